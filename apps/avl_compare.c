@@ -0,0 +1,328 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/avl_compare.c
+ *
+ * \brief An application to compare the lookup depth and throughput of AVL
+ *  trees, red-black trees and plain binary search trees built from skewed
+ *  insertion orders.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/avl.h>
+#include <upo/bst.h>
+#include <upo/error.h>
+#include <upo/hires_timer.h>
+#include <upo/random.h>
+#include <upo/rbt.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 1000000
+#define DEFAULT_OPT_MAX_SKEWED_BST_KEYS (size_t) 10000
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_VERBOSE 0
+
+/** \brief The number of insertion orders. */
+#define NUM_ORDERS 4
+
+/** \brief The percentage of keys moved at random in nearly sorted orders. */
+#define NEARLY_SORTED_SWAPS_PCT 1
+
+
+/** \brief The number of key comparisons performed so far. */
+static size_t num_compares = 0;
+
+
+/** \brief Compares two integers, counting comparisons. */
+static int int_compare(const void *a, const void *b);
+
+/** \brief Fills the given array with a permutation of `0, ..., n-1` in the given order. */
+static void make_order(int *keys, size_t n, int order);
+
+/** \brief Prints a line of the results table. */
+static void print_result(const char *tree, const char *order, size_t n, double insert, double lookups, double depth, size_t height);
+
+/** \brief Prints a usage message. */
+static void usage(const char *progname);
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    ++num_compares;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void make_order(int *keys, size_t n, int order)
+{
+    size_t i;
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+    switch (order)
+    {
+        case 0:
+            /* Sorted */
+            break;
+        case 1:
+            /* Nearly sorted: a few keys swapped with random ones */
+            for (i = 0; i < n*NEARLY_SORTED_SWAPS_PCT/100; ++i)
+            {
+                size_t j = upo_random_uniform_int(0, (int) n - 1);
+                size_t k = upo_random_uniform_int(0, (int) n - 1);
+                int tmp = keys[j];
+
+                keys[j] = keys[k];
+                keys[k] = tmp;
+            }
+            break;
+        case 2:
+            /* Zigzag: alternately the smallest and the largest key left */
+            for (i = 0; i < n; ++i)
+            {
+                keys[i] = (i % 2 == 0) ? (int) (i/2) : (int) (n - 1 - i/2);
+            }
+            break;
+        default:
+            upo_random_shuffle(keys, n, sizeof(int));
+            break;
+    }
+}
+
+void print_result(const char *tree, const char *order, size_t n, double insert, double lookups, double depth, size_t height)
+{
+    printf("%-4s  %-7s  %10lu  %12.6f  %12.6f  %10.2f  %8lu\n", tree, order, n, insert, lookups, depth, height);
+}
+
+void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s {options}\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-b <value>: Specifies the maximum number of keys inserted in skewed orders\n"
+                    "            in the plain BST, whose height grows linearly.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_MAX_SKEWED_BST_KEYS);
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-k <value>: Specifies the number of keys.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-v: Enables output verbosity.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_VERBOSE ? "enabled" : "disabled"));
+}
+
+
+int main(int argc, char *argv[])
+{
+    const char *order_names[NUM_ORDERS] = {"sorted", "nearly", "zigzag", "random"};
+    size_t opt_num_keys = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_max_skewed_bst_keys = DEFAULT_OPT_MAX_SKEWED_BST_KEYS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int opt_verbose = DEFAULT_OPT_VERBOSE;
+    int opt_help = 0;
+    int *keys = NULL;
+    upo_hires_timer_t timer = NULL;
+    int order;
+    int arg;
+    size_t i;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-b", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of skewed keys for the BST.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_max_skewed_bst_keys = atol(argv[arg]);
+        }
+        else if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-k", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_keys = atol(argv[arg]);
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-v", argv[arg]))
+        {
+            opt_verbose = 1;
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    if (opt_num_keys == 0 || opt_num_keys > INT32_MAX)
+    {
+        fprintf(stderr, "ERROR: number of keys must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt_verbose)
+    {
+        printf("Options:\n");
+        printf("* Number of keys: %lu\n", opt_num_keys);
+        printf("* Maximum number of skewed keys for the BST: %lu\n", opt_max_skewed_bst_keys);
+        printf("* Seed for random number generation: %u\n", opt_seed);
+    }
+
+    srand(opt_seed);
+
+    keys = malloc(opt_num_keys*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+
+    timer = upo_hires_timer_create();
+
+    /* The depth is the average number of comparisons of a successful lookup,
+     * that is the number of nodes on the path to the key */
+    printf("%-4s  %-7s  %10s  %12s  %12s  %10s  %8s\n", "tree", "order", "keys", "insert (s)", "lookups (s)", "depth", "height");
+
+    for (order = 0; order < NUM_ORDERS; ++order)
+    {
+        size_t bst_num_keys = opt_num_keys;
+        upo_avl_t avl = NULL;
+        upo_rbt_t rbt = NULL;
+        upo_bst_t bst = NULL;
+        double insert = 0;
+
+        make_order(keys, opt_num_keys, order);
+
+        upo_hires_timer_start(timer);
+        avl = upo_avl_create(int_compare);
+        for (i = 0; i < opt_num_keys; ++i)
+        {
+            upo_avl_put(avl, &keys[i], &keys[i]);
+        }
+        upo_hires_timer_stop(timer);
+        insert = upo_hires_timer_elapsed(timer);
+
+        num_compares = 0;
+        upo_hires_timer_start(timer);
+        for (i = 0; i < opt_num_keys; ++i)
+        {
+            if (upo_avl_get(avl, &keys[i]) != &keys[i])
+            {
+                fprintf(stderr, "ERROR: key not found.\n");
+                return EXIT_FAILURE;
+            }
+        }
+        upo_hires_timer_stop(timer);
+        print_result("avl", order_names[order], opt_num_keys, insert, upo_hires_timer_elapsed(timer), (double) num_compares/opt_num_keys, upo_avl_height(avl));
+        upo_avl_destroy(avl, 0);
+
+        upo_hires_timer_start(timer);
+        rbt = upo_rbt_create(int_compare);
+        for (i = 0; i < opt_num_keys; ++i)
+        {
+            upo_rbt_put(rbt, &keys[i], &keys[i]);
+        }
+        upo_hires_timer_stop(timer);
+        insert = upo_hires_timer_elapsed(timer);
+
+        num_compares = 0;
+        upo_hires_timer_start(timer);
+        for (i = 0; i < opt_num_keys; ++i)
+        {
+            if (upo_rbt_get(rbt, &keys[i]) != &keys[i])
+            {
+                fprintf(stderr, "ERROR: key not found.\n");
+                return EXIT_FAILURE;
+            }
+        }
+        upo_hires_timer_stop(timer);
+        print_result("rbt", order_names[order], opt_num_keys, insert, upo_hires_timer_elapsed(timer), (double) num_compares/opt_num_keys, upo_rbt_height(rbt));
+        upo_rbt_destroy(rbt, 0);
+
+        /* Skewed insertions make the plain BST (nearly) a list: both the
+         * time (quadratic) and the recursion depth (linear) must be bounded */
+        if (order < NUM_ORDERS - 1 && bst_num_keys > opt_max_skewed_bst_keys)
+        {
+            bst_num_keys = opt_max_skewed_bst_keys;
+        }
+
+        upo_hires_timer_start(timer);
+        bst = upo_bst_create(int_compare);
+        for (i = 0; i < bst_num_keys; ++i)
+        {
+            upo_bst_put(bst, &keys[i], &keys[i]);
+        }
+        upo_hires_timer_stop(timer);
+        insert = upo_hires_timer_elapsed(timer);
+
+        num_compares = 0;
+        upo_hires_timer_start(timer);
+        for (i = 0; i < bst_num_keys; ++i)
+        {
+            if (upo_bst_get(bst, &keys[i]) != &keys[i])
+            {
+                fprintf(stderr, "ERROR: key not found.\n");
+                return EXIT_FAILURE;
+            }
+        }
+        upo_hires_timer_stop(timer);
+        print_result("bst", order_names[order], bst_num_keys, insert, upo_hires_timer_elapsed(timer), (double) num_compares/bst_num_keys, upo_bst_height(bst));
+        upo_bst_destroy(bst, 0);
+    }
+
+    upo_hires_timer_destroy(timer);
+    free(keys);
+
+    return 0;
+}
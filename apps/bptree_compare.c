@@ -0,0 +1,381 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/bptree_compare.c
+ *
+ * \brief An application to compare B+-trees against binary search trees
+ *  (plain, red-black and AVL) on lookups and range scans.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/avl.h>
+#include <upo/bptree.h>
+#include <upo/bst.h>
+#include <upo/error.h>
+#include <upo/hires_timer.h>
+#include <upo/random.h>
+#include <upo/rbt.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 1000000
+#define DEFAULT_OPT_NUM_RANGES (size_t) 10000
+#define DEFAULT_OPT_RANGE_WIDTH (size_t) 100
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_VERBOSE 0
+
+/** \brief The number of compared trees. */
+#define NUM_TREES 5
+
+
+/** \brief Compares two integers. */
+static int int_compare(const void *a, const void *b);
+
+/** \brief Returns the number of keys of the given list, and frees it. */
+static size_t count_and_free(upo_bst_key_list_t list);
+
+/** \brief Prints a usage message. */
+static void usage(const char *progname);
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+size_t count_and_free(upo_bst_key_list_t list)
+{
+    size_t count = 0;
+
+    while (list != NULL)
+    {
+        upo_bst_key_list_t next = list->next;
+
+        free(list);
+        list = next;
+        ++count;
+    }
+
+    return count;
+}
+
+void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s {options}\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-k <value>: Specifies the number of keys.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-r <value>: Specifies the number of range scans (not run on the plain BST,\n"
+                    "            whose range scans visit the whole tree).\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_RANGES);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-v: Enables output verbosity.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_VERBOSE ? "enabled" : "disabled"));
+    fprintf(stderr, "-w <value>: Specifies the number of keys of each range scan.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_RANGE_WIDTH);
+}
+
+
+int main(int argc, char *argv[])
+{
+    const char *tree_names[NUM_TREES] = {"bst", "rbt", "avl", "bptree", "bptree"};
+    const char *method_names[NUM_TREES] = {"put", "put", "put", "put", "build"};
+    size_t opt_num_keys = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_num_ranges = DEFAULT_OPT_NUM_RANGES;
+    size_t opt_range_width = DEFAULT_OPT_RANGE_WIDTH;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int opt_verbose = DEFAULT_OPT_VERBOSE;
+    int opt_help = 0;
+    int *ints = NULL;
+    int *shuffled = NULL;
+    void **sorted_keys = NULL;
+    int *lows = NULL;
+    int *highs = NULL;
+    upo_hires_timer_t timer = NULL;
+    int t;
+    int arg;
+    size_t i;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-k", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_keys = atol(argv[arg]);
+        }
+        else if (!strcmp("-r", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of range scans.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_ranges = atol(argv[arg]);
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-v", argv[arg]))
+        {
+            opt_verbose = 1;
+        }
+        else if (!strcmp("-w", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected width of range scans.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_range_width = atol(argv[arg]);
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    if (opt_num_keys == 0 || opt_num_keys > INT32_MAX/2)
+    {
+        fprintf(stderr, "ERROR: number of keys must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (opt_range_width == 0 || opt_range_width > opt_num_keys)
+    {
+        fprintf(stderr, "ERROR: width of range scans must be positive and at most the number of keys.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt_verbose)
+    {
+        printf("Options:\n");
+        printf("* Number of keys: %lu\n", opt_num_keys);
+        printf("* Number of range scans: %lu\n", opt_num_ranges);
+        printf("* Width of range scans: %lu\n", opt_range_width);
+        printf("* Seed for random number generation: %u\n", opt_seed);
+    }
+
+    srand(opt_seed);
+
+    /* Even keys, so that bounds of ranges may be missing keys */
+    ints = malloc(opt_num_keys*sizeof(int));
+    shuffled = malloc(opt_num_keys*sizeof(int));
+    sorted_keys = malloc(opt_num_keys*sizeof(void*));
+    lows = malloc(opt_num_ranges*sizeof(int));
+    highs = malloc(opt_num_ranges*sizeof(int));
+    if (ints == NULL || shuffled == NULL || sorted_keys == NULL || lows == NULL || highs == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+    for (i = 0; i < opt_num_keys; ++i)
+    {
+        ints[i] = 2*(int) i;
+        shuffled[i] = ints[i];
+        sorted_keys[i] = &ints[i];
+    }
+    upo_random_shuffle(shuffled, opt_num_keys, sizeof(int));
+    for (i = 0; i < opt_num_ranges; ++i)
+    {
+        lows[i] = upo_random_uniform_int(0, 2*(int) (opt_num_keys - opt_range_width));
+        highs[i] = lows[i] + 2*(int) opt_range_width - 1;
+    }
+
+    timer = upo_hires_timer_create();
+
+    printf("%-6s  %-5s  %12s  %12s  %12s  %8s\n", "tree", "via", "insert (s)", "lookups (s)", "ranges (s)", "height");
+
+    for (t = 0; t < NUM_TREES; ++t)
+    {
+        upo_bst_t bst = NULL;
+        upo_rbt_t rbt = NULL;
+        upo_avl_t avl = NULL;
+        upo_bptree_t bptree = NULL;
+        double insert = 0;
+        double lookups = 0;
+        double ranges = 0;
+        size_t height = 0;
+        size_t found = 0;
+
+        /* Keys are inserted in random order, except for bulk loading */
+        upo_hires_timer_start(timer);
+        switch (t)
+        {
+            case 0:
+                bst = upo_bst_create(int_compare);
+                for (i = 0; i < opt_num_keys; ++i)
+                {
+                    upo_bst_put(bst, &shuffled[i], &shuffled[i]);
+                }
+                break;
+            case 1:
+                rbt = upo_rbt_create(int_compare);
+                for (i = 0; i < opt_num_keys; ++i)
+                {
+                    upo_rbt_put(rbt, &shuffled[i], &shuffled[i]);
+                }
+                break;
+            case 2:
+                avl = upo_avl_create(int_compare);
+                for (i = 0; i < opt_num_keys; ++i)
+                {
+                    upo_avl_put(avl, &shuffled[i], &shuffled[i]);
+                }
+                break;
+            case 3:
+                bptree = upo_bptree_create(int_compare);
+                for (i = 0; i < opt_num_keys; ++i)
+                {
+                    upo_bptree_put(bptree, &shuffled[i], &shuffled[i]);
+                }
+                break;
+            default:
+                bptree = upo_bptree_build(int_compare, sorted_keys, sorted_keys, opt_num_keys);
+                break;
+        }
+        upo_hires_timer_stop(timer);
+        insert = upo_hires_timer_elapsed(timer);
+
+        upo_hires_timer_start(timer);
+        for (i = 0; i < opt_num_keys; ++i)
+        {
+            switch (t)
+            {
+                case 0:
+                    found += upo_bst_get(bst, &shuffled[i]) != NULL;
+                    break;
+                case 1:
+                    found += upo_rbt_get(rbt, &shuffled[i]) != NULL;
+                    break;
+                case 2:
+                    found += upo_avl_get(avl, &shuffled[i]) != NULL;
+                    break;
+                default:
+                    found += upo_bptree_get(bptree, &shuffled[i]) != NULL;
+                    break;
+            }
+        }
+        upo_hires_timer_stop(timer);
+        lookups = upo_hires_timer_elapsed(timer);
+        if (found != opt_num_keys)
+        {
+            fprintf(stderr, "ERROR: key not found.\n");
+            return EXIT_FAILURE;
+        }
+
+        found = 0;
+        upo_hires_timer_start(timer);
+        for (i = 0; i < opt_num_ranges && t > 0; ++i)
+        {
+            switch (t)
+            {
+                case 1:
+                    found += count_and_free(upo_rbt_keys_range(rbt, &lows[i], &highs[i]));
+                    break;
+                case 2:
+                    found += count_and_free(upo_avl_keys_range(avl, &lows[i], &highs[i]));
+                    break;
+                default:
+                    found += count_and_free(upo_bptree_keys_range(bptree, &lows[i], &highs[i]));
+                    break;
+            }
+        }
+        upo_hires_timer_stop(timer);
+        ranges = upo_hires_timer_elapsed(timer);
+        if (t > 0 && found != opt_num_ranges*opt_range_width)
+        {
+            fprintf(stderr, "ERROR: wrong number of keys in ranges.\n");
+            return EXIT_FAILURE;
+        }
+
+        switch (t)
+        {
+            case 0:
+                height = upo_bst_height(bst);
+                upo_bst_destroy(bst, 0);
+                break;
+            case 1:
+                height = upo_rbt_height(rbt);
+                upo_rbt_destroy(rbt, 0);
+                break;
+            case 2:
+                height = upo_avl_height(avl);
+                upo_avl_destroy(avl, 0);
+                break;
+            default:
+                height = upo_bptree_height(bptree);
+                upo_bptree_destroy(bptree, 0);
+                break;
+        }
+
+        if (t > 0)
+        {
+            printf("%-6s  %-5s  %12.6f  %12.6f  %12.6f  %8lu\n", tree_names[t], method_names[t], insert, lookups, ranges, height);
+        }
+        else
+        {
+            printf("%-6s  %-5s  %12.6f  %12.6f  %12s  %8lu\n", tree_names[t], method_names[t], insert, lookups, "-", height);
+        }
+    }
+
+    upo_hires_timer_destroy(timer);
+    free(highs);
+    free(lows);
+    free(sorted_keys);
+    free(shuffled);
+    free(ints);
+
+    return 0;
+}
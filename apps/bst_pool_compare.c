@@ -0,0 +1,235 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/bst_pool_compare.c
+ *
+ * \brief An application to compare binary search trees whose nodes are
+ *  allocated with `malloc()` against trees whose nodes come from a pool.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/bst.h>
+#include <upo/error.h>
+#include <upo/hires_timer.h>
+#include <upo/pool.h>
+#include <upo/random.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 1000
+#define DEFAULT_OPT_NUM_TREES (size_t) 1000
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_VERBOSE 0
+
+
+/** \brief Compares two integers. */
+static int int_compare(const void *a, const void *b);
+
+/**
+ * \brief Builds, searches and destroys the given number of trees, and adds
+ *  the elapsed times to the given variables.
+ */
+static void run(const int *keys, size_t num_keys, size_t num_trees, upo_pool_t pool, upo_hires_timer_t timer, double *build, double *lookups, double *destroy);
+
+/** \brief Prints a usage message. */
+static void usage(const char *progname);
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void run(const int *keys, size_t num_keys, size_t num_trees, upo_pool_t pool, upo_hires_timer_t timer, double *build, double *lookups, double *destroy)
+{
+    size_t t;
+    size_t i;
+
+    for (t = 0; t < num_trees; ++t)
+    {
+        upo_bst_t bst = NULL;
+
+        upo_hires_timer_start(timer);
+        bst = upo_bst_create_with_pool(int_compare, pool);
+        for (i = 0; i < num_keys; ++i)
+        {
+            upo_bst_put(bst, (void*) &keys[i], (void*) &keys[i]);
+        }
+        upo_hires_timer_stop(timer);
+        *build += upo_hires_timer_elapsed(timer);
+
+        upo_hires_timer_start(timer);
+        for (i = 0; i < num_keys; ++i)
+        {
+            if (upo_bst_get(bst, &keys[i]) != &keys[i])
+            {
+                fprintf(stderr, "ERROR: key not found.\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        upo_hires_timer_stop(timer);
+        *lookups += upo_hires_timer_elapsed(timer);
+
+        upo_hires_timer_start(timer);
+        upo_bst_destroy(bst, 0);
+        upo_hires_timer_stop(timer);
+        *destroy += upo_hires_timer_elapsed(timer);
+    }
+}
+
+void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s {options}\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-k <value>: Specifies the number of keys of each tree.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-t <value>: Specifies the number of trees built one after the other.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_TREES);
+    fprintf(stderr, "-v: Enables output verbosity.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_VERBOSE ? "enabled" : "disabled"));
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t opt_num_keys = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_num_trees = DEFAULT_OPT_NUM_TREES;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int opt_verbose = DEFAULT_OPT_VERBOSE;
+    int opt_help = 0;
+    int *keys = NULL;
+    upo_pool_t pool = NULL;
+    upo_hires_timer_t timer = NULL;
+    double build = 0;
+    double lookups = 0;
+    double destroy = 0;
+    int arg;
+    size_t i;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-k", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_keys = atol(argv[arg]);
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-t", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of trees.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_trees = atol(argv[arg]);
+        }
+        else if (!strcmp("-v", argv[arg]))
+        {
+            opt_verbose = 1;
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    if (opt_num_keys == 0 || opt_num_keys > INT32_MAX)
+    {
+        fprintf(stderr, "ERROR: number of keys must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt_verbose)
+    {
+        printf("Options:\n");
+        printf("* Number of keys per tree: %lu\n", opt_num_keys);
+        printf("* Number of trees: %lu\n", opt_num_trees);
+        printf("* Seed for random number generation: %u\n", opt_seed);
+    }
+
+    srand(opt_seed);
+
+    keys = malloc(opt_num_keys*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+    for (i = 0; i < opt_num_keys; ++i)
+    {
+        keys[i] = (int) i;
+    }
+    upo_random_shuffle(keys, opt_num_keys, sizeof(int));
+
+    timer = upo_hires_timer_create();
+
+    printf("%-6s  %10s  %8s  %12s  %12s  %12s\n", "nodes", "keys", "trees", "build (s)", "lookups (s)", "destroy (s)");
+
+    run(keys, opt_num_keys, opt_num_trees, NULL, timer, &build, &lookups, &destroy);
+    printf("%-6s  %10lu  %8lu  %12.6f  %12.6f  %12.6f\n", "malloc", opt_num_keys, opt_num_trees, build, lookups, destroy);
+
+    /* A single pool is reused by all the trees */
+    build = lookups = destroy = 0;
+    pool = upo_bst_pool_create(UPO_POOL_DEFAULT_CHUNK_CAPACITY);
+    run(keys, opt_num_keys, opt_num_trees, pool, timer, &build, &lookups, &destroy);
+    printf("%-6s  %10lu  %8lu  %12.6f  %12.6f  %12.6f\n", "pool", opt_num_keys, opt_num_trees, build, lookups, destroy);
+    upo_pool_destroy(pool);
+
+    upo_hires_timer_destroy(timer);
+    free(keys);
+
+    return 0;
+}
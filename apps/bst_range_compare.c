@@ -0,0 +1,312 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/bst_range_compare.c
+ *
+ * \brief An application to compare the ways of finding the keys of narrow
+ *  ranges in large binary search trees.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/bst.h>
+#include <upo/error.h>
+#include <upo/hires_timer.h>
+#include <upo/random.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 1000000
+#define DEFAULT_OPT_NUM_QUERIES (size_t) 100000
+#define DEFAULT_OPT_RANGE_WIDTH (size_t) 10
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_VERBOSE 0
+
+/** \brief The maximum number of queries answered by walking the whole tree. */
+#define MAX_WALK_QUERIES (size_t) 10
+
+
+/** \brief Type for the context of the visit of the whole tree. */
+typedef struct {
+    upo_bst_comparator_t key_cmp; /**< The key comparison function. */
+    const int *low_key; /**< The lower bound of the range. */
+    const int *high_key; /**< The upper bound of the range. */
+    size_t count; /**< The number of keys found in the range. */
+} range_visit_context_t;
+
+
+/** \brief Compares two integers. */
+static int int_compare(const void *a, const void *b);
+
+/** \brief Counts the keys inside the range given by the context. */
+static void range_visit(void *key, void *value, void *context);
+
+/** \brief Prints a line of the results table. */
+static void print_result(const char *method, size_t num_queries, size_t num_found, double elapsed);
+
+/** \brief Prints a usage message. */
+static void usage(const char *progname);
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void range_visit(void *key, void *value, void *context)
+{
+    range_visit_context_t *ctx = context;
+
+    (void) value;
+
+    if (ctx->key_cmp(key, ctx->low_key) >= 0 && ctx->key_cmp(key, ctx->high_key) <= 0)
+    {
+        ctx->count += 1;
+    }
+}
+
+void print_result(const char *method, size_t num_queries, size_t num_found, double elapsed)
+{
+    printf("%-5s  %10lu  %12lu  %12.6f  %14.3f\n", method, num_queries, num_found, elapsed, elapsed*1e6/num_queries);
+}
+
+void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s {options}\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-k <value>: Specifies the number of keys.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-q <value>: Specifies the number of range queries.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_QUERIES);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-v: Enables output verbosity.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_VERBOSE ? "enabled" : "disabled"));
+    fprintf(stderr, "-w <value>: Specifies the number of keys inside each range.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_RANGE_WIDTH);
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t opt_num_keys = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_num_queries = DEFAULT_OPT_NUM_QUERIES;
+    size_t opt_range_width = DEFAULT_OPT_RANGE_WIDTH;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int opt_verbose = DEFAULT_OPT_VERBOSE;
+    int opt_help = 0;
+    int *keys = NULL;
+    int *low_keys = NULL;
+    upo_bst_t bst = NULL;
+    upo_hires_timer_t timer = NULL;
+    size_t num_walk_queries = 0;
+    size_t num_found = 0;
+    int arg;
+    size_t i;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-k", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_keys = atol(argv[arg]);
+        }
+        else if (!strcmp("-q", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of queries.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_queries = atol(argv[arg]);
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-v", argv[arg]))
+        {
+            opt_verbose = 1;
+        }
+        else if (!strcmp("-w", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected range width.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_range_width = atol(argv[arg]);
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    if (opt_num_keys == 0 || opt_num_keys > INT32_MAX)
+    {
+        fprintf(stderr, "ERROR: number of keys must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (opt_num_queries == 0)
+    {
+        fprintf(stderr, "ERROR: number of queries must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (opt_range_width == 0 || opt_range_width > opt_num_keys)
+    {
+        fprintf(stderr, "ERROR: range width must be positive and not greater than the number of keys.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt_verbose)
+    {
+        printf("Options:\n");
+        printf("* Number of keys: %lu\n", opt_num_keys);
+        printf("* Number of queries: %lu\n", opt_num_queries);
+        printf("* Range width: %lu\n", opt_range_width);
+        printf("* Seed for random number generation: %u\n", opt_seed);
+    }
+
+    srand(opt_seed);
+
+    keys = malloc(opt_num_keys*sizeof(int));
+    low_keys = malloc(opt_num_queries*sizeof(int));
+    if (keys == NULL || low_keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+    for (i = 0; i < opt_num_keys; ++i)
+    {
+        keys[i] = (int) i;
+    }
+    upo_random_shuffle(keys, opt_num_keys, sizeof(int));
+    for (i = 0; i < opt_num_queries; ++i)
+    {
+        low_keys[i] = upo_random_uniform_int(0, (int) (opt_num_keys - opt_range_width));
+    }
+
+    bst = upo_bst_create(int_compare);
+    for (i = 0; i < opt_num_keys; ++i)
+    {
+        upo_bst_put(bst, &keys[i], &keys[i]);
+    }
+
+    timer = upo_hires_timer_create();
+
+    printf("%-5s  %10s  %12s  %12s  %14s\n", "how", "queries", "keys found", "total (s)", "per query (us)");
+
+    /* Iterator: only the keys of the range are visited, without allocations
+     * unless the tree is deeper than UPO_BST_ITER_INLINE_DEPTH */
+    num_found = 0;
+    upo_hires_timer_start(timer);
+    for (i = 0; i < opt_num_queries; ++i)
+    {
+        int high_key = low_keys[i] + (int) opt_range_width - 1;
+        upo_bst_iter_t it;
+        void *key = NULL;
+
+        upo_bst_iter_seek(bst, &it, &low_keys[i]);
+        while (upo_bst_iter_next(&it, &key, NULL) && *(int*) key <= high_key)
+        {
+            ++num_found;
+        }
+        upo_bst_iter_destroy(&it);
+    }
+    upo_hires_timer_stop(timer);
+    print_result("iter", opt_num_queries, num_found, upo_hires_timer_elapsed(timer));
+
+    /* List of keys: as above, plus a list node per key */
+    num_found = 0;
+    upo_hires_timer_start(timer);
+    for (i = 0; i < opt_num_queries; ++i)
+    {
+        int high_key = low_keys[i] + (int) opt_range_width - 1;
+        upo_bst_key_list_t key_list = upo_bst_keys_range(bst, &low_keys[i], &high_key);
+
+        while (key_list != NULL)
+        {
+            upo_bst_key_list_t old_list = key_list;
+
+            key_list = key_list->next;
+            free(old_list);
+            ++num_found;
+        }
+    }
+    upo_hires_timer_stop(timer);
+    print_result("list", opt_num_queries, num_found, upo_hires_timer_elapsed(timer));
+
+    /* Whole tree: every key is compared against the range */
+    num_walk_queries = (opt_num_queries < MAX_WALK_QUERIES) ? opt_num_queries : MAX_WALK_QUERIES;
+    num_found = 0;
+    upo_hires_timer_start(timer);
+    for (i = 0; i < num_walk_queries; ++i)
+    {
+        int high_key = low_keys[i] + (int) opt_range_width - 1;
+        range_visit_context_t ctx = {int_compare, &low_keys[i], &high_key, 0};
+
+        upo_bst_traverse_in_order(bst, range_visit, &ctx);
+        num_found += ctx.count;
+    }
+    upo_hires_timer_stop(timer);
+    print_result("walk", num_walk_queries, num_found, upo_hires_timer_elapsed(timer));
+
+    upo_hires_timer_destroy(timer);
+    upo_bst_destroy(bst, 0);
+    free(low_keys);
+    free(keys);
+
+    return 0;
+}
@@ -0,0 +1,398 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/bst_scapegoat_compare.c
+ *
+ * \brief An application to compare the cost per operation of scapegoat trees
+ *  against AVL trees and red-black trees as the number of keys grows.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/avl.h>
+#include <upo/bst.h>
+#include <upo/error.h>
+#include <upo/hires_timer.h>
+#include <upo/random.h>
+#include <upo/rbt.h>
+
+
+#define DEFAULT_OPT_ALPHA UPO_BST_SCAPEGOAT_DEFAULT_ALPHA
+#define DEFAULT_OPT_NUM_KEYS (size_t) 1000000
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_VERBOSE 0
+
+/** \brief The number of tree sizes, each one ten times the previous one. */
+#define NUM_SIZES 3
+
+/** \brief The number of insertion orders. */
+#define NUM_ORDERS 2
+
+
+/** \brief Type for the operations of the compared trees. */
+typedef struct {
+    const char *name; /**< The name of the tree. */
+    void* (*create)(void); /**< Creates an empty tree. */
+    void (*put)(void*, void*, void*); /**< Adds a key-value pair. */
+    void* (*get)(void*, const void*); /**< Gets the value of a key. */
+    void (*del)(void*, const void*); /**< Deletes a key. */
+    size_t (*height)(void*); /**< Returns the height. */
+    void (*destroy)(void*); /**< Destroys the tree. */
+} tree_ops_t;
+
+
+/** \brief The weight-balance factor of scapegoat trees. */
+static double alpha = DEFAULT_OPT_ALPHA;
+
+
+/** \brief Compares two integers. */
+static int int_compare(const void *a, const void *b);
+
+static void* sg_create(void);
+static void sg_put(void *tree, void *key, void *value);
+static void* sg_get(void *tree, const void *key);
+static void sg_delete(void *tree, const void *key);
+static size_t sg_height(void *tree);
+static void sg_destroy(void *tree);
+
+static void* avl_create(void);
+static void avl_put(void *tree, void *key, void *value);
+static void* avl_get(void *tree, const void *key);
+static void avl_delete(void *tree, const void *key);
+static size_t avl_height(void *tree);
+static void avl_destroy(void *tree);
+
+static void* rbt_create(void);
+static void rbt_put(void *tree, void *key, void *value);
+static void* rbt_get(void *tree, const void *key);
+static void rbt_delete(void *tree, const void *key);
+static size_t rbt_height(void *tree);
+static void rbt_destroy(void *tree);
+
+/** \brief Inserts, looks up and deletes the given keys, and prints the times per operation. */
+static void run(const tree_ops_t *ops, const char *order, int *keys, size_t n, upo_hires_timer_t timer);
+
+/** \brief Prints a usage message. */
+static void usage(const char *progname);
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void* sg_create(void)
+{
+    upo_bst_t tree = upo_bst_create(int_compare);
+
+    upo_bst_set_scapegoat(tree, alpha);
+
+    return tree;
+}
+
+void sg_put(void *tree, void *key, void *value)
+{
+    upo_bst_put(tree, key, value);
+}
+
+void* sg_get(void *tree, const void *key)
+{
+    return upo_bst_get(tree, key);
+}
+
+void sg_delete(void *tree, const void *key)
+{
+    upo_bst_delete(tree, key, 0);
+}
+
+size_t sg_height(void *tree)
+{
+    return upo_bst_height(tree);
+}
+
+void sg_destroy(void *tree)
+{
+    upo_bst_destroy(tree, 0);
+}
+
+void* avl_create(void)
+{
+    return upo_avl_create(int_compare);
+}
+
+void avl_put(void *tree, void *key, void *value)
+{
+    upo_avl_put(tree, key, value);
+}
+
+void* avl_get(void *tree, const void *key)
+{
+    return upo_avl_get(tree, key);
+}
+
+void avl_delete(void *tree, const void *key)
+{
+    upo_avl_delete(tree, key, 0);
+}
+
+size_t avl_height(void *tree)
+{
+    return upo_avl_height(tree);
+}
+
+void avl_destroy(void *tree)
+{
+    upo_avl_destroy(tree, 0);
+}
+
+void* rbt_create(void)
+{
+    return upo_rbt_create(int_compare);
+}
+
+void rbt_put(void *tree, void *key, void *value)
+{
+    upo_rbt_put(tree, key, value);
+}
+
+void* rbt_get(void *tree, const void *key)
+{
+    return upo_rbt_get(tree, key);
+}
+
+void rbt_delete(void *tree, const void *key)
+{
+    upo_rbt_delete(tree, key, 0);
+}
+
+size_t rbt_height(void *tree)
+{
+    return upo_rbt_height(tree);
+}
+
+void rbt_destroy(void *tree)
+{
+    upo_rbt_destroy(tree, 0);
+}
+
+void run(const tree_ops_t *ops, const char *order, int *keys, size_t n, upo_hires_timer_t timer)
+{
+    void *tree = ops->create();
+    double insert = 0;
+    double lookups = 0;
+    double deletes = 0;
+    size_t height = 0;
+    size_t i;
+
+    upo_hires_timer_start(timer);
+    for (i = 0; i < n; ++i)
+    {
+        ops->put(tree, &keys[i], &keys[i]);
+    }
+    upo_hires_timer_stop(timer);
+    insert = upo_hires_timer_elapsed(timer);
+    height = ops->height(tree);
+
+    upo_hires_timer_start(timer);
+    for (i = 0; i < n; ++i)
+    {
+        if (ops->get(tree, &keys[i]) != &keys[i])
+        {
+            fprintf(stderr, "ERROR: key not found.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    upo_hires_timer_stop(timer);
+    lookups = upo_hires_timer_elapsed(timer);
+
+    upo_hires_timer_start(timer);
+    for (i = 0; i < n; ++i)
+    {
+        ops->del(tree, &keys[i]);
+    }
+    upo_hires_timer_stop(timer);
+    deletes = upo_hires_timer_elapsed(timer);
+
+    ops->destroy(tree);
+
+    printf("%-4s  %-6s  %10lu  %12.3f  %12.3f  %12.3f  %8lu\n", ops->name, order, n, insert*1e6/n, lookups*1e6/n, deletes*1e6/n, height);
+}
+
+void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s {options}\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-a <value>: Specifies the weight-balance factor of scapegoat trees,\n"
+                    "            greater than 0.5 and less than 1.\n"
+                    "            [default: %g]\n", DEFAULT_OPT_ALPHA);
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-k <value>: Specifies the largest number of keys; trees are also\n"
+                    "            built with 1/10 and 1/100 of them.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-v: Enables output verbosity.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_VERBOSE ? "enabled" : "disabled"));
+}
+
+
+int main(int argc, char *argv[])
+{
+    const tree_ops_t trees[] = {
+        {"sg", sg_create, sg_put, sg_get, sg_delete, sg_height, sg_destroy},
+        {"avl", avl_create, avl_put, avl_get, avl_delete, avl_height, avl_destroy},
+        {"rbt", rbt_create, rbt_put, rbt_get, rbt_delete, rbt_height, rbt_destroy}
+    };
+    const char *order_names[NUM_ORDERS] = {"sorted", "random"};
+    size_t num_trees = sizeof trees/sizeof trees[0];
+    size_t opt_num_keys = DEFAULT_OPT_NUM_KEYS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int opt_verbose = DEFAULT_OPT_VERBOSE;
+    int opt_help = 0;
+    int *keys = NULL;
+    upo_hires_timer_t timer = NULL;
+    size_t n;
+    int order;
+    int arg;
+    size_t i;
+    size_t t;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-a", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected weight-balance factor.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            alpha = atof(argv[arg]);
+        }
+        else if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-k", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_keys = atol(argv[arg]);
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-v", argv[arg]))
+        {
+            opt_verbose = 1;
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    if (opt_num_keys < 100 || opt_num_keys > INT32_MAX)
+    {
+        fprintf(stderr, "ERROR: number of keys must be at least 100.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (alpha <= 0.5 || alpha >= 1)
+    {
+        fprintf(stderr, "ERROR: weight-balance factor must be greater than 0.5 and less than 1.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt_verbose)
+    {
+        printf("Options:\n");
+        printf("* Weight-balance factor: %g\n", alpha);
+        printf("* Number of keys: %lu\n", opt_num_keys);
+        printf("* Seed for random number generation: %u\n", opt_seed);
+    }
+
+    srand(opt_seed);
+
+    keys = malloc(opt_num_keys*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+
+    timer = upo_hires_timer_create();
+
+    /* Amortized O(log(n)) updates show up as times per operation growing
+     * by a constant amount from one size to the next */
+    printf("%-4s  %-6s  %10s  %12s  %12s  %12s  %8s\n", "tree", "order", "keys", "insert (us)", "lookup (us)", "delete (us)", "height");
+
+    for (order = 0; order < NUM_ORDERS; ++order)
+    {
+        for (n = opt_num_keys/100, i = 0; i < NUM_SIZES; n *= 10, ++i)
+        {
+            size_t j;
+
+            for (j = 0; j < n; ++j)
+            {
+                keys[j] = (int) j;
+            }
+            if (order == 1)
+            {
+                upo_random_shuffle(keys, n, sizeof(int));
+            }
+
+            for (t = 0; t < num_trees; ++t)
+            {
+                run(&trees[t], order_names[order], keys, n, timer);
+            }
+        }
+    }
+
+    upo_hires_timer_destroy(timer);
+    free(keys);
+
+    return 0;
+}
@@ -0,0 +1,726 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/hash_compare.c
+ *
+ * \brief An application to compare the quality and the speed of different
+ *  hash functions.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <limits.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+#include <upo/hires_timer.h>
+#include <upo/random.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 1000000
+#define DEFAULT_OPT_KEY_LENGTH (size_t) 16
+#define DEFAULT_OPT_NUM_RUNS (size_t) 5
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_VERBOSE 0
+#define NUM_HASH_FUNCTIONS (size_t) 8
+#define NUM_AVALANCHE_SAMPLES (size_t) 2000
+#define STRIDE 1024
+
+
+/** \brief Defines the hash function category type as an enumerated type. */
+typedef enum {
+            unknown_hash_function = -1,
+            str_djb2_hash_function,
+            str_djb2a_hash_function,
+            str_java_hash_function,
+            str_sgistl_hash_function,
+            str_wyhash_hash_function,
+            int_div_hash_function,
+            int_knuth_hash_function,
+            int_mix_hash_function
+        } hash_function_t;
+
+
+/** \brief Tells whether the given hash function hashes strings (as opposed to integers). */
+static int is_string_hash_function(hash_function_t fun);
+
+/** \brief Returns the hasher implementing the given hash function. */
+static upo_ht_hasher_t get_hasher(hash_function_t fun);
+
+/** \brief Generates \a n random strings of length \a len. */
+static char** make_random_strings(size_t n, size_t len);
+
+/** \brief Generates \a n strings of the form `key<i>` (i.e., with a long common prefix). */
+static char** make_sequential_strings(size_t n);
+
+/** \brief Frees the given array of \a n strings. */
+static void free_strings(char **strs, size_t n);
+
+/** \brief Generates \a n random integers. */
+static int* make_random_ints(size_t n);
+
+/** \brief Generates the \a n integers \f$0, s, 2s, \ldots\f$ with stride \a s. */
+static int* make_sequential_ints(size_t n, int s);
+
+/** \brief Measures the time to hash the given keys \a num_runs times; returns the hashed keys per second. */
+static double throughput(upo_ht_hasher_t hasher, const void *keys, size_t key_size, size_t n, size_t num_runs);
+
+/**
+ * \brief Computes the avalanche bias, that is the maximum deviation from 1/2
+ *  of the probability that an output bit flips when a single input bit flips.
+ */
+static double avalanche_bias(hash_function_t fun, size_t len);
+
+/**
+ * \brief Hashes the given keys into \a m buckets (by masking) and returns the
+ *  standardized chi-square statistic of the bucket counts.
+ *
+ * Values whose magnitude is less than 3 are compatible with a uniform
+ * distribution.
+ */
+static double chi_square_z(upo_ht_hasher_t hasher, const void *keys, size_t key_size, size_t n, size_t m);
+
+/** \brief Compares hash functions. */
+static void compare_hash_functions(hash_function_t funs[], size_t num_funs, size_t n, size_t len, unsigned int seed, size_t num_runs, int verbose);
+
+/** \brief Extracts the hash function name from the given string. */
+static hash_function_t parse_hash_function(const char *str);
+
+/** \brief Prints the hash function name to the given output stream. */
+static void print_hash_function(FILE *fp, hash_function_t fun);
+
+/** \brief Displays a help message. */
+static void usage(const char *progname);
+
+
+int is_string_hash_function(hash_function_t fun)
+{
+    return fun >= str_djb2_hash_function && fun <= str_wyhash_hash_function;
+}
+
+upo_ht_hasher_t get_hasher(hash_function_t fun)
+{
+    switch (fun)
+    {
+        case str_djb2_hash_function:
+            return upo_ht_hash_str_djb2;
+        case str_djb2a_hash_function:
+            return upo_ht_hash_str_djb2a;
+        case str_java_hash_function:
+            return upo_ht_hash_str_java;
+        case str_sgistl_hash_function:
+            return upo_ht_hash_str_sgistl;
+        case str_wyhash_hash_function:
+            return upo_ht_hash_str_wyhash;
+        case int_div_hash_function:
+            return upo_ht_hash_int_div;
+        case int_knuth_hash_function:
+            return upo_ht_hash_int_mult_knuth;
+        case int_mix_hash_function:
+            return upo_ht_hash_int_mix;
+        case unknown_hash_function:
+            break;
+    }
+
+    return NULL;
+}
+
+char** make_random_strings(size_t n, size_t len)
+{
+    char **strs = NULL;
+    size_t i;
+
+    strs = malloc(n*sizeof(char*));
+    if (strs == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for random strings");
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        strs[i] = malloc(len+1);
+        if (strs[i] == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for a random string");
+        }
+        upo_random_string(strs[i], len);
+    }
+
+    return strs;
+}
+
+char** make_sequential_strings(size_t n)
+{
+    char **strs = NULL;
+    size_t i;
+
+    strs = malloc(n*sizeof(char*));
+    if (strs == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for sequential strings");
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        strs[i] = malloc(32);
+        if (strs[i] == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for a sequential string");
+        }
+        snprintf(strs[i], 32, "key%lu", i);
+    }
+
+    return strs;
+}
+
+void free_strings(char **strs, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; ++i)
+    {
+        free(strs[i]);
+    }
+    free(strs);
+}
+
+int* make_random_ints(size_t n)
+{
+    int *a = NULL;
+    size_t i;
+
+    a = malloc(n*sizeof(int));
+    if (a == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for random integers");
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        a[i] = rand();
+    }
+
+    return a;
+}
+
+int* make_sequential_ints(size_t n, int s)
+{
+    int *a = NULL;
+    size_t i;
+
+    a = malloc(n*sizeof(int));
+    if (a == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for sequential integers");
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        a[i] = (int) i*s;
+    }
+
+    return a;
+}
+
+double throughput(upo_ht_hasher_t hasher, const void *keys, size_t key_size, size_t n, size_t num_runs)
+{
+    const unsigned char *k = keys;
+    volatile uint64_t sink = 0;
+    uint64_t acc = 0;
+    upo_hires_timer_t timer;
+    double runtime = 0;
+    size_t r;
+    size_t i;
+
+    timer = upo_hires_timer_create();
+    upo_hires_timer_start(timer);
+    for (r = 0; r < num_runs; ++r)
+    {
+        for (i = 0; i < n; ++i)
+        {
+            acc ^= hasher(k + i*key_size);
+        }
+    }
+    upo_hires_timer_stop(timer);
+    runtime = upo_hires_timer_elapsed(timer);
+    upo_hires_timer_destroy(timer);
+
+    /* Prevents the compiler from optimizing the loop away */
+    sink = acc;
+    (void) sink;
+
+    return (n*num_runs)/runtime;
+}
+
+double avalanche_bias(hash_function_t fun, size_t len)
+{
+    upo_ht_hasher_t hasher = get_hasher(fun);
+    size_t in_bits = is_string_hash_function(fun) ? 7*len : 32;
+    size_t *flips = NULL;
+    char *str = NULL;
+    double bias = 0;
+    size_t s;
+    size_t i;
+    size_t j;
+
+    flips = calloc(in_bits*64, sizeof(size_t));
+    str = malloc(len+1);
+    if (flips == NULL || str == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for the avalanche test");
+    }
+
+    for (s = 0; s < NUM_AVALANCHE_SAMPLES; ++s)
+    {
+        uint64_t h0 = 0;
+
+        if (is_string_hash_function(fun))
+        {
+            char *key = str;
+
+            upo_random_string(str, len);
+            h0 = hasher(&key);
+            for (i = 0; i < in_bits; ++i)
+            {
+                char c = str[i/7];
+                uint64_t diff = 0;
+
+                str[i/7] ^= (char) (1 << (i%7));
+                if (str[i/7] != '\0')
+                {
+                    diff = h0 ^ hasher(&key);
+                }
+                else
+                {
+                    /* Flipping this bit would truncate the string: assume a
+                     * perfect avalanche for this sample */
+                    diff = UINT64_C(0x5555555555555555) << (s & 1);
+                }
+                str[i/7] = c;
+                for (j = 0; j < 64; ++j)
+                {
+                    flips[i*64+j] += (diff >> j) & 1;
+                }
+            }
+        }
+        else
+        {
+            int key = rand();
+
+            h0 = hasher(&key);
+            for (i = 0; i < in_bits; ++i)
+            {
+                int fkey = (int) ((unsigned int) key ^ (1U << i));
+                uint64_t diff = h0 ^ hasher(&fkey);
+
+                for (j = 0; j < 64; ++j)
+                {
+                    flips[i*64+j] += (diff >> j) & 1;
+                }
+            }
+        }
+    }
+
+    for (i = 0; i < in_bits*64; ++i)
+    {
+        double p = flips[i]/((double) NUM_AVALANCHE_SAMPLES);
+
+        if (fabs(p - 0.5) > bias)
+        {
+            bias = fabs(p - 0.5);
+        }
+    }
+
+    free(str);
+    free(flips);
+
+    return bias;
+}
+
+double chi_square_z(upo_ht_hasher_t hasher, const void *keys, size_t key_size, size_t n, size_t m)
+{
+    const unsigned char *k = keys;
+    size_t *counts = NULL;
+    double expected = n/((double) m);
+    double chi2 = 0;
+    size_t i;
+
+    assert( (m & (m-1)) == 0 );
+
+    counts = calloc(m, sizeof(size_t));
+    if (counts == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for bucket counts");
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        counts[hasher(k + i*key_size) & (m-1)] += 1;
+    }
+    for (i = 0; i < m; ++i)
+    {
+        chi2 += (counts[i]-expected)*(counts[i]-expected)/expected;
+    }
+
+    free(counts);
+
+    return (chi2 - (m-1))/sqrt(2.0*(m-1));
+}
+
+void compare_hash_functions(hash_function_t funs[], size_t num_funs, size_t n, size_t len, unsigned int seed, size_t num_runs, int verbose)
+{
+    char **rnd_strs = NULL;
+    char **seq_strs = NULL;
+    int *rnd_ints = NULL;
+    int *seq_ints = NULL;
+    int *strided_ints = NULL;
+    size_t m = 2;
+    size_t k;
+
+    srand(seed);
+
+    /* Buckets are a power of two as in tables reducing hashes by masking,
+     * with about 4 keys per bucket */
+    while (m < n/4)
+    {
+        m *= 2;
+    }
+
+    rnd_strs = make_random_strings(n, len);
+    seq_strs = make_sequential_strings(n);
+    rnd_ints = make_random_ints(n);
+    seq_ints = make_sequential_ints(n, 1);
+    strided_ints = make_sequential_ints(n, (n <= INT_MAX/STRIDE) ? STRIDE : 1);
+
+    if (verbose)
+    {
+        printf("Number of keys: %lu, string length: %lu, number of buckets: %lu\n", n, len, m);
+    }
+
+    printf("%-22s %14s %14s %10s %12s %12s %12s\n", "Hash function", "Mkeys/s", "MB/s", "Avalanche", "Chi2(rand)", "Chi2(seq)", "Chi2(strd)");
+    for (k = 0; k < num_funs; ++k)
+    {
+        hash_function_t fun = funs[k];
+        upo_ht_hasher_t hasher = get_hasher(fun);
+        double keys_per_sec = 0;
+        double bytes_per_key = 0;
+        double bias = 0;
+        double z_rnd = 0;
+        double z_seq = 0;
+
+        if (is_string_hash_function(fun))
+        {
+            keys_per_sec = throughput(hasher, rnd_strs, sizeof(char*), n, num_runs);
+            bytes_per_key = len;
+            z_rnd = chi_square_z(hasher, rnd_strs, sizeof(char*), n, m);
+            z_seq = chi_square_z(hasher, seq_strs, sizeof(char*), n, m);
+        }
+        else
+        {
+            keys_per_sec = throughput(hasher, rnd_ints, sizeof(int), n, num_runs);
+            bytes_per_key = sizeof(int);
+            z_rnd = chi_square_z(hasher, rnd_ints, sizeof(int), n, m);
+            z_seq = chi_square_z(hasher, seq_ints, sizeof(int), n, m);
+        }
+        bias = avalanche_bias(fun, len);
+
+        print_hash_function(stdout, fun);
+        printf(" %14.2f %14.2f %10.4f %12.2f %12.2f", keys_per_sec/1e6, keys_per_sec*bytes_per_key/1e6, bias, z_rnd, z_seq);
+        if (is_string_hash_function(fun))
+        {
+            printf(" %12s\n", "-");
+        }
+        else
+        {
+            printf(" %12.2f\n", chi_square_z(hasher, strided_ints, sizeof(int), n, m));
+        }
+    }
+
+    free(strided_ints);
+    free(seq_ints);
+    free(rnd_ints);
+    free_strings(seq_strs, n);
+    free_strings(rnd_strs, n);
+}
+
+hash_function_t parse_hash_function(const char *str)
+{
+    assert( str != NULL );
+
+    if (!strcmp("djb2", str))
+    {
+        return str_djb2_hash_function;
+    }
+    if (!strcmp("djb2a", str))
+    {
+        return str_djb2a_hash_function;
+    }
+    if (!strcmp("java", str))
+    {
+        return str_java_hash_function;
+    }
+    if (!strcmp("sgistl", str))
+    {
+        return str_sgistl_hash_function;
+    }
+    if (!strcmp("wyhash", str))
+    {
+        return str_wyhash_hash_function;
+    }
+    if (!strcmp("int-div", str))
+    {
+        return int_div_hash_function;
+    }
+    if (!strcmp("int-knuth", str))
+    {
+        return int_knuth_hash_function;
+    }
+    if (!strcmp("int-mix", str))
+    {
+        return int_mix_hash_function;
+    }
+
+    return unknown_hash_function;
+}
+
+void print_hash_function(FILE *fp, hash_function_t fun)
+{
+    assert( fp != NULL );
+
+    switch (fun)
+    {
+        case str_djb2_hash_function:
+            fprintf(fp, "%-22s", "String djb2");
+            break;
+        case str_djb2a_hash_function:
+            fprintf(fp, "%-22s", "String djb2a");
+            break;
+        case str_java_hash_function:
+            fprintf(fp, "%-22s", "String Java hashCode");
+            break;
+        case str_sgistl_hash_function:
+            fprintf(fp, "%-22s", "String SGI STL");
+            break;
+        case str_wyhash_hash_function:
+            fprintf(fp, "%-22s", "String wyhash");
+            break;
+        case int_div_hash_function:
+            fprintf(fp, "%-22s", "Integer division");
+            break;
+        case int_knuth_hash_function:
+            fprintf(fp, "%-22s", "Integer Knuth mult.");
+            break;
+        case int_mix_hash_function:
+            fprintf(fp, "%-22s", "Integer mix64");
+            break;
+        case unknown_hash_function:
+            fprintf(fp, "%-22s", "Unknown hash function");
+            break;
+    }
+}
+
+void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s <options>\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-a <value>: Specifies the hash function to use.\n"
+                    "            Possible values are:\n"
+                    "            - djb2: Bernstein's djb2 string hash\n"
+                    "            - djb2a: Bernstein's djb2a string hash\n"
+                    "            - java: Java's hashCode string hash\n"
+                    "            - sgistl: SGI STL's string hash\n"
+                    "            - wyhash: wyhash-like string hash\n"
+                    "            - int-div: integer hash by the division method\n"
+                    "            - int-knuth: integer hash by Knuth's multiplication method\n"
+                    "            - int-mix: integer hash by a multiply-xorshift mixer\n"
+                    "            Repeats this option as many times as is the number of hash functions to use.\n"
+                    "            [default: all]\n");
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-l <value>: Specifies the length of random string keys.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_KEY_LENGTH);
+    fprintf(stderr, "-n <value>: Specifies the number of keys to hash.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-r <value>: Specifies the number of times the keys are hashed to measure throughput.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_RUNS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-v: Enables output verbosity.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_VERBOSE ? "enabled" : "disabled"));
+}
+
+
+int main(int argc, char *argv[])
+{
+    hash_function_t *opt_funs = NULL;
+    size_t opt_n = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_len = DEFAULT_OPT_KEY_LENGTH;
+    size_t opt_num_runs = DEFAULT_OPT_NUM_RUNS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int opt_verbose = DEFAULT_OPT_VERBOSE;
+    int opt_help = 0;
+    size_t num_funs = 0;
+    int chosen_funs[NUM_HASH_FUNCTIONS];
+    int arg;
+    size_t i;
+    size_t j;
+
+    memset(chosen_funs, 0, NUM_HASH_FUNCTIONS*sizeof(int));
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-a", argv[arg]))
+        {
+            hash_function_t fun;
+
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected hash function name.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+
+            fun = parse_hash_function(argv[arg]);
+            if (fun == unknown_hash_function)
+            {
+                fprintf(stderr, "ERROR: unknown hash function name '%s'.\n", argv[arg]);
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            if (chosen_funs[(int) fun] == 0)
+            {
+                chosen_funs[(int) fun] = 1;
+                ++num_funs;
+            }
+        }
+        else if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-l", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected string length.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_len = atol(argv[arg]);
+        }
+        else if (!strcmp("-n", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_n = atol(argv[arg]);
+        }
+        else if (!strcmp("-r", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of runs.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_runs = atol(argv[arg]);
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-v", argv[arg]))
+        {
+            opt_verbose = 1;
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    if (opt_n == 0 || opt_len == 0 || opt_num_runs == 0)
+    {
+        fprintf(stderr, "ERROR: number of keys, string length and number of runs must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (num_funs == 0)
+    {
+        /* Compares all the hash functions */
+        for (i = 0; i < NUM_HASH_FUNCTIONS; ++i)
+        {
+            chosen_funs[i] = 1;
+        }
+        num_funs = NUM_HASH_FUNCTIONS;
+    }
+
+    if (opt_verbose)
+    {
+        printf("Options:\n");
+        printf("* Number of keys: %lu\n", opt_n);
+        printf("* String length: %lu\n", opt_len);
+        printf("* Number of runs: %lu\n", opt_num_runs);
+        printf("* Seed for random number generation: %u\n", opt_seed);
+    }
+
+    opt_funs = malloc(num_funs*sizeof(hash_function_t));
+    if (opt_funs == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for hash functions");
+    }
+
+    j = 0;
+    for (i = 0; i < NUM_HASH_FUNCTIONS; ++i)
+    {
+        if (chosen_funs[i] == 1)
+        {
+            opt_funs[j++] = (hash_function_t) i;
+        }
+    }
+
+    compare_hash_functions(opt_funs, num_funs, opt_n, opt_len, opt_seed, opt_num_runs, opt_verbose);
+
+    free(opt_funs);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,336 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/hset_compare.c
+ *
+ * \brief An application to compare the intersection of two hash sets against
+ *  the one of two sets emulated by hash tables with linear probing and `NULL`
+ *  values.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+#include <upo/hires_timer.h>
+#include <upo/hset.h>
+#include <upo/random.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 1000000
+#define DEFAULT_OPT_NUM_THREADS (size_t) 4
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_VERBOSE 0
+
+/** \brief The number of keys inserted by each batch insertion. */
+#define BATCH_SIZE (size_t) 256
+
+
+/** \brief Collects the keys of a table that are in another table. */
+struct intersect_context_s
+{
+    upo_ht_linprob_t large; /**< The table probed for each key. */
+    void **common; /**< The keys found in both tables. */
+    size_t num_common; /**< The number of keys found in both tables. */
+};
+
+
+/** \brief Compares two integers. */
+static int int_compare(const void *a, const void *b);
+
+/** \brief Collects the visited key if the other table contains it. */
+static void intersect_visit(void *key, void *value, void *info);
+
+/** \brief Builds a hash table with linear probing and `NULL` values from the given keys. */
+static upo_ht_linprob_t build_linprob(void **keys, size_t n);
+
+/** \brief Builds a hash set from the given keys. */
+static upo_hset_t build_hset(void **keys, size_t n);
+
+/** \brief Prints a line of the results table. */
+static void print_result(const char *set, double build, double intersect, size_t size);
+
+/** \brief Prints a usage message. */
+static void usage(const char *progname);
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void intersect_visit(void *key, void *value, void *info)
+{
+    struct intersect_context_s *ctx = info;
+
+    (void) value;
+
+    if (upo_ht_linprob_contains(ctx->large, key))
+    {
+        ctx->common[ctx->num_common++] = key;
+    }
+}
+
+upo_ht_linprob_t build_linprob(void **keys, size_t n)
+{
+    upo_ht_linprob_t ht = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+    void **values = calloc(BATCH_SIZE, sizeof(void*));
+    size_t i;
+
+    if (values == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for values");
+    }
+    /* Note: batch insertions are used since their load factor check does not
+     * scan the table for each key */
+    for (i = 0; i < n; i += BATCH_SIZE)
+    {
+        upo_ht_linprob_put_batch(ht, keys + i, values, (n - i < BATCH_SIZE) ? n - i : BATCH_SIZE, NULL);
+    }
+    free(values);
+
+    return ht;
+}
+
+upo_hset_t build_hset(void **keys, size_t n)
+{
+    upo_hset_t set = upo_hset_create(UPO_HSET_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+    size_t i;
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_hset_add(set, keys[i]);
+    }
+
+    return set;
+}
+
+void print_result(const char *set, double build, double intersect, size_t size)
+{
+    printf("%-16s  %12.6f  %14.6f  %10lu\n", set, build, intersect, size);
+}
+
+void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s {options}\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-k <value>: Specifies the number of keys of the larger set; the smaller one\n"
+                    "            has a quarter of them.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-t <value>: Specifies the number of threads of the parallel intersection.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_THREADS);
+    fprintf(stderr, "-v: Enables output verbosity.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_VERBOSE ? "enabled" : "disabled"));
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t opt_num_keys = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_num_threads = DEFAULT_OPT_NUM_THREADS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int opt_verbose = DEFAULT_OPT_VERBOSE;
+    int opt_help = 0;
+    int *ints = NULL;
+    void **keys = NULL;
+    size_t num_large = 0;
+    size_t num_small = 0;
+    upo_ht_linprob_t ht_large = NULL;
+    upo_ht_linprob_t ht_small = NULL;
+    upo_ht_linprob_t ht_common = NULL;
+    upo_hset_t set_large = NULL;
+    upo_hset_t set_small = NULL;
+    upo_hset_t set_common = NULL;
+    struct intersect_context_s ctx;
+    upo_hires_timer_t timer = NULL;
+    double build = 0;
+    size_t size = 0;
+    int arg;
+    size_t i;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-k", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_keys = atol(argv[arg]);
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-t", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of threads.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_threads = atol(argv[arg]);
+        }
+        else if (!strcmp("-v", argv[arg]))
+        {
+            opt_verbose = 1;
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    if (opt_num_keys < 4 || opt_num_keys > INT32_MAX/2)
+    {
+        fprintf(stderr, "ERROR: number of keys must be at least 4.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt_verbose)
+    {
+        printf("Options:\n");
+        printf("* Number of keys: %lu\n", opt_num_keys);
+        printf("* Number of threads: %lu\n", opt_num_threads);
+        printf("* Seed for random number generation: %u\n", opt_seed);
+    }
+
+    srand(opt_seed);
+
+    /* Keys of the larger set are drawn from twice as many integers, so
+     * about half of the keys of the smaller set are in the larger one */
+    num_large = opt_num_keys;
+    num_small = opt_num_keys / 4;
+    ints = malloc((num_large + num_small)*sizeof(int));
+    keys = malloc((num_large + num_small)*sizeof(void*));
+    ctx.common = malloc(num_small*sizeof(void*));
+    if (ints == NULL || keys == NULL || ctx.common == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+    for (i = 0; i < num_large + num_small; ++i)
+    {
+        ints[i] = upo_random_uniform_int(0, 2*(int) opt_num_keys - 1);
+        keys[i] = &ints[i];
+    }
+
+    timer = upo_hires_timer_create();
+
+    printf("%-16s  %12s  %14s  %10s\n", "set", "build (s)", "intersect (s)", "size");
+
+    /* Sets emulated by tables: the smaller table is traversed, and the keys
+     * it shares with the larger one are inserted in a new table */
+    upo_hires_timer_start(timer);
+    ht_large = build_linprob(keys, num_large);
+    ht_small = build_linprob(keys + num_large, num_small);
+    upo_hires_timer_stop(timer);
+    build = upo_hires_timer_elapsed(timer);
+
+    upo_hires_timer_start(timer);
+    ctx.large = ht_large;
+    ctx.num_common = 0;
+    upo_ht_linprob_traverse(ht_small, intersect_visit, &ctx);
+    ht_common = build_linprob(ctx.common, ctx.num_common);
+    upo_hires_timer_stop(timer);
+    size = ctx.num_common;
+    print_result("linprob", build, upo_hires_timer_elapsed(timer), size);
+
+    /* Hash sets */
+    upo_hires_timer_start(timer);
+    set_large = build_hset(keys, num_large);
+    set_small = build_hset(keys + num_large, num_small);
+    upo_hires_timer_stop(timer);
+    build = upo_hires_timer_elapsed(timer);
+
+    upo_hires_timer_start(timer);
+    set_common = upo_hset_intersect(set_large, set_small);
+    upo_hires_timer_stop(timer);
+    print_result("hset", build, upo_hires_timer_elapsed(timer), upo_hset_size(set_common));
+    if (upo_hset_size(set_common) != size)
+    {
+        fprintf(stderr, "ERROR: intersections have a different size.\n");
+        return EXIT_FAILURE;
+    }
+    upo_hset_destroy(set_common, 0);
+
+    upo_hires_timer_start(timer);
+    set_common = upo_hset_intersect_parallel(set_large, set_small, opt_num_threads);
+    upo_hires_timer_stop(timer);
+    print_result("hset (parallel)", build, upo_hires_timer_elapsed(timer), upo_hset_size(set_common));
+    if (upo_hset_size(set_common) != size)
+    {
+        fprintf(stderr, "ERROR: intersections have a different size.\n");
+        return EXIT_FAILURE;
+    }
+
+    if (opt_verbose)
+    {
+        /* Slots of tables hold the cached hash value, a key, a value and a
+         * deleted flag, while slots of sets only hold the hash value and the
+         * key */
+        printf("Larger set: %lu slots of the table, %lu slots of the set\n",
+               upo_ht_linprob_capacity(ht_large),
+               upo_hset_capacity(set_large));
+    }
+
+    upo_hset_destroy(set_common, 0);
+    upo_hset_destroy(set_small, 0);
+    upo_hset_destroy(set_large, 0);
+    upo_ht_linprob_destroy(ht_common, 0);
+    upo_ht_linprob_destroy(ht_small, 0);
+    upo_ht_linprob_destroy(ht_large, 0);
+    upo_hires_timer_destroy(timer);
+    free(ctx.common);
+    free(keys);
+    free(ints);
+
+    return 0;
+}
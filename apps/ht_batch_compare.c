@@ -0,0 +1,369 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/ht_batch_compare.c
+ *
+ * \brief An application to compare the throughput of batch hash table
+ *  operations against one-at-a-time operations on tables larger than the
+ *  cache.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+#include <upo/hires_timer.h>
+#include <upo/random.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 2000000
+#define DEFAULT_OPT_NUM_LOOKUPS (size_t) 4000000
+#define DEFAULT_OPT_BATCH_SIZE (size_t) 256
+#define DEFAULT_OPT_NUM_RUNS (size_t) 3
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_VERBOSE 0
+
+
+/** \brief Compares two integers. */
+static int int_compare(const void *a, const void *b);
+
+/** \brief Generates \a n pointers to keys chosen at random among the given \a num_keys ones. */
+static void** make_random_key_ptrs(int *keys, size_t num_keys, size_t n);
+
+/** \brief Returns the elapsed time (in seconds) of the given timer, or
+ *  the given best time if it is smaller. */
+static double best_time(upo_hires_timer_t timer, double best);
+
+/** \brief Prints a line of the results table. */
+static void print_result(const char *op, const char *table, size_t n, double loop_time, double batch_time);
+
+/** \brief Prints a usage message. */
+static void usage(const char *progname);
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void** make_random_key_ptrs(int *keys, size_t num_keys, size_t n)
+{
+    void **ptrs = NULL;
+    size_t i;
+
+    ptrs = malloc(n*sizeof(void*));
+    if (ptrs == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for key pointers");
+    }
+    for (i = 0; i < n; ++i)
+    {
+        ptrs[i] = &keys[upo_random_uniform_int(0, (int) num_keys - 1)];
+    }
+
+    return ptrs;
+}
+
+double best_time(upo_hires_timer_t timer, double best)
+{
+    double elapsed = upo_hires_timer_elapsed(timer);
+
+    return (best < 0 || elapsed < best) ? elapsed : best;
+}
+
+void print_result(const char *op, const char *table, size_t n, double loop_time, double batch_time)
+{
+    printf("%-4s  %-10s  %14.3f  %14.3f  %8.2f\n",
+           op,
+           table,
+           (loop_time > 0) ? n/loop_time*1.0e-6 : 0,
+           (batch_time > 0) ? n/batch_time*1.0e-6 : 0,
+           (batch_time > 0) ? loop_time/batch_time : 0);
+}
+
+void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s {options}\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-b <value>: Specifies the number of keys of each batch.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_BATCH_SIZE);
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-k <value>: Specifies the number of keys stored in the hash tables.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-n <value>: Specifies the number of lookups of each run.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_LOOKUPS);
+    fprintf(stderr, "-r <value>: Specifies the number of runs (the best one is reported).\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_RUNS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-v: Enables output verbosity.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_VERBOSE ? "enabled" : "disabled"));
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t opt_num_keys = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_num_lookups = DEFAULT_OPT_NUM_LOOKUPS;
+    size_t opt_batch_size = DEFAULT_OPT_BATCH_SIZE;
+    size_t opt_num_runs = DEFAULT_OPT_NUM_RUNS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int opt_verbose = DEFAULT_OPT_VERBOSE;
+    int opt_help = 0;
+    int *keys = NULL;
+    void **key_ptrs = NULL;
+    void **lookup_ptrs = NULL;
+    void **values = NULL;
+    upo_ht_sepchain_t sepchain_ht = NULL;
+    upo_ht_linprob_t linprob_ht = NULL;
+    upo_hires_timer_t timer = NULL;
+    double loop_time = -1;
+    double batch_time = -1;
+    size_t checksum = 0;
+    int arg;
+    size_t i;
+    size_t r;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-b", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected batch size.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_batch_size = atol(argv[arg]);
+        }
+        else if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-k", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_keys = atol(argv[arg]);
+        }
+        else if (!strcmp("-n", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of lookups.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_lookups = atol(argv[arg]);
+        }
+        else if (!strcmp("-r", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of runs.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_runs = atol(argv[arg]);
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-v", argv[arg]))
+        {
+            opt_verbose = 1;
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    if (opt_num_keys == 0 || opt_num_keys > INT32_MAX || opt_num_lookups == 0 || opt_batch_size == 0 || opt_num_runs == 0)
+    {
+        fprintf(stderr, "ERROR: number of keys, number of lookups, batch size and number of runs must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt_verbose)
+    {
+        printf("Options:\n");
+        printf("* Number of keys: %lu\n", opt_num_keys);
+        printf("* Number of lookups: %lu\n", opt_num_lookups);
+        printf("* Batch size: %lu\n", opt_batch_size);
+        printf("* Number of runs: %lu\n", opt_num_runs);
+        printf("* Seed for random number generation: %u\n", opt_seed);
+    }
+
+    srand(opt_seed);
+
+    keys = malloc(opt_num_keys*sizeof(int));
+    key_ptrs = malloc(opt_num_keys*sizeof(void*));
+    values = malloc(opt_num_lookups*sizeof(void*));
+    if (keys == NULL || key_ptrs == NULL || values == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+    for (i = 0; i < opt_num_keys; ++i)
+    {
+        keys[i] = (int) i;
+        key_ptrs[i] = &keys[i];
+    }
+    upo_random_shuffle(key_ptrs, opt_num_keys, sizeof(void*));
+    lookup_ptrs = make_random_key_ptrs(keys, opt_num_keys, opt_num_lookups);
+
+    timer = upo_hires_timer_create();
+
+    printf("%-4s  %-10s  %14s  %14s  %8s\n", "op", "table", "loop Mop/s", "batch Mop/s", "speedup");
+
+    /* Insertions in a separate chaining hash table */
+    for (r = 0; r < opt_num_runs; ++r)
+    {
+        sepchain_ht = upo_ht_sepchain_create(opt_num_keys, upo_ht_hash_int_mix, int_compare);
+        upo_hires_timer_start(timer);
+        for (i = 0; i < opt_num_keys; ++i)
+        {
+            upo_ht_sepchain_put(sepchain_ht, key_ptrs[i], key_ptrs[i]);
+        }
+        upo_hires_timer_stop(timer);
+        loop_time = best_time(timer, r == 0 ? -1 : loop_time);
+        upo_ht_sepchain_destroy(sepchain_ht, 0);
+
+        sepchain_ht = upo_ht_sepchain_create(opt_num_keys, upo_ht_hash_int_mix, int_compare);
+        upo_hires_timer_start(timer);
+        for (i = 0; i < opt_num_keys; i += opt_batch_size)
+        {
+            size_t n = (opt_num_keys - i < opt_batch_size) ? opt_num_keys - i : opt_batch_size;
+
+            upo_ht_sepchain_put_batch(sepchain_ht, key_ptrs + i, key_ptrs + i, n, NULL);
+        }
+        upo_hires_timer_stop(timer);
+        batch_time = best_time(timer, r == 0 ? -1 : batch_time);
+        if (r + 1 < opt_num_runs)
+        {
+            upo_ht_sepchain_destroy(sepchain_ht, 0);
+        }
+    }
+    print_result("put", "sepchain", opt_num_keys, loop_time, batch_time);
+
+    /* Lookups in a separate chaining hash table */
+    for (r = 0; r < opt_num_runs; ++r)
+    {
+        upo_hires_timer_start(timer);
+        for (i = 0; i < opt_num_lookups; ++i)
+        {
+            values[i] = upo_ht_sepchain_get(sepchain_ht, lookup_ptrs[i]);
+        }
+        upo_hires_timer_stop(timer);
+        loop_time = best_time(timer, r == 0 ? -1 : loop_time);
+        checksum += (size_t) *(int*) values[opt_num_lookups-1];
+
+        upo_hires_timer_start(timer);
+        for (i = 0; i < opt_num_lookups; i += opt_batch_size)
+        {
+            size_t n = (opt_num_lookups - i < opt_batch_size) ? opt_num_lookups - i : opt_batch_size;
+
+            upo_ht_sepchain_get_batch(sepchain_ht, lookup_ptrs + i, n, values + i);
+        }
+        upo_hires_timer_stop(timer);
+        batch_time = best_time(timer, r == 0 ? -1 : batch_time);
+        checksum += (size_t) *(int*) values[opt_num_lookups-1];
+    }
+    print_result("get", "sepchain", opt_num_lookups, loop_time, batch_time);
+
+    upo_ht_sepchain_destroy(sepchain_ht, 0);
+
+    /* Lookups in a linear probing hash table.
+     * Note: the table is loaded with batch insertions, whose load factor
+     * check does not scan the table for each key. */
+    linprob_ht = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+    for (i = 0; i < opt_num_keys; i += opt_batch_size)
+    {
+        size_t n = (opt_num_keys - i < opt_batch_size) ? opt_num_keys - i : opt_batch_size;
+
+        upo_ht_linprob_put_batch(linprob_ht, key_ptrs + i, key_ptrs + i, n, NULL);
+    }
+    for (r = 0; r < opt_num_runs; ++r)
+    {
+        upo_hires_timer_start(timer);
+        for (i = 0; i < opt_num_lookups; ++i)
+        {
+            values[i] = upo_ht_linprob_get(linprob_ht, lookup_ptrs[i]);
+        }
+        upo_hires_timer_stop(timer);
+        loop_time = best_time(timer, r == 0 ? -1 : loop_time);
+        checksum += (size_t) *(int*) values[opt_num_lookups-1];
+
+        upo_hires_timer_start(timer);
+        for (i = 0; i < opt_num_lookups; i += opt_batch_size)
+        {
+            size_t n = (opt_num_lookups - i < opt_batch_size) ? opt_num_lookups - i : opt_batch_size;
+
+            upo_ht_linprob_get_batch(linprob_ht, lookup_ptrs + i, n, values + i);
+        }
+        upo_hires_timer_stop(timer);
+        batch_time = best_time(timer, r == 0 ? -1 : batch_time);
+        checksum += (size_t) *(int*) values[opt_num_lookups-1];
+    }
+    print_result("get", "linprob", opt_num_lookups, loop_time, batch_time);
+
+    if (opt_verbose)
+    {
+        printf("Checksum: %lu\n", checksum);
+    }
+
+    upo_ht_linprob_destroy(linprob_ht, 0);
+    upo_hires_timer_destroy(timer);
+    free(lookup_ptrs);
+    free(values);
+    free(key_ptrs);
+    free(keys);
+
+    return 0;
+}
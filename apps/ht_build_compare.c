@@ -0,0 +1,275 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/ht_build_compare.c
+ *
+ * \brief An application to compare the bulk build of hash tables from arrays
+ *  of key-value pairs against insertions one pair at a time.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+#include <upo/hires_timer.h>
+#include <upo/random.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 1000000
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_VERBOSE 0
+
+/** \brief The number of keys inserted by each batch insertion. */
+#define BATCH_SIZE (size_t) 256
+
+
+/** \brief Compares two integers. */
+static int int_compare(const void *a, const void *b);
+
+/** \brief Prints a line of the results table. */
+static void print_result(const char *table, const char *method, double build, double lookups);
+
+/** \brief Prints a usage message. */
+static void usage(const char *progname);
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void print_result(const char *table, const char *method, double build, double lookups)
+{
+    printf("%-10s  %-10s  %12.6f  %12.6f\n", table, method, build, lookups);
+}
+
+void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s {options}\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-k <value>: Specifies the number of key-value pairs.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-v: Enables output verbosity.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_VERBOSE ? "enabled" : "disabled"));
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t opt_num_keys = DEFAULT_OPT_NUM_KEYS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int opt_verbose = DEFAULT_OPT_VERBOSE;
+    int opt_help = 0;
+    int *ints = NULL;
+    void **keys = NULL;
+    void **found = NULL;
+    upo_ht_sepchain_t sepchain = NULL;
+    upo_ht_linprob_t linprob = NULL;
+    upo_hires_timer_t timer = NULL;
+    double build = 0;
+    int method;
+    int arg;
+    size_t i;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-k", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_keys = atol(argv[arg]);
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-v", argv[arg]))
+        {
+            opt_verbose = 1;
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    if (opt_num_keys == 0 || opt_num_keys > INT32_MAX)
+    {
+        fprintf(stderr, "ERROR: number of keys must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt_verbose)
+    {
+        printf("Options:\n");
+        printf("* Number of keys: %lu\n", opt_num_keys);
+        printf("* Seed for random number generation: %u\n", opt_seed);
+    }
+
+    srand(opt_seed);
+
+    ints = malloc(opt_num_keys*sizeof(int));
+    keys = malloc(opt_num_keys*sizeof(void*));
+    found = malloc(opt_num_keys*sizeof(void*));
+    if (ints == NULL || keys == NULL || found == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+    /* Each key is also its own value */
+    for (i = 0; i < opt_num_keys; ++i)
+    {
+        ints[i] = upo_random_uniform_int(0, INT32_MAX - 1);
+        keys[i] = &ints[i];
+    }
+
+    timer = upo_hires_timer_create();
+
+    printf("%-10s  %-10s  %12s  %12s\n", "table", "method", "build (s)", "lookups (s)");
+
+    /* Separate chaining, with as many slots as pairs */
+    for (method = 0; method < 2; ++method)
+    {
+        upo_hires_timer_start(timer);
+        if (method == 0)
+        {
+            sepchain = upo_ht_sepchain_create(opt_num_keys, upo_ht_hash_int_mix, int_compare);
+            for (i = 0; i < opt_num_keys; ++i)
+            {
+                upo_ht_sepchain_put(sepchain, keys[i], keys[i]);
+            }
+        }
+        else
+        {
+            sepchain = upo_ht_sepchain_build(opt_num_keys, upo_ht_hash_int_mix, int_compare, keys, keys, opt_num_keys);
+        }
+        upo_hires_timer_stop(timer);
+        build = upo_hires_timer_elapsed(timer);
+
+        /* Lookups in insertion order walk lists whose nodes have been
+         * allocated in a different order by each method */
+        upo_hires_timer_start(timer);
+        upo_ht_sepchain_get_batch(sepchain, keys, opt_num_keys, found);
+        upo_hires_timer_stop(timer);
+        print_result("sepchain", (method == 0) ? "put" : "build", build, upo_hires_timer_elapsed(timer));
+
+        for (i = 0; i < opt_num_keys; ++i)
+        {
+            if (found[i] == NULL || *(int*) found[i] != ints[i])
+            {
+                fprintf(stderr, "ERROR: key not found.\n");
+                return EXIT_FAILURE;
+            }
+        }
+        upo_ht_sepchain_destroy(sepchain, 0);
+    }
+
+    /* Linear probing, growing from the default capacity unless built in
+     * bulk */
+    for (method = 0; method < 3; ++method)
+    {
+        const char *name[] = {"put", "put_batch", "build"};
+
+        upo_hires_timer_start(timer);
+        if (method == 0)
+        {
+            linprob = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+            for (i = 0; i < opt_num_keys; ++i)
+            {
+                upo_ht_linprob_put(linprob, keys[i], keys[i]);
+            }
+        }
+        else if (method == 1)
+        {
+            linprob = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+            for (i = 0; i < opt_num_keys; i += BATCH_SIZE)
+            {
+                size_t n = (opt_num_keys - i < BATCH_SIZE) ? opt_num_keys - i : BATCH_SIZE;
+
+                upo_ht_linprob_put_batch(linprob, keys + i, keys + i, n, NULL);
+            }
+        }
+        else
+        {
+            linprob = upo_ht_linprob_build(upo_ht_hash_int_mix, int_compare, keys, keys, opt_num_keys);
+        }
+        upo_hires_timer_stop(timer);
+        build = upo_hires_timer_elapsed(timer);
+
+        upo_hires_timer_start(timer);
+        upo_ht_linprob_get_batch(linprob, keys, opt_num_keys, found);
+        upo_hires_timer_stop(timer);
+        print_result("linprob", name[method], build, upo_hires_timer_elapsed(timer));
+
+        for (i = 0; i < opt_num_keys; ++i)
+        {
+            if (found[i] == NULL || *(int*) found[i] != ints[i])
+            {
+                fprintf(stderr, "ERROR: key not found.\n");
+                return EXIT_FAILURE;
+            }
+        }
+        if (opt_verbose)
+        {
+            upo_ht_stats_t stats;
+
+            upo_ht_linprob_stats(linprob, &stats);
+            printf("  %lu resizes in %.6f s, capacity %lu\n", stats.num_resizes, stats.resize_time, stats.capacity);
+        }
+        upo_ht_linprob_destroy(linprob, 0);
+    }
+
+    upo_hires_timer_destroy(timer);
+    free(found);
+    free(keys);
+    free(ints);
+
+    return 0;
+}
@@ -0,0 +1,433 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/ht_concurrent_compare.c
+ *
+ * \brief An application to compare the multi-threaded throughput of a hash
+ *  table protected by a single global lock against the lock-striped hash
+ *  table and the hash table with lock-free lookups.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Threads are a POSIX extension */
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+#include <upo/hashtable_concurrent.h>
+#include <upo/hires_timer.h>
+
+
+#define DEFAULT_OPT_MAX_THREADS (size_t) 8
+#define DEFAULT_OPT_NUM_KEYS (size_t) 100000
+#define DEFAULT_OPT_NUM_OPS (size_t) 1000000
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_VERBOSE 0
+#define NUM_WORKLOADS (size_t) 2
+
+
+/** \brief Defines the type of hash table implementations under comparison. */
+typedef enum {
+            global_lock_kind,
+            striped_kind,
+            rcu_kind
+        } table_kind_t;
+
+/** \brief A workload, that is a mix of read and write operations. */
+typedef struct {
+            const char *name;
+            unsigned int write_percent; /**< The percentage of operations that update the table. */
+        } workload_t;
+
+/** \brief A separate-chaining hash table protected by a single global mutex. */
+typedef struct {
+            upo_ht_sepchain_t ht;
+            pthread_mutex_t lock;
+        } global_lock_table_t;
+
+/** \brief The work assigned to a benchmark thread. */
+typedef struct {
+            table_kind_t kind;
+            global_lock_table_t *global_table;
+            upo_ht_striped_t striped_table;
+            upo_ht_rcu_t rcu_table;
+            int *keys; /**< The key universe shared by all threads. */
+            size_t num_keys; /**< The number of keys in the universe. */
+            size_t num_ops; /**< The number of operations to perform. */
+            unsigned int write_percent; /**< The percentage of write operations. */
+            uint64_t rng_state; /**< The state of the per-thread random number generator. */
+            size_t num_hits; /**< The number of successful lookups (prevents dead-code elimination). */
+        } thread_work_t;
+
+
+/** \brief Returns the next number of a xorshift64 random number generator. */
+static uint64_t xorshift64(uint64_t *state);
+
+/** \brief Compares two integers. */
+static int int_compare(const void *a, const void *b);
+
+/** \brief Runs the operations assigned to a thread. */
+static void* run_thread(void *arg);
+
+/** \brief Measures the throughput (in millions of operations per second) of
+ *  the given table kind for the given workload and number of threads. */
+static double run_benchmark(table_kind_t kind, const workload_t *workload, size_t num_threads, int *keys, size_t num_keys, size_t num_ops, unsigned int seed);
+
+/** \brief Prints a usage message. */
+static void usage(const char *progname);
+
+
+static const workload_t workloads[NUM_WORKLOADS] = {
+            {"read-mostly (95% get, 5% put/delete)", 5},
+            {"write-heavy (50% get, 50% put/delete)", 50}
+        };
+
+
+uint64_t xorshift64(uint64_t *state)
+{
+    uint64_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+
+    return x;
+}
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void* run_thread(void *arg)
+{
+    thread_work_t *work = arg;
+    size_t i;
+
+    for (i = 0; i < work->num_ops; ++i)
+    {
+        uint64_t r = xorshift64(&work->rng_state);
+        int *key = &work->keys[(r >> 8) % work->num_keys];
+        int is_write = (r & 0xFF) % 100 < work->write_percent;
+        int is_delete = (r >> 63) != 0;
+
+        if (work->kind == global_lock_kind)
+        {
+            pthread_mutex_lock(&work->global_table->lock);
+            if (!is_write)
+            {
+                work->num_hits += upo_ht_sepchain_contains(work->global_table->ht, key);
+            }
+            else if (is_delete)
+            {
+                upo_ht_sepchain_delete(work->global_table->ht, key, 0);
+            }
+            else
+            {
+                upo_ht_sepchain_put(work->global_table->ht, key, key);
+            }
+            pthread_mutex_unlock(&work->global_table->lock);
+        }
+        else if (work->kind == striped_kind)
+        {
+            if (!is_write)
+            {
+                work->num_hits += upo_ht_striped_contains(work->striped_table, key);
+            }
+            else if (is_delete)
+            {
+                upo_ht_striped_delete(work->striped_table, key, 0);
+            }
+            else
+            {
+                upo_ht_striped_put(work->striped_table, key, key);
+            }
+        }
+        else
+        {
+            if (!is_write)
+            {
+                work->num_hits += upo_ht_rcu_contains(work->rcu_table, key);
+            }
+            else if (is_delete)
+            {
+                upo_ht_rcu_delete(work->rcu_table, key, 0);
+            }
+            else
+            {
+                upo_ht_rcu_put(work->rcu_table, key, key);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+double run_benchmark(table_kind_t kind, const workload_t *workload, size_t num_threads, int *keys, size_t num_keys, size_t num_ops, unsigned int seed)
+{
+    global_lock_table_t global_table;
+    upo_ht_striped_t striped_table = NULL;
+    upo_ht_rcu_t rcu_table = NULL;
+    pthread_t *threads = NULL;
+    thread_work_t *works = NULL;
+    upo_hires_timer_t timer = NULL;
+    double elapsed = 0;
+    size_t i;
+
+    threads = malloc(num_threads*sizeof(pthread_t));
+    works = malloc(num_threads*sizeof(thread_work_t));
+    if (threads == NULL || works == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for threads");
+    }
+
+    /* All tables start half full and are sized for the whole key universe,
+     * since the separate-chaining table never resizes */
+    if (kind == global_lock_kind)
+    {
+        global_table.ht = upo_ht_sepchain_create(num_keys, upo_ht_hash_int_mix, int_compare);
+        pthread_mutex_init(&global_table.lock, NULL);
+        for (i = 0; i < num_keys; i += 2)
+        {
+            upo_ht_sepchain_put(global_table.ht, &keys[i], &keys[i]);
+        }
+    }
+    else if (kind == striped_kind)
+    {
+        striped_table = upo_ht_striped_create(num_keys, UPO_HT_STRIPED_DEFAULT_NUM_STRIPES, upo_ht_hash_int_mix, int_compare);
+        for (i = 0; i < num_keys; i += 2)
+        {
+            upo_ht_striped_put(striped_table, &keys[i], &keys[i]);
+        }
+    }
+    else
+    {
+        rcu_table = upo_ht_rcu_create(num_keys, UPO_HT_RCU_DEFAULT_NUM_STRIPES, upo_ht_hash_int_mix, int_compare);
+        for (i = 0; i < num_keys; i += 2)
+        {
+            upo_ht_rcu_put(rcu_table, &keys[i], &keys[i]);
+        }
+    }
+
+    for (i = 0; i < num_threads; ++i)
+    {
+        works[i].kind = kind;
+        works[i].global_table = &global_table;
+        works[i].striped_table = striped_table;
+        works[i].rcu_table = rcu_table;
+        works[i].keys = keys;
+        works[i].num_keys = num_keys;
+        works[i].num_ops = num_ops/num_threads;
+        works[i].write_percent = workload->write_percent;
+        /* The state of xorshift64 must be nonzero */
+        works[i].rng_state = upo_ht_hash_mix64(((uint64_t) seed << 32) | i) | 1;
+        works[i].num_hits = 0;
+    }
+
+    timer = upo_hires_timer_create();
+    upo_hires_timer_start(timer);
+
+    for (i = 0; i < num_threads; ++i)
+    {
+        if (pthread_create(&threads[i], NULL, run_thread, &works[i]) != 0)
+        {
+            upo_throw_sys_error("Unable to create a thread");
+        }
+    }
+    for (i = 0; i < num_threads; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    upo_hires_timer_stop(timer);
+    elapsed = upo_hires_timer_elapsed(timer);
+    upo_hires_timer_destroy(timer);
+
+    if (kind == global_lock_kind)
+    {
+        pthread_mutex_destroy(&global_table.lock);
+        upo_ht_sepchain_destroy(global_table.ht, 0);
+    }
+    else if (kind == striped_kind)
+    {
+        upo_ht_striped_destroy(striped_table, 0);
+    }
+    else
+    {
+        upo_ht_rcu_destroy(rcu_table, 0);
+    }
+
+    free(works);
+    free(threads);
+
+    return (elapsed > 0) ? (num_ops/num_threads*num_threads)/elapsed*1.0e-6 : 0;
+}
+
+void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s {options}\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-k <value>: Specifies the number of distinct keys.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-n <value>: Specifies the total number of operations of each run.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_OPS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-t <value>: Specifies the maximum number of threads (runs use 1, 2, 4, ... threads).\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_MAX_THREADS);
+    fprintf(stderr, "-v: Enables output verbosity.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_VERBOSE ? "enabled" : "disabled"));
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t opt_max_threads = DEFAULT_OPT_MAX_THREADS;
+    size_t opt_num_keys = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_num_ops = DEFAULT_OPT_NUM_OPS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int opt_verbose = DEFAULT_OPT_VERBOSE;
+    int opt_help = 0;
+    int *keys = NULL;
+    int arg;
+    size_t i;
+    size_t w;
+    size_t t;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-k", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_keys = atol(argv[arg]);
+        }
+        else if (!strcmp("-n", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of operations.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_ops = atol(argv[arg]);
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-t", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of threads.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_max_threads = atol(argv[arg]);
+        }
+        else if (!strcmp("-v", argv[arg]))
+        {
+            opt_verbose = 1;
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    if (opt_max_threads == 0 || opt_num_keys == 0 || opt_num_ops == 0)
+    {
+        fprintf(stderr, "ERROR: number of threads, keys and operations must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt_verbose)
+    {
+        printf("Options:\n");
+        printf("* Maximum number of threads: %lu\n", opt_max_threads);
+        printf("* Number of keys: %lu\n", opt_num_keys);
+        printf("* Number of operations: %lu\n", opt_num_ops);
+        printf("* Seed for random number generation: %u\n", opt_seed);
+    }
+
+    keys = malloc(opt_num_keys*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+    for (i = 0; i < opt_num_keys; ++i)
+    {
+        keys[i] = (int) i;
+    }
+
+    for (w = 0; w < NUM_WORKLOADS; ++w)
+    {
+        printf("Workload: %s\n", workloads[w].name);
+        printf("%8s  %18s  %18s  %18s\n", "threads", "global lock Mop/s", "striped Mop/s", "lock-free Mop/s");
+        for (t = 1; t <= opt_max_threads; t *= 2)
+        {
+            double global_tput = run_benchmark(global_lock_kind, &workloads[w], t, keys, opt_num_keys, opt_num_ops, opt_seed);
+            double striped_tput = run_benchmark(striped_kind, &workloads[w], t, keys, opt_num_keys, opt_num_ops, opt_seed);
+            double rcu_tput = run_benchmark(rcu_kind, &workloads[w], t, keys, opt_num_keys, opt_num_ops, opt_seed);
+
+            printf("%8lu  %18.3f  %18.3f  %18.3f\n", t, global_tput, striped_tput, rcu_tput);
+        }
+    }
+
+    free(keys);
+
+    return 0;
+}
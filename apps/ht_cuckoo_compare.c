@@ -0,0 +1,338 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/ht_cuckoo_compare.c
+ *
+ * \brief An application to compare the tail latency of lookups in hash tables
+ *  with separate chaining, linear probing and cuckoo hashing.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+#include <upo/random.h>
+#include <upo/sort.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 1000000
+#define DEFAULT_OPT_NUM_LOOKUPS (size_t) 1000000
+#define DEFAULT_OPT_MISS_RATE 0.0
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_VERBOSE 0
+
+/** \brief The number of keys inserted by each batch insertion. */
+#define BATCH_SIZE (size_t) 256
+
+
+/** \brief Returns the seconds elapsed since the given time, with nanosecond resolution. */
+static double elapsed_since(const struct timespec *start);
+
+/** \brief Compares two integers. */
+static int int_compare(const void *a, const void *b);
+
+/** \brief Compares two latencies. */
+static int double_compare(const void *a, const void *b);
+
+/** \brief Returns the p-th percentile of the given sorted latencies. */
+static double percentile(const double *latencies, size_t n, double p);
+
+/** \brief Sorts the given latencies and prints a line of the results table. */
+static void print_result(const char *table, double *latencies, size_t n);
+
+/** \brief Prints a usage message. */
+static void usage(const char *progname);
+
+
+double elapsed_since(const struct timespec *start)
+{
+    struct timespec stop;
+
+    /* Note: the high-resolution timer has microsecond resolution, which is
+     * too coarse to time a single lookup */
+    timespec_get(&stop, TIME_UTC);
+
+    return (stop.tv_sec - start->tv_sec) + (stop.tv_nsec - start->tv_nsec)*1e-9;
+}
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+int double_compare(const void *a, const void *b)
+{
+    const double *aa = a;
+    const double *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+double percentile(const double *latencies, size_t n, double p)
+{
+    size_t i = (size_t) (p*(n - 1)/100.0 + 0.5);
+
+    return latencies[i];
+}
+
+void print_result(const char *table, double *latencies, size_t n)
+{
+    upo_merge_sort(latencies, n, sizeof(double), double_compare);
+
+    /* Latencies are printed in nanoseconds */
+    printf("%-12s  %10.1f  %10.1f  %10.1f  %10.1f\n",
+           table,
+           percentile(latencies, n, 50)*1e9,
+           percentile(latencies, n, 99)*1e9,
+           percentile(latencies, n, 99.9)*1e9,
+           latencies[n - 1]*1e9);
+}
+
+void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s {options}\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-k <value>: Specifies the number of keys stored in the hash tables.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-m <value>: Specifies the fraction (between 0 and 1) of lookups of missing keys.\n"
+                    "            [default: %g]\n", DEFAULT_OPT_MISS_RATE);
+    fprintf(stderr, "-n <value>: Specifies the number of timed lookups.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_LOOKUPS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-v: Enables output verbosity.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_VERBOSE ? "enabled" : "disabled"));
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t opt_num_keys = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_num_lookups = DEFAULT_OPT_NUM_LOOKUPS;
+    double opt_miss_rate = DEFAULT_OPT_MISS_RATE;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int opt_verbose = DEFAULT_OPT_VERBOSE;
+    int opt_help = 0;
+    int *keys = NULL;
+    int *lookups = NULL;
+    void **key_ptrs = NULL;
+    double *latencies = NULL;
+    upo_ht_sepchain_t sepchain = NULL;
+    upo_ht_linprob_t linprob = NULL;
+    upo_ht_cuckoo_t cuckoo = NULL;
+    size_t found = 0;
+    struct timespec start;
+    int arg;
+    size_t i;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-k", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_keys = atol(argv[arg]);
+        }
+        else if (!strcmp("-m", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected fraction of missing keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_miss_rate = atof(argv[arg]);
+        }
+        else if (!strcmp("-n", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of lookups.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_lookups = atol(argv[arg]);
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-v", argv[arg]))
+        {
+            opt_verbose = 1;
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    if (opt_num_keys == 0 || opt_num_keys > INT32_MAX/2)
+    {
+        fprintf(stderr, "ERROR: number of keys must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (opt_num_lookups == 0)
+    {
+        fprintf(stderr, "ERROR: number of lookups must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (opt_miss_rate < 0 || opt_miss_rate > 1)
+    {
+        fprintf(stderr, "ERROR: fraction of missing keys must be between 0 and 1.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt_verbose)
+    {
+        printf("Options:\n");
+        printf("* Number of keys: %lu\n", opt_num_keys);
+        printf("* Number of lookups: %lu\n", opt_num_lookups);
+        printf("* Fraction of missing keys: %g\n", opt_miss_rate);
+        printf("* Seed for random number generation: %u\n", opt_seed);
+    }
+
+    srand(opt_seed);
+
+    /* Stored keys are even, so that odd keys are surely missing */
+    keys = malloc(opt_num_keys*sizeof(int));
+    key_ptrs = malloc(opt_num_keys*sizeof(void*));
+    lookups = malloc(opt_num_lookups*sizeof(int));
+    latencies = malloc(opt_num_lookups*sizeof(double));
+    if (keys == NULL || key_ptrs == NULL || lookups == NULL || latencies == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+    for (i = 0; i < opt_num_keys; ++i)
+    {
+        keys[i] = (int) (2*i);
+        key_ptrs[i] = &keys[i];
+    }
+    upo_random_shuffle(key_ptrs, opt_num_keys, sizeof(void*));
+    for (i = 0; i < opt_num_lookups; ++i)
+    {
+        int miss = (rand() < opt_miss_rate*((double) RAND_MAX + 1));
+
+        lookups[i] = 2*upo_random_uniform_int(0, (int) opt_num_keys - 1) + miss;
+    }
+
+    /* Every table is sized for the number of keys.
+     * Note: batch insertions are used since their load factor check does not
+     * scan the table for each key. */
+    sepchain = upo_ht_sepchain_create(opt_num_keys, upo_ht_hash_int_mix, int_compare);
+    linprob = upo_ht_linprob_create(2*opt_num_keys, upo_ht_hash_int_mix, int_compare);
+    cuckoo = upo_ht_cuckoo_create(opt_num_keys, upo_ht_hash_int_mix, int_compare);
+    for (i = 0; i < opt_num_keys; i += BATCH_SIZE)
+    {
+        size_t n = (opt_num_keys - i < BATCH_SIZE) ? opt_num_keys - i : BATCH_SIZE;
+
+        upo_ht_sepchain_put_batch(sepchain, key_ptrs + i, key_ptrs + i, n, NULL);
+        upo_ht_linprob_put_batch(linprob, key_ptrs + i, key_ptrs + i, n, NULL);
+    }
+    for (i = 0; i < opt_num_keys; ++i)
+    {
+        upo_ht_cuckoo_put(cuckoo, key_ptrs[i], key_ptrs[i]);
+    }
+
+    if (opt_verbose)
+    {
+        printf("Load factors: separate chaining %g, linear probing %g, cuckoo hashing %g (%lu keys in the stash)\n",
+               upo_ht_sepchain_load_factor(sepchain),
+               upo_ht_linprob_load_factor(linprob),
+               upo_ht_cuckoo_load_factor(cuckoo),
+               upo_ht_cuckoo_stash_size(cuckoo));
+    }
+
+    printf("%-12s  %10s  %10s  %10s  %10s\n", "table", "p50 (ns)", "p99 (ns)", "p99.9 (ns)", "max (ns)");
+
+    /* Each lookup is timed alone, so latencies include the clock overhead */
+    for (i = 0; i < opt_num_lookups; ++i)
+    {
+        timespec_get(&start, TIME_UTC);
+        found += (upo_ht_sepchain_get(sepchain, &lookups[i]) != NULL);
+        latencies[i] = elapsed_since(&start);
+    }
+    print_result("sepchain", latencies, opt_num_lookups);
+
+    for (i = 0; i < opt_num_lookups; ++i)
+    {
+        timespec_get(&start, TIME_UTC);
+        found -= (upo_ht_linprob_get(linprob, &lookups[i]) != NULL);
+        latencies[i] = elapsed_since(&start);
+    }
+    print_result("linprob", latencies, opt_num_lookups);
+
+    for (i = 0; i < opt_num_lookups; ++i)
+    {
+        timespec_get(&start, TIME_UTC);
+        found += (upo_ht_cuckoo_get(cuckoo, &lookups[i]) != NULL);
+        latencies[i] = elapsed_since(&start);
+    }
+    print_result("cuckoo", latencies, opt_num_lookups);
+
+    if (opt_verbose)
+    {
+        printf("Found keys: %lu\n", found);
+    }
+
+    upo_ht_cuckoo_destroy(cuckoo, 0);
+    upo_ht_linprob_destroy(linprob, 0);
+    upo_ht_sepchain_destroy(sepchain, 0);
+    free(latencies);
+    free(lookups);
+    free(key_ptrs);
+    free(keys);
+
+    return 0;
+}
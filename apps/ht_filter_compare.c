@@ -0,0 +1,306 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/ht_filter_compare.c
+ *
+ * \brief An application to measure how a filter attached in front of a hash
+ *  table with separate chaining speeds up lookups of missing keys.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+#include <upo/hires_timer.h>
+#include <upo/random.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 1000000
+#define DEFAULT_OPT_LOAD_FACTOR 4.0
+#define DEFAULT_OPT_FPR 0.01
+#define DEFAULT_OPT_MISS_RATE 0.9
+#define DEFAULT_OPT_NUM_LOOKUPS (size_t) 10000000
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_VERBOSE 0
+
+
+/** \brief Compares two integers. */
+static int int_compare(const void *a, const void *b);
+
+/** \brief Looks up the given keys and returns the number of found ones. */
+static size_t lookup_all(const upo_ht_sepchain_t ht, const int *lookups, size_t n);
+
+/** \brief Prints a usage message. */
+static void usage(const char *progname);
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+size_t lookup_all(const upo_ht_sepchain_t ht, const int *lookups, size_t n)
+{
+    size_t found = 0;
+    size_t i;
+
+    for (i = 0; i < n; ++i)
+    {
+        found += upo_ht_sepchain_contains(ht, &lookups[i]);
+    }
+
+    return found;
+}
+
+void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s {options}\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-f <value>: Specifies the false positive rate of the filter.\n"
+                    "            [default: %g]\n", DEFAULT_OPT_FPR);
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-k <value>: Specifies the number of keys stored in the hash table.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-l <value>: Specifies the load factor of the hash table.\n"
+                    "            [default: %g]\n", DEFAULT_OPT_LOAD_FACTOR);
+    fprintf(stderr, "-m <value>: Specifies the fraction (between 0 and 1) of lookups of missing keys.\n"
+                    "            [default: %g]\n", DEFAULT_OPT_MISS_RATE);
+    fprintf(stderr, "-n <value>: Specifies the number of lookups.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_LOOKUPS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-v: Enables output verbosity.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_VERBOSE ? "enabled" : "disabled"));
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t opt_num_keys = DEFAULT_OPT_NUM_KEYS;
+    double opt_load_factor = DEFAULT_OPT_LOAD_FACTOR;
+    double opt_fpr = DEFAULT_OPT_FPR;
+    double opt_miss_rate = DEFAULT_OPT_MISS_RATE;
+    size_t opt_num_lookups = DEFAULT_OPT_NUM_LOOKUPS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int opt_verbose = DEFAULT_OPT_VERBOSE;
+    int opt_help = 0;
+    int *keys = NULL;
+    int *lookups = NULL;
+    void **key_ptrs = NULL;
+    upo_ht_sepchain_t ht = NULL;
+    upo_hires_timer_t timer = NULL;
+    size_t found[2] = {0, 0};
+    double elapsed[2] = {0, 0};
+    int arg;
+    size_t i;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-f", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected false positive rate.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_fpr = atof(argv[arg]);
+        }
+        else if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-k", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_keys = atol(argv[arg]);
+        }
+        else if (!strcmp("-l", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected load factor.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_load_factor = atof(argv[arg]);
+        }
+        else if (!strcmp("-m", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected fraction of missing keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_miss_rate = atof(argv[arg]);
+        }
+        else if (!strcmp("-n", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of lookups.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_lookups = atol(argv[arg]);
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-v", argv[arg]))
+        {
+            opt_verbose = 1;
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    if (opt_num_keys == 0 || opt_num_keys > INT32_MAX/2)
+    {
+        fprintf(stderr, "ERROR: number of keys must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (opt_load_factor <= 0)
+    {
+        fprintf(stderr, "ERROR: load factor must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (opt_fpr <= 0 || opt_fpr >= 1)
+    {
+        fprintf(stderr, "ERROR: false positive rate must be between 0 and 1.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (opt_miss_rate < 0 || opt_miss_rate > 1)
+    {
+        fprintf(stderr, "ERROR: fraction of missing keys must be between 0 and 1.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt_verbose)
+    {
+        printf("Options:\n");
+        printf("* Number of keys: %lu\n", opt_num_keys);
+        printf("* Load factor: %g\n", opt_load_factor);
+        printf("* False positive rate: %g\n", opt_fpr);
+        printf("* Fraction of missing keys: %g\n", opt_miss_rate);
+        printf("* Number of lookups: %lu\n", opt_num_lookups);
+        printf("* Seed for random number generation: %u\n", opt_seed);
+    }
+
+    srand(opt_seed);
+
+    /* Stored keys are even, so that odd keys are surely missing */
+    keys = malloc(opt_num_keys*sizeof(int));
+    key_ptrs = malloc(opt_num_keys*sizeof(void*));
+    lookups = malloc(opt_num_lookups*sizeof(int));
+    if (keys == NULL || key_ptrs == NULL || lookups == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+    for (i = 0; i < opt_num_keys; ++i)
+    {
+        keys[i] = (int) (2*i);
+        key_ptrs[i] = &keys[i];
+    }
+    upo_random_shuffle(key_ptrs, opt_num_keys, sizeof(void*));
+    for (i = 0; i < opt_num_lookups; ++i)
+    {
+        int miss = (rand() < opt_miss_rate*((double) RAND_MAX + 1));
+
+        lookups[i] = 2*upo_random_uniform_int(0, (int) opt_num_keys - 1) + miss;
+    }
+
+    ht = upo_ht_sepchain_create((size_t) (opt_num_keys/opt_load_factor) + 1, upo_ht_hash_int_mix, int_compare);
+    upo_ht_sepchain_put_batch(ht, key_ptrs, key_ptrs, opt_num_keys, NULL);
+
+    timer = upo_hires_timer_create();
+
+    upo_hires_timer_start(timer);
+    found[0] = lookup_all(ht, lookups, opt_num_lookups);
+    upo_hires_timer_stop(timer);
+    elapsed[0] = upo_hires_timer_elapsed(timer);
+
+    upo_ht_sepchain_attach_filter(ht, opt_num_keys, opt_fpr);
+
+    upo_hires_timer_start(timer);
+    found[1] = lookup_all(ht, lookups, opt_num_lookups);
+    upo_hires_timer_stop(timer);
+    elapsed[1] = upo_hires_timer_elapsed(timer);
+
+    /* The filter must not change the result of lookups */
+    if (found[0] != found[1])
+    {
+        fprintf(stderr, "ERROR: lookups with and without the filter found different keys.\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("%-12s  %12s\n", "table", "lookups (s)");
+    printf("%-12s  %12.6f\n", "no filter", elapsed[0]);
+    printf("%-12s  %12.6f\n", "filter", elapsed[1]);
+
+    if (opt_verbose)
+    {
+        printf("Found keys: %lu of %lu\n", found[0], opt_num_lookups);
+    }
+
+    upo_hires_timer_destroy(timer);
+    upo_ht_sepchain_destroy(ht, 0);
+    free(lookups);
+    free(key_ptrs);
+    free(keys);
+
+    return 0;
+}
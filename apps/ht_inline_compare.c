@@ -0,0 +1,275 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/ht_inline_compare.c
+ *
+ * \brief An application to compare an integer-keyed hash table storing keys
+ *  and values inline against one storing pointers to heap-allocated ones.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+#include <upo/hires_timer.h>
+#include <upo/random.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 1000000
+#define DEFAULT_OPT_NUM_LOOKUPS (size_t) 10000000
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_VERBOSE 0
+
+/** \brief The number of keys inserted by each batch insertion. */
+#define BATCH_SIZE (size_t) 256
+
+
+/** \brief Compares two integers. */
+static int int_compare(const void *a, const void *b);
+
+/** \brief Prints a line of the results table. */
+static void print_result(const char *table, double build, double lookups);
+
+/** \brief Prints a usage message. */
+static void usage(const char *progname);
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void print_result(const char *table, double build, double lookups)
+{
+    printf("%-12s  %12.6f  %12.6f\n", table, build, lookups);
+}
+
+void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s {options}\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-k <value>: Specifies the number of keys stored in the hash tables.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-n <value>: Specifies the number of lookups.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_LOOKUPS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-v: Enables output verbosity.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_VERBOSE ? "enabled" : "disabled"));
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t opt_num_keys = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_num_lookups = DEFAULT_OPT_NUM_LOOKUPS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int opt_verbose = DEFAULT_OPT_VERBOSE;
+    int opt_help = 0;
+    int *lookups = NULL;
+    void **keys = NULL;
+    void **values = NULL;
+    upo_ht_linprob_t linprob = NULL;
+    upo_ht_inline_t inl = NULL;
+    upo_hires_timer_t timer = NULL;
+    double build = 0;
+    long checksum = 0;
+    int arg;
+    size_t i;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-k", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_keys = atol(argv[arg]);
+        }
+        else if (!strcmp("-n", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of lookups.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_lookups = atol(argv[arg]);
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-v", argv[arg]))
+        {
+            opt_verbose = 1;
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    if (opt_num_keys == 0 || opt_num_keys > INT32_MAX)
+    {
+        fprintf(stderr, "ERROR: number of keys must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt_verbose)
+    {
+        printf("Options:\n");
+        printf("* Number of keys: %lu\n", opt_num_keys);
+        printf("* Number of lookups: %lu\n", opt_num_lookups);
+        printf("* Seed for random number generation: %u\n", opt_seed);
+    }
+
+    srand(opt_seed);
+
+    lookups = malloc(opt_num_lookups*sizeof(int));
+    keys = malloc(opt_num_keys*sizeof(void*));
+    values = malloc(opt_num_keys*sizeof(void*));
+    if (lookups == NULL || keys == NULL || values == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+    for (i = 0; i < opt_num_lookups; ++i)
+    {
+        lookups[i] = upo_random_uniform_int(0, (int) opt_num_keys - 1);
+    }
+
+    timer = upo_hires_timer_create();
+
+    printf("%-12s  %12s  %12s\n", "table", "build (s)", "lookups (s)");
+
+    /* Pointer-based table: every key and every value is allocated on its own,
+     * as an int-to-int map needs.
+     * Note: batch insertions are used since their load factor check does not
+     * scan the table for each key. */
+    upo_hires_timer_start(timer);
+    for (i = 0; i < opt_num_keys; ++i)
+    {
+        int *key = malloc(sizeof(int));
+        int *value = malloc(sizeof(int));
+
+        if (key == NULL || value == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for key-value pair");
+        }
+        *key = (int) i;
+        *value = 2*(*key);
+        keys[i] = key;
+        values[i] = value;
+    }
+    linprob = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+    for (i = 0; i < opt_num_keys; i += BATCH_SIZE)
+    {
+        size_t n = (opt_num_keys - i < BATCH_SIZE) ? opt_num_keys - i : BATCH_SIZE;
+
+        upo_ht_linprob_put_batch(linprob, keys + i, values + i, n, NULL);
+    }
+    upo_hires_timer_stop(timer);
+    build = upo_hires_timer_elapsed(timer);
+
+    upo_hires_timer_start(timer);
+    for (i = 0; i < opt_num_lookups; ++i)
+    {
+        checksum += *(int*) upo_ht_linprob_get(linprob, &lookups[i]);
+    }
+    upo_hires_timer_stop(timer);
+    print_result("pointers", build, upo_hires_timer_elapsed(timer));
+
+    upo_ht_linprob_destroy(linprob, 1);
+
+    /* Inline table: pairs are copied into the slot array */
+    upo_hires_timer_start(timer);
+    inl = upo_ht_inline_create(UPO_HT_INLINE_DEFAULT_CAPACITY, sizeof(int), sizeof(int), NULL, NULL);
+    for (i = 0; i < opt_num_keys; ++i)
+    {
+        int key = (int) i;
+        int value = 2*key;
+
+        upo_ht_inline_put(inl, &key, &value);
+    }
+    upo_hires_timer_stop(timer);
+    build = upo_hires_timer_elapsed(timer);
+
+    upo_hires_timer_start(timer);
+    for (i = 0; i < opt_num_lookups; ++i)
+    {
+        checksum -= *(int*) upo_ht_inline_get(inl, &lookups[i]);
+    }
+    upo_hires_timer_stop(timer);
+    print_result("inline", build, upo_hires_timer_elapsed(timer));
+
+    /* Lookups must have found the same values */
+    if (checksum != 0)
+    {
+        fprintf(stderr, "ERROR: hash tables returned different values.\n");
+        return EXIT_FAILURE;
+    }
+
+    if (opt_verbose)
+    {
+        /* Pointer-based slots hold the cached hash value, two pointers and a
+         * deleted flag, and each pair also takes two heap blocks */
+        printf("Inline table: %lu bytes for %lu keys (%.1f bytes per key)\n",
+               upo_ht_inline_memory_usage(inl),
+               upo_ht_inline_size(inl),
+               upo_ht_inline_memory_usage(inl) / (double) upo_ht_inline_size(inl));
+    }
+
+    upo_ht_inline_destroy(inl);
+    upo_hires_timer_destroy(timer);
+    free(values);
+    free(keys);
+    free(lookups);
+
+    return 0;
+}
@@ -0,0 +1,279 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/ht_olist_compare.c
+ *
+ * \brief An application to compare lookups in hash tables with separate
+ *  chaining based on unordered and on ordered lists, when most lookups are
+ *  unsuccessful.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+#include <upo/hires_timer.h>
+#include <upo/random.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 100000
+#define DEFAULT_OPT_NUM_LOOKUPS (size_t) 1000000
+#define DEFAULT_OPT_MISS_PERCENT (size_t) 90
+#define DEFAULT_OPT_NUM_RUNS (size_t) 3
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_VERBOSE 0
+#define NUM_LOAD_FACTORS (size_t) 4
+
+
+/** \brief The load factors the hash tables are compared at. */
+static const size_t load_factors[NUM_LOAD_FACTORS] = {1, 4, 16, 64};
+
+
+/** \brief Compares two integers. */
+static int int_compare(const void *a, const void *b);
+
+/** \brief Prints a usage message. */
+static void usage(const char *progname);
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s {options}\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-k <value>: Specifies the number of keys stored in the hash tables.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-m <value>: Specifies the percentage of unsuccessful lookups.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_MISS_PERCENT);
+    fprintf(stderr, "-n <value>: Specifies the number of lookups of each run.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_LOOKUPS);
+    fprintf(stderr, "-r <value>: Specifies the number of runs (the best one is reported).\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_RUNS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-v: Enables output verbosity.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_VERBOSE ? "enabled" : "disabled"));
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t opt_num_keys = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_num_lookups = DEFAULT_OPT_NUM_LOOKUPS;
+    size_t opt_miss_percent = DEFAULT_OPT_MISS_PERCENT;
+    size_t opt_num_runs = DEFAULT_OPT_NUM_RUNS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int opt_verbose = DEFAULT_OPT_VERBOSE;
+    int opt_help = 0;
+    int *keys = NULL;
+    int *lookups = NULL;
+    upo_hires_timer_t timer = NULL;
+    size_t num_hits = 0;
+    int arg;
+    size_t i;
+    size_t l;
+    size_t r;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-k", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_keys = atol(argv[arg]);
+        }
+        else if (!strcmp("-m", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected percentage of unsuccessful lookups.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_miss_percent = atol(argv[arg]);
+        }
+        else if (!strcmp("-n", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of lookups.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_lookups = atol(argv[arg]);
+        }
+        else if (!strcmp("-r", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of runs.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_runs = atol(argv[arg]);
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-v", argv[arg]))
+        {
+            opt_verbose = 1;
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    if (opt_num_keys == 0 || opt_num_keys > INT32_MAX/2 || opt_num_lookups == 0 || opt_miss_percent > 100 || opt_num_runs == 0)
+    {
+        fprintf(stderr, "ERROR: number of keys, number of lookups and number of runs must be positive, and the percentage of unsuccessful lookups must not exceed 100.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt_verbose)
+    {
+        printf("Options:\n");
+        printf("* Number of keys: %lu\n", opt_num_keys);
+        printf("* Number of lookups: %lu\n", opt_num_lookups);
+        printf("* Percentage of unsuccessful lookups: %lu\n", opt_miss_percent);
+        printf("* Number of runs: %lu\n", opt_num_runs);
+        printf("* Seed for random number generation: %u\n", opt_seed);
+    }
+
+    srand(opt_seed);
+
+    /* Stored keys are even, so odd keys are never found */
+    keys = malloc(opt_num_keys*sizeof(int));
+    lookups = malloc(opt_num_lookups*sizeof(int));
+    if (keys == NULL || lookups == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+    for (i = 0; i < opt_num_keys; ++i)
+    {
+        keys[i] = 2*(int) i;
+    }
+    for (i = 0; i < opt_num_lookups; ++i)
+    {
+        int k = 2*upo_random_uniform_int(0, (int) opt_num_keys - 1);
+
+        lookups[i] = ((size_t) upo_random_uniform_int(0, 99) < opt_miss_percent) ? k + 1 : k;
+    }
+
+    timer = upo_hires_timer_create();
+
+    printf("%11s  %16s  %16s  %8s\n", "load factor", "unordered Mop/s", "ordered Mop/s", "speedup");
+    for (l = 0; l < NUM_LOAD_FACTORS; ++l)
+    {
+        size_t m = (opt_num_keys + load_factors[l] - 1) / load_factors[l];
+        upo_ht_sepchain_t sepchain_ht = upo_ht_sepchain_create(m, upo_ht_hash_int_mix, int_compare);
+        upo_ht_sepchain_olist_t olist_ht = upo_ht_sepchain_olist_create(m, upo_ht_hash_int_mix, int_compare);
+        double sepchain_time = -1;
+        double olist_time = -1;
+
+        for (i = 0; i < opt_num_keys; ++i)
+        {
+            upo_ht_sepchain_put(sepchain_ht, &keys[i], &keys[i]);
+            upo_ht_sepchain_olist_put(olist_ht, &keys[i], &keys[i]);
+        }
+
+        for (r = 0; r < opt_num_runs; ++r)
+        {
+            double elapsed = 0;
+
+            upo_hires_timer_start(timer);
+            for (i = 0; i < opt_num_lookups; ++i)
+            {
+                num_hits += upo_ht_sepchain_contains(sepchain_ht, &lookups[i]);
+            }
+            upo_hires_timer_stop(timer);
+            elapsed = upo_hires_timer_elapsed(timer);
+            sepchain_time = (sepchain_time < 0 || elapsed < sepchain_time) ? elapsed : sepchain_time;
+
+            upo_hires_timer_start(timer);
+            for (i = 0; i < opt_num_lookups; ++i)
+            {
+                num_hits += upo_ht_sepchain_olist_contains(olist_ht, &lookups[i]);
+            }
+            upo_hires_timer_stop(timer);
+            elapsed = upo_hires_timer_elapsed(timer);
+            olist_time = (olist_time < 0 || elapsed < olist_time) ? elapsed : olist_time;
+        }
+
+        printf("%11lu  %16.3f  %16.3f  %8.2f\n",
+               load_factors[l],
+               (sepchain_time > 0) ? opt_num_lookups/sepchain_time*1.0e-6 : 0,
+               (olist_time > 0) ? opt_num_lookups/olist_time*1.0e-6 : 0,
+               (olist_time > 0) ? sepchain_time/olist_time : 0);
+
+        upo_ht_sepchain_olist_destroy(olist_ht, 0);
+        upo_ht_sepchain_destroy(sepchain_ht, 0);
+    }
+
+    if (opt_verbose)
+    {
+        printf("Number of successful lookups: %lu\n", num_hits);
+    }
+
+    upo_hires_timer_destroy(timer);
+    free(lookups);
+    free(keys);
+
+    return 0;
+}
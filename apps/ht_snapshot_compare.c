@@ -0,0 +1,280 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/ht_snapshot_compare.c
+ *
+ * \brief An application to compare the warm start of a hash table from a
+ *  memory-mapped snapshot against rebuilding it key by key.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+#include <upo/hashtable_snapshot.h>
+#include <upo/hires_timer.h>
+#include <upo/random.h>
+
+
+#define DEFAULT_OPT_FILE "ht_snapshot_compare.snap"
+#define DEFAULT_OPT_NUM_KEYS (size_t) 2000000
+#define DEFAULT_OPT_NUM_LOOKUPS (size_t) 1000000
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_VERBOSE 0
+
+/** \brief The number of keys inserted by each batch insertion. */
+#define BATCH_SIZE (size_t) 256
+
+
+/** \brief Compares two integers. */
+static int int_compare(const void *a, const void *b);
+
+/** \brief Prints a line of the results table. */
+static void print_result(const char *phase, double elapsed);
+
+/** \brief Prints a usage message. */
+static void usage(const char *progname);
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void print_result(const char *phase, double elapsed)
+{
+    printf("%-24s  %12.6f\n", phase, elapsed);
+}
+
+void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s {options}\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-f <value>: Specifies the path of the snapshot file (removed at exit).\n"
+                    "            [default: %s]\n", DEFAULT_OPT_FILE);
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-k <value>: Specifies the number of keys stored in the hash table.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-n <value>: Specifies the number of lookups after the warm start.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_LOOKUPS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-v: Enables output verbosity.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_VERBOSE ? "enabled" : "disabled"));
+}
+
+
+int main(int argc, char *argv[])
+{
+    const char *opt_file = DEFAULT_OPT_FILE;
+    size_t opt_num_keys = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_num_lookups = DEFAULT_OPT_NUM_LOOKUPS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int opt_verbose = DEFAULT_OPT_VERBOSE;
+    int opt_help = 0;
+    int *keys = NULL;
+    int *lookups = NULL;
+    void **key_ptrs = NULL;
+    upo_ht_linprob_t ht = NULL;
+    upo_ht_linprob_snapshot_t snap = NULL;
+    upo_hires_timer_t timer = NULL;
+    size_t checksum = 0;
+    int arg;
+    size_t i;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-f", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected path of the snapshot file.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_file = argv[arg];
+        }
+        else if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-k", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_keys = atol(argv[arg]);
+        }
+        else if (!strcmp("-n", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of lookups.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_lookups = atol(argv[arg]);
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-v", argv[arg]))
+        {
+            opt_verbose = 1;
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    if (opt_num_keys == 0 || opt_num_keys > INT32_MAX)
+    {
+        fprintf(stderr, "ERROR: number of keys must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt_verbose)
+    {
+        printf("Options:\n");
+        printf("* Snapshot file: %s\n", opt_file);
+        printf("* Number of keys: %lu\n", opt_num_keys);
+        printf("* Number of lookups: %lu\n", opt_num_lookups);
+        printf("* Seed for random number generation: %u\n", opt_seed);
+    }
+
+    srand(opt_seed);
+
+    keys = malloc(opt_num_keys*sizeof(int));
+    key_ptrs = malloc(opt_num_keys*sizeof(void*));
+    lookups = malloc(opt_num_lookups*sizeof(int));
+    if (keys == NULL || key_ptrs == NULL || lookups == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+    for (i = 0; i < opt_num_keys; ++i)
+    {
+        keys[i] = (int) i;
+        key_ptrs[i] = &keys[i];
+    }
+    upo_random_shuffle(key_ptrs, opt_num_keys, sizeof(void*));
+    for (i = 0; i < opt_num_lookups; ++i)
+    {
+        lookups[i] = upo_random_uniform_int(0, (int) opt_num_keys - 1);
+    }
+
+    timer = upo_hires_timer_create();
+
+    printf("%-24s  %12s\n", "phase", "seconds");
+
+    /* Cold start: insert every key again.
+     * Note: batch insertions are used since their load factor check does not
+     * scan the table for each key. */
+    upo_hires_timer_start(timer);
+    ht = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+    for (i = 0; i < opt_num_keys; i += BATCH_SIZE)
+    {
+        size_t n = (opt_num_keys - i < BATCH_SIZE) ? opt_num_keys - i : BATCH_SIZE;
+
+        upo_ht_linprob_put_batch(ht, key_ptrs + i, key_ptrs + i, n, NULL);
+    }
+    upo_hires_timer_stop(timer);
+    print_result("rebuild", upo_hires_timer_elapsed(timer));
+
+    upo_hires_timer_start(timer);
+    for (i = 0; i < opt_num_lookups; ++i)
+    {
+        checksum += (size_t) *(int*) upo_ht_linprob_get(ht, &lookups[i]);
+    }
+    upo_hires_timer_stop(timer);
+    print_result("lookups (rebuilt)", upo_hires_timer_elapsed(timer));
+
+    upo_hires_timer_start(timer);
+    if (!upo_ht_linprob_snapshot_save(ht, opt_file, upo_ht_serialize_int, upo_ht_serialize_int))
+    {
+        upo_throw_sys_error("Unable to save the snapshot");
+    }
+    upo_hires_timer_stop(timer);
+    print_result("save snapshot", upo_hires_timer_elapsed(timer));
+
+    upo_ht_linprob_destroy(ht, 0);
+
+    /* Warm start: map the snapshot */
+    upo_hires_timer_start(timer);
+    snap = upo_ht_linprob_snapshot_open(opt_file, upo_ht_hash_int_mix, upo_ht_serialize_int);
+    upo_hires_timer_stop(timer);
+    if (snap == NULL)
+    {
+        upo_throw_sys_error("Unable to open the snapshot");
+    }
+    print_result("open snapshot", upo_hires_timer_elapsed(timer));
+
+    /* The first lookups also pay for page faults */
+    upo_hires_timer_start(timer);
+    for (i = 0; i < opt_num_lookups; ++i)
+    {
+        checksum -= (size_t) *(const int*) upo_ht_linprob_snapshot_get(snap, &lookups[i]);
+    }
+    upo_hires_timer_stop(timer);
+    print_result("lookups (snapshot)", upo_hires_timer_elapsed(timer));
+
+    /* Lookups must have found the same values */
+    assert( checksum == 0 );
+    if (opt_verbose)
+    {
+        printf("Snapshot: %lu keys in %lu slots\n", upo_ht_linprob_snapshot_size(snap), upo_ht_linprob_snapshot_capacity(snap));
+    }
+
+    upo_ht_linprob_snapshot_close(snap);
+    remove(opt_file);
+    upo_hires_timer_destroy(timer);
+    free(lookups);
+    free(key_ptrs);
+    free(keys);
+
+    return 0;
+}
@@ -0,0 +1 @@
+apps_targets += avl_compare
@@ -0,0 +1 @@
+apps_targets += bptree_compare
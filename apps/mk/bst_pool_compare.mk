@@ -0,0 +1 @@
+apps_targets += bst_pool_compare
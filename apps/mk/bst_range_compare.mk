@@ -0,0 +1 @@
+apps_targets += bst_range_compare
@@ -0,0 +1 @@
+apps_targets += hset_compare
@@ -0,0 +1 @@
+apps_targets += ht_cuckoo_compare
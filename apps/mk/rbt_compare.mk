@@ -0,0 +1 @@
+apps_targets += rbt_compare
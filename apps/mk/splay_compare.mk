@@ -0,0 +1 @@
+apps_targets += splay_compare
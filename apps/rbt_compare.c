@@ -0,0 +1,252 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/rbt_compare.c
+ *
+ * \brief An application to compare red-black trees against plain binary
+ *  search trees on sorted and on random insertion orders.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/bst.h>
+#include <upo/error.h>
+#include <upo/hires_timer.h>
+#include <upo/random.h>
+#include <upo/rbt.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 1000000
+#define DEFAULT_OPT_MAX_SORTED_BST_KEYS (size_t) 10000
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_VERBOSE 0
+
+
+/** \brief Compares two integers. */
+static int int_compare(const void *a, const void *b);
+
+/** \brief Prints a line of the results table. */
+static void print_result(const char *tree, const char *order, size_t n, double insert, double lookups, size_t height);
+
+/** \brief Prints a usage message. */
+static void usage(const char *progname);
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void print_result(const char *tree, const char *order, size_t n, double insert, double lookups, size_t height)
+{
+    printf("%-4s  %-7s  %10lu  %12.6f  %12.6f  %8lu\n", tree, order, n, insert, lookups, height);
+}
+
+void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s {options}\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-b <value>: Specifies the maximum number of keys inserted in sorted order\n"
+                    "            in the plain BST, whose height grows linearly.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_MAX_SORTED_BST_KEYS);
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-k <value>: Specifies the number of keys.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-v: Enables output verbosity.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_VERBOSE ? "enabled" : "disabled"));
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t opt_num_keys = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_max_sorted_bst_keys = DEFAULT_OPT_MAX_SORTED_BST_KEYS;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int opt_verbose = DEFAULT_OPT_VERBOSE;
+    int opt_help = 0;
+    int *keys = NULL;
+    upo_hires_timer_t timer = NULL;
+    int order;
+    int arg;
+    size_t i;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-b", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of sorted keys for the BST.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_max_sorted_bst_keys = atol(argv[arg]);
+        }
+        else if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-k", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_keys = atol(argv[arg]);
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-v", argv[arg]))
+        {
+            opt_verbose = 1;
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    if (opt_num_keys == 0 || opt_num_keys > INT32_MAX)
+    {
+        fprintf(stderr, "ERROR: number of keys must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt_verbose)
+    {
+        printf("Options:\n");
+        printf("* Number of keys: %lu\n", opt_num_keys);
+        printf("* Maximum number of sorted keys for the BST: %lu\n", opt_max_sorted_bst_keys);
+        printf("* Seed for random number generation: %u\n", opt_seed);
+    }
+
+    srand(opt_seed);
+
+    keys = malloc(opt_num_keys*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+
+    timer = upo_hires_timer_create();
+
+    printf("%-4s  %-7s  %10s  %12s  %12s  %8s\n", "tree", "order", "keys", "insert (s)", "lookups (s)", "height");
+
+    for (order = 0; order < 2; ++order)
+    {
+        const char *order_name = (order == 0) ? "sorted" : "random";
+        size_t bst_num_keys = opt_num_keys;
+        upo_bst_t bst = NULL;
+        upo_rbt_t rbt = NULL;
+        double insert = 0;
+
+        for (i = 0; i < opt_num_keys; ++i)
+        {
+            keys[i] = (int) i;
+        }
+        if (order == 1)
+        {
+            upo_random_shuffle(keys, opt_num_keys, sizeof(int));
+        }
+
+        upo_hires_timer_start(timer);
+        rbt = upo_rbt_create(int_compare);
+        for (i = 0; i < opt_num_keys; ++i)
+        {
+            upo_rbt_put(rbt, &keys[i], &keys[i]);
+        }
+        upo_hires_timer_stop(timer);
+        insert = upo_hires_timer_elapsed(timer);
+
+        upo_hires_timer_start(timer);
+        for (i = 0; i < opt_num_keys; ++i)
+        {
+            if (upo_rbt_get(rbt, &keys[i]) != &keys[i])
+            {
+                fprintf(stderr, "ERROR: key not found.\n");
+                return EXIT_FAILURE;
+            }
+        }
+        upo_hires_timer_stop(timer);
+        print_result("rbt", order_name, opt_num_keys, insert, upo_hires_timer_elapsed(timer), upo_rbt_height(rbt));
+        upo_rbt_destroy(rbt, 0);
+
+        /* Sorted insertions make the plain BST a list: both the time
+         * (quadratic) and the recursion depth (linear) must be bounded */
+        if (order == 0 && bst_num_keys > opt_max_sorted_bst_keys)
+        {
+            bst_num_keys = opt_max_sorted_bst_keys;
+        }
+
+        upo_hires_timer_start(timer);
+        bst = upo_bst_create(int_compare);
+        for (i = 0; i < bst_num_keys; ++i)
+        {
+            upo_bst_put(bst, &keys[i], &keys[i]);
+        }
+        upo_hires_timer_stop(timer);
+        insert = upo_hires_timer_elapsed(timer);
+
+        upo_hires_timer_start(timer);
+        for (i = 0; i < bst_num_keys; ++i)
+        {
+            if (upo_bst_get(bst, &keys[i]) != &keys[i])
+            {
+                fprintf(stderr, "ERROR: key not found.\n");
+                return EXIT_FAILURE;
+            }
+        }
+        upo_hires_timer_stop(timer);
+        print_result("bst", order_name, bst_num_keys, insert, upo_hires_timer_elapsed(timer), upo_bst_height(bst));
+        upo_bst_destroy(bst, 0);
+    }
+
+    upo_hires_timer_destroy(timer);
+    free(keys);
+
+    return 0;
+}
@@ -0,0 +1,468 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file apps/splay_compare.c
+ *
+ * \brief An application to compare lookups in splay trees, plain binary
+ *  search trees and AVL trees under uniform and Zipfian access patterns.
+ *
+ * In a Zipfian workload with exponent `s`, the key of rank `i` (from `1`) is
+ * looked up with probability proportional to `1/i^s`, so a few hot keys get
+ * most lookups.
+ * Ranks are assigned to keys at random, so that hot keys are scattered over
+ * the key space.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <upo/avl.h>
+#include <upo/bst.h>
+#include <upo/error.h>
+#include <upo/hires_timer.h>
+#include <upo/random.h>
+#include <upo/splay.h>
+
+
+#define DEFAULT_OPT_NUM_KEYS (size_t) 1000000
+#define DEFAULT_OPT_NUM_LOOKUPS (size_t) 1000000
+#define DEFAULT_OPT_ZIPF_EXPONENT 1.0
+#define DEFAULT_OPT_RNG_SEED (unsigned int) time(NULL)
+#define DEFAULT_OPT_VERBOSE 0
+
+
+/** \brief Type for the operations of the compared trees. */
+typedef struct {
+    const char *name; /**< The name of the tree. */
+    void* (*create)(void); /**< Creates an empty tree. */
+    void (*put)(void*, void*, void*); /**< Adds a key-value pair. */
+    void* (*get)(void*, const void*); /**< Gets the value of a key. */
+    size_t (*height)(void*); /**< Returns the height. */
+    void (*destroy)(void*); /**< Destroys the tree. */
+} tree_ops_t;
+
+
+/** \brief The number of key comparisons performed so far. */
+static size_t num_compares = 0;
+
+
+/** \brief Compares two integers, counting comparisons. */
+static int int_compare(const void *a, const void *b);
+
+static void* splay_create(void);
+static void splay_put(void *tree, void *key, void *value);
+static void* splay_get(void *tree, const void *key);
+static size_t splay_height(void *tree);
+static void splay_destroy(void *tree);
+
+static void* bst_create(void);
+static void bst_put(void *tree, void *key, void *value);
+static void* bst_get(void *tree, const void *key);
+static size_t bst_height(void *tree);
+static void bst_destroy(void *tree);
+
+static void* avl_create(void);
+static void avl_put(void *tree, void *key, void *value);
+static void* avl_get(void *tree, const void *key);
+static size_t avl_height(void *tree);
+static void avl_destroy(void *tree);
+
+/**
+ * \brief Fills the given array with the cumulative distribution of a Zipf
+ *  distribution over `n` ranks with the given exponent.
+ *
+ * An exponent of `0` gives the uniform distribution.
+ */
+static void zipf_cdf(double *cdf, size_t n, double exponent);
+
+/** \brief Draws a rank (from `0`) according to the given cumulative distribution. */
+static size_t zipf_draw(const double *cdf, size_t n);
+
+/**
+ * \brief Builds a tree with the given keys, looks up the given sequence of
+ *  keys and prints the times and the average number of comparisons.
+ */
+static void run(const tree_ops_t *ops, const char *workload, int *keys, size_t n, int *const *lookups, size_t m, upo_hires_timer_t timer);
+
+/** \brief Prints a usage message. */
+static void usage(const char *progname);
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    ++num_compares;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void* splay_create(void)
+{
+    return upo_splay_create(int_compare);
+}
+
+void splay_put(void *tree, void *key, void *value)
+{
+    upo_splay_put(tree, key, value);
+}
+
+void* splay_get(void *tree, const void *key)
+{
+    return upo_splay_get(tree, key);
+}
+
+size_t splay_height(void *tree)
+{
+    return upo_splay_height(tree);
+}
+
+void splay_destroy(void *tree)
+{
+    upo_splay_destroy(tree, 0);
+}
+
+void* bst_create(void)
+{
+    return upo_bst_create(int_compare);
+}
+
+void bst_put(void *tree, void *key, void *value)
+{
+    upo_bst_put(tree, key, value);
+}
+
+void* bst_get(void *tree, const void *key)
+{
+    return upo_bst_get(tree, key);
+}
+
+size_t bst_height(void *tree)
+{
+    return upo_bst_height(tree);
+}
+
+void bst_destroy(void *tree)
+{
+    upo_bst_destroy(tree, 0);
+}
+
+void* avl_create(void)
+{
+    return upo_avl_create(int_compare);
+}
+
+void avl_put(void *tree, void *key, void *value)
+{
+    upo_avl_put(tree, key, value);
+}
+
+void* avl_get(void *tree, const void *key)
+{
+    return upo_avl_get(tree, key);
+}
+
+size_t avl_height(void *tree)
+{
+    return upo_avl_height(tree);
+}
+
+void avl_destroy(void *tree)
+{
+    upo_avl_destroy(tree, 0);
+}
+
+void zipf_cdf(double *cdf, size_t n, double exponent)
+{
+    double sum = 0;
+    size_t i;
+
+    for (i = 0; i < n; ++i)
+    {
+        sum += 1.0/pow((double) (i + 1), exponent);
+        cdf[i] = sum;
+    }
+    for (i = 0; i < n; ++i)
+    {
+        cdf[i] /= sum;
+    }
+}
+
+size_t zipf_draw(const double *cdf, size_t n)
+{
+    double u = upo_random_uniform_real(0, 1);
+    size_t lo = 0;
+    size_t hi = n - 1;
+
+    /* The first rank whose cumulative probability exceeds u */
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo)/2;
+
+        if (cdf[mid] > u)
+        {
+            hi = mid;
+        }
+        else
+        {
+            lo = mid + 1;
+        }
+    }
+
+    return lo;
+}
+
+void run(const tree_ops_t *ops, const char *workload, int *keys, size_t n, int *const *lookups, size_t m, upo_hires_timer_t timer)
+{
+    void *tree = ops->create();
+    double insert = 0;
+    size_t i;
+
+    upo_hires_timer_start(timer);
+    for (i = 0; i < n; ++i)
+    {
+        ops->put(tree, &keys[i], &keys[i]);
+    }
+    upo_hires_timer_stop(timer);
+    insert = upo_hires_timer_elapsed(timer);
+
+    num_compares = 0;
+    upo_hires_timer_start(timer);
+    for (i = 0; i < m; ++i)
+    {
+        if (ops->get(tree, lookups[i]) != lookups[i])
+        {
+            fprintf(stderr, "ERROR: key not found.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    upo_hires_timer_stop(timer);
+
+    printf("%-5s  %-9s  %12.6f  %12.6f  %12.3f  %11.2f  %8lu\n", ops->name, workload, insert, upo_hires_timer_elapsed(timer), upo_hires_timer_elapsed(timer)*1e6/m, (double) num_compares/m, ops->height(tree));
+
+    ops->destroy(tree);
+}
+
+void usage(const char *progname)
+{
+    fprintf(stderr, "Usage: %s {options}\n", progname);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "-h: Displays this message.\n");
+    fprintf(stderr, "-k <value>: Specifies the number of keys.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_KEYS);
+    fprintf(stderr, "-l <value>: Specifies the number of lookups.\n"
+                    "            [default: %lu]\n", DEFAULT_OPT_NUM_LOOKUPS);
+    fprintf(stderr, "-s <value>: Specifies the seed for the random number generator.\n"
+                    "            [default: <current time>]\n");
+    fprintf(stderr, "-v: Enables output verbosity.\n"
+                    "    [default: <%s>]\n", (DEFAULT_OPT_VERBOSE ? "enabled" : "disabled"));
+    fprintf(stderr, "-z <value>: Specifies the exponent of the Zipfian workload; the\n"
+                    "            uniform workload is always run too.\n"
+                    "            [default: %g]\n", DEFAULT_OPT_ZIPF_EXPONENT);
+}
+
+
+int main(int argc, char *argv[])
+{
+    const tree_ops_t trees[] = {
+        {"splay", splay_create, splay_put, splay_get, splay_height, splay_destroy},
+        {"bst", bst_create, bst_put, bst_get, bst_height, bst_destroy},
+        {"avl", avl_create, avl_put, avl_get, avl_height, avl_destroy}
+    };
+    size_t num_trees = sizeof trees/sizeof trees[0];
+    size_t opt_num_keys = DEFAULT_OPT_NUM_KEYS;
+    size_t opt_num_lookups = DEFAULT_OPT_NUM_LOOKUPS;
+    double opt_exponent = DEFAULT_OPT_ZIPF_EXPONENT;
+    unsigned int opt_seed = DEFAULT_OPT_RNG_SEED;
+    int opt_verbose = DEFAULT_OPT_VERBOSE;
+    int opt_help = 0;
+    int *keys = NULL;
+    int *ranked = NULL;
+    int **lookups = NULL;
+    double *cdf = NULL;
+    double exponents[2];
+    char workload[32];
+    upo_hires_timer_t timer = NULL;
+    int arg;
+    size_t e;
+    size_t i;
+    size_t t;
+
+    for (arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp("-h", argv[arg]))
+        {
+            opt_help = 1;
+        }
+        else if (!strcmp("-k", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of keys.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_keys = atol(argv[arg]);
+        }
+        else if (!strcmp("-l", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected number of lookups.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_num_lookups = atol(argv[arg]);
+        }
+        else if (!strcmp("-s", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected seed for random number generator.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_seed = atoi(argv[arg]);
+        }
+        else if (!strcmp("-v", argv[arg]))
+        {
+            opt_verbose = 1;
+        }
+        else if (!strcmp("-z", argv[arg]))
+        {
+            ++arg;
+            if (arg >= argc)
+            {
+                fprintf(stderr, "ERROR: expected Zipf exponent.\n");
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            opt_exponent = atof(argv[arg]);
+        }
+    }
+
+    if (opt_help)
+    {
+        usage(argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    if (opt_num_keys == 0 || opt_num_keys > INT32_MAX)
+    {
+        fprintf(stderr, "ERROR: number of keys must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (opt_num_lookups == 0)
+    {
+        fprintf(stderr, "ERROR: number of lookups must be positive.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (opt_exponent < 0)
+    {
+        fprintf(stderr, "ERROR: Zipf exponent must not be negative.\n");
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt_verbose)
+    {
+        printf("Options:\n");
+        printf("* Number of keys: %lu\n", opt_num_keys);
+        printf("* Number of lookups: %lu\n", opt_num_lookups);
+        printf("* Zipf exponent: %g\n", opt_exponent);
+        printf("* Seed for random number generation: %u\n", opt_seed);
+    }
+
+    srand(opt_seed);
+
+    keys = malloc(opt_num_keys*sizeof(int));
+    ranked = malloc(opt_num_keys*sizeof(int));
+    cdf = malloc(opt_num_keys*sizeof(double));
+    lookups = malloc(opt_num_lookups*sizeof(int*));
+    if (keys == NULL || ranked == NULL || cdf == NULL || lookups == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys and lookups");
+    }
+
+    /* Keys are inserted in random order, so that the plain BST is balanced
+     * on average; ranked[i] is the index of the key of rank i */
+    for (i = 0; i < opt_num_keys; ++i)
+    {
+        keys[i] = (int) i;
+        ranked[i] = (int) i;
+    }
+    upo_random_shuffle(keys, opt_num_keys, sizeof(int));
+    upo_random_shuffle(ranked, opt_num_keys, sizeof(int));
+
+    timer = upo_hires_timer_create();
+
+    /* The depth is the average number of comparisons per lookup */
+    printf("%-5s  %-9s  %12s  %12s  %12s  %11s  %8s\n", "tree", "workload", "insert (s)", "lookups (s)", "lookup (us)", "depth", "height");
+
+    exponents[0] = 0;
+    exponents[1] = opt_exponent;
+    for (e = 0; e < 2; ++e)
+    {
+        if (exponents[e] == 0)
+        {
+            strcpy(workload, "uniform");
+        }
+        else
+        {
+            sprintf(workload, "zipf %.2f", exponents[e]);
+        }
+        if (e > 0 && exponents[e] == 0)
+        {
+            break;
+        }
+
+        /* Draw the lookups once, so that all trees see the same sequence */
+        zipf_cdf(cdf, opt_num_keys, exponents[e]);
+        for (i = 0; i < opt_num_lookups; ++i)
+        {
+            lookups[i] = &keys[ranked[zipf_draw(cdf, opt_num_keys)]];
+        }
+
+        for (t = 0; t < num_trees; ++t)
+        {
+            run(&trees[t], workload, keys, opt_num_keys, lookups, opt_num_lookups, timer);
+        }
+    }
+
+    upo_hires_timer_destroy(timer);
+    free(lookups);
+    free(cdf);
+    free(ranked);
+    free(keys);
+
+    return 0;
+}
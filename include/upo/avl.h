@@ -0,0 +1,311 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/avl.h
+ *
+ * \brief The AVL Tree abstract data type.
+ *
+ * AVL Trees (by G. M. Adelson-Velsky and E. M. Landis) are Binary Search
+ * Trees (see upo/bst.h) where the heights of the two subtrees of every node
+ * differ by at most one, hence the height of a tree with `n` keys is at most
+ * about `1.44 log(n+2)`, whatever the order keys are inserted in.
+ * This bound is tighter than the one of red-black trees (see upo/rbt.h), so
+ * lookups visit fewer nodes, at the cost of more rotations on updates.
+ *
+ * Insertions and deletions are iterative: the links followed from the root
+ * are pushed on a fixed-size stack, which is then popped to restore the
+ * balance bottom-up, stopping as soon as the height of a subtree is
+ * unchanged.
+ *
+ * Comparison functions, visit functions and lists of keys are those of
+ * binary search trees.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_AVL_H
+#define UPO_AVL_H
+
+
+#include <stddef.h>
+#include <upo/bst.h>
+
+
+/** \brief Declares the AVL Tree type. */
+typedef struct upo_avl_s* upo_avl_t;
+
+
+/**
+ * \brief Creates a new empty AVL tree.
+ *
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty AVL tree.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+upo_avl_t upo_avl_create(upo_bst_comparator_t key_cmp);
+
+/**
+ * \brief Destroys the given AVL tree together with data stored on it.
+ *
+ * \param tree The AVL tree to destroy.
+ * \param destroy_data Tells whether the previously allocated memory for keys
+ *  and values stored in this AVL tree must be freed (value `1`) or not
+ *  (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_avl_destroy(upo_avl_t tree, int destroy_data);
+
+/**
+ * \brief Removes all elements from the given AVL tree.
+ *
+ * \param tree The AVL tree to clear.
+ * \param destroy_data Tells whether the previously allocated memory for keys
+ *  and values stored in this AVL tree must be freed (value `1`) or not
+ *  (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_avl_clear(upo_avl_t tree, int destroy_data);
+
+/**
+ * \brief Inserts the given value identified by the provided key in the given
+ *  AVL tree.
+ *
+ * \param tree The AVL tree.
+ * \param key The key.
+ * \param value The value.
+ * \return The replaced value in case of a duplicate, otherwise `NULL`.
+ *
+ * If the key is already present in the tree, the associated value is replaced
+ * by the one provided as argument to this function (and the stored key is
+ * kept).
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_avl_put(upo_avl_t tree, void *key, void *value);
+
+/**
+ * \brief Inserts the given value identified by the provided key in the given
+ *  AVL tree but ignores duplicates.
+ *
+ * \param tree The AVL tree.
+ * \param key The key.
+ * \param value The value.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void upo_avl_insert(upo_avl_t tree, void *key, void *value);
+
+/**
+ * \brief Returns the value identified by the provided key in the given
+ *  AVL tree.
+ *
+ * \param tree The AVL tree.
+ * \param key The key.
+ * \return The value associated to \a key, or `NULL` if the key is not found.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_avl_get(const upo_avl_t tree, const void *key);
+
+/**
+ * \brief Tells if the given AVL tree contains an item identified by
+ *  the given key.
+ *
+ * \param tree The AVL tree.
+ * \param key The key.
+ * \return `1` if the AVL tree contains the key, or `0` otherwise.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+int upo_avl_contains(const upo_avl_t tree, const void *key);
+
+/**
+ * \brief Removes the value identified by the provided key in the given
+ *  AVL tree.
+ *
+ * \param tree The AVL tree.
+ * \param key The key.
+ * \param destroy_data Tells whether the previously allocated memory for the
+ *  stored key and its value must be freed (value `1`) or not (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void upo_avl_delete(upo_avl_t tree, const void *key, int destroy_data);
+
+/**
+ * \brief Returns the number of keys stored on the given AVL tree.
+ *
+ * \param tree The AVL tree.
+ * \return The number of keys, or `0` if the tree is `NULL`.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_avl_size(const upo_avl_t tree);
+
+/**
+ * \brief Tells if the given AVL tree is empty.
+ *
+ * \param tree The AVL tree.
+ * \return `1` if the AVL tree is empty or `NULL`, or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_avl_is_empty(const upo_avl_t tree);
+
+/**
+ * \brief Returns the height of the given AVL tree.
+ *
+ * \param tree The AVL tree.
+ * \return The number of links of the longest path from the root to a leaf,
+ *  `0` for empty trees and trees with a single node.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_avl_height(const upo_avl_t tree);
+
+/**
+ * \brief Performs a depth-first in-order traversal of the tree.
+ *
+ * \param tree The AVL tree to traverse.
+ * \param visit The visit function.
+ * \param visit_context Additional information, passed to the visit function
+ *  as third parameter.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_avl_traverse_in_order(const upo_avl_t tree, upo_bst_visitor_t visit, void *visit_context);
+
+/**
+ * \brief Returns the smallest key in the given AVL tree.
+ *
+ * \param tree The AVL tree.
+ * \return The smallest key, or `NULL` if the tree is empty.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_avl_min(const upo_avl_t tree);
+
+/**
+ * \brief Returns the largest key in the given AVL tree.
+ *
+ * \param tree The AVL tree.
+ * \return The largest key, or `NULL` if the tree is empty.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_avl_max(const upo_avl_t tree);
+
+/**
+ * \brief Returns the largest key in the AVL tree which is less than or
+ *  equal to the given key.
+ *
+ * \param tree The AVL tree.
+ * \param key The key.
+ * \return The largest key which is less than or equal to the given key, or
+ *  `NULL` if there is no such key.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_avl_floor(const upo_avl_t tree, const void *key);
+
+/**
+ * \brief Returns the smallest key in the AVL tree which is greater than
+ *  or equal to the given key.
+ *
+ * \param tree The AVL tree.
+ * \param key The key.
+ * \return The smallest key which is greater than or equal to the given key,
+ *  or `NULL` if there is no such key.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_avl_ceiling(const upo_avl_t tree, const void *key);
+
+/**
+ * \brief Returns the keys in the given AVL tree that are inside the
+ *  provided range of keys.
+ *
+ * \param tree The AVL tree.
+ * \param low_key The lower bound of the range of keys.
+ * \param high_key The upper bound of the range of keys.
+ * \return A singly-linked list of the keys inside the provided range (bounds
+ *  included) in ascending order, or `NULL` if no key falls inside the range.
+ *
+ * Only the subtrees that may hold keys of the range are visited.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements plus
+ *  linear in the number `k` of returned keys, `O(log(n) + k)`.
+ */
+upo_bst_key_list_t upo_avl_keys_range(const upo_avl_t tree, const void *low_key, const void *high_key);
+
+/**
+ * \brief Returns the keys in the given AVL tree.
+ *
+ * \param tree The AVL tree.
+ * \return A singly-linked list of keys in ascending order, or `NULL` if the
+ *  tree is empty.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+upo_bst_key_list_t upo_avl_keys(const upo_avl_t tree);
+
+/**
+ * \brief Checks if the given tree satisfies the properties of AVL trees.
+ *
+ * \param tree The AVL tree to check.
+ * \return `1` if keys are ordered, the heights of the subtrees of each node
+ *  differ by at most one, and stored heights and the size are consistent, or
+ *  `0` otherwise.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+int upo_avl_is_avl(const upo_avl_t tree);
+
+/**
+ * \brief Returns the comparison function stored in the AVL tree.
+ *
+ * \param tree The AVL tree.
+ * \return The comparison function.
+ */
+upo_bst_comparator_t upo_avl_get_comparator(const upo_avl_t tree);
+
+
+#endif /* UPO_AVL_H */
@@ -0,0 +1,342 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/bptree.h
+ *
+ * \brief The B+-Tree abstract data type.
+ *
+ * B+-Trees are balanced search trees whose nodes hold many keys, so that a
+ * lookup visits far fewer nodes than in a binary search tree (see upo/bst.h):
+ * - all key-value pairs are stored in the leaves, which are all at the same
+ *   depth and are linked in ascending order of keys, so that ranges of keys
+ *   are scanned without going back up the tree;
+ * - inner nodes only hold separator keys to route searches, where the `i`-th
+ *   separator is the smallest key of the subtree of the `i+1`-th child;
+ * - every node but the root is at least half full.
+ * .
+ *
+ * Each node takes a fixed number of bytes (a few cache lines), and is aligned
+ * to a cache line, so that a node is loaded with few adjacent memory accesses
+ * and the keys of a node are searched by binary search.
+ * Since keys are stored by reference, comparing a key still dereferences it.
+ *
+ * Besides insertions one pair at a time, a tree can be bulk-loaded from pairs
+ * sorted by key in linear time, with (almost) full nodes.
+ *
+ * Comparison functions, visit functions and lists of keys are those of
+ * binary search trees.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_BPTREE_H
+#define UPO_BPTREE_H
+
+
+#include <stddef.h>
+#include <upo/bst.h>
+
+
+/** \brief Declares the B+-Tree type. */
+typedef struct upo_bptree_s* upo_bptree_t;
+
+
+/**
+ * \brief Creates a new empty B+-tree.
+ *
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty B+-tree.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+upo_bptree_t upo_bptree_create(upo_bst_comparator_t key_cmp);
+
+/**
+ * \brief Creates a new B+-tree holding the given key-value pairs, sorted by
+ *  key.
+ *
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \param keys The array of keys, in strictly ascending order.
+ * \param values The array of values, where `values[i]` is the value of
+ *  `keys[i]`, or `NULL` if all values are `NULL`.
+ * \param n The number of key-value pairs.
+ * \return A B+-tree holding the given pairs.
+ *
+ * Leaves and inner nodes are filled level by level from left to right, and
+ * are as full as possible while keeping every node at least half full.
+ * Keys and values are stored by reference, as with upo_bptree_put().
+ *
+ * Worst-case complexity: linear in the number `n` of key-value pairs,
+ *  `O(n)`.
+ */
+upo_bptree_t upo_bptree_build(upo_bst_comparator_t key_cmp, void *const *keys, void *const *values, size_t n);
+
+/**
+ * \brief Destroys the given B+-tree together with data stored on it.
+ *
+ * \param tree The B+-tree to destroy.
+ * \param destroy_data Tells whether the previously allocated memory for keys
+ *  and values stored in this B+-tree must be freed (value `1`) or not
+ *  (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_bptree_destroy(upo_bptree_t tree, int destroy_data);
+
+/**
+ * \brief Removes all elements from the given B+-tree.
+ *
+ * \param tree The B+-tree to clear.
+ * \param destroy_data Tells whether the previously allocated memory for keys
+ *  and values stored in this B+-tree must be freed (value `1`) or not
+ *  (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_bptree_clear(upo_bptree_t tree, int destroy_data);
+
+/**
+ * \brief Inserts the given value identified by the provided key in the given
+ *  B+-tree.
+ *
+ * \param tree The B+-tree.
+ * \param key The key.
+ * \param value The value.
+ * \return The replaced value in case of a duplicate, otherwise `NULL`.
+ *
+ * If the key is already present in the tree, the associated value is replaced
+ * by the one provided as argument to this function (and the stored key is
+ * kept).
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_bptree_put(upo_bptree_t tree, void *key, void *value);
+
+/**
+ * \brief Inserts the given value identified by the provided key in the given
+ *  B+-tree but ignores duplicates.
+ *
+ * \param tree The B+-tree.
+ * \param key The key.
+ * \param value The value.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void upo_bptree_insert(upo_bptree_t tree, void *key, void *value);
+
+/**
+ * \brief Returns the value identified by the provided key in the given
+ *  B+-tree.
+ *
+ * \param tree The B+-tree.
+ * \param key The key.
+ * \return The value associated to \a key, or `NULL` if the key is not found.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_bptree_get(const upo_bptree_t tree, const void *key);
+
+/**
+ * \brief Tells if the given B+-tree contains an item identified by the given
+ *  key.
+ *
+ * \param tree The B+-tree.
+ * \param key The key.
+ * \return `1` if the B+-tree contains the key, or `0` otherwise.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+int upo_bptree_contains(const upo_bptree_t tree, const void *key);
+
+/**
+ * \brief Removes the value identified by the provided key in the given
+ *  B+-tree.
+ *
+ * \param tree The B+-tree.
+ * \param key The key.
+ * \param destroy_data Tells whether the previously allocated memory for the
+ *  stored key and its value must be freed (value `1`) or not (value `0`).
+ *
+ * Nodes left less than half full borrow keys from a sibling, or are merged
+ * with it.
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void upo_bptree_delete(upo_bptree_t tree, const void *key, int destroy_data);
+
+/**
+ * \brief Returns the number of keys stored on the given B+-tree.
+ *
+ * \param tree The B+-tree.
+ * \return The number of keys, or `0` if the tree is `NULL`.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_bptree_size(const upo_bptree_t tree);
+
+/**
+ * \brief Tells if the given B+-tree is empty.
+ *
+ * \param tree The B+-tree.
+ * \return `1` if the B+-tree is empty or `NULL`, or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_bptree_is_empty(const upo_bptree_t tree);
+
+/**
+ * \brief Returns the height of the given B+-tree.
+ *
+ * \param tree The B+-tree.
+ * \return The number of links from the root to any leaf, `0` for empty
+ *  trees and trees made of a single leaf.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_bptree_height(const upo_bptree_t tree);
+
+/**
+ * \brief Visits all key-value pairs of the given B+-tree in ascending order
+ *  of keys.
+ *
+ * \param tree The B+-tree to traverse.
+ * \param visit The visit function.
+ * \param visit_context Additional information, passed to the visit function
+ *  as third parameter.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_bptree_traverse_in_order(const upo_bptree_t tree, upo_bst_visitor_t visit, void *visit_context);
+
+/**
+ * \brief Returns the smallest key in the given B+-tree.
+ *
+ * \param tree The B+-tree.
+ * \return The smallest key, or `NULL` if the tree is empty.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_bptree_min(const upo_bptree_t tree);
+
+/**
+ * \brief Returns the largest key in the given B+-tree.
+ *
+ * \param tree The B+-tree.
+ * \return The largest key, or `NULL` if the tree is empty.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_bptree_max(const upo_bptree_t tree);
+
+/**
+ * \brief Returns the largest key in the B+-tree which is less than or equal
+ *  to the given key.
+ *
+ * \param tree The B+-tree.
+ * \param key The key.
+ * \return The largest key which is less than or equal to the given key, or
+ *  `NULL` if there is no such key.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_bptree_floor(const upo_bptree_t tree, const void *key);
+
+/**
+ * \brief Returns the smallest key in the B+-tree which is greater than or
+ *  equal to the given key.
+ *
+ * \param tree The B+-tree.
+ * \param key The key.
+ * \return The smallest key which is greater than or equal to the given key,
+ *  or `NULL` if there is no such key.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_bptree_ceiling(const upo_bptree_t tree, const void *key);
+
+/**
+ * \brief Returns the keys in the given B+-tree that are inside the provided
+ *  range of keys.
+ *
+ * \param tree The B+-tree.
+ * \param low_key The lower bound of the range of keys.
+ * \param high_key The upper bound of the range of keys.
+ * \return A singly-linked list of the keys inside the provided range (bounds
+ *  included) in ascending order, or `NULL` if no key falls inside the range.
+ *
+ * The leaf holding the lower bound is found from the root, then leaves are
+ * scanned through their links until the upper bound.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements plus
+ *  linear in the number `k` of returned keys, `O(log(n) + k)`.
+ */
+upo_bst_key_list_t upo_bptree_keys_range(const upo_bptree_t tree, const void *low_key, const void *high_key);
+
+/**
+ * \brief Returns the keys in the given B+-tree.
+ *
+ * \param tree The B+-tree.
+ * \return A singly-linked list of keys in ascending order, or `NULL` if the
+ *  tree is empty.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+upo_bst_key_list_t upo_bptree_keys(const upo_bptree_t tree);
+
+/**
+ * \brief Checks if the given tree satisfies the properties of B+-trees.
+ *
+ * \param tree The B+-tree to check.
+ * \return `1` if keys are ordered, separators are the smallest keys of their
+ *  right subtrees, all leaves are at the same depth and linked in order,
+ *  nodes but the root are at least half full, and the size is consistent, or
+ *  `0` otherwise.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+int upo_bptree_is_bptree(const upo_bptree_t tree);
+
+/**
+ * \brief Returns the comparison function stored in the B+-tree.
+ *
+ * \param tree The B+-tree.
+ * \return The comparison function.
+ */
+upo_bst_comparator_t upo_bptree_get_comparator(const upo_bptree_t tree);
+
+
+#endif /* UPO_BPTREE_H */
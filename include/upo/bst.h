@@ -43,6 +43,7 @@
 
 
 #include <stddef.h>
+#include <upo/pool.h>
 
 
 /** \brief Declares the Binary Search Tree type. */
@@ -80,6 +81,9 @@ typedef int (*upo_bst_comparator_t)(const void*, const void*);
  */
 typedef void (*upo_bst_visitor_t)(void*, void*, void*);
 
+/** \brief A reasonable weight-balance factor for scapegoat trees. */
+#define UPO_BST_SCAPEGOAT_DEFAULT_ALPHA 0.7
+
 /** \brief The type for nodes of list of keys. */
 struct upo_bst_key_list_node_s
 {
@@ -92,6 +96,36 @@ typedef struct upo_bst_key_list_node_s upo_bst_key_list_node_t;
 /** \brief The type for list of keys. */
 typedef upo_bst_key_list_node_t* upo_bst_key_list_t;
 
+/**
+ * \brief The number of nodes on the path from the root that an iterator
+ *  stores inline.
+ */
+#define UPO_BST_ITER_INLINE_DEPTH 64U
+
+/**
+ * \brief Type for in-order iterators (cursors) over binary search trees.
+ *
+ * An iterator is a cursor placed between two consecutive keys of the tree
+ * (or before the first one, or after the last one), which can be moved in
+ * both directions.
+ * It keeps the path from the root to the current node on a stack, whose
+ * first #UPO_BST_ITER_INLINE_DEPTH nodes are stored in the iterator itself,
+ * so that no memory is allocated unless the tree is deeper than that; the
+ * rest of the stack is allocated on the heap, and grows with the depth.
+ * It is meant to be allocated by the caller (e.g., on the stack),
+ * initialized by upo_bst_iter_seek() and released by upo_bst_iter_destroy();
+ * its fields are private.
+ * The tree must not be modified while it is being iterated.
+ */
+typedef struct {
+    const struct upo_bst_s *tree; /**< The iterated tree. */
+    const struct upo_bst_node_s *path[UPO_BST_ITER_INLINE_DEPTH]; /**< The first nodes of the path from the root to the current node. */
+    const struct upo_bst_node_s **deep_path; /**< The nodes of the path beyond the first #UPO_BST_ITER_INLINE_DEPTH ones, or `NULL` if never needed. */
+    size_t deep_capacity; /**< The number of nodes that \a deep_path can hold. */
+    size_t depth; /**< The number of nodes of the path from the root to the current node, or `0` if the tree is empty. */
+    int after; /**< Tells if the cursor is right after (`1`) or right before (`0`) the current node. */
+} upo_bst_iter_t;
+
 
 /**
  * \brief Creates a new empty binary search tree.
@@ -103,6 +137,56 @@ typedef upo_bst_key_list_node_t* upo_bst_key_list_t;
  */
 upo_bst_t upo_bst_create(upo_bst_comparator_t key_cmp);
 
+/**
+ * \brief Creates a new empty binary search tree whose nodes are allocated
+ *  from the given pool.
+ *
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \param pool An empty pool created by upo_bst_pool_create(), or `NULL` to
+ *  allocate nodes with `malloc()` as upo_bst_create() does.
+ * \return An empty binary search tree.
+ *
+ * The tree borrows the pool: while the tree is alive, the pool must not be
+ * used by anything else, and it is not destroyed together with the tree.
+ * Nodes allocated one after the other are contiguous in memory, and clearing
+ * or destroying the tree without destroying data releases all nodes at once
+ * by clearing the pool, so the pool can be reused by the next tree.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+upo_bst_t upo_bst_create_with_pool(upo_bst_comparator_t key_cmp, upo_pool_t pool);
+
+/**
+ * \brief Creates a pool whose blocks fit the nodes of binary search trees.
+ *
+ * \param chunk_capacity The number of blocks of the first chunk of the pool
+ *  (see upo_pool_create()).
+ * \return An empty pool, to be destroyed by means of upo_pool_destroy().
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+upo_pool_t upo_bst_pool_create(size_t chunk_capacity);
+
+/**
+ * \brief Creates a new balanced binary search tree holding the given
+ *  key-value pairs, sorted by key.
+ *
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \param keys The array of keys, in strictly ascending order.
+ * \param values The array of values, where `values[i]` is the value of
+ *  `keys[i]`, or `NULL` if all values are `NULL`.
+ * \param n The number of key-value pairs.
+ * \return A binary search tree holding the given pairs.
+ *
+ * The middle pair of each range becomes the root of its subtree, so the
+ * height of the tree is `floor(log2(n))`, as low as possible.
+ * Keys and values are stored by reference, as with upo_bst_put().
+ *
+ * Worst-case complexity: linear in the number `n` of key-value pairs,
+ *  `O(n)`.
+ */
+upo_bst_t upo_bst_build_from_sorted(upo_bst_comparator_t key_cmp, void *const *keys, void *const *values, size_t n);
+
 /**
  * \brief Destroys the given binary search tree together with data stored on it.
  *
@@ -114,7 +198,9 @@ upo_bst_t upo_bst_create(upo_bst_comparator_t key_cmp);
  * Memory deallocation (if requested) is performed by means of the `free()`
  * standard C function.
  *
- * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`, or
+ *  linear in the number `c` of chunks of the pool, `O(c)`, for trees created
+ *  with a pool when data is not destroyed.
  */
 void upo_bst_destroy(upo_bst_t tree, int destroy_data);
 
@@ -130,7 +216,9 @@ void upo_bst_destroy(upo_bst_t tree, int destroy_data);
  * Memory deallocation (if requested) is performed by means of the `free()`
  * standard C function.
  *
- * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`, or
+ *  linear in the number `c` of chunks of the pool, `O(c)`, for trees created
+ *  with a pool when data is not destroyed.
  */
 void upo_bst_clear(upo_bst_t tree, int destroy_data);
 
@@ -222,7 +310,10 @@ void upo_bst_insert(upo_bst_t tree, void *key, void *value);
  * \param tree The binary search tree.
  * \return The number of nodes of the given binary search tree.
  *
- * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ * Each node stores the size of its subtree, so the size of the tree is read
+ * from the root.
+ *
+ * Worst-case complexity: constant, `O(1)`.
  */
 size_t upo_bst_size(const upo_bst_t tree);
 
@@ -248,6 +339,50 @@ int upo_bst_is_empty(const upo_bst_t tree);
  */
 size_t upo_bst_height(const upo_bst_t tree);
 
+/**
+ * \brief Rebalances the given binary search tree in place.
+ *
+ * \param tree The binary search tree.
+ *
+ * The tree is first turned into a sorted chain of right children and then
+ * folded back into a tree of height `floor(log2(n))` by rounds of left
+ * rotations (the Day-Stout-Warren algorithm).
+ * No node is allocated or freed, and pointers to keys and values returned
+ * before stay valid.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`, with
+ *  constant extra space.
+ */
+void upo_bst_rebalance(upo_bst_t tree);
+
+/**
+ * \brief Turns the given binary search tree into a scapegoat tree, or back
+ *  into a plain binary search tree.
+ *
+ * \param tree The binary search tree.
+ * \param alpha The weight-balance factor, greater than `0.5` and not greater
+ *  than `1`, where `1` turns the mode off.
+ *
+ * A scapegoat tree uses the same nodes as a plain tree, plus a counter in the
+ * tree of the largest size since the last rebuild of the whole tree:
+ * - when an insertion leaves a node deeper than `log_{1/alpha}(n)`, its
+ *   deepest ancestor `u` such that a child of `u` holds more than
+ *   `alpha*size(u)` nodes (the scapegoat) is found and the subtree of `u` is
+ *   rebuilt in place, as upo_bst_rebalance() does;
+ * - when deletions leave fewer than `alpha` times the counter, the whole
+ *   tree is rebuilt.
+ * .
+ * So the height is always `O(log(n))`, and insertions and deletions take
+ * amortized `O(log(n))` time.
+ * Lower values of \a alpha give lower trees at the price of more frequent
+ * rebuilds (see #UPO_BST_SCAPEGOAT_DEFAULT_ALPHA).
+ *
+ * Turning the mode on rebalances the tree.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_bst_set_scapegoat(upo_bst_t tree, double alpha);
+
 /**
  * \brief Performs a depth-first in-order traversal of the tree.
  *
@@ -350,10 +485,13 @@ void* upo_bst_ceiling(const upo_bst_t tree, const void *key);
  * \param tree The binary search tree.
  * \param low_key The lower bound of the range of keys.
  * \param high_key The upper bound of the range of keys.
- * \return A singly-linked list of keys inside the provided range, or `NULL` if
- *  no key falls inside the range.
+ * \return A singly-linked list of the keys inside the provided range (bounds
+ *  included) in ascending order, or `NULL` if no key falls inside the range.
  *
- * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ * Only the keys of the range are visited, by means of an iterator.
+ *
+ * Worst-case complexity: linear in the height `h` of the tree plus the number
+ *  `k` of returned keys, `O(h + k)`.
  */
 upo_bst_key_list_t upo_bst_keys_range(const upo_bst_t tree, const void *low_key, const void *high_key);
 
@@ -361,12 +499,82 @@ upo_bst_key_list_t upo_bst_keys_range(const upo_bst_t tree, const void *low_key,
  * \brief Returns the keys in the given binary search tree.
  *
  * \param tree The binary search tree.
- * \return A singly-linked list of keys, or `NULL` if the tree is empty.
+ * \return A singly-linked list of keys in ascending order, or `NULL` if the
+ *  tree is empty.
  *
  * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
  */
 upo_bst_key_list_t upo_bst_keys(const upo_bst_t tree);
 
+/**
+ * \brief Places the given iterator right before the smallest key of the given
+ *  binary search tree not less than the provided key.
+ *
+ * \param tree The binary search tree.
+ * \param it The iterator to initialize.
+ * \param key The key, which needs not be in the tree, or `NULL` to place the
+ *  iterator before the smallest key of the tree.
+ *
+ * Then upo_bst_iter_next() returns the ceiling of \a key, and
+ * upo_bst_iter_prev() returns the largest key less than \a key.
+ * If all keys are less than \a key, the iterator is placed after the largest
+ * key.
+ *
+ * The iterator must then be released by upo_bst_iter_destroy() before being
+ * sought again or discarded.
+ *
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
+ */
+void upo_bst_iter_seek(const upo_bst_t tree, upo_bst_iter_t *it, const void *key);
+
+/**
+ * \brief Releases the memory used by the given iterator.
+ *
+ * \param it The iterator, initialized by upo_bst_iter_seek().
+ *
+ * Memory is allocated only for trees deeper than #UPO_BST_ITER_INLINE_DEPTH.
+ * Afterwards, the iterator is empty and may be sought again.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_bst_iter_destroy(upo_bst_iter_t *it);
+
+/**
+ * \brief Moves the given iterator forward past the next key-value pair.
+ *
+ * \param it The iterator.
+ * \param key Where the key of the next pair is stored, or `NULL` if it is
+ *  not needed.
+ * \param value Where the value of the next pair is stored, or `NULL` if it is
+ *  not needed.
+ * \return `1` if there was a next pair, or `0` if the iterator is after the
+ *  largest key (in which case it does not move, and \a key and \a value are
+ *  left unchanged).
+ *
+ * Iterating over `k` consecutive keys takes time `O(h + k)`.
+ *
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`, for a
+ *  single call.
+ */
+int upo_bst_iter_next(upo_bst_iter_t *it, void **key, void **value);
+
+/**
+ * \brief Moves the given iterator backward past the previous key-value pair.
+ *
+ * \param it The iterator.
+ * \param key Where the key of the previous pair is stored, or `NULL` if it is
+ *  not needed.
+ * \param value Where the value of the previous pair is stored, or `NULL` if
+ *  it is not needed.
+ * \return `1` if there was a previous pair, or `0` if the iterator is before
+ *  the smallest key (in which case it does not move, and \a key and \a value
+ *  are left unchanged).
+ *
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`, for a
+ *  single call.
+ */
+int upo_bst_iter_prev(upo_bst_iter_t *it, void **key, void **value);
+
 /**
  * \brief Checks if the given tree satisfies the binary search tree property.
  *
@@ -385,12 +593,49 @@ upo_bst_key_list_t upo_bst_keys(const upo_bst_t tree);
  */
 int upo_bst_is_bst(const upo_bst_t tree, const void *min_key, const void *max_key);
 
+/**
+ * \brief Returns the number of keys in the binary search tree which are less
+ *  than the given key.
+ *
+ * \param bst The binary search tree.
+ * \param key The key, which needs not be in the tree.
+ * \return The number of keys less than \a key.
+ *
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
+ */
 size_t upo_bst_rank(const upo_bst_t bst, const void *key);
 
+/**
+ * \brief Returns the key of the given rank in the binary search tree.
+ *
+ * \param bst The binary search tree.
+ * \param k The rank, from `0` for the smallest key.
+ * \return The key with \a k smaller keys (i.e., the `(k+1)`-th smallest key),
+ *  or `NULL` if \a k is not less than the size of the tree.
+ *
+ * For each key of the tree, `upo_bst_select(bst, upo_bst_rank(bst, key))`
+ * returns the key itself.
+ *
+ * Worst-case complexity: linear in the height `h` of the tree, `O(h)`.
+ */
+void *upo_bst_select(const upo_bst_t bst, size_t k);
+
 void *upo_bst_get_value_depth(const upo_bst_t bst, const void *key, long *depth);
 
 void *upo_bst_predecessor(const upo_bst_t bst, const void* key);
 
+/**
+ * \brief Returns the keys in the given binary search tree that are less than
+ *  or equal to the provided key.
+ *
+ * \param bst The binary search tree.
+ * \param key The key, which needs not be in the tree.
+ * \return A singly-linked list of keys in ascending order, or `NULL` if no
+ *  key is less than or equal to \a key.
+ *
+ * Worst-case complexity: linear in the height `h` of the tree plus the number
+ *  `k` of returned keys, `O(h + k)`.
+ */
 upo_bst_key_list_t upo_bst_keys_le(const upo_bst_t bst, const void *key);
 
 size_t upo_bst_subtree_count_leaves_depth(const upo_bst_t bst, const void *key, size_t d);
@@ -0,0 +1,267 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/filter.h
+ *
+ * \brief Approximate membership filters.
+ *
+ * A filter answers whether a key may belong to a set while taking a few bits
+ * per key: it may give false positives (with a probability chosen at creation
+ * time) but never false negatives.
+ * Placed in front of a larger data structure, a filter rejects most lookups
+ * of missing keys without touching that structure.
+ *
+ * Filters are blocked: all the bits (or counters) of a key lie in a single
+ * block of #UPO_FILTER_BLOCK_SIZE bytes, that is in one cache line, so that
+ * each operation reads or writes one cache line whatever the number of hash
+ * functions.
+ * Filters do not hash keys themselves: they are given the full hash value of
+ * keys (e.g., as returned by a #upo_ht_hasher_t function), which is remixed,
+ * so even weak hash functions (like upo_ht_hash_int_div()) are fine.
+ *
+ * Two filters are available:
+ * - the blocked Bloom filter (#upo_bloom_t), with one bit per cell, which
+ *   does not support deletions;
+ * - the counting blocked Bloom filter (#upo_cbloom_t), with a 4-bit counter
+ *   per cell, which supports deletions at the cost of 4 times the memory.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_FILTER_H
+#define UPO_FILTER_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/** \brief The size (in bytes) of the blocks of filters, i.e., of a cache line. */
+#define UPO_FILTER_BLOCK_SIZE 64U
+
+/** \brief The maximum value of the counters of counting filters. */
+#define UPO_CBLOOM_MAX_COUNT 15U
+
+
+/*** BEGIN of BLOCKED BLOOM FILTER ***/
+
+
+/** \brief Declares the blocked Bloom filter type. */
+typedef struct upo_bloom_s* upo_bloom_t;
+
+
+/**
+ * \brief Creates a new empty blocked Bloom filter.
+ *
+ * \param n The expected number of keys.
+ * \param fpr The wanted false positive rate, between `0` and `1` (excluded),
+ *  once \a n keys have been added.
+ * \return An empty filter.
+ *
+ * The number of bits per key and the number of hash functions start from the
+ * optimal ones for a (non-blocked) Bloom filter with the given false positive
+ * rate; since some blocks get more keys than others, bits are then added until
+ * the expected rate of the blocked filter meets the wanted one.
+ *
+ * Worst-case complexity: linear in the number `m` of bits, `O(m)`.
+ */
+upo_bloom_t upo_bloom_create(size_t n, double fpr);
+
+/**
+ * \brief Destroys the given blocked Bloom filter.
+ *
+ * \param filter The filter to destroy.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_bloom_destroy(upo_bloom_t filter);
+
+/**
+ * \brief Removes all keys from the given blocked Bloom filter.
+ *
+ * \param filter The filter to clear.
+ *
+ * Worst-case complexity: linear in the number `m` of bits, `O(m)`.
+ */
+void upo_bloom_clear(upo_bloom_t filter);
+
+/**
+ * \brief Adds the key with the given hash value to the given blocked Bloom
+ *  filter.
+ *
+ * \param filter The filter.
+ * \param hash The full hash value of the key.
+ *
+ * Worst-case complexity: linear in the number `k` of hash functions, `O(k)`.
+ */
+void upo_bloom_add(upo_bloom_t filter, uint64_t hash);
+
+/**
+ * \brief Tells whether the key with the given hash value may have been added
+ *  to the given blocked Bloom filter.
+ *
+ * \param filter The filter.
+ * \param hash The full hash value of the key.
+ * \return `0` if the key has surely not been added (or if the filter is
+ *  `NULL`), or `1` otherwise.
+ *
+ * Worst-case complexity: linear in the number `k` of hash functions, `O(k)`.
+ */
+int upo_bloom_may_contain(const upo_bloom_t filter, uint64_t hash);
+
+/**
+ * \brief Returns the number of hash functions of the given blocked Bloom
+ *  filter.
+ *
+ * \param filter The filter.
+ * \return The number of bits set by each key, or `0` if the filter is `NULL`.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_bloom_num_hashes(const upo_bloom_t filter);
+
+/**
+ * \brief Returns the number of bytes allocated for the bits of the given
+ *  blocked Bloom filter.
+ *
+ * \param filter The filter.
+ * \return The number of bytes, or `0` if the filter is `NULL`.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_bloom_memory_usage(const upo_bloom_t filter);
+
+
+/*** END of BLOCKED BLOOM FILTER ***/
+
+
+/*** BEGIN of COUNTING BLOCKED BLOOM FILTER ***/
+
+
+/**
+ * \brief Declares the counting blocked Bloom filter type.
+ *
+ * Each cell is a 4-bit counter instead of a bit, so keys can be removed.
+ * A counter that reaches #UPO_CBLOOM_MAX_COUNT sticks to it, since its true
+ * value is no longer known: this may leave false positives behind, but never
+ * false negatives.
+ */
+typedef struct upo_cbloom_s* upo_cbloom_t;
+
+
+/**
+ * \brief Creates a new empty counting blocked Bloom filter.
+ *
+ * \param n The expected number of keys.
+ * \param fpr The wanted false positive rate, between `0` and `1` (excluded),
+ *  once \a n keys have been added.
+ * \return An empty filter.
+ *
+ * The filter is sized as done by upo_bloom_create(), with a counter in place
+ * of each bit.
+ *
+ * Worst-case complexity: linear in the number `m` of counters, `O(m)`.
+ */
+upo_cbloom_t upo_cbloom_create(size_t n, double fpr);
+
+/**
+ * \brief Destroys the given counting blocked Bloom filter.
+ *
+ * \param filter The filter to destroy.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_cbloom_destroy(upo_cbloom_t filter);
+
+/**
+ * \brief Removes all keys from the given counting blocked Bloom filter.
+ *
+ * \param filter The filter to clear.
+ *
+ * Worst-case complexity: linear in the number `m` of counters, `O(m)`.
+ */
+void upo_cbloom_clear(upo_cbloom_t filter);
+
+/**
+ * \brief Adds the key with the given hash value to the given counting
+ *  blocked Bloom filter.
+ *
+ * \param filter The filter.
+ * \param hash The full hash value of the key.
+ *
+ * Adding the same key twice requires removing it twice.
+ *
+ * Worst-case complexity: linear in the number `k` of hash functions, `O(k)`.
+ */
+void upo_cbloom_add(upo_cbloom_t filter, uint64_t hash);
+
+/**
+ * \brief Removes the key with the given hash value from the given counting
+ *  blocked Bloom filter.
+ *
+ * \param filter The filter.
+ * \param hash The full hash value of the key, which must have been added
+ *  (otherwise other keys may become false negatives).
+ *
+ * Worst-case complexity: linear in the number `k` of hash functions, `O(k)`.
+ */
+void upo_cbloom_remove(upo_cbloom_t filter, uint64_t hash);
+
+/**
+ * \brief Tells whether the key with the given hash value may be in the given
+ *  counting blocked Bloom filter.
+ *
+ * \param filter The filter.
+ * \param hash The full hash value of the key.
+ * \return `0` if the key is surely not in the filter (or if the filter is
+ *  `NULL`), or `1` otherwise.
+ *
+ * Worst-case complexity: linear in the number `k` of hash functions, `O(k)`.
+ */
+int upo_cbloom_may_contain(const upo_cbloom_t filter, uint64_t hash);
+
+/**
+ * \brief Returns the number of hash functions of the given counting blocked
+ *  Bloom filter.
+ *
+ * \param filter The filter.
+ * \return The number of counters updated by each key, or `0` if the filter
+ *  is `NULL`.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_cbloom_num_hashes(const upo_cbloom_t filter);
+
+/**
+ * \brief Returns the number of bytes allocated for the counters of the given
+ *  counting blocked Bloom filter.
+ *
+ * \param filter The filter.
+ * \return The number of bytes, or `0` if the filter is `NULL`.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_cbloom_memory_usage(const upo_cbloom_t filter);
+
+
+/*** END of COUNTING BLOCKED BLOOM FILTER ***/
+
+
+#endif /* UPO_FILTER_H */
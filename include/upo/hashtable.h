@@ -33,6 +33,7 @@
 
 
 #include <stddef.h>
+#include <stdint.h>
 
 
 /*** BEGIN of COMMON TYPES ***/
@@ -42,13 +43,17 @@
  *
  * Declares the type for key hash functions that are used to map key
  * space into the index space to use for indexing the hash table.
- * A hash function takes two parameters:
- * - The first parameter is a pointer to the key to hash.
- * - The second parameter is the capacity of the hash table.
- * A hash function returns a nonnegative number which represents a position
- * (index) in the hash table.
+ * A hash function takes one parameter:
+ * - The parameter is a pointer to the key to hash.
+ * A hash function returns the full 64-bit hash value of the key, which does
+ * not depend on the capacity of the hash table.
+ * The hash table reduces this value to a position (index) in its array of
+ * slots (by masking when the capacity is a power of two, or by taking the
+ * remainder of the division by the capacity otherwise), and caches it next to
+ * the key so that resizes never need to hash the key again and key comparisons
+ * can be skipped when the two hash values differ.
  */
-typedef size_t (*upo_ht_hasher_t)(const void*, size_t);
+typedef uint64_t (*upo_ht_hasher_t)(const void*);
 
 /**
  * \brief The type for key comparison functions.
@@ -93,6 +98,61 @@ typedef struct upo_ht_key_list_node_s upo_ht_key_list_node_t;
 /** \brief The type for list of keys. */
 typedef upo_ht_key_list_node_t *upo_ht_key_list_t;
 
+/**
+ * \brief Number of keys whose slots are prefetched together by batch
+ *  operations.
+ *
+ * Batch operations split keys into groups of this size: they first hash all
+ * keys of a group and prefetch their slots, then resolve them, so that the
+ * cache misses of the group overlap instead of being paid one after another.
+ */
+#define UPO_HT_BATCH_GROUP_SIZE 16U
+
+/**
+ * \brief Number of buckets of the histograms reported by hash table
+ *  statistics.
+ *
+ * Bucket \f$i\f$ counts lengths equal to \f$i\f$, except the last one that
+ * counts all lengths not less than its index.
+ */
+#define UPO_HT_STATS_HISTOGRAM_SIZE 16U
+
+/**
+ * \brief Type for statistics about the layout of a hash table and the work
+ *  done by its operations.
+ *
+ * The probe length of a key is the number of slots (for linear probing) or of
+ * nodes (for separate chaining) a successful lookup of that key examines.
+ *
+ * Operation counters are only maintained when the library is compiled with
+ * the `UPO_HT_STATS` macro defined, and are zero otherwise; without that
+ * macro, operations pay no cost for them.
+ * Each operation on a key counts as one get (upo_ht_*_get(),
+ * upo_ht_*_contains() and batch lookups), put (upo_ht_*_put(),
+ * upo_ht_*_insert() and batch insertions) or delete, and adds to the number
+ * of probes the slots or nodes it examines; an operation on a missing key
+ * also counts the empty slot or the end of the list where it stops.
+ */
+typedef struct {
+    size_t size; /**< The number of stored key-value pairs. */
+    size_t capacity; /**< The number of slots. */
+    size_t num_tombstones; /**< The number of deleted slots (linear probing only). */
+    size_t max_probe_length; /**< The maximum probe length. */
+    double mean_probe_length; /**< The mean probe length. */
+    size_t p50_probe_length; /**< The median probe length. */
+    size_t p90_probe_length; /**< The 90th percentile of probe lengths. */
+    size_t p99_probe_length; /**< The 99th percentile of probe lengths. */
+    size_t probe_histogram[UPO_HT_STATS_HISTOGRAM_SIZE]; /**< Number of keys by probe length. */
+    size_t max_chain_length; /**< The length of the longest list of collisions (separate chaining) or cluster of non-empty slots (linear probing). */
+    size_t chain_histogram[UPO_HT_STATS_HISTOGRAM_SIZE]; /**< Number of slots by length of their list of collisions (separate chaining), or number of clusters of non-empty slots by length (linear probing). */
+    size_t num_resizes; /**< The number of times the table has been resized. */
+    double resize_time; /**< The time (in seconds) spent resizing the table. */
+    size_t num_gets; /**< The number of lookups. */
+    size_t num_puts; /**< The number of insertions. */
+    size_t num_deletes; /**< The number of removals. */
+    size_t num_probes; /**< The number of slots or nodes examined by all operations. */
+} upo_ht_stats_t;
+
 
 /*** END of COMMON TYPES ***/
 
@@ -221,6 +281,74 @@ int upo_ht_sepchain_contains(const upo_ht_sepchain_t ht, const void *key);
  */
 void upo_ht_sepchain_delete(upo_ht_sepchain_t ht, const void *key, int destroy_data);
 
+/**
+ * \brief Returns the values identified by the provided keys in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param keys The array of the \a n keys to look up.
+ * \param n The number of keys.
+ * \param values The array of \a n elements where the value associated to each
+ *  key (or `NULL` if the key is not found) is stored.
+ *
+ * The result is the same of calling upo_ht_sepchain_get() for each key, but the
+ * slots of #UPO_HT_BATCH_GROUP_SIZE keys at a time are prefetched before
+ * being looked up, which hides the latency of cache misses on tables larger
+ * than the cache.
+ *
+ * Worst-case complexity: linear in the number `k` of keys times the number `n`
+ *  of elements, `O(kn)`.
+ */
+void upo_ht_sepchain_get_batch(const upo_ht_sepchain_t ht, void *const *keys, size_t n, void **values);
+
+/**
+ * \brief Inserts the given values identified by the provided keys in the
+ *  given hash table.
+ *
+ * \param ht The hash table.
+ * \param keys The array of the \a n keys.
+ * \param values The array of the \a n values.
+ * \param n The number of key-value pairs.
+ * \param old_values The array of \a n elements where the value replaced by
+ *  each pair (or `NULL`) is stored, or `NULL` if replaced values are not
+ *  needed.
+ *
+ * The result is the same of calling upo_ht_sepchain_put() for each pair in
+ * order, but the slots of #UPO_HT_BATCH_GROUP_SIZE keys at a time are
+ * prefetched before being updated.
+ *
+ * Worst-case complexity: linear in the number `k` of keys times the number `n`
+ *  of elements, `O(kn)`.
+ */
+void upo_ht_sepchain_put_batch(upo_ht_sepchain_t ht, void *const *keys, void *const *values, size_t n, void **old_values);
+
+/**
+ * \brief Creates a new hash table holding the given key-value pairs.
+ *
+ * \param m The capacity of the hash table, or `0` to have as many slots as
+ *  pairs.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \param keys The array of the \a n keys.
+ * \param values The array of the \a n values, or `NULL` to associate `NULL`
+ *  to every key.
+ * \param n The number of key-value pairs.
+ * \return The hash table.
+ *
+ * The result is the same of creating the hash table and calling
+ * upo_ht_sepchain_put() for each pair in order (so that, among equal keys,
+ * the first key and the last value are kept), but keys are all hashed first
+ * and then inserted in the order of their slot, so that the lists of
+ * collisions are built one region of the table at a time and their nodes are
+ * allocated next to each other.
+ * Two arrays of \a n hash values and of \a n indices are allocated
+ * temporarily.
+ *
+ * Worst-case complexity: linear in the number `n` of pairs times the length
+ *  of the longest list of collisions.
+ */
+upo_ht_sepchain_t upo_ht_sepchain_build(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp, void *const *keys, void *const *values, size_t n);
+
 /**
  * \brief Tells if the given hash table is empty.
  *
@@ -249,7 +377,7 @@ size_t upo_ht_sepchain_capacity(const upo_ht_sepchain_t ht);
  * \param ht The hash table.
  * \return The number of keys stored in the hash tables.
  *
- * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ * Worst-case complexity: constant, `O(1)`.
  */
 size_t upo_ht_sepchain_size(const upo_ht_sepchain_t ht);
 
@@ -274,10 +402,70 @@ double upo_ht_sepchain_load_factor(const upo_ht_sepchain_t ht);
  */
 upo_ht_key_list_t upo_ht_sepchain_keys(const upo_ht_sepchain_t ht);
 
+/**
+ * \brief Type for iterators over hash tables with separate chaining.
+ *
+ * An iterator walks the array of slots of the hash table in place, without
+ * allocating memory.
+ * It is meant to be allocated by the caller (e.g., on the stack) and
+ * initialized by upo_ht_sepchain_iter_begin(); its fields are private.
+ * The hash table must not be modified while it is being iterated.
+ */
+typedef struct {
+    upo_ht_sepchain_t ht; /**< The iterated hash table. */
+    size_t slot; /**< The index of the next slot to visit. */
+    struct upo_ht_sepchain_list_node_s *node; /**< The next node to visit in the current list of collisions. */
+} upo_ht_sepchain_iter_t;
+
+/**
+ * \brief Positions the given iterator before the first key-value pair of the
+ *  given hash table.
+ *
+ * \param ht The hash table.
+ * \param it The iterator to initialize.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_ht_sepchain_iter_begin(const upo_ht_sepchain_t ht, upo_ht_sepchain_iter_t *it);
+
+/**
+ * \brief Moves the given iterator to the next key-value pair.
+ *
+ * \param it The iterator.
+ * \param key Where the key of the next pair is stored, or `NULL` if it is
+ *  not needed.
+ * \param value Where the value of the next pair is stored, or `NULL` if it is
+ *  not needed.
+ * \return `1` if there was a next pair, or `0` if all pairs have already been
+ *  visited (in which case \a key and \a value are left unchanged).
+ *
+ * Iterating over the whole hash table takes time linear in the number `m` of
+ * slots, `O(m)`.
+ *
+ * Worst-case complexity: linear in the number `m` of slots, `O(m)`, for a
+ *  single call.
+ */
+int upo_ht_sepchain_iter_next(upo_ht_sepchain_iter_t *it, void **key, void **value);
+
+/**
+ * \brief Copies the keys of the given hash table into the given array.
+ *
+ * \param ht The hash table.
+ * \param keys The array the keys are copied into.
+ * \param n The number of elements of \a keys.
+ * \return The number of keys copied, which is the smaller between \a n and
+ *  the size of the hash table.
+ *
+ * Unlike upo_ht_sepchain_keys(), no memory is allocated.
+ *
+ * Worst-case complexity: linear in the number `m` of slots, `O(m)`.
+ */
+size_t upo_ht_sepchain_keys_into(const upo_ht_sepchain_t ht, void **keys, size_t n);
+
 /**
  * \brief Performs a traversal of the hash table.
  *
- * \param tree The hash table to traverse.
+ * \param ht The hash table to traverse.
  * \param visit The visit function.
  * \param visit_context Additional information, passed to the visit function as
  *  third parameter.
@@ -302,6 +490,63 @@ upo_ht_comparator_t upo_ht_sepchain_get_comparator(const upo_ht_sepchain_t ht);
  */
 upo_ht_hasher_t upo_ht_sepchain_get_hasher(const upo_ht_sepchain_t ht);
 
+/**
+ * \brief Attaches a filter of the stored keys in front of the given hash
+ *  table.
+ *
+ * \param ht The hash table.
+ * \param n The expected number of keys.
+ * \param fpr The wanted false positive rate of the filter, between `0` and
+ *  `1` (excluded), once \a n keys are stored.
+ *
+ * The filter is a counting blocked Bloom filter (see upo/filter.h), kept up to
+ * date by insertions and deletions.
+ * Lookups (i.e., upo_ht_sepchain_get(), upo_ht_sepchain_contains() and
+ * upo_ht_sepchain_get_batch()) of keys rejected by the filter return at once,
+ * after reading one cache line of the filter instead of walking a list of
+ * collisions: this pays off when most lookups are for missing keys.
+ * Storing more than \a n keys raises the false positive rate, but lookups
+ * stay correct.
+ *
+ * A filter already attached is replaced.
+ *
+ * Worst-case complexity: linear in the capacity `m` and in the number `n` of
+ *  elements of the hash table, `O(m+n)`.
+ */
+void upo_ht_sepchain_attach_filter(upo_ht_sepchain_t ht, size_t n, double fpr);
+
+/**
+ * \brief Detaches and destroys the filter of the given hash table, if any.
+ *
+ * \param ht The hash table.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_ht_sepchain_detach_filter(upo_ht_sepchain_t ht);
+
+/**
+ * \brief Collects statistics about the given hash table.
+ *
+ * \param ht The hash table.
+ * \param stats Where the statistics are stored.
+ *
+ * Separate chaining hash tables are never resized, so the resize statistics
+ * are always zero.
+ *
+ * Worst-case complexity: linear in the capacity `m` and in the number `n` of
+ *  elements of the hash table, `O(m+n)`.
+ */
+void upo_ht_sepchain_stats(const upo_ht_sepchain_t ht, upo_ht_stats_t *stats);
+
+/**
+ * \brief Resets the operation counters of the given hash table.
+ *
+ * \param ht The hash table.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_ht_sepchain_reset_stats(upo_ht_sepchain_t ht);
+
 
 /*** END of HASH TABLE with SEPARATE CHAINING ***/
 
@@ -429,6 +674,77 @@ int upo_ht_linprob_contains(const upo_ht_linprob_t ht, const void *key);
  */
 void upo_ht_linprob_delete(upo_ht_linprob_t ht, const void *key, int destroy_data);
 
+/**
+ * \brief Returns the values identified by the provided keys in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param keys The array of the \a n keys to look up.
+ * \param n The number of keys.
+ * \param values The array of \a n elements where the value associated to each
+ *  key (or `NULL` if the key is not found) is stored.
+ *
+ * The result is the same of calling upo_ht_linprob_get() for each key, but the
+ * slots of #UPO_HT_BATCH_GROUP_SIZE keys at a time are prefetched before
+ * being looked up, which hides the latency of cache misses on tables larger
+ * than the cache.
+ *
+ * Worst-case complexity: linear in the number `k` of keys times the number `n`
+ *  of elements, `O(kn)`.
+ */
+void upo_ht_linprob_get_batch(const upo_ht_linprob_t ht, void *const *keys, size_t n, void **values);
+
+/**
+ * \brief Inserts the given values identified by the provided keys in the
+ *  given hash table.
+ *
+ * \param ht The hash table.
+ * \param keys The array of the \a n keys.
+ * \param values The array of the \a n values.
+ * \param n The number of key-value pairs.
+ * \param old_values The array of \a n elements where the value replaced by
+ *  each pair (or `NULL`) is stored, or `NULL` if replaced values are not
+ *  needed.
+ *
+ * The result is the same of calling upo_ht_linprob_put() for each pair in
+ * order, but the slots of #UPO_HT_BATCH_GROUP_SIZE keys at a time are
+ * prefetched before being updated.
+ * The load factor is checked once per group rather than once per pair, so the
+ * table may grow slightly earlier than with single insertions.
+ *
+ * Worst-case complexity: linear in the number `k` of keys times the number `n`
+ *  of elements, `O(kn)`.
+ */
+void upo_ht_linprob_put_batch(upo_ht_linprob_t ht, void *const *keys, void *const *values, size_t n, void **old_values);
+
+/**
+ * \brief Creates a new hash table holding the given key-value pairs.
+ *
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \param keys The array of the \a n keys.
+ * \param values The array of the \a n values, or `NULL` to associate `NULL`
+ *  to every key.
+ * \param n The number of key-value pairs.
+ * \return The hash table.
+ *
+ * The result is the same of creating the hash table and calling
+ * upo_ht_linprob_put() for each pair in order (so that, among equal keys,
+ * the first key and the last value are kept), but the capacity is chosen
+ * once from \a n, as the smallest power of two keeping the load factor below
+ * `0.5`, so the table is never resized; also, keys are all hashed first and
+ * then inserted in the order of their home slot, so that the table is filled
+ * one region at a time.
+ * Since the capacity is computed from the number of pairs, keys repeated
+ * many times give a table larger than needed.
+ * Two arrays of \a n hash values and of \a n indices are allocated
+ * temporarily.
+ *
+ * Worst-case complexity: linear in the number `n` of pairs times the length
+ *  of the longest cluster.
+ */
+upo_ht_linprob_t upo_ht_linprob_build(upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp, void *const *keys, void *const *values, size_t n);
+
 /**
  * \brief Tells if the given hash table is empty.
  *
@@ -457,7 +773,7 @@ size_t upo_ht_linprob_capacity(const upo_ht_linprob_t ht);
  * \param ht The hash table.
  * \return The number of keys stored in the hash tables.
  *
- * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ * Worst-case complexity: constant, `O(1)`.
  */
 size_t upo_ht_linprob_size(const upo_ht_linprob_t ht);
 
@@ -482,10 +798,83 @@ double upo_ht_linprob_load_factor(const upo_ht_linprob_t ht);
  */
 upo_ht_key_list_t upo_ht_linprob_keys(const upo_ht_linprob_t ht);
 
+/**
+ * \brief Type for iterators over hash tables with linear probing.
+ *
+ * An iterator walks the array of slots of the hash table in place, without
+ * allocating memory, and skips empty and deleted slots.
+ * It is meant to be allocated by the caller (e.g., on the stack) and
+ * initialized by upo_ht_linprob_iter_begin(); its fields are private.
+ * The hash table must not be modified while it is being iterated.
+ */
+typedef struct {
+    upo_ht_linprob_t ht; /**< The iterated hash table. */
+    size_t slot; /**< The index of the next slot to visit. */
+} upo_ht_linprob_iter_t;
+
+/**
+ * \brief Positions the given iterator before the first key-value pair of the
+ *  given hash table.
+ *
+ * \param ht The hash table.
+ * \param it The iterator to initialize.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_ht_linprob_iter_begin(const upo_ht_linprob_t ht, upo_ht_linprob_iter_t *it);
+
+/**
+ * \brief Moves the given iterator to the next key-value pair.
+ *
+ * \param it The iterator.
+ * \param key Where the key of the next pair is stored, or `NULL` if it is
+ *  not needed.
+ * \param value Where the value of the next pair is stored, or `NULL` if it is
+ *  not needed.
+ * \return `1` if there was a next pair, or `0` if all pairs have already been
+ *  visited (in which case \a key and \a value are left unchanged).
+ *
+ * Iterating over the whole hash table takes time linear in the number `m` of
+ * slots, `O(m)`.
+ *
+ * Worst-case complexity: linear in the number `m` of slots, `O(m)`, for a
+ *  single call.
+ */
+int upo_ht_linprob_iter_next(upo_ht_linprob_iter_t *it, void **key, void **value);
+
+/**
+ * \brief Returns the hash value of the key of the pair the given iterator
+ *  has just moved to.
+ *
+ * \param it The iterator, whose last call to upo_ht_linprob_iter_next()
+ *  returned `1`.
+ * \return The full hash value of the key, as cached by the hash table.
+ *
+ * The key hash function is not called.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+uint64_t upo_ht_linprob_iter_hash(const upo_ht_linprob_iter_t *it);
+
+/**
+ * \brief Copies the keys of the given hash table into the given array.
+ *
+ * \param ht The hash table.
+ * \param keys The array the keys are copied into.
+ * \param n The number of elements of \a keys.
+ * \return The number of keys copied, which is the smaller between \a n and
+ *  the size of the hash table.
+ *
+ * Unlike upo_ht_linprob_keys(), no memory is allocated.
+ *
+ * Worst-case complexity: linear in the number `m` of slots, `O(m)`.
+ */
+size_t upo_ht_linprob_keys_into(const upo_ht_linprob_t ht, void **keys, size_t n);
+
 /**
  * \brief Performs a traversal of the hash table.
  *
- * \param tree The hash table to traverse.
+ * \param ht The hash table to traverse.
  * \param visit The visit function.
  * \param visit_context Additional information, passed to the visit function as
  *  third parameter.
@@ -510,6 +899,26 @@ upo_ht_comparator_t upo_ht_linprob_get_comparator(const upo_ht_linprob_t ht);
  */
 upo_ht_hasher_t upo_ht_linprob_get_hasher(const upo_ht_linprob_t ht);
 
+/**
+ * \brief Collects statistics about the given hash table.
+ *
+ * \param ht The hash table.
+ * \param stats Where the statistics are stored.
+ *
+ * Worst-case complexity: linear in the capacity `m` and in the number `n` of
+ *  elements of the hash table, `O(m+n)`.
+ */
+void upo_ht_linprob_stats(const upo_ht_linprob_t ht, upo_ht_stats_t *stats);
+
+/**
+ * \brief Resets the operation counters and the resize statistics of the given hash table.
+ *
+ * \param ht The hash table.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_ht_linprob_reset_stats(upo_ht_linprob_t ht);
+
 
 /*** END of HASH TABLE with OPEN ADDRESSING ***/
 
@@ -517,69 +926,612 @@ upo_ht_hasher_t upo_ht_linprob_get_hasher(const upo_ht_linprob_t ht);
 /*** BEGIN of HASH TABLE with SEPARATE CHAINING and ORDERED LISTS ***/
 
 
-/** \brief The hash table with separate chaining (based on ordered linked lists) abstract data type. */
+/** \brief Default capacity of hash tables with separate chaining based on ordered lists. */
+#define UPO_HT_SEPCHAIN_OLIST_DEFAULT_CAPACITY 997U
+
+
+/**
+ * \brief The hash table with separate chaining (based on ordered linked lists)
+ *  abstract data type.
+ *
+ * Each list of collisions is kept sorted by the full hash value of keys and,
+ * for equal hash values, by the key comparison function.
+ * Thus, a lookup stops at the first node that follows the searched key: an
+ * unsuccessful lookup visits on average half of the list instead of all of
+ * it, and compares keys only when their hash values are equal.
+ */
 typedef struct upo_ht_sepchain_olist_s* upo_ht_sepchain_olist_t;
 
-/** \brief Creates a new hash table with separate chaining (based on ordered linked lists). */
+/**
+ * \brief Creates a new empty hash table with separate chaining (based on
+ *  ordered linked lists).
+ *
+ * \param m The initial capacity of the hash table.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty hash table.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
 upo_ht_sepchain_olist_t upo_ht_sepchain_olist_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
 
-/** \brief Destroys the given hash table with separate chaining (based on ordered linked lists). */
+/**
+ * \brief Destroys the given hash table with separate chaining (based on
+ *  ordered linked lists).
+ *
+ * \param ht The hash table to destroy.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
 void upo_ht_sepchain_olist_destroy(upo_ht_sepchain_olist_t ht, int destroy_data);
 
-/** \brief Removes all elements from the given hash table with separate chaining (based on ordered linked lists). */
+/**
+ * \brief Removes all elements from the given hash table with separate
+ *  chaining (based on ordered linked lists).
+ *
+ * \param ht The hash table to clear.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
 void upo_ht_sepchain_olist_clear(upo_ht_sepchain_olist_t ht, int destroy_data);
 
-/** \brief Returns value associated to the given key in the given hash table with separate chaining (based on ordered linked lists). */
+/**
+ * \brief Returns value associated to the given key in the given hash table
+ *  with separate chaining (based on ordered linked lists).
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return The value associated to \a key, or `NULL` if the key is not found.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
 void* upo_ht_sepchain_olist_get(const upo_ht_sepchain_olist_t ht, const void *key);
 
-/** \brief Tells whether the given key is present in the given hash table with separate chaining (based on ordered linked lists). */
+/**
+ * \brief Tells whether the given key is present in the given hash table with
+ *  separate chaining (based on ordered linked lists).
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return `1` if the hash table contains \a key, or `0` otherwise.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
 int upo_ht_sepchain_olist_contains(const upo_ht_sepchain_olist_t ht, const void *key);
 
-/** \brief Inserts/updates the given key-value pair into the given hash table with separate chaining (based on ordered linked lists). */
+/**
+ * \brief Inserts/updates the given key-value pair into the given hash table
+ *  with separate chaining (based on ordered linked lists).
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ * \return The replaced value in case of a duplicate, otherwise `NULL`.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
 void* upo_ht_sepchain_olist_put(upo_ht_sepchain_olist_t ht, void *key, void *value);
 
-/** \brief Inserts the given key-value pair into the given hash table with separate chaining (based on ordered linked lists); updates are ignored. */
+/**
+ * \brief Inserts the given key-value pair into the given hash table with
+ *  separate chaining (based on ordered linked lists); updates are ignored.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
 void upo_ht_sepchain_olist_insert(upo_ht_sepchain_olist_t ht, void *key, void *value);
 
-/** \brief Removes the key-value pair associated to the given key from the given hash table with separate chaining (based on ordered linked lists). */
+/**
+ * \brief Removes the key-value pair associated to the given key from the given
+ *  hash table with separate chaining (based on ordered linked lists).
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param destroy_data Tells whether the previously allocated memory for data,
+ *  that is to be removed, must be freed (value `1`) or not (value `0`).
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
 void upo_ht_sepchain_olist_delete(upo_ht_sepchain_olist_t ht, const void *key, int destroy_data);
 
-/** \brief Returns the capacity of the given hash table with separate chaining (based on ordered linked lists). */
+/**
+ * \brief Returns the capacity of the given hash table with separate chaining
+ *  (based on ordered linked lists).
+ *
+ * \param ht The hash table.
+ * \return The number of slots of the hash table.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
 size_t upo_ht_sepchain_olist_capacity(const upo_ht_sepchain_olist_t ht);
 
-/** \brief Returns the number of stored keys in the given hash table with separate chaining (based on ordered linked lists). */
+/**
+ * \brief Returns the number of stored keys in the given hash table with
+ *  separate chaining (based on ordered linked lists).
+ *
+ * \param ht The hash table.
+ * \return The number of stored keys.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
 size_t upo_ht_sepchain_olist_size(const upo_ht_sepchain_olist_t ht);
 
-/** \brief Returns the load factor of the given hash table with separate chaining (based on ordered linked lists). */
+/**
+ * \brief Returns the load factor of the given hash table with separate
+ *  chaining (based on ordered linked lists).
+ *
+ * \param ht The hash table.
+ * \return The ratio between the number of stored keys and the capacity.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
 double upo_ht_sepchain_olist_load_factor(const upo_ht_sepchain_olist_t ht);
 
-/** \brief Tells whether the given hash table with separate chaining (based on ordered linked lists) is empty. */
+/**
+ * \brief Tells whether the given hash table with separate chaining (based on
+ *  ordered linked lists) is empty.
+ *
+ * \param ht The hash table.
+ * \return `1` if the hash table is empty or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
 int upo_ht_sepchain_olist_is_empty(const upo_ht_sepchain_olist_t ht);
 
 
 /*** END of HASH TABLE with SEPARATE CHAINING and ORDERED LISTS ***/
 
 
+/*** BEGIN of HASH TABLE with CUCKOO HASHING ***/
 
-/*** BEGIN of HASH FUNCTIONS ***/
+
+/** \brief Default capacity (i.e., number of slots) of hash tables with cuckoo hashing. */
+#define UPO_HT_CUCKOO_DEFAULT_CAPACITY 1024U
+
+/** \brief Number of slots of each bucket of hash tables with cuckoo hashing. */
+#define UPO_HT_CUCKOO_BUCKET_SIZE 4U
+
+/** \brief Number of slots of the stash of hash tables with cuckoo hashing. */
+#define UPO_HT_CUCKOO_STASH_SIZE 4U
 
 
 /**
- * \brief Hash function for integers that uses the division method.
+ * \brief The hash table with (bucketized) cuckoo hashing abstract data type.
+ *
+ * Slots are grouped in buckets of #UPO_HT_CUCKOO_BUCKET_SIZE slots, and the
+ * number of buckets is a power of two.
+ * The full hash value of a key selects two candidate buckets, and the key is
+ * always stored in one of them or in a small stash of
+ * #UPO_HT_CUCKOO_STASH_SIZE slots.
+ * Thus, a lookup examines at most
+ * \f$2 \cdot \mathtt{UPO\_HT\_CUCKOO\_BUCKET\_SIZE} + \mathtt{UPO\_HT\_CUCKOO\_STASH\_SIZE}\f$
+ * slots, whatever the number of keys, unless the hash function is poor (see
+ * below).
+ *
+ * When both candidate buckets of a new key are full, a breadth-first search
+ * looks for the shortest sequence of keys to move to their other candidate
+ * bucket in order to free a slot; if none is found within a bounded number
+ * of steps, the key goes to the stash, and if the stash is full too, the
+ * number of buckets is doubled.
+ *
+ * Keys with the same full hash value share their candidate buckets whatever
+ * the number of buckets, so doubling the table does not help once more than
+ * \f$2 \cdot \mathtt{UPO\_HT\_CUCKOO\_BUCKET\_SIZE} + \mathtt{UPO\_HT\_CUCKOO\_STASH\_SIZE}\f$
+ * keys collide.
+ * Therefore, the table is not doubled when its capacity is already much
+ * larger than the number of keys: keys that do not fit go to an overflow
+ * area after the stash, which lookups scan linearly.
+ * Memory stays linear in the number of keys even with a hash function that
+ * is constant, or chosen by an adversary, at the cost of lookups linear in
+ * the number of colliding keys.
+ */
+typedef struct upo_ht_cuckoo_s* upo_ht_cuckoo_t;
+
+/**
+ * \brief Creates a new empty hash table with cuckoo hashing.
  *
- * \param x The integer to be hashed.
- * \param m The number of possible hash values.
- * \return The hash value which is an integer number in \f$\{0,\ldots,m-1\}\f$.
+ * \param m The initial capacity of the hash table, rounded up to a power of
+ *  two multiple of #UPO_HT_CUCKOO_BUCKET_SIZE.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty hash table.
  *
- * The division method is defined as:
- * \f[
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+upo_ht_cuckoo_t upo_ht_cuckoo_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Destroys the given hash table with cuckoo hashing.
+ *
+ * \param ht The hash table to destroy.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_cuckoo_destroy(upo_ht_cuckoo_t ht, int destroy_data);
+
+/**
+ * \brief Removes all elements from the given hash table with cuckoo hashing.
+ *
+ * \param ht The hash table to clear.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_cuckoo_clear(upo_ht_cuckoo_t ht, int destroy_data);
+
+/**
+ * \brief Returns value associated to the given key in the given hash table
+ *  with cuckoo hashing.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return The value associated to \a key, or `NULL` if the key is not found.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void* upo_ht_cuckoo_get(const upo_ht_cuckoo_t ht, const void *key);
+
+/**
+ * \brief Tells whether the given key is present in the given hash table with
+ *  cuckoo hashing.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return `1` if the hash table contains \a key, or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_ht_cuckoo_contains(const upo_ht_cuckoo_t ht, const void *key);
+
+/**
+ * \brief Inserts/updates the given key-value pair into the given hash table
+ *  with cuckoo hashing.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ * \return The replaced value in case of a duplicate, otherwise `NULL`.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`,
+ *  when the hash table is resized; otherwise constant, `O(1)`.
+ */
+void* upo_ht_cuckoo_put(upo_ht_cuckoo_t ht, void *key, void *value);
+
+/**
+ * \brief Inserts the given key-value pair into the given hash table with
+ *  cuckoo hashing; updates are ignored.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`,
+ *  when the hash table is resized; otherwise constant, `O(1)`.
+ */
+void upo_ht_cuckoo_insert(upo_ht_cuckoo_t ht, void *key, void *value);
+
+/**
+ * \brief Removes the key-value pair associated to the given key from the given
+ *  hash table with cuckoo hashing.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param destroy_data Tells whether the previously allocated memory for data,
+ *  that is to be removed, must be freed (value `1`) or not (value `0`).
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_ht_cuckoo_delete(upo_ht_cuckoo_t ht, const void *key, int destroy_data);
+
+/**
+ * \brief Returns the capacity of the given hash table with cuckoo hashing.
+ *
+ * \param ht The hash table.
+ * \return The number of slots of the buckets of the hash table (the stash
+ *  excluded).
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_cuckoo_capacity(const upo_ht_cuckoo_t ht);
+
+/**
+ * \brief Returns the number of stored keys in the given hash table with
+ *  cuckoo hashing.
+ *
+ * \param ht The hash table.
+ * \return The number of stored keys.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_cuckoo_size(const upo_ht_cuckoo_t ht);
+
+/**
+ * \brief Returns the load factor of the given hash table with cuckoo hashing.
+ *
+ * \param ht The hash table.
+ * \return The ratio between the number of stored keys and the capacity.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+double upo_ht_cuckoo_load_factor(const upo_ht_cuckoo_t ht);
+
+/**
+ * \brief Tells whether the given hash table with cuckoo hashing is empty.
+ *
+ * \param ht The hash table.
+ * \return `1` if the hash table is empty or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_ht_cuckoo_is_empty(const upo_ht_cuckoo_t ht);
+
+/**
+ * \brief Returns the number of keys currently kept in the stash of the given
+ *  hash table with cuckoo hashing.
+ *
+ * \param ht The hash table.
+ * \return The number of keys in the stash, overflow area included.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_cuckoo_stash_size(const upo_ht_cuckoo_t ht);
+
+/**
+ * \brief Traverses the given hash table with cuckoo hashing and calls the
+ *  given function on each key-value pair.
+ *
+ * \param ht The hash table to traverse.
+ * \param visit The function to call on each key-value pair.
+ * \param visit_context A pointer passed to \a visit as its last argument.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_cuckoo_traverse(const upo_ht_cuckoo_t ht, upo_ht_visitor_t visit, void *visit_context);
+
+
+/*** END of HASH TABLE with CUCKOO HASHING ***/
+
+
+/*** BEGIN of HASH TABLE with LINEAR PROBING and INLINE KEYS ***/
+
+
+/** \brief Default capacity of hash tables with inline keys. */
+#define UPO_HT_INLINE_DEFAULT_CAPACITY 1024U
+
+/** \brief Maximum size (in bytes) of keys and values of hash tables with inline keys. */
+#define UPO_HT_INLINE_MAX_SIZE 16U
+
+/** \brief Maximum load factor of hash tables with inline keys, before they grow. */
+#define UPO_HT_INLINE_MAX_LOAD_FACTOR 0.75
+
+
+/**
+ * \brief The hash table with linear probing and inline keys abstract data
+ *  type.
+ *
+ * Keys and values have a fixed size of at most #UPO_HT_INLINE_MAX_SIZE bytes
+ * each, and are copied into the slot array instead of being referenced by
+ * pointers, so that storing a pair needs no heap allocation and comparing
+ * keys needs no pointer dereference.
+ * Next to the slot array, a byte per slot tells whether the slot is empty or
+ * holds 7 bits of the hash value of its key: a probe compares keys only when
+ * such bits match.
+ *
+ * The capacity is a power of two, and deletions shift back the following
+ * keys of the probe sequence, so no deleted slot is ever left behind.
+ *
+ * Keys are compared by their bytes and hashed by a built-in function
+ * specialized for 4-byte and 8-byte integers, unless a hash function and a
+ * comparison function are provided; in the latter case they are passed
+ * pointers to the stored bytes (e.g., a `int*` for `int` keys).
+ * Key bytes must be fully initialized (e.g., padding bytes of structures).
+ */
+typedef struct upo_ht_inline_s* upo_ht_inline_t;
+
+/**
+ * \brief Creates a new empty hash table with inline keys.
+ *
+ * \param m The initial capacity of the hash table, rounded up to a power of
+ *  two.
+ * \param key_size The size (in bytes) of keys, between `1` and
+ *  #UPO_HT_INLINE_MAX_SIZE.
+ * \param value_size The size (in bytes) of values, at most
+ *  #UPO_HT_INLINE_MAX_SIZE (`0` for sets).
+ * \param key_hash A pointer to the function used to hash keys, or `NULL` to
+ *  use the built-in one.
+ * \param key_cmp A pointer to the function used to compare keys, or `NULL` to
+ *  compare keys by their bytes.
+ * \return An empty hash table.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+upo_ht_inline_t upo_ht_inline_create(size_t m, size_t key_size, size_t value_size, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Destroys the given hash table with inline keys.
+ *
+ * \param ht The hash table to destroy.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_ht_inline_destroy(upo_ht_inline_t ht);
+
+/**
+ * \brief Removes all elements from the given hash table with inline keys.
+ *
+ * \param ht The hash table to clear.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_inline_clear(upo_ht_inline_t ht);
+
+/**
+ * \brief Returns the value associated to the given key in the given hash
+ *  table with inline keys.
+ *
+ * \param ht The hash table.
+ * \param key A pointer to the key.
+ * \return A pointer to the value stored in the hash table, or `NULL` if the
+ *  key is not found.
+ *
+ * The returned pointer is suitably aligned for the type of values, and stays
+ * valid until the hash table is modified.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void* upo_ht_inline_get(const upo_ht_inline_t ht, const void *key);
+
+/**
+ * \brief Tells whether the given key is present in the given hash table with
+ *  inline keys.
+ *
+ * \param ht The hash table.
+ * \param key A pointer to the key.
+ * \return `1` if the hash table contains \a key, or `0` otherwise.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+int upo_ht_inline_contains(const upo_ht_inline_t ht, const void *key);
+
+/**
+ * \brief Inserts/updates the given key-value pair into the given hash table
+ *  with inline keys.
+ *
+ * \param ht The hash table.
+ * \param key A pointer to the key, whose bytes are copied.
+ * \param value A pointer to the value, whose bytes are copied (ignored if the
+ *  size of values is `0`).
+ * \return `1` if the key was already present (and its value has been
+ *  replaced), or `0` otherwise.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+int upo_ht_inline_put(upo_ht_inline_t ht, const void *key, const void *value);
+
+/**
+ * \brief Inserts the given key-value pair into the given hash table with
+ *  inline keys, unless the key is already present.
+ *
+ * \param ht The hash table.
+ * \param key A pointer to the key, whose bytes are copied.
+ * \param value A pointer to the value, whose bytes are copied (ignored if the
+ *  size of values is `0`).
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_inline_insert(upo_ht_inline_t ht, const void *key, const void *value);
+
+/**
+ * \brief Removes the given key from the given hash table with inline keys.
+ *
+ * \param ht The hash table.
+ * \param key A pointer to the key.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_inline_delete(upo_ht_inline_t ht, const void *key);
+
+/**
+ * \brief Returns the number of slots of the given hash table with inline
+ *  keys.
+ *
+ * \param ht The hash table.
+ * \return The capacity of the hash table, or `0` if it is `NULL`.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_inline_capacity(const upo_ht_inline_t ht);
+
+/**
+ * \brief Returns the number of keys stored in the given hash table with
+ *  inline keys.
+ *
+ * \param ht The hash table.
+ * \return The number of keys, or `0` if the hash table is `NULL`.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_inline_size(const upo_ht_inline_t ht);
+
+/**
+ * \brief Returns the load factor of the given hash table with inline keys.
+ *
+ * \param ht The hash table.
+ * \return The ratio between the number of keys and the capacity.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+double upo_ht_inline_load_factor(const upo_ht_inline_t ht);
+
+/**
+ * \brief Tells whether the given hash table with inline keys is empty.
+ *
+ * \param ht The hash table.
+ * \return `1` if the hash table is empty or `NULL`, or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_ht_inline_is_empty(const upo_ht_inline_t ht);
+
+/**
+ * \brief Returns the number of bytes allocated for the slots of the given
+ *  hash table with inline keys.
+ *
+ * \param ht The hash table.
+ * \return The number of bytes taken by the slot array and the per-slot
+ *  bytes of hash bits, or `0` if the hash table is `NULL`.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_inline_memory_usage(const upo_ht_inline_t ht);
+
+/**
+ * \brief Visits all key-value pairs of the given hash table with inline keys.
+ *
+ * \param ht The hash table.
+ * \param visit The function called on each key-value pair, with pointers to
+ *  the stored key and value (the latter is `NULL` if the size of values is
+ *  `0`); \a visit must not modify keys nor the hash table.
+ * \param visit_context A pointer passed to \a visit as its last argument.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_inline_traverse(const upo_ht_inline_t ht, upo_ht_visitor_t visit, void *visit_context);
+
+
+/*** END of HASH TABLE with LINEAR PROBING and INLINE KEYS ***/
+
+
+
+/*** BEGIN of HASH FUNCTIONS ***/
+
+
+/**
+ * \brief Hash function for integers that uses the division method.
+ *
+ * \param x The integer to be hashed.
+ * \return The hash value, that is the integer itself.
+ *
+ * The division method is defined as:
+ * \f[
  *   h(x) = x \bmod m
  * \f]
  * where:
  * - \f$y \bmod z\f$ means the remainder of the division \f$y / z\f$.
  * .
+ * The reduction modulo the capacity \f$m\f$ is carried out by the hash table.
  */
-size_t upo_ht_hash_int_div(const void *x, size_t m);
+uint64_t upo_ht_hash_int_div(const void *x);
 
 /**
  * \brief Hash function for integers that uses the multiplication method.
@@ -600,6 +1552,9 @@ size_t upo_ht_hash_int_div(const void *x, size_t m);
  * - \f$y \bmod 1\f$ is the fractional part of \f$y\f$, that is
  *   the result of \f$y - \lfloor y \rfloor\f$.
  * .
+ *
+ * Since this function depends on \a m, it cannot be used as a hash function
+ * for hash tables (see upo_ht_hash_int_mult_knuth()).
  */
 size_t upo_ht_hash_int_mult(const void *x, double a, size_t m);
 
@@ -608,31 +1563,33 @@ size_t upo_ht_hash_int_mult(const void *x, double a, size_t m);
  *  the value of the multiplicative constant as proposed by Knuth.
  *
  * \param x The integer to be hashed.
- * \param m The number of possible hash values.
- * \return The hash value which is an integer number in \f$\{0,\ldots,m-1\}\f$.
+ * \return The fractional part of \f$a x\f$ as a 64-bit fixed-point number,
+ *  where \f$a = (\sqrt{5}-1)/2\f$, with its bits in reverse order.
+ *
+ * Hash tables with a power-of-two capacity \f$2^k\f$ keep the low \f$k\f$
+ * bits of hash values: thanks to the reversal, these are the high \f$k\f$
+ * bits of the fraction (in reverse order), as the multiplication method
+ * requires.
  */
-size_t upo_ht_hash_int_mult_knuth(const void *x, size_t m);
+uint64_t upo_ht_hash_int_mult_knuth(const void *x);
 
 /**
  * \brief Hash function for strings.
  *
  * \param s The string to be hashed.
- * \param h0 The initial value for the hash value that is usually chosen
- *  randomly from a universal family mapping integer domain
- *  \f$\{0,\ldots,p-1\} \mapsto \{0,\ldots,m-1\}\f$.
- * \param a A multiplicative factor such that \f$a \in \{0,\ldots,p-1\}\f$ which
- *  is usually uniformly random.
- * \param m The number of possible hash values.
- * \return The hash value which is an integer number in \f$\{0,\ldots,m-1\}\f$.
+ * \param h0 The initial value for the hash value.
+ * \param a A multiplicative factor.
+ * \return The 64-bit hash value.
  *
  * The implemented hash function is the following:
  * \f[
- *     h(k) = h_0 \left( \big(\sum_{i=0}^{\ell-1} k_i\cdot a^i \big) \bmod m \right), 
+ *     h(k) = \big(h_0 a^{\ell} + \sum_{i=0}^{\ell-1} k_i\cdot a^{\ell-1-i} \big) \bmod 2^{64},
  * \f]
  * where:
- * - \f$k=(k_0,\ldots,k_{\ell-1})\f$ is an array of characters of size \$\ell\$
+ * - \f$k=(k_0,\ldots,k_{\ell-1})\f$ is an array of characters of size \f$\ell\f$
+ * .
  */
-size_t upo_ht_hash_str(const void *s, size_t h0, size_t a, size_t m);
+uint64_t upo_ht_hash_str(const void *s, uint64_t h0, uint64_t a);
 
 /**
  * \brief The Bernstein's hash function `djb2`.
@@ -644,7 +1601,7 @@ size_t upo_ht_hash_str(const void *s, size_t h0, size_t a, size_t m);
  * - http://www.cse.yorku.ca/~oz/hash.html
  * .
  */
-size_t upo_ht_hash_str_djb2(const void *s, size_t m);
+uint64_t upo_ht_hash_str_djb2(const void *s);
 
 /**
  * \brief The Bernstein's hash function `djb2a`.
@@ -658,7 +1615,7 @@ size_t upo_ht_hash_str_djb2(const void *s, size_t m);
  * - http://www.cse.yorku.ca/~oz/hash.html
  * .
  */
-size_t upo_ht_hash_str_djb2a(const void *s, size_t m);
+uint64_t upo_ht_hash_str_djb2a(const void *s);
 
 /**
  * \brief The Java's hash function `hashCode`.
@@ -667,19 +1624,82 @@ size_t upo_ht_hash_str_djb2a(const void *s, size_t m);
  * - https://docs.oracle.com/javase/8/docs/api/java/lang/String.html#hashCode--
  * .
  */
-size_t upo_ht_hash_str_java(const void *s, size_t m);
+uint64_t upo_ht_hash_str_java(const void *s);
 
 /**
  * \brief The Kernighan and Ritchie's hash function proposed in the second
  *  edition of their C book.
  */
-size_t upo_ht_hash_str_kr2e(const void *s, size_t m);
+uint64_t upo_ht_hash_str_kr2e(const void *s);
 
 /**
  * \brief The SGI STL's hash function `hash_fun`.
  *
  */
-size_t upo_ht_hash_str_sgistl(const void *s, size_t m);
+uint64_t upo_ht_hash_str_sgistl(const void *s);
+
+
+/**
+ * \brief Mixes the bits of the given 64-bit integer.
+ *
+ * \param x The integer to be mixed.
+ * \return The mixed value.
+ *
+ * This is the finalizer of the SplitMix64 generator, which alternates
+ * multiplications by odd constants and xor-shifts so that every output bit
+ * depends on every input bit.
+ * It is a bijection on 64-bit integers.
+ *
+ * See:
+ * - G.L. Steele, D. Lea, and C.H. Flood. "Fast splittable pseudorandom number generators", OOPSLA 2014.
+ * .
+ */
+uint64_t upo_ht_hash_mix64(uint64_t x);
+
+/**
+ * \brief Hash function for integers based on a multiply-xorshift mixer.
+ *
+ * \param x The integer to be hashed.
+ * \return The 64-bit hash value.
+ *
+ * Unlike upo_ht_hash_int_div(), consecutive or strided integers are spread
+ * over all the bits of the hash value, so that both the low bits (used for
+ * power-of-two capacities) and the high bits are uniformly distributed.
+ *
+ * \sa upo_ht_hash_mix64()
+ */
+uint64_t upo_ht_hash_int_mix(const void *x);
+
+/**
+ * \brief Hashes an array of bytes.
+ *
+ * \param data The array of bytes to be hashed.
+ * \param n The number of bytes in \a data.
+ * \param seed A seed value that selects the hash function in the family.
+ * \return The 64-bit hash value.
+ *
+ * The implemented hash function follows the design of `wyhash`: the input is
+ * consumed 16 (or 48) bytes at a time by means of unaligned 8-byte loads, and
+ * pairs of words are combined with a 64x64-bit to 128-bit multiplication
+ * whose halves are xor-ed together.
+ * Inputs of at most 16 bytes are processed without any loop.
+ *
+ * Words are loaded in the native byte order, so hash values differ between
+ * little-endian and big-endian machines.
+ *
+ * See:
+ * - https://github.com/wangyi-fudan/wyhash
+ * .
+ */
+uint64_t upo_ht_hash_bytes(const void *data, size_t n, uint64_t seed);
+
+/**
+ * \brief Hash function for strings based on upo_ht_hash_bytes().
+ *
+ * \param s The string to be hashed.
+ * \return The 64-bit hash value.
+ */
+uint64_t upo_ht_hash_str_wyhash(const void *s);
 
 
 /*** END of HASH FUNCTIONS ***/
@@ -0,0 +1,459 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/hashtable_concurrent.h
+ *
+ * \brief Hash Tables that can be safely shared among threads.
+ *
+ * The hash tables declared in this file offer the same operations of the ones
+ * declared in upo/hashtable.h, and use the same hash function, key comparison
+ * and visit function types, but each operation can be called concurrently by
+ * multiple threads without any external synchronization.
+ *
+ * Values returned by lookups are not protected once the lookup returns: if a
+ * thread may delete a key (freeing its data) while another thread is using
+ * the associated value, the lifetime of values must be managed by the user.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASHTABLE_CONCURRENT_H
+#define UPO_HASHTABLE_CONCURRENT_H
+
+
+#include <stddef.h>
+#include <upo/hashtable.h>
+
+
+/*** BEGIN of HASH TABLE with SEPARATE CHAINING and LOCK STRIPING ***/
+
+
+/** \brief Default capacity of hash tables with lock striping. */
+#define UPO_HT_STRIPED_DEFAULT_CAPACITY 1024U
+
+/** \brief Default number of stripes (i.e., locks) of hash tables with lock striping. */
+#define UPO_HT_STRIPED_DEFAULT_NUM_STRIPES 64U
+
+/**
+ * \brief Load factor of a stripe above which the capacity of hash tables with
+ *  lock striping is doubled.
+ */
+#define UPO_HT_STRIPED_MAX_LOAD_FACTOR 2U
+
+
+/**
+ * \brief Type for hash tables with separate chaining and lock striping.
+ *
+ * Slots are partitioned into stripes, each one protected by a reader-writer
+ * lock: slot \f$i\f$ belongs to stripe \f$i \bmod s\f$, where \f$s\f$ is the
+ * number of stripes.
+ * Lookups in different stripes never contend, and lookups in the same stripe
+ * only wait for writers.
+ * Since capacities and the number of stripes are powers of two and capacities
+ * only grow by doubling, a key never changes stripe.
+ * The table doubles its capacity when the number of keys in a stripe exceeds
+ * #UPO_HT_STRIPED_MAX_LOAD_FACTOR times the number of slots of the stripe; to
+ * do so, the resizing thread acquires the locks of all stripes in order and
+ * moves nodes without hashing keys again.
+ */
+typedef struct upo_ht_striped_s* upo_ht_striped_t;
+
+
+/**
+ * \brief Creates a new empty hash table.
+ *
+ * \param m The initial capacity of the hash table, rounded up to a power of
+ *  two not less than the number of stripes.
+ * \param num_stripes The number of stripes, rounded up to a power of two.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty hash table.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+upo_ht_striped_t upo_ht_striped_create(size_t m, size_t num_stripes, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Destroys the given hash table.
+ *
+ * \param ht The hash table to destroy.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * No other thread must be using the hash table.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_striped_destroy(upo_ht_striped_t ht, int destroy_data);
+
+/**
+ * \brief Removes all key-value pairs from the given hash table.
+ *
+ * \param ht The hash table to clear.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_striped_clear(upo_ht_striped_t ht, int destroy_data);
+
+/**
+ * \brief Insert the given value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ * \return The replaced value in case of a duplicate, otherwise `NULL`.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void* upo_ht_striped_put(upo_ht_striped_t ht, void *key, void *value);
+
+/**
+ * \brief Inserts the given value identified by the provided key in the given
+ *  hash table but ignores duplicates.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_ht_striped_insert(upo_ht_striped_t ht, void *key, void *value);
+
+/**
+ * \brief Returns the value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return The value associated to \a key, or `NULL` if the key is not found.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void* upo_ht_striped_get(const upo_ht_striped_t ht, const void *key);
+
+/**
+ * \brief Tells if the given hash table contains an item identified by
+ *  the given key.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return `1` if the hash table contains an item identified by the
+ *  given key, or `0` if the key is not found.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+int upo_ht_striped_contains(const upo_ht_striped_t ht, const void *key);
+
+/**
+ * \brief Removes the value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param destroy_data Tells whether the previously allocated memory for data,
+ *  that is to be removed, must be freed (value `1`) or not (value `0`).
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_ht_striped_delete(upo_ht_striped_t ht, const void *key, int destroy_data);
+
+/**
+ * \brief Tells if the given hash table is empty.
+ *
+ * \param ht The hash table.
+ * \return `1` if the hash table is empty or `0` otherwise.
+ *
+ * Worst-case complexity: linear in the number `s` of stripes, `O(s)`.
+ */
+int upo_ht_striped_is_empty(const upo_ht_striped_t ht);
+
+/**
+ * \brief Returns the capacity of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The total number of slots of the hash tables.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_striped_capacity(const upo_ht_striped_t ht);
+
+/**
+ * \brief Returns the size of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The number of keys stored in the hash tables.
+ *
+ * While other threads are updating the hash table, the returned value is only
+ * a snapshot.
+ *
+ * Worst-case complexity: linear in the number `s` of stripes, `O(s)`.
+ */
+size_t upo_ht_striped_size(const upo_ht_striped_t ht);
+
+/**
+ * \brief Returns the load factor of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The load factor which is defined as the ratio between the number of
+ *  stored keys (i.e., the keys) and the number of slots (i.e., the capacity).
+ *
+ * Worst-case complexity: linear in the number `s` of stripes, `O(s)`.
+ */
+double upo_ht_striped_load_factor(const upo_ht_striped_t ht);
+
+/**
+ * \brief Performs a traversal of the hash table.
+ *
+ * \param ht The hash table to traverse.
+ * \param visit The visit function.
+ * \param visit_context Additional information, passed to the visit function as
+ *  third parameter.
+ *
+ * Each stripe is read-locked while its keys are visited, so the visit
+ * function must not update the hash table.
+ *
+ * Worst-case complexity: linear in the number `m` of slots, `O(m)`.
+ */
+void upo_ht_striped_traverse(const upo_ht_striped_t ht, upo_ht_visitor_t visit, void *visit_context);
+
+
+/*** END of HASH TABLE with SEPARATE CHAINING and LOCK STRIPING ***/
+
+
+/*** BEGIN of HASH TABLE with SEPARATE CHAINING and LOCK-FREE LOOKUPS ***/
+
+
+/** \brief Default capacity of hash tables with lock-free lookups. */
+#define UPO_HT_RCU_DEFAULT_CAPACITY 1024U
+
+/** \brief Default number of writer locks of hash tables with lock-free lookups. */
+#define UPO_HT_RCU_DEFAULT_NUM_STRIPES 64U
+
+/**
+ * \brief Load factor of a stripe above which the capacity of hash tables with
+ *  lock-free lookups is doubled.
+ */
+#define UPO_HT_RCU_MAX_LOAD_FACTOR 2U
+
+/**
+ * \brief Number of nodes a thread retires before trying to reclaim the
+ *  memory of retired nodes.
+ */
+#define UPO_HT_RCU_RECLAIM_THRESHOLD 64U
+
+
+/**
+ * \brief Type for hash tables with separate chaining and lock-free lookups.
+ *
+ * Lookups (i.e., get, contains and traverse) take no lock and write no shared
+ * memory but the epoch announcement of the calling thread: they follow
+ * atomic slot and node pointers published by writers with release semantics.
+ * Writers serialise on a per-stripe mutex, where slot \f$i\f$ belongs to
+ * stripe \f$i \bmod s\f$, as in #upo_ht_striped_t.
+ *
+ * Removed nodes are not freed at once, since lookups may still be reading
+ * them: they are retired, and reclaimed with epoch-based reclamation.
+ * Each thread announces the global epoch when it starts a lookup; a node
+ * retired during epoch \f$e\f$ is freed only once the global epoch reaches
+ * \f$e+2\f$, which cannot happen while any lookup started before the node
+ * was unlinked is still running.
+ *
+ * When the table grows, the resizing thread acquires all stripe locks,
+ * copies the nodes into a new array of slots, publishes it atomically and
+ * retires the old slots and nodes, so that running lookups are never
+ * disturbed.
+ */
+typedef struct upo_ht_rcu_s* upo_ht_rcu_t;
+
+
+/**
+ * \brief Creates a new empty hash table.
+ *
+ * \param m The initial capacity of the hash table, rounded up to a power of
+ *  two not less than the number of stripes.
+ * \param num_stripes The number of writer locks, rounded up to a power of two.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty hash table.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+upo_ht_rcu_t upo_ht_rcu_create(size_t m, size_t num_stripes, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Destroys the given hash table.
+ *
+ * \param ht The hash table to destroy.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *
+ * No other thread must be using the hash table.
+ * Nodes still waiting to be reclaimed are freed too.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_rcu_destroy(upo_ht_rcu_t ht, int destroy_data);
+
+/**
+ * \brief Removes all key-value pairs from the given hash table.
+ *
+ * \param ht The hash table to clear.
+ * \param destroy_data Tells whether the previously allocated memory for data
+ *  stored in the hash table must be freed (value `1`) or not (value `0`).
+ *  Data are freed only when no lookup can still read them.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table, `O(m)`.
+ */
+void upo_ht_rcu_clear(upo_ht_rcu_t ht, int destroy_data);
+
+/**
+ * \brief Insert the given value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ * \return The replaced value in case of a duplicate, otherwise `NULL`.
+ *
+ * Concurrent lookups may still return the replaced value, so the caller must
+ * not free it while lookups can be running.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void* upo_ht_rcu_put(upo_ht_rcu_t ht, void *key, void *value);
+
+/**
+ * \brief Inserts the given value identified by the provided key in the given
+ *  hash table but ignores duplicates.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_ht_rcu_insert(upo_ht_rcu_t ht, void *key, void *value);
+
+/**
+ * \brief Returns the value identified by the provided key in the given
+ *  hash table, without taking any lock.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return The value associated to \a key, or `NULL` if the key is not found.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void* upo_ht_rcu_get(const upo_ht_rcu_t ht, const void *key);
+
+/**
+ * \brief Tells if the given hash table contains an item identified by
+ *  the given key, without taking any lock.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \return `1` if the hash table contains an item identified by the
+ *  given key, or `0` if the key is not found.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+int upo_ht_rcu_contains(const upo_ht_rcu_t ht, const void *key);
+
+/**
+ * \brief Removes the value identified by the provided key in the given
+ *  hash table.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param destroy_data Tells whether the previously allocated memory for data,
+ *  that is to be removed, must be freed (value `1`) or not (value `0`).
+ *  Data are freed only when no lookup can still read them.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_ht_rcu_delete(upo_ht_rcu_t ht, const void *key, int destroy_data);
+
+/**
+ * \brief Tells if the given hash table is empty.
+ *
+ * \param ht The hash table.
+ * \return `1` if the hash table is empty or `0` otherwise.
+ *
+ * Worst-case complexity: linear in the number `s` of stripes, `O(s)`.
+ */
+int upo_ht_rcu_is_empty(const upo_ht_rcu_t ht);
+
+/**
+ * \brief Returns the capacity of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The total number of slots of the hash tables.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_rcu_capacity(const upo_ht_rcu_t ht);
+
+/**
+ * \brief Returns the size of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The number of keys stored in the hash tables.
+ *
+ * While other threads are updating the hash table, the returned value is only
+ * a snapshot.
+ *
+ * Worst-case complexity: linear in the number `s` of stripes, `O(s)`.
+ */
+size_t upo_ht_rcu_size(const upo_ht_rcu_t ht);
+
+/**
+ * \brief Returns the load factor of the hash table.
+ *
+ * \param ht The hash table.
+ * \return The load factor which is defined as the ratio between the number of
+ *  stored keys (i.e., the keys) and the number of slots (i.e., the capacity).
+ *
+ * Worst-case complexity: linear in the number `s` of stripes, `O(s)`.
+ */
+double upo_ht_rcu_load_factor(const upo_ht_rcu_t ht);
+
+/**
+ * \brief Performs a traversal of the hash table, without taking any lock.
+ *
+ * \param ht The hash table to traverse.
+ * \param visit The visit function.
+ * \param visit_context Additional information, passed to the visit function as
+ *  third parameter.
+ *
+ * Keys inserted or removed during the traversal may or may not be visited.
+ * The visit function must not call any other operation on the hash table.
+ *
+ * Worst-case complexity: linear in the number `m` of slots, `O(m)`.
+ */
+void upo_ht_rcu_traverse(const upo_ht_rcu_t ht, upo_ht_visitor_t visit, void *visit_context);
+
+
+/*** END of HASH TABLE with SEPARATE CHAINING and LOCK-FREE LOOKUPS ***/
+
+
+#endif /* UPO_HASHTABLE_CONCURRENT_H */
@@ -0,0 +1,227 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/hashtable_snapshot.h
+ *
+ * \brief Persistent, memory-mapped snapshots of Hash Tables.
+ *
+ * A snapshot is a file holding a read-only copy of a hash table with linear
+ * probing, laid out so that it can be used in place once mapped in memory:
+ * - a fixed-size header;
+ * - a flat array of slots, where keys and values are referenced by offsets
+ *   instead of pointers;
+ * - a blob region with the bytes of keys and values.
+ *
+ * Saving a snapshot writes the file sequentially in one pass.
+ * Opening a snapshot only maps the file and checks its header, so it takes
+ * constant time whatever the number of keys: pages of the slot array and of
+ * the blob are read from disk lazily, the first time a lookup touches them.
+ *
+ * Since keys and values are copied byte by byte, the bytes to copy are
+ * given by user-provided serialization functions (see #upo_ht_serializer_t)
+ * and must not contain pointers.
+ * Lookups hash keys with the original hash function, and compare them by
+ * their serialized bytes.
+ * Snapshots use the native byte order and word size, and cannot be moved
+ * among machines with a different architecture.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASHTABLE_SNAPSHOT_H
+#define UPO_HASHTABLE_SNAPSHOT_H
+
+
+#include <stddef.h>
+#include <upo/hashtable.h>
+
+
+/**
+ * \brief The type for functions serializing a key or a value.
+ *
+ * Such a function takes a pointer to a key (or to a value), as stored in the
+ * hash table, stores in its second argument the address of the bytes that
+ * represent it, and returns the number of such bytes.
+ * Two keys must be equal if and only if their bytes are equal.
+ * The bytes must stay valid as long as the key (or the value) is not
+ * modified, as when they are the key itself, since a snapshot is written
+ * after all keys and values have been serialized.
+ */
+typedef size_t (*upo_ht_serializer_t)(const void*, const void**);
+
+
+/**
+ * \brief Serializes an integer as its bytes.
+ *
+ * \param x Pointer to an integer.
+ * \param bytes Where the address of the bytes is stored (i.e., \a x).
+ * \return `sizeof(int)`.
+ */
+size_t upo_ht_serialize_int(const void *x, const void **bytes);
+
+/**
+ * \brief Serializes a string as its characters, including the terminating
+ *  null character.
+ *
+ * \param s Pointer to a pointer to a null-terminated string, as expected by
+ *  string hash functions like upo_ht_hash_str_djb2().
+ * \param bytes Where the address of the first character is stored.
+ * \return The length of the string plus one.
+ */
+size_t upo_ht_serialize_str(const void *s, const void **bytes);
+
+
+/*** BEGIN of SNAPSHOT of HASH TABLE with LINEAR PROBING ***/
+
+
+/**
+ * \brief Type for read-only snapshots of hash tables with linear probing.
+ *
+ * The capacity of a snapshot is a power of two at least twice the number of
+ * keys, and keys are placed in its slots by linear probing on their cached
+ * full hash values, so lookups never need to skip deleted slots.
+ */
+typedef struct upo_ht_linprob_snapshot_s* upo_ht_linprob_snapshot_t;
+
+
+/**
+ * \brief Saves a snapshot of the given hash table to the given file.
+ *
+ * \param ht The hash table.
+ * \param path The path of the file to create (or to overwrite).
+ * \param key_serialize A pointer to the function serializing keys.
+ * \param value_serialize A pointer to the function serializing values.
+ * \return `1` if the snapshot has been saved, or `0` if an I/O error occurred
+ *  (in which case `errno` tells the cause and the content of the file is
+ *  unspecified).
+ *
+ * `NULL` values are preserved and are not passed to \a value_serialize.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the hash table and in
+ *  the total size of keys and values.
+ */
+int upo_ht_linprob_snapshot_save(const upo_ht_linprob_t ht, const char *path, upo_ht_serializer_t key_serialize, upo_ht_serializer_t value_serialize);
+
+/**
+ * \brief Opens the snapshot stored in the given file.
+ *
+ * \param path The path of the file.
+ * \param key_hash A pointer to the function used to hash keys, which must be
+ *  the one used by the hash table the snapshot has been saved from.
+ * \param key_serialize A pointer to the function serializing keys, which must
+ *  be the one used to save the snapshot.
+ * \return The snapshot, or `NULL` if the file cannot be mapped in memory or
+ *  does not hold a valid snapshot (in which case `errno` tells the cause).
+ *
+ * The file is mapped read-only and is not parsed: only the header is checked.
+ * The file must not be modified while the snapshot is open.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+upo_ht_linprob_snapshot_t upo_ht_linprob_snapshot_open(const char *path, upo_ht_hasher_t key_hash, upo_ht_serializer_t key_serialize);
+
+/**
+ * \brief Closes the given snapshot.
+ *
+ * \param snap The snapshot to close.
+ *
+ * Pointers to keys and values returned by the snapshot are no longer valid.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_ht_linprob_snapshot_close(upo_ht_linprob_snapshot_t snap);
+
+/**
+ * \brief Gets the value identified by the provided key in the given snapshot.
+ *
+ * \param snap The snapshot.
+ * \param key The key, in the same form used by the original hash table.
+ * \return A pointer to the serialized value inside the mapped file if the key
+ *  is found, or `NULL` otherwise (or if the stored value is `NULL`).
+ *
+ * The returned value is read-only and stays valid until the snapshot is
+ * closed.
+ * Its address is aligned for any type, so (e.g.) an integer value can be
+ * read through an `int` pointer, and a string value is a `char` array.
+ *
+ * Worst-case complexity: linear in the number `n` of keys, `O(n)`.
+ */
+const void* upo_ht_linprob_snapshot_get(const upo_ht_linprob_snapshot_t snap, const void *key);
+
+/**
+ * \brief Tells if the given snapshot contains an item identified by the
+ *  provided key.
+ *
+ * \param snap The snapshot.
+ * \param key The key.
+ * \return `1` if the snapshot contains the key, or `0` otherwise.
+ *
+ * Worst-case complexity: linear in the number `n` of keys, `O(n)`.
+ */
+int upo_ht_linprob_snapshot_contains(const upo_ht_linprob_snapshot_t snap, const void *key);
+
+/**
+ * \brief Returns the number of keys stored in the given snapshot.
+ *
+ * \param snap The snapshot.
+ * \return The number of keys, or `0` if the snapshot is `NULL`.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_linprob_snapshot_size(const upo_ht_linprob_snapshot_t snap);
+
+/**
+ * \brief Returns the number of slots of the given snapshot.
+ *
+ * \param snap The snapshot.
+ * \return The number of slots, or `0` if the snapshot is `NULL`.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_ht_linprob_snapshot_capacity(const upo_ht_linprob_snapshot_t snap);
+
+/**
+ * \brief Tells if the given snapshot is empty.
+ *
+ * \param snap The snapshot.
+ * \return `1` if the snapshot is empty or `NULL`, or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_ht_linprob_snapshot_is_empty(const upo_ht_linprob_snapshot_t snap);
+
+/**
+ * \brief Visits all key-value pairs of the given snapshot.
+ *
+ * \param snap The snapshot.
+ * \param visit The function called on each key-value pair; keys and values
+ *  point to their serialized bytes inside the read-only mapped file, and
+ *  must not be modified.
+ * \param visit_context A pointer passed to \a visit as its last argument.
+ *
+ * Worst-case complexity: linear in the number `m` of slots, `O(m)`.
+ */
+void upo_ht_linprob_snapshot_traverse(const upo_ht_linprob_snapshot_t snap, upo_ht_visitor_t visit, void *visit_context);
+
+
+/*** END of SNAPSHOT of HASH TABLE with LINEAR PROBING ***/
+
+
+#endif /* UPO_HASHTABLE_SNAPSHOT_H */
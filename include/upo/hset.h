@@ -0,0 +1,451 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/hset.h
+ *
+ * \brief Hash-based sets and multisets.
+ *
+ * Sets store keys only: each slot holds a pointer to the key and its cached
+ * full hash value, that is half the size of a slot of a hash table with
+ * linear probing, and no value pointer is wasted.
+ * Keys are placed by linear probing in a power-of-two number of slots, and
+ * removals shift back the following keys of the probe sequence, so no deleted
+ * slot is ever left behind.
+ *
+ * Union, intersection and difference build a new set by iterating over the
+ * smaller operand and probing the larger one with the cached hash values, so
+ * they take time linear in the capacity of the smaller set (plus the cost of
+ * copying the larger one, when the result contains it).
+ * Parallel variants split the iteration among threads.
+ *
+ * Sets and multisets store pointers to keys, not copies: keys must not be
+ * `NULL`, and must not be modified while stored.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HSET_H
+#define UPO_HSET_H
+
+
+#include <stddef.h>
+#include <upo/hashtable.h>
+
+
+/** \brief Default capacity of sets and multisets. */
+#define UPO_HSET_DEFAULT_CAPACITY 16U
+
+/** \brief Maximum load factor of sets and multisets, before they grow. */
+#define UPO_HSET_MAX_LOAD_FACTOR 0.7
+
+
+/*** BEGIN of HASH SET ***/
+
+
+/** \brief Declares the hash set type. */
+typedef struct upo_hset_s* upo_hset_t;
+
+/** \brief The type for functions visiting keys of sets. */
+typedef void (*upo_hset_visitor_t)(void*, void*);
+
+
+/**
+ * \brief Creates a new empty set.
+ *
+ * \param m The initial capacity of the set, rounded up to a power of two.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty set.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the set, `O(m)`.
+ */
+upo_hset_t upo_hset_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Destroys the given set.
+ *
+ * \param set The set to destroy.
+ * \param destroy_data Tells whether the previously allocated memory for keys
+ *  stored in the set must be freed (value `1`) or not (value `0`).
+ *
+ * Worst-case complexity: linear in the capacity `m` of the set, `O(m)`.
+ */
+void upo_hset_destroy(upo_hset_t set, int destroy_data);
+
+/**
+ * \brief Removes all keys from the given set.
+ *
+ * \param set The set to clear.
+ * \param destroy_data Tells whether the previously allocated memory for keys
+ *  stored in the set must be freed (value `1`) or not (value `0`).
+ *
+ * Worst-case complexity: linear in the capacity `m` of the set, `O(m)`.
+ */
+void upo_hset_clear(upo_hset_t set, int destroy_data);
+
+/**
+ * \brief Returns a copy of the given set.
+ *
+ * \param set The set to copy.
+ * \return A new set with the same keys (i.e., the same pointers), or `NULL`
+ *  if \a set is `NULL`.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the set, `O(m)`.
+ */
+upo_hset_t upo_hset_copy(const upo_hset_t set);
+
+/**
+ * \brief Adds the given key to the given set.
+ *
+ * \param set The set.
+ * \param key The key.
+ * \return `1` if the key has been added, or `0` if it was already present
+ *  (in which case the stored key is kept).
+ *
+ * Worst-case complexity: linear in the capacity `m` of the set, `O(m)`.
+ */
+int upo_hset_add(upo_hset_t set, void *key);
+
+/**
+ * \brief Returns the stored key equal to the given one.
+ *
+ * \param set The set.
+ * \param key The key to look for.
+ * \return The stored key, or `NULL` if the key is not found.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the set, `O(m)`.
+ */
+void* upo_hset_get(const upo_hset_t set, const void *key);
+
+/**
+ * \brief Tells whether the given key is in the given set.
+ *
+ * \param set The set.
+ * \param key The key.
+ * \return `1` if the set contains \a key, or `0` otherwise.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the set, `O(m)`.
+ */
+int upo_hset_contains(const upo_hset_t set, const void *key);
+
+/**
+ * \brief Removes the given key from the given set.
+ *
+ * \param set The set.
+ * \param key The key.
+ * \param destroy_data Tells whether the previously allocated memory for the
+ *  stored key must be freed (value `1`) or not (value `0`).
+ *
+ * Worst-case complexity: linear in the capacity `m` of the set, `O(m)`.
+ */
+void upo_hset_remove(upo_hset_t set, const void *key, int destroy_data);
+
+/**
+ * \brief Returns the number of keys of the given set.
+ *
+ * \param set The set.
+ * \return The number of keys, or `0` if the set is `NULL`.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_hset_size(const upo_hset_t set);
+
+/**
+ * \brief Tells whether the given set is empty.
+ *
+ * \param set The set.
+ * \return `1` if the set is empty or `NULL`, or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_hset_is_empty(const upo_hset_t set);
+
+/**
+ * \brief Returns the number of slots of the given set.
+ *
+ * \param set The set.
+ * \return The capacity, or `0` if the set is `NULL`.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_hset_capacity(const upo_hset_t set);
+
+/**
+ * \brief Returns the load factor of the given set.
+ *
+ * \param set The set.
+ * \return The ratio between the number of keys and the capacity.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+double upo_hset_load_factor(const upo_hset_t set);
+
+/**
+ * \brief Visits all keys of the given set.
+ *
+ * \param set The set.
+ * \param visit The function called on each key; it must not modify the set.
+ * \param visit_context A pointer passed to \a visit as its last argument.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the set, `O(m)`.
+ */
+void upo_hset_traverse(const upo_hset_t set, upo_hset_visitor_t visit, void *visit_context);
+
+/**
+ * \brief Returns the union of the given sets.
+ *
+ * \param a The first set.
+ * \param b The second set, with the same hash and comparison functions of
+ *  \a a.
+ * \return A new set with the keys of both sets; when a key is in both, the
+ *  one of the larger set is kept.
+ *
+ * The larger set is copied and the keys of the smaller one are added to the
+ * copy.
+ *
+ * Worst-case complexity: linear in the capacities of the sets.
+ */
+upo_hset_t upo_hset_union(const upo_hset_t a, const upo_hset_t b);
+
+/**
+ * \brief Returns the intersection of the given sets.
+ *
+ * \param a The first set.
+ * \param b The second set, with the same hash and comparison functions of
+ *  \a a.
+ * \return A new set with the keys (of the smaller set) that are in both sets.
+ *
+ * Worst-case complexity: linear in the capacity of the smaller set.
+ */
+upo_hset_t upo_hset_intersect(const upo_hset_t a, const upo_hset_t b);
+
+/**
+ * \brief Returns the difference of the given sets.
+ *
+ * \param a The first set.
+ * \param b The second set, with the same hash and comparison functions of
+ *  \a a.
+ * \return A new set with the keys of \a a that are not in \a b.
+ *
+ * If \a a is the smaller set, its keys are probed in \a b; otherwise \a a
+ * is copied and the keys of \a b are removed from the copy.
+ *
+ * Worst-case complexity: linear in the capacity of \a a plus, if \a b is the
+ *  smaller set, in the capacity of \a b.
+ */
+upo_hset_t upo_hset_difference(const upo_hset_t a, const upo_hset_t b);
+
+/**
+ * \brief Returns the union of the given sets, using the given number of
+ *  threads.
+ *
+ * \param a The first set.
+ * \param b The second set, with the same hash and comparison functions of
+ *  \a a.
+ * \param num_threads The number of threads probing the larger set.
+ * \return The same set as upo_hset_union().
+ *
+ * The threads look for the keys of the smaller set that are missing from
+ * the larger one, which are then added to the copy of the larger set by the
+ * calling thread.
+ * The sets must not be modified during the call.
+ */
+upo_hset_t upo_hset_union_parallel(const upo_hset_t a, const upo_hset_t b, size_t num_threads);
+
+/**
+ * \brief Returns the intersection of the given sets, using the given number
+ *  of threads.
+ *
+ * \param a The first set.
+ * \param b The second set, with the same hash and comparison functions of
+ *  \a a.
+ * \param num_threads The number of threads probing the larger set.
+ * \return The same set as upo_hset_intersect().
+ *
+ * The sets must not be modified during the call.
+ */
+upo_hset_t upo_hset_intersect_parallel(const upo_hset_t a, const upo_hset_t b, size_t num_threads);
+
+/**
+ * \brief Returns the difference of the given sets, using the given number of
+ *  threads.
+ *
+ * \param a The first set.
+ * \param b The second set, with the same hash and comparison functions of
+ *  \a a.
+ * \param num_threads The number of threads probing the other set.
+ * \return The same set as upo_hset_difference().
+ *
+ * The sets must not be modified during the call.
+ */
+upo_hset_t upo_hset_difference_parallel(const upo_hset_t a, const upo_hset_t b, size_t num_threads);
+
+
+/*** END of HASH SET ***/
+
+
+/*** BEGIN of HASH MULTISET ***/
+
+
+/**
+ * \brief Declares the hash multiset type.
+ *
+ * A multiset stores each distinct key once, together with its number of
+ * occurrences.
+ */
+typedef struct upo_hmset_s* upo_hmset_t;
+
+/** \brief The type for functions visiting keys of multisets, with their number of occurrences. */
+typedef void (*upo_hmset_visitor_t)(void*, size_t, void*);
+
+
+/**
+ * \brief Creates a new empty multiset.
+ *
+ * \param m The initial capacity of the multiset, rounded up to a power of
+ *  two.
+ * \param key_hash A pointer to the function used to hash keys.
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty multiset.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the multiset, `O(m)`.
+ */
+upo_hmset_t upo_hmset_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+
+/**
+ * \brief Destroys the given multiset.
+ *
+ * \param mset The multiset to destroy.
+ * \param destroy_data Tells whether the previously allocated memory for keys
+ *  stored in the multiset must be freed (value `1`) or not (value `0`).
+ *
+ * Worst-case complexity: linear in the capacity `m` of the multiset, `O(m)`.
+ */
+void upo_hmset_destroy(upo_hmset_t mset, int destroy_data);
+
+/**
+ * \brief Removes all keys from the given multiset.
+ *
+ * \param mset The multiset to clear.
+ * \param destroy_data Tells whether the previously allocated memory for keys
+ *  stored in the multiset must be freed (value `1`) or not (value `0`).
+ *
+ * Worst-case complexity: linear in the capacity `m` of the multiset, `O(m)`.
+ */
+void upo_hmset_clear(upo_hmset_t mset, int destroy_data);
+
+/**
+ * \brief Adds an occurrence of the given key to the given multiset.
+ *
+ * \param mset The multiset.
+ * \param key The key; if an equal key is already stored, the stored key is
+ *  kept and \a key is not retained.
+ * \return The number of occurrences of the key after the addition.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the multiset, `O(m)`.
+ */
+size_t upo_hmset_add(upo_hmset_t mset, void *key);
+
+/**
+ * \brief Removes an occurrence of the given key from the given multiset.
+ *
+ * \param mset The multiset.
+ * \param key The key.
+ * \param destroy_data Tells whether the previously allocated memory for the
+ *  stored key must be freed (value `1`) or not (value `0`) when its last
+ *  occurrence is removed.
+ * \return The number of occurrences of the key after the removal.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the multiset, `O(m)`.
+ */
+size_t upo_hmset_remove(upo_hmset_t mset, const void *key, int destroy_data);
+
+/**
+ * \brief Returns the number of occurrences of the given key in the given
+ *  multiset.
+ *
+ * \param mset The multiset.
+ * \param key The key.
+ * \return The number of occurrences, `0` if the key is not found.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the multiset, `O(m)`.
+ */
+size_t upo_hmset_count(const upo_hmset_t mset, const void *key);
+
+/**
+ * \brief Tells whether the given key is in the given multiset.
+ *
+ * \param mset The multiset.
+ * \param key The key.
+ * \return `1` if the multiset contains \a key, or `0` otherwise.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the multiset, `O(m)`.
+ */
+int upo_hmset_contains(const upo_hmset_t mset, const void *key);
+
+/**
+ * \brief Returns the number of distinct keys of the given multiset.
+ *
+ * \param mset The multiset.
+ * \return The number of distinct keys, or `0` if the multiset is `NULL`.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_hmset_size(const upo_hmset_t mset);
+
+/**
+ * \brief Returns the total number of occurrences of keys of the given
+ *  multiset.
+ *
+ * \param mset The multiset.
+ * \return The sum of the number of occurrences of all keys, or `0` if the
+ *  multiset is `NULL`.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_hmset_total(const upo_hmset_t mset);
+
+/**
+ * \brief Tells whether the given multiset is empty.
+ *
+ * \param mset The multiset.
+ * \return `1` if the multiset is empty or `NULL`, or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_hmset_is_empty(const upo_hmset_t mset);
+
+/**
+ * \brief Visits all distinct keys of the given multiset.
+ *
+ * \param mset The multiset.
+ * \param visit The function called on each key with its number of
+ *  occurrences; it must not modify the multiset.
+ * \param visit_context A pointer passed to \a visit as its last argument.
+ *
+ * Worst-case complexity: linear in the capacity `m` of the multiset, `O(m)`.
+ */
+void upo_hmset_traverse(const upo_hmset_t mset, upo_hmset_visitor_t visit, void *visit_context);
+
+
+/*** END of HASH MULTISET ***/
+
+
+#endif /* UPO_HSET_H */
@@ -0,0 +1,136 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/pool.h
+ *
+ * \brief The Pool memory allocator.
+ *
+ * A Pool hands out memory blocks of a fixed size that are carved out of large
+ * chunks obtained from the system allocator.
+ * Blocks given back to the pool are kept in a free list and reused by later
+ * allocations.
+ * Releasing all blocks at once (by clearing or destroying the pool) only
+ * costs one deallocation per chunk, regardless of the number of blocks.
+ *
+ * Pools are meant to be owned by containers that allocate many nodes of the
+ * same type (e.g., the lists of collisions of hash tables with separate
+ * chaining), so that nodes allocated one after the other are also contiguous
+ * in memory.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_POOL_H
+#define UPO_POOL_H
+
+
+#include <stddef.h>
+
+
+/** \brief Default number of blocks in the first chunk of a pool. */
+#define UPO_POOL_DEFAULT_CHUNK_CAPACITY 64U
+
+/** \brief Maximum number of blocks in a chunk of a pool. */
+#define UPO_POOL_MAX_CHUNK_CAPACITY 65536U
+
+
+/** \brief Declares the Pool type. */
+typedef struct upo_pool_s* upo_pool_t;
+
+
+/**
+ * \brief Creates a new empty pool.
+ *
+ * \param block_size The size (in bytes) of the blocks handed out by the pool.
+ * \param chunk_capacity The number of blocks in the first chunk; each new
+ *  chunk doubles the capacity of the previous one, up to
+ *  #UPO_POOL_MAX_CHUNK_CAPACITY blocks.
+ * \return An empty pool.
+ *
+ * Blocks are aligned as memory returned by `malloc()`.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+upo_pool_t upo_pool_create(size_t block_size, size_t chunk_capacity);
+
+/**
+ * \brief Destroys the given pool together with all the blocks it handed out.
+ *
+ * \param pool The pool to destroy.
+ *
+ * Worst-case complexity: linear in the number `c` of chunks, `O(c)`.
+ */
+void upo_pool_destroy(upo_pool_t pool);
+
+/**
+ * \brief Releases all the blocks handed out by the given pool.
+ *
+ * \param pool The pool to clear.
+ *
+ * Blocks previously handed out by the pool must no longer be used.
+ *
+ * Worst-case complexity: linear in the number `c` of chunks, `O(c)`.
+ */
+void upo_pool_clear(upo_pool_t pool);
+
+/**
+ * \brief Allocates a block from the given pool.
+ *
+ * \param pool The pool.
+ * \return A pointer to an uninitialized block of the size given at creation
+ *  time.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void* upo_pool_alloc(upo_pool_t pool);
+
+/**
+ * \brief Gives back a block to the given pool.
+ *
+ * \param pool The pool.
+ * \param block The block to give back, which must have been allocated from
+ *  \a pool (may be `NULL`).
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+void upo_pool_free(upo_pool_t pool, void *block);
+
+/**
+ * \brief Returns the number of blocks currently in use.
+ *
+ * \param pool The pool.
+ * \return The number of allocated blocks that have not been given back yet.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_pool_size(const upo_pool_t pool);
+
+/**
+ * \brief Returns the number of chunks currently owned by the pool.
+ *
+ * \param pool The pool.
+ * \return The number of chunks.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_pool_num_chunks(const upo_pool_t pool);
+
+
+#endif /* UPO_POOL_H */
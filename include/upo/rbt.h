@@ -0,0 +1,367 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/rbt.h
+ *
+ * \brief The Red-Black Tree (RBT) abstract data type.
+ *
+ * Red-Black Trees are Binary Search Trees (see upo/bst.h) whose nodes are
+ * colored red or black so that:
+ * - no path from the root has two red nodes in a row, and
+ * - every path from the root to a missing child has the same number of black
+ *   nodes,
+ * .
+ * hence the height of a tree with `n` keys is at most `2 log(n+1)`,
+ * whatever the order keys are inserted in.
+ *
+ * This implementation is the left-leaning variant by R. Sedgewick, where a
+ * red node is always the left child of its parent, so that a tree is a
+ * binary representation of a 2-3 tree.
+ * Each node also stores the size of its subtree, so that the rank of a key
+ * and the key of a given rank are found in logarithmic time.
+ *
+ * Comparison functions, visit functions and lists of keys are those of
+ * binary search trees.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_RBT_H
+#define UPO_RBT_H
+
+
+#include <stddef.h>
+#include <upo/bst.h>
+
+
+/** \brief Declares the Red-Black Tree type. */
+typedef struct upo_rbt_s* upo_rbt_t;
+
+
+/**
+ * \brief Creates a new empty red-black tree.
+ *
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty red-black tree.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+upo_rbt_t upo_rbt_create(upo_bst_comparator_t key_cmp);
+
+/**
+ * \brief Destroys the given red-black tree together with data stored on it.
+ *
+ * \param tree The red-black tree to destroy.
+ * \param destroy_data Tells whether the previously allocated memory for keys
+ *  and values stored in this red-black tree must be freed (value `1`) or not
+ *  (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_rbt_destroy(upo_rbt_t tree, int destroy_data);
+
+/**
+ * \brief Removes all elements from the given red-black tree.
+ *
+ * \param tree The red-black tree to clear.
+ * \param destroy_data Tells whether the previously allocated memory for keys
+ *  and values stored in this red-black tree must be freed (value `1`) or not
+ *  (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_rbt_clear(upo_rbt_t tree, int destroy_data);
+
+/**
+ * \brief Inserts the given value identified by the provided key in the given
+ *  red-black tree.
+ *
+ * \param tree The red-black tree.
+ * \param key The key.
+ * \param value The value.
+ * \return The replaced value in case of a duplicate, otherwise `NULL`.
+ *
+ * If the key is already present in the tree, the associated value is replaced
+ * by the one provided as argument to this function (and the stored key is
+ * kept).
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_rbt_put(upo_rbt_t tree, void *key, void *value);
+
+/**
+ * \brief Inserts the given value identified by the provided key in the given
+ *  red-black tree but ignores duplicates.
+ *
+ * \param tree The red-black tree.
+ * \param key The key.
+ * \param value The value.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void upo_rbt_insert(upo_rbt_t tree, void *key, void *value);
+
+/**
+ * \brief Returns the value identified by the provided key in the given
+ *  red-black tree.
+ *
+ * \param tree The red-black tree.
+ * \param key The key.
+ * \return The value associated to \a key, or `NULL` if the key is not found.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_rbt_get(const upo_rbt_t tree, const void *key);
+
+/**
+ * \brief Tells if the given red-black tree contains an item identified by
+ *  the given key.
+ *
+ * \param tree The red-black tree.
+ * \param key The key.
+ * \return `1` if the red-black tree contains the key, or `0` otherwise.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+int upo_rbt_contains(const upo_rbt_t tree, const void *key);
+
+/**
+ * \brief Removes the value identified by the provided key in the given
+ *  red-black tree.
+ *
+ * \param tree The red-black tree.
+ * \param key The key.
+ * \param destroy_data Tells whether the previously allocated memory for the
+ *  stored key and its value must be freed (value `1`) or not (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void upo_rbt_delete(upo_rbt_t tree, const void *key, int destroy_data);
+
+/**
+ * \brief Removes the key-value pair with the smallest key in the given
+ *  red-black tree.
+ *
+ * \param tree The red-black tree.
+ * \param destroy_data Tells whether the previously allocated memory for the
+ *  stored key and its value must be freed (value `1`) or not (value `0`).
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void upo_rbt_delete_min(upo_rbt_t tree, int destroy_data);
+
+/**
+ * \brief Removes the key-value pair with the largest key in the given
+ *  red-black tree.
+ *
+ * \param tree The red-black tree.
+ * \param destroy_data Tells whether the previously allocated memory for the
+ *  stored key and its value must be freed (value `1`) or not (value `0`).
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void upo_rbt_delete_max(upo_rbt_t tree, int destroy_data);
+
+/**
+ * \brief Returns the number of keys stored on the given red-black tree.
+ *
+ * \param tree The red-black tree.
+ * \return The number of keys, or `0` if the tree is `NULL`.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_rbt_size(const upo_rbt_t tree);
+
+/**
+ * \brief Tells if the given red-black tree is empty.
+ *
+ * \param tree The red-black tree.
+ * \return `1` if the red-black tree is empty or `NULL`, or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_rbt_is_empty(const upo_rbt_t tree);
+
+/**
+ * \brief Returns the height of the given red-black tree.
+ *
+ * \param tree The red-black tree.
+ * \return The number of links of the longest path from the root to a leaf,
+ *  `0` for empty trees and trees with a single node.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+size_t upo_rbt_height(const upo_rbt_t tree);
+
+/**
+ * \brief Performs a depth-first in-order traversal of the tree.
+ *
+ * \param tree The red-black tree to traverse.
+ * \param visit The visit function.
+ * \param visit_context Additional information, passed to the visit function
+ *  as third parameter.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_rbt_traverse_in_order(const upo_rbt_t tree, upo_bst_visitor_t visit, void *visit_context);
+
+/**
+ * \brief Returns the smallest key in the given red-black tree.
+ *
+ * \param tree The red-black tree.
+ * \return The smallest key, or `NULL` if the tree is empty.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_rbt_min(const upo_rbt_t tree);
+
+/**
+ * \brief Returns the largest key in the given red-black tree.
+ *
+ * \param tree The red-black tree.
+ * \return The largest key, or `NULL` if the tree is empty.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_rbt_max(const upo_rbt_t tree);
+
+/**
+ * \brief Returns the largest key in the red-black tree which is less than or
+ *  equal to the given key.
+ *
+ * \param tree The red-black tree.
+ * \param key The key.
+ * \return The largest key which is less than or equal to the given key, or
+ *  `NULL` if there is no such key.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_rbt_floor(const upo_rbt_t tree, const void *key);
+
+/**
+ * \brief Returns the smallest key in the red-black tree which is greater than
+ *  or equal to the given key.
+ *
+ * \param tree The red-black tree.
+ * \param key The key.
+ * \return The smallest key which is greater than or equal to the given key,
+ *  or `NULL` if there is no such key.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_rbt_ceiling(const upo_rbt_t tree, const void *key);
+
+/**
+ * \brief Returns the number of keys in the red-black tree which are less than
+ *  the given key.
+ *
+ * \param tree The red-black tree.
+ * \param key The key, which needs not be in the tree.
+ * \return The number of keys less than \a key.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+size_t upo_rbt_rank(const upo_rbt_t tree, const void *key);
+
+/**
+ * \brief Returns the key of the given rank in the red-black tree.
+ *
+ * \param tree The red-black tree.
+ * \param rank The rank, from `0` for the smallest key.
+ * \return The key with \a rank smaller keys, or `NULL` if \a rank is not
+ *  less than the size of the tree.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_rbt_select(const upo_rbt_t tree, size_t rank);
+
+/**
+ * \brief Returns the keys in the given red-black tree that are inside the
+ *  provided range of keys.
+ *
+ * \param tree The red-black tree.
+ * \param low_key The lower bound of the range of keys.
+ * \param high_key The upper bound of the range of keys.
+ * \return A singly-linked list of the keys inside the provided range (bounds
+ *  included) in ascending order, or `NULL` if no key falls inside the range.
+ *
+ * Only the subtrees that may hold keys of the range are visited.
+ *
+ * Worst-case complexity: logarithmic in the number `n` of elements plus
+ *  linear in the number `k` of returned keys, `O(log(n) + k)`.
+ */
+upo_bst_key_list_t upo_rbt_keys_range(const upo_rbt_t tree, const void *low_key, const void *high_key);
+
+/**
+ * \brief Returns the keys in the given red-black tree.
+ *
+ * \param tree The red-black tree.
+ * \return A singly-linked list of keys in ascending order, or `NULL` if the
+ *  tree is empty.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+upo_bst_key_list_t upo_rbt_keys(const upo_rbt_t tree);
+
+/**
+ * \brief Checks if the given tree satisfies the properties of left-leaning
+ *  red-black trees.
+ *
+ * \param tree The red-black tree to check.
+ * \return `1` if keys are ordered, red nodes are left children without red
+ *  children, all paths have the same number of black nodes, the root is
+ *  black, and subtree sizes are consistent, or `0` otherwise.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+int upo_rbt_is_rbt(const upo_rbt_t tree);
+
+/**
+ * \brief Returns the comparison function stored in the red-black tree.
+ *
+ * \param tree The red-black tree.
+ * \return The comparison function.
+ */
+upo_bst_comparator_t upo_rbt_get_comparator(const upo_rbt_t tree);
+
+
+#endif /* UPO_RBT_H */
@@ -0,0 +1,330 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file upo/splay.h
+ *
+ * \brief The Splay Tree abstract data type.
+ *
+ * Splay Trees (by D. D. Sleator and R. E. Tarjan) are Binary Search Trees
+ * (see upo/bst.h) that move each accessed key to the root by a sequence of
+ * rotations (a "splay"), without storing any balance information in nodes.
+ * A single operation may take linear time, but any sequence of `m`
+ * operations on a tree with at most `n` keys takes `O((m+n) log(n))` time.
+ * Moreover, a key accessed `q` times out of `m` accesses costs amortized
+ * `O(log(m/q))` time, so recently and frequently accessed keys stay close
+ * to the root: with skewed access patterns (e.g., Zipfian ones) lookups
+ * visit fewer nodes than in a balanced tree.
+ *
+ * Splaying is top-down: the search path is split into a left tree and a
+ * right tree while descending, and reassembled once the key is reached, so
+ * operations take one pass and constant extra space.
+ * Since lookups and ordered queries restructure the tree, they take a
+ * non-const tree.
+ * The height of a splay tree may be linear in the number of keys, hence no
+ * operation is recursive.
+ *
+ * Comparison functions, visit functions and lists of keys are those of
+ * binary search trees.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_SPLAY_H
+#define UPO_SPLAY_H
+
+
+#include <stddef.h>
+#include <upo/bst.h>
+
+
+/** \brief Declares the Splay Tree type. */
+typedef struct upo_splay_s* upo_splay_t;
+
+
+/**
+ * \brief Creates a new empty splay tree.
+ *
+ * \param key_cmp A pointer to the function used to compare keys.
+ * \return An empty splay tree.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+upo_splay_t upo_splay_create(upo_bst_comparator_t key_cmp);
+
+/**
+ * \brief Destroys the given splay tree together with data stored on it.
+ *
+ * \param tree The splay tree to destroy.
+ * \param destroy_data Tells whether the previously allocated memory for keys
+ *  and values stored in this splay tree must be freed (value `1`) or not
+ *  (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_splay_destroy(upo_splay_t tree, int destroy_data);
+
+/**
+ * \brief Removes all elements from the given splay tree.
+ *
+ * \param tree The splay tree to clear.
+ * \param destroy_data Tells whether the previously allocated memory for keys
+ *  and values stored in this splay tree must be freed (value `1`) or not
+ *  (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_splay_clear(upo_splay_t tree, int destroy_data);
+
+/**
+ * \brief Inserts the given value identified by the provided key in the given
+ *  splay tree.
+ *
+ * \param tree The splay tree.
+ * \param key The key.
+ * \param value The value.
+ * \return The replaced value in case of a duplicate, otherwise `NULL`.
+ *
+ * If the key is already present in the tree, the associated value is replaced
+ * by the one provided as argument to this function (and the stored key is
+ * kept).
+ * In both cases, the key becomes the root of the tree.
+ *
+ * Amortized complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_splay_put(upo_splay_t tree, void *key, void *value);
+
+/**
+ * \brief Inserts the given value identified by the provided key in the given
+ *  splay tree but ignores duplicates.
+ *
+ * \param tree The splay tree.
+ * \param key The key.
+ * \param value The value.
+ *
+ * Amortized complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void upo_splay_insert(upo_splay_t tree, void *key, void *value);
+
+/**
+ * \brief Returns the value identified by the provided key in the given
+ *  splay tree.
+ *
+ * \param tree The splay tree.
+ * \param key The key.
+ * \return The value associated to \a key, or `NULL` if the key is not found.
+ *
+ * The key (or the last key met while looking for it) becomes the root of
+ * the tree.
+ *
+ * Amortized complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_splay_get(upo_splay_t tree, const void *key);
+
+/**
+ * \brief Tells if the given splay tree contains an item identified by
+ *  the given key.
+ *
+ * \param tree The splay tree.
+ * \param key The key.
+ * \return `1` if the splay tree contains the key, or `0` otherwise.
+ *
+ * Like upo_splay_get(), this function splays the tree.
+ *
+ * Amortized complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+int upo_splay_contains(upo_splay_t tree, const void *key);
+
+/**
+ * \brief Removes the value identified by the provided key in the given
+ *  splay tree.
+ *
+ * \param tree The splay tree.
+ * \param key The key.
+ * \param destroy_data Tells whether the previously allocated memory for the
+ *  stored key and its value must be freed (value `1`) or not (value `0`).
+ *
+ * Memory deallocation (if requested) is performed by means of the `free()`
+ * standard C function.
+ *
+ * Amortized complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void upo_splay_delete(upo_splay_t tree, const void *key, int destroy_data);
+
+/**
+ * \brief Returns the number of keys stored on the given splay tree.
+ *
+ * \param tree The splay tree.
+ * \return The number of keys, or `0` if the tree is `NULL`.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+size_t upo_splay_size(const upo_splay_t tree);
+
+/**
+ * \brief Tells if the given splay tree is empty.
+ *
+ * \param tree The splay tree.
+ * \return `1` if the splay tree is empty or `NULL`, or `0` otherwise.
+ *
+ * Worst-case complexity: constant, `O(1)`.
+ */
+int upo_splay_is_empty(const upo_splay_t tree);
+
+/**
+ * \brief Returns the height of the given splay tree.
+ *
+ * \param tree The splay tree.
+ * \return The number of links of the longest path from the root to a leaf,
+ *  `0` for empty trees and trees with a single node.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+size_t upo_splay_height(const upo_splay_t tree);
+
+/**
+ * \brief Performs a depth-first in-order traversal of the tree.
+ *
+ * \param tree The splay tree to traverse.
+ * \param visit The visit function, which must not modify the tree.
+ * \param visit_context Additional information, passed to the visit function
+ *  as third parameter.
+ *
+ * The traversal does not splay the tree.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+void upo_splay_traverse_in_order(const upo_splay_t tree, upo_bst_visitor_t visit, void *visit_context);
+
+/**
+ * \brief Returns the smallest key in the given splay tree.
+ *
+ * \param tree The splay tree.
+ * \return The smallest key, or `NULL` if the tree is empty.
+ *
+ * The smallest key becomes the root of the tree.
+ *
+ * Amortized complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_splay_min(upo_splay_t tree);
+
+/**
+ * \brief Returns the largest key in the given splay tree.
+ *
+ * \param tree The splay tree.
+ * \return The largest key, or `NULL` if the tree is empty.
+ *
+ * The largest key becomes the root of the tree.
+ *
+ * Amortized complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_splay_max(upo_splay_t tree);
+
+/**
+ * \brief Returns the largest key in the splay tree which is less than or
+ *  equal to the given key.
+ *
+ * \param tree The splay tree.
+ * \param key The key.
+ * \return The largest key which is less than or equal to the given key, or
+ *  `NULL` if there is no such key.
+ *
+ * Amortized complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_splay_floor(upo_splay_t tree, const void *key);
+
+/**
+ * \brief Returns the smallest key in the splay tree which is greater than
+ *  or equal to the given key.
+ *
+ * \param tree The splay tree.
+ * \param key The key.
+ * \return The smallest key which is greater than or equal to the given key,
+ *  or `NULL` if there is no such key.
+ *
+ * Amortized complexity: logarithmic in the number `n` of elements,
+ *  `O(log(n))`.
+ */
+void* upo_splay_ceiling(upo_splay_t tree, const void *key);
+
+/**
+ * \brief Returns the keys in the given splay tree that are inside the
+ *  provided range of keys.
+ *
+ * \param tree The splay tree.
+ * \param low_key The lower bound of the range of keys.
+ * \param high_key The upper bound of the range of keys.
+ * \return A singly-linked list of the keys inside the provided range (bounds
+ *  included) in ascending order, or `NULL` if no key falls inside the range.
+ *
+ * The tree is splayed at \a low_key, so that the walk to the first key of
+ * the range is short, and only the subtrees that may hold keys of the range
+ * are visited.
+ *
+ * Amortized complexity: logarithmic in the number `n` of elements plus
+ *  linear in the number `k` of returned keys, `O(log(n) + k)`.
+ */
+upo_bst_key_list_t upo_splay_keys_range(upo_splay_t tree, const void *low_key, const void *high_key);
+
+/**
+ * \brief Returns the keys in the given splay tree.
+ *
+ * \param tree The splay tree.
+ * \return A singly-linked list of keys in ascending order, or `NULL` if the
+ *  tree is empty.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+upo_bst_key_list_t upo_splay_keys(const upo_splay_t tree);
+
+/**
+ * \brief Checks if the given tree is a valid binary search tree.
+ *
+ * \param tree The splay tree to check.
+ * \return `1` if keys are in strictly ascending order and the stored size is
+ *  consistent, or `0` otherwise.
+ *
+ * Worst-case complexity: linear in the number `n` of elements, `O(n)`.
+ */
+int upo_splay_is_bst(const upo_splay_t tree);
+
+/**
+ * \brief Returns the comparison function stored in the splay tree.
+ *
+ * \param tree The splay tree.
+ * \return The comparison function.
+ */
+upo_bst_comparator_t upo_splay_get_comparator(const upo_splay_t tree);
+
+
+#endif /* UPO_SPLAY_H */
@@ -0,0 +1,608 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include "avl_private.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/*** BEGIN of NODE OPERATIONS ***/
+
+
+upo_avl_node_t* upo_avl_node_create(void *key, void *value)
+{
+    upo_avl_node_t *node = malloc(sizeof(struct upo_avl_node_s));
+
+    if (node == NULL)
+    {
+        perror("Unable to allocate memory for a node of the AVL Tree");
+        abort();
+    }
+    node->key = key;
+    node->value = value;
+    node->left = NULL;
+    node->right = NULL;
+    node->height = 1;
+
+    return node;
+}
+
+int upo_avl_node_height(const upo_avl_node_t *node)
+{
+    return (node != NULL) ? node->height : 0;
+}
+
+void upo_avl_update_height(upo_avl_node_t *node)
+{
+    int left = upo_avl_node_height(node->left);
+    int right = upo_avl_node_height(node->right);
+
+    node->height = 1 + (left > right ? left : right);
+}
+
+upo_avl_node_t* upo_avl_rotate_left(upo_avl_node_t *node)
+{
+    upo_avl_node_t *x = node->right;
+
+    node->right = x->left;
+    x->left = node;
+    upo_avl_update_height(node);
+    upo_avl_update_height(x);
+
+    return x;
+}
+
+upo_avl_node_t* upo_avl_rotate_right(upo_avl_node_t *node)
+{
+    upo_avl_node_t *x = node->left;
+
+    node->left = x->right;
+    x->right = node;
+    upo_avl_update_height(node);
+    upo_avl_update_height(x);
+
+    return x;
+}
+
+upo_avl_node_t* upo_avl_rebalance(upo_avl_node_t *node)
+{
+    int balance = upo_avl_node_height(node->left) - upo_avl_node_height(node->right);
+
+    assert( balance >= -2 && balance <= 2 );
+
+    if (balance > 1)
+    {
+        /* Left-right case: first make the left child lean left */
+        if (upo_avl_node_height(node->left->left) < upo_avl_node_height(node->left->right))
+        {
+            node->left = upo_avl_rotate_left(node->left);
+        }
+        return upo_avl_rotate_right(node);
+    }
+    if (balance < -1)
+    {
+        if (upo_avl_node_height(node->right->right) < upo_avl_node_height(node->right->left))
+        {
+            node->right = upo_avl_rotate_right(node->right);
+        }
+        return upo_avl_rotate_left(node);
+    }
+    upo_avl_update_height(node);
+
+    return node;
+}
+
+void upo_avl_retrace(upo_avl_node_t **path[], size_t depth)
+{
+    while (depth > 0)
+    {
+        upo_avl_node_t **link = path[--depth];
+        int old_height = (*link)->height;
+
+        *link = upo_avl_rebalance(*link);
+        if ((*link)->height == old_height)
+        {
+            break;
+        }
+    }
+}
+
+
+/*** END of NODE OPERATIONS ***/
+
+
+/*** BEGIN of FUNDAMENTAL OPERATIONS ***/
+
+
+upo_avl_t upo_avl_create(upo_bst_comparator_t key_cmp)
+{
+    upo_avl_t tree = NULL;
+
+    assert( key_cmp != NULL );
+
+    tree = malloc(sizeof(struct upo_avl_s));
+    if (tree == NULL)
+    {
+        perror("Unable to allocate memory for AVL Tree");
+        abort();
+    }
+    tree->root = NULL;
+    tree->size = 0;
+    tree->key_cmp = key_cmp;
+
+    return tree;
+}
+
+void upo_avl_destroy(upo_avl_t tree, int destroy_data)
+{
+    if (tree != NULL)
+    {
+        upo_avl_clear(tree, destroy_data);
+        free(tree);
+    }
+}
+
+void upo_avl_clear_impl(upo_avl_node_t *node, int destroy_data)
+{
+    if (node != NULL)
+    {
+        upo_avl_clear_impl(node->left, destroy_data);
+        upo_avl_clear_impl(node->right, destroy_data);
+        if (destroy_data)
+        {
+            free(node->key);
+            free(node->value);
+        }
+        free(node);
+    }
+}
+
+void upo_avl_clear(upo_avl_t tree, int destroy_data)
+{
+    if (tree != NULL)
+    {
+        upo_avl_clear_impl(tree->root, destroy_data);
+        tree->root = NULL;
+        tree->size = 0;
+    }
+}
+
+void* upo_avl_put_impl(upo_avl_t tree, void *key, void *value, int replace)
+{
+    upo_avl_node_t **path[UPO_AVL_MAX_HEIGHT];
+    upo_avl_node_t **link = NULL;
+    size_t depth = 0;
+
+    assert( tree != NULL );
+
+    /* Remember the link to each node on the search path */
+    link = &tree->root;
+    while (*link != NULL)
+    {
+        int cmp = tree->key_cmp(key, (*link)->key);
+
+        if (cmp == 0)
+        {
+            void *old_value = (*link)->value;
+
+            if (replace)
+            {
+                (*link)->value = value;
+            }
+            return old_value;
+        }
+        assert( depth < UPO_AVL_MAX_HEIGHT );
+        path[depth++] = link;
+        link = (cmp < 0) ? &(*link)->left : &(*link)->right;
+    }
+
+    *link = upo_avl_node_create(key, value);
+    tree->size += 1;
+    upo_avl_retrace(path, depth);
+
+    return NULL;
+}
+
+void* upo_avl_put(upo_avl_t tree, void *key, void *value)
+{
+    assert( tree != NULL );
+
+    return upo_avl_put_impl(tree, key, value, 1);
+}
+
+void upo_avl_insert(upo_avl_t tree, void *key, void *value)
+{
+    assert( tree != NULL );
+
+    upo_avl_put_impl(tree, key, value, 0);
+}
+
+void* upo_avl_get(const upo_avl_t tree, const void *key)
+{
+    const upo_avl_node_t *node = NULL;
+
+    if (tree == NULL)
+    {
+        return NULL;
+    }
+
+    node = tree->root;
+    while (node != NULL)
+    {
+        int cmp = tree->key_cmp(key, node->key);
+
+        if (cmp == 0)
+        {
+            return node->value;
+        }
+        node = (cmp < 0) ? node->left : node->right;
+    }
+
+    return NULL;
+}
+
+int upo_avl_contains(const upo_avl_t tree, const void *key)
+{
+    const upo_avl_node_t *node = NULL;
+
+    if (tree == NULL)
+    {
+        return 0;
+    }
+
+    node = tree->root;
+    while (node != NULL)
+    {
+        int cmp = tree->key_cmp(key, node->key);
+
+        if (cmp == 0)
+        {
+            return 1;
+        }
+        node = (cmp < 0) ? node->left : node->right;
+    }
+
+    return 0;
+}
+
+void upo_avl_delete(upo_avl_t tree, const void *key, int destroy_data)
+{
+    upo_avl_node_t **path[UPO_AVL_MAX_HEIGHT];
+    upo_avl_node_t **link = NULL;
+    upo_avl_node_t *node = NULL;
+    size_t depth = 0;
+
+    if (tree == NULL)
+    {
+        return;
+    }
+
+    link = &tree->root;
+    while (*link != NULL)
+    {
+        int cmp = tree->key_cmp(key, (*link)->key);
+
+        if (cmp == 0)
+        {
+            break;
+        }
+        assert( depth < UPO_AVL_MAX_HEIGHT );
+        path[depth++] = link;
+        link = (cmp < 0) ? &(*link)->left : &(*link)->right;
+    }
+    if (*link == NULL)
+    {
+        return;
+    }
+
+    node = *link;
+    if (destroy_data)
+    {
+        free(node->key);
+        free(node->value);
+    }
+    if (node->left != NULL && node->right != NULL)
+    {
+        /* Move the successor pair into the node, and unlink the successor,
+         * which has no left child */
+        upo_avl_node_t **succ_link = &node->right;
+        upo_avl_node_t *succ = NULL;
+
+        path[depth++] = link;
+        while ((*succ_link)->left != NULL)
+        {
+            assert( depth < UPO_AVL_MAX_HEIGHT );
+            path[depth++] = succ_link;
+            succ_link = &(*succ_link)->left;
+        }
+        succ = *succ_link;
+        node->key = succ->key;
+        node->value = succ->value;
+        *succ_link = succ->right;
+        free(succ);
+    }
+    else
+    {
+        *link = (node->left != NULL) ? node->left : node->right;
+        free(node);
+    }
+    tree->size -= 1;
+    upo_avl_retrace(path, depth);
+}
+
+size_t upo_avl_size(const upo_avl_t tree)
+{
+    return (tree != NULL) ? tree->size : 0;
+}
+
+int upo_avl_is_empty(const upo_avl_t tree)
+{
+    return tree == NULL || tree->root == NULL;
+}
+
+size_t upo_avl_height(const upo_avl_t tree)
+{
+    /* Stored heights count nodes, while the height of a tree counts links */
+    return upo_avl_is_empty(tree) ? 0 : (size_t) tree->root->height - 1;
+}
+
+void upo_avl_traverse_in_order_impl(const upo_avl_node_t *node, upo_bst_visitor_t visit, void *visit_context)
+{
+    if (node != NULL)
+    {
+        upo_avl_traverse_in_order_impl(node->left, visit, visit_context);
+        visit(node->key, node->value, visit_context);
+        upo_avl_traverse_in_order_impl(node->right, visit, visit_context);
+    }
+}
+
+void upo_avl_traverse_in_order(const upo_avl_t tree, upo_bst_visitor_t visit, void *visit_context)
+{
+    if (tree != NULL)
+    {
+        upo_avl_traverse_in_order_impl(tree->root, visit, visit_context);
+    }
+}
+
+upo_bst_comparator_t upo_avl_get_comparator(const upo_avl_t tree)
+{
+    return (tree != NULL) ? tree->key_cmp : NULL;
+}
+
+
+/*** END of FUNDAMENTAL OPERATIONS ***/
+
+
+/*** BEGIN of ORDERED OPERATIONS ***/
+
+
+void* upo_avl_min(const upo_avl_t tree)
+{
+    const upo_avl_node_t *node = NULL;
+
+    if (upo_avl_is_empty(tree))
+    {
+        return NULL;
+    }
+    for (node = tree->root; node->left != NULL; node = node->left)
+    {
+    }
+
+    return node->key;
+}
+
+void* upo_avl_max(const upo_avl_t tree)
+{
+    const upo_avl_node_t *node = NULL;
+
+    if (upo_avl_is_empty(tree))
+    {
+        return NULL;
+    }
+    for (node = tree->root; node->right != NULL; node = node->right)
+    {
+    }
+
+    return node->key;
+}
+
+void* upo_avl_floor(const upo_avl_t tree, const void *key)
+{
+    const upo_avl_node_t *node = NULL;
+    void *floor = NULL;
+
+    if (tree == NULL)
+    {
+        return NULL;
+    }
+
+    /* The floor is the last key not greater than key on the search path */
+    node = tree->root;
+    while (node != NULL)
+    {
+        int cmp = tree->key_cmp(key, node->key);
+
+        if (cmp == 0)
+        {
+            return node->key;
+        }
+        if (cmp < 0)
+        {
+            node = node->left;
+        }
+        else
+        {
+            floor = node->key;
+            node = node->right;
+        }
+    }
+
+    return floor;
+}
+
+void* upo_avl_ceiling(const upo_avl_t tree, const void *key)
+{
+    const upo_avl_node_t *node = NULL;
+    void *ceiling = NULL;
+
+    if (tree == NULL)
+    {
+        return NULL;
+    }
+
+    node = tree->root;
+    while (node != NULL)
+    {
+        int cmp = tree->key_cmp(key, node->key);
+
+        if (cmp == 0)
+        {
+            return node->key;
+        }
+        if (cmp > 0)
+        {
+            node = node->right;
+        }
+        else
+        {
+            ceiling = node->key;
+            node = node->left;
+        }
+    }
+
+    return ceiling;
+}
+
+void upo_avl_key_list_prepend(upo_bst_key_list_t *list, void *key)
+{
+    upo_bst_key_list_node_t *list_node = malloc(sizeof(upo_bst_key_list_node_t));
+
+    if (list_node == NULL)
+    {
+        perror("Unable to allocate memory for a node of the list of keys");
+        abort();
+    }
+    list_node->key = key;
+    list_node->next = *list;
+    *list = list_node;
+}
+
+void upo_avl_keys_range_impl(const upo_avl_node_t *node, const void *low_key, const void *high_key, upo_bst_comparator_t key_cmp, upo_bst_key_list_t *list)
+{
+    int cmp_low = 0;
+    int cmp_high = 0;
+
+    if (node == NULL)
+    {
+        return;
+    }
+
+    cmp_low = key_cmp(low_key, node->key);
+    cmp_high = key_cmp(high_key, node->key);
+    if (cmp_high > 0)
+    {
+        upo_avl_keys_range_impl(node->right, low_key, high_key, key_cmp, list);
+    }
+    if (cmp_low <= 0 && cmp_high >= 0)
+    {
+        upo_avl_key_list_prepend(list, node->key);
+    }
+    if (cmp_low < 0)
+    {
+        upo_avl_keys_range_impl(node->left, low_key, high_key, key_cmp, list);
+    }
+}
+
+upo_bst_key_list_t upo_avl_keys_range(const upo_avl_t tree, const void *low_key, const void *high_key)
+{
+    upo_bst_key_list_t list = NULL;
+
+    if (tree != NULL)
+    {
+        upo_avl_keys_range_impl(tree->root, low_key, high_key, tree->key_cmp, &list);
+    }
+
+    return list;
+}
+
+void upo_avl_keys_impl(const upo_avl_node_t *node, upo_bst_key_list_t *list)
+{
+    if (node != NULL)
+    {
+        upo_avl_keys_impl(node->right, list);
+        upo_avl_key_list_prepend(list, node->key);
+        upo_avl_keys_impl(node->left, list);
+    }
+}
+
+upo_bst_key_list_t upo_avl_keys(const upo_avl_t tree)
+{
+    upo_bst_key_list_t list = NULL;
+
+    if (tree != NULL)
+    {
+        upo_avl_keys_impl(tree->root, &list);
+    }
+
+    return list;
+}
+
+int upo_avl_is_avl_impl(const upo_avl_node_t *node, const void *min_key, const void *max_key, upo_bst_comparator_t key_cmp, size_t *size)
+{
+    int left = 0;
+    int right = 0;
+
+    if (node == NULL)
+    {
+        return 1;
+    }
+
+    if ((min_key != NULL && key_cmp(node->key, min_key) <= 0)
+        || (max_key != NULL && key_cmp(node->key, max_key) >= 0)
+        || !upo_avl_is_avl_impl(node->left, min_key, node->key, key_cmp, size)
+        || !upo_avl_is_avl_impl(node->right, node->key, max_key, key_cmp, size))
+    {
+        return 0;
+    }
+    left = upo_avl_node_height(node->left);
+    right = upo_avl_node_height(node->right);
+    *size += 1;
+
+    return left - right >= -1 && left - right <= 1
+           && node->height == 1 + (left > right ? left : right);
+}
+
+int upo_avl_is_avl(const upo_avl_t tree)
+{
+    size_t size = 0;
+
+    if (tree == NULL)
+    {
+        return 1;
+    }
+
+    return upo_avl_is_avl_impl(tree->root, NULL, NULL, tree->key_cmp, &size)
+           && size == tree->size;
+}
+
+
+/*** END of ORDERED OPERATIONS ***/
@@ -0,0 +1,155 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/avl_private.h
+ *
+ * \brief Private header for the AVL Tree abstract data type.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef UPO_AVL_PRIVATE_H
+#define UPO_AVL_PRIVATE_H
+
+
+#include <stddef.h>
+#include <upo/avl.h>
+
+
+/**
+ * \brief The maximum number of nodes on a path from the root.
+ *
+ * An AVL tree of height `h` has at least `F(h+2) - 1` nodes, where `F(i)` is
+ * the `i`-th Fibonacci number, so no tree fitting in memory is higher.
+ */
+#define UPO_AVL_MAX_HEIGHT 96
+
+
+/** \brief Alias for AVL tree node type. */
+typedef struct upo_avl_node_s upo_avl_node_t;
+
+/** \brief Type for nodes of an AVL tree. */
+struct upo_avl_node_s
+{
+    void *key; /**< Pointer to user-provided key. */
+    void *value; /**< Pointer to user-provided value. */
+    upo_avl_node_t *left; /**< Pointer to the left child node. */
+    upo_avl_node_t *right; /**< Pointer to the right child node. */
+    int height; /**< The number of nodes of the longest path from this node to a leaf. */
+};
+
+/** \brief Defines an AVL tree. */
+struct upo_avl_s
+{
+    upo_avl_node_t *root; /**< The root of the tree. */
+    size_t size; /**< The number of nodes of the tree. */
+    upo_bst_comparator_t key_cmp; /**< Pointer to the key comparison function. */
+};
+
+
+/**
+ * \brief Clears the subtree rooted at the given node.
+ *
+ * \param node The root of the subtree.
+ * \param destroy_data Tells whether keys and values must be freed.
+ */
+static void upo_avl_clear_impl(upo_avl_node_t *node, int destroy_data);
+
+/** \brief Creates a leaf holding the given key-value pair. */
+static upo_avl_node_t* upo_avl_node_create(void *key, void *value);
+
+/** \brief Returns the height of the given node, or `0` if it is `NULL`. */
+static int upo_avl_node_height(const upo_avl_node_t *node);
+
+/** \brief Recomputes the height of the given node from its children. */
+static void upo_avl_update_height(upo_avl_node_t *node);
+
+/** \brief Rotates left the subtree rooted at the given node and returns its new root. */
+static upo_avl_node_t* upo_avl_rotate_left(upo_avl_node_t *node);
+
+/** \brief Rotates right the subtree rooted at the given node and returns its new root. */
+static upo_avl_node_t* upo_avl_rotate_right(upo_avl_node_t *node);
+
+/**
+ * \brief Restores the balance of the given node, whose subtrees are balanced
+ *  and differ in height by at most two.
+ *
+ * \param node The node.
+ * \return The new root of the subtree, with an up-to-date height.
+ */
+static upo_avl_node_t* upo_avl_rebalance(upo_avl_node_t *node);
+
+/**
+ * \brief Rebalances the nodes on the given path, from the last one up.
+ *
+ * \param path The links followed from the root to the updated node.
+ * \param depth The number of links on the path.
+ *
+ * Stops as soon as a subtree keeps its height, since the balance of its
+ * ancestors does not change.
+ */
+static void upo_avl_retrace(upo_avl_node_t **path[], size_t depth);
+
+/**
+ * \brief Inserts the given key-value pair, or updates the value of the key
+ *  if \a replace is `1`.
+ *
+ * \param tree The AVL tree.
+ * \param key The key.
+ * \param value The value.
+ * \param replace Tells whether the value of a duplicate key is replaced.
+ * \return The value of the key before the call, or `NULL` if the key has
+ *  been inserted.
+ */
+static void* upo_avl_put_impl(upo_avl_t tree, void *key, void *value, int replace);
+
+/** \brief Visits in order the subtree rooted at the given node. */
+static void upo_avl_traverse_in_order_impl(const upo_avl_node_t *node, upo_bst_visitor_t visit, void *visit_context);
+
+/**
+ * \brief Prepends to the given list the keys of the subtree rooted at the
+ *  given node that are inside the given range, visiting them from the
+ *  largest one so that the list is in ascending order.
+ */
+static void upo_avl_keys_range_impl(const upo_avl_node_t *node, const void *low_key, const void *high_key, upo_bst_comparator_t key_cmp, upo_bst_key_list_t *list);
+
+/** \brief Prepends to the given list all keys of the subtree rooted at the given node, in ascending order. */
+static void upo_avl_keys_impl(const upo_avl_node_t *node, upo_bst_key_list_t *list);
+
+/** \brief Prepends the given key to the given list. */
+static void upo_avl_key_list_prepend(upo_bst_key_list_t *list, void *key);
+
+/**
+ * \brief Checks the properties of the subtree rooted at the given node.
+ *
+ * \param node The root of the subtree.
+ * \param min_key The key all keys of the subtree must be greater than, or
+ *  `NULL` if there is no lower bound.
+ * \param max_key The key all keys of the subtree must be less than, or
+ *  `NULL` if there is no upper bound.
+ * \param key_cmp The key comparison function.
+ * \param size Where the number of nodes of the subtree is added.
+ * \return `1` if the subtree is a valid AVL tree, or `0` otherwise.
+ */
+static int upo_avl_is_avl_impl(const upo_avl_node_t *node, const void *min_key, const void *max_key, upo_bst_comparator_t key_cmp, size_t *size);
+
+
+#endif /* UPO_AVL_PRIVATE_H */
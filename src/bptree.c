@@ -0,0 +1,895 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include "bptree_private.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/*** BEGIN of NODE OPERATIONS ***/
+
+
+upo_bptree_node_t* upo_bptree_node_create(int is_leaf)
+{
+    upo_bptree_node_t *node = aligned_alloc(UPO_BPTREE_CACHE_LINE_SIZE, sizeof(struct upo_bptree_node_s));
+
+    if (node == NULL)
+    {
+        perror("Unable to allocate memory for a node of the B+-Tree");
+        abort();
+    }
+    node->num_keys = 0;
+    node->is_leaf = is_leaf;
+    if (is_leaf)
+    {
+        node->next = NULL;
+    }
+
+    return node;
+}
+
+size_t upo_bptree_lower_bound(const upo_bptree_node_t *node, const void *key, upo_bst_comparator_t key_cmp)
+{
+    size_t lo = 0;
+    size_t hi = node->num_keys;
+
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo)/2;
+
+        if (key_cmp(node->keys[mid], key) < 0)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+size_t upo_bptree_upper_bound(const upo_bptree_node_t *node, const void *key, upo_bst_comparator_t key_cmp)
+{
+    size_t lo = 0;
+    size_t hi = node->num_keys;
+
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo)/2;
+
+        if (key_cmp(node->keys[mid], key) <= 0)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+upo_bptree_node_t* upo_bptree_find_leaf(const upo_bptree_t tree, const void *key)
+{
+    upo_bptree_node_t *node = tree->root;
+
+    /* Keys equal to a separator are in the subtree on its right */
+    while (!node->is_leaf)
+    {
+        node = node->children[upo_bptree_upper_bound(node, key, tree->key_cmp)];
+    }
+
+    return node;
+}
+
+upo_bptree_node_t* upo_bptree_leftmost_leaf(upo_bptree_node_t *node)
+{
+    while (!node->is_leaf)
+    {
+        node = node->children[0];
+    }
+
+    return node;
+}
+
+void upo_bptree_merge_children(upo_bptree_node_t *node, size_t i)
+{
+    upo_bptree_node_t *left = node->children[i];
+    upo_bptree_node_t *right = node->children[i + 1];
+
+    if (left->is_leaf)
+    {
+        assert( left->num_keys + right->num_keys <= UPO_BPTREE_MAX_KEYS );
+
+        memcpy(left->keys + left->num_keys, right->keys, right->num_keys*sizeof(void*));
+        memcpy(left->values + left->num_keys, right->values, right->num_keys*sizeof(void*));
+        left->next = right->next;
+    }
+    else
+    {
+        assert( left->num_keys + 1 + right->num_keys <= UPO_BPTREE_MAX_KEYS );
+
+        /* The separator comes down between the keys of the two nodes */
+        left->keys[left->num_keys++] = node->keys[i];
+        memcpy(left->keys + left->num_keys, right->keys, right->num_keys*sizeof(void*));
+        memcpy(left->children + left->num_keys, right->children, (right->num_keys + 1)*sizeof(upo_bptree_node_t*));
+    }
+    left->num_keys += right->num_keys;
+    free(right);
+
+    memmove(node->keys + i, node->keys + i + 1, (node->num_keys - i - 1)*sizeof(void*));
+    memmove(node->children + i + 1, node->children + i + 2, (node->num_keys - i - 1)*sizeof(upo_bptree_node_t*));
+    node->num_keys -= 1;
+}
+
+void upo_bptree_fix_child(upo_bptree_node_t *node, size_t i)
+{
+    upo_bptree_node_t *child = node->children[i];
+    upo_bptree_node_t *left = (i > 0) ? node->children[i - 1] : NULL;
+    upo_bptree_node_t *right = (i < node->num_keys) ? node->children[i + 1] : NULL;
+
+    if (left != NULL && left->num_keys > UPO_BPTREE_MIN_KEYS)
+    {
+        /* Move the largest pair of the left sibling to the child */
+        memmove(child->keys + 1, child->keys, child->num_keys*sizeof(void*));
+        if (child->is_leaf)
+        {
+            memmove(child->values + 1, child->values, child->num_keys*sizeof(void*));
+            child->keys[0] = left->keys[left->num_keys - 1];
+            child->values[0] = left->values[left->num_keys - 1];
+            node->keys[i - 1] = child->keys[0];
+        }
+        else
+        {
+            memmove(child->children + 1, child->children, (child->num_keys + 1)*sizeof(upo_bptree_node_t*));
+            child->keys[0] = node->keys[i - 1];
+            child->children[0] = left->children[left->num_keys];
+            node->keys[i - 1] = left->keys[left->num_keys - 1];
+        }
+        child->num_keys += 1;
+        left->num_keys -= 1;
+    }
+    else if (right != NULL && right->num_keys > UPO_BPTREE_MIN_KEYS)
+    {
+        /* Move the smallest pair of the right sibling to the child */
+        if (child->is_leaf)
+        {
+            child->keys[child->num_keys] = right->keys[0];
+            child->values[child->num_keys] = right->values[0];
+            memmove(right->values, right->values + 1, (right->num_keys - 1)*sizeof(void*));
+            memmove(right->keys, right->keys + 1, (right->num_keys - 1)*sizeof(void*));
+            node->keys[i] = right->keys[0];
+        }
+        else
+        {
+            child->keys[child->num_keys] = node->keys[i];
+            child->children[child->num_keys + 1] = right->children[0];
+            node->keys[i] = right->keys[0];
+            memmove(right->keys, right->keys + 1, (right->num_keys - 1)*sizeof(void*));
+            memmove(right->children, right->children + 1, right->num_keys*sizeof(upo_bptree_node_t*));
+        }
+        child->num_keys += 1;
+        right->num_keys -= 1;
+    }
+    else if (right != NULL)
+    {
+        upo_bptree_merge_children(node, i);
+    }
+    else
+    {
+        upo_bptree_merge_children(node, i - 1);
+    }
+}
+
+size_t upo_bptree_group_size(size_t count, size_t num_groups, size_t group)
+{
+    return count/num_groups + (group < count % num_groups ? 1 : 0);
+}
+
+
+/*** END of NODE OPERATIONS ***/
+
+
+/*** BEGIN of FUNDAMENTAL OPERATIONS ***/
+
+
+upo_bptree_t upo_bptree_create(upo_bst_comparator_t key_cmp)
+{
+    upo_bptree_t tree = NULL;
+
+    assert( key_cmp != NULL );
+
+    tree = malloc(sizeof(struct upo_bptree_s));
+    if (tree == NULL)
+    {
+        perror("Unable to allocate memory for B+-Tree");
+        abort();
+    }
+    tree->root = NULL;
+    tree->size = 0;
+    tree->height = 0;
+    tree->key_cmp = key_cmp;
+
+    return tree;
+}
+
+upo_bptree_t upo_bptree_build(upo_bst_comparator_t key_cmp, void *const *keys, void *const *values, size_t n)
+{
+    upo_bptree_t tree = upo_bptree_create(key_cmp);
+    upo_bptree_node_t **level = NULL;
+    void **level_min = NULL;
+    size_t count = 0;
+    size_t num_nodes = 0;
+    size_t i;
+    size_t j;
+
+    assert( keys != NULL || n == 0 );
+
+    if (n == 0)
+    {
+        return tree;
+    }
+
+    /* Nodes of the current level and the smallest keys of their subtrees */
+    num_nodes = (n + UPO_BPTREE_MAX_KEYS - 1)/UPO_BPTREE_MAX_KEYS;
+    level = malloc(num_nodes*sizeof(upo_bptree_node_t*));
+    level_min = malloc(num_nodes*sizeof(void*));
+    if (level == NULL || level_min == NULL)
+    {
+        perror("Unable to allocate memory for the levels of the B+-Tree");
+        abort();
+    }
+
+    /* Spreading pairs evenly among the fewest leaves keeps every leaf at
+     * least half full */
+    count = 0;
+    for (i = 0; i < num_nodes; ++i)
+    {
+        upo_bptree_node_t *leaf = upo_bptree_node_create(1);
+        size_t leaf_size = upo_bptree_group_size(n, num_nodes, i);
+
+        for (j = 0; j < leaf_size; ++j, ++count)
+        {
+            assert( count == 0 || key_cmp(keys[count - 1], keys[count]) < 0 );
+
+            leaf->keys[j] = keys[count];
+            leaf->values[j] = (values != NULL) ? values[count] : NULL;
+        }
+        leaf->num_keys = leaf_size;
+        if (i > 0)
+        {
+            level[i - 1]->next = leaf;
+        }
+        level[i] = leaf;
+        level_min[i] = leaf->keys[0];
+    }
+
+    /* Each level of inner nodes is built in place over the previous one */
+    while (num_nodes > 1)
+    {
+        size_t num_parents = (num_nodes + UPO_BPTREE_MAX_KEYS)/(UPO_BPTREE_MAX_KEYS + 1);
+
+        count = 0;
+        for (i = 0; i < num_parents; ++i)
+        {
+            upo_bptree_node_t *parent = upo_bptree_node_create(0);
+            size_t num_children = upo_bptree_group_size(num_nodes, num_parents, i);
+            void *parent_min = level_min[count];
+
+            for (j = 0; j < num_children; ++j, ++count)
+            {
+                parent->children[j] = level[count];
+                if (j > 0)
+                {
+                    parent->keys[j - 1] = level_min[count];
+                }
+            }
+            parent->num_keys = num_children - 1;
+            level[i] = parent;
+            level_min[i] = parent_min;
+        }
+        num_nodes = num_parents;
+        tree->height += 1;
+    }
+
+    tree->root = level[0];
+    tree->size = n;
+    free(level_min);
+    free(level);
+
+    return tree;
+}
+
+void upo_bptree_destroy(upo_bptree_t tree, int destroy_data)
+{
+    if (tree != NULL)
+    {
+        upo_bptree_clear(tree, destroy_data);
+        free(tree);
+    }
+}
+
+void upo_bptree_clear_impl(upo_bptree_node_t *node, int destroy_data)
+{
+    size_t i;
+
+    if (node->is_leaf)
+    {
+        if (destroy_data)
+        {
+            for (i = 0; i < node->num_keys; ++i)
+            {
+                free(node->keys[i]);
+                free(node->values[i]);
+            }
+        }
+    }
+    else
+    {
+        /* Separators are references to keys of the leaves */
+        for (i = 0; i <= node->num_keys; ++i)
+        {
+            upo_bptree_clear_impl(node->children[i], destroy_data);
+        }
+    }
+    free(node);
+}
+
+void upo_bptree_clear(upo_bptree_t tree, int destroy_data)
+{
+    if (tree != NULL)
+    {
+        if (tree->root != NULL)
+        {
+            upo_bptree_clear_impl(tree->root, destroy_data);
+        }
+        tree->root = NULL;
+        tree->size = 0;
+        tree->height = 0;
+    }
+}
+
+upo_bptree_node_t* upo_bptree_put_impl(upo_bptree_node_t *node, void *key, void *value, int replace, void **old_value, int *inserted, upo_bst_comparator_t key_cmp, void **split_key)
+{
+    void *keys[UPO_BPTREE_MAX_KEYS + 1];
+    void *items[UPO_BPTREE_MAX_KEYS + 2];
+    upo_bptree_node_t *right = NULL;
+    upo_bptree_node_t *child_right = NULL;
+    size_t num_keys = node->num_keys;
+    size_t num_left = 0;
+    size_t pos = 0;
+
+    if (node->is_leaf)
+    {
+        pos = upo_bptree_lower_bound(node, key, key_cmp);
+        if (pos < num_keys && key_cmp(key, node->keys[pos]) == 0)
+        {
+            *old_value = node->values[pos];
+            if (replace)
+            {
+                node->values[pos] = value;
+            }
+            return NULL;
+        }
+        *inserted = 1;
+
+        if (num_keys < UPO_BPTREE_MAX_KEYS)
+        {
+            memmove(node->keys + pos + 1, node->keys + pos, (num_keys - pos)*sizeof(void*));
+            memmove(node->values + pos + 1, node->values + pos, (num_keys - pos)*sizeof(void*));
+            node->keys[pos] = key;
+            node->values[pos] = value;
+            node->num_keys += 1;
+            return NULL;
+        }
+
+        /* Split the full leaf, copying up the smallest key of the right one */
+        memcpy(keys, node->keys, pos*sizeof(void*));
+        memcpy(items, node->values, pos*sizeof(void*));
+        keys[pos] = key;
+        items[pos] = value;
+        memcpy(keys + pos + 1, node->keys + pos, (num_keys - pos)*sizeof(void*));
+        memcpy(items + pos + 1, node->values + pos, (num_keys - pos)*sizeof(void*));
+
+        num_left = (num_keys + 1 + 1)/2;
+        right = upo_bptree_node_create(1);
+        memcpy(node->keys, keys, num_left*sizeof(void*));
+        memcpy(node->values, items, num_left*sizeof(void*));
+        node->num_keys = num_left;
+        memcpy(right->keys, keys + num_left, (num_keys + 1 - num_left)*sizeof(void*));
+        memcpy(right->values, items + num_left, (num_keys + 1 - num_left)*sizeof(void*));
+        right->num_keys = num_keys + 1 - num_left;
+        right->next = node->next;
+        node->next = right;
+        *split_key = right->keys[0];
+
+        return right;
+    }
+
+    pos = upo_bptree_upper_bound(node, key, key_cmp);
+    child_right = upo_bptree_put_impl(node->children[pos], key, value, replace, old_value, inserted, key_cmp, split_key);
+    if (child_right == NULL)
+    {
+        return NULL;
+    }
+
+    if (num_keys < UPO_BPTREE_MAX_KEYS)
+    {
+        memmove(node->keys + pos + 1, node->keys + pos, (num_keys - pos)*sizeof(void*));
+        memmove(node->children + pos + 2, node->children + pos + 1, (num_keys - pos)*sizeof(upo_bptree_node_t*));
+        node->keys[pos] = *split_key;
+        node->children[pos + 1] = child_right;
+        node->num_keys += 1;
+        return NULL;
+    }
+
+    /* Split the full inner node, moving up its middle separator */
+    memcpy(keys, node->keys, pos*sizeof(void*));
+    memcpy(items, node->children, (pos + 1)*sizeof(void*));
+    keys[pos] = *split_key;
+    items[pos + 1] = child_right;
+    memcpy(keys + pos + 1, node->keys + pos, (num_keys - pos)*sizeof(void*));
+    memcpy(items + pos + 2, node->children + pos + 1, (num_keys - pos)*sizeof(void*));
+
+    num_left = (num_keys + 1)/2;
+    right = upo_bptree_node_create(0);
+    memcpy(node->keys, keys, num_left*sizeof(void*));
+    memcpy(node->children, items, (num_left + 1)*sizeof(void*));
+    node->num_keys = num_left;
+    memcpy(right->keys, keys + num_left + 1, (num_keys - num_left)*sizeof(void*));
+    memcpy(right->children, items + num_left + 1, (num_keys - num_left + 1)*sizeof(void*));
+    right->num_keys = num_keys - num_left;
+    *split_key = keys[num_left];
+
+    return right;
+}
+
+void* upo_bptree_put(upo_bptree_t tree, void *key, void *value)
+{
+    upo_bptree_node_t *right = NULL;
+    void *old_value = NULL;
+    void *split_key = NULL;
+    int inserted = 0;
+
+    assert( tree != NULL );
+
+    if (tree->root == NULL)
+    {
+        tree->root = upo_bptree_node_create(1);
+    }
+
+    right = upo_bptree_put_impl(tree->root, key, value, 1, &old_value, &inserted, tree->key_cmp, &split_key);
+    if (right != NULL)
+    {
+        /* The root has been split: the tree grows by one level */
+        upo_bptree_node_t *root = upo_bptree_node_create(0);
+
+        root->keys[0] = split_key;
+        root->children[0] = tree->root;
+        root->children[1] = right;
+        root->num_keys = 1;
+        tree->root = root;
+        tree->height += 1;
+    }
+    tree->size += inserted;
+
+    return old_value;
+}
+
+void upo_bptree_insert(upo_bptree_t tree, void *key, void *value)
+{
+    upo_bptree_node_t *right = NULL;
+    void *old_value = NULL;
+    void *split_key = NULL;
+    int inserted = 0;
+
+    assert( tree != NULL );
+
+    if (tree->root == NULL)
+    {
+        tree->root = upo_bptree_node_create(1);
+    }
+
+    right = upo_bptree_put_impl(tree->root, key, value, 0, &old_value, &inserted, tree->key_cmp, &split_key);
+    if (right != NULL)
+    {
+        upo_bptree_node_t *root = upo_bptree_node_create(0);
+
+        root->keys[0] = split_key;
+        root->children[0] = tree->root;
+        root->children[1] = right;
+        root->num_keys = 1;
+        tree->root = root;
+        tree->height += 1;
+    }
+    tree->size += inserted;
+}
+
+void* upo_bptree_get(const upo_bptree_t tree, const void *key)
+{
+    const upo_bptree_node_t *leaf = NULL;
+    size_t pos = 0;
+
+    if (upo_bptree_is_empty(tree))
+    {
+        return NULL;
+    }
+
+    leaf = upo_bptree_find_leaf(tree, key);
+    pos = upo_bptree_lower_bound(leaf, key, tree->key_cmp);
+
+    return (pos < leaf->num_keys && tree->key_cmp(key, leaf->keys[pos]) == 0) ? leaf->values[pos] : NULL;
+}
+
+int upo_bptree_contains(const upo_bptree_t tree, const void *key)
+{
+    const upo_bptree_node_t *leaf = NULL;
+    size_t pos = 0;
+
+    if (upo_bptree_is_empty(tree))
+    {
+        return 0;
+    }
+
+    leaf = upo_bptree_find_leaf(tree, key);
+    pos = upo_bptree_lower_bound(leaf, key, tree->key_cmp);
+
+    return pos < leaf->num_keys && tree->key_cmp(key, leaf->keys[pos]) == 0;
+}
+
+int upo_bptree_delete_impl(upo_bptree_node_t *node, const void *key, upo_bst_comparator_t key_cmp, void **old_key, void **old_value)
+{
+    size_t pos = 0;
+
+    if (node->is_leaf)
+    {
+        pos = upo_bptree_lower_bound(node, key, key_cmp);
+        if (pos == node->num_keys || key_cmp(key, node->keys[pos]) != 0)
+        {
+            return 0;
+        }
+        *old_key = node->keys[pos];
+        *old_value = node->values[pos];
+        memmove(node->keys + pos, node->keys + pos + 1, (node->num_keys - pos - 1)*sizeof(void*));
+        memmove(node->values + pos, node->values + pos + 1, (node->num_keys - pos - 1)*sizeof(void*));
+        node->num_keys -= 1;
+        return 1;
+    }
+
+    pos = upo_bptree_upper_bound(node, key, key_cmp);
+    if (!upo_bptree_delete_impl(node->children[pos], key, key_cmp, old_key, old_value))
+    {
+        return 0;
+    }
+
+    /* A separator referring to the removed key is replaced by the new
+     * smallest key of its subtree, so that it never refers to freed data */
+    if (pos > 0 && node->keys[pos - 1] == *old_key)
+    {
+        node->keys[pos - 1] = upo_bptree_leftmost_leaf(node->children[pos])->keys[0];
+    }
+    if (node->children[pos]->num_keys < UPO_BPTREE_MIN_KEYS)
+    {
+        upo_bptree_fix_child(node, pos);
+    }
+
+    return 1;
+}
+
+void upo_bptree_delete(upo_bptree_t tree, const void *key, int destroy_data)
+{
+    void *old_key = NULL;
+    void *old_value = NULL;
+
+    if (upo_bptree_is_empty(tree)
+        || !upo_bptree_delete_impl(tree->root, key, tree->key_cmp, &old_key, &old_value))
+    {
+        return;
+    }
+    tree->size -= 1;
+
+    /* The root shrinks when its last two children are merged */
+    if (!tree->root->is_leaf && tree->root->num_keys == 0)
+    {
+        upo_bptree_node_t *root = tree->root;
+
+        tree->root = root->children[0];
+        tree->height -= 1;
+        free(root);
+    }
+    else if (tree->root->is_leaf && tree->root->num_keys == 0)
+    {
+        free(tree->root);
+        tree->root = NULL;
+    }
+
+    /* Data is freed last, since key may be the stored key itself */
+    if (destroy_data)
+    {
+        free(old_key);
+        free(old_value);
+    }
+}
+
+size_t upo_bptree_size(const upo_bptree_t tree)
+{
+    return (tree != NULL) ? tree->size : 0;
+}
+
+int upo_bptree_is_empty(const upo_bptree_t tree)
+{
+    return tree == NULL || tree->root == NULL;
+}
+
+size_t upo_bptree_height(const upo_bptree_t tree)
+{
+    return (tree != NULL) ? tree->height : 0;
+}
+
+void upo_bptree_traverse_in_order(const upo_bptree_t tree, upo_bst_visitor_t visit, void *visit_context)
+{
+    const upo_bptree_node_t *leaf = NULL;
+    size_t i;
+
+    if (upo_bptree_is_empty(tree))
+    {
+        return;
+    }
+
+    for (leaf = upo_bptree_leftmost_leaf(tree->root); leaf != NULL; leaf = leaf->next)
+    {
+        for (i = 0; i < leaf->num_keys; ++i)
+        {
+            visit(leaf->keys[i], leaf->values[i], visit_context);
+        }
+    }
+}
+
+upo_bst_comparator_t upo_bptree_get_comparator(const upo_bptree_t tree)
+{
+    return (tree != NULL) ? tree->key_cmp : NULL;
+}
+
+
+/*** END of FUNDAMENTAL OPERATIONS ***/
+
+
+/*** BEGIN of ORDERED OPERATIONS ***/
+
+
+void* upo_bptree_min(const upo_bptree_t tree)
+{
+    if (upo_bptree_is_empty(tree))
+    {
+        return NULL;
+    }
+
+    return upo_bptree_leftmost_leaf(tree->root)->keys[0];
+}
+
+void* upo_bptree_max(const upo_bptree_t tree)
+{
+    const upo_bptree_node_t *node = NULL;
+
+    if (upo_bptree_is_empty(tree))
+    {
+        return NULL;
+    }
+
+    for (node = tree->root; !node->is_leaf; node = node->children[node->num_keys])
+    {
+    }
+
+    return node->keys[node->num_keys - 1];
+}
+
+void* upo_bptree_floor(const upo_bptree_t tree, const void *key)
+{
+    const upo_bptree_node_t *leaf = NULL;
+    size_t pos = 0;
+
+    if (upo_bptree_is_empty(tree))
+    {
+        return NULL;
+    }
+
+    /* The search never leaves a subtree whose smallest key is not greater
+     * than key, so the floor (if any) is in the leaf found */
+    leaf = upo_bptree_find_leaf(tree, key);
+    pos = upo_bptree_upper_bound(leaf, key, tree->key_cmp);
+
+    return (pos > 0) ? leaf->keys[pos - 1] : NULL;
+}
+
+void* upo_bptree_ceiling(const upo_bptree_t tree, const void *key)
+{
+    const upo_bptree_node_t *leaf = NULL;
+    size_t pos = 0;
+
+    if (upo_bptree_is_empty(tree))
+    {
+        return NULL;
+    }
+
+    leaf = upo_bptree_find_leaf(tree, key);
+    pos = upo_bptree_lower_bound(leaf, key, tree->key_cmp);
+    if (pos < leaf->num_keys)
+    {
+        return leaf->keys[pos];
+    }
+
+    /* All keys of the leaf are smaller: the ceiling starts the next one */
+    return (leaf->next != NULL) ? leaf->next->keys[0] : NULL;
+}
+
+upo_bst_key_list_t upo_bptree_keys_range(const upo_bptree_t tree, const void *low_key, const void *high_key)
+{
+    upo_bst_key_list_t list = NULL;
+    upo_bst_key_list_t *tail = &list;
+    const upo_bptree_node_t *leaf = NULL;
+    size_t pos = 0;
+
+    if (upo_bptree_is_empty(tree))
+    {
+        return NULL;
+    }
+
+    leaf = upo_bptree_find_leaf(tree, low_key);
+    pos = upo_bptree_lower_bound(leaf, low_key, tree->key_cmp);
+    while (leaf != NULL)
+    {
+        for (; pos < leaf->num_keys; ++pos)
+        {
+            upo_bst_key_list_node_t *list_node = NULL;
+
+            if (tree->key_cmp(leaf->keys[pos], high_key) > 0)
+            {
+                return list;
+            }
+
+            list_node = malloc(sizeof(upo_bst_key_list_node_t));
+            if (list_node == NULL)
+            {
+                perror("Unable to allocate memory for a node of the list of keys");
+                abort();
+            }
+            list_node->key = leaf->keys[pos];
+            list_node->next = NULL;
+            *tail = list_node;
+            tail = &list_node->next;
+        }
+        leaf = leaf->next;
+        pos = 0;
+    }
+
+    return list;
+}
+
+upo_bst_key_list_t upo_bptree_keys(const upo_bptree_t tree)
+{
+    upo_bst_key_list_t list = NULL;
+    upo_bst_key_list_t *tail = &list;
+    const upo_bptree_node_t *leaf = NULL;
+    size_t i;
+
+    if (upo_bptree_is_empty(tree))
+    {
+        return NULL;
+    }
+
+    for (leaf = upo_bptree_leftmost_leaf(tree->root); leaf != NULL; leaf = leaf->next)
+    {
+        for (i = 0; i < leaf->num_keys; ++i)
+        {
+            upo_bst_key_list_node_t *list_node = malloc(sizeof(upo_bst_key_list_node_t));
+
+            if (list_node == NULL)
+            {
+                perror("Unable to allocate memory for a node of the list of keys");
+                abort();
+            }
+            list_node->key = leaf->keys[i];
+            list_node->next = NULL;
+            *tail = list_node;
+            tail = &list_node->next;
+        }
+    }
+
+    return list;
+}
+
+int upo_bptree_is_bptree_impl(const upo_bptree_node_t *node, size_t depth, const upo_bptree_t tree, const void *min_key, const void *max_key, const upo_bptree_node_t **prev_leaf, size_t *size)
+{
+    size_t i;
+
+    if (node->num_keys > UPO_BPTREE_MAX_KEYS
+        || (node != tree->root && node->num_keys < UPO_BPTREE_MIN_KEYS)
+        || (node->is_leaf != (depth == tree->height)))
+    {
+        return 0;
+    }
+    for (i = 0; i < node->num_keys; ++i)
+    {
+        if ((i > 0 && tree->key_cmp(node->keys[i - 1], node->keys[i]) >= 0)
+            || (min_key != NULL && tree->key_cmp(node->keys[i], min_key) < 0)
+            || (max_key != NULL && tree->key_cmp(node->keys[i], max_key) >= 0))
+        {
+            return 0;
+        }
+    }
+
+    if (node->is_leaf)
+    {
+        /* Leaves are visited from left to right */
+        if (node->num_keys == 0 || (*prev_leaf != NULL && (*prev_leaf)->next != node))
+        {
+            return 0;
+        }
+        *prev_leaf = node;
+        *size += node->num_keys;
+        return 1;
+    }
+
+    for (i = 0; i <= node->num_keys; ++i)
+    {
+        const void *child_min = (i > 0) ? node->keys[i - 1] : min_key;
+        const void *child_max = (i < node->num_keys) ? node->keys[i] : max_key;
+
+        /* Each separator must be the smallest key of its right subtree */
+        if (i > 0 && upo_bptree_leftmost_leaf(node->children[i])->keys[0] != node->keys[i - 1])
+        {
+            return 0;
+        }
+        if (!upo_bptree_is_bptree_impl(node->children[i], depth + 1, tree, child_min, child_max, prev_leaf, size))
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+int upo_bptree_is_bptree(const upo_bptree_t tree)
+{
+    const upo_bptree_node_t *prev_leaf = NULL;
+    size_t size = 0;
+
+    if (tree == NULL)
+    {
+        return 1;
+    }
+    if (tree->root == NULL)
+    {
+        return tree->size == 0 && tree->height == 0;
+    }
+
+    return upo_bptree_is_bptree_impl(tree->root, 0, tree, NULL, NULL, &prev_leaf, &size)
+           && prev_leaf->next == NULL
+           && size == tree->size;
+}
+
+
+/*** END of ORDERED OPERATIONS ***/
@@ -0,0 +1,194 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/bptree_private.h
+ *
+ * \brief Private header for the B+-Tree abstract data type.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef UPO_BPTREE_PRIVATE_H
+#define UPO_BPTREE_PRIVATE_H
+
+
+#include <stdalign.h>
+#include <stddef.h>
+#include <upo/bptree.h>
+
+
+/** \brief The assumed size (in bytes) of a cache line. */
+#define UPO_BPTREE_CACHE_LINE_SIZE 64U
+
+/**
+ * \brief The size (in bytes) of nodes, a multiple of the cache line size.
+ *
+ * Eight cache lines hold about thirty keys per node on 64-bit machines, so
+ * a tree with fifty million keys has six levels instead of the (at least)
+ * twenty-six of a binary search tree.
+ */
+#define UPO_BPTREE_NODE_SIZE 512U
+
+/**
+ * \brief The maximum number of keys of a node.
+ *
+ * A node stores two counters, and either one more child than keys or a value
+ * per key and the link to the next leaf.
+ */
+#define UPO_BPTREE_MAX_KEYS ((UPO_BPTREE_NODE_SIZE - 3*sizeof(void*))/(2*sizeof(void*)))
+
+/** \brief The minimum number of keys of a node other than the root. */
+#define UPO_BPTREE_MIN_KEYS (UPO_BPTREE_MAX_KEYS/2)
+
+
+/** \brief Alias for B+-tree node type. */
+typedef struct upo_bptree_node_s upo_bptree_node_t;
+
+/** \brief Type for nodes of a B+-tree, either leaves or inner nodes. */
+struct upo_bptree_node_s
+{
+    alignas(UPO_BPTREE_CACHE_LINE_SIZE) size_t num_keys; /**< The number of keys of the node. */
+    int is_leaf; /**< Tells whether the node is a leaf (value `1`) or an inner node (value `0`). */
+    void *keys[UPO_BPTREE_MAX_KEYS]; /**< The keys (or separators) in ascending order. */
+    union
+    {
+        upo_bptree_node_t *children[UPO_BPTREE_MAX_KEYS + 1]; /**< The children of an inner node. */
+        struct
+        {
+            void *values[UPO_BPTREE_MAX_KEYS]; /**< The values of the keys of a leaf. */
+            upo_bptree_node_t *next; /**< The next leaf, or `NULL` for the last one. */
+        };
+    };
+};
+
+_Static_assert(sizeof(struct upo_bptree_node_s) == UPO_BPTREE_NODE_SIZE, "B+-tree nodes must fill their cache lines exactly");
+
+/** \brief Defines a B+-tree. */
+struct upo_bptree_s
+{
+    upo_bptree_node_t *root; /**< The root of the tree, or `NULL` if the tree is empty. */
+    size_t size; /**< The number of keys of the tree. */
+    size_t height; /**< The number of links from the root to any leaf. */
+    upo_bst_comparator_t key_cmp; /**< Pointer to the key comparison function. */
+};
+
+
+/** \brief Creates an empty leaf (if \a is_leaf is `1`) or inner node. */
+static upo_bptree_node_t* upo_bptree_node_create(int is_leaf);
+
+/**
+ * \brief Clears the subtree rooted at the given node.
+ *
+ * \param node The root of the subtree.
+ * \param destroy_data Tells whether keys and values must be freed.
+ */
+static void upo_bptree_clear_impl(upo_bptree_node_t *node, int destroy_data);
+
+/** \brief Returns the position of the first key of the node not less than the given key. */
+static size_t upo_bptree_lower_bound(const upo_bptree_node_t *node, const void *key, upo_bst_comparator_t key_cmp);
+
+/** \brief Returns the position of the first key of the node greater than the given key. */
+static size_t upo_bptree_upper_bound(const upo_bptree_node_t *node, const void *key, upo_bst_comparator_t key_cmp);
+
+/** \brief Returns the leaf whose range of keys includes the given key. */
+static upo_bptree_node_t* upo_bptree_find_leaf(const upo_bptree_t tree, const void *key);
+
+/** \brief Returns the leftmost leaf of the subtree rooted at the given node. */
+static upo_bptree_node_t* upo_bptree_leftmost_leaf(upo_bptree_node_t *node);
+
+/**
+ * \brief Inserts the given key-value pair in the subtree rooted at the given
+ *  node, or updates the value of the key if \a replace is `1`.
+ *
+ * \param node The root of the subtree.
+ * \param key The key.
+ * \param value The value.
+ * \param replace Tells whether the value of a duplicate key is replaced.
+ * \param old_value Where the value of a duplicate key is stored.
+ * \param inserted Where `1` is stored if the key has been inserted.
+ * \param key_cmp The key comparison function.
+ * \param split_key Where the smallest key of the new sibling is stored.
+ * \return The new right sibling of \a node if it has been split, or `NULL`
+ *  otherwise.
+ */
+static upo_bptree_node_t* upo_bptree_put_impl(upo_bptree_node_t *node, void *key, void *value, int replace, void **old_value, int *inserted, upo_bst_comparator_t key_cmp, void **split_key);
+
+/**
+ * \brief Removes the given key from the subtree rooted at the given node.
+ *
+ * \param node The root of the subtree.
+ * \param key The key.
+ * \param key_cmp The key comparison function.
+ * \param old_key Where the stored key is saved.
+ * \param old_value Where the stored value is saved.
+ * \return `1` if the key has been found, or `0` otherwise.
+ *
+ * Children of \a node left with too few keys are fixed, while \a node itself
+ * may be left with too few keys, to be fixed by its parent.
+ */
+static int upo_bptree_delete_impl(upo_bptree_node_t *node, const void *key, upo_bst_comparator_t key_cmp, void **old_key, void **old_value);
+
+/**
+ * \brief Fixes the given child of the given inner node, which has one key
+ *  less than the minimum, by moving a key from a sibling or by merging it
+ *  with a sibling.
+ *
+ * \param node The parent node.
+ * \param i The position of the child.
+ */
+static void upo_bptree_fix_child(upo_bptree_node_t *node, size_t i);
+
+/**
+ * \brief Merges the child of the given inner node at position \a i + 1 into
+ *  the child at position \a i.
+ */
+static void upo_bptree_merge_children(upo_bptree_node_t *node, size_t i);
+
+/**
+ * \brief Returns the number of items of a group, when the given number of
+ *  items is split as evenly as possible in the given number of groups.
+ *
+ * \param count The number of items.
+ * \param num_groups The number of groups.
+ * \param group The position of the group.
+ * \return The number of items of the group.
+ */
+static size_t upo_bptree_group_size(size_t count, size_t num_groups, size_t group);
+
+/**
+ * \brief Checks the properties of the subtree rooted at the given node.
+ *
+ * \param node The root of the subtree.
+ * \param depth The depth of \a node.
+ * \param tree The tree.
+ * \param min_key The key all keys of the subtree must be greater than or
+ *  equal to, or `NULL` if there is no lower bound.
+ * \param max_key The key all keys of the subtree must be less than, or
+ *  `NULL` if there is no upper bound.
+ * \param prev_leaf The last leaf visited so far, which must link to the next
+ *  one.
+ * \param size Where the number of keys of the leaves is added.
+ * \return `1` if the subtree is a valid B+-tree, or `0` otherwise.
+ */
+static int upo_bptree_is_bptree_impl(const upo_bptree_node_t *node, size_t depth, const upo_bptree_t tree, const void *min_key, const void *max_key, const upo_bptree_node_t **prev_leaf, size_t *size);
+
+
+#endif /* UPO_BPTREE_PRIVATE_H */
@@ -19,7 +19,10 @@
  * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <assert.h>
 #include "bst_private.h"
+#include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -29,6 +32,14 @@
 
 upo_bst_t upo_bst_create(upo_bst_comparator_t key_cmp)
 {
+    return upo_bst_create_with_pool(key_cmp, NULL);
+}
+
+upo_bst_t upo_bst_create_with_pool(upo_bst_comparator_t key_cmp, upo_pool_t pool)
+{
+    /* The pool is cleared with the tree, so it cannot hold other blocks */
+    assert( pool == NULL || upo_pool_size(pool) == 0 );
+
     upo_bst_t tree = malloc(sizeof(struct upo_bst_s));
     if (tree == NULL)
     {
@@ -38,10 +49,55 @@ upo_bst_t upo_bst_create(upo_bst_comparator_t key_cmp)
 
     tree->root = NULL;
     tree->key_cmp = key_cmp;
+    tree->node_pool = pool;
+    tree->alpha = 1.0;
+    tree->max_size = 0;
 
     return tree;
 }
 
+upo_pool_t upo_bst_pool_create(size_t chunk_capacity)
+{
+    return upo_pool_create(sizeof(struct upo_bst_node_s), chunk_capacity);
+}
+
+upo_bst_t upo_bst_build_from_sorted(upo_bst_comparator_t key_cmp, void *const *keys, void *const *values, size_t n)
+{
+    upo_bst_t tree = upo_bst_create(key_cmp);
+    size_t i;
+
+    assert( keys != NULL || n == 0 );
+
+    for (i = 1; i < n; ++i)
+    {
+        assert( key_cmp(keys[i - 1], keys[i]) < 0 );
+    }
+
+    tree->root = upo_bst_build_impl(keys, values, 0, n);
+    tree->max_size = n;
+
+    return tree;
+}
+
+upo_bst_node_t* upo_bst_build_impl(void *const *keys, void *const *values, size_t lo, size_t hi)
+{
+    upo_bst_node_t *node = NULL;
+    size_t mid = lo + (hi - lo)/2;
+
+    if (lo >= hi)
+    {
+        return NULL;
+    }
+
+    /* The recursion depth is logarithmic, as the tree is balanced */
+    node = upo_bst_node_create(keys[mid], (values != NULL) ? values[mid] : NULL, NULL);
+    node->left = upo_bst_build_impl(keys, values, lo, mid);
+    node->right = upo_bst_build_impl(keys, values, mid + 1, hi);
+    node->size = hi - lo;
+
+    return node;
+}
+
 void upo_bst_destroy(upo_bst_t tree, int destroy_data)
 {
     if (tree != NULL)
@@ -51,12 +107,13 @@ void upo_bst_destroy(upo_bst_t tree, int destroy_data)
     }
 }
 
-void upo_bst_clear_impl(upo_bst_node_t *node, int destroy_data)
+void upo_bst_clear_impl(upo_bst_node_t *node, int destroy_data, upo_pool_t pool)
 {
+#ifdef UPO_BST_USE_RECURSIVE_TRAVERSAL
     if (node != NULL)
     {
-        upo_bst_clear_impl(node->left, destroy_data);
-        upo_bst_clear_impl(node->right, destroy_data);
+        upo_bst_clear_impl(node->left, destroy_data, pool);
+        upo_bst_clear_impl(node->right, destroy_data, pool);
 
         if (destroy_data)
         {
@@ -64,22 +121,63 @@ void upo_bst_clear_impl(upo_bst_node_t *node, int destroy_data)
             free(node->value);
         }
 
-        free(node);
+        /* Pooled nodes are all released at once by the caller */
+        if (pool == NULL)
+        {
+            free(node);
+        }
+    }
+#else
+    while (node != NULL)
+    {
+        if (node->left != NULL)
+        {
+            /* Rotate right, until the node to free has no left child */
+            upo_bst_node_t *left = node->left;
+
+            node->left = left->right;
+            left->right = node;
+            node = left;
+        }
+        else
+        {
+            upo_bst_node_t *right = node->right;
+
+            if (destroy_data)
+            {
+                free(node->key);
+                free(node->value);
+            }
+
+            /* Pooled nodes are all released at once by the caller */
+            if (pool == NULL)
+            {
+                free(node);
+            }
+            node = right;
+        }
     }
+#endif /* UPO_BST_USE_RECURSIVE_TRAVERSAL */
 }
 
 void upo_bst_clear(upo_bst_t tree, int destroy_data)
 {
     if (tree != NULL)
     {
-        upo_bst_clear_impl(tree->root, destroy_data);
+        /* Without data to destroy, pooled nodes need not be visited */
+        if (tree->node_pool == NULL || destroy_data)
+        {
+            upo_bst_clear_impl(tree->root, destroy_data, tree->node_pool);
+        }
+        upo_pool_clear(tree->node_pool);
+        tree->max_size = 0;
         tree->root = NULL;
     }
 }
 
-upo_bst_node_t* upo_bst_node_create(void *key, void *value) {
+upo_bst_node_t* upo_bst_node_create(void *key, void *value, upo_pool_t pool) {
     upo_bst_node_t *node = NULL;
-    node = malloc(sizeof(struct upo_bst_node_s));
+    node = (pool != NULL) ? upo_pool_alloc(pool) : malloc(sizeof(struct upo_bst_node_s));
     if(node == NULL) {
         perror("Unable to create node.");
         abort();
@@ -88,46 +186,160 @@ upo_bst_node_t* upo_bst_node_create(void *key, void *value) {
     node->value = value;
     node->left = NULL;
     node->right = NULL;
+    node->size = 1;
     return node;
 }
 
-upo_bst_node_t* upo_bst_put_impl(upo_bst_node_t *node, void *key, void *value, void *old_value, upo_bst_comparator_t key_cmp) {
-    old_value = NULL;
-    if(node == NULL) return upo_bst_node_create(key, value);
-    else if(key_cmp(key, node->key) < 0) node->left = upo_bst_put_impl(node->left, key, value, old_value, key_cmp);
-    else if(key_cmp(key, node->key) > 0) node->right = upo_bst_put_impl(node->right, key, value, old_value, key_cmp);
+void upo_bst_node_destroy(upo_bst_node_t *node, upo_pool_t pool) {
+    if(pool != NULL) upo_pool_free(pool, node);
+    else free(node);
+}
+
+#ifdef UPO_BST_USE_RECURSIVE_PUT
+
+upo_bst_node_t* upo_bst_put_impl(upo_bst_node_t *node, void *key, void *value, void **old_value, upo_bst_comparator_t key_cmp, upo_pool_t pool) {
+    if(node == NULL) return upo_bst_node_create(key, value, pool);
+    else if(key_cmp(key, node->key) < 0) node->left = upo_bst_put_impl(node->left, key, value, old_value, key_cmp, pool);
+    else if(key_cmp(key, node->key) > 0) node->right = upo_bst_put_impl(node->right, key, value, old_value, key_cmp, pool);
     else {
-        old_value = node->value;
+        *old_value = node->value;
         node->value = value;
     }
+    node->size = 1 + upo_bst_size_impl(node->left) + upo_bst_size_impl(node->right);
+    return node;
+}
+
+upo_bst_node_t* upo_bst_insert_impl(upo_bst_node_t *node, void *key, void *value, upo_bst_comparator_t key_cmp, upo_pool_t pool) {
+    if(node == NULL) return upo_bst_node_create(key, value, pool);
+    else if(key_cmp(key, node->key) < 0) node->left = upo_bst_insert_impl(node->left, key, value, key_cmp, pool);
+    else if(key_cmp(key, node->key) > 0) node->right = upo_bst_insert_impl(node->right, key, value, key_cmp, pool);
+    node->size = 1 + upo_bst_size_impl(node->left) + upo_bst_size_impl(node->right);
     return node;
 }
 
+#else
+
+void* upo_bst_put_iterative_impl(upo_bst_t tree, void *key, void *value, int replace, size_t *depth)
+{
+    upo_bst_node_t *path[UPO_BST_PUT_PATH_DEPTH];
+    upo_bst_node_t **link = &tree->root;
+    size_t i;
+
+    *depth = 0;
+
+    while (*link != NULL)
+    {
+        int cmp = tree->key_cmp(key, (*link)->key);
+
+        if (cmp == 0)
+        {
+            void *old_value = (*link)->value;
+
+            if (replace)
+            {
+                (*link)->value = value;
+            }
+            return old_value;
+        }
+
+        if (*depth < UPO_BST_PUT_PATH_DEPTH)
+        {
+            path[*depth] = *link;
+        }
+        link = (cmp < 0) ? &(*link)->left : &(*link)->right;
+        *depth += 1;
+    }
+    *link = upo_bst_node_create(key, value, tree->node_pool);
+
+    /* A node has been added: its ancestors grow by one */
+    if (*depth > UPO_BST_PUT_PATH_DEPTH)
+    {
+        upo_bst_path_resize_impl(tree->root, key, tree->key_cmp, 1);
+    }
+    else
+    {
+        for (i = 0; i < *depth; ++i)
+        {
+            path[i]->size += 1;
+        }
+    }
+
+    return NULL;
+}
+
+#endif /* UPO_BST_USE_RECURSIVE_PUT */
+
+#if !defined(UPO_BST_USE_RECURSIVE_PUT) || !defined(UPO_BST_USE_RECURSIVE_DELETE)
+
+void upo_bst_path_resize_impl(upo_bst_node_t *node, const void *key, upo_bst_comparator_t key_cmp, int grow)
+{
+    while (node != NULL)
+    {
+        int cmp = key_cmp(key, node->key);
+
+        if (cmp == 0)
+        {
+            return;
+        }
+        if (grow)
+        {
+            node->size += 1;
+        }
+        else
+        {
+            node->size -= 1;
+        }
+        node = (cmp < 0) ? node->left : node->right;
+    }
+}
+
+#endif
+
 void* upo_bst_put(upo_bst_t tree, void *key, void *value)
 {
     void *old_value = NULL;
-    tree->root = upo_bst_put_impl(tree->root, key, value, old_value, tree->key_cmp);
-    return old_value;
-}
+    size_t old_size = upo_bst_size_impl(tree->root);
+    size_t depth = SIZE_MAX;
 
-upo_bst_node_t* upo_bst_insert_impl(upo_bst_node_t *node, void *key, void *value, upo_bst_comparator_t key_cmp) {
-    if(node == NULL) return upo_bst_node_create(key, value);
-    else if(key_cmp(key, node->key) < 0) node->left = upo_bst_insert_impl(node->left, key, value, key_cmp);
-    else if(key_cmp(key, node->key) > 0) node->right = upo_bst_insert_impl(node->right, key, value, key_cmp);
-    return node;
+#ifdef UPO_BST_USE_RECURSIVE_PUT
+    tree->root = upo_bst_put_impl(tree->root, key, value, &old_value, tree->key_cmp, tree->node_pool);
+#else
+    old_value = upo_bst_put_iterative_impl(tree, key, value, 1, &depth);
+#endif /* UPO_BST_USE_RECURSIVE_PUT */
+    upo_bst_scapegoat_insert_fix_impl(tree, key, old_size, depth);
+
+    return old_value;
 }
 
 void upo_bst_insert(upo_bst_t tree, void *key, void *value)
 {
-    tree->root = upo_bst_insert_impl(tree->root, key, value, tree->key_cmp);
+    size_t old_size = upo_bst_size_impl(tree->root);
+    size_t depth = SIZE_MAX;
+
+#ifdef UPO_BST_USE_RECURSIVE_PUT
+    tree->root = upo_bst_insert_impl(tree->root, key, value, tree->key_cmp, tree->node_pool);
+#else
+    upo_bst_put_iterative_impl(tree, key, value, 0, &depth);
+#endif /* UPO_BST_USE_RECURSIVE_PUT */
+    upo_bst_scapegoat_insert_fix_impl(tree, key, old_size, depth);
 }
 
 upo_bst_node_t* upo_bst_get_impl(upo_bst_node_t *node, const void *key, upo_bst_comparator_t key_cmp) {
+#ifdef UPO_BST_USE_RECURSIVE_GET
     if(node == NULL) return NULL;
     if(key_cmp(key, node->key) < 0) return upo_bst_get_impl(node->left, key, key_cmp);
     else if(key_cmp(key, node->key) > 0) return upo_bst_get_impl(node->right, key, key_cmp);
     else return node;
-} 
+#else
+    while(node != NULL) {
+        int cmp = key_cmp(key, node->key);
+        if(cmp < 0) node = node->left;
+        else if(cmp > 0) node = node->right;
+        else return node;
+    }
+    return NULL;
+#endif /* UPO_BST_USE_RECURSIVE_GET */
+}
 
 void* upo_bst_get(const upo_bst_t tree, const void *key)
 {
@@ -141,7 +353,9 @@ int upo_bst_contains(const upo_bst_t tree, const void *key)
     return upo_bst_get_impl(tree->root, key, tree->key_cmp) != NULL ? 1 : 0;
 }
 
-upo_bst_node_t* upo_bst_delete_1C_impl(upo_bst_node_t *node, int destroy_data) {
+#ifdef UPO_BST_USE_RECURSIVE_DELETE
+
+upo_bst_node_t* upo_bst_delete_1C_impl(upo_bst_node_t *node, int destroy_data, upo_pool_t pool) {
     upo_bst_node_t *tmp = node;
     if(node->left != NULL) node = node->left;
     else node = node->right;
@@ -149,39 +363,182 @@ upo_bst_node_t* upo_bst_delete_1C_impl(upo_bst_node_t *node, int destroy_data) {
         free(tmp->key);
         free(tmp->value);
     } 
-    free(tmp);
+    upo_bst_node_destroy(tmp, pool);
     return node;
 }
 
-upo_bst_node_t* upo_bst_delete_2C_impl(upo_bst_node_t *node, int destroy_data, upo_bst_comparator_t key_cmp) {
+upo_bst_node_t* upo_bst_delete_2C_impl(upo_bst_node_t *node, int destroy_data, upo_bst_comparator_t key_cmp, upo_pool_t pool) {
     upo_bst_node_t *max = upo_bst_max_impl(node->left);
+    if(destroy_data == 1) {
+        free(node->key);
+        free(node->value);
+    }
+    /* The pair of max moves here, so only its node is freed */
     node->key = max->key;
     node->value = max->value;
-    node->left = upo_bst_delete_impl(node->left, node->key, destroy_data, key_cmp);
-    if(destroy_data == 1) {
-        free(max->key);
-        free(max->value);
-    } 
+    node->left = upo_bst_delete_impl(node->left, node->key, 0, key_cmp, pool);
     return node;
 }
 
-upo_bst_node_t* upo_bst_delete_impl(upo_bst_node_t *node, const void *key, int destroy_data, upo_bst_comparator_t key_cmp) {
+upo_bst_node_t* upo_bst_delete_impl(upo_bst_node_t *node, const void *key, int destroy_data, upo_bst_comparator_t key_cmp, upo_pool_t pool) {
     if(node == NULL) return NULL;
-    if(key_cmp(key, node->key) < 0) node->left = upo_bst_delete_impl(node->left, key, destroy_data, key_cmp);
-    else if(key_cmp(key, node->key) > 0) node->right = upo_bst_delete_impl(node->right, key, destroy_data, key_cmp);
-    else if(node->left != NULL && node->right != NULL) node = upo_bst_delete_2C_impl(node, destroy_data, key_cmp);
-    else node = upo_bst_delete_1C_impl(node, destroy_data);
+    if(key_cmp(key, node->key) < 0) node->left = upo_bst_delete_impl(node->left, key, destroy_data, key_cmp, pool);
+    else if(key_cmp(key, node->key) > 0) node->right = upo_bst_delete_impl(node->right, key, destroy_data, key_cmp, pool);
+    else if(node->left != NULL && node->right != NULL) node = upo_bst_delete_2C_impl(node, destroy_data, key_cmp, pool);
+    else node = upo_bst_delete_1C_impl(node, destroy_data, pool);
+    if(node != NULL) node->size = 1 + upo_bst_size_impl(node->left) + upo_bst_size_impl(node->right);
     return node;
 }
 
+#else
+
+void upo_bst_delete_iterative_impl(upo_bst_t tree, const void *key, int destroy_data)
+{
+    upo_bst_node_t **link = &tree->root;
+    upo_bst_node_t *node = NULL;
+
+    while (*link != NULL)
+    {
+        int cmp = tree->key_cmp(key, (*link)->key);
+
+        if (cmp == 0)
+        {
+            break;
+        }
+
+        /* The node to remove would be in this subtree */
+        (*link)->size -= 1;
+        link = (cmp < 0) ? &(*link)->left : &(*link)->right;
+    }
+
+    node = *link;
+    if (node == NULL)
+    {
+        /* No node is removed: undo the size decrements of the ancestors */
+        upo_bst_path_resize_impl(tree->root, key, tree->key_cmp, 1);
+        return;
+    }
+
+    /* The key may be the one of the node: do not use it from now on */
+    if (destroy_data)
+    {
+        free(node->key);
+        free(node->value);
+    }
+
+    if (node->left != NULL && node->right != NULL)
+    {
+        /* The pair of the max of the left subtree moves here, and its node
+         * (which has no right child) is removed instead */
+        upo_bst_node_t **max_link = &node->left;
+        upo_bst_node_t *max = NULL;
+
+        node->size -= 1;
+        while ((*max_link)->right != NULL)
+        {
+            (*max_link)->size -= 1;
+            max_link = &(*max_link)->right;
+        }
+        max = *max_link;
+        node->key = max->key;
+        node->value = max->value;
+        *max_link = max->left;
+        upo_bst_node_destroy(max, tree->node_pool);
+    }
+    else
+    {
+        *link = (node->left != NULL) ? node->left : node->right;
+        upo_bst_node_destroy(node, tree->node_pool);
+    }
+}
+
+#endif /* UPO_BST_USE_RECURSIVE_DELETE */
+
 void upo_bst_delete(upo_bst_t tree, const void *key, int destroy_data)
 {
-    tree->root = upo_bst_delete_impl(tree->root, key, destroy_data, tree->key_cmp);
+#ifdef UPO_BST_USE_RECURSIVE_DELETE
+    tree->root = upo_bst_delete_impl(tree->root, key, destroy_data, tree->key_cmp, tree->node_pool);
+#else
+    upo_bst_delete_iterative_impl(tree, key, destroy_data);
+#endif /* UPO_BST_USE_RECURSIVE_DELETE */
+
+    /* Scapegoat trees are rebuilt once they have shrunk too much */
+    if (tree->alpha < 1.0 && (double) upo_bst_size_impl(tree->root) < tree->alpha*tree->max_size)
+    {
+        upo_bst_rebalance(tree);
+    }
+}
+
+void upo_bst_set_scapegoat(upo_bst_t tree, double alpha)
+{
+    /* preconditions */
+    assert( tree != NULL );
+    assert( alpha > 0.5 && alpha <= 1.0 );
+
+    tree->alpha = alpha;
+    if (alpha < 1.0)
+    {
+        /* A balanced tree is within the height bound */
+        upo_bst_rebalance(tree);
+    }
+}
+
+int upo_bst_scapegoat_too_deep_impl(double alpha, size_t n, size_t depth)
+{
+    return depth > 0 && (double) depth > log((double) n)/log(1.0/alpha);
+}
+
+void upo_bst_scapegoat_insert_fix_impl(upo_bst_t tree, const void *key, size_t old_size, size_t depth)
+{
+    upo_bst_node_t **link = &tree->root;
+    upo_bst_node_t **scapegoat = NULL;
+    size_t n = upo_bst_size_impl(tree->root);
+
+    if (tree->alpha >= 1.0 || n == old_size)
+    {
+        /* Not a scapegoat tree, or no node added */
+        return;
+    }
+    if (n > tree->max_size)
+    {
+        tree->max_size = n;
+    }
+    if (depth != SIZE_MAX && !upo_bst_scapegoat_too_deep_impl(tree->alpha, n, depth))
+    {
+        return;
+    }
+
+    /* Walk down to the new node, looking for its deepest ancestor whose
+     * subtree is not alpha-weight-balanced */
+    depth = 0;
+    while (*link != NULL)
+    {
+        upo_bst_node_t *node = *link;
+        int cmp = tree->key_cmp(key, node->key);
+        upo_bst_node_t *child = NULL;
+
+        if (cmp == 0)
+        {
+            break;
+        }
+        child = (cmp < 0) ? node->left : node->right;
+        if ((double) child->size > tree->alpha*node->size)
+        {
+            scapegoat = link;
+        }
+        link = (cmp < 0) ? &node->left : &node->right;
+        ++depth;
+    }
+
+    if (scapegoat != NULL && upo_bst_scapegoat_too_deep_impl(tree->alpha, n, depth))
+    {
+        *scapegoat = upo_bst_rebalance_impl(*scapegoat);
+    }
 }
 
 size_t upo_bst_size_impl(upo_bst_node_t *node) {
     if(node == NULL) return 0;
-    return 1 + upo_bst_size_impl(node->left) + upo_bst_size_impl(node->right);
+    return node->size;
 }
 
 size_t upo_bst_size(const upo_bst_t tree)
@@ -195,6 +552,8 @@ int upo_bst_is_leaf_impl(upo_bst_node_t *node) {
     return 0;
 }
 
+#ifdef UPO_BST_USE_RECURSIVE_TRAVERSAL
+
 size_t upo_bst_height_impl(upo_bst_node_t *node) {
     if(node == NULL || upo_bst_is_leaf_impl(node)) return 0;
     size_t left = upo_bst_height_impl(node->left);
@@ -202,11 +561,6 @@ size_t upo_bst_height_impl(upo_bst_node_t *node) {
     return 1 + (left > right ? left : right);
 }
 
-size_t upo_bst_height(const upo_bst_t tree)
-{
-    return upo_bst_height_impl(tree->root);
-}
-
 void upo_bst_traverse_in_order_impl(upo_bst_node_t *node, upo_bst_visitor_t visit, void *visit_context) {
     if(node != NULL) {
         upo_bst_traverse_in_order_impl(node->left, visit, visit_context);
@@ -215,9 +569,138 @@ void upo_bst_traverse_in_order_impl(upo_bst_node_t *node, upo_bst_visitor_t visi
     }
 }
 
+#endif /* UPO_BST_USE_RECURSIVE_TRAVERSAL */
+
+size_t upo_bst_height(const upo_bst_t tree)
+{
+#ifdef UPO_BST_USE_RECURSIVE_TRAVERSAL
+    return upo_bst_height_impl(tree->root);
+#else
+    /* The height is the depth of the deepest node, which is a leaf */
+    upo_bst_iter_t it;
+    size_t max_depth = 0;
+
+    upo_bst_iter_seek(tree, &it, NULL);
+    while (upo_bst_iter_next(&it, NULL, NULL))
+    {
+        if (it.depth > max_depth)
+        {
+            max_depth = it.depth;
+        }
+    }
+    upo_bst_iter_destroy(&it);
+
+    return (max_depth > 0) ? max_depth - 1 : 0;
+#endif /* UPO_BST_USE_RECURSIVE_TRAVERSAL */
+}
+
+void upo_bst_rebalance(upo_bst_t tree)
+{
+    if (tree == NULL)
+    {
+        return;
+    }
+
+    tree->root = upo_bst_rebalance_impl(tree->root);
+    tree->max_size = upo_bst_size_impl(tree->root);
+}
+
+upo_bst_node_t* upo_bst_rebalance_impl(upo_bst_node_t *node)
+{
+    upo_bst_node_t pseudo_root;
+    size_t n = 0;
+    size_t full = 1;
+
+    if (node == NULL)
+    {
+        return NULL;
+    }
+
+    pseudo_root.left = NULL;
+    pseudo_root.right = node;
+    n = node->size;
+
+    upo_bst_tree_to_vine_impl(&pseudo_root);
+
+    /* The nodes beyond the largest complete tree (of 2^k-1 nodes) become
+     * the leaves of the bottom level */
+    while (2*full + 1 <= n)
+    {
+        full = 2*full + 1;
+    }
+    upo_bst_vine_compress_impl(&pseudo_root, n - full);
+    while (full > 1)
+    {
+        full /= 2;
+        upo_bst_vine_compress_impl(&pseudo_root, full);
+    }
+
+    return pseudo_root.right;
+}
+
+void upo_bst_tree_to_vine_impl(upo_bst_node_t *pseudo_root)
+{
+    upo_bst_node_t *tail = pseudo_root;
+    upo_bst_node_t *rest = tail->right;
+
+    while (rest != NULL)
+    {
+        if (rest->left == NULL)
+        {
+            tail = rest;
+            rest = rest->right;
+        }
+        else
+        {
+            /* Rotate right: the left child takes the place of the node */
+            upo_bst_node_t *left = rest->left;
+
+            rest->left = left->right;
+            left->right = rest;
+            left->size = rest->size;
+            rest->size = 1 + upo_bst_size_impl(rest->left) + upo_bst_size_impl(rest->right);
+            rest = left;
+            tail->right = left;
+        }
+    }
+}
+
+void upo_bst_vine_compress_impl(upo_bst_node_t *pseudo_root, size_t count)
+{
+    upo_bst_node_t *scanner = pseudo_root;
+    size_t i;
+
+    for (i = 0; i < count; ++i)
+    {
+        /* Rotate left: the right child takes the place of the node */
+        upo_bst_node_t *child = scanner->right;
+        upo_bst_node_t *right = child->right;
+
+        child->right = right->left;
+        right->left = child;
+        right->size = child->size;
+        child->size = 1 + upo_bst_size_impl(child->left) + upo_bst_size_impl(child->right);
+        scanner->right = right;
+        scanner = right;
+    }
+}
+
 void upo_bst_traverse_in_order(const upo_bst_t tree, upo_bst_visitor_t visit, void *visit_context)
 {
+#ifdef UPO_BST_USE_RECURSIVE_TRAVERSAL
     upo_bst_traverse_in_order_impl(tree->root, visit, visit_context);
+#else
+    upo_bst_iter_t it;
+    void *key = NULL;
+    void *value = NULL;
+
+    upo_bst_iter_seek(tree, &it, NULL);
+    while (upo_bst_iter_next(&it, &key, &value))
+    {
+        visit(key, value, visit_context);
+    }
+    upo_bst_iter_destroy(&it);
+#endif /* UPO_BST_USE_RECURSIVE_TRAVERSAL */
 }
 
 int upo_bst_is_empty(const upo_bst_t tree)
@@ -233,9 +716,14 @@ int upo_bst_is_empty(const upo_bst_t tree)
 
 void* upo_bst_min_impl(upo_bst_node_t *node) {
     if(node == NULL) return NULL;
+#ifdef UPO_BST_USE_RECURSIVE_GET
     if(node->left != NULL) return upo_bst_min_impl(node->left);
     else return node;
-} 
+#else
+    while(node->left != NULL) node = node->left;
+    return node;
+#endif /* UPO_BST_USE_RECURSIVE_GET */
+}
 
 void* upo_bst_min(const upo_bst_t tree)
 {
@@ -247,9 +735,14 @@ void* upo_bst_min(const upo_bst_t tree)
 
 void* upo_bst_max_impl(upo_bst_node_t *node) {
     if(node == NULL) return NULL;
+#ifdef UPO_BST_USE_RECURSIVE_GET
     if(node->right != NULL) return upo_bst_max_impl(node->right);
     else return node;
-}   
+#else
+    while(node->right != NULL) node = node->right;
+    return node;
+#endif /* UPO_BST_USE_RECURSIVE_GET */
+}
 
 void* upo_bst_max(const upo_bst_t tree)
 {
@@ -262,18 +755,17 @@ void* upo_bst_max(const upo_bst_t tree)
 void upo_bst_delete_min(upo_bst_t tree, int destroy_data)
 {
     if(tree == NULL || tree->root == NULL) return;
-    void *min = upo_bst_min(tree);
-    tree->root = upo_bst_delete_impl(tree->root, min, destroy_data, tree->key_cmp);
+    upo_bst_delete(tree, upo_bst_min(tree), destroy_data);
 }
 
 void upo_bst_delete_max(upo_bst_t tree, int destroy_data)
 {
     if(tree == NULL || tree->root == NULL) return;
-    void *max = upo_bst_max(tree);
-    tree->root = upo_bst_delete_impl(tree->root, max, destroy_data, tree->key_cmp);
+    upo_bst_delete(tree, upo_bst_max(tree), destroy_data);
 }
 
 const upo_bst_node_t *upo_bst_floor_impl(const upo_bst_node_t *node, const void *key, upo_bst_comparator_t key_cmp) {
+#ifdef UPO_BST_USE_RECURSIVE_GET
     if(node != NULL) {
         int cmp = key_cmp(key, node->key);
         if(cmp < 0) return upo_bst_floor_impl(node->left, key, key_cmp);
@@ -285,6 +777,20 @@ const upo_bst_node_t *upo_bst_floor_impl(const upo_bst_node_t *node, const void
         else return node;
     }
     return NULL;
+#else
+    const upo_bst_node_t *floor_node = NULL;
+    while(node != NULL) {
+        int cmp = key_cmp(key, node->key);
+        if(cmp < 0) node = node->left;
+        else if(cmp > 0) {
+            /* The floor is this node, unless a greater one is on the right */
+            floor_node = node;
+            node = node->right;
+        }
+        else return node;
+    }
+    return floor_node;
+#endif /* UPO_BST_USE_RECURSIVE_GET */
 }
 
 void* upo_bst_floor(const upo_bst_t tree, const void *key)
@@ -298,6 +804,7 @@ void* upo_bst_floor(const upo_bst_t tree, const void *key)
 }
 
 const upo_bst_node_t *upo_bst_ceiling_impl(const upo_bst_node_t *node, const void *key, upo_bst_comparator_t key_cmp) {
+#ifdef UPO_BST_USE_RECURSIVE_GET
     if(node != NULL) {
         int cmp = key_cmp(key, node->key);
         if(cmp > 0) return upo_bst_ceiling_impl(node->right, key, key_cmp);
@@ -309,6 +816,20 @@ const upo_bst_node_t *upo_bst_ceiling_impl(const upo_bst_node_t *node, const voi
         else return node;
     }
     return NULL;
+#else
+    const upo_bst_node_t *ceiling_node = NULL;
+    while(node != NULL) {
+        int cmp = key_cmp(key, node->key);
+        if(cmp > 0) node = node->right;
+        else if(cmp < 0) {
+            /* The ceiling is this node, unless a smaller one is on the left */
+            ceiling_node = node;
+            node = node->left;
+        }
+        else return node;
+    }
+    return ceiling_node;
+#endif /* UPO_BST_USE_RECURSIVE_GET */
 }
 
 void* upo_bst_ceiling(const upo_bst_t tree, const void *key)
@@ -321,54 +842,293 @@ void* upo_bst_ceiling(const upo_bst_t tree, const void *key)
     return NULL;
 }
 
-void upo_bst_keys_range_impl(const upo_bst_node_t *node, const void *low_key, const void *high_key, upo_bst_comparator_t key_cmp, upo_bst_key_list_t *list) {
-    if(node != NULL) {
-        upo_bst_keys_range_impl(node->left, low_key, high_key, key_cmp, list);
-        upo_bst_key_list_node_t *list_node = NULL;
-        list_node = malloc(sizeof(struct upo_bst_key_list_node_s));
-        if(list_node == NULL) {
-            perror("Unable to allocate node.\n");
-            abort();
-        }
-        if((key_cmp(node->key, low_key) >= 0) && (key_cmp(node->key, high_key) <= 0)) {
-            list_node->key = node->key;
-            list_node->next = *list;
-            *list = list_node;
-        }
-        upo_bst_keys_range_impl(node->right, low_key, high_key, key_cmp, list);
+upo_bst_key_list_t upo_bst_keys_range(const upo_bst_t tree, const void *low_key, const void *high_key)
+{
+    upo_bst_iter_t it;
+
+    if (tree == NULL)
+    {
+        return NULL;
+    }
+
+    upo_bst_iter_seek(tree, &it, low_key);
+
+    return upo_bst_iter_collect(&it, high_key);
+}
+
+upo_bst_key_list_t upo_bst_keys(const upo_bst_t tree)
+{
+    upo_bst_iter_t it;
+
+    if (tree == NULL)
+    {
+        return NULL;
     }
+
+    upo_bst_iter_seek(tree, &it, NULL);
+
+    return upo_bst_iter_collect(&it, NULL);
 }
 
-upo_bst_key_list_t upo_bst_keys_range(const upo_bst_t tree, const void *low_key, const void *high_key)
+upo_bst_key_list_t upo_bst_iter_collect(upo_bst_iter_t *it, const void *high_key)
 {
-    if(tree == NULL) return NULL;
     upo_bst_key_list_t list = NULL;
-    upo_bst_keys_range_impl(tree->root, low_key, high_key, tree->key_cmp, &list);
+    upo_bst_key_list_t *tail = &list;
+    void *key = NULL;
+
+    while (upo_bst_iter_next(it, &key, NULL)
+           && (high_key == NULL || it->tree->key_cmp(key, high_key) <= 0))
+    {
+        upo_bst_key_list_node_t *list_node = malloc(sizeof(upo_bst_key_list_node_t));
+        if (list_node == NULL)
+        {
+            perror("Unable to allocate memory for the list of keys");
+            abort();
+        }
+        list_node->key = key;
+        list_node->next = NULL;
+        *tail = list_node;
+        tail = &list_node->next;
+    }
+    upo_bst_iter_destroy(it);
+
     return list;
 }
 
-void upo_bst_keys_impl(const upo_bst_node_t *node, upo_bst_comparator_t key_cmp, upo_bst_key_list_t *list) {
-    if(node != NULL) {
-        upo_bst_keys_impl(node->left, key_cmp, list);
-        upo_bst_key_list_node_t *list_node = NULL;
-        list_node = malloc(sizeof(struct upo_bst_key_list_node_s));
-        if(list_node == NULL) {
-            perror("Unable to allocate node.\n");
+const upo_bst_node_t* upo_bst_iter_at(const upo_bst_iter_t *it, size_t depth)
+{
+    return (depth < UPO_BST_ITER_INLINE_DEPTH)
+           ? it->path[depth]
+           : it->deep_path[depth - UPO_BST_ITER_INLINE_DEPTH];
+}
+
+const upo_bst_node_t* upo_bst_iter_node(const upo_bst_iter_t *it)
+{
+    return upo_bst_iter_at(it, it->depth - 1);
+}
+
+void upo_bst_iter_push(upo_bst_iter_t *it, const upo_bst_node_t *node)
+{
+    size_t deep_depth = 0;
+
+    if (it->depth < UPO_BST_ITER_INLINE_DEPTH)
+    {
+        it->path[it->depth] = node;
+        it->depth += 1;
+        return;
+    }
+
+    deep_depth = it->depth - UPO_BST_ITER_INLINE_DEPTH;
+    if (deep_depth == it->deep_capacity)
+    {
+        size_t capacity = (it->deep_capacity > 0) ? 2*it->deep_capacity : UPO_BST_ITER_INLINE_DEPTH;
+        const upo_bst_node_t **deep_path = realloc(it->deep_path, capacity*sizeof(const upo_bst_node_t*));
+        if (deep_path == NULL)
+        {
+            perror("Unable to allocate memory for the path of the iterator");
             abort();
         }
-        list_node->key = node->key;
-        list_node->next = *list;
-        *list = list_node;
-        upo_bst_keys_impl(node->right, key_cmp, list);
+        it->deep_path = deep_path;
+        it->deep_capacity = capacity;
     }
+    it->deep_path[deep_depth] = node;
+    it->depth += 1;
 }
 
-upo_bst_key_list_t upo_bst_keys(const upo_bst_t tree)
+void upo_bst_iter_push_extreme(upo_bst_iter_t *it, const upo_bst_node_t *node, int leftmost)
 {
-    if(tree == NULL) return NULL;
-    upo_bst_key_list_t list = NULL;
-    upo_bst_keys_impl(tree->root, tree->key_cmp, &list);
-    return list;
+    while (node != NULL)
+    {
+        upo_bst_iter_push(it, node);
+        node = leftmost ? node->left : node->right;
+    }
+}
+
+int upo_bst_iter_find(upo_bst_iter_t *it, const void *key, int strict, int forward)
+{
+    const upo_bst_node_t *node = it->tree->root;
+    const upo_bst_node_t *found = NULL;
+    size_t found_depth = 0;
+
+    it->depth = 0;
+    while (node != NULL)
+    {
+        int cmp = it->tree->key_cmp(key, node->key);
+
+        upo_bst_iter_push(it, node);
+        if (cmp == 0 && !strict)
+        {
+            found = node;
+            found_depth = it->depth;
+            break;
+        }
+        if (forward ? cmp < 0 : cmp > 0)
+        {
+            /* The best candidate so far: look for a closer one */
+            found = node;
+            found_depth = it->depth;
+            node = forward ? node->left : node->right;
+        }
+        else
+        {
+            node = forward ? node->right : node->left;
+        }
+    }
+
+    if (found == NULL)
+    {
+        return 0;
+    }
+    it->depth = found_depth;
+
+    return 1;
+}
+
+int upo_bst_iter_step(upo_bst_iter_t *it, int forward)
+{
+    const upo_bst_node_t *node = upo_bst_iter_node(it);
+    const upo_bst_node_t *child = node;
+    size_t d = it->depth - 1;
+
+    /* The successor is the leftmost node of the right subtree, if any
+     * (and the predecessor the rightmost node of the left subtree) */
+    if ((forward ? node->right : node->left) != NULL)
+    {
+        upo_bst_iter_push_extreme(it, forward ? node->right : node->left, forward);
+        return 1;
+    }
+
+    /* Otherwise, it is the first ancestor reached from its left subtree
+     * (from its right subtree for the predecessor) */
+    while (d > 0)
+    {
+        const upo_bst_node_t *parent = upo_bst_iter_at(it, d - 1);
+
+        if ((forward ? parent->left : parent->right) == child)
+        {
+            it->depth = d;
+            return 1;
+        }
+        child = parent;
+        --d;
+    }
+
+    return 0;
+}
+
+void upo_bst_iter_seek(const upo_bst_t tree, upo_bst_iter_t *it, const void *key)
+{
+    /* preconditions */
+    assert( it != NULL );
+
+    it->tree = tree;
+    it->deep_path = NULL;
+    it->deep_capacity = 0;
+    it->depth = 0;
+    it->after = 0;
+
+    if (tree == NULL || tree->root == NULL)
+    {
+        return;
+    }
+
+    if (key == NULL)
+    {
+        upo_bst_iter_push_extreme(it, tree->root, 1);
+    }
+    else if (!upo_bst_iter_find(it, key, 0, 1))
+    {
+        /* All keys are less than the given one */
+        it->depth = 0;
+        upo_bst_iter_push_extreme(it, tree->root, 0);
+        it->after = 1;
+    }
+}
+
+void upo_bst_iter_destroy(upo_bst_iter_t *it)
+{
+    /* preconditions */
+    assert( it != NULL );
+
+    free(it->deep_path);
+    it->deep_path = NULL;
+    it->deep_capacity = 0;
+    it->depth = 0;
+    it->after = 0;
+}
+
+int upo_bst_iter_next(upo_bst_iter_t *it, void **key, void **value)
+{
+    const upo_bst_node_t *node = NULL;
+
+    /* preconditions */
+    assert( it != NULL );
+
+    if (it->depth == 0)
+    {
+        return 0;
+    }
+
+    if (it->after)
+    {
+        if (!upo_bst_iter_step(it, 1))
+        {
+            return 0;
+        }
+    }
+    else
+    {
+        it->after = 1;
+    }
+
+    node = upo_bst_iter_node(it);
+    if (key != NULL)
+    {
+        *key = node->key;
+    }
+    if (value != NULL)
+    {
+        *value = node->value;
+    }
+
+    return 1;
+}
+
+int upo_bst_iter_prev(upo_bst_iter_t *it, void **key, void **value)
+{
+    const upo_bst_node_t *node = NULL;
+
+    /* preconditions */
+    assert( it != NULL );
+
+    if (it->depth == 0)
+    {
+        return 0;
+    }
+
+    if (!it->after)
+    {
+        if (!upo_bst_iter_step(it, 0))
+        {
+            return 0;
+        }
+    }
+    else
+    {
+        it->after = 0;
+    }
+
+    node = upo_bst_iter_node(it);
+    if (key != NULL)
+    {
+        *key = node->key;
+    }
+    if (value != NULL)
+    {
+        *value = node->value;
+    }
+
+    return 1;
 }
 
 int upo_bst_is_bst_impl(const upo_bst_node_t *node, const void *min_key, int min_key_changed, const void *max_key, int max_key_changed, upo_bst_comparator_t key_cmp) {
@@ -396,8 +1156,10 @@ int upo_bst_is_bst(const upo_bst_t tree, const void *min_key, const void *max_ke
 
 size_t upo_bst_rank_impl(upo_bst_node_t *node, const void *key, upo_bst_comparator_t cmp) {
     if(node == NULL) return 0;
-    if(cmp(key, node->key) <= 0) return upo_bst_rank_impl(node->left, key, cmp);
-    else return 1 + upo_bst_rank_impl(node->left, key, cmp) + upo_bst_rank_impl(node->right, key, cmp);
+    int c = cmp(key, node->key);
+    if(c < 0) return upo_bst_rank_impl(node->left, key, cmp);
+    else if(c > 0) return 1 + upo_bst_size_impl(node->left) + upo_bst_rank_impl(node->right, key, cmp);
+    else return upo_bst_size_impl(node->left);
 }
 
 size_t upo_bst_rank(const upo_bst_t bst, const void *key) {
@@ -405,6 +1167,19 @@ size_t upo_bst_rank(const upo_bst_t bst, const void *key) {
     return upo_bst_rank_impl(bst->root, key, bst->key_cmp);
 }
 
+upo_bst_node_t* upo_bst_select_impl(upo_bst_node_t *node, size_t k) {
+    if(node == NULL) return NULL;
+    size_t left_size = upo_bst_size_impl(node->left);
+    if(k < left_size) return upo_bst_select_impl(node->left, k);
+    else if(k > left_size) return upo_bst_select_impl(node->right, k - left_size - 1);
+    else return node;
+}
+
+void *upo_bst_select(const upo_bst_t bst, size_t k) {
+    if(bst == NULL || k >= upo_bst_size(bst)) return NULL;
+    return upo_bst_select_impl(bst->root, k)->key;
+}
+
 void *upo_bst_predecessor_impl(upo_bst_node_t *node, const void *key, upo_bst_comparator_t cmp) {
     if(node == NULL) return NULL;
     if(cmp(key, node->key) <= 0) return upo_bst_predecessor_impl(node->left, key, cmp);
@@ -441,27 +1216,11 @@ void *upo_bst_get_value_depth(const upo_bst_t bst, const void *key, long *depth)
     return upo_bst_get_value_depth_impl(bst->root, key, depth, bst->key_cmp);
 }
 
-void upo_bst_keys_le_impl(upo_bst_node_t *node, const void *key, upo_bst_comparator_t cmp, upo_bst_key_list_t *list) {
-    if(node == NULL) return;
-    if(cmp(node->key, key) <= 0) {
-        upo_bst_key_list_node_t *list_node = malloc(sizeof(upo_bst_key_list_node_t));
-        if(list_node == NULL) {
-            perror("Malloc failed.");
-            abort();
-        }
-        list_node->key = node->key;
-        list_node->next = *list;
-        *list = list_node;
-        upo_bst_keys_le_impl(node->right, key, cmp, list);
-    }
-    upo_bst_keys_le_impl(node->left, key, cmp, list);
-}
-
 upo_bst_key_list_t upo_bst_keys_le(const upo_bst_t bst, const void *key) {
     if(bst == NULL || upo_bst_is_empty(bst)) return NULL;
-    upo_bst_key_list_t list = NULL;
-    upo_bst_keys_le_impl(bst->root, key, bst->key_cmp, &list);
-    return list;
+    upo_bst_iter_t it;
+    upo_bst_iter_seek(bst, &it, NULL);
+    return upo_bst_iter_collect(&it, key);
 }
 
 size_t upo_bst_subtree_count_leaves_depth_impl(upo_bst_node_t *node, const void *key, size_t leaves_depth, size_t current_depth, int subtree_found, upo_bst_comparator_t cmp) {
@@ -32,6 +32,13 @@
 #include <upo/bst.h>
 
 
+/**
+ * \brief The number of nodes on the path from the root that iterative puts
+ *  remember, to update subtree sizes without walking the tree again.
+ */
+#define UPO_BST_PUT_PATH_DEPTH 64U
+
+
 /** \brief Alias for binary search tree node type. */
 typedef struct upo_bst_node_s upo_bst_node_t;
 
@@ -42,6 +49,7 @@ struct upo_bst_node_s
     void *value; /**< Pointer to user-provided value. */
     upo_bst_node_t *left; /**< Pointer to the left child node. */
     upo_bst_node_t *right; /**< Pointer to the right child node. */
+    size_t size; /**< The number of nodes of the subtree rooted at this node. */
 };
 
 /** \brief Defines a binary tree. */
@@ -49,6 +57,9 @@ struct upo_bst_s
 {
     upo_bst_node_t *root; /**< The root of the binary tree. */
     upo_bst_comparator_t key_cmp; /**< Pointer to the key comparison function. */
+    upo_pool_t node_pool; /**< The pool nodes are allocated from, or `NULL` to use `malloc()`. */
+    double alpha; /**< The weight-balance factor of scapegoat trees, or `1` for plain trees. */
+    size_t max_size; /**< The largest number of nodes since the whole tree was last rebuilt. */
 };
 
 
@@ -62,28 +73,139 @@ struct upo_bst_s
  * Memory deallocation (if requested) is performed by means of the `free()`
  * standard C function.
  */
-static void upo_bst_clear_impl(upo_bst_node_t*, int destroy_data);
+static void upo_bst_clear_impl(upo_bst_node_t*, int destroy_data, upo_pool_t pool);
+
+/**
+ * \brief Creates a node holding the given key-value pair.
+ *
+ * \param key The key.
+ * \param value The value.
+ * \param pool The pool the node is allocated from, or `NULL` to use
+ *  `malloc()`.
+ */
+static upo_bst_node_t* upo_bst_node_create(void *key, void *value, upo_pool_t pool);
+
+/** \brief Frees the given node (but not its key and value) to the given pool, or with `free()` if the pool is `NULL`. */
+static void upo_bst_node_destroy(upo_bst_node_t *node, upo_pool_t pool);
+
+#ifdef UPO_BST_USE_RECURSIVE_PUT
 
-static upo_bst_node_t* upo_bst_node_create(void *key, void *value);
+static upo_bst_node_t* upo_bst_put_impl(upo_bst_node_t *node, void *key, void *value, void **old_value, upo_bst_comparator_t key_cmp, upo_pool_t pool);
 
-static upo_bst_node_t* upo_bst_put_impl(upo_bst_node_t *node, void *key, void *value, void *old_value, upo_bst_comparator_t key_cmp);
+static upo_bst_node_t* upo_bst_insert_impl(upo_bst_node_t *node, void *key, void *value, upo_bst_comparator_t key_cmp, upo_pool_t pool);
 
-static upo_bst_node_t* upo_bst_insert_impl(upo_bst_node_t *node, void *key, void *value, upo_bst_comparator_t key_cmp);
+#else
+
+/**
+ * \brief Adds the given key-value pair to the given tree, or (if \a replace
+ *  is not zero) replaces the value of the given key if it is already there.
+ *
+ * \return The previous value of the key, or `NULL` if the key was not in the
+ *  tree.
+ *
+ * The depth of the new node (if any) is stored in \a depth.
+ * The tree is walked down with a loop, remembering the first
+ * #UPO_BST_PUT_PATH_DEPTH nodes of the path; only if a node is added, the
+ * subtree sizes of its ancestors are then updated, from the remembered path
+ * or (for deeper nodes) by walking the tree again.
+ */
+static void* upo_bst_put_iterative_impl(upo_bst_t tree, void *key, void *value, int replace, size_t *depth);
+
+#endif /* UPO_BST_USE_RECURSIVE_PUT */
+
+#if !defined(UPO_BST_USE_RECURSIVE_PUT) || !defined(UPO_BST_USE_RECURSIVE_DELETE)
+
+/**
+ * \brief Increments (if \a grow is not zero) or decrements the subtree size
+ *  of the nodes on the path from the given node to the given key, excluding
+ *  the node holding the key.
+ */
+static void upo_bst_path_resize_impl(upo_bst_node_t *node, const void *key, upo_bst_comparator_t key_cmp, int grow);
+
+#endif
 
 static upo_bst_node_t* upo_bst_get_impl(upo_bst_node_t *node, const void *key, upo_bst_comparator_t key_cmp);
 
-static upo_bst_node_t* upo_bst_delete_1C_impl(upo_bst_node_t *node, int destroy_data);
+#ifdef UPO_BST_USE_RECURSIVE_DELETE
+
+static upo_bst_node_t* upo_bst_delete_1C_impl(upo_bst_node_t *node, int destroy_data, upo_pool_t pool);
+
+static upo_bst_node_t* upo_bst_delete_2C_impl(upo_bst_node_t *node, int destroy_data, upo_bst_comparator_t key_cmp, upo_pool_t pool);
+
+static upo_bst_node_t* upo_bst_delete_impl(upo_bst_node_t *node, const void *key, int destroy_data, upo_bst_comparator_t key_cmp, upo_pool_t pool);
 
-static upo_bst_node_t* upo_bst_delete_2C_impl(upo_bst_node_t *node, int destroy_data, upo_bst_comparator_t key_cmp);
+#else
+
+/**
+ * \brief Removes the given key from the given tree, if it is there.
+ *
+ * The tree is walked down with a loop, and the subtree sizes of the nodes on
+ * the path are updated on the way.
+ */
+static void upo_bst_delete_iterative_impl(upo_bst_t tree, const void *key, int destroy_data);
 
-static upo_bst_node_t* upo_bst_delete_impl(upo_bst_node_t *node, const void *key, int destroy_data, upo_bst_comparator_t key_cmp);
+#endif /* UPO_BST_USE_RECURSIVE_DELETE */
 
 static size_t upo_bst_size_impl(upo_bst_node_t *node);
 
 static int upo_bst_is_leaf_impl(upo_bst_node_t *node);
 
+/**
+ * \brief Tells if the given depth exceeds the height bound `log_{1/alpha}(n)`
+ *  of scapegoat trees with \a n nodes.
+ */
+static int upo_bst_scapegoat_too_deep_impl(double alpha, size_t n, size_t depth);
+
+/**
+ * \brief Restores the height bound of a scapegoat tree after an insertion.
+ *
+ * \param tree The tree.
+ * \param key The inserted key.
+ * \param old_size The number of nodes before the insertion.
+ * \param depth The depth of the new node, or `SIZE_MAX` if it is not known.
+ *
+ * If the new node is too deep, its deepest ancestor whose subtree is not
+ * alpha-weight-balanced (the scapegoat) is found by walking down again from
+ * the root, and its subtree is rebuilt.
+ */
+static void upo_bst_scapegoat_insert_fix_impl(upo_bst_t tree, const void *key, size_t old_size, size_t depth);
+
+/**
+ * \brief Rebalances the given subtree in place.
+ *
+ * \return The new root of the subtree, which has the same size.
+ */
+static upo_bst_node_t* upo_bst_rebalance_impl(upo_bst_node_t *node);
+
+/**
+ * \brief Builds a balanced subtree holding the given key-value pairs.
+ *
+ * \param keys The array of keys, in strictly ascending order.
+ * \param values The array of values, or `NULL` if all values are `NULL`.
+ * \param lo The index of the first pair of the subtree.
+ * \param hi The index past the last pair of the subtree.
+ * \return The root of the subtree, or `NULL` if the range is empty.
+ */
+static upo_bst_node_t* upo_bst_build_impl(void *const *keys, void *const *values, size_t lo, size_t hi);
+
+/**
+ * \brief Turns the tree hanging as right child of the given pseudo-root into
+ *  a chain of right children, in ascending order of keys, by right rotations.
+ */
+static void upo_bst_tree_to_vine_impl(upo_bst_node_t *pseudo_root);
+
+/**
+ * \brief Performs the given number of left rotations on every other node of
+ *  the right spine hanging from the given pseudo-root.
+ */
+static void upo_bst_vine_compress_impl(upo_bst_node_t *pseudo_root, size_t count);
+
+#ifdef UPO_BST_USE_RECURSIVE_TRAVERSAL
+
 static size_t upo_bst_height_impl(upo_bst_node_t *node);
 
+#endif /* UPO_BST_USE_RECURSIVE_TRAVERSAL */
+
 static void* upo_bst_max_impl(upo_bst_node_t *node);
 
 static void* upo_bst_min_impl(upo_bst_node_t *node);
@@ -92,20 +214,68 @@ static const upo_bst_node_t *upo_bst_floor_impl(const upo_bst_node_t *node, cons
 
 static const upo_bst_node_t *upo_bst_ceiling_impl(const upo_bst_node_t *node, const void *key, upo_bst_comparator_t key_cmp);
 
-static void upo_bst_keys_range_impl(const upo_bst_node_t *node, const void *low_key, const void *high_key, upo_bst_comparator_t key_cmp, upo_bst_key_list_t *list);
+/** \brief Returns the node at the given depth (from `0`) of the path of the given iterator. */
+static const upo_bst_node_t* upo_bst_iter_at(const upo_bst_iter_t *it, size_t depth);
+
+/** \brief Returns the current node of the given (non-empty) iterator. */
+static const upo_bst_node_t* upo_bst_iter_node(const upo_bst_iter_t *it);
+
+/**
+ * \brief Pushes the given node on the path of the given iterator, making it
+ *  the current node.
+ *
+ * Beyond #UPO_BST_ITER_INLINE_DEPTH nodes, the path goes on the heap, whose
+ * part is doubled when full.
+ */
+static void upo_bst_iter_push(upo_bst_iter_t *it, const upo_bst_node_t *node);
+
+/**
+ * \brief Pushes the given node and then its leftmost (if \a leftmost is not
+ *  zero) or rightmost descendants on the path of the given iterator.
+ */
+static void upo_bst_iter_push_extreme(upo_bst_iter_t *it, const upo_bst_node_t *node, int leftmost);
+
+/**
+ * \brief Makes current the node of the smallest key greater than (if
+ *  \a forward is not zero) or the largest key less than the given key, or
+ *  equal to it when \a strict is zero.
+ *
+ * \param it The iterator.
+ * \param key The key.
+ * \param strict Tells whether a node with the given key is excluded.
+ * \param forward Tells the direction of the search.
+ * \return `1` if such a node exists, or `0` otherwise (in which case the path
+ *  of the iterator is invalid).
+ */
+static int upo_bst_iter_find(upo_bst_iter_t *it, const void *key, int strict, int forward);
+
+/**
+ * \brief Makes current the successor (if \a forward is not zero) or the
+ *  predecessor of the current node of the given (non-empty) iterator.
+ *
+ * \return `1` if the iterator has moved, or `0` if there is no such node.
+ */
+static int upo_bst_iter_step(upo_bst_iter_t *it, int forward);
 
-static void upo_bst_keys_impl(const upo_bst_node_t *node, upo_bst_comparator_t key_cmp, upo_bst_key_list_t *list);
+/**
+ * \brief Collects the keys from the position of the given iterator up to the
+ *  given key (included), or up to the largest key if it is `NULL`, and
+ *  releases the iterator.
+ *
+ * \return A singly-linked list of keys in ascending order.
+ */
+static upo_bst_key_list_t upo_bst_iter_collect(upo_bst_iter_t *it, const void *high_key);
 
 static int upo_bst_is_bst_impl(const upo_bst_node_t *node, const void *min_key, int min_key_changed, const void *max_key, int max_key_changed, upo_bst_comparator_t key_cmp);
 
 static size_t upo_bst_rank_impl(upo_bst_node_t *node, const void *key, upo_bst_comparator_t cmp);
 
+static upo_bst_node_t* upo_bst_select_impl(upo_bst_node_t *node, size_t k);
+
 static void *upo_bst_predecessor_impl(upo_bst_node_t *node, const void *key, upo_bst_comparator_t cmp);
 
 static void *upo_bst_get_value_depth_impl(upo_bst_node_t *node, const void *key, long *depth, upo_bst_comparator_t cmp);
 
-static void upo_bst_keys_le_impl(upo_bst_node_t *node, const void *key, upo_bst_comparator_t cmp, upo_bst_key_list_t *list);
-
 static size_t upo_bst_subtree_count_leaves_depth_impl(upo_bst_node_t *node, const void *key, size_t leaves_depth, size_t current_depth, int subtree_found, upo_bst_comparator_t cmp);
 
 #endif /* UPO_BST_PRIVATE_H */
@@ -0,0 +1,350 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include "filter_private.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/hashtable.h>
+
+
+/*** BEGIN of COMMON FUNCTIONS ***/
+
+
+void upo_filter_dimension(size_t n, double fpr, size_t cells_per_block, size_t *num_blocks, size_t *num_hashes)
+{
+    /* Start from the optimal values for a (non-blocked) Bloom filter:
+     * -ln(p)/ln(2)^2 cells per key and ln(2) hash functions per cell per key */
+    double ln2 = log(2.0);
+    double cells_per_key = -log(fpr) / (ln2*ln2);
+    size_t k = 0;
+    size_t iter = 0;
+
+    /* Keys are not spread evenly among blocks, and overloaded blocks give
+     * most false positives, so cells are added until the rate of the blocked
+     * filter meets the wanted one */
+    for (;;)
+    {
+        double k_opt = round(cells_per_key * ln2);
+
+        k = (k_opt < 1) ? 1 : (k_opt > UPO_FILTER_MAX_HASHES) ? UPO_FILTER_MAX_HASHES : (size_t) k_opt;
+        if (upo_filter_blocked_fpr(cells_per_block / cells_per_key, cells_per_block, k) <= fpr || ++iter == 100)
+        {
+            break;
+        }
+        cells_per_key *= 1.05;
+    }
+
+    *num_blocks = (size_t) ceil((n > 0 ? n : 1) * cells_per_key / cells_per_block);
+    *num_hashes = k;
+
+    /* The block is selected by the upper half of a 64-bit hash value */
+    assert( *num_blocks <= UINT32_MAX );
+}
+
+double upo_filter_blocked_fpr(double keys_per_block, size_t cells_per_block, size_t num_hashes)
+{
+    double sd = sqrt(keys_per_block);
+    double lo = floor(keys_per_block - 10*sd - 10);
+    double hi = ceil(keys_per_block + 10*sd + 10);
+    double fpr = 0;
+    double i;
+
+    /* The number of keys in a block is a Poisson variable; the probability
+     * is computed in logarithmic space, since exp(-keys_per_block) may
+     * underflow */
+    for (i = (lo > 0) ? lo : 0; i <= hi; ++i)
+    {
+        double p = exp(-keys_per_block + i*log(keys_per_block) - lgamma(i + 1));
+        double cell_set = 1 - pow(1 - 1.0/cells_per_block, num_hashes*i);
+
+        fpr += p * pow(cell_set, num_hashes);
+    }
+
+    return fpr;
+}
+
+upo_filter_block_t* upo_filter_create_blocks(size_t num_blocks)
+{
+    upo_filter_block_t *blocks = NULL;
+
+    blocks = aligned_alloc(UPO_FILTER_BLOCK_SIZE, num_blocks*sizeof(upo_filter_block_t));
+    if (blocks == NULL)
+    {
+        perror("Unable to allocate memory for blocks of the filter");
+        abort();
+    }
+    memset(blocks, 0, num_blocks*sizeof(upo_filter_block_t));
+
+    return blocks;
+}
+
+upo_filter_probe_t upo_filter_probe(uint64_t hash, size_t num_blocks)
+{
+    upo_filter_probe_t probe;
+    uint64_t h = upo_ht_hash_mix64(hash);
+
+    /* Maps the upper half to [0, num_blocks) with a multiplication, which is
+     * cheaper than a modulo and does not require a power of two */
+    probe.block = (size_t) (((h >> 32) * num_blocks) >> 32);
+    probe.cells = h;
+
+    return probe;
+}
+
+
+/*** END of COMMON FUNCTIONS ***/
+
+
+/*** BEGIN of BLOCKED BLOOM FILTER ***/
+
+
+upo_bloom_t upo_bloom_create(size_t n, double fpr)
+{
+    upo_bloom_t filter = NULL;
+
+    /* preconditions */
+    assert( fpr > 0 && fpr < 1 );
+
+    filter = malloc(sizeof(struct upo_bloom_s));
+    if (filter == NULL)
+    {
+        perror("Unable to allocate memory for Blocked Bloom Filter");
+        abort();
+    }
+
+    upo_filter_dimension(n, fpr, UPO_BLOOM_BLOCK_BITS, &filter->num_blocks, &filter->num_hashes);
+    filter->blocks = upo_filter_create_blocks(filter->num_blocks);
+
+    return filter;
+}
+
+void upo_bloom_destroy(upo_bloom_t filter)
+{
+    if (filter != NULL)
+    {
+        free(filter->blocks);
+        free(filter);
+    }
+}
+
+void upo_bloom_clear(upo_bloom_t filter)
+{
+    if (filter != NULL)
+    {
+        memset(filter->blocks, 0, filter->num_blocks*sizeof(upo_filter_block_t));
+    }
+}
+
+void upo_bloom_add(upo_bloom_t filter, uint64_t hash)
+{
+    if (filter != NULL)
+    {
+        upo_filter_probe_t probe = upo_filter_probe(hash, filter->num_blocks);
+        upo_filter_block_t *block = &filter->blocks[probe.block];
+        size_t i;
+
+        for (i = 0; i < filter->num_hashes; ++i)
+        {
+            size_t bit = 0;
+
+            probe.cells *= UPO_FILTER_CELL_MULTIPLIER;
+            bit = (size_t) (probe.cells >> (64 - UPO_BLOOM_BLOCK_BITS_LOG2));
+
+            block->words[bit / 64] |= UINT64_C(1) << (bit % 64);
+        }
+    }
+}
+
+int upo_bloom_may_contain(const upo_bloom_t filter, uint64_t hash)
+{
+    if (filter != NULL)
+    {
+        upo_filter_probe_t probe = upo_filter_probe(hash, filter->num_blocks);
+        const upo_filter_block_t *block = &filter->blocks[probe.block];
+        size_t i;
+
+        for (i = 0; i < filter->num_hashes; ++i)
+        {
+            size_t bit = 0;
+
+            probe.cells *= UPO_FILTER_CELL_MULTIPLIER;
+            bit = (size_t) (probe.cells >> (64 - UPO_BLOOM_BLOCK_BITS_LOG2));
+
+            if ((block->words[bit / 64] & (UINT64_C(1) << (bit % 64))) == 0)
+            {
+                return 0;
+            }
+        }
+        return 1;
+    }
+
+    return 0;
+}
+
+size_t upo_bloom_num_hashes(const upo_bloom_t filter)
+{
+    return (filter != NULL) ? filter->num_hashes : 0;
+}
+
+size_t upo_bloom_memory_usage(const upo_bloom_t filter)
+{
+    return (filter != NULL) ? filter->num_blocks*sizeof(upo_filter_block_t) : 0;
+}
+
+
+/*** END of BLOCKED BLOOM FILTER ***/
+
+
+/*** BEGIN of COUNTING BLOCKED BLOOM FILTER ***/
+
+
+upo_cbloom_t upo_cbloom_create(size_t n, double fpr)
+{
+    upo_cbloom_t filter = NULL;
+
+    /* preconditions */
+    assert( fpr > 0 && fpr < 1 );
+
+    filter = malloc(sizeof(struct upo_cbloom_s));
+    if (filter == NULL)
+    {
+        perror("Unable to allocate memory for Counting Blocked Bloom Filter");
+        abort();
+    }
+
+    upo_filter_dimension(n, fpr, UPO_CBLOOM_BLOCK_COUNTERS, &filter->num_blocks, &filter->num_hashes);
+    filter->blocks = upo_filter_create_blocks(filter->num_blocks);
+
+    return filter;
+}
+
+void upo_cbloom_destroy(upo_cbloom_t filter)
+{
+    if (filter != NULL)
+    {
+        free(filter->blocks);
+        free(filter);
+    }
+}
+
+void upo_cbloom_clear(upo_cbloom_t filter)
+{
+    if (filter != NULL)
+    {
+        memset(filter->blocks, 0, filter->num_blocks*sizeof(upo_filter_block_t));
+    }
+}
+
+void upo_cbloom_add(upo_cbloom_t filter, uint64_t hash)
+{
+    if (filter != NULL)
+    {
+        upo_filter_probe_t probe = upo_filter_probe(hash, filter->num_blocks);
+        upo_filter_block_t *block = &filter->blocks[probe.block];
+        size_t i;
+
+        for (i = 0; i < filter->num_hashes; ++i)
+        {
+            size_t c = 0;
+            unsigned int shift = 0;
+            uint64_t count = 0;
+
+            probe.cells *= UPO_FILTER_CELL_MULTIPLIER;
+            c = (size_t) (probe.cells >> (64 - UPO_CBLOOM_BLOCK_COUNTERS_LOG2));
+            shift = 4*(c % 16);
+            count = (block->words[c / 16] >> shift) & 0xF;
+
+            /* A saturated counter no longer tells how many keys it counts */
+            if (count < UPO_CBLOOM_MAX_COUNT)
+            {
+                block->words[c / 16] += UINT64_C(1) << shift;
+            }
+        }
+    }
+}
+
+void upo_cbloom_remove(upo_cbloom_t filter, uint64_t hash)
+{
+    if (filter != NULL)
+    {
+        upo_filter_probe_t probe = upo_filter_probe(hash, filter->num_blocks);
+        upo_filter_block_t *block = &filter->blocks[probe.block];
+        size_t i;
+
+        for (i = 0; i < filter->num_hashes; ++i)
+        {
+            size_t c = 0;
+            unsigned int shift = 0;
+            uint64_t count = 0;
+
+            probe.cells *= UPO_FILTER_CELL_MULTIPLIER;
+            c = (size_t) (probe.cells >> (64 - UPO_CBLOOM_BLOCK_COUNTERS_LOG2));
+            shift = 4*(c % 16);
+            count = (block->words[c / 16] >> shift) & 0xF;
+
+            if (count > 0 && count < UPO_CBLOOM_MAX_COUNT)
+            {
+                block->words[c / 16] -= UINT64_C(1) << shift;
+            }
+        }
+    }
+}
+
+int upo_cbloom_may_contain(const upo_cbloom_t filter, uint64_t hash)
+{
+    if (filter != NULL)
+    {
+        upo_filter_probe_t probe = upo_filter_probe(hash, filter->num_blocks);
+        const upo_filter_block_t *block = &filter->blocks[probe.block];
+        size_t i;
+
+        for (i = 0; i < filter->num_hashes; ++i)
+        {
+            size_t c = 0;
+
+            probe.cells *= UPO_FILTER_CELL_MULTIPLIER;
+            c = (size_t) (probe.cells >> (64 - UPO_CBLOOM_BLOCK_COUNTERS_LOG2));
+            if (((block->words[c / 16] >> (4*(c % 16))) & 0xF) == 0)
+            {
+                return 0;
+            }
+        }
+        return 1;
+    }
+
+    return 0;
+}
+
+size_t upo_cbloom_num_hashes(const upo_cbloom_t filter)
+{
+    return (filter != NULL) ? filter->num_hashes : 0;
+}
+
+size_t upo_cbloom_memory_usage(const upo_cbloom_t filter)
+{
+    return (filter != NULL) ? filter->num_blocks*sizeof(upo_filter_block_t) : 0;
+}
+
+
+/*** END of COUNTING BLOCKED BLOOM FILTER ***/
@@ -0,0 +1,142 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file filter_private.h
+ *
+ * \brief Private header for approximate membership filters.
+ *
+ * The hash value given for a key is remixed into a 64-bit word whose upper
+ * half selects the block; the cells of the key inside the block are given by
+ * the most significant bits of the products of that word by increasing powers
+ * of an odd constant.
+ * Double hashing (i.e., cells `h1 + i*h2`) is avoided since, modulo the few
+ * cells of a block, it yields about twice as many false positives.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_FILTER_PRIVATE_H
+#define UPO_FILTER_PRIVATE_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include <upo/filter.h>
+
+
+/** \brief The number of 64-bit words of a block. */
+#define UPO_FILTER_BLOCK_WORDS (UPO_FILTER_BLOCK_SIZE/sizeof(uint64_t))
+
+/** \brief The base 2 logarithm of the number of bits of a block. */
+#define UPO_BLOOM_BLOCK_BITS_LOG2 9U
+
+/** \brief The number of bits of a block (i.e., `8*UPO_FILTER_BLOCK_SIZE`). */
+#define UPO_BLOOM_BLOCK_BITS (1U << UPO_BLOOM_BLOCK_BITS_LOG2)
+
+/** \brief The base 2 logarithm of the number of 4-bit counters of a block. */
+#define UPO_CBLOOM_BLOCK_COUNTERS_LOG2 7U
+
+/** \brief The number of 4-bit counters of a block (i.e., `2*UPO_FILTER_BLOCK_SIZE`). */
+#define UPO_CBLOOM_BLOCK_COUNTERS (1U << UPO_CBLOOM_BLOCK_COUNTERS_LOG2)
+
+/** \brief The odd constant whose powers give the cells of a key (2^64 divided by the golden ratio). */
+#define UPO_FILTER_CELL_MULTIPLIER UINT64_C(0x9E3779B97F4A7C15)
+
+/** \brief The maximum number of hash functions of filters. */
+#define UPO_FILTER_MAX_HASHES 16U
+
+
+/** \brief Type for blocks of filters, aligned to a cache line. */
+struct upo_filter_block_s
+{
+    uint64_t words[UPO_FILTER_BLOCK_WORDS]; /**< The bits (or the counters) of the block. */
+};
+
+/** \brief Alias for the type for blocks of filters. */
+typedef struct upo_filter_block_s upo_filter_block_t;
+
+/** \brief Type for the cells selected by a key. */
+struct upo_filter_probe_s
+{
+    size_t block; /**< The index of the block. */
+    uint64_t cells; /**< The word whose products by #UPO_FILTER_CELL_MULTIPLIER give the cells. */
+};
+
+/** \brief Alias for the type for the cells selected by a key. */
+typedef struct upo_filter_probe_s upo_filter_probe_t;
+
+/** \brief Defines a blocked Bloom filter. */
+struct upo_bloom_s
+{
+    upo_filter_block_t *blocks; /**< The blocks of bits. */
+    size_t num_blocks; /**< The number of blocks. */
+    size_t num_hashes; /**< The number of bits set by each key. */
+};
+
+/** \brief Defines a counting blocked Bloom filter. */
+struct upo_cbloom_s
+{
+    upo_filter_block_t *blocks; /**< The blocks of 4-bit counters. */
+    size_t num_blocks; /**< The number of blocks. */
+    size_t num_hashes; /**< The number of counters updated by each key. */
+};
+
+
+/**
+ * \brief Computes the number of blocks and of hash functions of a filter.
+ *
+ * \param n The expected number of keys.
+ * \param fpr The wanted false positive rate.
+ * \param cells_per_block The number of cells of a block.
+ * \param num_blocks Where the number of blocks is stored.
+ * \param num_hashes Where the number of hash functions is stored.
+ */
+static void upo_filter_dimension(size_t n, double fpr, size_t cells_per_block, size_t *num_blocks, size_t *num_hashes);
+
+/**
+ * \brief Returns the false positive rate of a blocked filter.
+ *
+ * \param keys_per_block The mean number of keys per block.
+ * \param cells_per_block The number of cells of a block.
+ * \param num_hashes The number of hash functions.
+ * \return The probability that a missing key passes the filter.
+ */
+static double upo_filter_blocked_fpr(double keys_per_block, size_t cells_per_block, size_t num_hashes);
+
+/**
+ * \brief Allocates the given number of zeroed blocks, aligned to a cache
+ *  line.
+ *
+ * \param num_blocks The number of blocks.
+ * \return The blocks.
+ */
+static upo_filter_block_t* upo_filter_create_blocks(size_t num_blocks);
+
+/**
+ * \brief Computes the cells selected by the key with the given hash value.
+ *
+ * \param hash The full hash value of the key.
+ * \param num_blocks The number of blocks of the filter.
+ * \return The block and the word giving the cells of the key.
+ */
+static upo_filter_probe_t upo_filter_probe(uint64_t hash, size_t num_blocks);
+
+
+#endif /* UPO_FILTER_PRIVATE_H */
@@ -25,6 +25,8 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <upo/error.h>
 #include <upo/utility.h>
 
@@ -75,6 +77,9 @@ upo_ht_sepchain_t upo_ht_sepchain_create(size_t m, upo_ht_hasher_t key_hash, upo
     ht->size = 0;
     ht->key_hash = key_hash;
     ht->key_cmp = key_cmp;
+    ht->node_pool = upo_pool_create(sizeof(upo_ht_sepchain_list_node_t), UPO_POOL_DEFAULT_CHUNK_CAPACITY);
+    ht->filter = NULL;
+    upo_ht_sepchain_reset_stats(ht);
 
     return ht;
 }
@@ -84,6 +89,8 @@ void upo_ht_sepchain_destroy(upo_ht_sepchain_t ht, int destroy_data)
     if (ht != NULL)
     {
         upo_ht_sepchain_clear(ht, destroy_data);
+        upo_cbloom_destroy(ht->filter);
+        upo_pool_destroy(ht->node_pool);
         free(ht->slots);
         free(ht);
     }
@@ -95,28 +102,25 @@ void upo_ht_sepchain_clear(upo_ht_sepchain_t ht, int destroy_data)
     {
         size_t i = 0;
 
-        /* For each slot, clear the associated list of collisions */
+        /* For each slot, clear the associated list of collisions.
+         * Nodes are only visited when the data they point to must be freed,
+         * since nodes themselves are released all at once by the pool. */
         for (i = 0; i < ht->capacity; ++i)
         {
-            upo_ht_sepchain_list_node_t *list = NULL;
-
-            list = ht->slots[i].head;
-            while (list != NULL)
+            if (destroy_data)
             {
-                upo_ht_sepchain_list_node_t *node = list;
+                upo_ht_sepchain_list_node_t *node = NULL;
 
-                list = list->next;
-
-                if (destroy_data)
+                for (node = ht->slots[i].head; node != NULL; node = node->next)
                 {
                     free(node->key);
                     free(node->value);
                 }
-
-                free(node);
             }
             ht->slots[i].head = NULL;
         }
+        upo_pool_clear(ht->node_pool);
+        upo_cbloom_clear(ht->filter);
         ht->size = 0;
     }
 }
@@ -127,18 +131,26 @@ void* upo_ht_sepchain_put(upo_ht_sepchain_t ht, void *key, void *value)
 
     void *old_value = NULL;
     upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    uint64_t hash = hasher(key);
+    size_t idx = upo_ht_hash_to_index(hash, ht->capacity);
     upo_ht_sepchain_list_node_t *node = NULL;
-    node = ht->slots[hash].head;
+    node = ht->slots[idx].head;
     upo_ht_comparator_t cmp = ht->key_cmp;
 
-    while(node != NULL && cmp(key, node->key) != 0) node = node->next;
+    UPO_HT_STATS_COUNT_OP(ht, num_puts);
+    while(node != NULL && (node->hash != hash || cmp(key, node->key) != 0)) {
+        UPO_HT_STATS_COUNT_PROBE(ht);
+        node = node->next;
+    }
     if(node == NULL) {
-        node = malloc(sizeof(upo_ht_sepchain_list_node_t));
+        node = upo_pool_alloc(ht->node_pool);
         node->key = key;
         node->value = value;
-        node->next = ht->slots[hash].head;
-        ht->slots[hash].head = node;
+        node->hash = hash;
+        node->next = ht->slots[idx].head;
+        ht->slots[idx].head = node;
+        ht->size += 1;
+        upo_cbloom_add(ht->filter, hash);
     }
     else {
         old_value = node->value;
@@ -153,18 +165,26 @@ void upo_ht_sepchain_insert(upo_ht_sepchain_t ht, void *key, void *value)
     if(ht == NULL) return;
 
     upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    uint64_t hash = hasher(key);
+    size_t idx = upo_ht_hash_to_index(hash, ht->capacity);
     upo_ht_sepchain_list_node_t *node = NULL;
-    node = ht->slots[hash].head;
+    node = ht->slots[idx].head;
     upo_ht_comparator_t cmp = ht->key_cmp;
 
-    while(node != NULL && cmp(key, node->key) != 0) node = node->next;
+    UPO_HT_STATS_COUNT_OP(ht, num_puts);
+    while(node != NULL && (node->hash != hash || cmp(key, node->key) != 0)) {
+        UPO_HT_STATS_COUNT_PROBE(ht);
+        node = node->next;
+    }
     if(node == NULL) {
-        node = malloc(sizeof(upo_ht_sepchain_list_node_t));
+        node = upo_pool_alloc(ht->node_pool);
         node->key = key;
         node->value = value;
-        node->next = ht->slots[hash].head;
-        ht->slots[hash].head = node;
+        node->hash = hash;
+        node->next = ht->slots[idx].head;
+        ht->slots[idx].head = node;
+        ht->size += 1;
+        upo_cbloom_add(ht->filter, hash);
     }
 }
 
@@ -173,12 +193,18 @@ void* upo_ht_sepchain_get(const upo_ht_sepchain_t ht, const void *key)
     if(ht == NULL) return NULL;
 
     upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    uint64_t hash = hasher(key);
+    size_t idx = upo_ht_hash_to_index(hash, ht->capacity);
     upo_ht_sepchain_list_node_t *node = NULL;
-    node = ht->slots[hash].head;
+    node = ht->slots[idx].head;
     upo_ht_comparator_t cmp = ht->key_cmp;
 
-    while(node != NULL && cmp(key, node->key) != 0) node = node->next;
+    UPO_HT_STATS_COUNT_OP(ht, num_gets);
+    if(ht->filter != NULL && !upo_cbloom_may_contain(ht->filter, hash)) return NULL;
+    while(node != NULL && (node->hash != hash || cmp(key, node->key) != 0)) {
+        UPO_HT_STATS_COUNT_PROBE(ht);
+        node = node->next;
+    }
     if(node != NULL) return node->value;
     else return NULL;
 }
@@ -188,12 +214,18 @@ int upo_ht_sepchain_contains(const upo_ht_sepchain_t ht, const void *key)
     if(ht == NULL) return 0;
 
     upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    uint64_t hash = hasher(key);
+    size_t idx = upo_ht_hash_to_index(hash, ht->capacity);
     upo_ht_sepchain_list_node_t *node = NULL;
-    node = ht->slots[hash].head;
+    node = ht->slots[idx].head;
     upo_ht_comparator_t cmp = ht->key_cmp;
 
-    while(node != NULL && cmp(key, node->key) != 0) node = node->next;
+    UPO_HT_STATS_COUNT_OP(ht, num_gets);
+    if(ht->filter != NULL && !upo_cbloom_may_contain(ht->filter, hash)) return 0;
+    while(node != NULL && (node->hash != hash || cmp(key, node->key) != 0)) {
+        UPO_HT_STATS_COUNT_PROBE(ht);
+        node = node->next;
+    }
     if(node != NULL) return 1;
     else return 0;
 }
@@ -203,42 +235,164 @@ void upo_ht_sepchain_delete(upo_ht_sepchain_t ht, const void *key, int destroy_d
     if(ht == NULL) return;
 
     upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    uint64_t hash = hasher(key);
+    size_t idx = upo_ht_hash_to_index(hash, ht->capacity);
     upo_ht_sepchain_list_node_t *node = NULL;
-    node = ht->slots[hash].head;
+    node = ht->slots[idx].head;
     upo_ht_comparator_t cmp = ht->key_cmp;
     upo_ht_sepchain_list_node_t *p = NULL;
 
-    while(node != NULL && cmp(key, node->key) != 0) {
+    UPO_HT_STATS_COUNT_OP(ht, num_deletes);
+    while(node != NULL && (node->hash != hash || cmp(key, node->key) != 0)) {
+        UPO_HT_STATS_COUNT_PROBE(ht);
         p = node;
         node = node->next;
     }
     if(node != NULL) {
-        if(p == NULL) ht->slots[hash].head = node->next;
+        if(p == NULL) ht->slots[idx].head = node->next;
         else p->next = node->next;
+        if(destroy_data) {
+            free(node->key);
+            free(node->value);
+        }
+        upo_pool_free(ht->node_pool, node);
+        ht->size -= 1;
+        upo_cbloom_remove(ht->filter, hash);
+    }
+}
+
+void upo_ht_sepchain_get_batch(const upo_ht_sepchain_t ht, void *const *keys, size_t n, void **values)
+{
+    size_t idx[UPO_HT_BATCH_GROUP_SIZE];
+    uint64_t hash[UPO_HT_BATCH_GROUP_SIZE];
+    upo_ht_sepchain_list_node_t *head[UPO_HT_BATCH_GROUP_SIZE];
+    size_t b = 0;
+
+    if (ht == NULL)
+    {
+        for (b = 0; b < n; ++b)
+        {
+            values[b] = NULL;
+        }
+        return;
     }
-    if(destroy_data) {
-        free(node->key);
-        free(node->value);
+
+    for (b = 0; b < n; b += UPO_HT_BATCH_GROUP_SIZE)
+    {
+        size_t g = (n - b < UPO_HT_BATCH_GROUP_SIZE) ? n - b : UPO_HT_BATCH_GROUP_SIZE;
+        size_t i = 0;
+
+        /* Stage 1: hashes the keys of the group and prefetches their slots,
+         * unless the filter rejects them */
+        for (i = 0; i < g; ++i)
+        {
+            hash[i] = ht->key_hash(keys[b+i]);
+            idx[i] = upo_ht_hash_to_index(hash[i], ht->capacity);
+            if (ht->filter != NULL && !upo_cbloom_may_contain(ht->filter, hash[i]))
+            {
+                idx[i] = SIZE_MAX;
+            }
+            else
+            {
+                UPO_HT_PREFETCH(&ht->slots[idx[i]]);
+            }
+        }
+        /* Stage 2: prefetches the heads of the lists of collisions */
+        for (i = 0; i < g; ++i)
+        {
+            head[i] = (idx[i] != SIZE_MAX) ? ht->slots[idx[i]].head : NULL;
+            if (head[i] != NULL)
+            {
+                UPO_HT_PREFETCH(head[i]);
+            }
+        }
+        /* Stage 3: walks the lists, whose heads are now in cache */
+        for (i = 0; i < g; ++i)
+        {
+            upo_ht_sepchain_list_node_t *node = head[i];
+
+            UPO_HT_STATS_COUNT_OP(ht, num_gets);
+            while (node != NULL && (node->hash != hash[i] || ht->key_cmp(keys[b+i], node->key) != 0))
+            {
+                UPO_HT_STATS_COUNT_PROBE(ht);
+                node = node->next;
+            }
+            values[b+i] = (node != NULL) ? node->value : NULL;
+        }
     }
-    free(node);
 }
 
-size_t upo_ht_sepchain_size(const upo_ht_sepchain_t ht)
+void upo_ht_sepchain_put_batch(upo_ht_sepchain_t ht, void *const *keys, void *const *values, size_t n, void **old_values)
 {
-    if(ht == NULL) return 0;
+    size_t idx[UPO_HT_BATCH_GROUP_SIZE];
+    uint64_t hash[UPO_HT_BATCH_GROUP_SIZE];
+    size_t b = 0;
 
-    size_t size = 0;
+    if (ht == NULL)
+    {
+        return;
+    }
 
-    for(size_t i = 0; i < ht->capacity; i++) {
-        upo_ht_sepchain_list_node_t *node = NULL;
-        node = ht->slots[i].head;
-        while(node != NULL) {
-            node = node->next;
-            size++;
+    for (b = 0; b < n; b += UPO_HT_BATCH_GROUP_SIZE)
+    {
+        size_t g = (n - b < UPO_HT_BATCH_GROUP_SIZE) ? n - b : UPO_HT_BATCH_GROUP_SIZE;
+        size_t i = 0;
+
+        for (i = 0; i < g; ++i)
+        {
+            hash[i] = ht->key_hash(keys[b+i]);
+            idx[i] = upo_ht_hash_to_index(hash[i], ht->capacity);
+            UPO_HT_PREFETCH(&ht->slots[idx[i]]);
+        }
+        for (i = 0; i < g; ++i)
+        {
+            if (ht->slots[idx[i]].head != NULL)
+            {
+                UPO_HT_PREFETCH(ht->slots[idx[i]].head);
+            }
+        }
+        /* Heads are read again rather than kept from the previous stage,
+         * since an earlier pair of the group may have changed them */
+        for (i = 0; i < g; ++i)
+        {
+            upo_ht_sepchain_list_node_t *node = ht->slots[idx[i]].head;
+            void *old_value = NULL;
+
+            UPO_HT_STATS_COUNT_OP(ht, num_puts);
+            while (node != NULL && (node->hash != hash[i] || ht->key_cmp(keys[b+i], node->key) != 0))
+            {
+                UPO_HT_STATS_COUNT_PROBE(ht);
+                node = node->next;
+            }
+            if (node == NULL)
+            {
+                node = upo_pool_alloc(ht->node_pool);
+                node->key = keys[b+i];
+                node->value = values[b+i];
+                node->hash = hash[i];
+                node->next = ht->slots[idx[i]].head;
+                ht->slots[idx[i]].head = node;
+                ht->size += 1;
+                upo_cbloom_add(ht->filter, hash[i]);
+            }
+            else
+            {
+                old_value = node->value;
+                node->value = values[b+i];
+            }
+            if (old_values != NULL)
+            {
+                old_values[b+i] = old_value;
+            }
         }
     }
-    return size;
+}
+
+size_t upo_ht_sepchain_size(const upo_ht_sepchain_t ht)
+{
+    if(ht == NULL) return 0;
+
+    return ht->size;
 }
 
 int upo_ht_sepchain_is_empty(const upo_ht_sepchain_t ht)
@@ -266,6 +420,37 @@ upo_ht_hasher_t upo_ht_sepchain_get_hasher(const upo_ht_sepchain_t ht)
     return ht->key_hash;
 }
 
+void upo_ht_sepchain_attach_filter(upo_ht_sepchain_t ht, size_t n, double fpr)
+{
+    if (ht != NULL)
+    {
+        size_t i;
+
+        upo_cbloom_destroy(ht->filter);
+        ht->filter = upo_cbloom_create(n, fpr);
+
+        /* Keys already stored are added by their cached hash value */
+        for (i = 0; i < ht->capacity; ++i)
+        {
+            upo_ht_sepchain_list_node_t *node = NULL;
+
+            for (node = ht->slots[i].head; node != NULL; node = node->next)
+            {
+                upo_cbloom_add(ht->filter, node->hash);
+            }
+        }
+    }
+}
+
+void upo_ht_sepchain_detach_filter(upo_ht_sepchain_t ht)
+{
+    if (ht != NULL)
+    {
+        upo_cbloom_destroy(ht->filter);
+        ht->filter = NULL;
+    }
+}
+
 
 /*** EXERCISE #1 - END of HASH TABLE with SEPARATE CHAINING ***/
 
@@ -305,6 +490,7 @@ upo_ht_linprob_t upo_ht_linprob_create(size_t m, upo_ht_hasher_t key_hash, upo_h
         {
             ht->slots[i].key = NULL;
             ht->slots[i].value = NULL;
+            ht->slots[i].hash = 0;
             ht->slots[i].tombstone = 0;
         }
     }
@@ -318,6 +504,7 @@ upo_ht_linprob_t upo_ht_linprob_create(size_t m, upo_ht_hasher_t key_hash, upo_h
     ht->size = 0;
     ht->key_hash = key_hash;
     ht->key_cmp = key_cmp;
+    upo_ht_linprob_reset_stats(ht);
 
     return ht;
 }
@@ -366,12 +553,15 @@ void* upo_ht_linprob_put(upo_ht_linprob_t ht, void *key, void *value)
     if(upo_ht_linprob_load_factor(ht) >= 0.5) upo_ht_linprob_resize(ht, ht->capacity * 2);
 
     upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    uint64_t key_hash = hasher(key);
+    size_t hash = upo_ht_hash_to_index(key_hash, ht->capacity);
     size_t tomb_hash = 0;
     upo_ht_comparator_t cmp = ht->key_cmp;
     int tomb_found = 0;
 
-    while((ht->slots[hash].key != NULL && cmp(key, ht->slots[hash].key)) || ht->slots[hash].tombstone) {
+    UPO_HT_STATS_COUNT_OP(ht, num_puts);
+    while((ht->slots[hash].key != NULL && (ht->slots[hash].hash != key_hash || cmp(key, ht->slots[hash].key) != 0)) || ht->slots[hash].tombstone) {
+        UPO_HT_STATS_COUNT_PROBE(ht);
         if(ht->slots[hash].tombstone && !tomb_found) {
             tomb_found = 1;
             tomb_hash = hash;
@@ -382,6 +572,7 @@ void* upo_ht_linprob_put(upo_ht_linprob_t ht, void *key, void *value)
         if(tomb_found) hash = tomb_hash;
         ht->slots[hash].key = key;
         ht->slots[hash].value = value;
+        ht->slots[hash].hash = key_hash;
         ht->slots[hash].tombstone = 0;
         ht->size += 1;
     }
@@ -400,12 +591,15 @@ void upo_ht_linprob_insert(upo_ht_linprob_t ht, void *key, void *value)
     if(upo_ht_linprob_load_factor(ht) >= 0.5) upo_ht_linprob_resize(ht, ht->capacity * 2);
     
     upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    uint64_t key_hash = hasher(key);
+    size_t hash = upo_ht_hash_to_index(key_hash, ht->capacity);
     size_t tomb_hash = 0;
     int tomb_found = 0;
     upo_ht_comparator_t cmp = ht->key_cmp;
 
-    while((ht->slots[hash].key != NULL && cmp(key, ht->slots[hash].key) != 0) || ht->slots[hash].tombstone) {
+    UPO_HT_STATS_COUNT_OP(ht, num_puts);
+    while((ht->slots[hash].key != NULL && (ht->slots[hash].hash != key_hash || cmp(key, ht->slots[hash].key) != 0)) || ht->slots[hash].tombstone) {
+        UPO_HT_STATS_COUNT_PROBE(ht);
         if(ht->slots[hash].tombstone && !tomb_found) {
             tomb_found = 1;
             tomb_hash = hash;
@@ -416,6 +610,7 @@ void upo_ht_linprob_insert(upo_ht_linprob_t ht, void *key, void *value)
         if(tomb_found) hash = tomb_hash;
         ht->slots[hash].key = key;
         ht->slots[hash].value = value;
+        ht->slots[hash].hash = key_hash;
         ht->slots[hash].tombstone = 0;
         ht->size += 1;
     }
@@ -426,10 +621,15 @@ void* upo_ht_linprob_get(const upo_ht_linprob_t ht, const void *key)
     if(ht == NULL) return NULL;
 
     upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    uint64_t key_hash = hasher(key);
+    size_t hash = upo_ht_hash_to_index(key_hash, ht->capacity);
     upo_ht_comparator_t cmp = ht->key_cmp;
 
-    while((ht->slots[hash].key != NULL && cmp(key, ht->slots[hash].key)) || ht->slots[hash].tombstone) hash = (hash + 1) % ht->capacity;
+    UPO_HT_STATS_COUNT_OP(ht, num_gets);
+    while((ht->slots[hash].key != NULL && (ht->slots[hash].hash != key_hash || cmp(key, ht->slots[hash].key) != 0)) || ht->slots[hash].tombstone) {
+        UPO_HT_STATS_COUNT_PROBE(ht);
+        hash = (hash + 1) % ht->capacity;
+    }
     if(ht->slots[hash].key != NULL) return ht->slots[hash].value;
     else return NULL;
 }
@@ -439,10 +639,15 @@ int upo_ht_linprob_contains(const upo_ht_linprob_t ht, const void *key)
     if(ht == NULL) return 0;
 
     upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    uint64_t key_hash = hasher(key);
+    size_t hash = upo_ht_hash_to_index(key_hash, ht->capacity);
     upo_ht_comparator_t cmp = ht->key_cmp;
 
-    while((ht->slots[hash].key != NULL && cmp(key, ht->slots[hash].key)) || ht->slots[hash].tombstone) hash = (hash + 1) % ht->capacity;
+    UPO_HT_STATS_COUNT_OP(ht, num_gets);
+    while((ht->slots[hash].key != NULL && (ht->slots[hash].hash != key_hash || cmp(key, ht->slots[hash].key) != 0)) || ht->slots[hash].tombstone) {
+        UPO_HT_STATS_COUNT_PROBE(ht);
+        hash = (hash + 1) % ht->capacity;
+    }
     if(ht->slots[hash].key != NULL) return 1;
     else return 0;
 }
@@ -452,10 +657,15 @@ void upo_ht_linprob_delete(upo_ht_linprob_t ht, const void *key, int destroy_dat
     if(ht == NULL) return;
 
     upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
+    uint64_t key_hash = hasher(key);
+    size_t hash = upo_ht_hash_to_index(key_hash, ht->capacity);
     upo_ht_comparator_t cmp = ht->key_cmp;
 
-    while((ht->slots[hash].key != NULL && cmp(key, ht->slots[hash].key) != 0) || ht->slots[hash].tombstone) hash = (hash + 1) % ht->capacity;
+    UPO_HT_STATS_COUNT_OP(ht, num_deletes);
+    while((ht->slots[hash].key != NULL && (ht->slots[hash].hash != key_hash || cmp(key, ht->slots[hash].key) != 0)) || ht->slots[hash].tombstone) {
+        UPO_HT_STATS_COUNT_PROBE(ht);
+        hash = (hash + 1) % ht->capacity;
+    }
     if(ht->slots[hash].key != NULL) {
         if(destroy_data) {
             free(ht->slots[hash].key);
@@ -464,21 +674,134 @@ void upo_ht_linprob_delete(upo_ht_linprob_t ht, const void *key, int destroy_dat
         ht->slots[hash].key = NULL;
         ht->slots[hash].value = NULL;
         ht->slots[hash].tombstone = 1;
-        if(upo_ht_linprob_load_factor(ht) <= 0.125) upo_ht_linprob_resize(ht, ht->capacity / 2);
         ht->size -= 1;
+        if(upo_ht_linprob_load_factor(ht) <= 0.125) upo_ht_linprob_resize(ht, ht->capacity / 2);
     }   
 }
 
-size_t upo_ht_linprob_size(const upo_ht_linprob_t ht)
+void upo_ht_linprob_get_batch(const upo_ht_linprob_t ht, void *const *keys, size_t n, void **values)
 {
-    if(ht == NULL) return 0;
+    size_t idx[UPO_HT_BATCH_GROUP_SIZE];
+    uint64_t hash[UPO_HT_BATCH_GROUP_SIZE];
+    size_t b = 0;
+
+    if (ht == NULL)
+    {
+        for (b = 0; b < n; ++b)
+        {
+            values[b] = NULL;
+        }
+        return;
+    }
+
+    for (b = 0; b < n; b += UPO_HT_BATCH_GROUP_SIZE)
+    {
+        size_t g = (n - b < UPO_HT_BATCH_GROUP_SIZE) ? n - b : UPO_HT_BATCH_GROUP_SIZE;
+        size_t i = 0;
+
+        /* Stage 1: hashes the keys of the group and prefetches their home
+         * slots */
+        for (i = 0; i < g; ++i)
+        {
+            hash[i] = ht->key_hash(keys[b+i]);
+            idx[i] = upo_ht_hash_to_index(hash[i], ht->capacity);
+            UPO_HT_PREFETCH(&ht->slots[idx[i]]);
+        }
+        /* Stage 2: probes from the home slots, which are now in cache */
+        for (i = 0; i < g; ++i)
+        {
+            size_t j = idx[i];
+
+            UPO_HT_STATS_COUNT_OP(ht, num_gets);
+            while ((ht->slots[j].key != NULL && (ht->slots[j].hash != hash[i] || ht->key_cmp(keys[b+i], ht->slots[j].key) != 0)) || ht->slots[j].tombstone)
+            {
+                UPO_HT_STATS_COUNT_PROBE(ht);
+                j = (j + 1) % ht->capacity;
+            }
+            values[b+i] = (ht->slots[j].key != NULL) ? ht->slots[j].value : NULL;
+        }
+    }
+}
 
-    size_t size = 0;
+void upo_ht_linprob_put_batch(upo_ht_linprob_t ht, void *const *keys, void *const *values, size_t n, void **old_values)
+{
+    size_t idx[UPO_HT_BATCH_GROUP_SIZE];
+    uint64_t hash[UPO_HT_BATCH_GROUP_SIZE];
+    size_t b = 0;
+
+    if (ht == NULL)
+    {
+        return;
+    }
+
+    for (b = 0; b < n; b += UPO_HT_BATCH_GROUP_SIZE)
+    {
+        size_t g = (n - b < UPO_HT_BATCH_GROUP_SIZE) ? n - b : UPO_HT_BATCH_GROUP_SIZE;
+        size_t i = 0;
 
-    for(size_t i = 0; i < ht->capacity; i++) {
-        if(ht->slots[i].key != NULL && !ht->slots[i].tombstone) size++;
+        /* Makes room for the whole group at once, so that slots do not move
+         * after being prefetched */
+        while (2*(ht->size + g) > ht->capacity)
+        {
+            upo_ht_linprob_resize(ht, ht->capacity * 2);
+        }
+
+        for (i = 0; i < g; ++i)
+        {
+            hash[i] = ht->key_hash(keys[b+i]);
+            idx[i] = upo_ht_hash_to_index(hash[i], ht->capacity);
+            UPO_HT_PREFETCH(&ht->slots[idx[i]]);
+        }
+        for (i = 0; i < g; ++i)
+        {
+            size_t j = idx[i];
+            size_t tomb = 0;
+            int tomb_found = 0;
+            void *old_value = NULL;
+
+            UPO_HT_STATS_COUNT_OP(ht, num_puts);
+            while ((ht->slots[j].key != NULL && (ht->slots[j].hash != hash[i] || ht->key_cmp(keys[b+i], ht->slots[j].key) != 0)) || ht->slots[j].tombstone)
+            {
+                UPO_HT_STATS_COUNT_PROBE(ht);
+                if (ht->slots[j].tombstone && !tomb_found)
+                {
+                    tomb_found = 1;
+                    tomb = j;
+                }
+                j = (j + 1) % ht->capacity;
+            }
+            if (ht->slots[j].key == NULL)
+            {
+                if (tomb_found)
+                {
+                    j = tomb;
+                }
+                ht->slots[j].key = keys[b+i];
+                ht->slots[j].value = values[b+i];
+                ht->slots[j].hash = hash[i];
+                ht->slots[j].tombstone = 0;
+                ht->size += 1;
+            }
+            else
+            {
+                old_value = ht->slots[j].value;
+                ht->slots[j].value = values[b+i];
+            }
+            if (old_values != NULL)
+            {
+                old_values[b+i] = old_value;
+            }
+        }
     }
-    return size;
+}
+
+size_t upo_ht_linprob_size(const upo_ht_linprob_t ht)
+{
+    if(ht == NULL) return 0;
+
+    /* The size is kept up to date by insertions, removals and resizes, so the
+     * load factor checked by each insertion does not scan the table */
+    return ht->size;
 }
 
 int upo_ht_linprob_is_empty(const upo_ht_linprob_t ht)
@@ -496,6 +819,16 @@ double upo_ht_linprob_load_factor(const upo_ht_linprob_t ht)
     return upo_ht_linprob_size(ht) / (double) upo_ht_linprob_capacity(ht);
 }
 
+upo_ht_comparator_t upo_ht_linprob_get_comparator(const upo_ht_linprob_t ht)
+{
+    return ht->key_cmp;
+}
+
+upo_ht_hasher_t upo_ht_linprob_get_hasher(const upo_ht_linprob_t ht)
+{
+    return ht->key_hash;
+}
+
 void upo_ht_linprob_resize(upo_ht_linprob_t ht, size_t n)
 {
     /* preconditions */
@@ -509,6 +842,7 @@ void upo_ht_linprob_resize(upo_ht_linprob_t ht, size_t n)
 
         size_t i = 0;
         upo_ht_linprob_t new_ht = NULL;
+        double start = upo_ht_stats_now();
 
         /* Create a new temporary hash table */
         new_ht = upo_ht_linprob_create(n, ht->key_hash, ht->key_cmp);
@@ -518,15 +852,24 @@ void upo_ht_linprob_resize(upo_ht_linprob_t ht, size_t n)
             abort();
         }
 
-        /* Put in the temporary hash table the key-value pairs stored in the
+        /* Move in the temporary hash table the key-value pairs stored in the
          * hash table to resize.
-         * Note: by calling function 'put' we are also rehashing the keys
-         * according to the new capacity. */
+         * Note: keys are not hashed again since their full hash value is
+         * cached in the slot and only needs to be reduced according to the
+         * new capacity; also, keys are known to be distinct, so no comparison
+         * is needed to find their new slot. */
         for (i = 0; i < ht->capacity; ++i)
         {
             if (ht->slots[i].key != NULL)
             {
-                upo_ht_linprob_put(new_ht, ht->slots[i].key, ht->slots[i].value);
+                size_t j = upo_ht_hash_to_index(ht->slots[i].hash, n);
+
+                while (new_ht->slots[j].key != NULL)
+                {
+                    j = (j + 1) % n;
+                }
+                new_ht->slots[j] = ht->slots[i];
+                new_ht->size += 1;
             }
         }
 
@@ -542,6 +885,9 @@ void upo_ht_linprob_resize(upo_ht_linprob_t ht, size_t n)
 
         /* Destroy temporary hash table */
         upo_ht_linprob_destroy(new_ht, 0);
+
+        ht->num_resizes += 1;
+        ht->resize_time += upo_ht_stats_now() - start;
     }
 }
 
@@ -554,237 +900,2082 @@ void upo_ht_linprob_resize(upo_ht_linprob_t ht, size_t n)
 
 upo_ht_key_list_t upo_ht_sepchain_keys(const upo_ht_sepchain_t ht)
 {
-    if(ht == NULL) return NULL;
-
     upo_ht_key_list_t list = NULL;
-    
-    if(!upo_ht_sepchain_is_empty(ht)) {
-        for(size_t i = 0; i < ht->capacity; i++) {
-            upo_ht_sepchain_list_node_t *node = NULL;
-            if(ht->slots[i].head != NULL) {
-                node = ht->slots[i].head;
-                while(node != NULL) {
-                    upo_ht_key_list_node_t *list_node = NULL;
-                    list_node = malloc(sizeof(upo_ht_key_list_node_t));
-                    if(list_node == NULL) {
-                        perror("Unable to allocate memory for Hash Table with Separate Chaining");
-                        abort();
-                    }
-                    list_node->key = node->key;
-                    list_node->next = list;
-                    list = list_node;
-                    node = node->next;
-                }
-            }
+    upo_ht_sepchain_iter_t it;
+    void *key = NULL;
+
+    upo_ht_sepchain_iter_begin(ht, &it);
+    while (upo_ht_sepchain_iter_next(&it, &key, NULL))
+    {
+        upo_ht_key_list_node_t *list_node = malloc(sizeof(upo_ht_key_list_node_t));
+        if (list_node == NULL)
+        {
+            perror("Unable to allocate memory for the list of keys");
+            abort();
         }
+        list_node->key = key;
+        list_node->next = list;
+        list = list_node;
     }
+
     return list;
 }
 
-void upo_ht_sepchain_traverse(const upo_ht_sepchain_t ht, upo_ht_visitor_t visit, void *visit_context)
+void upo_ht_sepchain_iter_begin(const upo_ht_sepchain_t ht, upo_ht_sepchain_iter_t *it)
 {
-    if(ht == NULL) return;
+    /* preconditions */
+    assert( it != NULL );
 
-    if(!upo_ht_sepchain_is_empty(ht)) {
-        for(size_t i = 0; i < ht->capacity; i++) {
-            upo_ht_sepchain_list_node_t *node = NULL;
-            if(ht->slots[i].head != NULL) {
-                node = ht->slots[i].head;
-                while(node != NULL) {
-                    visit(node->value, node->key, visit_context);
-                    node = node->next;
-                }
-            }
-        }
-    }
+    it->ht = ht;
+    it->slot = 0;
+    it->node = NULL;
 }
 
-upo_ht_key_list_t upo_ht_linprob_keys(const upo_ht_linprob_t ht)
+int upo_ht_sepchain_iter_next(upo_ht_sepchain_iter_t *it, void **key, void **value)
 {
-    if(ht == NULL) return NULL;
+    /* preconditions */
+    assert( it != NULL );
 
-    upo_ht_key_list_t list = NULL;
+    if (it->ht == NULL)
+    {
+        return 0;
+    }
 
-    if(!upo_ht_linprob_is_empty(ht)) {
-        for(size_t i = 0; i < ht->capacity; i++) {
-            upo_ht_key_list_node_t *list_node = NULL;
-            if(ht->slots[i].key != NULL && !ht->slots[i].tombstone) {
-                list_node = malloc(sizeof(upo_ht_key_list_node_t));
-                if(list_node == NULL) {
-                    perror("Unable to allocate memory for Hash Table with Separate Chaining");
-                    abort();
-                }
-                list_node->key = ht->slots[i].key;
-                list_node->next = list;
-                list = list_node;
-            }
+    /* Skip empty slots until a non-empty list of collisions is found */
+    while (it->node == NULL)
+    {
+        if (it->slot >= it->ht->capacity)
+        {
+            return 0;
         }
+        it->node = it->ht->slots[it->slot].head;
+        it->slot += 1;
     }
-    return list;
+
+    if (key != NULL)
+    {
+        *key = it->node->key;
+    }
+    if (value != NULL)
+    {
+        *value = it->node->value;
+    }
+    it->node = it->node->next;
+
+    return 1;
 }
 
-void upo_ht_linprob_traverse(const upo_ht_linprob_t ht, upo_ht_visitor_t visit, void *visit_context)
+size_t upo_ht_sepchain_keys_into(const upo_ht_sepchain_t ht, void **keys, size_t n)
 {
-    if(ht == NULL) return;
+    upo_ht_sepchain_iter_t it;
+    size_t count = 0;
 
-    if(!upo_ht_linprob_is_empty(ht)) {
-        for(size_t i = 0; i < ht->capacity; i++) {
-            if(ht->slots[i].key != NULL && !ht->slots[i].tombstone) {
-                visit(ht->slots[i].key, ht->slots[i].value, visit_context);
-            }
-        }
+    /* preconditions */
+    assert( keys != NULL || n == 0 );
+
+    upo_ht_sepchain_iter_begin(ht, &it);
+    while (count < n && upo_ht_sepchain_iter_next(&it, &keys[count], NULL))
+    {
+        ++count;
     }
+
+    return count;
 }
 
+void upo_ht_sepchain_traverse(const upo_ht_sepchain_t ht, upo_ht_visitor_t visit, void *visit_context)
+{
+    upo_ht_sepchain_iter_t it;
+    void *key = NULL;
+    void *value = NULL;
 
-/*** EXERCISE #3 - END of HASH TABLE - EXTRA OPERATIONS ***/
+    upo_ht_sepchain_iter_begin(ht, &it);
+    while (upo_ht_sepchain_iter_next(&it, &key, &value))
+    {
+        visit(key, value, visit_context);
+    }
+}
 
+upo_ht_key_list_t upo_ht_linprob_keys(const upo_ht_linprob_t ht)
+{
+    upo_ht_key_list_t list = NULL;
+    upo_ht_linprob_iter_t it;
+    void *key = NULL;
 
-/*** END of HASH TABLE with SEPARATE CHAINING and ORDERED LISTS ***/
+    upo_ht_linprob_iter_begin(ht, &it);
+    while (upo_ht_linprob_iter_next(&it, &key, NULL))
+    {
+        upo_ht_key_list_node_t *list_node = malloc(sizeof(upo_ht_key_list_node_t));
+        if (list_node == NULL)
+        {
+            perror("Unable to allocate memory for the list of keys");
+            abort();
+        }
+        list_node->key = key;
+        list_node->next = list;
+        list = list_node;
+    }
 
+    return list;
+}
 
-upo_ht_sepchain_olist_t upo_ht_sepchain_olist_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp);
+void upo_ht_linprob_iter_begin(const upo_ht_linprob_t ht, upo_ht_linprob_iter_t *it)
+{
+    /* preconditions */
+    assert( it != NULL );
 
-void upo_ht_sepchain_olist_destroy(upo_ht_sepchain_olist_t ht, int destroy_data);
+    it->ht = ht;
+    it->slot = 0;
+}
 
-void upo_ht_sepchain_olist_clear(upo_ht_sepchain_olist_t ht, int destroy_data);
+int upo_ht_linprob_iter_next(upo_ht_linprob_iter_t *it, void **key, void **value)
+{
+    /* preconditions */
+    assert( it != NULL );
 
-void* upo_ht_sepchain_olist_get(const upo_ht_sepchain_olist_t ht, const void *key);
+    if (it->ht == NULL)
+    {
+        return 0;
+    }
 
-int upo_ht_sepchain_olist_contains(const upo_ht_sepchain_olist_t ht, const void *key);
+    /* Skip empty and deleted slots */
+    while (it->slot < it->ht->capacity)
+    {
+        const upo_ht_linprob_slot_t *slot = &it->ht->slots[it->slot];
 
-void* upo_ht_sepchain_olist_put(upo_ht_sepchain_olist_t ht, void *key, void *value) {
-    if(ht == NULL || upo_ht_sepchain_olist_is_empty(ht)) return NULL;
+        it->slot += 1;
+        if (slot->key != NULL && !slot->tombstone)
+        {
+            if (key != NULL)
+            {
+                *key = slot->key;
+            }
+            if (value != NULL)
+            {
+                *value = slot->value;
+            }
+            return 1;
+        }
+    }
 
-    void *old_value = NULL;
-    upo_ht_hasher_t hasher = ht->key_hash;
-    size_t hash = hasher(key, ht->capacity);
-    upo_ht_sepchain_list_node_t *node = NULL;
-    node = ht->slots[hash].head;
-    upo_ht_comparator_t cmp = ht->key_cmp;
+    return 0;
+}
 
-    while(node != NULL && cmp(key, node->key) < 0) node = node->next;
-    if(node == NULL) {
-        node = malloc(sizeof(upo_ht_sepchain_list_node_t));
+uint64_t upo_ht_linprob_iter_hash(const upo_ht_linprob_iter_t *it)
+{
+    /* preconditions */
+    assert( it != NULL );
+    assert( it->ht != NULL );
+    assert( it->slot > 0 );
+
+    return it->ht->slots[it->slot - 1].hash;
+}
+
+size_t upo_ht_linprob_keys_into(const upo_ht_linprob_t ht, void **keys, size_t n)
+{
+    upo_ht_linprob_iter_t it;
+    size_t count = 0;
+
+    /* preconditions */
+    assert( keys != NULL || n == 0 );
+
+    upo_ht_linprob_iter_begin(ht, &it);
+    while (count < n && upo_ht_linprob_iter_next(&it, &keys[count], NULL))
+    {
+        ++count;
+    }
+
+    return count;
+}
+
+void upo_ht_linprob_traverse(const upo_ht_linprob_t ht, upo_ht_visitor_t visit, void *visit_context)
+{
+    upo_ht_linprob_iter_t it;
+    void *key = NULL;
+    void *value = NULL;
+
+    upo_ht_linprob_iter_begin(ht, &it);
+    while (upo_ht_linprob_iter_next(&it, &key, &value))
+    {
+        visit(key, value, visit_context);
+    }
+}
+
+
+/*** EXERCISE #3 - END of HASH TABLE - EXTRA OPERATIONS ***/
+
+
+/*** BEGIN of HASH TABLE BULK BUILD ***/
+
+
+void upo_ht_build_partition(void *const *keys, size_t n, upo_ht_hasher_t key_hash, size_t capacity, uint64_t *hashes, size_t *order)
+{
+    size_t num_parts = 1;
+    size_t width = 0;
+    size_t *offsets = NULL;
+    size_t i;
+
+    while (num_parts < UPO_HT_BUILD_MAX_PARTITIONS && capacity / num_parts > UPO_HT_BUILD_PARTITION_SLOTS)
+    {
+        num_parts *= 2;
+    }
+    width = (capacity + num_parts - 1) / num_parts;
+
+    for (i = 0; i < n; ++i)
+    {
+        hashes[i] = key_hash(keys[i]);
+    }
+
+    if (num_parts == 1)
+    {
+        /* The whole table fits in a region */
+        for (i = 0; i < n; ++i)
+        {
+            order[i] = i;
+        }
+        return;
+    }
+
+    offsets = calloc(num_parts + 1, sizeof(size_t));
+    if (offsets == NULL)
+    {
+        perror("Unable to allocate memory for the partitions of the Hash Table");
+        abort();
+    }
+
+    /* Count the keys of each region, then turn counts into the position of
+     * the first key of each region */
+    for (i = 0; i < n; ++i)
+    {
+        offsets[upo_ht_hash_to_index(hashes[i], capacity) / width + 1] += 1;
+    }
+    for (i = 1; i <= num_parts; ++i)
+    {
+        offsets[i] += offsets[i-1];
+    }
+    /* Scattering keys in their original order keeps the partition stable */
+    for (i = 0; i < n; ++i)
+    {
+        order[offsets[upo_ht_hash_to_index(hashes[i], capacity) / width]++] = i;
+    }
+
+    free(offsets);
+}
+
+upo_ht_sepchain_t upo_ht_sepchain_build(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp, void *const *keys, void *const *values, size_t n)
+{
+    upo_ht_sepchain_t ht = NULL;
+    uint64_t *hashes = NULL;
+    size_t *order = NULL;
+    size_t k;
+
+    ht = upo_ht_sepchain_create((m > 0) ? m : (n > 0) ? n : 1, key_hash, key_cmp);
+
+    hashes = malloc(n*sizeof(uint64_t));
+    order = malloc(n*sizeof(size_t));
+    if (n > 0 && (hashes == NULL || order == NULL))
+    {
+        perror("Unable to allocate memory for building the Hash Table with Separate Chaining");
+        abort();
+    }
+    upo_ht_build_partition(keys, n, key_hash, ht->capacity, hashes, order);
+
+    for (k = 0; k < n; ++k)
+    {
+        size_t i = order[k];
+        size_t idx = upo_ht_hash_to_index(hashes[i], ht->capacity);
+        upo_ht_sepchain_list_node_t *node = ht->slots[idx].head;
+
+        UPO_HT_STATS_COUNT_OP(ht, num_puts);
+        while (node != NULL && (node->hash != hashes[i] || key_cmp(keys[i], node->key) != 0))
+        {
+            UPO_HT_STATS_COUNT_PROBE(ht);
+            node = node->next;
+        }
+        if (node == NULL)
+        {
+            node = upo_pool_alloc(ht->node_pool);
+            node->key = keys[i];
+            node->hash = hashes[i];
+            node->next = ht->slots[idx].head;
+            ht->slots[idx].head = node;
+            ht->size += 1;
+        }
+        node->value = (values != NULL) ? values[i] : NULL;
+    }
+
+    free(order);
+    free(hashes);
+
+    return ht;
+}
+
+upo_ht_linprob_t upo_ht_linprob_build(upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp, void *const *keys, void *const *values, size_t n)
+{
+    upo_ht_linprob_t ht = NULL;
+    uint64_t *hashes = NULL;
+    size_t *order = NULL;
+    size_t capacity = UPO_HT_LINPROB_DEFAULT_CAPACITY;
+    size_t k;
+
+    /* The same bound checked by insertions, so that the next insertion does
+     * not resize the table */
+    while (2*n >= capacity)
+    {
+        capacity *= 2;
+    }
+    ht = upo_ht_linprob_create(capacity, key_hash, key_cmp);
+
+    hashes = malloc(n*sizeof(uint64_t));
+    order = malloc(n*sizeof(size_t));
+    if (n > 0 && (hashes == NULL || order == NULL))
+    {
+        perror("Unable to allocate memory for building the Hash Table with Linear Probing");
+        abort();
+    }
+    upo_ht_build_partition(keys, n, key_hash, capacity, hashes, order);
+
+    /* The table has no deleted slots, so probing stops at the first slot
+     * that is empty or that holds an equal key */
+    for (k = 0; k < n; ++k)
+    {
+        size_t i = order[k];
+        size_t j = upo_ht_hash_to_index(hashes[i], capacity);
+
+        UPO_HT_STATS_COUNT_OP(ht, num_puts);
+        while (ht->slots[j].key != NULL && (ht->slots[j].hash != hashes[i] || key_cmp(keys[i], ht->slots[j].key) != 0))
+        {
+            UPO_HT_STATS_COUNT_PROBE(ht);
+            j = (j + 1) & (capacity - 1);
+        }
+        if (ht->slots[j].key == NULL)
+        {
+            ht->slots[j].key = keys[i];
+            ht->slots[j].hash = hashes[i];
+            ht->size += 1;
+        }
+        ht->slots[j].value = (values != NULL) ? values[i] : NULL;
+    }
+
+    free(order);
+    free(hashes);
+
+    return ht;
+}
+
+
+/*** END of HASH TABLE BULK BUILD ***/
+
+
+/*** BEGIN of HASH TABLE STATISTICS ***/
+
+
+void upo_ht_stats_init(upo_ht_stats_t *stats, size_t size, size_t capacity)
+{
+    memset(stats, 0, sizeof *stats);
+    stats->size = size;
+    stats->capacity = capacity;
+}
+
+void upo_ht_stats_histogram_add(size_t *histogram, size_t length)
+{
+    histogram[(length < UPO_HT_STATS_HISTOGRAM_SIZE) ? length : UPO_HT_STATS_HISTOGRAM_SIZE - 1] += 1;
+}
+
+size_t upo_ht_stats_percentile(const size_t *counts, size_t max_length, size_t n, double p)
+{
+    size_t target = (size_t) ceil(p*n);
+    size_t cum = 0;
+    size_t k;
+
+    if (target == 0)
+    {
+        target = 1;
+    }
+    for (k = 0; k <= max_length; ++k)
+    {
+        cum += counts[k];
+        if (cum >= target)
+        {
+            return k;
+        }
+    }
+
+    return max_length;
+}
+
+void upo_ht_stats_set_probe_lengths(upo_ht_stats_t *stats, const size_t *counts)
+{
+    size_t sum = 0;
+    size_t k;
+
+    if (stats->size == 0)
+    {
+        return;
+    }
+
+    for (k = 0; k <= stats->max_probe_length; ++k)
+    {
+        sum += k*counts[k];
+    }
+    stats->mean_probe_length = sum / (double) stats->size;
+    stats->p50_probe_length = upo_ht_stats_percentile(counts, stats->max_probe_length, stats->size, 0.50);
+    stats->p90_probe_length = upo_ht_stats_percentile(counts, stats->max_probe_length, stats->size, 0.90);
+    stats->p99_probe_length = upo_ht_stats_percentile(counts, stats->max_probe_length, stats->size, 0.99);
+}
+
+double upo_ht_stats_now()
+{
+    struct timespec ts;
+
+    timespec_get(&ts, TIME_UTC);
+
+    return ts.tv_sec + ts.tv_nsec*1.0e-9;
+}
+
+void upo_ht_sepchain_stats(const upo_ht_sepchain_t ht, upo_ht_stats_t *stats)
+{
+    size_t *counts = NULL;
+    size_t i;
+
+    /* preconditions */
+    assert( stats != NULL );
+
+    upo_ht_stats_init(stats, upo_ht_sepchain_size(ht), upo_ht_sepchain_capacity(ht));
+    if (ht == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < ht->capacity; ++i)
+    {
+        upo_ht_sepchain_list_node_t *node = NULL;
+        size_t length = 0;
+
+        for (node = ht->slots[i].head; node != NULL; node = node->next)
+        {
+            ++length;
+        }
+        upo_ht_stats_histogram_add(stats->chain_histogram, length);
+        if (length > stats->max_chain_length)
+        {
+            stats->max_chain_length = length;
+        }
+    }
+
+    /* The k-th node of a list (starting from 1) is found after examining k
+     * nodes, so the longest probe is as long as the longest list */
+    stats->max_probe_length = stats->max_chain_length;
+    counts = calloc(stats->max_probe_length + 1, sizeof(size_t));
+    if (counts == NULL)
+    {
+        perror("Unable to allocate memory for hash table statistics");
+        abort();
+    }
+    for (i = 0; i < ht->capacity; ++i)
+    {
+        upo_ht_sepchain_list_node_t *node = NULL;
+        size_t length = 0;
+
+        for (node = ht->slots[i].head; node != NULL; node = node->next)
+        {
+            ++length;
+            counts[length] += 1;
+            upo_ht_stats_histogram_add(stats->probe_histogram, length);
+        }
+    }
+    upo_ht_stats_set_probe_lengths(stats, counts);
+    free(counts);
+
+#ifdef UPO_HT_STATS
+    stats->num_gets = ht->counters.num_gets;
+    stats->num_puts = ht->counters.num_puts;
+    stats->num_deletes = ht->counters.num_deletes;
+    stats->num_probes = ht->counters.num_probes;
+#endif /* UPO_HT_STATS */
+}
+
+void upo_ht_sepchain_reset_stats(upo_ht_sepchain_t ht)
+{
+#ifdef UPO_HT_STATS
+    if (ht != NULL)
+    {
+        memset(&ht->counters, 0, sizeof ht->counters);
+    }
+#else
+    (void) ht;
+#endif /* UPO_HT_STATS */
+}
+
+void upo_ht_linprob_stats(const upo_ht_linprob_t ht, upo_ht_stats_t *stats)
+{
+    size_t *counts = NULL;
+    size_t first_empty = 0;
+    size_t length = 0;
+    size_t i;
+
+    /* preconditions */
+    assert( stats != NULL );
+
+    upo_ht_stats_init(stats, upo_ht_linprob_size(ht), upo_ht_linprob_capacity(ht));
+    if (ht == NULL || ht->capacity == 0)
+    {
+        return;
+    }
+    stats->num_resizes = ht->num_resizes;
+    stats->resize_time = ht->resize_time;
+
+    /* A key stored j slots after its home slot is found after examining j+1
+     * slots (tombstones included) */
+    for (i = 0; i < ht->capacity; ++i)
+    {
+        if (ht->slots[i].key != NULL)
+        {
+            size_t home = upo_ht_hash_to_index(ht->slots[i].hash, ht->capacity);
+            size_t probes = (i + ht->capacity - home) % ht->capacity + 1;
+
+            if (probes > stats->max_probe_length)
+            {
+                stats->max_probe_length = probes;
+            }
+        }
+        else if (ht->slots[i].tombstone)
+        {
+            stats->num_tombstones += 1;
+        }
+    }
+    counts = calloc(stats->max_probe_length + 1, sizeof(size_t));
+    if (counts == NULL)
+    {
+        perror("Unable to allocate memory for hash table statistics");
+        abort();
+    }
+    for (i = 0; i < ht->capacity; ++i)
+    {
+        if (ht->slots[i].key != NULL)
+        {
+            size_t home = upo_ht_hash_to_index(ht->slots[i].hash, ht->capacity);
+            size_t probes = (i + ht->capacity - home) % ht->capacity + 1;
+
+            counts[probes] += 1;
+            upo_ht_stats_histogram_add(stats->probe_histogram, probes);
+        }
+    }
+    upo_ht_stats_set_probe_lengths(stats, counts);
+    free(counts);
+
+    /* Clusters are maximal runs of non-empty slots and may wrap around the
+     * end of the array, so the scan starts right after an empty slot */
+    while (first_empty < ht->capacity && (ht->slots[first_empty].key != NULL || ht->slots[first_empty].tombstone))
+    {
+        ++first_empty;
+    }
+    if (first_empty == ht->capacity)
+    {
+        upo_ht_stats_histogram_add(stats->chain_histogram, ht->capacity);
+        stats->max_chain_length = ht->capacity;
+    }
+    else
+    {
+        for (i = 1; i <= ht->capacity; ++i)
+        {
+            size_t j = (first_empty + i) % ht->capacity;
+
+            if (ht->slots[j].key != NULL || ht->slots[j].tombstone)
+            {
+                ++length;
+            }
+            else if (length > 0)
+            {
+                upo_ht_stats_histogram_add(stats->chain_histogram, length);
+                if (length > stats->max_chain_length)
+                {
+                    stats->max_chain_length = length;
+                }
+                length = 0;
+            }
+        }
+    }
+
+#ifdef UPO_HT_STATS
+    stats->num_gets = ht->counters.num_gets;
+    stats->num_puts = ht->counters.num_puts;
+    stats->num_deletes = ht->counters.num_deletes;
+    stats->num_probes = ht->counters.num_probes;
+#endif /* UPO_HT_STATS */
+}
+
+void upo_ht_linprob_reset_stats(upo_ht_linprob_t ht)
+{
+    if (ht != NULL)
+    {
+        ht->num_resizes = 0;
+        ht->resize_time = 0;
+#ifdef UPO_HT_STATS
+        memset(&ht->counters, 0, sizeof ht->counters);
+#endif /* UPO_HT_STATS */
+    }
+}
+
+
+/*** END of HASH TABLE STATISTICS ***/
+
+
+/*** BEGIN of HASH TABLE with SEPARATE CHAINING and ORDERED LISTS ***/
+
+
+upo_ht_sepchain_olist_t upo_ht_sepchain_olist_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_ht_sepchain_olist_t ht = NULL;
+    size_t i = 0;
+
+    /* preconditions */
+    assert( key_hash != NULL );
+    assert( key_cmp != NULL );
+
+    ht = malloc(sizeof(struct upo_ht_sepchain_olist_s));
+    if (ht == NULL)
+    {
+        perror("Unable to allocate memory for Hash Table with Separate Chaining and Ordered Lists");
+        abort();
+    }
+
+    if (m > 0)
+    {
+        ht->slots = malloc(m*sizeof(upo_ht_sepchain_slot_t));
+        if (ht->slots == NULL)
+        {
+            perror("Unable to allocate memory for slots of the Hash Table with Separate Chaining and Ordered Lists");
+            abort();
+        }
+
+        for (i = 0; i < m; ++i)
+        {
+            ht->slots[i].head = NULL;
+        }
+    }
+    else
+    {
+        ht->slots = NULL;
+    }
+
+    ht->capacity = m;
+    ht->size = 0;
+    ht->key_hash = key_hash;
+    ht->key_cmp = key_cmp;
+    ht->node_pool = upo_pool_create(sizeof(upo_ht_sepchain_list_node_t), UPO_POOL_DEFAULT_CHUNK_CAPACITY);
+
+    return ht;
+}
+
+void upo_ht_sepchain_olist_destroy(upo_ht_sepchain_olist_t ht, int destroy_data)
+{
+    if (ht != NULL)
+    {
+        upo_ht_sepchain_olist_clear(ht, destroy_data);
+        upo_pool_destroy(ht->node_pool);
+        free(ht->slots);
+        free(ht);
+    }
+}
+
+void upo_ht_sepchain_olist_clear(upo_ht_sepchain_olist_t ht, int destroy_data)
+{
+    if (ht != NULL && ht->slots != NULL)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < ht->capacity; ++i)
+        {
+            if (destroy_data)
+            {
+                upo_ht_sepchain_list_node_t *node = NULL;
+
+                for (node = ht->slots[i].head; node != NULL; node = node->next)
+                {
+                    free(node->key);
+                    free(node->value);
+                }
+            }
+            ht->slots[i].head = NULL;
+        }
+        upo_pool_clear(ht->node_pool);
+        ht->size = 0;
+    }
+}
+
+upo_ht_sepchain_list_node_t** upo_ht_sepchain_olist_find(const upo_ht_sepchain_olist_t ht, const void *key, uint64_t hash, int *found)
+{
+    upo_ht_sepchain_list_node_t **link = &ht->slots[upo_ht_hash_to_index(hash, ht->capacity)].head;
+
+    *found = 0;
+
+    /* Nodes are sorted by hash value first, so most steps only compare
+     * integers, and the walk stops at the first node that would follow the
+     * key */
+    while (*link != NULL && (*link)->hash <= hash)
+    {
+        if ((*link)->hash == hash)
+        {
+            int cmp = ht->key_cmp((*link)->key, key);
+
+            if (cmp >= 0)
+            {
+                *found = (cmp == 0);
+                break;
+            }
+        }
+        link = &(*link)->next;
+    }
+
+    return link;
+}
+
+void* upo_ht_sepchain_olist_get(const upo_ht_sepchain_olist_t ht, const void *key)
+{
+    if(ht == NULL) return NULL;
+
+    int found = 0;
+    upo_ht_sepchain_list_node_t **link = upo_ht_sepchain_olist_find(ht, key, ht->key_hash(key), &found);
+
+    return found ? (*link)->value : NULL;
+}
+
+int upo_ht_sepchain_olist_contains(const upo_ht_sepchain_olist_t ht, const void *key)
+{
+    if(ht == NULL) return 0;
+
+    int found = 0;
+
+    upo_ht_sepchain_olist_find(ht, key, ht->key_hash(key), &found);
+
+    return found;
+}
+
+void* upo_ht_sepchain_olist_put(upo_ht_sepchain_olist_t ht, void *key, void *value)
+{
+    if(ht == NULL) return NULL;
+
+    void *old_value = NULL;
+    uint64_t hash = ht->key_hash(key);
+    int found = 0;
+    upo_ht_sepchain_list_node_t **link = upo_ht_sepchain_olist_find(ht, key, hash, &found);
+
+    if(!found) {
+        upo_ht_sepchain_list_node_t *node = upo_pool_alloc(ht->node_pool);
         node->key = key;
         node->value = value;
-        node->next = ht->slots[hash].head;
-        ht->slots[hash].head = node;
+        node->hash = hash;
+        node->next = *link;
+        *link = node;
+        ht->size += 1;
+    }
+    else {
+        old_value = (*link)->value;
+        (*link)->value = value;
+    }
+
+    return old_value;
+}
+
+void upo_ht_sepchain_olist_insert(upo_ht_sepchain_olist_t ht, void *key, void *value)
+{
+    if(ht == NULL) return;
+
+    uint64_t hash = ht->key_hash(key);
+    int found = 0;
+    upo_ht_sepchain_list_node_t **link = upo_ht_sepchain_olist_find(ht, key, hash, &found);
+
+    if(!found) {
+        upo_ht_sepchain_list_node_t *node = upo_pool_alloc(ht->node_pool);
+        node->key = key;
+        node->value = value;
+        node->hash = hash;
+        node->next = *link;
+        *link = node;
+        ht->size += 1;
+    }
+}
+
+void upo_ht_sepchain_olist_delete(upo_ht_sepchain_olist_t ht, const void *key, int destroy_data)
+{
+    if(ht == NULL) return;
+
+    int found = 0;
+    upo_ht_sepchain_list_node_t **link = upo_ht_sepchain_olist_find(ht, key, ht->key_hash(key), &found);
+
+    if(found) {
+        upo_ht_sepchain_list_node_t *node = *link;
+        *link = node->next;
+        if(destroy_data) {
+            free(node->key);
+            free(node->value);
+        }
+        upo_pool_free(ht->node_pool, node);
+        ht->size -= 1;
+    }
+}
+
+size_t upo_ht_sepchain_olist_capacity(const upo_ht_sepchain_olist_t ht)
+{
+    return (ht != NULL) ? ht->capacity : 0;
+}
+
+size_t upo_ht_sepchain_olist_size(const upo_ht_sepchain_olist_t ht)
+{
+    return (ht != NULL) ? ht->size : 0;
+}
+
+double upo_ht_sepchain_olist_load_factor(const upo_ht_sepchain_olist_t ht)
+{
+    return upo_ht_sepchain_olist_size(ht) / (double) upo_ht_sepchain_olist_capacity(ht);
+}
+
+int upo_ht_sepchain_olist_is_empty(const upo_ht_sepchain_olist_t ht)
+{
+    return (ht == NULL || ht->size == 0) ? 1 : 0;
+}
+
+
+/*** END of HASH TABLE with SEPARATE CHAINING and ORDERED LISTS ***/
+
+
+/*** BEGIN of HASH TABLE with CUCKOO HASHING ***/
+
+
+upo_ht_cuckoo_t upo_ht_cuckoo_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_ht_cuckoo_t ht = NULL;
+    size_t num_buckets = 1;
+
+    /* preconditions */
+    assert( key_hash != NULL );
+    assert( key_cmp != NULL );
+
+    ht = malloc(sizeof(struct upo_ht_cuckoo_s));
+    if (ht == NULL)
+    {
+        perror("Unable to allocate memory for Hash Table with Cuckoo Hashing");
+        abort();
+    }
+
+    while (num_buckets*UPO_HT_CUCKOO_BUCKET_SIZE < m)
+    {
+        num_buckets *= 2;
+    }
+
+    ht->buckets = upo_ht_cuckoo_create_buckets(num_buckets);
+    ht->num_buckets = num_buckets;
+    ht->size = 0;
+    ht->stash = malloc(UPO_HT_CUCKOO_STASH_SIZE*sizeof(upo_ht_cuckoo_stash_slot_t));
+    if (ht->stash == NULL)
+    {
+        perror("Unable to allocate memory for the stash of Hash Table with Cuckoo Hashing");
+        abort();
+    }
+    ht->stash_size = 0;
+    ht->stash_capacity = UPO_HT_CUCKOO_STASH_SIZE;
+    ht->key_hash = key_hash;
+    ht->key_cmp = key_cmp;
+
+    return ht;
+}
+
+upo_ht_cuckoo_bucket_t* upo_ht_cuckoo_create_buckets(size_t num_buckets)
+{
+    upo_ht_cuckoo_bucket_t *buckets = NULL;
+    size_t i;
+    size_t j;
+
+    buckets = malloc(num_buckets*sizeof(upo_ht_cuckoo_bucket_t));
+    if (buckets == NULL)
+    {
+        perror("Unable to allocate memory for buckets of the Hash Table with Cuckoo Hashing");
+        abort();
+    }
+    for (i = 0; i < num_buckets; ++i)
+    {
+        for (j = 0; j < UPO_HT_CUCKOO_BUCKET_SIZE; ++j)
+        {
+            buckets[i].hashes[j] = 0;
+            buckets[i].keys[j] = NULL;
+            buckets[i].values[j] = NULL;
+        }
+    }
+
+    return buckets;
+}
+
+void upo_ht_cuckoo_destroy(upo_ht_cuckoo_t ht, int destroy_data)
+{
+    if (ht != NULL)
+    {
+        upo_ht_cuckoo_clear(ht, destroy_data);
+        free(ht->stash);
+        free(ht->buckets);
+        free(ht);
+    }
+}
+
+void upo_ht_cuckoo_clear(upo_ht_cuckoo_t ht, int destroy_data)
+{
+    if (ht != NULL)
+    {
+        size_t i;
+        size_t j;
+
+        for (i = 0; i < ht->num_buckets; ++i)
+        {
+            for (j = 0; j < UPO_HT_CUCKOO_BUCKET_SIZE; ++j)
+            {
+                if (ht->buckets[i].keys[j] != NULL)
+                {
+                    if (destroy_data)
+                    {
+                        free(ht->buckets[i].keys[j]);
+                        free(ht->buckets[i].values[j]);
+                    }
+                    ht->buckets[i].keys[j] = NULL;
+                    ht->buckets[i].values[j] = NULL;
+                }
+            }
+        }
+        for (i = 0; i < ht->stash_size; ++i)
+        {
+            if (destroy_data)
+            {
+                free(ht->stash[i].key);
+                free(ht->stash[i].value);
+            }
+            ht->stash[i].key = NULL;
+            ht->stash[i].value = NULL;
+        }
+        ht->stash_size = 0;
+        ht->size = 0;
+    }
+}
+
+size_t upo_ht_cuckoo_bucket1(uint64_t hash, size_t num_buckets)
+{
+    return hash & (num_buckets - 1);
+}
+
+size_t upo_ht_cuckoo_bucket2(uint64_t hash, size_t num_buckets)
+{
+    size_t b1 = upo_ht_cuckoo_bucket1(hash, num_buckets);
+    size_t b2 = 0;
+
+    /* The bits of the first bucket are spread over the whole word (as in
+     * the finalizer of MurmurHash3), so that the second bucket does not
+     * depend only on them */
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    b2 = hash & (num_buckets - 1);
+
+    if (b2 == b1 && num_buckets > 1)
+    {
+        b2 = b1 ^ 1;
+    }
+
+    return b2;
+}
+
+size_t upo_ht_cuckoo_bucket_find(const upo_ht_cuckoo_t ht, const upo_ht_cuckoo_bucket_t *bucket, const void *key, uint64_t hash)
+{
+    size_t i;
+
+    for (i = 0; i < UPO_HT_CUCKOO_BUCKET_SIZE; ++i)
+    {
+        if (bucket->hashes[i] == hash && bucket->keys[i] != NULL && ht->key_cmp(key, bucket->keys[i]) == 0)
+        {
+            return i;
+        }
+    }
+
+    return UPO_HT_CUCKOO_BUCKET_SIZE;
+}
+
+size_t upo_ht_cuckoo_bucket_find_empty(const upo_ht_cuckoo_bucket_t *bucket)
+{
+    size_t i;
+
+    for (i = 0; i < UPO_HT_CUCKOO_BUCKET_SIZE; ++i)
+    {
+        if (bucket->keys[i] == NULL)
+        {
+            return i;
+        }
+    }
+
+    return UPO_HT_CUCKOO_BUCKET_SIZE;
+}
+
+int upo_ht_cuckoo_find(const upo_ht_cuckoo_t ht, const void *key, uint64_t hash, size_t *bucket, size_t *slot)
+{
+    size_t b1 = upo_ht_cuckoo_bucket1(hash, ht->num_buckets);
+    size_t b2 = upo_ht_cuckoo_bucket2(hash, ht->num_buckets);
+    size_t i;
+
+    /* Both buckets are fetched at once, so that a lookup pays for at most
+     * one cache miss latency */
+    UPO_HT_PREFETCH(&ht->buckets[b1]);
+    UPO_HT_PREFETCH(&ht->buckets[b2]);
+
+    i = upo_ht_cuckoo_bucket_find(ht, &ht->buckets[b1], key, hash);
+    if (i < UPO_HT_CUCKOO_BUCKET_SIZE)
+    {
+        *bucket = b1;
+        *slot = i;
+        return 1;
+    }
+    i = upo_ht_cuckoo_bucket_find(ht, &ht->buckets[b2], key, hash);
+    if (i < UPO_HT_CUCKOO_BUCKET_SIZE)
+    {
+        *bucket = b2;
+        *slot = i;
+        return 1;
+    }
+    for (i = 0; i < ht->stash_size; ++i)
+    {
+        if (ht->stash[i].hash == hash && ht->key_cmp(key, ht->stash[i].key) == 0)
+        {
+            *bucket = SIZE_MAX;
+            *slot = i;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int upo_ht_cuckoo_make_room(upo_ht_cuckoo_t ht, size_t b1, size_t b2, size_t *bucket, size_t *slot)
+{
+    upo_ht_cuckoo_bfs_node_t queue[UPO_HT_CUCKOO_MAX_BFS_BUCKETS];
+    size_t head = 0;
+    size_t tail = 0;
+
+    queue[tail].bucket = b1;
+    queue[tail].parent = SIZE_MAX;
+    queue[tail].slot = 0;
+    queue[tail].depth = 0;
+    ++tail;
+    if (b2 != b1)
+    {
+        queue[tail] = queue[0];
+        queue[tail].bucket = b2;
+        ++tail;
+    }
+
+    for (head = 0; head < tail; ++head)
+    {
+        const upo_ht_cuckoo_bucket_t *from = &ht->buckets[queue[head].bucket];
+        size_t s = upo_ht_cuckoo_bucket_find_empty(from);
+        size_t i;
+
+        if (s < UPO_HT_CUCKOO_BUCKET_SIZE)
+        {
+            size_t cur = head;
+
+            /* Move keys backwards along the path, so that each key goes to
+             * the slot that has just been freed by the previous move */
+            while (queue[cur].parent != SIZE_MAX)
+            {
+                upo_ht_cuckoo_bucket_t *src = &ht->buckets[queue[queue[cur].parent].bucket];
+                upo_ht_cuckoo_bucket_t *dst = &ht->buckets[queue[cur].bucket];
+                size_t src_slot = queue[cur].slot;
+
+                dst->keys[s] = src->keys[src_slot];
+                dst->values[s] = src->values[src_slot];
+                dst->hashes[s] = src->hashes[src_slot];
+                src->keys[src_slot] = NULL;
+                src->values[src_slot] = NULL;
+                s = src_slot;
+                cur = queue[cur].parent;
+            }
+            *bucket = queue[cur].bucket;
+            *slot = s;
+            return 1;
+        }
+
+        if (queue[head].depth == UPO_HT_CUCKOO_MAX_PATH_LENGTH)
+        {
+            continue;
+        }
+
+        /* Every key of a full bucket may move to its other bucket */
+        for (i = 0; i < UPO_HT_CUCKOO_BUCKET_SIZE && tail < UPO_HT_CUCKOO_MAX_BFS_BUCKETS; ++i)
+        {
+            uint64_t hash = from->hashes[i];
+            size_t alt = upo_ht_cuckoo_bucket1(hash, ht->num_buckets);
+            size_t k;
+            int on_path = 0;
+
+            if (alt == queue[head].bucket)
+            {
+                alt = upo_ht_cuckoo_bucket2(hash, ht->num_buckets);
+            }
+            /* A bucket must not appear twice on a path, otherwise a move
+             * could overwrite a key that has still to be moved */
+            for (k = head; k != SIZE_MAX && !on_path; k = queue[k].parent)
+            {
+                on_path = (queue[k].bucket == alt);
+            }
+            if (!on_path)
+            {
+                queue[tail].bucket = alt;
+                queue[tail].parent = head;
+                queue[tail].slot = i;
+                queue[tail].depth = queue[head].depth + 1;
+                ++tail;
+            }
+        }
+    }
+
+    return 0;
+}
+
+int upo_ht_cuckoo_place(upo_ht_cuckoo_t ht, void *key, void *value, uint64_t hash)
+{
+    size_t b1 = upo_ht_cuckoo_bucket1(hash, ht->num_buckets);
+    size_t b2 = upo_ht_cuckoo_bucket2(hash, ht->num_buckets);
+    size_t b = b1;
+    size_t s = upo_ht_cuckoo_bucket_find_empty(&ht->buckets[b1]);
+
+    if (s == UPO_HT_CUCKOO_BUCKET_SIZE)
+    {
+        b = b2;
+        s = upo_ht_cuckoo_bucket_find_empty(&ht->buckets[b2]);
+    }
+    if (s == UPO_HT_CUCKOO_BUCKET_SIZE && !upo_ht_cuckoo_make_room(ht, b1, b2, &b, &s))
+    {
+        if (ht->stash_size >= UPO_HT_CUCKOO_STASH_SIZE)
+        {
+            return 0;
+        }
+        upo_ht_cuckoo_stash_push(ht, key, value, hash);
+        return 1;
+    }
+
+    ht->buckets[b].keys[s] = key;
+    ht->buckets[b].values[s] = value;
+    ht->buckets[b].hashes[s] = hash;
+    ht->size += 1;
+
+    return 1;
+}
+
+void upo_ht_cuckoo_stash_push(upo_ht_cuckoo_t ht, void *key, void *value, uint64_t hash)
+{
+    if (ht->stash_size == ht->stash_capacity)
+    {
+        size_t capacity = 2*ht->stash_capacity;
+        upo_ht_cuckoo_stash_slot_t *stash = realloc(ht->stash, capacity*sizeof(upo_ht_cuckoo_stash_slot_t));
+
+        if (stash == NULL)
+        {
+            perror("Unable to allocate memory for the overflow area of Hash Table with Cuckoo Hashing");
+            abort();
+        }
+        ht->stash = stash;
+        ht->stash_capacity = capacity;
+    }
+    ht->stash[ht->stash_size].key = key;
+    ht->stash[ht->stash_size].value = value;
+    ht->stash[ht->stash_size].hash = hash;
+    ht->stash_size += 1;
+    ht->size += 1;
+}
+
+void upo_ht_cuckoo_add(upo_ht_cuckoo_t ht, void *key, void *value, uint64_t hash)
+{
+    if (upo_ht_cuckoo_place(ht, key, value, hash))
+    {
+        return;
+    }
+    /* If the buckets are mostly empty, the key does not fit because of
+     * collisions rather than of the load, and a resize does not help */
+    if (upo_ht_cuckoo_capacity(ht) <= UPO_HT_CUCKOO_MAX_GROWTH*(ht->size - ht->stash_size + 1))
+    {
+        upo_ht_cuckoo_resize(ht, 2*ht->num_buckets);
+        if (upo_ht_cuckoo_place(ht, key, value, hash))
+        {
+            return;
+        }
+    }
+    upo_ht_cuckoo_stash_push(ht, key, value, hash);
+}
+
+void upo_ht_cuckoo_drain_stash(upo_ht_cuckoo_t ht)
+{
+    size_t i = ht->stash_size;
+
+    /* Scan backwards, so that the last pair can replace a moved one */
+    while (i > 0)
+    {
+        upo_ht_cuckoo_stash_slot_t *entry = &ht->stash[--i];
+        size_t b = upo_ht_cuckoo_bucket1(entry->hash, ht->num_buckets);
+        size_t s = upo_ht_cuckoo_bucket_find_empty(&ht->buckets[b]);
+
+        if (s == UPO_HT_CUCKOO_BUCKET_SIZE)
+        {
+            b = upo_ht_cuckoo_bucket2(entry->hash, ht->num_buckets);
+            s = upo_ht_cuckoo_bucket_find_empty(&ht->buckets[b]);
+        }
+        if (s < UPO_HT_CUCKOO_BUCKET_SIZE)
+        {
+            ht->buckets[b].keys[s] = entry->key;
+            ht->buckets[b].values[s] = entry->value;
+            ht->buckets[b].hashes[s] = entry->hash;
+            ht->stash_size -= 1;
+            *entry = ht->stash[ht->stash_size];
+            ht->stash[ht->stash_size].key = NULL;
+            ht->stash[ht->stash_size].value = NULL;
+        }
+    }
+}
+
+void upo_ht_cuckoo_resize(upo_ht_cuckoo_t ht, size_t num_buckets)
+{
+    upo_ht_cuckoo_bucket_t *old_buckets = ht->buckets;
+    size_t old_num_buckets = ht->num_buckets;
+    upo_ht_cuckoo_stash_slot_t *old_stash = ht->stash;
+    size_t old_stash_size = ht->stash_size;
+    size_t old_size = ht->size;
+    size_t i;
+    size_t j;
+
+    ht->buckets = upo_ht_cuckoo_create_buckets(num_buckets);
+    ht->num_buckets = num_buckets;
+    ht->size = 0;
+    ht->stash = malloc(UPO_HT_CUCKOO_STASH_SIZE*sizeof(upo_ht_cuckoo_stash_slot_t));
+    if (ht->stash == NULL)
+    {
+        perror("Unable to allocate memory for the stash of Hash Table with Cuckoo Hashing");
+        abort();
+    }
+    ht->stash_size = 0;
+    ht->stash_capacity = UPO_HT_CUCKOO_STASH_SIZE;
+
+    /* Keys are not hashed again since their full hash value is cached; keys
+     * that still do not fit go to the overflow area, rather than doubling
+     * the table again */
+    for (i = 0; i < old_num_buckets; ++i)
+    {
+        for (j = 0; j < UPO_HT_CUCKOO_BUCKET_SIZE; ++j)
+        {
+            if (old_buckets[i].keys[j] != NULL && !upo_ht_cuckoo_place(ht, old_buckets[i].keys[j], old_buckets[i].values[j], old_buckets[i].hashes[j]))
+            {
+                upo_ht_cuckoo_stash_push(ht, old_buckets[i].keys[j], old_buckets[i].values[j], old_buckets[i].hashes[j]);
+            }
+        }
+    }
+    for (i = 0; i < old_stash_size; ++i)
+    {
+        if (!upo_ht_cuckoo_place(ht, old_stash[i].key, old_stash[i].value, old_stash[i].hash))
+        {
+            upo_ht_cuckoo_stash_push(ht, old_stash[i].key, old_stash[i].value, old_stash[i].hash);
+        }
+    }
+
+    assert( ht->size == old_size );
+
+    free(old_stash);
+    free(old_buckets);
+}
+
+void* upo_ht_cuckoo_put(upo_ht_cuckoo_t ht, void *key, void *value)
+{
+    void *old_value = NULL;
+    uint64_t hash = 0;
+    size_t b = 0;
+    size_t s = 0;
+
+    if (ht == NULL)
+    {
+        return NULL;
+    }
+
+    hash = ht->key_hash(key);
+    if (upo_ht_cuckoo_find(ht, key, hash, &b, &s))
+    {
+        if (b == SIZE_MAX)
+        {
+            old_value = ht->stash[s].value;
+            ht->stash[s].value = value;
+        }
+        else
+        {
+            old_value = ht->buckets[b].values[s];
+            ht->buckets[b].values[s] = value;
+        }
+        return old_value;
+    }
+
+    upo_ht_cuckoo_add(ht, key, value, hash);
+
+    return NULL;
+}
+
+void upo_ht_cuckoo_insert(upo_ht_cuckoo_t ht, void *key, void *value)
+{
+    uint64_t hash = 0;
+    size_t b = 0;
+    size_t s = 0;
+
+    if (ht == NULL)
+    {
+        return;
+    }
+
+    hash = ht->key_hash(key);
+    if (!upo_ht_cuckoo_find(ht, key, hash, &b, &s))
+    {
+        upo_ht_cuckoo_add(ht, key, value, hash);
+    }
+}
+
+void* upo_ht_cuckoo_get(const upo_ht_cuckoo_t ht, const void *key)
+{
+    size_t b = 0;
+    size_t s = 0;
+
+    if (ht == NULL || !upo_ht_cuckoo_find(ht, key, ht->key_hash(key), &b, &s))
+    {
+        return NULL;
+    }
+
+    return (b == SIZE_MAX) ? ht->stash[s].value : ht->buckets[b].values[s];
+}
+
+int upo_ht_cuckoo_contains(const upo_ht_cuckoo_t ht, const void *key)
+{
+    size_t b = 0;
+    size_t s = 0;
+
+    return ht != NULL && upo_ht_cuckoo_find(ht, key, ht->key_hash(key), &b, &s);
+}
+
+void upo_ht_cuckoo_delete(upo_ht_cuckoo_t ht, const void *key, int destroy_data)
+{
+    size_t b = 0;
+    size_t s = 0;
+
+    if (ht == NULL || !upo_ht_cuckoo_find(ht, key, ht->key_hash(key), &b, &s))
+    {
+        return;
+    }
+
+    if (b == SIZE_MAX)
+    {
+        if (destroy_data)
+        {
+            free(ht->stash[s].key);
+            free(ht->stash[s].value);
+        }
+        ht->stash_size -= 1;
+        ht->stash[s] = ht->stash[ht->stash_size];
+        ht->stash[ht->stash_size].key = NULL;
+        ht->stash[ht->stash_size].value = NULL;
+    }
+    else
+    {
+        if (destroy_data)
+        {
+            free(ht->buckets[b].keys[s]);
+            free(ht->buckets[b].values[s]);
+        }
+        ht->buckets[b].keys[s] = NULL;
+        ht->buckets[b].values[s] = NULL;
+        /* The freed slot may be a candidate for keys waiting in the stash */
+        if (ht->stash_size > 0)
+        {
+            upo_ht_cuckoo_drain_stash(ht);
+        }
+    }
+    ht->size -= 1;
+}
+
+size_t upo_ht_cuckoo_capacity(const upo_ht_cuckoo_t ht)
+{
+    return (ht != NULL) ? ht->num_buckets*UPO_HT_CUCKOO_BUCKET_SIZE : 0;
+}
+
+size_t upo_ht_cuckoo_size(const upo_ht_cuckoo_t ht)
+{
+    return (ht != NULL) ? ht->size : 0;
+}
+
+double upo_ht_cuckoo_load_factor(const upo_ht_cuckoo_t ht)
+{
+    return upo_ht_cuckoo_size(ht) / (double) upo_ht_cuckoo_capacity(ht);
+}
+
+int upo_ht_cuckoo_is_empty(const upo_ht_cuckoo_t ht)
+{
+    return upo_ht_cuckoo_size(ht) == 0 ? 1 : 0;
+}
+
+size_t upo_ht_cuckoo_stash_size(const upo_ht_cuckoo_t ht)
+{
+    return (ht != NULL) ? ht->stash_size : 0;
+}
+
+void upo_ht_cuckoo_traverse(const upo_ht_cuckoo_t ht, upo_ht_visitor_t visit, void *visit_context)
+{
+    if (ht != NULL)
+    {
+        size_t i;
+        size_t j;
+
+        for (i = 0; i < ht->num_buckets; ++i)
+        {
+            for (j = 0; j < UPO_HT_CUCKOO_BUCKET_SIZE; ++j)
+            {
+                if (ht->buckets[i].keys[j] != NULL)
+                {
+                    visit(ht->buckets[i].keys[j], ht->buckets[i].values[j], visit_context);
+                }
+            }
+        }
+        for (i = 0; i < ht->stash_size; ++i)
+        {
+            visit(ht->stash[i].key, ht->stash[i].value, visit_context);
+        }
+    }
+}
+
+
+/*** END of HASH TABLE with CUCKOO HASHING ***/
+
+
+/*** BEGIN of HASH TABLE with LINEAR PROBING and INLINE KEYS ***/
+
+
+upo_ht_inline_t upo_ht_inline_create(size_t m, size_t key_size, size_t value_size, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_ht_inline_t ht = NULL;
+    size_t key_align = upo_ht_inline_alignment(key_size);
+    size_t value_align = upo_ht_inline_alignment(value_size);
+    size_t slot_align = (key_align > value_align) ? key_align : value_align;
+    size_t capacity = UPO_HT_INLINE_MIN_CAPACITY;
+
+    /* preconditions */
+    assert( key_size > 0 && key_size <= UPO_HT_INLINE_MAX_SIZE );
+    assert( value_size <= UPO_HT_INLINE_MAX_SIZE );
+
+    ht = malloc(sizeof(struct upo_ht_inline_s));
+    if (ht == NULL)
+    {
+        perror("Unable to allocate memory for Hash Table with Linear Probing and Inline Keys");
+        abort();
     }
-    else {
-        old_value = node->value;
-        node->value = value;
+
+    /* Values are aligned according to their size, so that the pointers
+     * returned by get can be dereferenced as the type of values */
+    ht->key_size = key_size;
+    ht->value_size = value_size;
+    ht->value_offset = (key_size + value_align - 1) / value_align * value_align;
+    ht->slot_size = (ht->value_offset + value_size + slot_align - 1) / slot_align * slot_align;
+    ht->key_hash = key_hash;
+    ht->key_cmp = key_cmp;
+    ht->size = 0;
+
+    while (capacity < m)
+    {
+        capacity *= 2;
     }
+    upo_ht_inline_create_slots(ht, capacity);
 
-    return old_value;
+    return ht;
+}
+
+size_t upo_ht_inline_alignment(size_t size)
+{
+    size_t align = 1;
+
+    while (size > 0 && align < 8 && size % (2*align) == 0)
+    {
+        align *= 2;
+    }
+
+    return align;
+}
+
+void upo_ht_inline_create_slots(upo_ht_inline_t ht, size_t capacity)
+{
+    ht->ctrl = malloc(capacity);
+    ht->slots = malloc(capacity*ht->slot_size);
+    if (ht->ctrl == NULL || ht->slots == NULL)
+    {
+        perror("Unable to allocate memory for slots of the Hash Table with Linear Probing and Inline Keys");
+        abort();
+    }
+    memset(ht->ctrl, UPO_HT_INLINE_EMPTY, capacity);
+    ht->capacity = capacity;
+}
+
+void upo_ht_inline_destroy(upo_ht_inline_t ht)
+{
+    if (ht != NULL)
+    {
+        free(ht->slots);
+        free(ht->ctrl);
+        free(ht);
+    }
+}
+
+void upo_ht_inline_clear(upo_ht_inline_t ht)
+{
+    if (ht != NULL)
+    {
+        memset(ht->ctrl, UPO_HT_INLINE_EMPTY, ht->capacity);
+        ht->size = 0;
+    }
 }
 
-void upo_ht_sepchain_olist_insert(upo_ht_sepchain_olist_t ht, void *key, void *value);
+uint64_t upo_ht_inline_hash(const upo_ht_inline_t ht, const void *key)
+{
+    uint32_t k32 = 0;
+    uint64_t k64 = 0;
 
-void upo_ht_sepchain_olist_delete(upo_ht_sepchain_olist_t ht, const void *key, int destroy_data);
+    if (ht->key_hash != NULL)
+    {
+        return ht->key_hash(key);
+    }
 
-size_t upo_ht_sepchain_olist_capacity(const upo_ht_sepchain_olist_t ht);
+    /* Integer keys are mixed directly, without looping over their bytes.
+     * Note: for `int` keys, this is the same as upo_ht_hash_int_mix(). */
+    switch (ht->key_size)
+    {
+        case sizeof(uint32_t):
+            memcpy(&k32, key, sizeof k32);
+            return upo_ht_hash_mix64(k32);
+        case sizeof(uint64_t):
+            memcpy(&k64, key, sizeof k64);
+            return upo_ht_hash_mix64(k64);
+        default:
+            return upo_ht_hash_bytes(key, ht->key_size, 0);
+    }
+}
 
-size_t upo_ht_sepchain_olist_size(const upo_ht_sepchain_olist_t ht);
+unsigned char upo_ht_inline_h2(uint64_t hash)
+{
+    /* The most significant bits are used, since the least significant ones
+     * select the home slot and so are mostly the same along a probe sequence */
+    return (unsigned char) (hash >> 57);
+}
 
-double upo_ht_sepchain_olist_load_factor(const upo_ht_sepchain_olist_t ht);
+int upo_ht_inline_key_equals(const upo_ht_inline_t ht, const void *key1, const void *key2)
+{
+    uint64_t a[2] = {0, 0};
+    uint64_t b[2] = {0, 0};
 
-int upo_ht_sepchain_olist_is_empty(const upo_ht_sepchain_olist_t ht);
+    if (ht->key_cmp != NULL)
+    {
+        return ht->key_cmp(key1, key2) == 0;
+    }
 
+    /* Fixed-size copies compile to plain loads, unlike a memcmp() with a
+     * size only known at run time */
+    switch (ht->key_size)
+    {
+        case sizeof(uint32_t):
+            memcpy(a, key1, sizeof(uint32_t));
+            memcpy(b, key2, sizeof(uint32_t));
+            return a[0] == b[0];
+        case sizeof(uint64_t):
+            memcpy(a, key1, sizeof(uint64_t));
+            memcpy(b, key2, sizeof(uint64_t));
+            return a[0] == b[0];
+        case 2*sizeof(uint64_t):
+            memcpy(a, key1, 2*sizeof(uint64_t));
+            memcpy(b, key2, 2*sizeof(uint64_t));
+            return a[0] == b[0] && a[1] == b[1];
+        default:
+            return memcmp(key1, key2, ht->key_size) == 0;
+    }
+}
 
-/*** END of HASH TABLE with SEPARATE CHAINING and ORDERED LISTS ***/
+int upo_ht_inline_find(const upo_ht_inline_t ht, const void *key, uint64_t hash, size_t *index)
+{
+    size_t mask = ht->capacity - 1;
+    size_t i = hash & mask;
+    unsigned char h2 = upo_ht_inline_h2(hash);
+
+    /* The load factor is kept below 1, so an empty slot is always found */
+    while (ht->ctrl[i] != UPO_HT_INLINE_EMPTY)
+    {
+        if (ht->ctrl[i] == h2 && upo_ht_inline_key_equals(ht, key, ht->slots + i*ht->slot_size))
+        {
+            *index = i;
+            return 1;
+        }
+        i = (i + 1) & mask;
+    }
+    *index = i;
+
+    return 0;
+}
+
+void upo_ht_inline_resize(upo_ht_inline_t ht, size_t capacity)
+{
+    unsigned char *old_ctrl = ht->ctrl;
+    unsigned char *old_slots = ht->slots;
+    size_t old_capacity = ht->capacity;
+    size_t mask = capacity - 1;
+    size_t i;
+
+    upo_ht_inline_create_slots(ht, capacity);
+
+    /* Keys are hashed again since hash values are not stored, but they are
+     * known to be distinct, so no comparison is needed to find their slot */
+    for (i = 0; i < old_capacity; ++i)
+    {
+        if (old_ctrl[i] != UPO_HT_INLINE_EMPTY)
+        {
+            const unsigned char *slot = old_slots + i*ht->slot_size;
+            size_t j = upo_ht_inline_hash(ht, slot) & mask;
+
+            while (ht->ctrl[j] != UPO_HT_INLINE_EMPTY)
+            {
+                j = (j + 1) & mask;
+            }
+            ht->ctrl[j] = old_ctrl[i];
+            memcpy(ht->slots + j*ht->slot_size, slot, ht->slot_size);
+        }
+    }
+
+    free(old_slots);
+    free(old_ctrl);
+}
+
+void* upo_ht_inline_get(const upo_ht_inline_t ht, const void *key)
+{
+    size_t i = 0;
+
+    if (ht == NULL || !upo_ht_inline_find(ht, key, upo_ht_inline_hash(ht, key), &i))
+    {
+        return NULL;
+    }
+
+    return ht->slots + i*ht->slot_size + ht->value_offset;
+}
+
+int upo_ht_inline_contains(const upo_ht_inline_t ht, const void *key)
+{
+    size_t i = 0;
+
+    return ht != NULL && upo_ht_inline_find(ht, key, upo_ht_inline_hash(ht, key), &i);
+}
+
+int upo_ht_inline_put(upo_ht_inline_t ht, const void *key, const void *value)
+{
+    uint64_t hash = 0;
+    size_t i = 0;
+
+    if (ht == NULL)
+    {
+        return 0;
+    }
+
+    hash = upo_ht_inline_hash(ht, key);
+    if (upo_ht_inline_find(ht, key, hash, &i))
+    {
+        if (ht->value_size > 0)
+        {
+            memcpy(ht->slots + i*ht->slot_size + ht->value_offset, value, ht->value_size);
+        }
+        return 1;
+    }
+
+    if (ht->size + 1 > UPO_HT_INLINE_MAX_LOAD_FACTOR*ht->capacity)
+    {
+        upo_ht_inline_resize(ht, 2*ht->capacity);
+        upo_ht_inline_find(ht, key, hash, &i);
+    }
+
+    ht->ctrl[i] = upo_ht_inline_h2(hash);
+    memcpy(ht->slots + i*ht->slot_size, key, ht->key_size);
+    if (ht->value_size > 0)
+    {
+        memcpy(ht->slots + i*ht->slot_size + ht->value_offset, value, ht->value_size);
+    }
+    ht->size += 1;
+
+    return 0;
+}
+
+void upo_ht_inline_insert(upo_ht_inline_t ht, const void *key, const void *value)
+{
+    if (!upo_ht_inline_contains(ht, key))
+    {
+        upo_ht_inline_put(ht, key, value);
+    }
+}
+
+void upo_ht_inline_delete(upo_ht_inline_t ht, const void *key)
+{
+    size_t mask = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    if (ht == NULL || !upo_ht_inline_find(ht, key, upo_ht_inline_hash(ht, key), &i))
+    {
+        return;
+    }
+
+    /* Shift back the following keys of the cluster that would no longer be
+     * reachable from their home slot once slot i is empty (Knuth's
+     * Algorithm R) */
+    mask = ht->capacity - 1;
+    for (j = (i + 1) & mask; ht->ctrl[j] != UPO_HT_INLINE_EMPTY; j = (j + 1) & mask)
+    {
+        size_t home = upo_ht_inline_hash(ht, ht->slots + j*ht->slot_size) & mask;
+
+        /* The key in slot j can move to slot i unless its home slot lies
+         * cyclically in (i, j] */
+        if (((j - home) & mask) >= ((j - i) & mask))
+        {
+            ht->ctrl[i] = ht->ctrl[j];
+            memcpy(ht->slots + i*ht->slot_size, ht->slots + j*ht->slot_size, ht->slot_size);
+            i = j;
+        }
+    }
+    ht->ctrl[i] = UPO_HT_INLINE_EMPTY;
+    ht->size -= 1;
+
+    if (ht->capacity > UPO_HT_INLINE_MIN_CAPACITY && ht->size <= ht->capacity/8)
+    {
+        upo_ht_inline_resize(ht, ht->capacity/2);
+    }
+}
+
+size_t upo_ht_inline_capacity(const upo_ht_inline_t ht)
+{
+    return (ht != NULL) ? ht->capacity : 0;
+}
+
+size_t upo_ht_inline_size(const upo_ht_inline_t ht)
+{
+    return (ht != NULL) ? ht->size : 0;
+}
+
+double upo_ht_inline_load_factor(const upo_ht_inline_t ht)
+{
+    return upo_ht_inline_size(ht) / (double) upo_ht_inline_capacity(ht);
+}
+
+int upo_ht_inline_is_empty(const upo_ht_inline_t ht)
+{
+    return upo_ht_inline_size(ht) == 0 ? 1 : 0;
+}
+
+size_t upo_ht_inline_memory_usage(const upo_ht_inline_t ht)
+{
+    return (ht != NULL) ? ht->capacity*(ht->slot_size + 1) : 0;
+}
+
+void upo_ht_inline_traverse(const upo_ht_inline_t ht, upo_ht_visitor_t visit, void *visit_context)
+{
+    if (ht != NULL)
+    {
+        size_t i;
+
+        for (i = 0; i < ht->capacity; ++i)
+        {
+            if (ht->ctrl[i] != UPO_HT_INLINE_EMPTY)
+            {
+                unsigned char *slot = ht->slots + i*ht->slot_size;
+
+                visit(slot, (ht->value_size > 0) ? slot + ht->value_offset : NULL, visit_context);
+            }
+        }
+    }
+}
+
+
+/*** END of HASH TABLE with LINEAR PROBING and INLINE KEYS ***/
 
 
 /*** BEGIN of HASH FUNCTIONS ***/
 
 
-size_t upo_ht_hash_int_div(const void *x, size_t m)
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 upo_ht_uint128_t;
+#endif
+
+void upo_ht_hash_mul128(uint64_t a, uint64_t b, uint64_t *lo, uint64_t *hi)
+{
+#if defined(__SIZEOF_INT128__)
+    upo_ht_uint128_t r = (upo_ht_uint128_t) a * b;
+
+    *lo = (uint64_t) r;
+    *hi = (uint64_t) (r >> 64);
+#else
+    uint64_t a_lo = a & 0xFFFFFFFFU;
+    uint64_t a_hi = a >> 32;
+    uint64_t b_lo = b & 0xFFFFFFFFU;
+    uint64_t b_hi = b >> 32;
+    uint64_t ll = a_lo * b_lo;
+    uint64_t lh = a_lo * b_hi;
+    uint64_t hl = a_hi * b_lo;
+    uint64_t hh = a_hi * b_hi;
+    uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFU) + (hl & 0xFFFFFFFFU);
+
+    *lo = (mid << 32) | (ll & 0xFFFFFFFFU);
+    *hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+uint64_t upo_ht_hash_mum(uint64_t a, uint64_t b)
+{
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+
+    upo_ht_hash_mul128(a, b, &lo, &hi);
+
+    return lo ^ hi;
+}
+
+uint64_t upo_ht_hash_read64(const unsigned char *p)
+{
+    uint64_t v = 0;
+
+    memcpy(&v, p, sizeof v);
+
+    return v;
+}
+
+uint64_t upo_ht_hash_read32(const unsigned char *p)
+{
+    uint32_t v = 0;
+
+    memcpy(&v, p, sizeof v);
+
+    return v;
+}
+
+uint64_t upo_ht_hash_reverse64(uint64_t x)
+{
+    x = ((x >> 1) & UINT64_C(0x5555555555555555)) | ((x & UINT64_C(0x5555555555555555)) << 1);
+    x = ((x >> 2) & UINT64_C(0x3333333333333333)) | ((x & UINT64_C(0x3333333333333333)) << 2);
+    x = ((x >> 4) & UINT64_C(0x0F0F0F0F0F0F0F0F)) | ((x & UINT64_C(0x0F0F0F0F0F0F0F0F)) << 4);
+    x = ((x >> 8) & UINT64_C(0x00FF00FF00FF00FF)) | ((x & UINT64_C(0x00FF00FF00FF00FF)) << 8);
+    x = ((x >> 16) & UINT64_C(0x0000FFFF0000FFFF)) | ((x & UINT64_C(0x0000FFFF0000FFFF)) << 16);
+
+    return (x >> 32) | (x << 32);
+}
+
+size_t upo_ht_hash_to_index(uint64_t hash, size_t capacity)
+{
+    /* preconditions */
+    assert( capacity > 0 );
+
+    if ((capacity & (capacity - 1)) == 0)
+    {
+        return hash & (capacity - 1);
+    }
+
+    return hash % capacity;
+}
+
+uint64_t upo_ht_hash_int_div(const void *x)
 {
     /* preconditions */
     assert( x != NULL );
-    assert( m > 0 );
 
-    return *((int*) x) % m;
+    return (unsigned int) *((int*) x);
 }
 
 size_t upo_ht_hash_int_mult(const void *x, double a, size_t m)
 {
+    uint64_t frac = 0;
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+
     /* preconditions */
     assert( x != NULL );
     assert( a > 0 && a < 1 );
     assert( m > 0 );
 
-    return floor( m * fmod(a * *((int*) x), 1.0) );
+    /* With a in 64-bit fixed point, the product modulo 2^64 is the
+     * fractional part of a*x, and the high half of m times that fraction is
+     * the floor of their product. */
+    frac = (unsigned int) *((int*) x) * (uint64_t) ldexp(a, 64);
+    upo_ht_hash_mul128(m, frac, &lo, &hi);
+
+    return hi;
 }
 
-size_t upo_ht_hash_int_mult_knuth(const void *x, size_t m)
+uint64_t upo_ht_hash_int_mult_knuth(const void *x)
 {
-    return upo_ht_hash_int_mult(x, 0.5*(sqrt(5)-1), m);
+    /* preconditions */
+    assert( x != NULL );
+
+    /* 0x9E3779B97F4A7C15 is (sqrt(5)-1)/2 as a 64-bit fixed-point number, so
+     * the product modulo 2^64 is the fractional part of a*x.
+     * The method takes the high bits of the fraction, while tables reduce
+     * hash values to their low bits (whose low k bits are zero for multiples
+     * of 2^k): reversing the bits moves the former to the latter. */
+    return upo_ht_hash_reverse64((unsigned int) *((int*) x) * UINT64_C(0x9E3779B97F4A7C15));
 }
 
-size_t upo_ht_hash_str(const void *x, size_t h0, size_t a, size_t m)
+uint64_t upo_ht_hash_str(const void *x, uint64_t h0, uint64_t a)
 {
     const char *s = NULL;
-    size_t h = h0; 
+    uint64_t h = h0;
 
     /* preconditions */
     assert( x != NULL );
-    assert( m > 0 );
-/*
-    assert( a < m );
-*/
-    assert( h0 < m );
 
     s = *((const char**) x);
     for (; *s; ++s)
     {
-        h = (a*h + *s) % m;
+        h = a*h + *s;
     }
 
     return h;
 }
 
-size_t upo_ht_hash_str_djb2(const void *x, size_t m)
+uint64_t upo_ht_hash_str_djb2(const void *x)
 {
-    return upo_ht_hash_str(x, 5381U, 33U, m);
+    return upo_ht_hash_str(x, 5381U, 33U);
 }
 
-size_t upo_ht_hash_str_djb2a(const void *x, size_t m)
+uint64_t upo_ht_hash_str_djb2a(const void *x)
 {
     const char *s = NULL;
-    size_t h = 5381U; 
+    uint64_t h = 5381U;
 
     /* preconditions */
     assert( x != NULL );
-    assert( m > 0 );
 
     s = *((const char**) x);
     for (; *s; ++s)
     {
-        h = (33U*h ^ *s) % m;
+        h = 33U*h ^ *s;
     }
 
     return h;
 }
 
-size_t upo_ht_hash_str_java(const void *x, size_t m)
+uint64_t upo_ht_hash_str_java(const void *x)
+{
+    return upo_ht_hash_str(x, 0U, 31U);
+}
+
+uint64_t upo_ht_hash_str_kr2e(const void *x)
+{
+    return upo_ht_hash_str(x, 0U, 31U);
+}
+
+uint64_t upo_ht_hash_str_sgistl(const void *x)
+{
+    return upo_ht_hash_str(x, 0U, 5U);
+}
+
+uint64_t upo_ht_hash_str_stlport(const void *x)
+{
+    return upo_ht_hash_str(x, 0U, 33U);
+}
+
+uint64_t upo_ht_hash_mix64(uint64_t x)
 {
-    return upo_ht_hash_str(x, 0U, 31U, m);
+    x += UINT64_C(0x9E3779B97F4A7C15);
+    x = (x ^ (x >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    x = (x ^ (x >> 27)) * UINT64_C(0x94D049BB133111EB);
+
+    return x ^ (x >> 31);
 }
 
-size_t upo_ht_hash_str_kr2e(const void *x, size_t m)
+uint64_t upo_ht_hash_int_mix(const void *x)
 {
-    return upo_ht_hash_str(x, 0U, 31U, m);
+    /* preconditions */
+    assert( x != NULL );
+
+    return upo_ht_hash_mix64((unsigned int) *((int*) x));
 }
 
-size_t upo_ht_hash_str_sgistl(const void *x, size_t m)
+uint64_t upo_ht_hash_bytes(const void *data, size_t n, uint64_t seed)
 {
-    return upo_ht_hash_str(x, 0U, 5U, m);
+    static const uint64_t secret[4] = { UINT64_C(0xA0761D6478BD642F),
+                                        UINT64_C(0xE7037ED1A0B428DB),
+                                        UINT64_C(0x8EBC6AF09C88C6E3),
+                                        UINT64_C(0x589965CC75374CC3) };
+    const unsigned char *p = data;
+    uint64_t a = 0;
+    uint64_t b = 0;
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+
+    /* preconditions */
+    assert( data != NULL || n == 0 );
+
+    seed ^= upo_ht_hash_mum(seed ^ secret[0], secret[1]);
+
+    if (n <= 16)
+    {
+        if (n >= 4)
+        {
+            /* Two (possibly overlapping) pairs of 4-byte words cover the
+             * whole input */
+            size_t off = (n >> 3) << 2;
+
+            a = (upo_ht_hash_read32(p) << 32) | upo_ht_hash_read32(p + off);
+            b = (upo_ht_hash_read32(p + n - 4) << 32) | upo_ht_hash_read32(p + n - 4 - off);
+        }
+        else if (n > 0)
+        {
+            a = ((uint64_t) p[0] << 16) | ((uint64_t) p[n >> 1] << 8) | p[n - 1];
+        }
+    }
+    else
+    {
+        size_t i = n;
+
+        if (i > 48)
+        {
+            /* Three independent lanes keep the multipliers busy */
+            uint64_t seed1 = seed;
+            uint64_t seed2 = seed;
+
+            do
+            {
+                seed = upo_ht_hash_mum(upo_ht_hash_read64(p) ^ secret[1], upo_ht_hash_read64(p + 8) ^ seed);
+                seed1 = upo_ht_hash_mum(upo_ht_hash_read64(p + 16) ^ secret[2], upo_ht_hash_read64(p + 24) ^ seed1);
+                seed2 = upo_ht_hash_mum(upo_ht_hash_read64(p + 32) ^ secret[3], upo_ht_hash_read64(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            }
+            while (i > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (i > 16)
+        {
+            seed = upo_ht_hash_mum(upo_ht_hash_read64(p) ^ secret[1], upo_ht_hash_read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        /* The last 16 bytes (possibly overlapping the ones already consumed) */
+        a = upo_ht_hash_read64(p + i - 16);
+        b = upo_ht_hash_read64(p + i - 8);
+    }
+
+    upo_ht_hash_mul128(a ^ secret[1], b ^ seed, &lo, &hi);
+
+    return upo_ht_hash_mum(lo ^ secret[0] ^ n, hi ^ secret[1]);
 }
 
-size_t upo_ht_hash_str_stlport(const void *x, size_t m)
+uint64_t upo_ht_hash_str_wyhash(const void *x)
 {
-    return upo_ht_hash_str(x, 0U, 33U, m);
+    const char *s = NULL;
+
+    /* preconditions */
+    assert( x != NULL );
+
+    s = *((const char**) x);
+
+    return upo_ht_hash_bytes(s, strlen(s), 0);
 }
 
 /*** END of HASH FUNCTIONS ***/
@@ -0,0 +1,1040 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Reader-writer locks and thread-specific data are POSIX extensions */
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include "hashtable_concurrent_private.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+size_t upo_ht_concurrent_next_pow2(size_t n)
+{
+    size_t p = 1;
+
+    while (p < n)
+    {
+        p *= 2;
+    }
+
+    return p;
+}
+
+
+/*** BEGIN of HASH TABLE with SEPARATE CHAINING and LOCK STRIPING ***/
+
+
+upo_ht_striped_t upo_ht_striped_create(size_t m, size_t num_stripes, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_ht_striped_t ht = NULL;
+    size_t i = 0;
+
+    /* preconditions */
+    assert( key_hash != NULL );
+    assert( key_cmp != NULL );
+
+    ht = malloc(sizeof(struct upo_ht_striped_s));
+    if (ht == NULL)
+    {
+        perror("Unable to allocate memory for Hash Table with Lock Striping");
+        abort();
+    }
+
+    ht->num_stripes = upo_ht_concurrent_next_pow2(num_stripes);
+    ht->capacity = upo_ht_concurrent_next_pow2(m > ht->num_stripes ? m : ht->num_stripes);
+
+    ht->slots = malloc(ht->capacity*sizeof(upo_ht_striped_node_t*));
+    ht->stripes = aligned_alloc(UPO_HT_CACHE_LINE_SIZE, ht->num_stripes*sizeof(upo_ht_striped_stripe_t));
+    if (ht->slots == NULL || ht->stripes == NULL)
+    {
+        perror("Unable to allocate memory for slots of the Hash Table with Lock Striping");
+        abort();
+    }
+
+    for (i = 0; i < ht->capacity; ++i)
+    {
+        ht->slots[i] = NULL;
+    }
+    for (i = 0; i < ht->num_stripes; ++i)
+    {
+        if (pthread_rwlock_init(&ht->stripes[i].lock, NULL) != 0)
+        {
+            perror("Unable to initialize the lock of a stripe of the Hash Table with Lock Striping");
+            abort();
+        }
+        ht->stripes[i].size = 0;
+        ht->stripes[i].node_pool = upo_pool_create(sizeof(upo_ht_striped_node_t), UPO_POOL_DEFAULT_CHUNK_CAPACITY);
+    }
+
+    ht->key_hash = key_hash;
+    ht->key_cmp = key_cmp;
+
+    return ht;
+}
+
+void upo_ht_striped_destroy(upo_ht_striped_t ht, int destroy_data)
+{
+    if (ht != NULL)
+    {
+        size_t i = 0;
+
+        upo_ht_striped_clear(ht, destroy_data);
+
+        for (i = 0; i < ht->num_stripes; ++i)
+        {
+            pthread_rwlock_destroy(&ht->stripes[i].lock);
+            upo_pool_destroy(ht->stripes[i].node_pool);
+        }
+        free(ht->stripes);
+        free(ht->slots);
+        free(ht);
+    }
+}
+
+void upo_ht_striped_clear(upo_ht_striped_t ht, int destroy_data)
+{
+    if (ht != NULL)
+    {
+        size_t s = 0;
+
+        for (s = 0; s < ht->num_stripes; ++s)
+        {
+            upo_ht_striped_stripe_t *stripe = &ht->stripes[s];
+            size_t i = 0;
+
+            upo_ht_striped_write_lock(stripe);
+
+            for (i = s; i < ht->capacity; i += ht->num_stripes)
+            {
+                if (destroy_data)
+                {
+                    upo_ht_striped_node_t *node = NULL;
+
+                    for (node = ht->slots[i]; node != NULL; node = node->next)
+                    {
+                        free(node->key);
+                        free(node->value);
+                    }
+                }
+                ht->slots[i] = NULL;
+            }
+            upo_pool_clear(stripe->node_pool);
+            stripe->size = 0;
+
+            upo_ht_striped_unlock(stripe);
+        }
+    }
+}
+
+upo_ht_striped_stripe_t* upo_ht_striped_stripe(const upo_ht_striped_t ht, uint64_t hash)
+{
+    return &ht->stripes[hash & (ht->num_stripes - 1)];
+}
+
+void upo_ht_striped_read_lock(upo_ht_striped_stripe_t *stripe)
+{
+    if (pthread_rwlock_rdlock(&stripe->lock) != 0)
+    {
+        perror("Unable to read-lock a stripe of the Hash Table with Lock Striping");
+        abort();
+    }
+}
+
+void upo_ht_striped_write_lock(upo_ht_striped_stripe_t *stripe)
+{
+    if (pthread_rwlock_wrlock(&stripe->lock) != 0)
+    {
+        perror("Unable to write-lock a stripe of the Hash Table with Lock Striping");
+        abort();
+    }
+}
+
+void upo_ht_striped_unlock(upo_ht_striped_stripe_t *stripe)
+{
+    pthread_rwlock_unlock(&stripe->lock);
+}
+
+upo_ht_striped_node_t** upo_ht_striped_find(const upo_ht_striped_t ht, const void *key, uint64_t hash)
+{
+    upo_ht_striped_node_t **link = &ht->slots[hash & (ht->capacity - 1)];
+
+    while (*link != NULL && ((*link)->hash != hash || ht->key_cmp(key, (*link)->key) != 0))
+    {
+        link = &(*link)->next;
+    }
+
+    return link;
+}
+
+void upo_ht_striped_resize(upo_ht_striped_t ht, size_t capacity)
+{
+    size_t s = 0;
+
+    /* Acquiring the locks always in the same order prevents deadlocks among
+     * threads resizing at the same time */
+    for (s = 0; s < ht->num_stripes; ++s)
+    {
+        upo_ht_striped_write_lock(&ht->stripes[s]);
+    }
+
+    /* Only the first of the threads that saw the same overloaded capacity
+     * resizes the table */
+    if (ht->capacity == capacity)
+    {
+        size_t new_capacity = 2*capacity;
+        upo_ht_striped_node_t **new_slots = NULL;
+        size_t i = 0;
+
+        new_slots = malloc(new_capacity*sizeof(upo_ht_striped_node_t*));
+        if (new_slots == NULL)
+        {
+            perror("Unable to allocate memory for slots of the Hash Table with Lock Striping");
+            abort();
+        }
+        for (i = 0; i < new_capacity; ++i)
+        {
+            new_slots[i] = NULL;
+        }
+
+        /* Nodes of slot i move either to slot i or to slot i+capacity, which
+         * belong to the same stripe, so nodes stay in the pool of their
+         * stripe */
+        for (i = 0; i < capacity; ++i)
+        {
+            upo_ht_striped_node_t *node = ht->slots[i];
+
+            while (node != NULL)
+            {
+                upo_ht_striped_node_t *next = node->next;
+                size_t j = node->hash & (new_capacity - 1);
+
+                node->next = new_slots[j];
+                new_slots[j] = node;
+                node = next;
+            }
+        }
+
+        free(ht->slots);
+        ht->slots = new_slots;
+        ht->capacity = new_capacity;
+    }
+
+    for (s = ht->num_stripes; s > 0; --s)
+    {
+        upo_ht_striped_unlock(&ht->stripes[s-1]);
+    }
+}
+
+void* upo_ht_striped_put(upo_ht_striped_t ht, void *key, void *value)
+{
+    if(ht == NULL) return NULL;
+
+    void *old_value = NULL;
+    uint64_t hash = ht->key_hash(key);
+    upo_ht_striped_stripe_t *stripe = upo_ht_striped_stripe(ht, hash);
+    upo_ht_striped_node_t **link = NULL;
+    size_t capacity = 0;
+    int grow = 0;
+
+    upo_ht_striped_write_lock(stripe);
+
+    link = upo_ht_striped_find(ht, key, hash);
+    if(*link == NULL) {
+        upo_ht_striped_node_t *node = upo_pool_alloc(stripe->node_pool);
+        node->key = key;
+        node->value = value;
+        node->hash = hash;
+        node->next = NULL;
+        *link = node;
+        stripe->size += 1;
+        capacity = ht->capacity;
+        grow = stripe->size > UPO_HT_STRIPED_MAX_LOAD_FACTOR*(capacity/ht->num_stripes);
+    }
+    else {
+        old_value = (*link)->value;
+        (*link)->value = value;
+    }
+
+    upo_ht_striped_unlock(stripe);
+
+    if(grow) upo_ht_striped_resize(ht, capacity);
+
+    return old_value;
+}
+
+void upo_ht_striped_insert(upo_ht_striped_t ht, void *key, void *value)
+{
+    if(ht == NULL) return;
+
+    uint64_t hash = ht->key_hash(key);
+    upo_ht_striped_stripe_t *stripe = upo_ht_striped_stripe(ht, hash);
+    upo_ht_striped_node_t **link = NULL;
+    size_t capacity = 0;
+    int grow = 0;
+
+    upo_ht_striped_write_lock(stripe);
+
+    link = upo_ht_striped_find(ht, key, hash);
+    if(*link == NULL) {
+        upo_ht_striped_node_t *node = upo_pool_alloc(stripe->node_pool);
+        node->key = key;
+        node->value = value;
+        node->hash = hash;
+        node->next = NULL;
+        *link = node;
+        stripe->size += 1;
+        capacity = ht->capacity;
+        grow = stripe->size > UPO_HT_STRIPED_MAX_LOAD_FACTOR*(capacity/ht->num_stripes);
+    }
+
+    upo_ht_striped_unlock(stripe);
+
+    if(grow) upo_ht_striped_resize(ht, capacity);
+}
+
+void* upo_ht_striped_get(const upo_ht_striped_t ht, const void *key)
+{
+    if(ht == NULL) return NULL;
+
+    void *value = NULL;
+    uint64_t hash = ht->key_hash(key);
+    upo_ht_striped_stripe_t *stripe = upo_ht_striped_stripe(ht, hash);
+    upo_ht_striped_node_t **link = NULL;
+
+    upo_ht_striped_read_lock(stripe);
+
+    link = upo_ht_striped_find(ht, key, hash);
+    if(*link != NULL) value = (*link)->value;
+
+    upo_ht_striped_unlock(stripe);
+
+    return value;
+}
+
+int upo_ht_striped_contains(const upo_ht_striped_t ht, const void *key)
+{
+    if(ht == NULL) return 0;
+
+    int found = 0;
+    uint64_t hash = ht->key_hash(key);
+    upo_ht_striped_stripe_t *stripe = upo_ht_striped_stripe(ht, hash);
+
+    upo_ht_striped_read_lock(stripe);
+
+    found = *upo_ht_striped_find(ht, key, hash) != NULL ? 1 : 0;
+
+    upo_ht_striped_unlock(stripe);
+
+    return found;
+}
+
+void upo_ht_striped_delete(upo_ht_striped_t ht, const void *key, int destroy_data)
+{
+    if(ht == NULL) return;
+
+    uint64_t hash = ht->key_hash(key);
+    upo_ht_striped_stripe_t *stripe = upo_ht_striped_stripe(ht, hash);
+    upo_ht_striped_node_t **link = NULL;
+
+    upo_ht_striped_write_lock(stripe);
+
+    link = upo_ht_striped_find(ht, key, hash);
+    if(*link != NULL) {
+        upo_ht_striped_node_t *node = *link;
+        *link = node->next;
+        if(destroy_data) {
+            free(node->key);
+            free(node->value);
+        }
+        upo_pool_free(stripe->node_pool, node);
+        stripe->size -= 1;
+    }
+
+    upo_ht_striped_unlock(stripe);
+}
+
+size_t upo_ht_striped_size(const upo_ht_striped_t ht)
+{
+    if(ht == NULL) return 0;
+
+    size_t size = 0;
+
+    for(size_t s = 0; s < ht->num_stripes; s++) {
+        upo_ht_striped_read_lock(&ht->stripes[s]);
+        size += ht->stripes[s].size;
+        upo_ht_striped_unlock(&ht->stripes[s]);
+    }
+    return size;
+}
+
+int upo_ht_striped_is_empty(const upo_ht_striped_t ht)
+{
+    return upo_ht_striped_size(ht) == 0 ? 1 : 0;
+}
+
+size_t upo_ht_striped_capacity(const upo_ht_striped_t ht)
+{
+    if(ht == NULL) return 0;
+
+    size_t capacity = 0;
+
+    /* Resizes hold the locks of all stripes */
+    upo_ht_striped_read_lock(&ht->stripes[0]);
+    capacity = ht->capacity;
+    upo_ht_striped_unlock(&ht->stripes[0]);
+
+    return capacity;
+}
+
+double upo_ht_striped_load_factor(const upo_ht_striped_t ht)
+{
+    return upo_ht_striped_size(ht) / (double) upo_ht_striped_capacity(ht);
+}
+
+void upo_ht_striped_traverse(const upo_ht_striped_t ht, upo_ht_visitor_t visit, void *visit_context)
+{
+    if(ht == NULL) return;
+
+    for(size_t s = 0; s < ht->num_stripes; s++) {
+        upo_ht_striped_read_lock(&ht->stripes[s]);
+        for(size_t i = s; i < ht->capacity; i += ht->num_stripes) {
+            for(upo_ht_striped_node_t *node = ht->slots[i]; node != NULL; node = node->next) {
+                visit(node->key, node->value, visit_context);
+            }
+        }
+        upo_ht_striped_unlock(&ht->stripes[s]);
+    }
+}
+
+
+/*** END of HASH TABLE with SEPARATE CHAINING and LOCK STRIPING ***/
+
+
+/*** BEGIN of HASH TABLE with SEPARATE CHAINING and LOCK-FREE LOOKUPS ***/
+
+
+upo_ht_rcu_t upo_ht_rcu_create(size_t m, size_t num_stripes, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_ht_rcu_t ht = NULL;
+    size_t i = 0;
+
+    /* preconditions */
+    assert( key_hash != NULL );
+    assert( key_cmp != NULL );
+
+    ht = malloc(sizeof(struct upo_ht_rcu_s));
+    if (ht == NULL)
+    {
+        perror("Unable to allocate memory for Hash Table with Lock-Free Lookups");
+        abort();
+    }
+
+    ht->num_stripes = upo_ht_concurrent_next_pow2(num_stripes);
+    atomic_init(&ht->slots, upo_ht_rcu_slots_create(upo_ht_concurrent_next_pow2(m > ht->num_stripes ? m : ht->num_stripes)));
+
+    ht->stripes = aligned_alloc(UPO_HT_CACHE_LINE_SIZE, ht->num_stripes*sizeof(upo_ht_rcu_stripe_t));
+    if (ht->stripes == NULL)
+    {
+        perror("Unable to allocate memory for stripes of the Hash Table with Lock-Free Lookups");
+        abort();
+    }
+    for (i = 0; i < ht->num_stripes; ++i)
+    {
+        if (pthread_mutex_init(&ht->stripes[i].lock, NULL) != 0)
+        {
+            perror("Unable to initialize the lock of a stripe of the Hash Table with Lock-Free Lookups");
+            abort();
+        }
+        ht->stripes[i].size = 0;
+    }
+
+    atomic_init(&ht->epoch, 0);
+    atomic_init(&ht->records, NULL);
+    if (pthread_key_create(&ht->record_key, upo_ht_rcu_record_release) != 0)
+    {
+        perror("Unable to create the thread-specific key of the Hash Table with Lock-Free Lookups");
+        abort();
+    }
+
+    ht->key_hash = key_hash;
+    ht->key_cmp = key_cmp;
+
+    return ht;
+}
+
+void upo_ht_rcu_destroy(upo_ht_rcu_t ht, int destroy_data)
+{
+    if (ht != NULL)
+    {
+        upo_ht_rcu_slots_t *slots = atomic_load_explicit(&ht->slots, memory_order_relaxed);
+        upo_ht_rcu_record_t *record = atomic_load_explicit(&ht->records, memory_order_relaxed);
+        size_t i = 0;
+
+        /* No thread is using the table anymore, so everything can be freed
+         * at once */
+        for (i = 0; i < slots->capacity; ++i)
+        {
+            upo_ht_rcu_node_t *node = atomic_load_explicit(&slots->heads[i], memory_order_relaxed);
+
+            while (node != NULL)
+            {
+                upo_ht_rcu_node_t *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+
+                node->retired.destroy_data = destroy_data;
+                upo_ht_rcu_free_retired(&node->retired);
+                node = next;
+            }
+        }
+        free(slots);
+
+        while (record != NULL)
+        {
+            upo_ht_rcu_record_t *next = record->next;
+            upo_ht_rcu_retired_t *object = record->retired;
+
+            while (object != NULL)
+            {
+                upo_ht_rcu_retired_t *next_object = object->next;
+
+                upo_ht_rcu_free_retired(object);
+                object = next_object;
+            }
+            free(record);
+            record = next;
+        }
+
+        /* Deleting the key prevents the destructor from running on records
+         * freed above when the threads that owned them exit */
+        pthread_key_delete(ht->record_key);
+
+        for (i = 0; i < ht->num_stripes; ++i)
+        {
+            pthread_mutex_destroy(&ht->stripes[i].lock);
+        }
+        free(ht->stripes);
+        free(ht);
+    }
+}
+
+void upo_ht_rcu_clear(upo_ht_rcu_t ht, int destroy_data)
+{
+    if (ht != NULL)
+    {
+        upo_ht_rcu_record_t *record = upo_ht_rcu_record(ht);
+        size_t s = 0;
+
+        upo_ht_rcu_lock_all(ht);
+
+        upo_ht_rcu_replace_slots(ht, record, atomic_load_explicit(&ht->slots, memory_order_relaxed)->capacity, 0, destroy_data);
+        for (s = 0; s < ht->num_stripes; ++s)
+        {
+            ht->stripes[s].size = 0;
+        }
+
+        upo_ht_rcu_unlock_all(ht);
+    }
+}
+
+upo_ht_rcu_slots_t* upo_ht_rcu_slots_create(size_t capacity)
+{
+    upo_ht_rcu_slots_t *slots = NULL;
+    size_t i = 0;
+
+    slots = malloc(sizeof(upo_ht_rcu_slots_t) + capacity*sizeof(_Atomic(upo_ht_rcu_node_t*)));
+    if (slots == NULL)
+    {
+        perror("Unable to allocate memory for slots of the Hash Table with Lock-Free Lookups");
+        abort();
+    }
+
+    slots->retired.next = NULL;
+    slots->retired.epoch = 0;
+    slots->retired.destroy_data = 0;
+    slots->capacity = capacity;
+    for (i = 0; i < capacity; ++i)
+    {
+        atomic_init(&slots->heads[i], NULL);
+    }
+
+    return slots;
+}
+
+upo_ht_rcu_stripe_t* upo_ht_rcu_stripe(const upo_ht_rcu_t ht, uint64_t hash)
+{
+    return &ht->stripes[hash & (ht->num_stripes - 1)];
+}
+
+void upo_ht_rcu_lock(upo_ht_rcu_stripe_t *stripe)
+{
+    if (pthread_mutex_lock(&stripe->lock) != 0)
+    {
+        perror("Unable to lock a stripe of the Hash Table with Lock-Free Lookups");
+        abort();
+    }
+}
+
+void upo_ht_rcu_unlock(upo_ht_rcu_stripe_t *stripe)
+{
+    pthread_mutex_unlock(&stripe->lock);
+}
+
+void upo_ht_rcu_lock_all(upo_ht_rcu_t ht)
+{
+    size_t s = 0;
+
+    /* Acquiring the locks always in the same order prevents deadlocks among
+     * threads resizing at the same time */
+    for (s = 0; s < ht->num_stripes; ++s)
+    {
+        upo_ht_rcu_lock(&ht->stripes[s]);
+    }
+}
+
+void upo_ht_rcu_unlock_all(upo_ht_rcu_t ht)
+{
+    size_t s = 0;
+
+    for (s = ht->num_stripes; s > 0; --s)
+    {
+        upo_ht_rcu_unlock(&ht->stripes[s-1]);
+    }
+}
+
+upo_ht_rcu_record_t* upo_ht_rcu_record(const upo_ht_rcu_t ht)
+{
+    upo_ht_rcu_record_t *record = pthread_getspecific(ht->record_key);
+
+    if (record != NULL)
+    {
+        return record;
+    }
+
+    /* Reuses the record of a thread that has exited, if any */
+    for (record = atomic_load_explicit(&ht->records, memory_order_acquire); record != NULL; record = record->next)
+    {
+        int owned = 0;
+
+        if (atomic_compare_exchange_strong(&record->owned, &owned, 1))
+        {
+            break;
+        }
+    }
+
+    if (record == NULL)
+    {
+        record = aligned_alloc(UPO_HT_CACHE_LINE_SIZE, sizeof(upo_ht_rcu_record_t));
+        if (record == NULL)
+        {
+            perror("Unable to allocate memory for a reclamation record of the Hash Table with Lock-Free Lookups");
+            abort();
+        }
+        atomic_init(&record->state, 0);
+        atomic_init(&record->owned, 1);
+        record->retired = NULL;
+        record->num_retired = 0;
+        record->next = atomic_load_explicit(&ht->records, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&ht->records, &record->next, record, memory_order_release, memory_order_relaxed))
+        {
+            ;
+        }
+    }
+
+    if (pthread_setspecific(ht->record_key, record) != 0)
+    {
+        perror("Unable to set the reclamation record of the Hash Table with Lock-Free Lookups");
+        abort();
+    }
+
+    return record;
+}
+
+void upo_ht_rcu_record_release(void *record)
+{
+    upo_ht_rcu_record_t *r = record;
+
+    atomic_store_explicit(&r->owned, 0, memory_order_release);
+}
+
+upo_ht_rcu_record_t* upo_ht_rcu_read_lock(const upo_ht_rcu_t ht)
+{
+    upo_ht_rcu_record_t *record = upo_ht_rcu_record(ht);
+    uint_fast64_t epoch = atomic_load_explicit(&ht->epoch, memory_order_relaxed);
+
+    atomic_store_explicit(&record->state, (epoch << 1) | 1, memory_order_seq_cst);
+    /* The announcement must be visible before any pointer of the table is
+     * read */
+    atomic_thread_fence(memory_order_seq_cst);
+
+    return record;
+}
+
+void upo_ht_rcu_read_unlock(upo_ht_rcu_record_t *record)
+{
+    atomic_store_explicit(&record->state, 0, memory_order_release);
+}
+
+upo_ht_rcu_node_t* upo_ht_rcu_find(const upo_ht_rcu_t ht, const upo_ht_rcu_slots_t *slots, const void *key, uint64_t hash)
+{
+    upo_ht_rcu_node_t *node = atomic_load_explicit(&slots->heads[hash & (slots->capacity - 1)], memory_order_acquire);
+
+    while (node != NULL && (node->hash != hash || ht->key_cmp(key, node->key) != 0))
+    {
+        node = atomic_load_explicit(&node->next, memory_order_acquire);
+    }
+
+    return node;
+}
+
+void upo_ht_rcu_retire(upo_ht_rcu_t ht, upo_ht_rcu_record_t *record, upo_ht_rcu_retired_t *object)
+{
+    /* The object must be unreachable before the epoch is read */
+    atomic_thread_fence(memory_order_seq_cst);
+
+    object->epoch = atomic_load_explicit(&ht->epoch, memory_order_relaxed);
+    object->next = record->retired;
+    record->retired = object;
+    record->num_retired += 1;
+
+    if (record->num_retired >= UPO_HT_RCU_RECLAIM_THRESHOLD)
+    {
+        upo_ht_rcu_try_advance(ht);
+        upo_ht_rcu_reclaim(ht, record);
+    }
+}
+
+void upo_ht_rcu_try_advance(upo_ht_rcu_t ht)
+{
+    uint_fast64_t epoch = atomic_load_explicit(&ht->epoch, memory_order_acquire);
+    upo_ht_rcu_record_t *record = NULL;
+
+    for (record = atomic_load_explicit(&ht->records, memory_order_acquire); record != NULL; record = record->next)
+    {
+        uint_fast64_t state = atomic_load_explicit(&record->state, memory_order_acquire);
+
+        if ((state & 1) != 0 && (state >> 1) != epoch)
+        {
+            return;
+        }
+    }
+
+    atomic_compare_exchange_strong(&ht->epoch, &epoch, epoch + 1);
+}
+
+void upo_ht_rcu_reclaim(upo_ht_rcu_t ht, upo_ht_rcu_record_t *record)
+{
+    uint_fast64_t epoch = atomic_load_explicit(&ht->epoch, memory_order_acquire);
+    upo_ht_rcu_retired_t **link = &record->retired;
+
+    while (*link != NULL)
+    {
+        upo_ht_rcu_retired_t *object = *link;
+
+        if (object->epoch + 2 <= epoch)
+        {
+            *link = object->next;
+            upo_ht_rcu_free_retired(object);
+            record->num_retired -= 1;
+        }
+        else
+        {
+            link = &object->next;
+        }
+    }
+}
+
+void upo_ht_rcu_free_retired(upo_ht_rcu_retired_t *object)
+{
+    /* Only nodes are retired with their data */
+    if (object->destroy_data)
+    {
+        upo_ht_rcu_node_t *node = (upo_ht_rcu_node_t*) object;
+
+        free(node->key);
+        free(atomic_load_explicit(&node->value, memory_order_relaxed));
+    }
+    free(object);
+}
+
+void upo_ht_rcu_replace_slots(upo_ht_rcu_t ht, upo_ht_rcu_record_t *record, size_t capacity, int copy_nodes, int destroy_data)
+{
+    upo_ht_rcu_slots_t *old_slots = atomic_load_explicit(&ht->slots, memory_order_relaxed);
+    upo_ht_rcu_slots_t *new_slots = upo_ht_rcu_slots_create(capacity);
+    size_t i = 0;
+
+    /* Running lookups may be reading the old nodes, so they are copied
+     * rather than relinked */
+    if (copy_nodes)
+    {
+        for (i = 0; i < old_slots->capacity; ++i)
+        {
+            upo_ht_rcu_node_t *node = NULL;
+
+            for (node = atomic_load_explicit(&old_slots->heads[i], memory_order_relaxed); node != NULL; node = atomic_load_explicit(&node->next, memory_order_relaxed))
+            {
+                upo_ht_rcu_node_t *copy = malloc(sizeof(upo_ht_rcu_node_t));
+                size_t j = node->hash & (capacity - 1);
+
+                if (copy == NULL)
+                {
+                    perror("Unable to allocate memory for new node of the Hash Table with Lock-Free Lookups");
+                    abort();
+                }
+                copy->retired.next = NULL;
+                copy->retired.epoch = 0;
+                copy->retired.destroy_data = 0;
+                copy->key = node->key;
+                atomic_init(&copy->value, atomic_load_explicit(&node->value, memory_order_relaxed));
+                copy->hash = node->hash;
+                atomic_init(&copy->next, atomic_load_explicit(&new_slots->heads[j], memory_order_relaxed));
+                atomic_store_explicit(&new_slots->heads[j], copy, memory_order_relaxed);
+            }
+        }
+    }
+
+    atomic_store_explicit(&ht->slots, new_slots, memory_order_release);
+
+    /* Old slots and nodes are retired only once they are unreachable */
+    for (i = 0; i < old_slots->capacity; ++i)
+    {
+        upo_ht_rcu_node_t *node = atomic_load_explicit(&old_slots->heads[i], memory_order_relaxed);
+
+        while (node != NULL)
+        {
+            upo_ht_rcu_node_t *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+
+            node->retired.destroy_data = destroy_data;
+            upo_ht_rcu_retire(ht, record, &node->retired);
+            node = next;
+        }
+    }
+    upo_ht_rcu_retire(ht, record, &old_slots->retired);
+}
+
+void upo_ht_rcu_resize(upo_ht_rcu_t ht, size_t capacity)
+{
+    upo_ht_rcu_record_t *record = upo_ht_rcu_record(ht);
+
+    upo_ht_rcu_lock_all(ht);
+
+    /* Only the first of the threads that saw the same overloaded capacity
+     * resizes the table */
+    if (atomic_load_explicit(&ht->slots, memory_order_relaxed)->capacity == capacity)
+    {
+        upo_ht_rcu_replace_slots(ht, record, 2*capacity, 1, 0);
+    }
+
+    upo_ht_rcu_unlock_all(ht);
+}
+
+int upo_ht_rcu_link(upo_ht_rcu_t ht, upo_ht_rcu_stripe_t *stripe, upo_ht_rcu_slots_t *slots, void *key, void *value, uint64_t hash)
+{
+    upo_ht_rcu_node_t *node = malloc(sizeof(upo_ht_rcu_node_t));
+    size_t i = hash & (slots->capacity - 1);
+
+    if (node == NULL)
+    {
+        perror("Unable to allocate memory for new node of the Hash Table with Lock-Free Lookups");
+        abort();
+    }
+
+    node->retired.next = NULL;
+    node->retired.epoch = 0;
+    node->retired.destroy_data = 0;
+    node->key = key;
+    atomic_init(&node->value, value);
+    node->hash = hash;
+    atomic_init(&node->next, atomic_load_explicit(&slots->heads[i], memory_order_relaxed));
+
+    /* Publishes the fully initialized node to lookups */
+    atomic_store_explicit(&slots->heads[i], node, memory_order_release);
+    stripe->size += 1;
+
+    return stripe->size > UPO_HT_RCU_MAX_LOAD_FACTOR*(slots->capacity/ht->num_stripes);
+}
+
+void* upo_ht_rcu_put(upo_ht_rcu_t ht, void *key, void *value)
+{
+    if(ht == NULL) return NULL;
+
+    void *old_value = NULL;
+    uint64_t hash = ht->key_hash(key);
+    upo_ht_rcu_stripe_t *stripe = upo_ht_rcu_stripe(ht, hash);
+    upo_ht_rcu_slots_t *slots = NULL;
+    upo_ht_rcu_node_t *node = NULL;
+    size_t capacity = 0;
+    int grow = 0;
+
+    upo_ht_rcu_lock(stripe);
+
+    /* Slots are only replaced while all stripe locks are held */
+    slots = atomic_load_explicit(&ht->slots, memory_order_relaxed);
+    capacity = slots->capacity;
+    node = upo_ht_rcu_find(ht, slots, key, hash);
+    if(node == NULL) grow = upo_ht_rcu_link(ht, stripe, slots, key, value, hash);
+    else old_value = atomic_exchange_explicit(&node->value, value, memory_order_acq_rel);
+
+    upo_ht_rcu_unlock(stripe);
+
+    if(grow) upo_ht_rcu_resize(ht, capacity);
+
+    return old_value;
+}
+
+void upo_ht_rcu_insert(upo_ht_rcu_t ht, void *key, void *value)
+{
+    if(ht == NULL) return;
+
+    uint64_t hash = ht->key_hash(key);
+    upo_ht_rcu_stripe_t *stripe = upo_ht_rcu_stripe(ht, hash);
+    upo_ht_rcu_slots_t *slots = NULL;
+    size_t capacity = 0;
+    int grow = 0;
+
+    upo_ht_rcu_lock(stripe);
+
+    slots = atomic_load_explicit(&ht->slots, memory_order_relaxed);
+    capacity = slots->capacity;
+    if(upo_ht_rcu_find(ht, slots, key, hash) == NULL) grow = upo_ht_rcu_link(ht, stripe, slots, key, value, hash);
+
+    upo_ht_rcu_unlock(stripe);
+
+    if(grow) upo_ht_rcu_resize(ht, capacity);
+}
+
+void* upo_ht_rcu_get(const upo_ht_rcu_t ht, const void *key)
+{
+    if(ht == NULL) return NULL;
+
+    void *value = NULL;
+    uint64_t hash = ht->key_hash(key);
+    upo_ht_rcu_record_t *record = upo_ht_rcu_read_lock(ht);
+    upo_ht_rcu_node_t *node = upo_ht_rcu_find(ht, atomic_load_explicit(&ht->slots, memory_order_acquire), key, hash);
+
+    if(node != NULL) value = atomic_load_explicit(&node->value, memory_order_acquire);
+
+    upo_ht_rcu_read_unlock(record);
+
+    return value;
+}
+
+int upo_ht_rcu_contains(const upo_ht_rcu_t ht, const void *key)
+{
+    if(ht == NULL) return 0;
+
+    uint64_t hash = ht->key_hash(key);
+    upo_ht_rcu_record_t *record = upo_ht_rcu_read_lock(ht);
+    int found = upo_ht_rcu_find(ht, atomic_load_explicit(&ht->slots, memory_order_acquire), key, hash) != NULL ? 1 : 0;
+
+    upo_ht_rcu_read_unlock(record);
+
+    return found;
+}
+
+void upo_ht_rcu_delete(upo_ht_rcu_t ht, const void *key, int destroy_data)
+{
+    if(ht == NULL) return;
+
+    uint64_t hash = ht->key_hash(key);
+    upo_ht_rcu_stripe_t *stripe = upo_ht_rcu_stripe(ht, hash);
+    upo_ht_rcu_record_t *record = upo_ht_rcu_record(ht);
+    upo_ht_rcu_slots_t *slots = NULL;
+    _Atomic(upo_ht_rcu_node_t*) *link = NULL;
+    upo_ht_rcu_node_t *node = NULL;
+
+    upo_ht_rcu_lock(stripe);
+
+    slots = atomic_load_explicit(&ht->slots, memory_order_relaxed);
+    link = &slots->heads[hash & (slots->capacity - 1)];
+    node = atomic_load_explicit(link, memory_order_relaxed);
+    while(node != NULL && (node->hash != hash || ht->key_cmp(key, node->key) != 0)) {
+        link = &node->next;
+        node = atomic_load_explicit(link, memory_order_relaxed);
+    }
+    if(node != NULL) {
+        /* The node keeps its link to the next one, so lookups standing on it
+         * can go on */
+        atomic_store_explicit(link, atomic_load_explicit(&node->next, memory_order_relaxed), memory_order_release);
+        node->retired.destroy_data = destroy_data;
+        upo_ht_rcu_retire(ht, record, &node->retired);
+        stripe->size -= 1;
+    }
+
+    upo_ht_rcu_unlock(stripe);
+}
+
+size_t upo_ht_rcu_size(const upo_ht_rcu_t ht)
+{
+    if(ht == NULL) return 0;
+
+    size_t size = 0;
+
+    for(size_t s = 0; s < ht->num_stripes; s++) {
+        upo_ht_rcu_lock(&ht->stripes[s]);
+        size += ht->stripes[s].size;
+        upo_ht_rcu_unlock(&ht->stripes[s]);
+    }
+    return size;
+}
+
+int upo_ht_rcu_is_empty(const upo_ht_rcu_t ht)
+{
+    return upo_ht_rcu_size(ht) == 0 ? 1 : 0;
+}
+
+size_t upo_ht_rcu_capacity(const upo_ht_rcu_t ht)
+{
+    if(ht == NULL) return 0;
+
+    /* The slots may be retired as soon as they are replaced */
+    upo_ht_rcu_record_t *record = upo_ht_rcu_read_lock(ht);
+    size_t capacity = atomic_load_explicit(&ht->slots, memory_order_acquire)->capacity;
+
+    upo_ht_rcu_read_unlock(record);
+
+    return capacity;
+}
+
+double upo_ht_rcu_load_factor(const upo_ht_rcu_t ht)
+{
+    return upo_ht_rcu_size(ht) / (double) upo_ht_rcu_capacity(ht);
+}
+
+void upo_ht_rcu_traverse(const upo_ht_rcu_t ht, upo_ht_visitor_t visit, void *visit_context)
+{
+    if(ht == NULL) return;
+
+    upo_ht_rcu_record_t *record = upo_ht_rcu_read_lock(ht);
+    upo_ht_rcu_slots_t *slots = atomic_load_explicit(&ht->slots, memory_order_acquire);
+
+    for(size_t i = 0; i < slots->capacity; i++) {
+        for(upo_ht_rcu_node_t *node = atomic_load_explicit(&slots->heads[i], memory_order_acquire); node != NULL; node = atomic_load_explicit(&node->next, memory_order_acquire)) {
+            visit(node->key, atomic_load_explicit(&node->value, memory_order_acquire), visit_context);
+        }
+    }
+
+    upo_ht_rcu_read_unlock(record);
+}
+
+
+/*** END of HASH TABLE with SEPARATE CHAINING and LOCK-FREE LOOKUPS ***/
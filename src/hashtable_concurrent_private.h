@@ -0,0 +1,301 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/hashtable_concurrent_private.h
+ *
+ * \brief Private header for the concurrent Hash Table abstract data types.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASHTABLE_CONCURRENT_PRIVATE_H
+#define UPO_HASHTABLE_CONCURRENT_PRIVATE_H
+
+
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <upo/hashtable_concurrent.h>
+#include <upo/pool.h>
+
+
+/** \brief The assumed size (in bytes) of a cache line. */
+#define UPO_HT_CACHE_LINE_SIZE 64U
+
+
+/**
+ * \brief Rounds up the given number to a power of two.
+ *
+ * \param n The number to round up.
+ * \return The smallest power of two greater than or equal to \a n (and to 1).
+ */
+static size_t upo_ht_concurrent_next_pow2(size_t n);
+
+
+/*** BEGIN of HASH TABLE with SEPARATE CHAINING and LOCK STRIPING ***/
+
+
+/** \brief Type for nodes of the list of collisions. */
+struct upo_ht_striped_node_s
+{
+    void *key; /**< Pointer to the user-provided key. */
+    void *value; /**< Pointer to the value associated to the key. */
+    uint64_t hash; /**< The cached full hash value of the key. */
+    struct upo_ht_striped_node_s *next; /**< Pointer to the next node in the list. */
+};
+/** \brief Alias for the type for nodes of the list of collisions. */
+typedef struct upo_ht_striped_node_s upo_ht_striped_node_t;
+
+/**
+ * \brief Type for stripes of hash tables with lock striping.
+ *
+ * Each stripe lives in its own cache lines, so that threads working on
+ * different stripes do not invalidate each other's caches.
+ */
+struct upo_ht_striped_stripe_s
+{
+    alignas(UPO_HT_CACHE_LINE_SIZE) pthread_rwlock_t lock; /**< The lock protecting the slots of the stripe. */
+    size_t size; /**< The number of keys stored in the slots of the stripe. */
+    upo_pool_t node_pool; /**< The pool the nodes of the slots of the stripe are allocated from. */
+};
+/** \brief Alias for the type for stripes of hash tables with lock striping. */
+typedef struct upo_ht_striped_stripe_s upo_ht_striped_stripe_t;
+
+/** \brief Type for hash tables with separate chaining and lock striping. */
+struct upo_ht_striped_s
+{
+    upo_ht_striped_node_t **slots; /**< The hash table as array of slots (i.e., heads of lists of collisions). */
+    size_t capacity; /**< The capacity of the hash table (a power of two). */
+    upo_ht_striped_stripe_t *stripes; /**< The array of stripes. */
+    size_t num_stripes; /**< The number of stripes (a power of two). */
+    upo_ht_hasher_t key_hash; /**< The key hash function. */
+    upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+};
+
+
+/** \brief Returns the stripe which the given hash value belongs to. */
+static upo_ht_striped_stripe_t* upo_ht_striped_stripe(const upo_ht_striped_t ht, uint64_t hash);
+
+/** \brief Acquires the lock of the given stripe for reading. */
+static void upo_ht_striped_read_lock(upo_ht_striped_stripe_t *stripe);
+
+/** \brief Acquires the lock of the given stripe for writing. */
+static void upo_ht_striped_write_lock(upo_ht_striped_stripe_t *stripe);
+
+/** \brief Releases the lock of the given stripe. */
+static void upo_ht_striped_unlock(upo_ht_striped_stripe_t *stripe);
+
+/**
+ * \brief Returns the link (i.e., the pointer to the node) to the node storing
+ *  the given key, or to the end of its list of collisions if the key is not
+ *  found.
+ *
+ * The lock of the stripe of the key must be held.
+ */
+static upo_ht_striped_node_t** upo_ht_striped_find(const upo_ht_striped_t ht, const void *key, uint64_t hash);
+
+/**
+ * \brief Doubles the capacity of the given hash table, unless another thread
+ *  has already changed the given capacity.
+ *
+ * No lock must be held by the calling thread.
+ */
+static void upo_ht_striped_resize(upo_ht_striped_t ht, size_t capacity);
+
+
+/*** END of HASH TABLE with SEPARATE CHAINING and LOCK STRIPING ***/
+
+
+/*** BEGIN of HASH TABLE with SEPARATE CHAINING and LOCK-FREE LOOKUPS ***/
+
+
+/**
+ * \brief Type for objects waiting to be reclaimed.
+ *
+ * It is the first member of every object that can be retired, so that
+ * reclaiming an object amounts to freeing it.
+ */
+struct upo_ht_rcu_retired_s
+{
+    struct upo_ht_rcu_retired_s *next; /**< Pointer to the next object retired by the same thread. */
+    uint64_t epoch; /**< The global epoch when the object was retired. */
+    int destroy_data; /**< Tells whether the key and the value of a retired node must be freed too. */
+};
+/** \brief Alias for the type for objects waiting to be reclaimed. */
+typedef struct upo_ht_rcu_retired_s upo_ht_rcu_retired_t;
+
+/** \brief Type for nodes of the list of collisions. */
+struct upo_ht_rcu_node_s
+{
+    upo_ht_rcu_retired_t retired; /**< The reclamation information. */
+    void *key; /**< Pointer to the user-provided key. */
+    _Atomic(void*) value; /**< Pointer to the value associated to the key. */
+    uint64_t hash; /**< The cached full hash value of the key. */
+    _Atomic(struct upo_ht_rcu_node_s*) next; /**< Pointer to the next node in the list. */
+};
+/** \brief Alias for the type for nodes of the list of collisions. */
+typedef struct upo_ht_rcu_node_s upo_ht_rcu_node_t;
+
+/** \brief Type for arrays of slots, replaced as a whole on resize. */
+struct upo_ht_rcu_slots_s
+{
+    upo_ht_rcu_retired_t retired; /**< The reclamation information. */
+    size_t capacity; /**< The number of slots (a power of two). */
+    _Atomic(upo_ht_rcu_node_t*) heads[]; /**< The heads of the lists of collisions. */
+};
+/** \brief Alias for the type for arrays of slots. */
+typedef struct upo_ht_rcu_slots_s upo_ht_rcu_slots_t;
+
+/**
+ * \brief Type for the per-thread reclamation records.
+ *
+ * A record is owned by at most one thread at a time, and is reused by a new
+ * thread after its owner exits.
+ */
+struct upo_ht_rcu_record_s
+{
+    alignas(UPO_HT_CACHE_LINE_SIZE) atomic_uint_fast64_t state; /**< The announced epoch shifted left by one, or-ed with 1 while a lookup is running. */
+    atomic_int owned; /**< Tells whether a thread owns the record. */
+    upo_ht_rcu_retired_t *retired; /**< The list of objects retired by the owner. */
+    size_t num_retired; /**< The number of objects retired by the owner. */
+    struct upo_ht_rcu_record_s *next; /**< Pointer to the next record. */
+};
+/** \brief Alias for the type for the per-thread reclamation records. */
+typedef struct upo_ht_rcu_record_s upo_ht_rcu_record_t;
+
+/** \brief Type for stripes of hash tables with lock-free lookups. */
+struct upo_ht_rcu_stripe_s
+{
+    alignas(UPO_HT_CACHE_LINE_SIZE) pthread_mutex_t lock; /**< The lock serialising writers to the slots of the stripe. */
+    size_t size; /**< The number of keys stored in the slots of the stripe. */
+};
+/** \brief Alias for the type for stripes of hash tables with lock-free lookups. */
+typedef struct upo_ht_rcu_stripe_s upo_ht_rcu_stripe_t;
+
+/** \brief Type for hash tables with separate chaining and lock-free lookups. */
+struct upo_ht_rcu_s
+{
+    _Atomic(upo_ht_rcu_slots_t*) slots; /**< The current array of slots. */
+    upo_ht_rcu_stripe_t *stripes; /**< The array of stripes. */
+    size_t num_stripes; /**< The number of stripes (a power of two). */
+    atomic_uint_fast64_t epoch; /**< The global epoch. */
+    _Atomic(upo_ht_rcu_record_t*) records; /**< The list of reclamation records. */
+    pthread_key_t record_key; /**< The key of the thread-specific pointer to the record of the calling thread. */
+    upo_ht_hasher_t key_hash; /**< The key hash function. */
+    upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+};
+
+
+/** \brief Allocates an array of \a capacity empty slots. */
+static upo_ht_rcu_slots_t* upo_ht_rcu_slots_create(size_t capacity);
+
+/** \brief Returns the stripe which the given hash value belongs to. */
+static upo_ht_rcu_stripe_t* upo_ht_rcu_stripe(const upo_ht_rcu_t ht, uint64_t hash);
+
+/** \brief Acquires the lock of the given stripe. */
+static void upo_ht_rcu_lock(upo_ht_rcu_stripe_t *stripe);
+
+/** \brief Releases the lock of the given stripe. */
+static void upo_ht_rcu_unlock(upo_ht_rcu_stripe_t *stripe);
+
+/** \brief Acquires the locks of all stripes, in order. */
+static void upo_ht_rcu_lock_all(upo_ht_rcu_t ht);
+
+/** \brief Releases the locks of all stripes, in reverse order. */
+static void upo_ht_rcu_unlock_all(upo_ht_rcu_t ht);
+
+/**
+ * \brief Returns the reclamation record of the calling thread, claiming or
+ *  allocating one on first use.
+ */
+static upo_ht_rcu_record_t* upo_ht_rcu_record(const upo_ht_rcu_t ht);
+
+/** \brief Releases the ownership of a record when its owner thread exits. */
+static void upo_ht_rcu_record_release(void *record);
+
+/**
+ * \brief Starts a lookup, announcing the current global epoch.
+ *
+ * \return The record of the calling thread, to be passed to
+ *  upo_ht_rcu_read_unlock().
+ */
+static upo_ht_rcu_record_t* upo_ht_rcu_read_lock(const upo_ht_rcu_t ht);
+
+/** \brief Ends a lookup started by upo_ht_rcu_read_lock(). */
+static void upo_ht_rcu_read_unlock(upo_ht_rcu_record_t *record);
+
+/**
+ * \brief Returns the node storing the given key, or `NULL` if the key is not
+ *  found.
+ *
+ * The caller must either have started a lookup or hold the lock of the
+ * stripe of the key.
+ */
+static upo_ht_rcu_node_t* upo_ht_rcu_find(const upo_ht_rcu_t ht, const upo_ht_rcu_slots_t *slots, const void *key, uint64_t hash);
+
+/**
+ * \brief Retires the given object, and reclaims the objects retired by the
+ *  calling thread that no lookup can still read once there are enough of
+ *  them.
+ */
+static void upo_ht_rcu_retire(upo_ht_rcu_t ht, upo_ht_rcu_record_t *record, upo_ht_rcu_retired_t *object);
+
+/**
+ * \brief Advances the global epoch if every running lookup has announced the
+ *  current one.
+ */
+static void upo_ht_rcu_try_advance(upo_ht_rcu_t ht);
+
+/** \brief Frees the retired objects of the given record retired at least two epochs ago. */
+static void upo_ht_rcu_reclaim(upo_ht_rcu_t ht, upo_ht_rcu_record_t *record);
+
+/** \brief Frees the given retired object (and its data, if requested). */
+static void upo_ht_rcu_free_retired(upo_ht_rcu_retired_t *object);
+
+/**
+ * \brief Replaces the array of slots with a new one of the given capacity,
+ *  holding copies of the current nodes, and retires the old array and nodes.
+ *
+ * The locks of all stripes must be held.
+ */
+static void upo_ht_rcu_replace_slots(upo_ht_rcu_t ht, upo_ht_rcu_record_t *record, size_t capacity, int copy_nodes, int destroy_data);
+
+/**
+ * \brief Doubles the capacity of the given hash table, unless another thread
+ *  has already changed the given capacity.
+ *
+ * No lock must be held by the calling thread.
+ */
+static void upo_ht_rcu_resize(upo_ht_rcu_t ht, size_t capacity);
+
+/**
+ * \brief Links a new node to the given slots; the lock of the stripe of the
+ *  key must be held.
+ *
+ * \return Whether the table should grow after the lock is released.
+ */
+static int upo_ht_rcu_link(upo_ht_rcu_t ht, upo_ht_rcu_stripe_t *stripe, upo_ht_rcu_slots_t *slots, void *key, void *value, uint64_t hash);
+
+
+/*** END of HASH TABLE with SEPARATE CHAINING and LOCK-FREE LOOKUPS ***/
+
+
+#endif /* UPO_HASHTABLE_CONCURRENT_PRIVATE_H */
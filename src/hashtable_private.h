@@ -29,7 +29,171 @@
 #define UPO_HASHTABLE_PRIVATE_H
 
 
+#include <upo/filter.h>
 #include <upo/hashtable.h>
+#include <upo/pool.h>
+
+
+/**
+ * \brief Hints the processor to fetch into the cache the memory at the given
+ *  address, which is going to be read soon.
+ *
+ * It expands to nothing on compilers without a prefetch builtin.
+ */
+#if defined(__GNUC__)
+# define UPO_HT_PREFETCH(p) __builtin_prefetch((p), 0, 3)
+#else
+# define UPO_HT_PREFETCH(p) ((void) (p))
+#endif
+
+
+/**
+ * \brief Reduces the given full hash value to a slot index.
+ *
+ * \param hash The full hash value returned by the key hash function.
+ * \param capacity The capacity of the hash table.
+ * \return An index in \f$\{0,\ldots,capacity-1\}\f$.
+ *
+ * When the capacity is a power of two the reduction is a bit mask, otherwise
+ * it is the remainder of the division by the capacity.
+ */
+static size_t upo_ht_hash_to_index(uint64_t hash, size_t capacity);
+
+/**
+ * \brief Computes the full 128-bit product of two 64-bit integers.
+ *
+ * \param a The first factor.
+ * \param b The second factor.
+ * \param lo Where the low 64 bits of the product are stored.
+ * \param hi Where the high 64 bits of the product are stored.
+ */
+static void upo_ht_hash_mul128(uint64_t a, uint64_t b, uint64_t *lo, uint64_t *hi);
+
+/**
+ * \brief Reverses the order of the bits of the given integer.
+ *
+ * \param x The integer.
+ * \return The integer whose bit `i` is bit `63-i` of \a x.
+ */
+static uint64_t upo_ht_hash_reverse64(uint64_t x);
+
+/**
+ * \brief Multiplies two 64-bit integers and folds the 128-bit product by
+ *  xor-ing its two halves.
+ */
+static uint64_t upo_ht_hash_mum(uint64_t a, uint64_t b);
+
+/** \brief Reads 8 bytes in native byte order from a possibly unaligned address. */
+static uint64_t upo_ht_hash_read64(const unsigned char *p);
+
+/** \brief Reads 4 bytes in native byte order from a possibly unaligned address. */
+static uint64_t upo_ht_hash_read32(const unsigned char *p);
+
+
+#ifdef UPO_HT_STATS
+
+/** \brief Type for the operation counters of hash tables. */
+struct upo_ht_counters_s
+{
+    size_t num_gets; /**< The number of lookups. */
+    size_t num_puts; /**< The number of insertions. */
+    size_t num_deletes; /**< The number of removals. */
+    size_t num_probes; /**< The number of slots or nodes examined. */
+};
+/** \brief Alias for the type for the operation counters of hash tables. */
+typedef struct upo_ht_counters_s upo_ht_counters_t;
+
+/**
+ * \brief Counts an operation of the given kind (i.e., the name of a field of
+ *  #upo_ht_counters_t) on the given hash table, together with the first
+ *  slot or node it examines.
+ */
+# define UPO_HT_STATS_COUNT_OP(ht, op) ((ht)->counters.op += 1, (ht)->counters.num_probes += 1)
+
+/** \brief Counts one more slot or node examined by an operation on the given hash table. */
+# define UPO_HT_STATS_COUNT_PROBE(ht) ((ht)->counters.num_probes += 1)
+
+#else
+
+# define UPO_HT_STATS_COUNT_OP(ht, op) ((void) 0)
+# define UPO_HT_STATS_COUNT_PROBE(ht) ((void) 0)
+
+#endif /* UPO_HT_STATS */
+
+
+/**
+ * \brief Initializes the given statistics for a hash table with the given
+ *  size and capacity.
+ *
+ * \param stats The statistics.
+ * \param size The number of stored key-value pairs.
+ * \param capacity The number of slots.
+ */
+static void upo_ht_stats_init(upo_ht_stats_t *stats, size_t size, size_t capacity);
+
+/**
+ * \brief Adds the given length to the given histogram.
+ *
+ * \param histogram A histogram with #UPO_HT_STATS_HISTOGRAM_SIZE buckets.
+ * \param length The length.
+ */
+static void upo_ht_stats_histogram_add(size_t *histogram, size_t length);
+
+/**
+ * \brief Sets the mean and the percentiles of probe lengths of the given
+ *  statistics.
+ *
+ * \param stats The statistics, whose size and maximum probe length are set.
+ * \param counts The number of keys by probe length, from `0` to the maximum
+ *  probe length.
+ */
+static void upo_ht_stats_set_probe_lengths(upo_ht_stats_t *stats, const size_t *counts);
+
+/**
+ * \brief Returns the given percentile of the given distribution of lengths.
+ *
+ * \param counts The number of keys by length, from `0` to \a max_length.
+ * \param max_length The maximum length.
+ * \param n The number of keys.
+ * \param p The percentile, in \f$[0,1]\f$.
+ * \return The smallest length not exceeded by at least a fraction \a p of
+ *  the keys.
+ */
+static size_t upo_ht_stats_percentile(const size_t *counts, size_t max_length, size_t n, double p);
+
+/** \brief Returns the time (in seconds) elapsed since an arbitrary point. */
+static double upo_ht_stats_now();
+
+
+/**
+ * \brief The number of slots of a table region filled at a time by bulk
+ *  builds.
+ */
+#define UPO_HT_BUILD_PARTITION_SLOTS 4096U
+
+/** \brief The maximum number of regions keys are partitioned into by bulk builds. */
+#define UPO_HT_BUILD_MAX_PARTITIONS 1024U
+
+
+/**
+ * \brief Hashes the given keys and sorts them by the region of the table
+ *  their slot falls into.
+ *
+ * \param keys The array of the \a n keys.
+ * \param n The number of keys.
+ * \param key_hash The key hash function.
+ * \param capacity The capacity of the hash table.
+ * \param hashes The array of \a n elements where the hash value of each key
+ *  is stored.
+ * \param order The array of \a n elements where the positions of keys are
+ *  stored, sorted by region; keys of the same region keep their relative
+ *  order, so that later pairs still replace earlier ones.
+ *
+ * Keys are partitioned by a single counting pass (as in a radix sort on the
+ * high digit of the slot), into at most #UPO_HT_BUILD_MAX_PARTITIONS regions
+ * of about #UPO_HT_BUILD_PARTITION_SLOTS slots.
+ */
+static void upo_ht_build_partition(void *const *keys, size_t n, upo_ht_hasher_t key_hash, size_t capacity, uint64_t *hashes, size_t *order);
 
 
 /*** BEGIN of HASH TABLE with SEPARATE CHAINING ***/
@@ -40,6 +204,7 @@ struct upo_ht_sepchain_list_node_s
 {
     void *key; /**< Pointer to the user-provided key. */
     void *value; /**< Pointer to the value associated to the key. */
+    uint64_t hash; /**< The cached full hash value of the key. */
     struct upo_ht_sepchain_list_node_s *next; /**< Pointer to the next node in the list. */
 };
 /** \brief Alias for the type for nodes of the list of collisions. */
@@ -61,6 +226,11 @@ struct upo_ht_sepchain_s
     size_t size; /**< The number of elements stored in the hash table. */
     upo_ht_hasher_t key_hash; /**< The key hash function. */
     upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+    upo_pool_t node_pool; /**< The pool the nodes of the lists of collisions are allocated from. */
+    upo_cbloom_t filter; /**< The filter of stored keys checked before lookups, or `NULL`. */
+#ifdef UPO_HT_STATS
+    upo_ht_counters_t counters; /**< The operation counters. */
+#endif /* UPO_HT_STATS */
 };
 
 
@@ -75,6 +245,7 @@ struct upo_ht_linprob_slot_s
 {
     void *key; /**< Pointer to the user-provided key. */
     void *value; /**< Pointer to the value associated to the key. */
+    uint64_t hash; /**< The cached full hash value of the key. */
     int tombstone; /**< Flag used to mark this slot as deleted. */
 };
 
@@ -89,6 +260,11 @@ struct upo_ht_linprob_s
     size_t size; /**< The number of stored key-value pairs. */
     upo_ht_hasher_t key_hash; /**< The key hash function. */
     upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+    size_t num_resizes; /**< The number of times the hash table has been resized. */
+    double resize_time; /**< The time (in seconds) spent resizing the hash table. */
+#ifdef UPO_HT_STATS
+    upo_ht_counters_t counters; /**< The operation counters. */
+#endif /* UPO_HT_STATS */
 };
 
 
@@ -104,7 +280,361 @@ static void upo_ht_linprob_resize(upo_ht_linprob_t ht, size_t n);
 /*** END of HASH TABLE with LINEAR PROBING ***/
 
 
-typedef struct upo_ht_sepchain_olist_s* upo_ht_sepchain_olist_t;
+/*** BEGIN of HASH TABLE with SEPARATE CHAINING and ORDERED LISTS ***/
+
+
+/** \brief Type for hash tables with separate chaining based on ordered lists. */
+struct upo_ht_sepchain_olist_s
+{
+    upo_ht_sepchain_slot_t *slots; /**< The hash table as array of slots. */
+    size_t capacity; /**< The capacity of the hash table. */
+    size_t size; /**< The number of elements stored in the hash table. */
+    upo_ht_hasher_t key_hash; /**< The key hash function. */
+    upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+    upo_pool_t node_pool; /**< The pool the nodes of the lists of collisions are allocated from. */
+};
+
+
+/**
+ * \brief Returns the link (i.e., the pointer to the node) to the first node
+ *  of the list of collisions of the given key that does not precede the key.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param hash The full hash value of the key.
+ * \param found Where `1` is stored if the linked node stores the key, or `0`
+ *  otherwise (in which case a new node for the key must be linked there).
+ * \return The link to the node.
+ *
+ * Nodes are sorted by hash value and, for equal hash values, by key.
+ */
+static upo_ht_sepchain_list_node_t** upo_ht_sepchain_olist_find(const upo_ht_sepchain_olist_t ht, const void *key, uint64_t hash, int *found);
+
+
+/*** END of HASH TABLE with SEPARATE CHAINING and ORDERED LISTS ***/
+
+
+/*** BEGIN of HASH TABLE with CUCKOO HASHING ***/
+
+
+/**
+ * \brief Maximum number of buckets visited by the breadth-first search for a
+ *  sequence of moves that frees a slot.
+ */
+#define UPO_HT_CUCKOO_MAX_BFS_BUCKETS 256U
+
+/**
+ * \brief Maximum number of moves of the sequence that frees a slot.
+ *
+ * With #UPO_HT_CUCKOO_BUCKET_SIZE slots per bucket, a search that starts from
+ * two buckets reaches at most \f$2 \cdot 4^4 = 512\f$ buckets with at most
+ * four moves, so the search is bounded by #UPO_HT_CUCKOO_MAX_BFS_BUCKETS
+ * first.
+ */
+#define UPO_HT_CUCKOO_MAX_PATH_LENGTH 4U
+
+/**
+ * \brief Ratio between the capacity and the number of keys stored in buckets
+ *  beyond which a key that does not fit is not worth a resize.
+ *
+ * Keys with the same full hash value share their candidate buckets whatever
+ * the number of buckets, so with a poor or adversarial hash function the
+ * table would be doubled over and over; such keys go to the overflow area
+ * instead.
+ */
+#define UPO_HT_CUCKOO_MAX_GROWTH 8U
+
+
+/**
+ * \brief Type for buckets of hash tables with cuckoo hashing.
+ *
+ * Hash values are kept together, so that the slots of a bucket can be
+ * filtered without touching keys.
+ * A slot is empty if its key is `NULL`.
+ */
+struct upo_ht_cuckoo_bucket_s
+{
+    uint64_t hashes[UPO_HT_CUCKOO_BUCKET_SIZE]; /**< The cached full hash values of the keys. */
+    void *keys[UPO_HT_CUCKOO_BUCKET_SIZE]; /**< Pointers to the user-provided keys. */
+    void *values[UPO_HT_CUCKOO_BUCKET_SIZE]; /**< Pointers to the values associated to the keys. */
+};
+/** \brief Alias for the type for buckets of hash tables with cuckoo hashing. */
+typedef struct upo_ht_cuckoo_bucket_s upo_ht_cuckoo_bucket_t;
+
+/** \brief Type for the slots of the stash of hash tables with cuckoo hashing. */
+struct upo_ht_cuckoo_stash_slot_s
+{
+    void *key; /**< Pointer to the user-provided key. */
+    void *value; /**< Pointer to the value associated to the key. */
+    uint64_t hash; /**< The cached full hash value of the key. */
+};
+/** \brief Alias for the type for the slots of the stash of hash tables with cuckoo hashing. */
+typedef struct upo_ht_cuckoo_stash_slot_s upo_ht_cuckoo_stash_slot_t;
+
+/** \brief Type for hash tables with cuckoo hashing. */
+struct upo_ht_cuckoo_s
+{
+    upo_ht_cuckoo_bucket_t *buckets; /**< The array of buckets. */
+    size_t num_buckets; /**< The number of buckets (a power of two). */
+    size_t size; /**< The number of stored key-value pairs (stash included). */
+    upo_ht_cuckoo_stash_slot_t *stash; /**< The stash, whose slots beyond the first #UPO_HT_CUCKOO_STASH_SIZE ones are the overflow area. */
+    size_t stash_size; /**< The number of key-value pairs in the stash and in the overflow area (which are the first ones). */
+    size_t stash_capacity; /**< The number of allocated slots of the stash. */
+    upo_ht_hasher_t key_hash; /**< The key hash function. */
+    upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+};
+
+/** \brief Type for the nodes of the breadth-first search for a free slot. */
+struct upo_ht_cuckoo_bfs_node_s
+{
+    size_t bucket; /**< The index of the visited bucket. */
+    size_t parent; /**< The position of the node the bucket has been reached from, or `SIZE_MAX` for the two starting buckets. */
+    size_t slot; /**< The slot of the parent bucket whose key would move to this bucket. */
+    size_t depth; /**< The number of moves needed to reach this bucket. */
+};
+/** \brief Alias for the type for the nodes of the breadth-first search for a free slot. */
+typedef struct upo_ht_cuckoo_bfs_node_s upo_ht_cuckoo_bfs_node_t;
+
+
+/**
+ * \brief Allocates the given number of empty buckets.
+ *
+ * \param num_buckets The number of buckets.
+ * \return The array of buckets.
+ */
+static upo_ht_cuckoo_bucket_t* upo_ht_cuckoo_create_buckets(size_t num_buckets);
+
+/**
+ * \brief Returns the first candidate bucket for the given full hash value.
+ *
+ * \param hash The full hash value of a key.
+ * \param num_buckets The number of buckets (a power of two).
+ * \return The index of the first candidate bucket.
+ */
+static size_t upo_ht_cuckoo_bucket1(uint64_t hash, size_t num_buckets);
+
+/**
+ * \brief Returns the second candidate bucket for the given full hash value.
+ *
+ * \param hash The full hash value of a key.
+ * \param num_buckets The number of buckets (a power of two).
+ * \return The index of the second candidate bucket, which is derived by
+ *  remixing \a hash and differs from the first one when there are at least
+ *  two buckets.
+ */
+static size_t upo_ht_cuckoo_bucket2(uint64_t hash, size_t num_buckets);
+
+/**
+ * \brief Returns the slot holding the given key in the given bucket.
+ *
+ * \param ht The hash table.
+ * \param bucket The bucket.
+ * \param key The key.
+ * \param hash The full hash value of the key.
+ * \return The index of the slot, or #UPO_HT_CUCKOO_BUCKET_SIZE if the key is
+ *  not in the bucket.
+ */
+static size_t upo_ht_cuckoo_bucket_find(const upo_ht_cuckoo_t ht, const upo_ht_cuckoo_bucket_t *bucket, const void *key, uint64_t hash);
+
+/**
+ * \brief Returns the first empty slot of the given bucket.
+ *
+ * \param bucket The bucket.
+ * \return The index of the slot, or #UPO_HT_CUCKOO_BUCKET_SIZE if the bucket
+ *  is full.
+ */
+static size_t upo_ht_cuckoo_bucket_find_empty(const upo_ht_cuckoo_bucket_t *bucket);
+
+/**
+ * \brief Finds the bucket and the slot (or the stash slot) holding the given
+ *  key.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param hash The full hash value of the key.
+ * \param bucket Where the index of the bucket is stored, or `SIZE_MAX` if the
+ *  key is in the stash.
+ * \param slot Where the index of the slot (of the bucket or of the stash) is
+ *  stored.
+ * \return `1` if the key is found, or `0` otherwise.
+ */
+static int upo_ht_cuckoo_find(const upo_ht_cuckoo_t ht, const void *key, uint64_t hash, size_t *bucket, size_t *slot);
+
+/**
+ * \brief Stores the given key-value pair, which must not be in the hash
+ *  table, in one of its candidate buckets or in the stash.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ * \param hash The full hash value of the key.
+ * \return `1` if the pair has been stored, or `0` if both the candidate
+ *  buckets (after trying to free a slot) and the stash are full.
+ */
+static int upo_ht_cuckoo_place(upo_ht_cuckoo_t ht, void *key, void *value, uint64_t hash);
+
+/**
+ * \brief Frees a slot in one of the two given buckets by moving keys to their
+ *  other candidate bucket.
+ *
+ * \param ht The hash table.
+ * \param b1 The first bucket.
+ * \param b2 The second bucket.
+ * \param bucket Where the index of the bucket with the freed slot is stored.
+ * \param slot Where the index of the freed slot is stored.
+ * \return `1` if a slot has been freed, or `0` if no sequence of at most
+ *  #UPO_HT_CUCKOO_MAX_PATH_LENGTH moves has been found.
+ */
+static int upo_ht_cuckoo_make_room(upo_ht_cuckoo_t ht, size_t b1, size_t b2, size_t *bucket, size_t *slot);
+
+/**
+ * \brief Appends the given key-value pair, which must not be in the hash
+ *  table, to the stash, growing it if needed.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ * \param hash The full hash value of the key.
+ *
+ * Once the first #UPO_HT_CUCKOO_STASH_SIZE slots are used, the pair goes to
+ * the overflow area, which lookups scan linearly.
+ */
+static void upo_ht_cuckoo_stash_push(upo_ht_cuckoo_t ht, void *key, void *value, uint64_t hash);
+
+/**
+ * \brief Stores the given key-value pair, which must not be in the hash
+ *  table, resizing the hash table if it does not fit.
+ *
+ * \param ht The hash table.
+ * \param key The key.
+ * \param value The value.
+ * \param hash The full hash value of the key.
+ *
+ * The hash table is doubled only while its capacity is at most
+ * #UPO_HT_CUCKOO_MAX_GROWTH times the number of keys stored in buckets (i.e.,
+ * the stash and the overflow area excluded); otherwise (or if the
+ * pair does not fit even after the resize), the pair goes to the overflow
+ * area.
+ */
+static void upo_ht_cuckoo_add(upo_ht_cuckoo_t ht, void *key, void *value, uint64_t hash);
+
+/**
+ * \brief Moves keys from the stash to their candidate buckets, where
+ *  possible.
+ *
+ * \param ht The hash table.
+ */
+static void upo_ht_cuckoo_drain_stash(upo_ht_cuckoo_t ht);
+
+/**
+ * \brief Resize the given hash table to the given number of buckets.
+ *
+ * \param ht The hash table to resize.
+ * \param num_buckets The new number of buckets (a power of two).
+ *
+ * Keys that cannot be stored in their candidate buckets nor in the stash go
+ * to the overflow area.
+ */
+static void upo_ht_cuckoo_resize(upo_ht_cuckoo_t ht, size_t num_buckets);
+
+
+/*** END of HASH TABLE with CUCKOO HASHING ***/
+
+
+/*** BEGIN of HASH TABLE with LINEAR PROBING and INLINE KEYS ***/
+
+
+/** \brief The control byte of empty slots (no hash bits have the top bit set). */
+#define UPO_HT_INLINE_EMPTY 0x80U
+
+/** \brief The minimum capacity of hash tables with inline keys. */
+#define UPO_HT_INLINE_MIN_CAPACITY 8U
+
+
+/** \brief Defines the type for hash tables with linear probing and inline keys. */
+struct upo_ht_inline_s
+{
+    unsigned char *ctrl; /**< The control bytes: #UPO_HT_INLINE_EMPTY, or 7 bits of the hash value of the key in the slot. */
+    unsigned char *slots; /**< The slots, each holding a key followed by a value. */
+    size_t capacity; /**< The number of slots (a power of two). */
+    size_t size; /**< The number of stored key-value pairs. */
+    size_t key_size; /**< The size (in bytes) of keys. */
+    size_t value_size; /**< The size (in bytes) of values. */
+    size_t value_offset; /**< The offset of the value in a slot. */
+    size_t slot_size; /**< The size (in bytes) of a slot, padding included. */
+    upo_ht_hasher_t key_hash; /**< The key hash function, or `NULL` for the built-in one. */
+    upo_ht_comparator_t key_cmp; /**< The key comparison function, or `NULL` to compare bytes. */
+};
+
+
+/**
+ * \brief Returns the alignment for data of the given size.
+ *
+ * \param size The size (in bytes) of the data.
+ * \return The largest power of two, up to `8`, dividing \a size.
+ */
+static size_t upo_ht_inline_alignment(size_t size);
+
+/**
+ * \brief Allocates the slots and the control bytes of the given hash table,
+ *  all empty.
+ *
+ * \param ht The hash table.
+ * \param capacity The number of slots (a power of two).
+ */
+static void upo_ht_inline_create_slots(upo_ht_inline_t ht, size_t capacity);
+
+/**
+ * \brief Returns the full hash value of the given key.
+ *
+ * \param ht The hash table.
+ * \param key A pointer to the key.
+ * \return The hash value, computed by the built-in function if the hash table
+ *  has no hash function.
+ */
+static uint64_t upo_ht_inline_hash(const upo_ht_inline_t ht, const void *key);
+
+/**
+ * \brief Returns the control byte of a key with the given hash value.
+ *
+ * \param hash The full hash value of the key.
+ * \return The 7 most significant bits of \a hash.
+ */
+static unsigned char upo_ht_inline_h2(uint64_t hash);
+
+/**
+ * \brief Tells whether two keys are equal.
+ *
+ * \param ht The hash table.
+ * \param key1 A pointer to the first key.
+ * \param key2 A pointer to the second key.
+ * \return `1` if the keys are equal, or `0` otherwise.
+ */
+static int upo_ht_inline_key_equals(const upo_ht_inline_t ht, const void *key1, const void *key2);
+
+/**
+ * \brief Finds the slot holding the given key.
+ *
+ * \param ht The hash table.
+ * \param key A pointer to the key.
+ * \param hash The full hash value of the key.
+ * \param index Where the index of the slot holding the key is stored or, if
+ *  the key is not found, the index of the empty slot ending the probe
+ *  sequence.
+ * \return `1` if the key is found, or `0` otherwise.
+ */
+static int upo_ht_inline_find(const upo_ht_inline_t ht, const void *key, uint64_t hash, size_t *index);
+
+/**
+ * \brief Resizes the given hash table to the given capacity.
+ *
+ * \param ht The hash table.
+ * \param capacity The new capacity (a power of two).
+ */
+static void upo_ht_inline_resize(upo_ht_inline_t ht, size_t capacity);
+
+
+/*** END of HASH TABLE with LINEAR PROBING and INLINE KEYS ***/
 
 
 #endif /* UPO_HASHTABLE_PRIVATE_H */
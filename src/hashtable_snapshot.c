@@ -0,0 +1,396 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include "hashtable_snapshot_private.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+size_t upo_ht_serialize_int(const void *x, const void **bytes)
+{
+    /* preconditions */
+    assert( bytes != NULL );
+
+    *bytes = x;
+
+    return sizeof(int);
+}
+
+size_t upo_ht_serialize_str(const void *s, const void **bytes)
+{
+    const char *str = NULL;
+
+    /* preconditions */
+    assert( s != NULL );
+    assert( bytes != NULL );
+
+    str = *((const char**) s);
+    *bytes = str;
+
+    return strlen(str) + 1;
+}
+
+uint64_t upo_ht_snapshot_align(uint64_t n)
+{
+    return (n + UPO_HT_SNAPSHOT_ALIGNMENT - 1) / UPO_HT_SNAPSHOT_ALIGNMENT * UPO_HT_SNAPSHOT_ALIGNMENT;
+}
+
+int upo_ht_snapshot_write_padding(FILE *fp, size_t n)
+{
+    static const unsigned char zeros[UPO_HT_SNAPSHOT_ALIGNMENT];
+
+    while (n > 0)
+    {
+        size_t len = (n < sizeof zeros) ? n : sizeof zeros;
+
+        if (fwrite(zeros, 1, len, fp) != len)
+        {
+            return 0;
+        }
+        n -= len;
+    }
+
+    return 1;
+}
+
+
+/*** BEGIN of SNAPSHOT of HASH TABLE with LINEAR PROBING ***/
+
+
+int upo_ht_linprob_snapshot_save(const upo_ht_linprob_t ht, const char *path, upo_ht_serializer_t key_serialize, upo_ht_serializer_t value_serialize)
+{
+    upo_ht_snapshot_header_t header;
+    upo_ht_snapshot_slot_t *slots = NULL;
+    upo_ht_snapshot_item_t *items = NULL;
+    upo_ht_linprob_iter_t it;
+    size_t size = upo_ht_linprob_size(ht);
+    size_t capacity = 1;
+    size_t i;
+    size_t k;
+    uint64_t blob_size = 0;
+    void *key = NULL;
+    void *value = NULL;
+    FILE *fp = NULL;
+    int ok = 1;
+
+    /* preconditions */
+    assert( path != NULL );
+    assert( key_serialize != NULL );
+    assert( value_serialize != NULL );
+
+    /* Keep the load factor at most 1/2, so that probe sequences are short */
+    while (capacity < 2*size)
+    {
+        capacity *= 2;
+    }
+
+    slots = malloc(capacity*sizeof(upo_ht_snapshot_slot_t));
+    items = malloc((size > 0 ? size : 1)*sizeof(upo_ht_snapshot_item_t));
+    if (slots == NULL || items == NULL)
+    {
+        perror("Unable to allocate memory for the slots of the snapshot");
+        abort();
+    }
+    for (i = 0; i < capacity; ++i)
+    {
+        slots[i].hash = 0;
+        slots[i].key_offset = UPO_HT_SNAPSHOT_NONE;
+        slots[i].key_size = 0;
+        slots[i].value_offset = UPO_HT_SNAPSHOT_NONE;
+        slots[i].value_size = 0;
+    }
+
+    /* Place keys in the slot array, using the hash values cached by the
+     * table, and lay out the blob region, serializing each key and value once */
+    k = 0;
+    upo_ht_linprob_iter_begin(ht, &it);
+    while (upo_ht_linprob_iter_next(&it, &key, &value))
+    {
+        uint64_t hash = upo_ht_linprob_iter_hash(&it);
+        upo_ht_snapshot_item_t *item = &items[k++];
+
+        i = hash & (capacity - 1);
+        while (slots[i].key_offset != UPO_HT_SNAPSHOT_NONE)
+        {
+            i = (i + 1) & (capacity - 1);
+        }
+        item->key_size = key_serialize(key, &item->key_bytes);
+        item->value_bytes = NULL;
+        item->value_size = 0;
+        slots[i].hash = hash;
+        slots[i].key_offset = blob_size;
+        slots[i].key_size = item->key_size;
+        blob_size += upo_ht_snapshot_align(item->key_size);
+        if (value != NULL)
+        {
+            item->value_size = value_serialize(value, &item->value_bytes);
+            slots[i].value_offset = blob_size;
+            slots[i].value_size = item->value_size;
+            blob_size += upo_ht_snapshot_align(item->value_size);
+        }
+    }
+
+    memset(&header, 0, sizeof header);
+    memcpy(header.magic, UPO_HT_SNAPSHOT_MAGIC, sizeof UPO_HT_SNAPSHOT_MAGIC);
+    header.version = UPO_HT_SNAPSHOT_VERSION;
+    header.byte_order = UPO_HT_SNAPSHOT_BYTE_ORDER;
+    header.capacity = capacity;
+    header.size = size;
+    header.slots_offset = upo_ht_snapshot_align(sizeof header);
+    header.blob_offset = upo_ht_snapshot_align(header.slots_offset + capacity*sizeof(upo_ht_snapshot_slot_t));
+    header.blob_size = blob_size;
+
+    /* Write everything in one sequential pass, in the same order used above */
+    fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        int err = errno;
+
+        free(items);
+        free(slots);
+        errno = err;
+        return 0;
+    }
+    ok = fwrite(&header, sizeof header, 1, fp) == 1
+         && upo_ht_snapshot_write_padding(fp, header.slots_offset - sizeof header)
+         && fwrite(slots, sizeof(upo_ht_snapshot_slot_t), capacity, fp) == capacity
+         && upo_ht_snapshot_write_padding(fp, header.blob_offset - header.slots_offset - capacity*sizeof(upo_ht_snapshot_slot_t));
+    for (k = 0; ok && k < size; ++k)
+    {
+        const upo_ht_snapshot_item_t *item = &items[k];
+
+        ok = fwrite(item->key_bytes, 1, item->key_size, fp) == item->key_size
+             && upo_ht_snapshot_write_padding(fp, upo_ht_snapshot_align(item->key_size) - item->key_size);
+        if (ok && item->value_bytes != NULL)
+        {
+            ok = fwrite(item->value_bytes, 1, item->value_size, fp) == item->value_size
+                 && upo_ht_snapshot_write_padding(fp, upo_ht_snapshot_align(item->value_size) - item->value_size);
+        }
+    }
+    free(items);
+    free(slots);
+
+    if (!ok)
+    {
+        int err = errno;
+
+        fclose(fp);
+        errno = err;
+        return 0;
+    }
+
+    return fclose(fp) == 0;
+}
+
+upo_ht_linprob_snapshot_t upo_ht_linprob_snapshot_open(const char *path, upo_ht_hasher_t key_hash, upo_ht_serializer_t key_serialize)
+{
+    upo_ht_linprob_snapshot_t snap = NULL;
+    const upo_ht_snapshot_header_t *header = NULL;
+    struct stat st;
+    void *map = NULL;
+    size_t map_size = 0;
+    int fd = -1;
+
+    /* preconditions */
+    assert( path != NULL );
+    assert( key_hash != NULL );
+    assert( key_serialize != NULL );
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+    if (fstat(fd, &st) != 0)
+    {
+        int err = errno;
+
+        close(fd);
+        errno = err;
+        return NULL;
+    }
+    if (st.st_size < (off_t) sizeof(upo_ht_snapshot_header_t))
+    {
+        close(fd);
+        errno = EINVAL;
+        return NULL;
+    }
+    map_size = (size_t) st.st_size;
+    map = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    /* The mapping keeps its own reference to the file */
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    /* Only the header is checked: the rest of the file is used as it is */
+    header = map;
+    if (memcmp(header->magic, UPO_HT_SNAPSHOT_MAGIC, sizeof UPO_HT_SNAPSHOT_MAGIC) != 0
+        || header->version != UPO_HT_SNAPSHOT_VERSION
+        || header->byte_order != UPO_HT_SNAPSHOT_BYTE_ORDER
+        || header->capacity == 0
+        || (header->capacity & (header->capacity - 1)) != 0
+        || header->size >= header->capacity
+        || header->slots_offset % UPO_HT_SNAPSHOT_ALIGNMENT != 0
+        || header->blob_offset % UPO_HT_SNAPSHOT_ALIGNMENT != 0
+        || header->slots_offset > map_size
+        || header->capacity > (map_size - header->slots_offset)/sizeof(upo_ht_snapshot_slot_t)
+        || header->blob_offset > map_size
+        || header->blob_size > map_size - header->blob_offset)
+    {
+        munmap(map, map_size);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    /* Lookups jump around the slot array: do not read ahead */
+    posix_madvise(map, map_size, POSIX_MADV_RANDOM);
+
+    snap = malloc(sizeof(struct upo_ht_linprob_snapshot_s));
+    if (snap == NULL)
+    {
+        perror("Unable to allocate memory for a snapshot");
+        abort();
+    }
+    snap->map = map;
+    snap->map_size = map_size;
+    snap->header = header;
+    snap->slots = (const upo_ht_snapshot_slot_t*) ((const unsigned char*) map + header->slots_offset);
+    snap->blob = (const unsigned char*) map + header->blob_offset;
+    snap->key_hash = key_hash;
+    snap->key_serialize = key_serialize;
+
+    return snap;
+}
+
+void upo_ht_linprob_snapshot_close(upo_ht_linprob_snapshot_t snap)
+{
+    if (snap != NULL)
+    {
+        munmap(snap->map, snap->map_size);
+        free(snap);
+    }
+}
+
+const upo_ht_snapshot_slot_t* upo_ht_linprob_snapshot_find(const upo_ht_linprob_snapshot_t snap, const void *key)
+{
+    size_t mask = snap->header->capacity - 1;
+    uint64_t hash = snap->key_hash(key);
+    const void *bytes = NULL;
+    size_t size = snap->key_serialize(key, &bytes);
+    size_t i = hash & mask;
+    size_t n;
+
+    /* The bound on probes only matters for corrupted files, since at least
+     * half of the slots are empty */
+    for (n = 0; n <= mask; ++n)
+    {
+        const upo_ht_snapshot_slot_t *slot = &snap->slots[i];
+
+        if (slot->key_offset == UPO_HT_SNAPSHOT_NONE)
+        {
+            return NULL;
+        }
+        if (slot->hash == hash
+            && slot->key_size == size
+            && memcmp(snap->blob + slot->key_offset, bytes, size) == 0)
+        {
+            return slot;
+        }
+        i = (i + 1) & mask;
+    }
+
+    return NULL;
+}
+
+const void* upo_ht_linprob_snapshot_get(const upo_ht_linprob_snapshot_t snap, const void *key)
+{
+    const upo_ht_snapshot_slot_t *slot = NULL;
+
+    if (snap == NULL)
+    {
+        return NULL;
+    }
+
+    slot = upo_ht_linprob_snapshot_find(snap, key);
+    if (slot == NULL || slot->value_offset == UPO_HT_SNAPSHOT_NONE)
+    {
+        return NULL;
+    }
+
+    return snap->blob + slot->value_offset;
+}
+
+int upo_ht_linprob_snapshot_contains(const upo_ht_linprob_snapshot_t snap, const void *key)
+{
+    return snap != NULL && upo_ht_linprob_snapshot_find(snap, key) != NULL;
+}
+
+size_t upo_ht_linprob_snapshot_size(const upo_ht_linprob_snapshot_t snap)
+{
+    return (snap != NULL) ? snap->header->size : 0;
+}
+
+size_t upo_ht_linprob_snapshot_capacity(const upo_ht_linprob_snapshot_t snap)
+{
+    return (snap != NULL) ? snap->header->capacity : 0;
+}
+
+int upo_ht_linprob_snapshot_is_empty(const upo_ht_linprob_snapshot_t snap)
+{
+    return upo_ht_linprob_snapshot_size(snap) == 0;
+}
+
+void upo_ht_linprob_snapshot_traverse(const upo_ht_linprob_snapshot_t snap, upo_ht_visitor_t visit, void *visit_context)
+{
+    if (snap != NULL)
+    {
+        size_t i;
+
+        for (i = 0; i < snap->header->capacity; ++i)
+        {
+            const upo_ht_snapshot_slot_t *slot = &snap->slots[i];
+
+            if (slot->key_offset != UPO_HT_SNAPSHOT_NONE)
+            {
+                void *value = NULL;
+
+                if (slot->value_offset != UPO_HT_SNAPSHOT_NONE)
+                {
+                    value = (void*) (snap->blob + slot->value_offset);
+                }
+                visit((void*) (snap->blob + slot->key_offset), value, visit_context);
+            }
+        }
+    }
+}
+
+
+/*** END of SNAPSHOT of HASH TABLE with LINEAR PROBING ***/
@@ -0,0 +1,145 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/hashtable_snapshot_private.h
+ *
+ * \brief Private header for the snapshots of Hash Tables.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HASHTABLE_SNAPSHOT_PRIVATE_H
+#define UPO_HASHTABLE_SNAPSHOT_PRIVATE_H
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <upo/hashtable_snapshot.h>
+
+
+/** \brief The magic number at the beginning of snapshot files. */
+#define UPO_HT_SNAPSHOT_MAGIC "UPOHTLP"
+
+/** \brief The version of the format of snapshot files. */
+#define UPO_HT_SNAPSHOT_VERSION 1U
+
+/** \brief A known value used to detect snapshots saved with another byte order. */
+#define UPO_HT_SNAPSHOT_BYTE_ORDER 0x01020304U
+
+/**
+ * \brief The alignment (in bytes) of the slot array and of keys and values in
+ *  the blob region.
+ */
+#define UPO_HT_SNAPSHOT_ALIGNMENT 16U
+
+/** \brief The offset marking empty slots and `NULL` values. */
+#define UPO_HT_SNAPSHOT_NONE UINT64_MAX
+
+
+/** \brief Type for the header of snapshot files. */
+struct upo_ht_snapshot_header_s
+{
+    char magic[8]; /**< The magic number #UPO_HT_SNAPSHOT_MAGIC. */
+    uint32_t version; /**< The version #UPO_HT_SNAPSHOT_VERSION of the format. */
+    uint32_t byte_order; /**< The value #UPO_HT_SNAPSHOT_BYTE_ORDER in native byte order. */
+    uint64_t capacity; /**< The number of slots (a power of two). */
+    uint64_t size; /**< The number of stored key-value pairs. */
+    uint64_t slots_offset; /**< The file offset of the slot array. */
+    uint64_t blob_offset; /**< The file offset of the blob region. */
+    uint64_t blob_size; /**< The number of bytes of the blob region. */
+    uint64_t reserved; /**< Reserved for future use (zero). */
+};
+
+/** \brief Alias for the type for the header of snapshot files. */
+typedef struct upo_ht_snapshot_header_s upo_ht_snapshot_header_t;
+
+/** \brief Type for slots of snapshot files. */
+struct upo_ht_snapshot_slot_s
+{
+    uint64_t hash; /**< The full hash value of the key. */
+    uint64_t key_offset; /**< The offset of the key in the blob region, or #UPO_HT_SNAPSHOT_NONE if the slot is empty. */
+    uint64_t key_size; /**< The number of bytes of the key. */
+    uint64_t value_offset; /**< The offset of the value in the blob region, or #UPO_HT_SNAPSHOT_NONE if the value is `NULL`. */
+    uint64_t value_size; /**< The number of bytes of the value. */
+};
+
+/** \brief Alias for the type for slots of snapshot files. */
+typedef struct upo_ht_snapshot_slot_s upo_ht_snapshot_slot_t;
+
+
+/*** BEGIN of SNAPSHOT of HASH TABLE with LINEAR PROBING ***/
+
+
+/** \brief Type for the serialized bytes of a key-value pair, in the order they are written to the blob region. */
+struct upo_ht_snapshot_item_s
+{
+    const void *key_bytes; /**< The bytes of the key. */
+    const void *value_bytes; /**< The bytes of the value, or `NULL` if the value is `NULL`. */
+    size_t key_size; /**< The number of bytes of the key. */
+    size_t value_size; /**< The number of bytes of the value. */
+};
+
+/** \brief Alias for the type for the serialized bytes of a key-value pair. */
+typedef struct upo_ht_snapshot_item_s upo_ht_snapshot_item_t;
+
+/** \brief Type for read-only snapshots of hash tables with linear probing. */
+struct upo_ht_linprob_snapshot_s
+{
+    void *map; /**< The address of the mapped file. */
+    size_t map_size; /**< The number of mapped bytes. */
+    const upo_ht_snapshot_header_t *header; /**< The header of the file. */
+    const upo_ht_snapshot_slot_t *slots; /**< The slot array of the file. */
+    const unsigned char *blob; /**< The blob region of the file. */
+    upo_ht_hasher_t key_hash; /**< The key hash function. */
+    upo_ht_serializer_t key_serialize; /**< The key serialization function. */
+};
+
+
+/**
+ * \brief Rounds up the given size to a multiple of #UPO_HT_SNAPSHOT_ALIGNMENT.
+ *
+ * \param n The size.
+ * \return The smallest multiple of the alignment not less than \a n.
+ */
+static uint64_t upo_ht_snapshot_align(uint64_t n);
+
+/**
+ * \brief Writes the given number of zero bytes to the given stream.
+ *
+ * \param fp The stream.
+ * \param n The number of bytes.
+ * \return `1` on success, or `0` on error.
+ */
+static int upo_ht_snapshot_write_padding(FILE *fp, size_t n);
+
+/**
+ * \brief Finds the slot of the given snapshot holding the given key.
+ *
+ * \param snap The snapshot.
+ * \param key The key.
+ * \return The slot holding the key, or `NULL` if the key is not found.
+ */
+static const upo_ht_snapshot_slot_t* upo_ht_linprob_snapshot_find(const upo_ht_linprob_snapshot_t snap, const void *key);
+
+
+/*** END of SNAPSHOT of HASH TABLE with LINEAR PROBING ***/
+
+
+#endif /* UPO_HASHTABLE_SNAPSHOT_PRIVATE_H */
@@ -0,0 +1,797 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Threads are a POSIX extension */
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <errno.h>
+#include "hset_private.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/*** BEGIN of COMMON FUNCTIONS ***/
+
+
+void upo_hset_init(struct upo_hset_s *set, size_t capacity, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp, int with_counts)
+{
+    assert( capacity >= UPO_HSET_MIN_CAPACITY && (capacity & (capacity - 1)) == 0 );
+
+    /* Empty slots have a NULL key */
+    set->slots = calloc(capacity, sizeof(upo_hset_slot_t));
+    if (set->slots == NULL)
+    {
+        perror("Unable to allocate memory for slots of the Hash Set");
+        abort();
+    }
+    set->counts = NULL;
+    if (with_counts)
+    {
+        set->counts = calloc(capacity, sizeof(size_t));
+        if (set->counts == NULL)
+        {
+            perror("Unable to allocate memory for counters of the Hash Multiset");
+            abort();
+        }
+    }
+    set->capacity = capacity;
+    set->size = 0;
+    set->key_hash = key_hash;
+    set->key_cmp = key_cmp;
+}
+
+void upo_hset_empty(struct upo_hset_s *set, int destroy_data)
+{
+    size_t i;
+
+    if (destroy_data)
+    {
+        for (i = 0; i < set->capacity; ++i)
+        {
+            free(set->slots[i].key);
+        }
+    }
+    memset(set->slots, 0, set->capacity*sizeof(upo_hset_slot_t));
+    if (set->counts != NULL)
+    {
+        memset(set->counts, 0, set->capacity*sizeof(size_t));
+    }
+    set->size = 0;
+}
+
+size_t upo_hset_capacity_for(size_t n)
+{
+    size_t capacity = UPO_HSET_MIN_CAPACITY;
+
+    while (n > capacity*UPO_HSET_MAX_LOAD_FACTOR)
+    {
+        capacity <<= 1;
+    }
+
+    return capacity;
+}
+
+upo_hset_t upo_hset_create_like(const struct upo_hset_s *set, size_t n)
+{
+    return upo_hset_create(upo_hset_capacity_for(n), set->key_hash, set->key_cmp);
+}
+
+int upo_hset_find(const struct upo_hset_s *set, const void *key, uint64_t hash, size_t *index)
+{
+    size_t mask = set->capacity - 1;
+    size_t i = (size_t) hash & mask;
+
+    /* The load factor is bounded, so there is always an empty slot */
+    while (set->slots[i].key != NULL)
+    {
+        if (set->slots[i].hash == hash && set->key_cmp(set->slots[i].key, key) == 0)
+        {
+            *index = i;
+            return 1;
+        }
+        i = (i + 1) & mask;
+    }
+    *index = i;
+
+    return 0;
+}
+
+size_t upo_hset_insert_new(struct upo_hset_s *set, void *key, uint64_t hash)
+{
+    size_t mask = 0;
+    size_t i = 0;
+
+    assert( key != NULL );
+
+    if (set->size + 1 > set->capacity*UPO_HSET_MAX_LOAD_FACTOR)
+    {
+        upo_hset_resize(set, set->capacity << 1);
+    }
+
+    mask = set->capacity - 1;
+    i = (size_t) hash & mask;
+    while (set->slots[i].key != NULL)
+    {
+        i = (i + 1) & mask;
+    }
+    set->slots[i].key = key;
+    set->slots[i].hash = hash;
+    set->size += 1;
+
+    return i;
+}
+
+void upo_hset_remove_at(struct upo_hset_s *set, size_t index)
+{
+    size_t mask = set->capacity - 1;
+    size_t i = index;
+    size_t j = index;
+
+    /* Backward shift: move back each following key of the cluster whose home
+     * slot is not cyclically in (i, j], so that no probe sequence is broken */
+    for (;;)
+    {
+        size_t home = 0;
+
+        j = (j + 1) & mask;
+        if (set->slots[j].key == NULL)
+        {
+            break;
+        }
+        home = (size_t) set->slots[j].hash & mask;
+        if ((i <= j) ? (i < home && home <= j) : (i < home || home <= j))
+        {
+            continue;
+        }
+        set->slots[i] = set->slots[j];
+        if (set->counts != NULL)
+        {
+            set->counts[i] = set->counts[j];
+        }
+        i = j;
+    }
+    set->slots[i].key = NULL;
+    set->slots[i].hash = 0;
+    if (set->counts != NULL)
+    {
+        set->counts[i] = 0;
+    }
+    set->size -= 1;
+}
+
+void upo_hset_resize(struct upo_hset_s *set, size_t capacity)
+{
+    struct upo_hset_s old = *set;
+    size_t i;
+
+    assert( capacity*UPO_HSET_MAX_LOAD_FACTOR >= set->size );
+
+    upo_hset_init(set, capacity, old.key_hash, old.key_cmp, old.counts != NULL);
+    for (i = 0; i < old.capacity; ++i)
+    {
+        if (old.slots[i].key != NULL)
+        {
+            /* Keys are distinct, and their hash value is cached */
+            size_t j = upo_hset_insert_new(set, old.slots[i].key, old.slots[i].hash);
+
+            if (old.counts != NULL)
+            {
+                set->counts[j] = old.counts[i];
+            }
+        }
+    }
+    free(old.slots);
+    free(old.counts);
+}
+
+void* upo_hset_select(void *arg)
+{
+    upo_hset_select_work_t *work = arg;
+    size_t i;
+
+    work->num_selected = 0;
+    for (i = work->begin; i < work->end; ++i)
+    {
+        const upo_hset_slot_t *slot = &work->src->slots[i];
+        size_t j = 0;
+
+        if (slot->key != NULL && upo_hset_find(work->probe, slot->key, slot->hash, &j) == work->keep_present)
+        {
+            work->selected[work->num_selected++] = *slot;
+        }
+    }
+
+    return NULL;
+}
+
+upo_hset_slot_t* upo_hset_select_parallel(const struct upo_hset_s *src, const struct upo_hset_s *probe, int keep_present, size_t num_threads, size_t *num_selected)
+{
+    upo_hset_select_work_t *works = NULL;
+    pthread_t *threads = NULL;
+    upo_hset_slot_t *selected = NULL;
+    size_t chunk = 0;
+    size_t t;
+
+    if (num_threads == 0)
+    {
+        num_threads = 1;
+    }
+    if (num_threads > src->capacity)
+    {
+        num_threads = src->capacity;
+    }
+
+    works = malloc(num_threads*sizeof(upo_hset_select_work_t));
+    threads = malloc(num_threads*sizeof(pthread_t));
+    /* Each thread writes the keys it selects in its own part of the array, so
+     * no synchronization is needed */
+    selected = malloc((src->size > 0 ? src->size : 1)*sizeof(upo_hset_slot_t));
+    if (works == NULL || threads == NULL || selected == NULL)
+    {
+        perror("Unable to allocate memory for the threads of the Hash Set");
+        abort();
+    }
+
+    chunk = (src->capacity + num_threads - 1) / num_threads;
+    for (t = 0; t < num_threads; ++t)
+    {
+        works[t].src = src;
+        works[t].probe = probe;
+        works[t].keep_present = keep_present;
+        works[t].begin = (t*chunk < src->capacity) ? t*chunk : src->capacity;
+        works[t].end = (works[t].begin + chunk < src->capacity) ? works[t].begin + chunk : src->capacity;
+        works[t].selected = NULL;
+        works[t].num_selected = 0;
+    }
+
+    /* The first pass counts keys per range, so that each thread knows where
+     * to write in the shared output array */
+    for (t = 0; t < num_threads; ++t)
+    {
+        size_t i;
+
+        for (i = works[t].begin; i < works[t].end; ++i)
+        {
+            works[t].num_selected += (src->slots[i].key != NULL);
+        }
+    }
+    for (t = 0; t < num_threads; ++t)
+    {
+        works[t].selected = (t == 0) ? selected : works[t-1].selected + works[t-1].num_selected;
+    }
+
+    /* The calling thread takes the first range */
+    for (t = 1; t < num_threads; ++t)
+    {
+        int rc = pthread_create(&threads[t], NULL, upo_hset_select, &works[t]);
+
+        if (rc != 0)
+        {
+            errno = rc;
+            perror("Unable to create a thread of the Hash Set");
+            abort();
+        }
+    }
+    upo_hset_select(&works[0]);
+    for (t = 1; t < num_threads; ++t)
+    {
+        pthread_join(threads[t], NULL);
+    }
+
+    /* Compact the parts of the output array */
+    *num_selected = 0;
+    for (t = 0; t < num_threads; ++t)
+    {
+        memmove(selected + *num_selected, works[t].selected, works[t].num_selected*sizeof(upo_hset_slot_t));
+        *num_selected += works[t].num_selected;
+    }
+
+    free(threads);
+    free(works);
+
+    return selected;
+}
+
+
+/*** END of COMMON FUNCTIONS ***/
+
+
+/*** BEGIN of HASH SET ***/
+
+
+upo_hset_t upo_hset_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_hset_t set = NULL;
+    size_t capacity = UPO_HSET_MIN_CAPACITY;
+
+    assert( key_hash != NULL );
+    assert( key_cmp != NULL );
+
+    set = malloc(sizeof(struct upo_hset_s));
+    if (set == NULL)
+    {
+        perror("Unable to allocate memory for Hash Set");
+        abort();
+    }
+    while (capacity < m)
+    {
+        capacity <<= 1;
+    }
+    upo_hset_init(set, capacity, key_hash, key_cmp, 0);
+
+    return set;
+}
+
+void upo_hset_destroy(upo_hset_t set, int destroy_data)
+{
+    if (set != NULL)
+    {
+        upo_hset_clear(set, destroy_data);
+        free(set->slots);
+        free(set->counts);
+        free(set);
+    }
+}
+
+void upo_hset_clear(upo_hset_t set, int destroy_data)
+{
+    if (set != NULL)
+    {
+        upo_hset_empty(set, destroy_data);
+    }
+}
+
+upo_hset_t upo_hset_copy(const upo_hset_t set)
+{
+    upo_hset_t copy = NULL;
+
+    if (set == NULL)
+    {
+        return NULL;
+    }
+
+    copy = upo_hset_create(set->capacity, set->key_hash, set->key_cmp);
+    memcpy(copy->slots, set->slots, set->capacity*sizeof(upo_hset_slot_t));
+    copy->size = set->size;
+
+    return copy;
+}
+
+int upo_hset_add(upo_hset_t set, void *key)
+{
+    uint64_t hash = 0;
+    size_t i = 0;
+
+    assert( set != NULL );
+    assert( key != NULL );
+
+    hash = set->key_hash(key);
+    if (upo_hset_find(set, key, hash, &i))
+    {
+        return 0;
+    }
+    upo_hset_insert_new(set, key, hash);
+
+    return 1;
+}
+
+void* upo_hset_get(const upo_hset_t set, const void *key)
+{
+    size_t i = 0;
+
+    if (set != NULL && upo_hset_find(set, key, set->key_hash(key), &i))
+    {
+        return set->slots[i].key;
+    }
+
+    return NULL;
+}
+
+int upo_hset_contains(const upo_hset_t set, const void *key)
+{
+    return upo_hset_get(set, key) != NULL;
+}
+
+void upo_hset_remove(upo_hset_t set, const void *key, int destroy_data)
+{
+    size_t i = 0;
+
+    if (set != NULL && upo_hset_find(set, key, set->key_hash(key), &i))
+    {
+        if (destroy_data)
+        {
+            free(set->slots[i].key);
+        }
+        upo_hset_remove_at(set, i);
+    }
+}
+
+size_t upo_hset_size(const upo_hset_t set)
+{
+    return (set != NULL) ? set->size : 0;
+}
+
+int upo_hset_is_empty(const upo_hset_t set)
+{
+    return upo_hset_size(set) == 0;
+}
+
+size_t upo_hset_capacity(const upo_hset_t set)
+{
+    return (set != NULL) ? set->capacity : 0;
+}
+
+double upo_hset_load_factor(const upo_hset_t set)
+{
+    return (set != NULL) ? set->size / (double) set->capacity : 0;
+}
+
+void upo_hset_traverse(const upo_hset_t set, upo_hset_visitor_t visit, void *visit_context)
+{
+    size_t i;
+
+    if (set == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < set->capacity; ++i)
+    {
+        if (set->slots[i].key != NULL)
+        {
+            visit(set->slots[i].key, visit_context);
+        }
+    }
+}
+
+upo_hset_t upo_hset_union(const upo_hset_t a, const upo_hset_t b)
+{
+    upo_hset_t small = NULL;
+    upo_hset_t res = NULL;
+    size_t i;
+
+    assert( a != NULL && b != NULL );
+    assert( a->key_hash == b->key_hash && a->key_cmp == b->key_cmp );
+
+    res = upo_hset_copy(a->size >= b->size ? a : b);
+    small = (a->size >= b->size) ? b : a;
+    for (i = 0; i < small->capacity; ++i)
+    {
+        const upo_hset_slot_t *slot = &small->slots[i];
+        size_t j = 0;
+
+        if (slot->key != NULL && !upo_hset_find(res, slot->key, slot->hash, &j))
+        {
+            upo_hset_insert_new(res, slot->key, slot->hash);
+        }
+    }
+
+    return res;
+}
+
+upo_hset_t upo_hset_intersect(const upo_hset_t a, const upo_hset_t b)
+{
+    upo_hset_t small = NULL;
+    upo_hset_t large = NULL;
+    upo_hset_t res = NULL;
+    size_t i;
+
+    assert( a != NULL && b != NULL );
+    assert( a->key_hash == b->key_hash && a->key_cmp == b->key_cmp );
+
+    small = (a->size <= b->size) ? a : b;
+    large = (a->size <= b->size) ? b : a;
+    res = upo_hset_create_like(small, small->size);
+    for (i = 0; i < small->capacity; ++i)
+    {
+        const upo_hset_slot_t *slot = &small->slots[i];
+        size_t j = 0;
+
+        if (slot->key != NULL && upo_hset_find(large, slot->key, slot->hash, &j))
+        {
+            upo_hset_insert_new(res, slot->key, slot->hash);
+        }
+    }
+
+    return res;
+}
+
+upo_hset_t upo_hset_difference(const upo_hset_t a, const upo_hset_t b)
+{
+    upo_hset_t res = NULL;
+    size_t i;
+
+    assert( a != NULL && b != NULL );
+    assert( a->key_hash == b->key_hash && a->key_cmp == b->key_cmp );
+
+    if (a->size <= b->size)
+    {
+        res = upo_hset_create_like(a, a->size);
+        for (i = 0; i < a->capacity; ++i)
+        {
+            const upo_hset_slot_t *slot = &a->slots[i];
+            size_t j = 0;
+
+            if (slot->key != NULL && !upo_hset_find(b, slot->key, slot->hash, &j))
+            {
+                upo_hset_insert_new(res, slot->key, slot->hash);
+            }
+        }
+    }
+    else
+    {
+        res = upo_hset_copy(a);
+        for (i = 0; i < b->capacity; ++i)
+        {
+            const upo_hset_slot_t *slot = &b->slots[i];
+            size_t j = 0;
+
+            if (slot->key != NULL && upo_hset_find(res, slot->key, slot->hash, &j))
+            {
+                upo_hset_remove_at(res, j);
+            }
+        }
+    }
+
+    return res;
+}
+
+upo_hset_t upo_hset_union_parallel(const upo_hset_t a, const upo_hset_t b, size_t num_threads)
+{
+    upo_hset_t small = NULL;
+    upo_hset_t large = NULL;
+    upo_hset_slot_t *missing = NULL;
+    size_t num_missing = 0;
+    upo_hset_t res = NULL;
+    size_t i;
+
+    assert( a != NULL && b != NULL );
+    assert( a->key_hash == b->key_hash && a->key_cmp == b->key_cmp );
+
+    small = (a->size >= b->size) ? b : a;
+    large = (a->size >= b->size) ? a : b;
+    missing = upo_hset_select_parallel(small, large, 0, num_threads, &num_missing);
+    res = upo_hset_copy(large);
+    if (res->size + num_missing > res->capacity*UPO_HSET_MAX_LOAD_FACTOR)
+    {
+        upo_hset_resize(res, upo_hset_capacity_for(res->size + num_missing));
+    }
+    for (i = 0; i < num_missing; ++i)
+    {
+        upo_hset_insert_new(res, missing[i].key, missing[i].hash);
+    }
+    free(missing);
+
+    return res;
+}
+
+upo_hset_t upo_hset_intersect_parallel(const upo_hset_t a, const upo_hset_t b, size_t num_threads)
+{
+    upo_hset_t small = NULL;
+    upo_hset_t large = NULL;
+    upo_hset_slot_t *common = NULL;
+    size_t num_common = 0;
+    upo_hset_t res = NULL;
+    size_t i;
+
+    assert( a != NULL && b != NULL );
+    assert( a->key_hash == b->key_hash && a->key_cmp == b->key_cmp );
+
+    small = (a->size <= b->size) ? a : b;
+    large = (a->size <= b->size) ? b : a;
+    common = upo_hset_select_parallel(small, large, 1, num_threads, &num_common);
+    res = upo_hset_create_like(small, num_common);
+    for (i = 0; i < num_common; ++i)
+    {
+        upo_hset_insert_new(res, common[i].key, common[i].hash);
+    }
+    free(common);
+
+    return res;
+}
+
+upo_hset_t upo_hset_difference_parallel(const upo_hset_t a, const upo_hset_t b, size_t num_threads)
+{
+    upo_hset_slot_t *selected = NULL;
+    size_t num_selected = 0;
+    upo_hset_t res = NULL;
+    size_t i;
+
+    assert( a != NULL && b != NULL );
+    assert( a->key_hash == b->key_hash && a->key_cmp == b->key_cmp );
+
+    if (a->size <= b->size)
+    {
+        /* Keep the keys of a missing from b */
+        selected = upo_hset_select_parallel(a, b, 0, num_threads, &num_selected);
+        res = upo_hset_create_like(a, num_selected);
+        for (i = 0; i < num_selected; ++i)
+        {
+            upo_hset_insert_new(res, selected[i].key, selected[i].hash);
+        }
+    }
+    else
+    {
+        /* Remove the keys of b present in a from a copy of a */
+        selected = upo_hset_select_parallel(b, a, 1, num_threads, &num_selected);
+        res = upo_hset_copy(a);
+        for (i = 0; i < num_selected; ++i)
+        {
+            size_t j = 0;
+
+            if (upo_hset_find(res, selected[i].key, selected[i].hash, &j))
+            {
+                upo_hset_remove_at(res, j);
+            }
+        }
+    }
+    free(selected);
+
+    return res;
+}
+
+
+/*** END of HASH SET ***/
+
+
+/*** BEGIN of HASH MULTISET ***/
+
+
+upo_hmset_t upo_hmset_create(size_t m, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp)
+{
+    upo_hmset_t mset = NULL;
+    size_t capacity = UPO_HSET_MIN_CAPACITY;
+
+    assert( key_hash != NULL );
+    assert( key_cmp != NULL );
+
+    mset = malloc(sizeof(struct upo_hmset_s));
+    if (mset == NULL)
+    {
+        perror("Unable to allocate memory for Hash Multiset");
+        abort();
+    }
+    while (capacity < m)
+    {
+        capacity <<= 1;
+    }
+    upo_hset_init(&mset->set, capacity, key_hash, key_cmp, 1);
+    mset->total = 0;
+
+    return mset;
+}
+
+void upo_hmset_destroy(upo_hmset_t mset, int destroy_data)
+{
+    if (mset != NULL)
+    {
+        upo_hmset_clear(mset, destroy_data);
+        free(mset->set.slots);
+        free(mset->set.counts);
+        free(mset);
+    }
+}
+
+void upo_hmset_clear(upo_hmset_t mset, int destroy_data)
+{
+    if (mset != NULL)
+    {
+        upo_hset_empty(&mset->set, destroy_data);
+        mset->total = 0;
+    }
+}
+
+size_t upo_hmset_add(upo_hmset_t mset, void *key)
+{
+    uint64_t hash = 0;
+    size_t i = 0;
+
+    assert( mset != NULL );
+    assert( key != NULL );
+
+    hash = mset->set.key_hash(key);
+    if (!upo_hset_find(&mset->set, key, hash, &i))
+    {
+        i = upo_hset_insert_new(&mset->set, key, hash);
+    }
+    mset->total += 1;
+
+    return ++mset->set.counts[i];
+}
+
+size_t upo_hmset_remove(upo_hmset_t mset, const void *key, int destroy_data)
+{
+    size_t i = 0;
+    size_t count = 0;
+
+    if (mset == NULL || !upo_hset_find(&mset->set, key, mset->set.key_hash(key), &i))
+    {
+        return 0;
+    }
+
+    mset->total -= 1;
+    count = --mset->set.counts[i];
+    if (count == 0)
+    {
+        if (destroy_data)
+        {
+            free(mset->set.slots[i].key);
+        }
+        upo_hset_remove_at(&mset->set, i);
+    }
+
+    return count;
+}
+
+size_t upo_hmset_count(const upo_hmset_t mset, const void *key)
+{
+    size_t i = 0;
+
+    if (mset != NULL && upo_hset_find(&mset->set, key, mset->set.key_hash(key), &i))
+    {
+        return mset->set.counts[i];
+    }
+
+    return 0;
+}
+
+int upo_hmset_contains(const upo_hmset_t mset, const void *key)
+{
+    return upo_hmset_count(mset, key) > 0;
+}
+
+size_t upo_hmset_size(const upo_hmset_t mset)
+{
+    return (mset != NULL) ? mset->set.size : 0;
+}
+
+size_t upo_hmset_total(const upo_hmset_t mset)
+{
+    return (mset != NULL) ? mset->total : 0;
+}
+
+int upo_hmset_is_empty(const upo_hmset_t mset)
+{
+    return upo_hmset_size(mset) == 0;
+}
+
+void upo_hmset_traverse(const upo_hmset_t mset, upo_hmset_visitor_t visit, void *visit_context)
+{
+    size_t i;
+
+    if (mset == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < mset->set.capacity; ++i)
+    {
+        if (mset->set.slots[i].key != NULL)
+        {
+            visit(mset->set.slots[i].key, mset->set.counts[i], visit_context);
+        }
+    }
+}
+
+
+/*** END of HASH MULTISET ***/
@@ -0,0 +1,195 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/hset_private.h
+ *
+ * \brief Private header for hash-based sets and multisets.
+ *
+ * A multiset is a set whose table also has an array of counters, parallel to
+ * the slot array: the functions moving keys among slots move their counters
+ * too, so that sets and multisets share the same probing code.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_HSET_PRIVATE_H
+#define UPO_HSET_PRIVATE_H
+
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <upo/hset.h>
+
+
+/** \brief The minimum capacity of sets and multisets. */
+#define UPO_HSET_MIN_CAPACITY 8U
+
+
+/** \brief Type for slots of sets. */
+struct upo_hset_slot_s
+{
+    void *key; /**< Pointer to the key, or `NULL` if the slot is empty. */
+    uint64_t hash; /**< The full hash value of the key. */
+};
+
+/** \brief Alias for the type for slots of sets. */
+typedef struct upo_hset_slot_s upo_hset_slot_t;
+
+/** \brief Defines a set. */
+struct upo_hset_s
+{
+    upo_hset_slot_t *slots; /**< The slots. */
+    size_t *counts; /**< The number of occurrences of the key of each slot (multisets only), or `NULL`. */
+    size_t capacity; /**< The number of slots (a power of two). */
+    size_t size; /**< The number of stored keys. */
+    upo_ht_hasher_t key_hash; /**< The key hash function. */
+    upo_ht_comparator_t key_cmp; /**< The key comparison function. */
+};
+
+/** \brief Defines a multiset. */
+struct upo_hmset_s
+{
+    struct upo_hset_s set; /**< The distinct keys, with their number of occurrences. */
+    size_t total; /**< The total number of occurrences. */
+};
+
+/** \brief Type for the work of a thread selecting keys of a set. */
+struct upo_hset_select_work_s
+{
+    const struct upo_hset_s *src; /**< The set whose keys are selected. */
+    const struct upo_hset_s *probe; /**< The set probed for each key. */
+    int keep_present; /**< Whether keys present in \c probe (value `1`) or missing from it (value `0`) are selected. */
+    size_t begin; /**< The first slot of \c src to visit. */
+    size_t end; /**< The slot of \c src after the last one to visit. */
+    upo_hset_slot_t *selected; /**< The selected keys, with their hash value. */
+    size_t num_selected; /**< The number of selected keys. */
+};
+
+/** \brief Alias for the type for the work of a thread selecting keys of a set. */
+typedef struct upo_hset_select_work_s upo_hset_select_work_t;
+
+
+/**
+ * \brief Initializes the given set as empty.
+ *
+ * \param set The set.
+ * \param capacity The number of slots (a power of two).
+ * \param key_hash The key hash function.
+ * \param key_cmp The key comparison function.
+ * \param with_counts Whether counters of occurrences are needed.
+ */
+static void upo_hset_init(struct upo_hset_s *set, size_t capacity, upo_ht_hasher_t key_hash, upo_ht_comparator_t key_cmp, int with_counts);
+
+/**
+ * \brief Frees the keys of the given set (if asked to) and marks all slots
+ *  as empty.
+ *
+ * \param set The set.
+ * \param destroy_data Whether keys must be freed.
+ */
+static void upo_hset_empty(struct upo_hset_s *set, int destroy_data);
+
+/**
+ * \brief Returns the smallest capacity that keeps the given number of keys
+ *  within the maximum load factor.
+ *
+ * \param n The number of keys.
+ * \return A power of two.
+ */
+static size_t upo_hset_capacity_for(size_t n);
+
+/**
+ * \brief Creates an empty set with the same functions as the given one, and
+ *  room for the given number of keys.
+ *
+ * \param set The set.
+ * \param n The number of keys.
+ * \return The new set.
+ */
+static upo_hset_t upo_hset_create_like(const struct upo_hset_s *set, size_t n);
+
+/**
+ * \brief Finds the slot holding the given key.
+ *
+ * \param set The set.
+ * \param key The key.
+ * \param hash The full hash value of the key.
+ * \param index Where the index of the slot holding the key is stored or, if
+ *  the key is not found, the index of the empty slot ending the probe
+ *  sequence.
+ * \return `1` if the key is found, or `0` otherwise.
+ */
+static int upo_hset_find(const struct upo_hset_s *set, const void *key, uint64_t hash, size_t *index);
+
+/**
+ * \brief Stores the given key, which must not be in the set, growing the set
+ *  if needed.
+ *
+ * \param set The set.
+ * \param key The key.
+ * \param hash The full hash value of the key.
+ * \return The index of the slot holding the key.
+ */
+static size_t upo_hset_insert_new(struct upo_hset_s *set, void *key, uint64_t hash);
+
+/**
+ * \brief Empties the given slot, shifting back the following keys of its
+ *  cluster.
+ *
+ * \param set The set.
+ * \param index The index of the slot.
+ */
+static void upo_hset_remove_at(struct upo_hset_s *set, size_t index);
+
+/**
+ * \brief Resizes the given set.
+ *
+ * \param set The set.
+ * \param capacity The new capacity (a power of two).
+ */
+static void upo_hset_resize(struct upo_hset_s *set, size_t capacity);
+
+/**
+ * \brief Selects the keys in a range of slots of a set according to their
+ *  presence in another set.
+ *
+ * \param arg A pointer to a #upo_hset_select_work_t.
+ * \return `NULL`.
+ */
+static void* upo_hset_select(void *arg);
+
+/**
+ * \brief Selects the keys of a set according to their presence in another
+ *  set, using the given number of threads.
+ *
+ * \param src The set whose keys are selected.
+ * \param probe The set probed for each key.
+ * \param keep_present Whether keys present in \a probe (value `1`) or
+ *  missing from it (value `0`) are selected.
+ * \param num_threads The number of threads.
+ * \param num_selected Where the number of selected keys is stored.
+ * \return The selected keys, with their hash value, to be freed with
+ *  `free()`.
+ */
+static upo_hset_slot_t* upo_hset_select_parallel(const struct upo_hset_s *src, const struct upo_hset_s *probe, int keep_present, size_t num_threads, size_t *num_selected);
+
+
+#endif /* UPO_HSET_PRIVATE_H */
@@ -0,0 +1,182 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include "pool_private.h"
+#include <stdalign.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/** \brief The alignment of blocks handed out by pools. */
+#define UPO_POOL_ALIGNMENT alignof(max_align_t)
+
+/** \brief Rounds up the given size to a multiple of the alignment of blocks. */
+#define UPO_POOL_ALIGN(n) (((n) + UPO_POOL_ALIGNMENT - 1) / UPO_POOL_ALIGNMENT * UPO_POOL_ALIGNMENT)
+
+
+upo_pool_t upo_pool_create(size_t block_size, size_t chunk_capacity)
+{
+    upo_pool_t pool = NULL;
+
+    /* preconditions */
+    assert( block_size > 0 );
+
+    pool = malloc(sizeof(struct upo_pool_s));
+    if (pool == NULL)
+    {
+        perror("Unable to create a pool");
+        abort();
+    }
+
+    /* Free blocks store the link to the next free block */
+    if (block_size < sizeof(upo_pool_free_block_t))
+    {
+        block_size = sizeof(upo_pool_free_block_t);
+    }
+
+    pool->chunks = NULL;
+    pool->free_list = NULL;
+    pool->block_size = UPO_POOL_ALIGN(block_size);
+    pool->init_capacity = (chunk_capacity > 0) ? chunk_capacity : UPO_POOL_DEFAULT_CHUNK_CAPACITY;
+    pool->next_block = 0;
+    pool->num_chunks = 0;
+    pool->size = 0;
+
+    return pool;
+}
+
+void upo_pool_destroy(upo_pool_t pool)
+{
+    if (pool != NULL)
+    {
+        upo_pool_clear(pool);
+        free(pool);
+    }
+}
+
+void upo_pool_clear(upo_pool_t pool)
+{
+    if (pool != NULL)
+    {
+        upo_pool_chunk_t *chunk = pool->chunks;
+
+        while (chunk != NULL)
+        {
+            upo_pool_chunk_t *next = chunk->next;
+
+            free(chunk);
+            chunk = next;
+        }
+
+        pool->chunks = NULL;
+        pool->free_list = NULL;
+        pool->next_block = 0;
+        pool->num_chunks = 0;
+        pool->size = 0;
+    }
+}
+
+size_t upo_pool_chunk_header_size()
+{
+    return UPO_POOL_ALIGN(sizeof(upo_pool_chunk_t));
+}
+
+void upo_pool_add_chunk(upo_pool_t pool)
+{
+    upo_pool_chunk_t *chunk = NULL;
+    size_t capacity = pool->init_capacity;
+
+    /* Each chunk doubles the capacity of the previous one, so that the number
+     * of chunks stays logarithmic in the number of blocks */
+    if (pool->chunks != NULL)
+    {
+        capacity = pool->chunks->capacity;
+        if (capacity < UPO_POOL_MAX_CHUNK_CAPACITY)
+        {
+            capacity *= 2;
+        }
+    }
+
+    chunk = malloc(upo_pool_chunk_header_size() + capacity*pool->block_size);
+    if (chunk == NULL)
+    {
+        perror("Unable to allocate memory for a chunk of the pool");
+        abort();
+    }
+
+    chunk->capacity = capacity;
+    chunk->next = pool->chunks;
+    pool->chunks = chunk;
+    pool->next_block = 0;
+    pool->num_chunks += 1;
+}
+
+void* upo_pool_alloc(upo_pool_t pool)
+{
+    void *block = NULL;
+
+    /* preconditions */
+    assert( pool != NULL );
+
+    if (pool->free_list != NULL)
+    {
+        block = pool->free_list;
+        pool->free_list = pool->free_list->next;
+    }
+    else
+    {
+        if (pool->chunks == NULL || pool->next_block == pool->chunks->capacity)
+        {
+            upo_pool_add_chunk(pool);
+        }
+        block = (char*) pool->chunks + upo_pool_chunk_header_size() + pool->next_block*pool->block_size;
+        pool->next_block += 1;
+    }
+    pool->size += 1;
+
+    return block;
+}
+
+void upo_pool_free(upo_pool_t pool, void *block)
+{
+    /* preconditions */
+    assert( pool != NULL );
+
+    if (block != NULL)
+    {
+        upo_pool_free_block_t *free_block = block;
+
+        free_block->next = pool->free_list;
+        pool->free_list = free_block;
+        pool->size -= 1;
+    }
+}
+
+size_t upo_pool_size(const upo_pool_t pool)
+{
+    return (pool != NULL) ? pool->size : 0;
+}
+
+size_t upo_pool_num_chunks(const upo_pool_t pool)
+{
+    return (pool != NULL) ? pool->num_chunks : 0;
+}
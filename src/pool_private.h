@@ -0,0 +1,77 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file pool_private.h
+ *
+ * \brief Private header for the Pool memory allocator.
+ *
+ * Chunks are kept in a singly-linked list; blocks are handed out from the most
+ * recent chunk by bumping an index and, once given back, are threaded into a
+ * free list through their first bytes.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_POOL_PRIVATE_H
+#define UPO_POOL_PRIVATE_H
+
+
+#include <stddef.h>
+#include <upo/pool.h>
+
+
+/** \brief Type for the header of chunks of a pool. */
+struct upo_pool_chunk_s
+{
+    struct upo_pool_chunk_s *next; /**< Pointer to the previously allocated chunk. */
+    size_t capacity; /**< The number of blocks in this chunk. */
+};
+/** \brief Alias for the type for the header of chunks of a pool. */
+typedef struct upo_pool_chunk_s upo_pool_chunk_t;
+
+/** \brief Type for blocks in the free list of a pool. */
+struct upo_pool_free_block_s
+{
+    struct upo_pool_free_block_s *next; /**< Pointer to the next free block. */
+};
+/** \brief Alias for the type for blocks in the free list of a pool. */
+typedef struct upo_pool_free_block_s upo_pool_free_block_t;
+
+/** \brief Defines a pool. */
+struct upo_pool_s
+{
+    upo_pool_chunk_t *chunks; /**< The list of chunks, starting from the most recent one. */
+    upo_pool_free_block_t *free_list; /**< The list of blocks given back to the pool. */
+    size_t block_size; /**< The size of blocks, rounded up to the alignment of blocks. */
+    size_t init_capacity; /**< The number of blocks in the first chunk. */
+    size_t next_block; /**< The index of the first never used block in the most recent chunk. */
+    size_t num_chunks; /**< The number of chunks. */
+    size_t size; /**< The number of blocks in use. */
+};
+
+
+/** \brief Returns the offset of the first block from the start of a chunk. */
+static size_t upo_pool_chunk_header_size();
+
+/** \brief Allocates a new chunk and makes it the most recent one. */
+static void upo_pool_add_chunk(upo_pool_t pool);
+
+
+#endif /* UPO_POOL_PRIVATE_H */
@@ -0,0 +1,797 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include "rbt_private.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/*** BEGIN of NODE OPERATIONS ***/
+
+
+upo_rbt_node_t* upo_rbt_node_create(void *key, void *value)
+{
+    upo_rbt_node_t *node = malloc(sizeof(struct upo_rbt_node_s));
+
+    if (node == NULL)
+    {
+        perror("Unable to allocate memory for a node of the Red-Black Tree");
+        abort();
+    }
+    node->key = key;
+    node->value = value;
+    node->left = NULL;
+    node->right = NULL;
+    node->size = 1;
+    node->color = UPO_RBT_RED;
+
+    return node;
+}
+
+int upo_rbt_is_red(const upo_rbt_node_t *node)
+{
+    return node != NULL && node->color == UPO_RBT_RED;
+}
+
+size_t upo_rbt_node_size(const upo_rbt_node_t *node)
+{
+    return (node != NULL) ? node->size : 0;
+}
+
+upo_rbt_node_t* upo_rbt_rotate_left(upo_rbt_node_t *node)
+{
+    upo_rbt_node_t *x = node->right;
+
+    assert( upo_rbt_is_red(x) );
+
+    node->right = x->left;
+    x->left = node;
+    x->color = node->color;
+    node->color = UPO_RBT_RED;
+    x->size = node->size;
+    node->size = 1 + upo_rbt_node_size(node->left) + upo_rbt_node_size(node->right);
+
+    return x;
+}
+
+upo_rbt_node_t* upo_rbt_rotate_right(upo_rbt_node_t *node)
+{
+    upo_rbt_node_t *x = node->left;
+
+    assert( upo_rbt_is_red(x) );
+
+    node->left = x->right;
+    x->right = node;
+    x->color = node->color;
+    node->color = UPO_RBT_RED;
+    x->size = node->size;
+    node->size = 1 + upo_rbt_node_size(node->left) + upo_rbt_node_size(node->right);
+
+    return x;
+}
+
+void upo_rbt_flip_colors(upo_rbt_node_t *node)
+{
+    node->color = !node->color;
+    node->left->color = !node->left->color;
+    node->right->color = !node->right->color;
+}
+
+upo_rbt_node_t* upo_rbt_move_red_left(upo_rbt_node_t *node)
+{
+    upo_rbt_flip_colors(node);
+    if (upo_rbt_is_red(node->right->left))
+    {
+        node->right = upo_rbt_rotate_right(node->right);
+        node = upo_rbt_rotate_left(node);
+        upo_rbt_flip_colors(node);
+    }
+
+    return node;
+}
+
+upo_rbt_node_t* upo_rbt_move_red_right(upo_rbt_node_t *node)
+{
+    upo_rbt_flip_colors(node);
+    if (upo_rbt_is_red(node->left->left))
+    {
+        node = upo_rbt_rotate_right(node);
+        upo_rbt_flip_colors(node);
+    }
+
+    return node;
+}
+
+upo_rbt_node_t* upo_rbt_balance(upo_rbt_node_t *node)
+{
+    if (upo_rbt_is_red(node->right) && !upo_rbt_is_red(node->left))
+    {
+        node = upo_rbt_rotate_left(node);
+    }
+    if (upo_rbt_is_red(node->left) && upo_rbt_is_red(node->left->left))
+    {
+        node = upo_rbt_rotate_right(node);
+    }
+    if (upo_rbt_is_red(node->left) && upo_rbt_is_red(node->right))
+    {
+        upo_rbt_flip_colors(node);
+    }
+    node->size = 1 + upo_rbt_node_size(node->left) + upo_rbt_node_size(node->right);
+
+    return node;
+}
+
+
+/*** END of NODE OPERATIONS ***/
+
+
+/*** BEGIN of FUNDAMENTAL OPERATIONS ***/
+
+
+upo_rbt_t upo_rbt_create(upo_bst_comparator_t key_cmp)
+{
+    upo_rbt_t tree = NULL;
+
+    assert( key_cmp != NULL );
+
+    tree = malloc(sizeof(struct upo_rbt_s));
+    if (tree == NULL)
+    {
+        perror("Unable to allocate memory for Red-Black Tree");
+        abort();
+    }
+    tree->root = NULL;
+    tree->key_cmp = key_cmp;
+
+    return tree;
+}
+
+void upo_rbt_destroy(upo_rbt_t tree, int destroy_data)
+{
+    if (tree != NULL)
+    {
+        upo_rbt_clear(tree, destroy_data);
+        free(tree);
+    }
+}
+
+void upo_rbt_clear_impl(upo_rbt_node_t *node, int destroy_data)
+{
+    if (node != NULL)
+    {
+        upo_rbt_clear_impl(node->left, destroy_data);
+        upo_rbt_clear_impl(node->right, destroy_data);
+        if (destroy_data)
+        {
+            free(node->key);
+            free(node->value);
+        }
+        free(node);
+    }
+}
+
+void upo_rbt_clear(upo_rbt_t tree, int destroy_data)
+{
+    if (tree != NULL)
+    {
+        upo_rbt_clear_impl(tree->root, destroy_data);
+        tree->root = NULL;
+    }
+}
+
+upo_rbt_node_t* upo_rbt_put_impl(upo_rbt_node_t *node, void *key, void *value, int replace, void **old_value, upo_bst_comparator_t key_cmp)
+{
+    int cmp = 0;
+
+    if (node == NULL)
+    {
+        return upo_rbt_node_create(key, value);
+    }
+
+    cmp = key_cmp(key, node->key);
+    if (cmp < 0)
+    {
+        node->left = upo_rbt_put_impl(node->left, key, value, replace, old_value, key_cmp);
+    }
+    else if (cmp > 0)
+    {
+        node->right = upo_rbt_put_impl(node->right, key, value, replace, old_value, key_cmp);
+    }
+    else if (replace)
+    {
+        *old_value = node->value;
+        node->value = value;
+    }
+
+    /* Fix right-leaning red links and pairs of red links on the way up */
+    return upo_rbt_balance(node);
+}
+
+void* upo_rbt_put(upo_rbt_t tree, void *key, void *value)
+{
+    void *old_value = NULL;
+
+    assert( tree != NULL );
+
+    tree->root = upo_rbt_put_impl(tree->root, key, value, 1, &old_value, tree->key_cmp);
+    tree->root->color = UPO_RBT_BLACK;
+
+    return old_value;
+}
+
+void upo_rbt_insert(upo_rbt_t tree, void *key, void *value)
+{
+    void *old_value = NULL;
+
+    assert( tree != NULL );
+
+    tree->root = upo_rbt_put_impl(tree->root, key, value, 0, &old_value, tree->key_cmp);
+    tree->root->color = UPO_RBT_BLACK;
+}
+
+upo_rbt_node_t* upo_rbt_get_impl(upo_rbt_node_t *node, const void *key, upo_bst_comparator_t key_cmp)
+{
+    /* The height is logarithmic, but a loop is cheaper than recursion */
+    while (node != NULL)
+    {
+        int cmp = key_cmp(key, node->key);
+
+        if (cmp == 0)
+        {
+            return node;
+        }
+        node = (cmp < 0) ? node->left : node->right;
+    }
+
+    return NULL;
+}
+
+void* upo_rbt_get(const upo_rbt_t tree, const void *key)
+{
+    upo_rbt_node_t *node = NULL;
+
+    if (tree == NULL)
+    {
+        return NULL;
+    }
+    node = upo_rbt_get_impl(tree->root, key, tree->key_cmp);
+
+    return (node != NULL) ? node->value : NULL;
+}
+
+int upo_rbt_contains(const upo_rbt_t tree, const void *key)
+{
+    return tree != NULL && upo_rbt_get_impl(tree->root, key, tree->key_cmp) != NULL;
+}
+
+upo_rbt_node_t* upo_rbt_delete_min_impl(upo_rbt_node_t *node, void **key, void **value)
+{
+    if (node->left == NULL)
+    {
+        /* A node without left child has no right child either */
+        *key = node->key;
+        *value = node->value;
+        free(node);
+        return NULL;
+    }
+
+    /* Carry a red link down the left spine, so that the removed node is red */
+    if (!upo_rbt_is_red(node->left) && !upo_rbt_is_red(node->left->left))
+    {
+        node = upo_rbt_move_red_left(node);
+    }
+    node->left = upo_rbt_delete_min_impl(node->left, key, value);
+
+    return upo_rbt_balance(node);
+}
+
+upo_rbt_node_t* upo_rbt_delete_max_impl(upo_rbt_node_t *node, void **key, void **value)
+{
+    if (upo_rbt_is_red(node->left))
+    {
+        node = upo_rbt_rotate_right(node);
+    }
+    if (node->right == NULL)
+    {
+        *key = node->key;
+        *value = node->value;
+        free(node);
+        return NULL;
+    }
+
+    if (!upo_rbt_is_red(node->right) && !upo_rbt_is_red(node->right->left))
+    {
+        node = upo_rbt_move_red_right(node);
+    }
+    node->right = upo_rbt_delete_max_impl(node->right, key, value);
+
+    return upo_rbt_balance(node);
+}
+
+upo_rbt_node_t* upo_rbt_delete_impl(upo_rbt_node_t *node, const void *key, void **old_key, void **old_value, upo_bst_comparator_t key_cmp)
+{
+    if (key_cmp(key, node->key) < 0)
+    {
+        if (!upo_rbt_is_red(node->left) && !upo_rbt_is_red(node->left->left))
+        {
+            node = upo_rbt_move_red_left(node);
+        }
+        node->left = upo_rbt_delete_impl(node->left, key, old_key, old_value, key_cmp);
+    }
+    else
+    {
+        if (upo_rbt_is_red(node->left))
+        {
+            node = upo_rbt_rotate_right(node);
+        }
+        if (key_cmp(key, node->key) == 0 && node->right == NULL)
+        {
+            *old_key = node->key;
+            *old_value = node->value;
+            free(node);
+            return NULL;
+        }
+        if (!upo_rbt_is_red(node->right) && !upo_rbt_is_red(node->right->left))
+        {
+            node = upo_rbt_move_red_right(node);
+        }
+        if (key_cmp(key, node->key) == 0)
+        {
+            /* Replace the pair with its successor, removed from the right
+             * subtree */
+            *old_key = node->key;
+            *old_value = node->value;
+            node->right = upo_rbt_delete_min_impl(node->right, &node->key, &node->value);
+        }
+        else
+        {
+            node->right = upo_rbt_delete_impl(node->right, key, old_key, old_value, key_cmp);
+        }
+    }
+
+    return upo_rbt_balance(node);
+}
+
+void upo_rbt_delete(upo_rbt_t tree, const void *key, int destroy_data)
+{
+    void *old_key = NULL;
+    void *old_value = NULL;
+
+    /* The top-down pass assumes the key is in the tree */
+    if (!upo_rbt_contains(tree, key))
+    {
+        return;
+    }
+
+    if (!upo_rbt_is_red(tree->root->left) && !upo_rbt_is_red(tree->root->right))
+    {
+        tree->root->color = UPO_RBT_RED;
+    }
+    tree->root = upo_rbt_delete_impl(tree->root, key, &old_key, &old_value, tree->key_cmp);
+    if (tree->root != NULL)
+    {
+        tree->root->color = UPO_RBT_BLACK;
+    }
+
+    /* Data is freed last, since key may be the stored key itself */
+    if (destroy_data)
+    {
+        free(old_key);
+        free(old_value);
+    }
+}
+
+void upo_rbt_delete_min(upo_rbt_t tree, int destroy_data)
+{
+    void *old_key = NULL;
+    void *old_value = NULL;
+
+    if (upo_rbt_is_empty(tree))
+    {
+        return;
+    }
+
+    if (!upo_rbt_is_red(tree->root->left) && !upo_rbt_is_red(tree->root->right))
+    {
+        tree->root->color = UPO_RBT_RED;
+    }
+    tree->root = upo_rbt_delete_min_impl(tree->root, &old_key, &old_value);
+    if (tree->root != NULL)
+    {
+        tree->root->color = UPO_RBT_BLACK;
+    }
+
+    if (destroy_data)
+    {
+        free(old_key);
+        free(old_value);
+    }
+}
+
+void upo_rbt_delete_max(upo_rbt_t tree, int destroy_data)
+{
+    void *old_key = NULL;
+    void *old_value = NULL;
+
+    if (upo_rbt_is_empty(tree))
+    {
+        return;
+    }
+
+    if (!upo_rbt_is_red(tree->root->left) && !upo_rbt_is_red(tree->root->right))
+    {
+        tree->root->color = UPO_RBT_RED;
+    }
+    tree->root = upo_rbt_delete_max_impl(tree->root, &old_key, &old_value);
+    if (tree->root != NULL)
+    {
+        tree->root->color = UPO_RBT_BLACK;
+    }
+
+    if (destroy_data)
+    {
+        free(old_key);
+        free(old_value);
+    }
+}
+
+size_t upo_rbt_size(const upo_rbt_t tree)
+{
+    return (tree != NULL) ? upo_rbt_node_size(tree->root) : 0;
+}
+
+int upo_rbt_is_empty(const upo_rbt_t tree)
+{
+    return tree == NULL || tree->root == NULL;
+}
+
+size_t upo_rbt_height_impl(const upo_rbt_node_t *node)
+{
+    size_t left = 0;
+    size_t right = 0;
+
+    if (node == NULL || (node->left == NULL && node->right == NULL))
+    {
+        return 0;
+    }
+    left = upo_rbt_height_impl(node->left);
+    right = upo_rbt_height_impl(node->right);
+
+    return 1 + (left > right ? left : right);
+}
+
+size_t upo_rbt_height(const upo_rbt_t tree)
+{
+    return (tree != NULL) ? upo_rbt_height_impl(tree->root) : 0;
+}
+
+void upo_rbt_traverse_in_order_impl(const upo_rbt_node_t *node, upo_bst_visitor_t visit, void *visit_context)
+{
+    if (node != NULL)
+    {
+        upo_rbt_traverse_in_order_impl(node->left, visit, visit_context);
+        visit(node->key, node->value, visit_context);
+        upo_rbt_traverse_in_order_impl(node->right, visit, visit_context);
+    }
+}
+
+void upo_rbt_traverse_in_order(const upo_rbt_t tree, upo_bst_visitor_t visit, void *visit_context)
+{
+    if (tree != NULL)
+    {
+        upo_rbt_traverse_in_order_impl(tree->root, visit, visit_context);
+    }
+}
+
+upo_bst_comparator_t upo_rbt_get_comparator(const upo_rbt_t tree)
+{
+    return (tree != NULL) ? tree->key_cmp : NULL;
+}
+
+
+/*** END of FUNDAMENTAL OPERATIONS ***/
+
+
+/*** BEGIN of ORDERED OPERATIONS ***/
+
+
+void* upo_rbt_min(const upo_rbt_t tree)
+{
+    const upo_rbt_node_t *node = NULL;
+
+    if (upo_rbt_is_empty(tree))
+    {
+        return NULL;
+    }
+    for (node = tree->root; node->left != NULL; node = node->left)
+    {
+    }
+
+    return node->key;
+}
+
+void* upo_rbt_max(const upo_rbt_t tree)
+{
+    const upo_rbt_node_t *node = NULL;
+
+    if (upo_rbt_is_empty(tree))
+    {
+        return NULL;
+    }
+    for (node = tree->root; node->right != NULL; node = node->right)
+    {
+    }
+
+    return node->key;
+}
+
+void* upo_rbt_floor(const upo_rbt_t tree, const void *key)
+{
+    const upo_rbt_node_t *node = NULL;
+    void *floor = NULL;
+
+    if (tree == NULL)
+    {
+        return NULL;
+    }
+
+    /* The floor is the last key not greater than key on the search path */
+    node = tree->root;
+    while (node != NULL)
+    {
+        int cmp = tree->key_cmp(key, node->key);
+
+        if (cmp == 0)
+        {
+            return node->key;
+        }
+        if (cmp < 0)
+        {
+            node = node->left;
+        }
+        else
+        {
+            floor = node->key;
+            node = node->right;
+        }
+    }
+
+    return floor;
+}
+
+void* upo_rbt_ceiling(const upo_rbt_t tree, const void *key)
+{
+    const upo_rbt_node_t *node = NULL;
+    void *ceiling = NULL;
+
+    if (tree == NULL)
+    {
+        return NULL;
+    }
+
+    node = tree->root;
+    while (node != NULL)
+    {
+        int cmp = tree->key_cmp(key, node->key);
+
+        if (cmp == 0)
+        {
+            return node->key;
+        }
+        if (cmp > 0)
+        {
+            node = node->right;
+        }
+        else
+        {
+            ceiling = node->key;
+            node = node->left;
+        }
+    }
+
+    return ceiling;
+}
+
+size_t upo_rbt_rank(const upo_rbt_t tree, const void *key)
+{
+    const upo_rbt_node_t *node = NULL;
+    size_t rank = 0;
+
+    if (tree == NULL)
+    {
+        return 0;
+    }
+
+    /* Each time the path goes right, the node and its left subtree are
+     * smaller than key */
+    node = tree->root;
+    while (node != NULL)
+    {
+        int cmp = tree->key_cmp(key, node->key);
+
+        if (cmp < 0)
+        {
+            node = node->left;
+        }
+        else if (cmp > 0)
+        {
+            rank += 1 + upo_rbt_node_size(node->left);
+            node = node->right;
+        }
+        else
+        {
+            return rank + upo_rbt_node_size(node->left);
+        }
+    }
+
+    return rank;
+}
+
+void* upo_rbt_select(const upo_rbt_t tree, size_t rank)
+{
+    const upo_rbt_node_t *node = NULL;
+
+    if (rank >= upo_rbt_size(tree))
+    {
+        return NULL;
+    }
+
+    node = tree->root;
+    for (;;)
+    {
+        size_t left_size = upo_rbt_node_size(node->left);
+
+        if (rank < left_size)
+        {
+            node = node->left;
+        }
+        else if (rank > left_size)
+        {
+            rank -= left_size + 1;
+            node = node->right;
+        }
+        else
+        {
+            return node->key;
+        }
+    }
+}
+
+void upo_rbt_key_list_prepend(upo_bst_key_list_t *list, void *key)
+{
+    upo_bst_key_list_node_t *list_node = malloc(sizeof(upo_bst_key_list_node_t));
+
+    if (list_node == NULL)
+    {
+        perror("Unable to allocate memory for a node of the list of keys");
+        abort();
+    }
+    list_node->key = key;
+    list_node->next = *list;
+    *list = list_node;
+}
+
+void upo_rbt_keys_range_impl(const upo_rbt_node_t *node, const void *low_key, const void *high_key, upo_bst_comparator_t key_cmp, upo_bst_key_list_t *list)
+{
+    int cmp_low = 0;
+    int cmp_high = 0;
+
+    if (node == NULL)
+    {
+        return;
+    }
+
+    cmp_low = key_cmp(low_key, node->key);
+    cmp_high = key_cmp(high_key, node->key);
+    if (cmp_high > 0)
+    {
+        upo_rbt_keys_range_impl(node->right, low_key, high_key, key_cmp, list);
+    }
+    if (cmp_low <= 0 && cmp_high >= 0)
+    {
+        upo_rbt_key_list_prepend(list, node->key);
+    }
+    if (cmp_low < 0)
+    {
+        upo_rbt_keys_range_impl(node->left, low_key, high_key, key_cmp, list);
+    }
+}
+
+upo_bst_key_list_t upo_rbt_keys_range(const upo_rbt_t tree, const void *low_key, const void *high_key)
+{
+    upo_bst_key_list_t list = NULL;
+
+    if (tree != NULL)
+    {
+        upo_rbt_keys_range_impl(tree->root, low_key, high_key, tree->key_cmp, &list);
+    }
+
+    return list;
+}
+
+void upo_rbt_keys_impl(const upo_rbt_node_t *node, upo_bst_key_list_t *list)
+{
+    if (node != NULL)
+    {
+        upo_rbt_keys_impl(node->right, list);
+        upo_rbt_key_list_prepend(list, node->key);
+        upo_rbt_keys_impl(node->left, list);
+    }
+}
+
+upo_bst_key_list_t upo_rbt_keys(const upo_rbt_t tree)
+{
+    upo_bst_key_list_t list = NULL;
+
+    if (tree != NULL)
+    {
+        upo_rbt_keys_impl(tree->root, &list);
+    }
+
+    return list;
+}
+
+int upo_rbt_is_rbt_impl(const upo_rbt_node_t *node, const void *min_key, const void *max_key, upo_bst_comparator_t key_cmp, size_t *black_height)
+{
+    size_t left_height = 0;
+    size_t right_height = 0;
+
+    if (node == NULL)
+    {
+        *black_height = 0;
+        return 1;
+    }
+
+    if ((min_key != NULL && key_cmp(node->key, min_key) <= 0)
+        || (max_key != NULL && key_cmp(node->key, max_key) >= 0)
+        || upo_rbt_is_red(node->right)
+        || (upo_rbt_is_red(node) && upo_rbt_is_red(node->left))
+        || node->size != 1 + upo_rbt_node_size(node->left) + upo_rbt_node_size(node->right))
+    {
+        return 0;
+    }
+    if (!upo_rbt_is_rbt_impl(node->left, min_key, node->key, key_cmp, &left_height)
+        || !upo_rbt_is_rbt_impl(node->right, node->key, max_key, key_cmp, &right_height)
+        || left_height != right_height)
+    {
+        return 0;
+    }
+    *black_height = left_height + !upo_rbt_is_red(node);
+
+    return 1;
+}
+
+int upo_rbt_is_rbt(const upo_rbt_t tree)
+{
+    size_t black_height = 0;
+
+    if (upo_rbt_is_empty(tree))
+    {
+        return 1;
+    }
+
+    return !upo_rbt_is_red(tree->root)
+           && upo_rbt_is_rbt_impl(tree->root, NULL, NULL, tree->key_cmp, &black_height);
+}
+
+
+/*** END of ORDERED OPERATIONS ***/
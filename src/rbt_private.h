@@ -0,0 +1,191 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/rbt_private.h
+ *
+ * \brief Private header for the Red-Black Tree abstract data type.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_RBT_PRIVATE_H
+#define UPO_RBT_PRIVATE_H
+
+
+#include <stddef.h>
+#include <upo/rbt.h>
+
+
+/** \brief The color of red nodes, whose link from the parent is red. */
+#define UPO_RBT_RED 1
+
+/** \brief The color of black nodes. */
+#define UPO_RBT_BLACK 0
+
+
+/** \brief Alias for red-black tree node type. */
+typedef struct upo_rbt_node_s upo_rbt_node_t;
+
+/** \brief Type for nodes of a red-black tree. */
+struct upo_rbt_node_s
+{
+    void *key; /**< Pointer to user-provided key. */
+    void *value; /**< Pointer to user-provided value. */
+    upo_rbt_node_t *left; /**< Pointer to the left child node. */
+    upo_rbt_node_t *right; /**< Pointer to the right child node. */
+    size_t size; /**< The number of nodes of the subtree rooted at this node. */
+    int color; /**< The color of the node (#UPO_RBT_RED or #UPO_RBT_BLACK). */
+};
+
+/** \brief Defines a red-black tree. */
+struct upo_rbt_s
+{
+    upo_rbt_node_t *root; /**< The root of the tree. */
+    upo_bst_comparator_t key_cmp; /**< Pointer to the key comparison function. */
+};
+
+
+/**
+ * \brief Clears the subtree rooted at the given node.
+ *
+ * \param node The root of the subtree.
+ * \param destroy_data Tells whether keys and values must be freed.
+ */
+static void upo_rbt_clear_impl(upo_rbt_node_t *node, int destroy_data);
+
+/** \brief Creates a red node with the given key and value. */
+static upo_rbt_node_t* upo_rbt_node_create(void *key, void *value);
+
+/** \brief Tells whether the given node is red (missing nodes are black). */
+static int upo_rbt_is_red(const upo_rbt_node_t *node);
+
+/** \brief Returns the size of the subtree rooted at the given node (`0` for missing nodes). */
+static size_t upo_rbt_node_size(const upo_rbt_node_t *node);
+
+/** \brief Makes a right-leaning red link lean to the left, and returns the new root of the subtree. */
+static upo_rbt_node_t* upo_rbt_rotate_left(upo_rbt_node_t *node);
+
+/** \brief Makes a left-leaning red link lean to the right, and returns the new root of the subtree. */
+static upo_rbt_node_t* upo_rbt_rotate_right(upo_rbt_node_t *node);
+
+/** \brief Flips the colors of the given node and of its children. */
+static void upo_rbt_flip_colors(upo_rbt_node_t *node);
+
+/**
+ * \brief Assuming the given node is red and both its left child and the left
+ *  child of that are black, makes the left child or one of its children red.
+ */
+static upo_rbt_node_t* upo_rbt_move_red_left(upo_rbt_node_t *node);
+
+/**
+ * \brief Assuming the given node is red and both its right child and the left
+ *  child of that are black, makes the right child or one of its children red.
+ */
+static upo_rbt_node_t* upo_rbt_move_red_right(upo_rbt_node_t *node);
+
+/** \brief Restores the invariants of the given subtree on the way up from an update. */
+static upo_rbt_node_t* upo_rbt_balance(upo_rbt_node_t *node);
+
+/**
+ * \brief Inserts the given pair in the subtree rooted at the given node.
+ *
+ * \param node The root of the subtree.
+ * \param key The key.
+ * \param value The value.
+ * \param replace Whether the value of an equal key must be replaced.
+ * \param old_value Where the replaced value is stored.
+ * \param key_cmp The key comparison function.
+ * \return The new root of the subtree.
+ */
+static upo_rbt_node_t* upo_rbt_put_impl(upo_rbt_node_t *node, void *key, void *value, int replace, void **old_value, upo_bst_comparator_t key_cmp);
+
+/** \brief Returns the node holding the given key, or `NULL`. */
+static upo_rbt_node_t* upo_rbt_get_impl(upo_rbt_node_t *node, const void *key, upo_bst_comparator_t key_cmp);
+
+/**
+ * \brief Removes the smallest key of the subtree rooted at the given node.
+ *
+ * \param node The root of the subtree.
+ * \param key Where the removed key is stored.
+ * \param value Where the removed value is stored.
+ * \return The new root of the subtree.
+ */
+static upo_rbt_node_t* upo_rbt_delete_min_impl(upo_rbt_node_t *node, void **key, void **value);
+
+/**
+ * \brief Removes the largest key of the subtree rooted at the given node.
+ *
+ * \param node The root of the subtree.
+ * \param key Where the removed key is stored.
+ * \param value Where the removed value is stored.
+ * \return The new root of the subtree.
+ */
+static upo_rbt_node_t* upo_rbt_delete_max_impl(upo_rbt_node_t *node, void **key, void **value);
+
+/**
+ * \brief Removes the given key, which must be in the subtree rooted at the
+ *  given node.
+ *
+ * \param node The root of the subtree.
+ * \param key The key to remove.
+ * \param old_key Where the removed (stored) key is stored.
+ * \param old_value Where the removed value is stored.
+ * \param key_cmp The key comparison function.
+ * \return The new root of the subtree.
+ */
+static upo_rbt_node_t* upo_rbt_delete_impl(upo_rbt_node_t *node, const void *key, void **old_key, void **old_value, upo_bst_comparator_t key_cmp);
+
+/** \brief Returns the height of the subtree rooted at the given node. */
+static size_t upo_rbt_height_impl(const upo_rbt_node_t *node);
+
+/** \brief Visits in order the subtree rooted at the given node. */
+static void upo_rbt_traverse_in_order_impl(const upo_rbt_node_t *node, upo_bst_visitor_t visit, void *visit_context);
+
+/**
+ * \brief Prepends to the given list the keys of the subtree rooted at the
+ *  given node that are inside the given range, visiting them from the
+ *  largest one so that the list is in ascending order.
+ */
+static void upo_rbt_keys_range_impl(const upo_rbt_node_t *node, const void *low_key, const void *high_key, upo_bst_comparator_t key_cmp, upo_bst_key_list_t *list);
+
+/** \brief Prepends to the given list all keys of the subtree rooted at the given node, in ascending order. */
+static void upo_rbt_keys_impl(const upo_rbt_node_t *node, upo_bst_key_list_t *list);
+
+/** \brief Prepends the given key to the given list. */
+static void upo_rbt_key_list_prepend(upo_bst_key_list_t *list, void *key);
+
+/**
+ * \brief Checks the properties of the subtree rooted at the given node.
+ *
+ * \param node The root of the subtree.
+ * \param min_key The key all keys of the subtree must be greater than, or
+ *  `NULL` if there is no lower bound.
+ * \param max_key The key all keys of the subtree must be less than, or
+ *  `NULL` if there is no upper bound.
+ * \param key_cmp The key comparison function.
+ * \param black_height Where the number of black nodes of each path to a
+ *  missing child is stored.
+ * \return `1` if the subtree is a valid left-leaning red-black tree, or `0`
+ *  otherwise.
+ */
+static int upo_rbt_is_rbt_impl(const upo_rbt_node_t *node, const void *min_key, const void *max_key, upo_bst_comparator_t key_cmp, size_t *black_height);
+
+
+#endif /* UPO_RBT_PRIVATE_H */
@@ -0,0 +1,597 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "splay_private.h"
+
+
+/*** BEGIN of NODE OPERATIONS ***/
+
+
+upo_splay_node_t* upo_splay_node_create(void *key, void *value)
+{
+    upo_splay_node_t *node = malloc(sizeof(struct upo_splay_node_s));
+
+    if (node == NULL)
+    {
+        perror("Unable to allocate memory for a node of the Splay Tree");
+        abort();
+    }
+    node->key = key;
+    node->value = value;
+    node->left = NULL;
+    node->right = NULL;
+
+    return node;
+}
+
+upo_splay_node_t* upo_splay_splay_impl(upo_splay_node_t *node, const void *key, upo_bst_comparator_t key_cmp, int extreme)
+{
+    /* The left tree hangs from header.right and the right tree from
+     * header.left; left_max and right_min are their nodes where the next
+     * nodes are linked */
+    upo_splay_node_t header;
+    upo_splay_node_t *left_max = &header;
+    upo_splay_node_t *right_min = &header;
+
+    if (node == NULL)
+    {
+        return NULL;
+    }
+
+    header.left = NULL;
+    header.right = NULL;
+    for (;;)
+    {
+        int cmp = (extreme != 0) ? extreme : key_cmp(key, node->key);
+
+        if (cmp < 0)
+        {
+            if (node->left == NULL)
+            {
+                break;
+            }
+            if (extreme != 0 || key_cmp(key, node->left->key) < 0)
+            {
+                /* Zig-zig: rotate right before linking */
+                upo_splay_node_t *x = node->left;
+
+                node->left = x->right;
+                x->right = node;
+                node = x;
+                if (node->left == NULL)
+                {
+                    break;
+                }
+            }
+            right_min->left = node;
+            right_min = node;
+            node = node->left;
+        }
+        else if (cmp > 0)
+        {
+            if (node->right == NULL)
+            {
+                break;
+            }
+            if (extreme != 0 || key_cmp(key, node->right->key) > 0)
+            {
+                upo_splay_node_t *x = node->right;
+
+                node->right = x->left;
+                x->left = node;
+                node = x;
+                if (node->right == NULL)
+                {
+                    break;
+                }
+            }
+            left_max->right = node;
+            left_max = node;
+            node = node->right;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    /* Reassemble */
+    left_max->right = node->left;
+    right_min->left = node->right;
+    node->left = header.right;
+    node->right = header.left;
+
+    return node;
+}
+
+void upo_splay_stack_push(upo_splay_stack_t *stack, const upo_splay_node_t *node, size_t depth)
+{
+    if (stack->size == stack->capacity)
+    {
+        size_t capacity = (stack->capacity > 0) ? 2*stack->capacity : UPO_SPLAY_STACK_INITIAL_CAPACITY;
+        upo_splay_stack_item_t *items = realloc(stack->items, capacity*sizeof(upo_splay_stack_item_t));
+
+        if (items == NULL)
+        {
+            perror("Unable to allocate memory for the stack of the Splay Tree walk");
+            abort();
+        }
+        stack->items = items;
+        stack->capacity = capacity;
+    }
+    stack->items[stack->size].node = node;
+    stack->items[stack->size].depth = depth;
+    stack->size += 1;
+}
+
+void upo_splay_traverse_range_impl(const upo_splay_node_t *node, const void *low_key, const void *high_key, upo_bst_comparator_t key_cmp, upo_bst_visitor_t visit, void *visit_context)
+{
+    upo_splay_stack_t stack = {NULL, 0, 0};
+
+    for (;;)
+    {
+        /* Push the path to the smallest key not less than low_key */
+        while (node != NULL)
+        {
+            if (low_key == NULL || key_cmp(low_key, node->key) <= 0)
+            {
+                upo_splay_stack_push(&stack, node, 0);
+                node = node->left;
+            }
+            else
+            {
+                node = node->right;
+            }
+        }
+        if (stack.size == 0)
+        {
+            break;
+        }
+        stack.size -= 1;
+        node = stack.items[stack.size].node;
+        if (high_key != NULL && key_cmp(high_key, node->key) < 0)
+        {
+            break;
+        }
+        visit(node->key, node->value, visit_context);
+        node = node->right;
+    }
+
+    free(stack.items);
+}
+
+
+/*** END of NODE OPERATIONS ***/
+
+
+/*** BEGIN of FUNDAMENTAL OPERATIONS ***/
+
+
+upo_splay_t upo_splay_create(upo_bst_comparator_t key_cmp)
+{
+    upo_splay_t tree = NULL;
+
+    assert( key_cmp != NULL );
+
+    tree = malloc(sizeof(struct upo_splay_s));
+    if (tree == NULL)
+    {
+        perror("Unable to allocate memory for Splay Tree");
+        abort();
+    }
+    tree->root = NULL;
+    tree->size = 0;
+    tree->key_cmp = key_cmp;
+
+    return tree;
+}
+
+void upo_splay_destroy(upo_splay_t tree, int destroy_data)
+{
+    if (tree != NULL)
+    {
+        upo_splay_clear(tree, destroy_data);
+        free(tree);
+    }
+}
+
+void upo_splay_clear(upo_splay_t tree, int destroy_data)
+{
+    upo_splay_node_t *node = NULL;
+
+    if (tree == NULL)
+    {
+        return;
+    }
+
+    /* Rotate left children up until the root has none, then free it and
+     * go on with its right subtree */
+    node = tree->root;
+    while (node != NULL)
+    {
+        if (node->left != NULL)
+        {
+            upo_splay_node_t *x = node->left;
+
+            node->left = x->right;
+            x->right = node;
+            node = x;
+        }
+        else
+        {
+            upo_splay_node_t *next = node->right;
+
+            if (destroy_data)
+            {
+                free(node->key);
+                free(node->value);
+            }
+            free(node);
+            node = next;
+        }
+    }
+    tree->root = NULL;
+    tree->size = 0;
+}
+
+void* upo_splay_put_impl(upo_splay_t tree, void *key, void *value, int replace)
+{
+    upo_splay_node_t *node = NULL;
+    int cmp = 0;
+
+    assert( tree != NULL );
+
+    if (tree->root == NULL)
+    {
+        tree->root = upo_splay_node_create(key, value);
+        tree->size = 1;
+        return NULL;
+    }
+
+    tree->root = upo_splay_splay_impl(tree->root, key, tree->key_cmp, 0);
+    cmp = tree->key_cmp(key, tree->root->key);
+    if (cmp == 0)
+    {
+        void *old_value = tree->root->value;
+
+        if (replace)
+        {
+            tree->root->value = value;
+        }
+        return old_value;
+    }
+
+    /* The root is the floor or the ceiling of key: split it around the new
+     * node */
+    node = upo_splay_node_create(key, value);
+    if (cmp < 0)
+    {
+        node->left = tree->root->left;
+        node->right = tree->root;
+        tree->root->left = NULL;
+    }
+    else
+    {
+        node->right = tree->root->right;
+        node->left = tree->root;
+        tree->root->right = NULL;
+    }
+    tree->root = node;
+    tree->size += 1;
+
+    return NULL;
+}
+
+void* upo_splay_put(upo_splay_t tree, void *key, void *value)
+{
+    assert( tree != NULL );
+
+    return upo_splay_put_impl(tree, key, value, 1);
+}
+
+void upo_splay_insert(upo_splay_t tree, void *key, void *value)
+{
+    assert( tree != NULL );
+
+    upo_splay_put_impl(tree, key, value, 0);
+}
+
+void* upo_splay_get(upo_splay_t tree, const void *key)
+{
+    if (upo_splay_is_empty(tree))
+    {
+        return NULL;
+    }
+
+    tree->root = upo_splay_splay_impl(tree->root, key, tree->key_cmp, 0);
+
+    return (tree->key_cmp(key, tree->root->key) == 0) ? tree->root->value : NULL;
+}
+
+int upo_splay_contains(upo_splay_t tree, const void *key)
+{
+    if (upo_splay_is_empty(tree))
+    {
+        return 0;
+    }
+
+    tree->root = upo_splay_splay_impl(tree->root, key, tree->key_cmp, 0);
+
+    return tree->key_cmp(key, tree->root->key) == 0;
+}
+
+void upo_splay_delete(upo_splay_t tree, const void *key, int destroy_data)
+{
+    upo_splay_node_t *node = NULL;
+
+    if (upo_splay_is_empty(tree))
+    {
+        return;
+    }
+
+    tree->root = upo_splay_splay_impl(tree->root, key, tree->key_cmp, 0);
+    if (tree->key_cmp(key, tree->root->key) != 0)
+    {
+        return;
+    }
+
+    /* Join the subtrees of the root: the largest key of the left subtree,
+     * once splayed, has no right child */
+    node = tree->root;
+    if (node->left == NULL)
+    {
+        tree->root = node->right;
+    }
+    else
+    {
+        tree->root = upo_splay_splay_impl(node->left, NULL, tree->key_cmp, 1);
+        tree->root->right = node->right;
+    }
+    if (destroy_data)
+    {
+        free(node->key);
+        free(node->value);
+    }
+    free(node);
+    tree->size -= 1;
+}
+
+size_t upo_splay_size(const upo_splay_t tree)
+{
+    return (tree != NULL) ? tree->size : 0;
+}
+
+int upo_splay_is_empty(const upo_splay_t tree)
+{
+    return tree == NULL || tree->root == NULL;
+}
+
+size_t upo_splay_height(const upo_splay_t tree)
+{
+    upo_splay_stack_t stack = {NULL, 0, 0};
+    size_t height = 0;
+
+    if (upo_splay_is_empty(tree))
+    {
+        return 0;
+    }
+
+    upo_splay_stack_push(&stack, tree->root, 0);
+    while (stack.size > 0)
+    {
+        upo_splay_stack_item_t item = stack.items[--stack.size];
+
+        if (item.depth > height)
+        {
+            height = item.depth;
+        }
+        if (item.node->left != NULL)
+        {
+            upo_splay_stack_push(&stack, item.node->left, item.depth + 1);
+        }
+        if (item.node->right != NULL)
+        {
+            upo_splay_stack_push(&stack, item.node->right, item.depth + 1);
+        }
+    }
+    free(stack.items);
+
+    return height;
+}
+
+void upo_splay_traverse_in_order(const upo_splay_t tree, upo_bst_visitor_t visit, void *visit_context)
+{
+    if (tree != NULL)
+    {
+        upo_splay_traverse_range_impl(tree->root, NULL, NULL, tree->key_cmp, visit, visit_context);
+    }
+}
+
+upo_bst_comparator_t upo_splay_get_comparator(const upo_splay_t tree)
+{
+    return (tree != NULL) ? tree->key_cmp : NULL;
+}
+
+
+/*** END of FUNDAMENTAL OPERATIONS ***/
+
+
+/*** BEGIN of ORDERED OPERATIONS ***/
+
+
+void* upo_splay_min(upo_splay_t tree)
+{
+    if (upo_splay_is_empty(tree))
+    {
+        return NULL;
+    }
+
+    tree->root = upo_splay_splay_impl(tree->root, NULL, tree->key_cmp, -1);
+
+    return tree->root->key;
+}
+
+void* upo_splay_max(upo_splay_t tree)
+{
+    if (upo_splay_is_empty(tree))
+    {
+        return NULL;
+    }
+
+    tree->root = upo_splay_splay_impl(tree->root, NULL, tree->key_cmp, 1);
+
+    return tree->root->key;
+}
+
+void* upo_splay_floor(upo_splay_t tree, const void *key)
+{
+    upo_splay_node_t *root = NULL;
+
+    if (upo_splay_is_empty(tree))
+    {
+        return NULL;
+    }
+
+    /* The root is now either the floor or the ceiling of key; in the latter
+     * case the floor is the largest key of its left subtree */
+    root = upo_splay_splay_impl(tree->root, key, tree->key_cmp, 0);
+    tree->root = root;
+    if (tree->key_cmp(key, root->key) >= 0)
+    {
+        return root->key;
+    }
+    if (root->left == NULL)
+    {
+        return NULL;
+    }
+    root->left = upo_splay_splay_impl(root->left, NULL, tree->key_cmp, 1);
+
+    return root->left->key;
+}
+
+void* upo_splay_ceiling(upo_splay_t tree, const void *key)
+{
+    upo_splay_node_t *root = NULL;
+
+    if (upo_splay_is_empty(tree))
+    {
+        return NULL;
+    }
+
+    root = upo_splay_splay_impl(tree->root, key, tree->key_cmp, 0);
+    tree->root = root;
+    if (tree->key_cmp(key, root->key) <= 0)
+    {
+        return root->key;
+    }
+    if (root->right == NULL)
+    {
+        return NULL;
+    }
+    root->right = upo_splay_splay_impl(root->right, NULL, tree->key_cmp, -1);
+
+    return root->right->key;
+}
+
+void upo_splay_key_list_append_visit(void *key, void *value, void *context)
+{
+    upo_bst_key_list_t **tail = context;
+    upo_bst_key_list_node_t *list_node = malloc(sizeof(upo_bst_key_list_node_t));
+
+    (void) value;
+
+    if (list_node == NULL)
+    {
+        perror("Unable to allocate memory for a node of the list of keys");
+        abort();
+    }
+    list_node->key = key;
+    list_node->next = NULL;
+    **tail = list_node;
+    *tail = &list_node->next;
+}
+
+upo_bst_key_list_t upo_splay_keys_range(upo_splay_t tree, const void *low_key, const void *high_key)
+{
+    upo_bst_key_list_t list = NULL;
+    upo_bst_key_list_t *tail = &list;
+
+    assert( low_key != NULL );
+    assert( high_key != NULL );
+
+    if (upo_splay_is_empty(tree))
+    {
+        return NULL;
+    }
+
+    tree->root = upo_splay_splay_impl(tree->root, low_key, tree->key_cmp, 0);
+    upo_splay_traverse_range_impl(tree->root, low_key, high_key, tree->key_cmp, upo_splay_key_list_append_visit, &tail);
+
+    return list;
+}
+
+upo_bst_key_list_t upo_splay_keys(const upo_splay_t tree)
+{
+    upo_bst_key_list_t list = NULL;
+    upo_bst_key_list_t *tail = &list;
+
+    upo_splay_traverse_in_order(tree, upo_splay_key_list_append_visit, &tail);
+
+    return list;
+}
+
+void upo_splay_check_visit(void *key, void *value, void *context)
+{
+    upo_splay_check_t *check = context;
+
+    (void) value;
+
+    if (check->prev_key != NULL && check->key_cmp(check->prev_key, key) >= 0)
+    {
+        check->ordered = 0;
+    }
+    check->prev_key = key;
+    check->size += 1;
+}
+
+int upo_splay_is_bst(const upo_splay_t tree)
+{
+    upo_splay_check_t check;
+
+    if (tree == NULL)
+    {
+        return 1;
+    }
+
+    check.key_cmp = tree->key_cmp;
+    check.prev_key = NULL;
+    check.size = 0;
+    check.ordered = 1;
+    upo_splay_traverse_in_order(tree, upo_splay_check_visit, &check);
+
+    return check.ordered && check.size == tree->size;
+}
+
+
+/*** END of ORDERED OPERATIONS ***/
@@ -0,0 +1,159 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/splay_private.h
+ *
+ * \brief Private header for the Splay Tree abstract data type.
+ *
+ * \author SapphireDragoness
+ *
+ * \copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ *  This file is part of UPOalglib.
+ *
+ *  UPOalglib is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  UPOalglib is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPO_SPLAY_PRIVATE_H
+#define UPO_SPLAY_PRIVATE_H
+
+
+#include <stddef.h>
+#include <upo/splay.h>
+
+
+/** \brief The initial number of items of the stacks used to walk trees. */
+#define UPO_SPLAY_STACK_INITIAL_CAPACITY 64
+
+
+/** \brief Alias for splay tree node type. */
+typedef struct upo_splay_node_s upo_splay_node_t;
+
+/** \brief Type for nodes of a splay tree. */
+struct upo_splay_node_s
+{
+    void *key; /**< Pointer to user-provided key. */
+    void *value; /**< Pointer to user-provided value. */
+    upo_splay_node_t *left; /**< Pointer to the left child node. */
+    upo_splay_node_t *right; /**< Pointer to the right child node. */
+};
+
+/** \brief Defines a splay tree. */
+struct upo_splay_s
+{
+    upo_splay_node_t *root; /**< The root of the tree. */
+    size_t size; /**< The number of nodes of the tree. */
+    upo_bst_comparator_t key_cmp; /**< Pointer to the key comparison function. */
+};
+
+/** \brief Type for items of the stacks used to walk trees. */
+typedef struct {
+    const upo_splay_node_t *node; /**< The node. */
+    size_t depth; /**< The number of links from the root to the node. */
+} upo_splay_stack_item_t;
+
+/**
+ * \brief Type for the growable stacks used to walk trees, whose height is
+ *  not bounded.
+ */
+typedef struct {
+    upo_splay_stack_item_t *items; /**< The items, from the bottom. */
+    size_t size; /**< The number of items. */
+    size_t capacity; /**< The number of allocated items. */
+} upo_splay_stack_t;
+
+/** \brief Type for the state of the check of the order of keys. */
+typedef struct {
+    upo_bst_comparator_t key_cmp; /**< The key comparison function. */
+    const void *prev_key; /**< The last visited key, or `NULL`. */
+    size_t size; /**< The number of visited keys. */
+    int ordered; /**< `1` if keys visited so far are in ascending order. */
+} upo_splay_check_t;
+
+
+/** \brief Creates a leaf holding the given key-value pair. */
+static upo_splay_node_t* upo_splay_node_create(void *key, void *value);
+
+/**
+ * \brief Splays the subtree rooted at the given node, top-down.
+ *
+ * \param node The root of the subtree.
+ * \param key The key to look for (ignored if \a extreme is not `0`).
+ * \param key_cmp The key comparison function.
+ * \param extreme `-1` to splay the smallest key, `1` to splay the largest
+ *  key, or `0` to splay \a key.
+ * \return The new root of the subtree, which holds \a key if present, or
+ *  otherwise the last key met while looking for it (i.e., either its floor
+ *  or its ceiling), or `NULL` if the subtree is empty.
+ *
+ * Nodes met on the way down are hung on a left tree (keys less than \a key)
+ * and on a right tree (keys greater than \a key), rotating pairs of links
+ * that go in the same direction; the two trees become the subtrees of the
+ * last node met.
+ */
+static upo_splay_node_t* upo_splay_splay_impl(upo_splay_node_t *node, const void *key, upo_bst_comparator_t key_cmp, int extreme);
+
+/**
+ * \brief Inserts the given key-value pair, or updates the value of the key
+ *  if \a replace is `1`.
+ *
+ * \param tree The splay tree.
+ * \param key The key.
+ * \param value The value.
+ * \param replace Tells whether the value of a duplicate key is replaced.
+ * \return The value of the key before the call, or `NULL` if the key has
+ *  been inserted.
+ */
+static void* upo_splay_put_impl(upo_splay_t tree, void *key, void *value, int replace);
+
+/** \brief Pushes the given node and its depth on the given stack, growing it if full. */
+static void upo_splay_stack_push(upo_splay_stack_t *stack, const upo_splay_node_t *node, size_t depth);
+
+/**
+ * \brief Visits in order the keys of the subtree rooted at the given node
+ *  that are inside the given range.
+ *
+ * \param node The root of the subtree.
+ * \param low_key The lower bound of the range, or `NULL` if there is none.
+ * \param high_key The upper bound of the range, or `NULL` if there is none.
+ * \param key_cmp The key comparison function.
+ * \param visit The visit function.
+ * \param visit_context Additional information, passed to the visit function.
+ *
+ * The walk is iterative, with an explicit stack, and stops at the first key
+ * greater than \a high_key.
+ */
+static void upo_splay_traverse_range_impl(const upo_splay_node_t *node, const void *low_key, const void *high_key, upo_bst_comparator_t key_cmp, upo_bst_visitor_t visit, void *visit_context);
+
+/**
+ * \brief Appends the given key to a list of keys.
+ *
+ * \param key The key.
+ * \param value Ignored.
+ * \param context A pointer to the link (of type `upo_bst_key_list_t*`) where
+ *  the key must be stored, which is moved to the new list node.
+ */
+static void upo_splay_key_list_append_visit(void *key, void *value, void *context);
+
+/**
+ * \brief Checks that the given key is greater than the previous one.
+ *
+ * \param key The key.
+ * \param value Ignored.
+ * \param context The state of the check (of type upo_splay_check_t).
+ */
+static void upo_splay_check_visit(void *key, void *value, void *context);
+
+
+#endif /* UPO_SPLAY_PRIVATE_H */
@@ -1 +1 @@
-test_targets += test_bst test_bst_more
+test_targets += test_bst test_bst_more test_bst_deep
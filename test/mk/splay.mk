@@ -0,0 +1 @@
+test_targets += test_splay
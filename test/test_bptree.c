@@ -0,0 +1,518 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <upo/error.h>
+#include <upo/random.h>
+#include <upo/bptree.h>
+
+
+static int int_compare(const void *a, const void *b);
+static void check_balanced(const upo_bptree_t tree);
+static void check_key_list(upo_bst_key_list_t list, int low, int high, int step);
+static void in_order_visit(void *key, void *value, void *info);
+
+static void test_empty();
+static void test_sorted();
+static void test_reverse();
+static void test_random();
+static void test_delete();
+static void test_ordered();
+static void test_destroy_data();
+static void test_build();
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void check_balanced(const upo_bptree_t tree)
+{
+    size_t n = upo_bptree_size(tree);
+
+    assert( upo_bptree_is_bptree(tree) );
+    /* Every inner node but the root has at least sixteen children */
+    assert( upo_bptree_height(tree) <= 1 + log(n + 1)/log(2.0)/4 );
+}
+
+/* Checks that the list holds low, low+step, ..., high and frees it */
+void check_key_list(upo_bst_key_list_t list, int low, int high, int step)
+{
+    int expected = low;
+
+    while (list != NULL)
+    {
+        upo_bst_key_list_t next = list->next;
+
+        assert( expected <= high );
+        assert( *(int*) list->key == expected );
+        expected += step;
+        free(list);
+        list = next;
+    }
+    assert( expected > high );
+}
+
+void in_order_visit(void *key, void *value, void *info)
+{
+    int *last = info;
+
+    assert( *(int*) key > *last );
+    assert( *(int*) value == 2 * *(int*) key );
+
+    *last = *(int*) key;
+}
+
+void test_empty()
+{
+    upo_bptree_t tree = upo_bptree_create(int_compare);
+    int key = 1;
+
+    assert( upo_bptree_is_empty(tree) );
+    assert( upo_bptree_size(tree) == 0 );
+    assert( upo_bptree_height(tree) == 0 );
+    assert( upo_bptree_is_bptree(tree) );
+    assert( upo_bptree_get(tree, &key) == NULL );
+    assert( !upo_bptree_contains(tree, &key) );
+    assert( upo_bptree_min(tree) == NULL );
+    assert( upo_bptree_max(tree) == NULL );
+    assert( upo_bptree_floor(tree, &key) == NULL );
+    assert( upo_bptree_ceiling(tree, &key) == NULL );
+    assert( upo_bptree_keys(tree) == NULL );
+    assert( upo_bptree_keys_range(tree, &key, &key) == NULL );
+    assert( upo_bptree_get_comparator(tree) == int_compare );
+
+    upo_bptree_delete(tree, &key, 0);
+    assert( upo_bptree_is_empty(tree) );
+
+    upo_bptree_destroy(tree, 0);
+
+    /* NULL trees */
+    assert( upo_bptree_size(NULL) == 0 );
+    assert( upo_bptree_is_empty(NULL) );
+    assert( upo_bptree_get(NULL, &key) == NULL );
+    upo_bptree_destroy(NULL, 0);
+}
+
+void test_sorted()
+{
+    size_t n = 10000;
+    int *keys = NULL;
+    int *values = NULL;
+    upo_bptree_t tree = upo_bptree_create(int_compare);
+    int last = -1;
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    values = malloc(n*sizeof(int));
+    if (keys == NULL || values == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys and values");
+    }
+
+    /* Sorted insertions degenerate a plain BST into a list */
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+        values[i] = 2*keys[i];
+        assert( upo_bptree_put(tree, &keys[i], &values[i]) == NULL );
+        if (i % 1000 == 0)
+        {
+            check_balanced(tree);
+        }
+    }
+    assert( upo_bptree_size(tree) == n );
+    check_balanced(tree);
+
+    for (i = 0; i < n; ++i)
+    {
+        assert( *(int*) upo_bptree_get(tree, &keys[i]) == values[i] );
+    }
+    upo_bptree_traverse_in_order(tree, in_order_visit, &last);
+    assert( last == (int) n - 1 );
+
+    upo_bptree_destroy(tree, 0);
+    free(values);
+    free(keys);
+}
+
+void test_reverse()
+{
+    size_t n = 10000;
+    int *keys = NULL;
+    upo_bptree_t tree = upo_bptree_create(int_compare);
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) (n - i);
+        upo_bptree_insert(tree, &keys[i], &keys[i]);
+    }
+    assert( upo_bptree_size(tree) == n );
+    check_balanced(tree);
+    assert( *(int*) upo_bptree_min(tree) == 1 );
+    assert( *(int*) upo_bptree_max(tree) == (int) n );
+
+    upo_bptree_destroy(tree, 0);
+    free(keys);
+}
+
+void test_random()
+{
+    size_t n = 10000;
+    int *keys = NULL;
+    int *values = NULL;
+    int other = -1;
+    upo_bptree_t tree = upo_bptree_create(int_compare);
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    values = malloc(n*sizeof(int));
+    if (keys == NULL || values == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys and values");
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+        values[i] = 2*keys[i];
+    }
+    upo_random_shuffle(keys, n, sizeof(int));
+    for (i = 0; i < n; ++i)
+    {
+        upo_bptree_put(tree, &keys[i], &values[keys[i]]);
+    }
+    check_balanced(tree);
+
+    /* Put replaces the value and returns the old one, insert does not */
+    assert( upo_bptree_put(tree, &keys[0], &other) == &values[keys[0]] );
+    assert( upo_bptree_get(tree, &keys[0]) == &other );
+    upo_bptree_insert(tree, &keys[0], &values[keys[0]]);
+    assert( upo_bptree_get(tree, &keys[0]) == &other );
+    assert( upo_bptree_size(tree) == n );
+    check_balanced(tree);
+
+    upo_bptree_clear(tree, 0);
+    assert( upo_bptree_is_empty(tree) );
+
+    upo_bptree_destroy(tree, 0);
+    free(values);
+    free(keys);
+}
+
+static void test_delete()
+{
+    size_t n = 20000;
+    int *keys = NULL;
+    int *removed = NULL;
+    int missing = -1;
+    upo_bptree_t tree = upo_bptree_create(int_compare);
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    removed = malloc(n*sizeof(int));
+    if (keys == NULL || removed == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+    upo_random_shuffle(keys, n, sizeof(int));
+    for (i = 0; i < n; ++i)
+    {
+        upo_bptree_put(tree, &keys[i], &keys[i]);
+    }
+
+    upo_bptree_delete(tree, &missing, 0);
+    assert( upo_bptree_size(tree) == n );
+
+    /* Delete half of the keys in another random order, through copies since
+     * the tree references the original keys */
+    for (i = 0; i < n; ++i)
+    {
+        removed[i] = (int) i;
+    }
+    upo_random_shuffle(removed, n, sizeof(int));
+    for (i = 0; i < n/2; ++i)
+    {
+        upo_bptree_delete(tree, &removed[i], 0);
+        assert( !upo_bptree_contains(tree, &removed[i]) );
+        if (i % 1000 == 0)
+        {
+            check_balanced(tree);
+        }
+    }
+    assert( upo_bptree_size(tree) == n - n/2 );
+    check_balanced(tree);
+    for (i = n/2; i < n; ++i)
+    {
+        assert( *(int*) upo_bptree_get(tree, &removed[i]) == removed[i] );
+    }
+
+    /* Remove the remaining keys from both ends */
+    while (!upo_bptree_is_empty(tree))
+    {
+        int min = *(int*) upo_bptree_min(tree);
+        int max = *(int*) upo_bptree_max(tree);
+
+        upo_bptree_delete(tree, &min, 0);
+        assert( upo_bptree_is_empty(tree) || *(int*) upo_bptree_min(tree) > min );
+        upo_bptree_delete(tree, &max, 0);
+        assert( upo_bptree_is_empty(tree) || *(int*) upo_bptree_max(tree) < max );
+        assert( upo_bptree_is_bptree(tree) );
+    }
+    assert( upo_bptree_size(tree) == 0 );
+
+    upo_bptree_destroy(tree, 0);
+    free(removed);
+    free(keys);
+}
+
+void test_ordered()
+{
+    size_t n = 1000;
+    int *keys = NULL;
+    upo_bptree_t tree = upo_bptree_create(int_compare);
+    int key;
+    int low;
+    int high;
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+
+    /* Even keys 0, 2, ..., 2(n-1) */
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = 2*(int) i;
+    }
+    upo_random_shuffle(keys, n, sizeof(int));
+    for (i = 0; i < n; ++i)
+    {
+        upo_bptree_put(tree, &keys[i], &keys[i]);
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        key = 2*(int) i;
+        assert( *(int*) upo_bptree_floor(tree, &key) == key );
+        assert( *(int*) upo_bptree_ceiling(tree, &key) == key );
+
+        key = 2*(int) i + 1;
+        assert( *(int*) upo_bptree_floor(tree, &key) == key - 1 );
+        if (i + 1 < n)
+        {
+            assert( *(int*) upo_bptree_ceiling(tree, &key) == key + 1 );
+        }
+        else
+        {
+            assert( upo_bptree_ceiling(tree, &key) == NULL );
+        }
+    }
+    key = -1;
+    assert( upo_bptree_floor(tree, &key) == NULL );
+
+    check_key_list(upo_bptree_keys(tree), 0, 2*((int) n - 1), 2);
+
+    low = 101;
+    high = 200;
+    check_key_list(upo_bptree_keys_range(tree, &low, &high), 102, 200, 2);
+    low = -10;
+    high = 0;
+    check_key_list(upo_bptree_keys_range(tree, &low, &high), 0, 0, 2);
+    low = 5;
+    high = 5;
+    assert( upo_bptree_keys_range(tree, &low, &high) == NULL );
+
+    upo_bptree_destroy(tree, 0);
+    free(keys);
+}
+
+void test_destroy_data()
+{
+    size_t n = 1000;
+    upo_bptree_t tree = upo_bptree_create(int_compare);
+    int key;
+    size_t i;
+
+    /* Leaks of keys and values are reported by memory checkers */
+    for (i = 0; i < n; ++i)
+    {
+        int *k = malloc(sizeof(int));
+        int *v = malloc(sizeof(int));
+
+        if (k == NULL || v == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for a key-value pair");
+        }
+        *k = (int) i;
+        *v = (int) i;
+        upo_bptree_put(tree, k, v);
+    }
+
+    key = 10;
+    upo_bptree_delete(tree, &key, 1);
+    key = (int) n - 1;
+    upo_bptree_delete(tree, &key, 1);
+    /* Smallest keys of leaves are also separators of inner nodes, which must
+     * not refer to freed keys */
+    for (i = 0; i < n/2; ++i)
+    {
+        upo_bptree_delete(tree, upo_bptree_min(tree), 1);
+    }
+    assert( upo_bptree_size(tree) == n - 2 - n/2 );
+    assert( upo_bptree_is_bptree(tree) );
+
+    upo_bptree_destroy(tree, 1);
+}
+
+void test_build()
+{
+    size_t sizes[] = {0, 1, 30, 31, 100, 961, 962, 10000, 100000};
+    size_t num_sizes = sizeof sizes/sizeof sizes[0];
+    size_t max_n = sizes[num_sizes - 1];
+    int *ints = NULL;
+    void **keys = NULL;
+    void **values = NULL;
+    upo_bptree_t tree = NULL;
+    size_t s;
+    size_t i;
+
+    ints = malloc(max_n*sizeof(int));
+    keys = malloc(max_n*sizeof(void*));
+    values = malloc(max_n*sizeof(void*));
+    if (ints == NULL || keys == NULL || values == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys and values");
+    }
+    for (i = 0; i < max_n; ++i)
+    {
+        ints[i] = 2*(int) i;
+        keys[i] = &ints[i];
+        values[i] = &ints[max_n - 1 - i];
+    }
+
+    /* Sizes around the capacity of one and of two levels of nodes */
+    for (s = 0; s < num_sizes; ++s)
+    {
+        size_t n = sizes[s];
+        int key;
+
+        tree = upo_bptree_build(int_compare, keys, values, n);
+
+        assert( upo_bptree_size(tree) == n );
+        check_balanced(tree);
+        for (i = 0; i < n; ++i)
+        {
+            assert( upo_bptree_get(tree, keys[i]) == values[i] );
+            key = ints[i] + 1;
+            assert( !upo_bptree_contains(tree, &key) );
+        }
+
+        /* The tree keeps working after bulk loading */
+        for (i = 0; i < n; i += 2)
+        {
+            upo_bptree_put(tree, keys[i], NULL);
+            upo_bptree_delete(tree, keys[i], 0);
+        }
+        assert( upo_bptree_size(tree) == n/2 );
+        check_balanced(tree);
+
+        upo_bptree_destroy(tree, 0);
+    }
+
+    /* NULL values */
+    tree = upo_bptree_build(int_compare, keys, NULL, 100);
+    assert( upo_bptree_contains(tree, keys[50]) );
+    assert( upo_bptree_get(tree, keys[50]) == NULL );
+    upo_bptree_destroy(tree, 0);
+
+    free(values);
+    free(keys);
+    free(ints);
+}
+
+
+int main()
+{
+    printf("Test case 'empty'... ");
+    fflush(stdout);
+    test_empty();
+    printf("OK\n");
+
+    printf("Test case 'sorted'... ");
+    fflush(stdout);
+    test_sorted();
+    printf("OK\n");
+
+    printf("Test case 'reverse'... ");
+    fflush(stdout);
+    test_reverse();
+    printf("OK\n");
+
+    printf("Test case 'random'... ");
+    fflush(stdout);
+    test_random();
+    printf("OK\n");
+
+    printf("Test case 'delete'... ");
+    fflush(stdout);
+    test_delete();
+    printf("OK\n");
+
+    printf("Test case 'ordered'... ");
+    fflush(stdout);
+    test_ordered();
+    printf("OK\n");
+
+    printf("Test case 'destroy data'... ");
+    fflush(stdout);
+    test_destroy_data();
+    printf("OK\n");
+
+    printf("Test case 'build'... ");
+    fflush(stdout);
+    test_build();
+    printf("OK\n");
+
+    return 0;
+}
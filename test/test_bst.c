@@ -49,6 +49,7 @@ static void test_size();
 static void test_height();
 static void test_traversal();
 static void test_null();
+static void test_pool();
 
 
 int int_compare(const void *a, const void *b)
@@ -1093,6 +1094,86 @@ void test_null()
     upo_bst_destroy(bst, 1);
 }
 
+void test_pool()
+{
+    int keys[] = {8, 3, 1, 6, 4, 7, 10, 14, 13};
+    int values[] = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    size_t n = sizeof keys/sizeof keys[0];
+    upo_pool_t pool = upo_bst_pool_create(4);
+    upo_bst_t bst = NULL;
+    int round;
+    size_t i;
+
+    assert( pool != NULL );
+
+    /* The same pool serves one tree after the other */
+    for (round = 0; round < 3; ++round)
+    {
+        bst = upo_bst_create_with_pool(int_compare, pool);
+        assert( bst != NULL );
+        assert( upo_bst_is_empty(bst) );
+
+        for (i = 0; i < n; ++i)
+        {
+            assert( upo_bst_put(bst, &keys[i], &values[i]) == NULL );
+        }
+        assert( upo_bst_size(bst) == n );
+        assert( upo_pool_size(pool) == n );
+        assert( upo_pool_num_chunks(pool) > 1 );
+        for (i = 0; i < n; ++i)
+        {
+            assert( upo_bst_get(bst, &keys[i]) == &values[i] );
+        }
+
+        /* Deleted nodes go back to the pool */
+        upo_bst_delete(bst, &keys[0], 0); // 8: two children
+        upo_bst_delete(bst, &keys[2], 0); // 1: leaf
+        upo_bst_delete(bst, &keys[6], 0); // 10: one child
+        upo_bst_delete_min(bst, 0);
+        assert( upo_bst_size(bst) == n - 4 );
+        assert( upo_pool_size(pool) == n - 4 );
+        assert( !upo_bst_contains(bst, &keys[0]) );
+        assert( upo_bst_get(bst, &keys[3]) == &values[3] );
+
+        /* Freed blocks are reused before growing the pool */
+        upo_bst_insert(bst, &keys[0], &values[0]);
+        assert( upo_pool_size(pool) == n - 3 );
+        assert( upo_bst_get(bst, &keys[0]) == &values[0] );
+
+        if (round == 0)
+        {
+            upo_bst_clear(bst, 0);
+            assert( upo_bst_is_empty(bst) );
+            assert( upo_pool_size(pool) == 0 );
+            assert( upo_pool_num_chunks(pool) == 0 );
+        }
+        upo_bst_destroy(bst, 0);
+        assert( upo_pool_size(pool) == 0 );
+    }
+
+    /* Destroying data still frees keys and values, but not the nodes one by one */
+    bst = upo_bst_create_with_pool(int_compare, pool);
+    for (i = 0; i < n; ++i)
+    {
+        int *key = malloc(sizeof(int));
+        int *value = malloc(sizeof(int));
+
+        if (key == NULL || value == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for keys and values");
+        }
+        *key = keys[i];
+        *value = values[i];
+        upo_bst_put(bst, key, value);
+    }
+    upo_bst_delete(bst, &keys[0], 1);
+    assert( upo_bst_size(bst) == n - 1 );
+    upo_bst_destroy(bst, 1);
+    assert( upo_pool_size(pool) == 0 );
+
+    upo_pool_destroy(pool);
+}
+
 
 int main()
 {
@@ -1141,5 +1222,10 @@ int main()
     test_null();
     printf("OK\n");
 
+    printf("Test case 'pool'... ");
+    fflush(stdout);
+    test_pool();
+    printf("OK\n");
+
     return 0;
 }
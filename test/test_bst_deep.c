@@ -0,0 +1,234 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Threads are a POSIX extension */
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <upo/bst.h>
+#include <upo/error.h>
+
+
+/**
+ * \brief The number of keys inserted in sorted order.
+ *
+ * Each insertion walks the whole tree, so the time is quadratic in the number
+ * of keys.
+ */
+#define NUM_KEYS 20000U
+
+/**
+ * \brief The stack size of the thread running the tests.
+ *
+ * It is far smaller than the stack needed by recursive operations on a tree
+ * of height #NUM_KEYS, so that only iterative ones can succeed.
+ */
+#if defined(UPO_BST_USE_RECURSIVE_PUT) || defined(UPO_BST_USE_RECURSIVE_GET) || defined(UPO_BST_USE_RECURSIVE_DELETE) || defined(UPO_BST_USE_RECURSIVE_TRAVERSAL)
+# define STACK_SIZE 0U
+#else
+# define STACK_SIZE 262144U
+#endif
+
+
+/** \brief Type for the context of the in-order visit. */
+typedef struct {
+    int next_key; /**< The key expected next. */
+} visit_context_t;
+
+
+static int int_compare(const void *a, const void *b);
+static void check_visitor(void *key, void *value, void *context);
+static void run_with_stack(void *(*test)(void*), void *arg);
+
+static void* test_sorted(void *arg);
+static void* test_reverse_sorted(void *arg);
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void check_visitor(void *key, void *value, void *context)
+{
+    visit_context_t *ctx = context;
+
+    assert( *(int*) key == ctx->next_key );
+    assert( value == key );
+    ctx->next_key += 1;
+}
+
+void run_with_stack(void *(*test)(void*), void *arg)
+{
+    pthread_attr_t attr;
+    pthread_t thread;
+
+    if (pthread_attr_init(&attr) != 0)
+    {
+        upo_throw_sys_error("Unable to initialize thread attributes");
+    }
+    if (STACK_SIZE > 0 && pthread_attr_setstacksize(&attr, STACK_SIZE) != 0)
+    {
+        upo_throw_sys_error("Unable to set the stack size of a thread");
+    }
+    if (pthread_create(&thread, &attr, test, arg) != 0)
+    {
+        upo_throw_sys_error("Unable to create a thread");
+    }
+    pthread_join(thread, NULL);
+    pthread_attr_destroy(&attr);
+}
+
+void* test_sorted(void *arg)
+{
+    /* Sorted insertions make the tree a chain of right children */
+    int *keys = arg;
+    int missing_lo = -1;
+    int missing_hi = (int) NUM_KEYS;
+    int new_value = 0;
+    visit_context_t ctx = {0};
+    upo_bst_t bst = upo_bst_create(int_compare);
+    size_t i;
+
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        upo_bst_insert(bst, &keys[i], &keys[i]);
+    }
+    assert( upo_bst_size(bst) == NUM_KEYS );
+    assert( upo_bst_height(bst) == NUM_KEYS - 1 );
+
+    /* Lookups at every depth */
+    for (i = 0; i < NUM_KEYS; i += NUM_KEYS/20)
+    {
+        assert( upo_bst_get(bst, &keys[i]) == &keys[i] );
+    }
+    assert( upo_bst_contains(bst, &keys[NUM_KEYS-1]) );
+    assert( !upo_bst_contains(bst, &missing_hi) );
+    assert( upo_bst_put(bst, &keys[NUM_KEYS-1], &new_value) == &keys[NUM_KEYS-1] );
+    assert( upo_bst_put(bst, &keys[NUM_KEYS-1], &keys[NUM_KEYS-1]) == &new_value );
+    assert( upo_bst_size(bst) == NUM_KEYS );
+
+    assert( upo_bst_min(bst) == &keys[0] );
+    assert( upo_bst_max(bst) == &keys[NUM_KEYS-1] );
+    assert( upo_bst_floor(bst, &missing_hi) == &keys[NUM_KEYS-1] );
+    assert( upo_bst_floor(bst, &missing_lo) == NULL );
+    assert( upo_bst_ceiling(bst, &missing_lo) == &keys[0] );
+    assert( upo_bst_ceiling(bst, &missing_hi) == NULL );
+
+    upo_bst_traverse_in_order(bst, check_visitor, &ctx);
+    assert( ctx.next_key == (int) NUM_KEYS );
+
+    /* Deletions at the bottom and at the top of the chain */
+    upo_bst_delete(bst, &missing_hi, 0);
+    upo_bst_delete_max(bst, 0);
+    upo_bst_delete(bst, &keys[NUM_KEYS/2], 0);
+    assert( upo_bst_size(bst) == NUM_KEYS - 2 );
+    assert( !upo_bst_contains(bst, &keys[NUM_KEYS/2]) );
+    assert( upo_bst_max(bst) == &keys[NUM_KEYS-2] );
+    for (i = 0; i < NUM_KEYS/2; ++i)
+    {
+        upo_bst_delete_min(bst, 0);
+    }
+    assert( upo_bst_size(bst) == NUM_KEYS/2 - 2 );
+    assert( upo_bst_min(bst) == &keys[NUM_KEYS/2 + 1] );
+
+    upo_bst_destroy(bst, 0);
+
+    return NULL;
+}
+
+void* test_reverse_sorted(void *arg)
+{
+    /* Reverse sorted insertions make the tree a chain of left children */
+    int *keys = arg;
+    visit_context_t ctx = {0};
+    upo_pool_t pool = upo_bst_pool_create(UPO_POOL_DEFAULT_CHUNK_CAPACITY);
+    upo_bst_t bst = upo_bst_create_with_pool(int_compare, pool);
+    size_t i;
+
+    for (i = NUM_KEYS; i > 0; --i)
+    {
+        assert( upo_bst_put(bst, &keys[i-1], &keys[i-1]) == NULL );
+    }
+    assert( upo_bst_size(bst) == NUM_KEYS );
+    assert( upo_bst_height(bst) == NUM_KEYS - 1 );
+    assert( upo_bst_get(bst, &keys[0]) == &keys[0] );
+    assert( upo_bst_min(bst) == &keys[0] );
+
+    upo_bst_traverse_in_order(bst, check_visitor, &ctx);
+    assert( ctx.next_key == (int) NUM_KEYS );
+
+    upo_bst_delete_min(bst, 0);
+    upo_bst_delete(bst, &keys[NUM_KEYS-1], 0);
+    assert( upo_bst_size(bst) == NUM_KEYS - 2 );
+    assert( upo_bst_min(bst) == &keys[1] );
+
+    /* Clearing gives all pooled nodes back at once, and they are reused */
+    upo_bst_clear(bst, 0);
+    assert( upo_bst_is_empty(bst) );
+    for (i = NUM_KEYS; i > 0; --i)
+    {
+        upo_bst_insert(bst, &keys[i-1], &keys[i-1]);
+    }
+
+    upo_bst_destroy(bst, 0);
+    upo_pool_destroy(pool);
+
+    return NULL;
+}
+
+
+int main()
+{
+    int *keys = NULL;
+    size_t i;
+
+    keys = malloc(NUM_KEYS*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+    for (i = 0; i < NUM_KEYS; ++i)
+    {
+        keys[i] = (int) i;
+    }
+
+    printf("Test case 'sorted insertions'... ");
+    fflush(stdout);
+    run_with_stack(test_sorted, keys);
+    printf("OK\n");
+
+    printf("Test case 'reverse sorted insertions'... ");
+    fflush(stdout);
+    run_with_stack(test_reverse_sorted, keys);
+    printf("OK\n");
+
+    free(keys);
+
+    return 0;
+}
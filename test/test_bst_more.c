@@ -21,6 +21,7 @@
 
 #include <assert.h>
 #include <limits.h>
+#include <math.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -37,6 +38,9 @@ static void test_min_max();
 static void test_delete_min_max();
 static void test_floor_ceiling();
 static void test_bst_property();
+static void test_iter();
+static void test_build_rebalance();
+static void test_scapegoat();
 
 
 int int_compare(const void *a, const void *b)
@@ -874,6 +878,55 @@ void test_rank()
     upo_bst_destroy(bst, 0);
 }
 
+void test_select()
+{
+    int keys[] = {8, 3, 1, 6, 4, 7, 10, 14, 13};
+    int values[] = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    int sorted_keys[] = {1, 3, 4, 6, 7, 8, 10, 13, 14};
+    int old_value = 100;
+
+    upo_bst_t bst = upo_bst_create(int_compare);
+
+    assert(bst != NULL);
+
+    // BST with no nodes
+
+    assert(upo_bst_select(bst, 0) == NULL);
+
+    // Filling BST
+
+    size_t n = sizeof(keys) / sizeof(int);
+    for (size_t i = 0; i < n; i++)
+        upo_bst_put(bst, &keys[i], &values[i]);
+
+    for (size_t k = 0; k < n; k++)
+    {
+        assert(*(int*) upo_bst_select(bst, k) == sorted_keys[k]);
+        assert(upo_bst_rank(bst, upo_bst_select(bst, k)) == k);
+    }
+    assert(upo_bst_select(bst, n) == NULL);
+
+    // Subtree sizes after updates and deletions
+
+    assert(upo_bst_put(bst, &keys[0], &old_value) == &values[0]);
+    assert(upo_bst_size(bst) == n);
+
+    upo_bst_delete(bst, &keys[0], 0); // 8: two children
+    upo_bst_delete(bst, &keys[2], 0); // 1: leaf
+    upo_bst_delete(bst, &keys[6], 0); // 10: one child
+    assert(upo_bst_size(bst) == n - 3);
+
+    int remaining_keys[] = {3, 4, 6, 7, 13, 14};
+    for (size_t k = 0; k < n - 3; k++)
+    {
+        assert(*(int*) upo_bst_select(bst, k) == remaining_keys[k]);
+        assert(upo_bst_rank(bst, &remaining_keys[k]) == k);
+    }
+    assert(upo_bst_select(bst, n - 3) == NULL);
+
+    upo_bst_destroy(bst, 0);
+}
+
 void test_predecessor()
 {
     int keys[] = {8, 3, 1, 6, 4, 7, 10, 14, 13};
@@ -1004,6 +1057,394 @@ void test_keys_le()
     upo_bst_destroy(bst, 0);
 }
 
+void test_iter()
+{
+    /* Deep trees make iterators move part of their path to the heap */
+    size_t n = 3*UPO_BST_ITER_INLINE_DEPTH;
+    int *keys = NULL;
+    int *values = NULL;
+    int shape;
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    values = malloc(n*sizeof(int));
+    if (keys == NULL || values == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys and values");
+    }
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = 2*(int) i;
+        values[i] = (int) i;
+    }
+
+    /* Shapes: balanced, right spine, left spine, zigzag */
+    for (shape = 0; shape < 4; ++shape)
+    {
+        upo_bst_t bst = upo_bst_create(int_compare);
+        upo_bst_iter_t it;
+        upo_bst_key_list_t key_list = NULL;
+        void *key = NULL;
+        void *value = NULL;
+        int lo_key;
+        int hi_key;
+        int q;
+
+        /* Empty tree */
+        upo_bst_iter_seek(bst, &it, NULL);
+        assert( !upo_bst_iter_next(&it, &key, &value) );
+        assert( !upo_bst_iter_prev(&it, &key, &value) );
+        upo_bst_iter_destroy(&it);
+
+        for (i = 0; i < n; ++i)
+        {
+            size_t j = i;
+
+            switch (shape)
+            {
+                case 0:
+                    /* Bit-reversal-like order: root first, then halves */
+                    j = (i*37) % n;
+                    break;
+                case 2:
+                    j = n - 1 - i;
+                    break;
+                case 3:
+                    j = (i % 2 == 0) ? i/2 : n - 1 - i/2;
+                    break;
+            }
+            upo_bst_insert(bst, &keys[j], &values[j]);
+        }
+        assert( upo_bst_size(bst) == n );
+
+        /* Whole tree, forward and then backward */
+        upo_bst_iter_seek(bst, &it, NULL);
+        assert( !upo_bst_iter_prev(&it, NULL, NULL) );
+        for (i = 0; i < n; ++i)
+        {
+            assert( upo_bst_iter_next(&it, &key, &value) );
+            assert( key == &keys[i] );
+            assert( value == &values[i] );
+        }
+        assert( !upo_bst_iter_next(&it, &key, NULL) );
+        assert( key == &keys[n-1] );
+        for (i = n; i > 0; --i)
+        {
+            assert( upo_bst_iter_prev(&it, &key, NULL) );
+            assert( key == &keys[i-1] );
+        }
+        assert( !upo_bst_iter_prev(&it, NULL, NULL) );
+        assert( upo_bst_iter_next(&it, &key, NULL) );
+        assert( key == &keys[0] );
+        upo_bst_iter_destroy(&it);
+
+        /* Seeks on present and absent keys, and past both ends */
+        for (q = -1; q <= 2*(int) n; ++q)
+        {
+            int ceil_key = (q < 0) ? 0 : q + (q % 2);
+            int lower_key = (q % 2 == 0) ? q - 2 : q - 1;
+
+            upo_bst_iter_seek(bst, &it, &q);
+            if (ceil_key < 2*(int) n)
+            {
+                assert( upo_bst_iter_next(&it, &key, NULL) );
+                assert( *(int*) key == ceil_key );
+                /* Moving back returns the same key */
+                assert( upo_bst_iter_prev(&it, &key, NULL) );
+                assert( *(int*) key == ceil_key );
+            }
+            else
+            {
+                assert( !upo_bst_iter_next(&it, NULL, NULL) );
+            }
+
+            if (lower_key >= 0)
+            {
+                assert( upo_bst_iter_prev(&it, &key, NULL) );
+                assert( *(int*) key == (lower_key < 2*(int) n ? lower_key : 2*(int) n - 2) );
+            }
+            else
+            {
+                assert( !upo_bst_iter_prev(&it, NULL, NULL) );
+            }
+            upo_bst_iter_destroy(&it);
+        }
+
+        /* Ranges come in ascending order */
+        lo_key = 11;
+        hi_key = 2*UPO_BST_ITER_INLINE_DEPTH + 10;
+        key_list = upo_bst_keys_range(bst, &lo_key, &hi_key);
+        for (q = 12; q <= hi_key; q += 2)
+        {
+            upo_bst_key_list_t old_list = key_list;
+
+            assert( key_list != NULL );
+            assert( *(int*) key_list->key == q );
+            key_list = key_list->next;
+            free(old_list);
+        }
+        assert( key_list == NULL );
+
+        upo_bst_destroy(bst, 0);
+    }
+
+    free(values);
+    free(keys);
+}
+
+void test_build_rebalance()
+{
+    size_t max_n = 300;
+    int *keys = NULL;
+    int *values = NULL;
+    void **key_ptrs = NULL;
+    void **value_ptrs = NULL;
+    int min_key = INT_MIN;
+    int max_key = INT_MAX;
+    size_t n;
+    size_t i;
+
+    keys = malloc(max_n*sizeof(int));
+    values = malloc(max_n*sizeof(int));
+    key_ptrs = malloc(max_n*sizeof(void*));
+    value_ptrs = malloc(max_n*sizeof(void*));
+    if (keys == NULL || values == NULL || key_ptrs == NULL || value_ptrs == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys and values");
+    }
+    for (i = 0; i < max_n; ++i)
+    {
+        keys[i] = 3*(int) i;
+        values[i] = (int) i;
+        key_ptrs[i] = &keys[i];
+        value_ptrs[i] = &values[i];
+    }
+
+    for (n = 0; n <= max_n; n += (n < 20) ? 1 : 37)
+    {
+        size_t height = 0;
+        upo_bst_t bst = NULL;
+
+        while (((size_t) 2 << height) <= n)
+        {
+            ++height;
+        }
+
+        /* Build from sorted pairs */
+        bst = upo_bst_build_from_sorted(int_compare, key_ptrs, value_ptrs, n);
+        assert( upo_bst_size(bst) == n );
+        assert( upo_bst_height(bst) == height );
+        assert( upo_bst_is_bst(bst, &min_key, &max_key) );
+        for (i = 0; i < n; ++i)
+        {
+            assert( upo_bst_get(bst, &keys[i]) == &values[i] );
+            assert( upo_bst_select(bst, i) == &keys[i] );
+        }
+        /* The tree can then be updated as any other */
+        if (n > 0)
+        {
+            upo_bst_delete(bst, &keys[n/2], 0);
+            assert( upo_bst_size(bst) == n - 1 );
+            upo_bst_put(bst, &keys[n/2], &values[n/2]);
+            assert( upo_bst_get(bst, &keys[n/2]) == &values[n/2] );
+        }
+        upo_bst_destroy(bst, 0);
+
+        /* Without values */
+        bst = upo_bst_build_from_sorted(int_compare, key_ptrs, NULL, n);
+        assert( upo_bst_size(bst) == n );
+        for (i = 0; i < n; ++i)
+        {
+            assert( upo_bst_contains(bst, &keys[i]) );
+            assert( upo_bst_get(bst, &keys[i]) == NULL );
+        }
+        upo_bst_destroy(bst, 0);
+
+        /* Rebalance a chain built by sorted insertions */
+        bst = upo_bst_create(int_compare);
+        for (i = 0; i < n; ++i)
+        {
+            upo_bst_put(bst, &keys[i], &values[i]);
+        }
+        upo_bst_rebalance(bst);
+        assert( upo_bst_size(bst) == n );
+        assert( upo_bst_height(bst) == height );
+        assert( upo_bst_is_bst(bst, &min_key, &max_key) );
+        for (i = 0; i < n; ++i)
+        {
+            assert( upo_bst_get(bst, &keys[i]) == &values[i] );
+            assert( upo_bst_select(bst, i) == &keys[i] );
+            assert( upo_bst_rank(bst, &keys[i]) == i );
+        }
+
+        /* Rebalance a zigzag-shaped tree */
+        upo_bst_clear(bst, 0);
+        for (i = 0; i < n; ++i)
+        {
+            size_t j = (i % 2 == 0) ? i/2 : n - 1 - i/2;
+
+            upo_bst_insert(bst, &keys[j], &values[j]);
+        }
+        upo_bst_rebalance(bst);
+        assert( upo_bst_height(bst) == height );
+        for (i = 0; i < n; ++i)
+        {
+            assert( upo_bst_select(bst, i) == &keys[i] );
+        }
+
+        /* Rebalancing a balanced tree keeps it balanced */
+        upo_bst_rebalance(bst);
+        assert( upo_bst_height(bst) == height );
+        assert( upo_bst_size(bst) == n );
+        upo_bst_destroy(bst, 0);
+    }
+
+    /* NULL tree */
+    upo_bst_rebalance(NULL);
+
+    free(value_ptrs);
+    free(key_ptrs);
+    free(values);
+    free(keys);
+}
+
+void test_scapegoat()
+{
+    size_t n = 2000;
+    double alphas[] = {0.55, UPO_BST_SCAPEGOAT_DEFAULT_ALPHA, 0.9};
+    size_t num_alphas = sizeof alphas/sizeof alphas[0];
+    int *keys = NULL;
+    int *values = NULL;
+    int min_key = INT_MIN;
+    int max_key = INT_MAX;
+    size_t a;
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    values = malloc(n*sizeof(int));
+    if (keys == NULL || values == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys and values");
+    }
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+        values[i] = (int) i;
+    }
+
+    for (a = 0; a < num_alphas; ++a)
+    {
+        double alpha = alphas[a];
+        upo_pool_t pool = upo_bst_pool_create(UPO_POOL_DEFAULT_CHUNK_CAPACITY);
+        upo_bst_t bst = upo_bst_create_with_pool(int_compare, pool);
+        size_t size = 0;
+
+        upo_bst_set_scapegoat(bst, alpha);
+
+        /* Sorted insertions: the height stays within log_{1/alpha}(n) */
+        for (i = 0; i < n; ++i)
+        {
+            if (i % 2 == 0)
+            {
+                assert( upo_bst_put(bst, &keys[i], &values[i]) == NULL );
+            }
+            else
+            {
+                upo_bst_insert(bst, &keys[i], &values[i]);
+            }
+            if (i % 97 == 0)
+            {
+                assert( (double) upo_bst_height(bst) <= log((double) i + 1)/log(1/alpha) );
+            }
+        }
+        assert( upo_bst_size(bst) == n );
+        assert( (double) upo_bst_height(bst) <= log((double) n)/log(1/alpha) );
+        assert( upo_bst_is_bst(bst, &min_key, &max_key) );
+        for (i = 0; i < n; ++i)
+        {
+            assert( upo_bst_get(bst, &keys[i]) == &values[i] );
+            assert( upo_bst_select(bst, i) == &keys[i] );
+        }
+
+        /* Replacing values does not change the tree */
+        assert( upo_bst_put(bst, &keys[n-1], &values[0]) == &values[n-1] );
+        assert( upo_bst_put(bst, &keys[n-1], &values[n-1]) == &values[0] );
+        assert( upo_bst_size(bst) == n );
+
+        /* Deletions from one end: the whole tree is rebuilt once it shrinks */
+        size = n;
+        for (i = 0; i < 3*n/4; ++i)
+        {
+            if (i % 2 == 0)
+            {
+                upo_bst_delete_min(bst, 0);
+            }
+            else
+            {
+                upo_bst_delete(bst, &keys[i], 0);
+            }
+            --size;
+            if (i % 97 == 0)
+            {
+                assert( (double) upo_bst_height(bst) <= log((double) size)/log(1/alpha) + 1 );
+            }
+        }
+        assert( upo_bst_size(bst) == size );
+        assert( upo_bst_is_bst(bst, &min_key, &max_key) );
+        for (i = 0; i < size; ++i)
+        {
+            assert( *(int*) upo_bst_select(bst, i) == (int) (3*n/4 + i) );
+        }
+
+        /* Reverse sorted reinsertions */
+        for (i = 3*n/4; i > 0; --i)
+        {
+            upo_bst_put(bst, &keys[i-1], &values[i-1]);
+        }
+        assert( upo_bst_size(bst) == n );
+        assert( (double) upo_bst_height(bst) <= log((double) n)/log(1/alpha) );
+
+        upo_bst_clear(bst, 0);
+        assert( upo_bst_is_empty(bst) );
+        for (i = 0; i < n; ++i)
+        {
+            upo_bst_insert(bst, &keys[i], &values[i]);
+        }
+        assert( (double) upo_bst_height(bst) <= log((double) n)/log(1/alpha) );
+
+        upo_bst_destroy(bst, 0);
+        upo_pool_destroy(pool);
+    }
+
+    /* Switching the mode of an existing tree */
+    {
+        upo_bst_t bst = upo_bst_create(int_compare);
+
+        for (i = 0; i < n/2; ++i)
+        {
+            upo_bst_insert(bst, &keys[i], &values[i]);
+        }
+        assert( upo_bst_height(bst) == n/2 - 1 );
+
+        upo_bst_set_scapegoat(bst, UPO_BST_SCAPEGOAT_DEFAULT_ALPHA);
+        assert( (double) upo_bst_height(bst) <= log2((double) n/2) );
+
+        /* Back to a plain tree: sorted insertions make a chain again */
+        upo_bst_set_scapegoat(bst, 1.0);
+        for (i = n/2; i < n; ++i)
+        {
+            upo_bst_insert(bst, &keys[i], &values[i]);
+        }
+        assert( upo_bst_height(bst) >= n/2 );
+        assert( upo_bst_size(bst) == n );
+
+        upo_bst_destroy(bst, 0);
+    }
+
+    free(values);
+    free(keys);
+}
+
 
 int main()
 {
@@ -1037,6 +1478,11 @@ int main()
     test_rank();
     printf("OK\n");
 
+    printf("Test case 'key select'... ");
+    fflush(stdout);
+    test_select();
+    printf("OK\n");
+
     printf("Test case 'predecessor'... ");
     fflush(stdout);
     test_predecessor();
@@ -1052,6 +1498,21 @@ int main()
     test_keys_le();
     printf("OK\n");
 
+    printf("Test case 'iterator'... ");
+    fflush(stdout);
+    test_iter();
+    printf("OK\n");
+
+    printf("Test case 'build/rebalance'... ");
+    fflush(stdout);
+    test_build_rebalance();
+    printf("OK\n");
+
+    printf("Test case 'scapegoat'... ");
+    fflush(stdout);
+    test_scapegoat();
+    printf("OK\n");
+
     //TODO add test for upo_bst_subtree_count_leaves_depth()
 
     return 0;
@@ -0,0 +1,223 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <upo/filter.h>
+#include <upo/hashtable.h>
+
+
+static void test_bloom();
+static void test_bloom_fpr();
+static void test_cbloom();
+static void test_cbloom_saturation();
+static void test_null();
+
+
+void test_bloom()
+{
+    upo_bloom_t filter = upo_bloom_create(1000, 0.01);
+    uint64_t i;
+
+    assert( filter != NULL );
+    /* About 10 bits per key with 7 hash functions, in whole cache lines */
+    assert( upo_bloom_num_hashes(filter) == 7 );
+    assert( upo_bloom_memory_usage(filter) % UPO_FILTER_BLOCK_SIZE == 0 );
+    assert( upo_bloom_memory_usage(filter) >= 1000*9/8 );
+
+    /* The identity hash is a weak one, but the filter remixes it */
+    for (i = 0; i < 1000; ++i)
+    {
+        assert( !upo_bloom_may_contain(filter, 2*i) );
+    }
+    for (i = 0; i < 1000; ++i)
+    {
+        upo_bloom_add(filter, 2*i);
+    }
+    for (i = 0; i < 1000; ++i)
+    {
+        assert( upo_bloom_may_contain(filter, 2*i) );
+    }
+
+    upo_bloom_clear(filter);
+    for (i = 0; i < 1000; ++i)
+    {
+        assert( !upo_bloom_may_contain(filter, 2*i) );
+    }
+
+    upo_bloom_destroy(filter);
+}
+
+void test_bloom_fpr()
+{
+    size_t n = 100000;
+    double fprs[] = {0.1, 0.01, 0.001};
+    size_t f;
+
+    for (f = 0; f < sizeof fprs/sizeof fprs[0]; ++f)
+    {
+        upo_bloom_t bloom = upo_bloom_create(n, fprs[f]);
+        upo_cbloom_t cbloom = upo_cbloom_create(n, fprs[f]);
+        size_t bloom_positives = 0;
+        size_t cbloom_positives = 0;
+        int key;
+
+        for (key = 0; key < (int) n; ++key)
+        {
+            upo_bloom_add(bloom, upo_ht_hash_int_mix(&key));
+            upo_cbloom_add(cbloom, upo_ht_hash_int_mix(&key));
+        }
+        for (key = (int) n; key < (int) (11*n); ++key)
+        {
+            bloom_positives += upo_bloom_may_contain(bloom, upo_ht_hash_int_mix(&key));
+            cbloom_positives += upo_cbloom_may_contain(cbloom, upo_ht_hash_int_mix(&key));
+        }
+
+        /* Filters are sized for blocking not to spoil the wanted rate */
+        assert( bloom_positives < 1.5*fprs[f]*10*n );
+        assert( cbloom_positives < 1.5*fprs[f]*10*n );
+
+        upo_cbloom_destroy(cbloom);
+        upo_bloom_destroy(bloom);
+    }
+}
+
+void test_cbloom()
+{
+    upo_cbloom_t filter = upo_cbloom_create(1000, 0.01);
+    uint64_t i;
+
+    assert( filter != NULL );
+    assert( upo_cbloom_num_hashes(filter) > 0 );
+    /* 4-bit counters take 4 times the memory of bits */
+    assert( upo_cbloom_memory_usage(filter) >= 4*1000*9/8 );
+
+    for (i = 0; i < 1000; ++i)
+    {
+        upo_cbloom_add(filter, i);
+    }
+    /* A key added twice stays until it is removed twice */
+    upo_cbloom_add(filter, 0);
+    for (i = 0; i < 1000; ++i)
+    {
+        upo_cbloom_remove(filter, i);
+    }
+    assert( upo_cbloom_may_contain(filter, 0) );
+    upo_cbloom_remove(filter, 0);
+    /* All counters are back to zero */
+    for (i = 0; i < 1000; ++i)
+    {
+        assert( !upo_cbloom_may_contain(filter, i) );
+    }
+
+    /* Removing some keys leaves no false negatives among the others */
+    for (i = 0; i < 1000; ++i)
+    {
+        upo_cbloom_add(filter, i);
+    }
+    for (i = 0; i < 1000; i += 2)
+    {
+        upo_cbloom_remove(filter, i);
+    }
+    for (i = 1; i < 1000; i += 2)
+    {
+        assert( upo_cbloom_may_contain(filter, i) );
+    }
+
+    upo_cbloom_clear(filter);
+    for (i = 0; i < 1000; ++i)
+    {
+        assert( !upo_cbloom_may_contain(filter, i) );
+    }
+
+    upo_cbloom_destroy(filter);
+}
+
+void test_cbloom_saturation()
+{
+    upo_cbloom_t filter = upo_cbloom_create(1, 0.5);
+    size_t i;
+
+    /* Counters saturate and stick, so that no key becomes a false negative,
+     * even if a key is removed more times than it has been added */
+    for (i = 0; i < 2*UPO_CBLOOM_MAX_COUNT; ++i)
+    {
+        upo_cbloom_add(filter, 42);
+    }
+    for (i = 0; i < 4*UPO_CBLOOM_MAX_COUNT; ++i)
+    {
+        upo_cbloom_remove(filter, 42);
+    }
+    assert( upo_cbloom_may_contain(filter, 42) );
+
+    upo_cbloom_destroy(filter);
+}
+
+void test_null()
+{
+    assert( !upo_bloom_may_contain(NULL, 1) );
+    assert( upo_bloom_num_hashes(NULL) == 0 );
+    assert( upo_bloom_memory_usage(NULL) == 0 );
+    upo_bloom_add(NULL, 1);
+    upo_bloom_clear(NULL);
+    upo_bloom_destroy(NULL);
+
+    assert( !upo_cbloom_may_contain(NULL, 1) );
+    assert( upo_cbloom_num_hashes(NULL) == 0 );
+    assert( upo_cbloom_memory_usage(NULL) == 0 );
+    upo_cbloom_add(NULL, 1);
+    upo_cbloom_remove(NULL, 1);
+    upo_cbloom_clear(NULL);
+    upo_cbloom_destroy(NULL);
+}
+
+
+int main()
+{
+    printf("Test case 'bloom'... ");
+    fflush(stdout);
+    test_bloom();
+    printf("OK\n");
+
+    printf("Test case 'bloom false positive rate'... ");
+    fflush(stdout);
+    test_bloom_fpr();
+    printf("OK\n");
+
+    printf("Test case 'counting bloom'... ");
+    fflush(stdout);
+    test_cbloom();
+    printf("OK\n");
+
+    printf("Test case 'counting bloom saturation'... ");
+    fflush(stdout);
+    test_cbloom_saturation();
+    printf("OK\n");
+
+    printf("Test case 'null'... ");
+    fflush(stdout);
+    test_null();
+    printf("OK\n");
+
+    return 0;
+}
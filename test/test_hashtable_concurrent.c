@@ -0,0 +1,919 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Threads are a POSIX extension */
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <upo/error.h>
+#include <upo/hashtable_concurrent.h>
+
+
+#define NUM_THREADS 4
+#define NUM_KEYS_PER_THREAD 5000
+#define NUM_STRESS_ROUNDS 20
+
+
+/** \brief The work assigned to a thread. */
+typedef struct {
+            upo_ht_striped_t ht;
+            upo_ht_rcu_t rcu_ht;
+            int *keys; /**< The keys shared by all threads. */
+            size_t num_keys; /**< The number of shared keys. */
+            size_t id; /**< The identifier of the thread. */
+        } thread_work_t;
+
+
+static int int_compare(const void *a, const void *b);
+static void count_key_visit(void *key, void *value, void *info);
+static void check_pair_visit(void *key, void *value, void *info);
+static void check_pair_visit(void *key, void *value, void *info)
+{
+    int *k = key;
+    int *v = value;
+
+    assert( *k == *v );
+
+    count_key_visit(key, value, info);
+}
+
+void* put_get_thread(void *arg);
+static void* delete_thread(void *arg);
+static void* read_thread(void *arg);
+static void* rcu_write_thread(void *arg);
+static void* rcu_read_thread(void *arg);
+
+static void test_create_destroy();
+static void test_put_get_contains_delete();
+static void test_insert();
+static void test_clear();
+static void test_resize();
+static void test_traverse();
+static void test_concurrent_put_get();
+static void test_concurrent_delete();
+static void test_concurrent_read_write();
+static void test_rcu_put_get_contains_delete();
+static void test_rcu_clear();
+static void test_rcu_resize();
+static void test_rcu_traverse();
+static void test_rcu_stress();
+static void test_null();
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    assert( a != NULL );
+    assert( b != NULL );
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void count_key_visit(void *key, void *value, void *info)
+{
+    size_t *counter = info;
+
+    assert( key != NULL );
+    assert( value != NULL );
+
+    *counter += 1;
+}
+
+void* put_get_thread(void *arg)
+{
+    thread_work_t *work = arg;
+    size_t i;
+
+    /* Each thread puts a disjoint range of keys */
+    for (i = work->id*NUM_KEYS_PER_THREAD; i < (work->id+1)*NUM_KEYS_PER_THREAD; ++i)
+    {
+        upo_ht_striped_put(work->ht, &work->keys[i], &work->keys[i]);
+    }
+    for (i = work->id*NUM_KEYS_PER_THREAD; i < (work->id+1)*NUM_KEYS_PER_THREAD; ++i)
+    {
+        int *value = upo_ht_striped_get(work->ht, &work->keys[i]);
+
+        assert( value != NULL );
+        assert( *value == work->keys[i] );
+    }
+
+    return NULL;
+}
+
+void* delete_thread(void *arg)
+{
+    thread_work_t *work = arg;
+    size_t i;
+
+    /* Each thread deletes the even keys of its range */
+    for (i = work->id*NUM_KEYS_PER_THREAD; i < (work->id+1)*NUM_KEYS_PER_THREAD; i += 2)
+    {
+        upo_ht_striped_delete(work->ht, &work->keys[i], 0);
+    }
+
+    return NULL;
+}
+
+void* read_thread(void *arg)
+{
+    thread_work_t *work = arg;
+    size_t r;
+    size_t i;
+
+    /* Keys in the first half are never deleted: they must always be found,
+     * even while the table is resized */
+    for (r = 0; r < 4; ++r)
+    {
+        for (i = 0; i < work->num_keys/2; ++i)
+        {
+            assert( upo_ht_striped_contains(work->ht, &work->keys[i]) );
+        }
+    }
+
+    return NULL;
+}
+
+void* rcu_write_thread(void *arg)
+{
+    thread_work_t *work = arg;
+    int present[NUM_KEYS_PER_THREAD] = {0};
+    size_t r;
+    size_t i;
+
+    /* Each writer repeatedly inserts and deletes (freeing them) freshly
+     * allocated keys of its own range, so that lookups of other threads
+     * run on nodes being reclaimed */
+    for (r = 0; r < NUM_STRESS_ROUNDS; ++r)
+    {
+        for (i = 0; i < NUM_KEYS_PER_THREAD; ++i)
+        {
+            int k = (int) (work->id*NUM_KEYS_PER_THREAD + i);
+
+            if (!present[i] && (i + r) % 3 != 0)
+            {
+                int *key = malloc(sizeof(int));
+                int *value = malloc(sizeof(int));
+
+                if (key == NULL || value == NULL)
+                {
+                    upo_throw_sys_error("Unable to allocate memory for key-value pairs");
+                }
+                *key = *value = k;
+                assert( upo_ht_rcu_put(work->rcu_ht, key, value) == NULL );
+                present[i] = 1;
+            }
+            else if (present[i] && (i + r) % 3 == 0)
+            {
+                upo_ht_rcu_delete(work->rcu_ht, &k, 1);
+                present[i] = 0;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+void* rcu_read_thread(void *arg)
+{
+    thread_work_t *work = arg;
+    size_t r;
+    size_t i;
+
+    for (r = 0; r < NUM_STRESS_ROUNDS; ++r)
+    {
+        size_t counter = 0;
+
+        /* Keys of the writers may or may not be found, but comparing them
+         * must never read freed memory */
+        for (i = 0; i < (NUM_THREADS-1)*NUM_KEYS_PER_THREAD; ++i)
+        {
+            int k = (int) i;
+
+            upo_ht_rcu_contains(work->rcu_ht, &k);
+        }
+        /* Values are freed as soon as lookups end, so they are checked
+         * during a traversal */
+        upo_ht_rcu_traverse(work->rcu_ht, check_pair_visit, &counter);
+
+        assert( counter >= work->num_keys );
+
+        /* Keys of the reader are never deleted */
+        for (i = 0; i < work->num_keys; ++i)
+        {
+            assert( upo_ht_rcu_contains(work->rcu_ht, &work->keys[i]) );
+        }
+    }
+
+    return NULL;
+}
+
+void test_create_destroy()
+{
+    upo_ht_striped_t ht;
+
+    ht = upo_ht_striped_create(UPO_HT_STRIPED_DEFAULT_CAPACITY, UPO_HT_STRIPED_DEFAULT_NUM_STRIPES, upo_ht_hash_int_mix, int_compare);
+
+    assert( ht != NULL );
+    assert( upo_ht_striped_capacity(ht) == UPO_HT_STRIPED_DEFAULT_CAPACITY );
+    assert( upo_ht_striped_is_empty(ht) );
+
+    upo_ht_striped_destroy(ht, 0);
+
+    /* Capacity and number of stripes are rounded up to powers of two, and
+     * there is at least one slot per stripe */
+    ht = upo_ht_striped_create(5, 3, upo_ht_hash_int_mix, int_compare);
+
+    assert( ht != NULL );
+    assert( upo_ht_striped_capacity(ht) == 8 );
+
+    upo_ht_striped_destroy(ht, 1);
+}
+
+void test_put_get_contains_delete()
+{
+    int keys[] = {0,1,2,3,4,5,6,7,8,9};
+    int values[] = {0,1,2,3,4,5,6,7,8,9};
+    int values_upd[] = {9,8,7,6,5,4,3,2,1,0};
+    int no_key = 10;
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i;
+    upo_ht_striped_t ht;
+
+    ht = upo_ht_striped_create(16, 4, upo_ht_hash_int_div, int_compare);
+
+    /* Insertion */
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_striped_put(ht, &keys[i], &values[i]) == NULL );
+    }
+
+    assert( upo_ht_striped_size(ht) == n );
+
+    /* Search */
+    for (i = 0; i < n; ++i)
+    {
+        int *value = upo_ht_striped_get(ht, &keys[i]);
+
+        assert( value != NULL );
+        assert( *value == values[i] );
+        assert( upo_ht_striped_contains(ht, &keys[i]) );
+    }
+    assert( upo_ht_striped_get(ht, &no_key) == NULL );
+    assert( !upo_ht_striped_contains(ht, &no_key) );
+
+    /* Update */
+    for (i = 0; i < n; ++i)
+    {
+        int *old_value = upo_ht_striped_put(ht, &keys[i], &values_upd[i]);
+
+        assert( old_value != NULL );
+        assert( *old_value == values[i] );
+    }
+
+    assert( upo_ht_striped_size(ht) == n );
+
+    for (i = 0; i < n; ++i)
+    {
+        int *value = upo_ht_striped_get(ht, &keys[i]);
+
+        assert( value != NULL );
+        assert( *value == values_upd[i] );
+    }
+
+    /* Removal */
+    upo_ht_striped_delete(ht, &no_key, 0);
+
+    assert( upo_ht_striped_size(ht) == n );
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_striped_delete(ht, &keys[i], 0);
+
+        assert( !upo_ht_striped_contains(ht, &keys[i]) );
+        assert( upo_ht_striped_size(ht) == n-i-1 );
+    }
+
+    assert( upo_ht_striped_is_empty(ht) );
+
+    upo_ht_striped_destroy(ht, 0);
+}
+
+void test_insert()
+{
+    int keys[] = {0,16,32,48,64};
+    int values[] = {0,1,2,3,4};
+    int values_upd[] = {9,8,7,6,5};
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i;
+    upo_ht_striped_t ht;
+
+    /* All keys collide in the same slot */
+    ht = upo_ht_striped_create(16, 4, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_striped_insert(ht, &keys[i], &values[i]);
+    }
+    /* Duplicates are ignored */
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_striped_insert(ht, &keys[i], &values_upd[i]);
+    }
+
+    assert( upo_ht_striped_size(ht) == n );
+
+    for (i = 0; i < n; ++i)
+    {
+        int *value = upo_ht_striped_get(ht, &keys[i]);
+
+        assert( value != NULL );
+        assert( *value == values[i] );
+    }
+
+    upo_ht_striped_destroy(ht, 0);
+}
+
+void test_clear()
+{
+    size_t n = 100;
+    size_t i;
+    upo_ht_striped_t ht;
+
+    ht = upo_ht_striped_create(16, 4, upo_ht_hash_int_mix, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        int *key = malloc(sizeof(int));
+        int *value = malloc(sizeof(int));
+
+        if (key == NULL || value == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for key-value pairs");
+        }
+        *key = *value = (int) i;
+        upo_ht_striped_put(ht, key, value);
+    }
+
+    assert( upo_ht_striped_size(ht) == n );
+
+    upo_ht_striped_clear(ht, 1);
+
+    assert( upo_ht_striped_is_empty(ht) );
+
+    upo_ht_striped_destroy(ht, 0);
+}
+
+void test_resize()
+{
+    int keys[1000];
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i;
+    upo_ht_striped_t ht;
+
+    ht = upo_ht_striped_create(4, 4, upo_ht_hash_int_mix, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+        upo_ht_striped_put(ht, &keys[i], &keys[i]);
+
+        assert( upo_ht_striped_size(ht) == i+1 );
+    }
+
+    assert( upo_ht_striped_capacity(ht) > 4 );
+    assert( upo_ht_striped_load_factor(ht) <= UPO_HT_STRIPED_MAX_LOAD_FACTOR );
+
+    for (i = 0; i < n; ++i)
+    {
+        int *value = upo_ht_striped_get(ht, &keys[i]);
+
+        assert( value != NULL );
+        assert( *value == keys[i] );
+    }
+
+    upo_ht_striped_destroy(ht, 0);
+}
+
+void test_traverse()
+{
+    int keys[] = {0,1,2,3,4,5,6,7,8,9};
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t counter = 0;
+    size_t i;
+    upo_ht_striped_t ht;
+
+    ht = upo_ht_striped_create(16, 4, upo_ht_hash_int_mix, int_compare);
+
+    upo_ht_striped_traverse(ht, count_key_visit, &counter);
+
+    assert( counter == 0 );
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_striped_put(ht, &keys[i], &keys[i]);
+    }
+
+    upo_ht_striped_traverse(ht, count_key_visit, &counter);
+
+    assert( counter == n );
+
+    upo_ht_striped_destroy(ht, 0);
+}
+
+void test_concurrent_put_get()
+{
+    int *keys = NULL;
+    size_t n = NUM_THREADS*NUM_KEYS_PER_THREAD;
+    pthread_t threads[NUM_THREADS];
+    thread_work_t works[NUM_THREADS];
+    size_t i;
+    upo_ht_striped_t ht;
+
+    keys = malloc(n*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+
+    /* A small initial capacity forces concurrent resizes */
+    ht = upo_ht_striped_create(8, 8, upo_ht_hash_int_mix, int_compare);
+
+    for (i = 0; i < NUM_THREADS; ++i)
+    {
+        works[i].ht = ht;
+        works[i].keys = keys;
+        works[i].num_keys = n;
+        works[i].id = i;
+        if (pthread_create(&threads[i], NULL, put_get_thread, &works[i]) != 0)
+        {
+            upo_throw_sys_error("Unable to create a thread");
+        }
+    }
+    for (i = 0; i < NUM_THREADS; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    assert( upo_ht_striped_size(ht) == n );
+
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_striped_contains(ht, &keys[i]) );
+    }
+
+    upo_ht_striped_destroy(ht, 0);
+    free(keys);
+}
+
+void test_concurrent_delete()
+{
+    int *keys = NULL;
+    size_t n = NUM_THREADS*NUM_KEYS_PER_THREAD;
+    pthread_t threads[NUM_THREADS];
+    thread_work_t works[NUM_THREADS];
+    size_t i;
+    upo_ht_striped_t ht;
+
+    keys = malloc(n*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+
+    ht = upo_ht_striped_create(UPO_HT_STRIPED_DEFAULT_CAPACITY, UPO_HT_STRIPED_DEFAULT_NUM_STRIPES, upo_ht_hash_int_mix, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+        upo_ht_striped_put(ht, &keys[i], &keys[i]);
+    }
+
+    for (i = 0; i < NUM_THREADS; ++i)
+    {
+        works[i].ht = ht;
+        works[i].keys = keys;
+        works[i].num_keys = n;
+        works[i].id = i;
+        if (pthread_create(&threads[i], NULL, delete_thread, &works[i]) != 0)
+        {
+            upo_throw_sys_error("Unable to create a thread");
+        }
+    }
+    for (i = 0; i < NUM_THREADS; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    assert( upo_ht_striped_size(ht) == n/2 );
+
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_striped_contains(ht, &keys[i]) == (int) (i % 2) );
+    }
+
+    upo_ht_striped_destroy(ht, 0);
+    free(keys);
+}
+
+void test_concurrent_read_write()
+{
+    int *keys = NULL;
+    size_t n = 2*NUM_KEYS_PER_THREAD;
+    pthread_t reader;
+    thread_work_t work;
+    size_t i;
+    upo_ht_striped_t ht;
+
+    keys = malloc(n*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+
+    ht = upo_ht_striped_create(4, 4, upo_ht_hash_int_mix, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+    for (i = 0; i < n/2; ++i)
+    {
+        upo_ht_striped_put(ht, &keys[i], &keys[i]);
+    }
+
+    work.ht = ht;
+    work.keys = keys;
+    work.num_keys = n;
+    work.id = 0;
+    if (pthread_create(&reader, NULL, read_thread, &work) != 0)
+    {
+        upo_throw_sys_error("Unable to create a thread");
+    }
+
+    /* Meanwhile, the second half is repeatedly inserted and deleted, which
+     * also resizes the table */
+    for (i = n/2; i < n; ++i)
+    {
+        upo_ht_striped_put(ht, &keys[i], &keys[i]);
+    }
+    for (i = n/2; i < n; ++i)
+    {
+        upo_ht_striped_delete(ht, &keys[i], 0);
+    }
+
+    pthread_join(reader, NULL);
+
+    assert( upo_ht_striped_size(ht) == n/2 );
+
+    upo_ht_striped_destroy(ht, 0);
+    free(keys);
+}
+
+void test_rcu_put_get_contains_delete()
+{
+    int keys[] = {0,1,2,3,4,5,6,7,8,9};
+    int values[] = {0,1,2,3,4,5,6,7,8,9};
+    int values_upd[] = {9,8,7,6,5,4,3,2,1,0};
+    int no_key = 10;
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i;
+    upo_ht_rcu_t ht;
+
+    ht = upo_ht_rcu_create(16, 4, upo_ht_hash_int_div, int_compare);
+
+    assert( upo_ht_rcu_capacity(ht) == 16 );
+
+    /* Insertion */
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_rcu_put(ht, &keys[i], &values[i]) == NULL );
+    }
+    upo_ht_rcu_insert(ht, &keys[0], &values_upd[0]);
+
+    assert( upo_ht_rcu_size(ht) == n );
+
+    /* Search */
+    for (i = 0; i < n; ++i)
+    {
+        int *value = upo_ht_rcu_get(ht, &keys[i]);
+
+        assert( value != NULL );
+        assert( *value == values[i] );
+        assert( upo_ht_rcu_contains(ht, &keys[i]) );
+    }
+    assert( upo_ht_rcu_get(ht, &no_key) == NULL );
+    assert( !upo_ht_rcu_contains(ht, &no_key) );
+
+    /* Update */
+    for (i = 0; i < n; ++i)
+    {
+        int *old_value = upo_ht_rcu_put(ht, &keys[i], &values_upd[i]);
+        int *value = upo_ht_rcu_get(ht, &keys[i]);
+
+        assert( old_value != NULL );
+        assert( *old_value == values[i] );
+        assert( value != NULL );
+        assert( *value == values_upd[i] );
+    }
+
+    /* Removal */
+    upo_ht_rcu_delete(ht, &no_key, 0);
+
+    assert( upo_ht_rcu_size(ht) == n );
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_rcu_delete(ht, &keys[i], 0);
+
+        assert( !upo_ht_rcu_contains(ht, &keys[i]) );
+        assert( upo_ht_rcu_size(ht) == n-i-1 );
+    }
+
+    assert( upo_ht_rcu_is_empty(ht) );
+
+    upo_ht_rcu_destroy(ht, 0);
+}
+
+void test_rcu_clear()
+{
+    size_t n = 1000;
+    size_t i;
+    upo_ht_rcu_t ht;
+
+    ht = upo_ht_rcu_create(16, 4, upo_ht_hash_int_mix, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        int *key = malloc(sizeof(int));
+        int *value = malloc(sizeof(int));
+
+        if (key == NULL || value == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for key-value pairs");
+        }
+        *key = *value = (int) i;
+        upo_ht_rcu_put(ht, key, value);
+        /* Deletes every other key, so that some nodes are still waiting to
+         * be reclaimed when the table is destroyed */
+        if (i % 2 == 1)
+        {
+            int k = (int) i - 1;
+
+            upo_ht_rcu_delete(ht, &k, 1);
+        }
+    }
+
+    assert( upo_ht_rcu_size(ht) == n/2 );
+
+    upo_ht_rcu_clear(ht, 1);
+
+    assert( upo_ht_rcu_is_empty(ht) );
+
+    upo_ht_rcu_destroy(ht, 0);
+}
+
+void test_rcu_resize()
+{
+    int keys[1000];
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i;
+    upo_ht_rcu_t ht;
+
+    ht = upo_ht_rcu_create(4, 4, upo_ht_hash_int_mix, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+        upo_ht_rcu_put(ht, &keys[i], &keys[i]);
+
+        assert( upo_ht_rcu_size(ht) == i+1 );
+    }
+
+    assert( upo_ht_rcu_capacity(ht) > 4 );
+    assert( upo_ht_rcu_load_factor(ht) <= UPO_HT_RCU_MAX_LOAD_FACTOR );
+
+    for (i = 0; i < n; ++i)
+    {
+        int *value = upo_ht_rcu_get(ht, &keys[i]);
+
+        assert( value != NULL );
+        assert( *value == keys[i] );
+    }
+
+    upo_ht_rcu_destroy(ht, 0);
+}
+
+void test_rcu_traverse()
+{
+    int keys[] = {0,1,2,3,4,5,6,7,8,9};
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t counter = 0;
+    size_t i;
+    upo_ht_rcu_t ht;
+
+    ht = upo_ht_rcu_create(16, 4, upo_ht_hash_int_mix, int_compare);
+
+    upo_ht_rcu_traverse(ht, count_key_visit, &counter);
+
+    assert( counter == 0 );
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_rcu_put(ht, &keys[i], &keys[i]);
+    }
+
+    upo_ht_rcu_traverse(ht, count_key_visit, &counter);
+
+    assert( counter == n );
+
+    upo_ht_rcu_destroy(ht, 0);
+}
+
+void test_rcu_stress()
+{
+    int *keys = NULL;
+    size_t n = NUM_KEYS_PER_THREAD;
+    pthread_t threads[NUM_THREADS];
+    thread_work_t works[NUM_THREADS];
+    size_t i;
+    upo_ht_rcu_t ht;
+
+    keys = malloc(n*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+
+    /* A small initial capacity forces resizes during lookups */
+    ht = upo_ht_rcu_create(8, 8, upo_ht_hash_int_mix, int_compare);
+
+    /* The reader owns the keys after those of the writers */
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) ((NUM_THREADS-1)*NUM_KEYS_PER_THREAD + i);
+        upo_ht_rcu_put(ht, &keys[i], &keys[i]);
+    }
+
+    for (i = 0; i < NUM_THREADS; ++i)
+    {
+        works[i].rcu_ht = ht;
+        works[i].keys = keys;
+        works[i].num_keys = n;
+        works[i].id = i;
+        if (pthread_create(&threads[i], NULL, (i < NUM_THREADS-1) ? rcu_write_thread : rcu_read_thread, &works[i]) != 0)
+        {
+            upo_throw_sys_error("Unable to create a thread");
+        }
+    }
+    for (i = 0; i < NUM_THREADS; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_rcu_contains(ht, &keys[i]) );
+        upo_ht_rcu_delete(ht, &keys[i], 0);
+    }
+
+    /* Keys still stored by the writers are freed with the table */
+    upo_ht_rcu_destroy(ht, 1);
+    free(keys);
+}
+
+void test_null()
+{
+    upo_ht_striped_t ht = NULL;
+    upo_ht_rcu_t rcu_ht = NULL;
+
+    assert( upo_ht_striped_size(ht) == 0 );
+
+    assert( upo_ht_striped_is_empty(ht) );
+
+    assert( upo_ht_striped_capacity(ht) == 0 );
+
+    upo_ht_striped_clear(ht, 0);
+
+    upo_ht_striped_destroy(ht, 0);
+
+    assert( upo_ht_rcu_size(rcu_ht) == 0 );
+
+    assert( upo_ht_rcu_is_empty(rcu_ht) );
+
+    assert( upo_ht_rcu_capacity(rcu_ht) == 0 );
+
+    assert( upo_ht_rcu_get(rcu_ht, NULL) == NULL );
+
+    upo_ht_rcu_clear(rcu_ht, 0);
+
+    upo_ht_rcu_destroy(rcu_ht, 0);
+}
+
+
+int main()
+{
+    printf("Test case 'create/destroy'... ");
+    fflush(stdout);
+    test_create_destroy();
+    printf("OK\n");
+
+    printf("Test case 'put/get/contains/delete'... ");
+    fflush(stdout);
+    test_put_get_contains_delete();
+    printf("OK\n");
+
+    printf("Test case 'insert'... ");
+    fflush(stdout);
+    test_insert();
+    printf("OK\n");
+
+    printf("Test case 'clear'... ");
+    fflush(stdout);
+    test_clear();
+    printf("OK\n");
+
+    printf("Test case 'resize'... ");
+    fflush(stdout);
+    test_resize();
+    printf("OK\n");
+
+    printf("Test case 'traverse'... ");
+    fflush(stdout);
+    test_traverse();
+    printf("OK\n");
+
+    printf("Test case 'concurrent put/get'... ");
+    fflush(stdout);
+    test_concurrent_put_get();
+    printf("OK\n");
+
+    printf("Test case 'concurrent delete'... ");
+    fflush(stdout);
+    test_concurrent_delete();
+    printf("OK\n");
+
+    printf("Test case 'concurrent read/write'... ");
+    fflush(stdout);
+    test_concurrent_read_write();
+    printf("OK\n");
+
+    printf("Test case 'rcu put/get/contains/delete'... ");
+    fflush(stdout);
+    test_rcu_put_get_contains_delete();
+    printf("OK\n");
+
+    printf("Test case 'rcu clear'... ");
+    fflush(stdout);
+    test_rcu_clear();
+    printf("OK\n");
+
+    printf("Test case 'rcu resize'... ");
+    fflush(stdout);
+    test_rcu_resize();
+    printf("OK\n");
+
+    printf("Test case 'rcu traverse'... ");
+    fflush(stdout);
+    test_rcu_traverse();
+    printf("OK\n");
+
+    printf("Test case 'rcu stress'... ");
+    fflush(stdout);
+    test_rcu_stress();
+    printf("OK\n");
+
+    printf("Test case 'null'... ");
+    fflush(stdout);
+    test_null();
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,485 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+
+
+static int int_compare(const void *a, const void *b);
+static int str_compare(const void *a, const void *b);
+static uint64_t same_hash(const void *key);
+static void count_pair_visit(void *key, void *value, void *info);
+
+static void test_create_destroy();
+static void test_put_get();
+static void test_insert();
+static void test_delete();
+static void test_str();
+static void test_many();
+static void test_collisions();
+static void test_flooding();
+static void test_traverse();
+static void test_destroy_data();
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+int str_compare(const void *a, const void *b)
+{
+    const char **aa = (const char**) a;
+    const char **bb = (const char**) b;
+
+    return strcmp(*aa, *bb);
+}
+
+uint64_t same_hash(const void *key)
+{
+    (void) key;
+
+    return 42;
+}
+
+void count_pair_visit(void *key, void *value, void *info)
+{
+    size_t *counter = info;
+
+    assert( key != NULL );
+    assert( value != NULL );
+    /* Values are stored as the key times two */
+    assert( *(int*) value == 2 * *(int*) key );
+
+    *counter += 1;
+}
+
+void test_create_destroy()
+{
+    upo_ht_cuckoo_t ht = upo_ht_cuckoo_create(UPO_HT_CUCKOO_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+    int key = 1;
+
+    assert( ht != NULL );
+    assert( upo_ht_cuckoo_is_empty(ht) );
+    assert( upo_ht_cuckoo_size(ht) == 0 );
+    assert( upo_ht_cuckoo_capacity(ht) >= UPO_HT_CUCKOO_DEFAULT_CAPACITY );
+    assert( upo_ht_cuckoo_capacity(ht) % UPO_HT_CUCKOO_BUCKET_SIZE == 0 );
+    assert( upo_ht_cuckoo_stash_size(ht) == 0 );
+    assert( upo_ht_cuckoo_get(ht, &key) == NULL );
+    assert( !upo_ht_cuckoo_contains(ht, &key) );
+    upo_ht_cuckoo_destroy(ht, 0);
+
+    /* Tiny capacities are rounded up to one bucket */
+    ht = upo_ht_cuckoo_create(0, upo_ht_hash_int_div, int_compare);
+    assert( upo_ht_cuckoo_capacity(ht) == UPO_HT_CUCKOO_BUCKET_SIZE );
+    upo_ht_cuckoo_destroy(ht, 0);
+
+    /* NULL tables */
+    assert( upo_ht_cuckoo_size(NULL) == 0 );
+    assert( upo_ht_cuckoo_is_empty(NULL) );
+    assert( upo_ht_cuckoo_get(NULL, &key) == NULL );
+    assert( !upo_ht_cuckoo_contains(NULL, &key) );
+    upo_ht_cuckoo_destroy(NULL, 0);
+}
+
+void test_put_get()
+{
+    int keys[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    int values[] = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18};
+    int other = 100;
+    size_t n = sizeof keys/sizeof keys[0];
+    upo_ht_cuckoo_t ht = upo_ht_cuckoo_create(UPO_HT_CUCKOO_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+    size_t i;
+
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_cuckoo_put(ht, &keys[i], &values[i]) == NULL );
+    }
+    assert( upo_ht_cuckoo_size(ht) == n );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_cuckoo_get(ht, &keys[i]) == &values[i] );
+        assert( upo_ht_cuckoo_contains(ht, &keys[i]) );
+    }
+    assert( upo_ht_cuckoo_get(ht, &other) == NULL );
+
+    /* Putting an existing key replaces its value and returns the old one */
+    assert( upo_ht_cuckoo_put(ht, &keys[3], &other) == &values[3] );
+    assert( upo_ht_cuckoo_get(ht, &keys[3]) == &other );
+    assert( upo_ht_cuckoo_size(ht) == n );
+
+    upo_ht_cuckoo_destroy(ht, 0);
+}
+
+void test_insert()
+{
+    int key = 1;
+    int value1 = 2;
+    int value2 = 3;
+    upo_ht_cuckoo_t ht = upo_ht_cuckoo_create(UPO_HT_CUCKOO_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    upo_ht_cuckoo_insert(ht, &key, &value1);
+    /* Inserting an existing key does not replace its value */
+    upo_ht_cuckoo_insert(ht, &key, &value2);
+    assert( upo_ht_cuckoo_get(ht, &key) == &value1 );
+    assert( upo_ht_cuckoo_size(ht) == 1 );
+
+    upo_ht_cuckoo_destroy(ht, 0);
+}
+
+void test_delete()
+{
+    int keys[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    int values[] = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18};
+    size_t n = sizeof keys/sizeof keys[0];
+    upo_ht_cuckoo_t ht = upo_ht_cuckoo_create(UPO_HT_CUCKOO_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+    size_t i;
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_cuckoo_put(ht, &keys[i], &values[i]);
+    }
+    for (i = 0; i < n; i += 2)
+    {
+        upo_ht_cuckoo_delete(ht, &keys[i], 0);
+    }
+    /* Deleting a missing key does nothing */
+    upo_ht_cuckoo_delete(ht, &keys[0], 0);
+    assert( upo_ht_cuckoo_size(ht) == n/2 );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_cuckoo_contains(ht, &keys[i]) == (i % 2 != 0) );
+    }
+
+    upo_ht_cuckoo_clear(ht, 0);
+    assert( upo_ht_cuckoo_is_empty(ht) );
+    for (i = 0; i < n; ++i)
+    {
+        assert( !upo_ht_cuckoo_contains(ht, &keys[i]) );
+    }
+
+    upo_ht_cuckoo_destroy(ht, 0);
+}
+
+void test_str()
+{
+    char *keys[] = {"apple", "banana", "cherry", "", "durian"};
+    char *values[] = {"red", "yellow", "dark red", "empty", "green"};
+    size_t n = sizeof keys/sizeof keys[0];
+    upo_ht_cuckoo_t ht = upo_ht_cuckoo_create(UPO_HT_CUCKOO_DEFAULT_CAPACITY, upo_ht_hash_str_djb2, str_compare);
+    char buf[16];
+    char *copy = buf;
+    size_t i;
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_cuckoo_put(ht, &keys[i], &values[i]);
+    }
+    for (i = 0; i < n; ++i)
+    {
+        /* Look up a copy, to be sure keys are compared by content */
+        strcpy(buf, keys[i]);
+        assert( upo_ht_cuckoo_get(ht, &copy) == &values[i] );
+    }
+
+    upo_ht_cuckoo_destroy(ht, 0);
+}
+
+void test_many()
+{
+    size_t n = 100000;
+    int *keys = NULL;
+    int *values = NULL;
+    upo_ht_cuckoo_t ht = NULL;
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    values = malloc(n*sizeof(int));
+    if (keys == NULL || values == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys and values");
+    }
+
+    /* Start small, so that the table has to grow many times */
+    ht = upo_ht_cuckoo_create(4, upo_ht_hash_int_div, int_compare);
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) (i * 7919);
+        values[i] = 2*keys[i];
+        upo_ht_cuckoo_put(ht, &keys[i], &values[i]);
+    }
+    assert( upo_ht_cuckoo_size(ht) == n );
+    assert( upo_ht_cuckoo_capacity(ht) >= n );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_cuckoo_get(ht, &keys[i]) == &values[i] );
+    }
+
+    for (i = 0; i < n; i += 3)
+    {
+        upo_ht_cuckoo_delete(ht, &keys[i], 0);
+    }
+    assert( upo_ht_cuckoo_size(ht) == n - (n + 2)/3 );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_cuckoo_contains(ht, &keys[i]) == (i % 3 != 0) );
+    }
+
+    upo_ht_cuckoo_destroy(ht, 0);
+    free(values);
+    free(keys);
+}
+
+void test_collisions()
+{
+    int keys[UPO_HT_CUCKOO_BUCKET_SIZE*4];
+    int values[UPO_HT_CUCKOO_BUCKET_SIZE*4];
+    size_t n = sizeof keys/sizeof keys[0];
+    upo_ht_cuckoo_t ht = upo_ht_cuckoo_create(UPO_HT_CUCKOO_DEFAULT_CAPACITY, same_hash, int_compare);
+    size_t capacity = upo_ht_cuckoo_capacity(ht);
+    size_t i;
+
+    /* All keys share both buckets: once they are full, keys go to the stash,
+     * and once the stash is full, growing the table does not help either */
+    for (i = 0; i < 2*UPO_HT_CUCKOO_BUCKET_SIZE + UPO_HT_CUCKOO_STASH_SIZE; ++i)
+    {
+        keys[i] = (int) i;
+        values[i] = 2*keys[i];
+        upo_ht_cuckoo_put(ht, &keys[i], &values[i]);
+    }
+    assert( upo_ht_cuckoo_stash_size(ht) == UPO_HT_CUCKOO_STASH_SIZE );
+    assert( upo_ht_cuckoo_capacity(ht) == capacity );
+    for (i = 0; i < 2*UPO_HT_CUCKOO_BUCKET_SIZE + UPO_HT_CUCKOO_STASH_SIZE; ++i)
+    {
+        assert( upo_ht_cuckoo_get(ht, &keys[i]) == &values[i] );
+    }
+
+    /* Deleting a key from a bucket moves a key from the stash */
+    upo_ht_cuckoo_delete(ht, &keys[0], 0);
+    assert( upo_ht_cuckoo_stash_size(ht) == UPO_HT_CUCKOO_STASH_SIZE - 1 );
+    /* Deleting a key from the stash keeps the others */
+    upo_ht_cuckoo_delete(ht, &keys[2*UPO_HT_CUCKOO_BUCKET_SIZE + 1], 0);
+    assert( upo_ht_cuckoo_stash_size(ht) == UPO_HT_CUCKOO_STASH_SIZE - 2 );
+    for (i = 1; i < 2*UPO_HT_CUCKOO_BUCKET_SIZE + UPO_HT_CUCKOO_STASH_SIZE; ++i)
+    {
+        assert( upo_ht_cuckoo_contains(ht, &keys[i]) == (i != 2*UPO_HT_CUCKOO_BUCKET_SIZE + 1) );
+    }
+    assert( upo_ht_cuckoo_size(ht) == 2*UPO_HT_CUCKOO_BUCKET_SIZE + UPO_HT_CUCKOO_STASH_SIZE - 2 );
+
+    upo_ht_cuckoo_destroy(ht, 0);
+
+    /* With the identity hash, keys that are equal modulo the number of
+     * buckets share the first bucket, so they must be moved to make room */
+    ht = upo_ht_cuckoo_create(16*UPO_HT_CUCKOO_BUCKET_SIZE, upo_ht_hash_int_div, int_compare);
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) (i * 16);
+        values[i] = 2*keys[i];
+        upo_ht_cuckoo_put(ht, &keys[i], &values[i]);
+    }
+    assert( upo_ht_cuckoo_size(ht) == n );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_cuckoo_get(ht, &keys[i]) == &values[i] );
+    }
+
+    upo_ht_cuckoo_destroy(ht, 0);
+}
+
+void test_flooding()
+{
+    size_t n = 1000;
+    int *keys = NULL;
+    int *values = NULL;
+    upo_ht_cuckoo_t ht = NULL;
+    size_t counter = 0;
+    size_t capacity = 0;
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    values = malloc(n*sizeof(int));
+    if (keys == NULL || values == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys and values");
+    }
+
+    /* With a constant hash, resizing never helps: the table must stop
+     * growing and keep the extra keys in the overflow area, while only the
+     * two candidate buckets hold keys */
+    ht = upo_ht_cuckoo_create(UPO_HT_CUCKOO_BUCKET_SIZE, same_hash, int_compare);
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+        values[i] = 2*keys[i];
+        assert( upo_ht_cuckoo_put(ht, &keys[i], &values[i]) == NULL );
+    }
+    capacity = upo_ht_cuckoo_capacity(ht);
+    assert( upo_ht_cuckoo_size(ht) == n );
+    assert( 4*capacity < n );
+    assert( upo_ht_cuckoo_stash_size(ht) == n - 2*UPO_HT_CUCKOO_BUCKET_SIZE );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_cuckoo_get(ht, &keys[i]) == &values[i] );
+        upo_ht_cuckoo_insert(ht, &keys[i], &values[0]);
+    }
+    assert( upo_ht_cuckoo_size(ht) == n );
+    upo_ht_cuckoo_traverse(ht, count_pair_visit, &counter);
+    assert( counter == n );
+
+    for (i = 0; i < n; i += 2)
+    {
+        upo_ht_cuckoo_delete(ht, &keys[i], 0);
+    }
+    assert( upo_ht_cuckoo_size(ht) == n/2 );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_cuckoo_contains(ht, &keys[i]) == (i % 2 == 1) );
+    }
+    /* Further collisions still do not grow the table */
+    for (i = 0; i < n; i += 2)
+    {
+        upo_ht_cuckoo_put(ht, &keys[i], &values[i]);
+    }
+    assert( upo_ht_cuckoo_size(ht) == n );
+    assert( upo_ht_cuckoo_capacity(ht) == capacity );
+
+    upo_ht_cuckoo_destroy(ht, 0);
+    free(values);
+    free(keys);
+}
+
+void test_traverse()
+{
+    int keys[100];
+    int values[100];
+    size_t n = sizeof keys/sizeof keys[0];
+    upo_ht_cuckoo_t ht = upo_ht_cuckoo_create(8, upo_ht_hash_int_div, int_compare);
+    size_t counter = 0;
+    size_t i;
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) (i * 32);
+        values[i] = 2*keys[i];
+        upo_ht_cuckoo_put(ht, &keys[i], &values[i]);
+    }
+
+    upo_ht_cuckoo_traverse(ht, count_pair_visit, &counter);
+    assert( counter == n );
+
+    upo_ht_cuckoo_destroy(ht, 0);
+}
+
+void test_destroy_data()
+{
+    upo_ht_cuckoo_t ht = upo_ht_cuckoo_create(4, upo_ht_hash_int_div, int_compare);
+    size_t n = 100;
+    size_t i;
+
+    for (i = 0; i < n; ++i)
+    {
+        int *key = malloc(sizeof(int));
+        int *value = malloc(sizeof(int));
+
+        if (key == NULL || value == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for key and value");
+        }
+        *key = (int) i;
+        *value = 2*(*key);
+        upo_ht_cuckoo_put(ht, key, value);
+    }
+    for (i = 0; i < n; i += 2)
+    {
+        int key = (int) i;
+
+        upo_ht_cuckoo_delete(ht, &key, 1);
+    }
+    assert( upo_ht_cuckoo_size(ht) == n/2 );
+
+    /* Remaining keys and values are freed by the hash table */
+    upo_ht_cuckoo_destroy(ht, 1);
+}
+
+
+int main()
+{
+    printf("Test case 'create/destroy'... ");
+    fflush(stdout);
+    test_create_destroy();
+    printf("OK\n");
+
+    printf("Test case 'put/get'... ");
+    fflush(stdout);
+    test_put_get();
+    printf("OK\n");
+
+    printf("Test case 'insert'... ");
+    fflush(stdout);
+    test_insert();
+    printf("OK\n");
+
+    printf("Test case 'delete'... ");
+    fflush(stdout);
+    test_delete();
+    printf("OK\n");
+
+    printf("Test case 'str'... ");
+    fflush(stdout);
+    test_str();
+    printf("OK\n");
+
+    printf("Test case 'many'... ");
+    fflush(stdout);
+    test_many();
+    printf("OK\n");
+
+    printf("Test case 'collisions'... ");
+    fflush(stdout);
+    test_collisions();
+    printf("OK\n");
+
+    printf("Test case 'flooding'... ");
+    fflush(stdout);
+    test_flooding();
+    printf("OK\n");
+
+    printf("Test case 'traverse'... ");
+    fflush(stdout);
+    test_traverse();
+    printf("OK\n");
+
+    printf("Test case 'destroy data'... ");
+    fflush(stdout);
+    test_destroy_data();
+    printf("OK\n");
+
+    return 0;
+}
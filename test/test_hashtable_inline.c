@@ -0,0 +1,383 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+
+
+/** \brief A 12-byte key, hashed and compared by its bytes. */
+typedef struct
+{
+    int32_t x;
+    int32_t y;
+    int32_t z;
+} point_t;
+
+
+static int int_compare(const void *a, const void *b);
+static void sum_pair_visit(void *key, void *value, void *info);
+
+static void test_create_destroy();
+static void test_int();
+static void test_alignment();
+static void test_struct_keys();
+static void test_set();
+static void test_collisions();
+static void test_grow_shrink();
+static void test_traverse();
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void sum_pair_visit(void *key, void *value, void *info)
+{
+    long *sum = info;
+
+    /* Values are stored as the key times two */
+    assert( *(int*) value == 2 * *(int*) key );
+
+    *sum += *(int*) key;
+}
+
+void test_create_destroy()
+{
+    upo_ht_inline_t ht = upo_ht_inline_create(UPO_HT_INLINE_DEFAULT_CAPACITY, sizeof(int), sizeof(int), NULL, NULL);
+    int key = 1;
+
+    assert( ht != NULL );
+    assert( upo_ht_inline_is_empty(ht) );
+    assert( upo_ht_inline_size(ht) == 0 );
+    assert( upo_ht_inline_capacity(ht) >= UPO_HT_INLINE_DEFAULT_CAPACITY );
+    assert( upo_ht_inline_get(ht, &key) == NULL );
+    assert( !upo_ht_inline_contains(ht, &key) );
+    /* No pointers are stored: an int-to-int pair takes 8 bytes plus a
+     * control byte */
+    assert( upo_ht_inline_memory_usage(ht) == upo_ht_inline_capacity(ht)*(2*sizeof(int) + 1) );
+    upo_ht_inline_destroy(ht);
+
+    /* NULL tables */
+    assert( upo_ht_inline_size(NULL) == 0 );
+    assert( upo_ht_inline_is_empty(NULL) );
+    assert( upo_ht_inline_get(NULL, &key) == NULL );
+    assert( !upo_ht_inline_contains(NULL, &key) );
+    assert( upo_ht_inline_memory_usage(NULL) == 0 );
+    upo_ht_inline_destroy(NULL);
+}
+
+void test_int()
+{
+    upo_ht_inline_t ht = upo_ht_inline_create(UPO_HT_INLINE_DEFAULT_CAPACITY, sizeof(int), sizeof(int), NULL, NULL);
+    int n = 100;
+    int key;
+    int value;
+
+    for (key = 0; key < n; ++key)
+    {
+        /* The table keeps copies: the caller's variables can be reused */
+        value = 2*key;
+        assert( upo_ht_inline_put(ht, &key, &value) == 0 );
+    }
+    assert( upo_ht_inline_size(ht) == (size_t) n );
+    for (key = 0; key < n; ++key)
+    {
+        int *stored = upo_ht_inline_get(ht, &key);
+
+        assert( stored != NULL );
+        assert( *stored == 2*key );
+        assert( upo_ht_inline_contains(ht, &key) );
+    }
+    key = n;
+    assert( upo_ht_inline_get(ht, &key) == NULL );
+
+    /* Putting an existing key replaces its value */
+    key = 7;
+    value = -1;
+    assert( upo_ht_inline_put(ht, &key, &value) == 1 );
+    assert( *(int*) upo_ht_inline_get(ht, &key) == -1 );
+    /* Inserting an existing key does not */
+    value = -2;
+    upo_ht_inline_insert(ht, &key, &value);
+    assert( *(int*) upo_ht_inline_get(ht, &key) == -1 );
+    assert( upo_ht_inline_size(ht) == (size_t) n );
+
+    /* Values can be updated in place */
+    *(int*) upo_ht_inline_get(ht, &key) = 14;
+    assert( *(int*) upo_ht_inline_get(ht, &key) == 14 );
+
+    for (key = 0; key < n; key += 2)
+    {
+        upo_ht_inline_delete(ht, &key);
+    }
+    upo_ht_inline_delete(ht, &key);
+    assert( upo_ht_inline_size(ht) == (size_t) n/2 );
+    for (key = 0; key < n; ++key)
+    {
+        assert( upo_ht_inline_contains(ht, &key) == (key % 2 != 0) );
+    }
+
+    upo_ht_inline_clear(ht);
+    assert( upo_ht_inline_is_empty(ht) );
+    key = 1;
+    assert( !upo_ht_inline_contains(ht, &key) );
+
+    upo_ht_inline_destroy(ht);
+}
+
+void test_alignment()
+{
+    upo_ht_inline_t ht = upo_ht_inline_create(8, sizeof(int), sizeof(double), NULL, NULL);
+    int key;
+
+    for (key = 0; key < 100; ++key)
+    {
+        double value = key/2.0;
+
+        upo_ht_inline_put(ht, &key, &value);
+    }
+    for (key = 0; key < 100; ++key)
+    {
+        double *value = upo_ht_inline_get(ht, &key);
+
+        assert( (uintptr_t) value % alignof(double) == 0 );
+        assert( *value == key/2.0 );
+    }
+
+    upo_ht_inline_destroy(ht);
+}
+
+void test_struct_keys()
+{
+    upo_ht_inline_t ht = upo_ht_inline_create(UPO_HT_INLINE_DEFAULT_CAPACITY, sizeof(point_t), sizeof(int), NULL, NULL);
+    upo_ht_inline_t ht16 = upo_ht_inline_create(UPO_HT_INLINE_DEFAULT_CAPACITY, 2*sizeof(uint64_t), 2*sizeof(uint64_t), NULL, NULL);
+    point_t p;
+    uint64_t k[2];
+    int i;
+
+    for (i = 0; i < 1000; ++i)
+    {
+        p.x = i;
+        p.y = -i;
+        p.z = i % 7;
+        upo_ht_inline_put(ht, &p, &i);
+
+        k[0] = (uint64_t) i;
+        k[1] = ~(uint64_t) i;
+        upo_ht_inline_put(ht16, k, k);
+    }
+    for (i = 0; i < 1000; ++i)
+    {
+        uint64_t *v = NULL;
+
+        p.x = i;
+        p.y = -i;
+        p.z = i % 7;
+        assert( *(int*) upo_ht_inline_get(ht, &p) == i );
+        p.z += 1;
+        assert( !upo_ht_inline_contains(ht, &p) );
+
+        k[0] = (uint64_t) i;
+        k[1] = ~(uint64_t) i;
+        v = upo_ht_inline_get(ht16, k);
+        assert( v[0] == k[0] && v[1] == k[1] );
+        k[1] = 0;
+        assert( !upo_ht_inline_contains(ht16, k) );
+    }
+
+    upo_ht_inline_destroy(ht16);
+    upo_ht_inline_destroy(ht);
+}
+
+void test_set()
+{
+    upo_ht_inline_t ht = upo_ht_inline_create(UPO_HT_INLINE_DEFAULT_CAPACITY, sizeof(int64_t), 0, NULL, NULL);
+    int64_t key;
+
+    assert( upo_ht_inline_memory_usage(ht) == upo_ht_inline_capacity(ht)*(sizeof(int64_t) + 1) );
+    for (key = 0; key < 100; key += 3)
+    {
+        upo_ht_inline_put(ht, &key, NULL);
+    }
+    for (key = 0; key < 100; ++key)
+    {
+        assert( upo_ht_inline_contains(ht, &key) == (key % 3 == 0) );
+    }
+
+    upo_ht_inline_destroy(ht);
+}
+
+void test_collisions()
+{
+    /* With the identity hash, keys that are equal modulo the capacity share
+     * their home slot: deletions must shift back the rest of the cluster */
+    upo_ht_inline_t ht = upo_ht_inline_create(64, sizeof(int), sizeof(int), upo_ht_hash_int_div, int_compare);
+    char present[320];
+    int key;
+    int i;
+
+    memset(present, 0, sizeof present);
+    srand(42);
+    for (i = 0; i < 20000; ++i)
+    {
+        /* Keys are multiples of 64 or close to them, to form long clusters
+         * which wrap around the end of the slot array */
+        key = 64*(rand() % 4) + (rand() % 8) - 4 + 64;
+
+        if (rand() % 2)
+        {
+            upo_ht_inline_put(ht, &key, &key);
+            present[key] = 1;
+        }
+        else
+        {
+            upo_ht_inline_delete(ht, &key);
+            present[key] = 0;
+        }
+
+        if (i % 100 == 0)
+        {
+            size_t size = 0;
+            int k;
+
+            for (k = 0; k < 320; ++k)
+            {
+                int *value = upo_ht_inline_get(ht, &k);
+
+                assert( (value != NULL) == present[k] );
+                assert( value == NULL || *value == k );
+                size += present[k];
+            }
+            assert( upo_ht_inline_size(ht) == size );
+        }
+    }
+
+    upo_ht_inline_destroy(ht);
+}
+
+void test_grow_shrink()
+{
+    upo_ht_inline_t ht = upo_ht_inline_create(8, sizeof(int), sizeof(int), NULL, NULL);
+    int n = 100000;
+    int key;
+
+    for (key = 0; key < n; ++key)
+    {
+        int value = 2*key;
+
+        upo_ht_inline_put(ht, &key, &value);
+    }
+    assert( upo_ht_inline_size(ht) == (size_t) n );
+    assert( upo_ht_inline_load_factor(ht) <= UPO_HT_INLINE_MAX_LOAD_FACTOR );
+    for (key = 0; key < n; ++key)
+    {
+        assert( *(int*) upo_ht_inline_get(ht, &key) == 2*key );
+    }
+
+    for (key = 0; key < n - 10; ++key)
+    {
+        upo_ht_inline_delete(ht, &key);
+    }
+    assert( upo_ht_inline_size(ht) == 10 );
+    assert( upo_ht_inline_capacity(ht) < (size_t) n );
+    for (key = n - 10; key < n; ++key)
+    {
+        assert( *(int*) upo_ht_inline_get(ht, &key) == 2*key );
+    }
+
+    upo_ht_inline_destroy(ht);
+}
+
+void test_traverse()
+{
+    upo_ht_inline_t ht = upo_ht_inline_create(8, sizeof(int), sizeof(int), NULL, NULL);
+    long sum = 0;
+    int key;
+
+    for (key = 1; key <= 100; ++key)
+    {
+        int value = 2*key;
+
+        upo_ht_inline_put(ht, &key, &value);
+    }
+
+    upo_ht_inline_traverse(ht, sum_pair_visit, &sum);
+    assert( sum == 100*101/2 );
+
+    upo_ht_inline_destroy(ht);
+}
+
+
+int main()
+{
+    printf("Test case 'create/destroy'... ");
+    fflush(stdout);
+    test_create_destroy();
+    printf("OK\n");
+
+    printf("Test case 'int'... ");
+    fflush(stdout);
+    test_int();
+    printf("OK\n");
+
+    printf("Test case 'alignment'... ");
+    fflush(stdout);
+    test_alignment();
+    printf("OK\n");
+
+    printf("Test case 'struct keys'... ");
+    fflush(stdout);
+    test_struct_keys();
+    printf("OK\n");
+
+    printf("Test case 'set'... ");
+    fflush(stdout);
+    test_set();
+    printf("OK\n");
+
+    printf("Test case 'collisions'... ");
+    fflush(stdout);
+    test_collisions();
+    printf("OK\n");
+
+    printf("Test case 'grow/shrink'... ");
+    fflush(stdout);
+    test_grow_shrink();
+    printf("OK\n");
+
+    printf("Test case 'traverse'... ");
+    fflush(stdout);
+    test_traverse();
+    printf("OK\n");
+
+    return 0;
+}
@@ -36,9 +36,13 @@ static int int_compare(const void *a, const void *b);
 static void int_key_value_print(void *key, void *value, void *info);
 #endif // UPO_DEBUG
 static void count_key_visit(void *key, void *value, void *info);
+static void check_pair_visit(void *key, void *value, void *info);
 
 static void test_keys();
 static void test_traverse();
+static void test_iterator();
+static void test_stats();
+static void test_build();
 
 
 int int_compare(const void *a, const void *b)
@@ -91,6 +95,19 @@ void count_key_visit(void *key, void *value, void *info)
     }
 }
 
+void check_pair_visit(void *key, void *value, void *info)
+{
+    size_t *counter = info;
+
+    assert( info != NULL );
+    assert( key != NULL );
+    assert( value != NULL );
+    /* Values are stored as the key plus one */
+    assert( *(int*) value == *(int*) key + 1 );
+
+    *counter += 1;
+}
+
 void test_keys()
 {
     int keys1[] = {0,1,2,3,4,5,6,7,8,9};
@@ -372,6 +389,291 @@ void test_traverse()
     upo_ht_linprob_destroy(ht, 0);
 }
 
+void test_iterator()
+{
+    int keys[] = {0,10,20,30,40,1,2,3,4,5,11,12,13,14};
+    int values[] = {1,11,21,31,41,2,3,4,5,6,12,13,14,15};
+    void *exported[sizeof keys/sizeof keys[0]];
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i;
+    size_t j;
+    size_t count = 0;
+    size_t key_counter = 0;
+    upo_ht_linprob_t ht;
+    upo_ht_linprob_iter_t it;
+    void *key = NULL;
+    void *value = NULL;
+
+    /* HT: NULL and empty hash table */
+
+    upo_ht_linprob_iter_begin(NULL, &it);
+    assert( !upo_ht_linprob_iter_next(&it, &key, &value) );
+    assert( upo_ht_linprob_keys_into(NULL, exported, n) == 0 );
+
+    ht = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+
+    assert( ht != NULL );
+
+    upo_ht_linprob_iter_begin(ht, &it);
+    assert( !upo_ht_linprob_iter_next(&it, &key, &value) );
+    assert( key == NULL && value == NULL );
+    assert( !upo_ht_linprob_iter_next(&it, &key, &value) );
+    assert( upo_ht_linprob_keys_into(ht, exported, n) == 0 );
+
+    /* HT: collisions and holes */
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_linprob_put(ht, &keys[i], &values[i]);
+    }
+    /* Leave some deleted slots behind */
+    upo_ht_linprob_delete(ht, &keys[2], 0);
+    upo_ht_linprob_delete(ht, &keys[7], 0);
+    upo_ht_linprob_put(ht, &keys[2], &values[2]);
+
+    count = 0;
+    upo_ht_linprob_iter_begin(ht, &it);
+    while (upo_ht_linprob_iter_next(&it, &key, &value))
+    {
+        assert( key != NULL && value != NULL );
+        assert( *(int*) value == *(int*) key + 1 );
+        assert( *(int*) key != keys[7] );
+        assert( upo_ht_linprob_iter_hash(&it) == upo_ht_hash_int_div(key) );
+        ++count;
+    }
+    assert( count == n-1 );
+    /* An exhausted iterator stays exhausted */
+    assert( !upo_ht_linprob_iter_next(&it, NULL, NULL) );
+
+    /* Keys and values can be skipped */
+    count = 0;
+    upo_ht_linprob_iter_begin(ht, &it);
+    while (upo_ht_linprob_iter_next(&it, NULL, NULL))
+    {
+        ++count;
+    }
+    assert( count == n-1 );
+
+    /* Traversal passes keys and values in this order */
+    key_counter = 0;
+    upo_ht_linprob_traverse(ht, check_pair_visit, &key_counter);
+    assert( key_counter == n-1 );
+
+    /* Export of all keys: each key is exported once */
+    count = upo_ht_linprob_keys_into(ht, exported, n);
+    assert( count == n-1 );
+    for (i = 0; i < n; ++i)
+    {
+        size_t found = 0;
+
+        for (j = 0; j < count; ++j)
+        {
+            if (*(int*) exported[j] == keys[i])
+            {
+                ++found;
+            }
+        }
+        assert( found == ((i == 7) ? 0 : 1) );
+    }
+
+    /* Export truncated to the size of the array */
+    assert( upo_ht_linprob_keys_into(ht, exported, 3) == 3 );
+    assert( upo_ht_linprob_keys_into(ht, NULL, 0) == 0 );
+
+    upo_ht_linprob_destroy(ht, 0);
+}
+
+void test_stats()
+{
+    int keys[] = {0,16,32,1,5};
+    int wrap_keys[] = {15,31,47};
+    int more_keys[] = {100,101,102,103,104};
+    int missing = 48;
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i;
+    upo_ht_linprob_t ht;
+    upo_ht_stats_t stats;
+
+    /* HT: NULL and empty hash table */
+
+    upo_ht_linprob_stats(NULL, &stats);
+    assert( stats.size == 0 );
+    assert( stats.capacity == 0 );
+
+    ht = upo_ht_linprob_create(16, upo_ht_hash_int_div, int_compare);
+
+    assert( ht != NULL );
+
+    upo_ht_linprob_stats(ht, &stats);
+    assert( stats.size == 0 );
+    assert( stats.capacity == 16 );
+    assert( stats.max_probe_length == 0 );
+    assert( stats.max_chain_length == 0 );
+
+    /* HT: a cluster of four slots (0-3) and one of one slot (5) */
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_linprob_put(ht, &keys[i], &keys[i]);
+    }
+
+    upo_ht_linprob_stats(ht, &stats);
+    assert( stats.size == n );
+    assert( stats.max_probe_length == 3 );
+    assert( stats.mean_probe_length == 2 );
+    assert( stats.p50_probe_length == 2 );
+    assert( stats.p90_probe_length == 3 );
+    assert( stats.probe_histogram[1] == 2 );
+    assert( stats.probe_histogram[2] == 1 );
+    assert( stats.probe_histogram[3] == 2 );
+    assert( stats.max_chain_length == 4 );
+    assert( stats.chain_histogram[4] == 1 );
+    assert( stats.chain_histogram[1] == 1 );
+    assert( stats.num_tombstones == 0 );
+    assert( stats.num_resizes == 0 );
+
+    /* Deleted slots still belong to their cluster */
+    upo_ht_linprob_delete(ht, &keys[2], 0);
+
+    upo_ht_linprob_stats(ht, &stats);
+    assert( stats.size == n-1 );
+    assert( stats.num_tombstones == 1 );
+    assert( stats.max_chain_length == 4 );
+
+#ifdef UPO_HT_STATS
+    upo_ht_linprob_reset_stats(ht);
+    /* The key 1 is two slots after its home slot; 48 stops at slot 4 */
+    upo_ht_linprob_get(ht, &keys[3]);
+    upo_ht_linprob_contains(ht, &missing);
+
+    upo_ht_linprob_stats(ht, &stats);
+    assert( stats.num_gets == 2 );
+    assert( stats.num_puts == 0 );
+    assert( stats.num_deletes == 0 );
+    assert( stats.num_probes == 3 + 5 );
+#else
+    (void) missing;
+    assert( stats.num_gets == 0 && stats.num_puts == 0 && stats.num_deletes == 0 && stats.num_probes == 0 );
+#endif /* UPO_HT_STATS */
+
+    /* Resizes */
+    for (i = 0; i < sizeof more_keys/sizeof more_keys[0]; ++i)
+    {
+        upo_ht_linprob_put(ht, &more_keys[i], &more_keys[i]);
+    }
+
+    upo_ht_linprob_stats(ht, &stats);
+    assert( stats.num_resizes == 1 );
+    assert( stats.resize_time >= 0 );
+    assert( stats.capacity == 32 );
+    assert( stats.num_tombstones == 0 );
+
+    upo_ht_linprob_reset_stats(ht);
+    upo_ht_linprob_stats(ht, &stats);
+    assert( stats.num_resizes == 0 );
+    assert( stats.resize_time == 0 );
+
+    upo_ht_linprob_destroy(ht, 0);
+
+    /* HT: a cluster wrapping around the end of the slots */
+
+    ht = upo_ht_linprob_create(16, upo_ht_hash_int_div, int_compare);
+
+    assert( ht != NULL );
+
+    for (i = 0; i < sizeof wrap_keys/sizeof wrap_keys[0]; ++i)
+    {
+        upo_ht_linprob_put(ht, &wrap_keys[i], &wrap_keys[i]);
+    }
+
+    upo_ht_linprob_stats(ht, &stats);
+    assert( stats.max_probe_length == 3 );
+    assert( stats.max_chain_length == 3 );
+    assert( stats.chain_histogram[3] == 1 );
+    assert( stats.chain_histogram[1] == 0 );
+
+    upo_ht_linprob_destroy(ht, 0);
+}
+
+
+void test_build()
+{
+    size_t n = 20000;
+    int *ikeys = NULL;
+    int *ivalues = NULL;
+    void **keys = NULL;
+    void **values = NULL;
+    upo_ht_linprob_t ht = NULL;
+    upo_ht_stats_t stats;
+    int missing = -1;
+    size_t i;
+
+    ikeys = malloc(n*sizeof(int));
+    ivalues = malloc(n*sizeof(int));
+    keys = malloc(n*sizeof(void*));
+    values = malloc(n*sizeof(void*));
+    if (ikeys == NULL || ivalues == NULL || keys == NULL || values == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys and values");
+    }
+    /* Each key appears twice, and the table spans several regions */
+    for (i = 0; i < n; ++i)
+    {
+        ikeys[i] = (int) (i / 2);
+        ivalues[i] = (int) i;
+        keys[i] = &ikeys[i];
+        values[i] = &ivalues[i];
+    }
+
+    ht = upo_ht_linprob_build(upo_ht_hash_int_div, int_compare, keys, values, n);
+    assert( ht != NULL );
+    assert( upo_ht_linprob_size(ht) == n/2 );
+
+    /* The capacity is a power of two keeping the load factor below 0.5, even
+     * if duplicates are counted */
+    assert( (upo_ht_linprob_capacity(ht) & (upo_ht_linprob_capacity(ht) - 1)) == 0 );
+    assert( 2*n < upo_ht_linprob_capacity(ht) );
+    assert( upo_ht_linprob_load_factor(ht) < 0.5 );
+
+    /* As with insertions in order, the first key and the last value are kept */
+    for (i = 0; i < n; i += 2)
+    {
+        int key = ikeys[i];
+
+        assert( upo_ht_linprob_get(ht, &key) == &ivalues[i+1] );
+    }
+    assert( !upo_ht_linprob_contains(ht, &missing) );
+    upo_ht_linprob_delete(ht, &ikeys[0], 0);
+    assert( upo_ht_linprob_size(ht) == n/2 - 1 );
+    assert( !upo_ht_linprob_contains(ht, &ikeys[1]) );
+
+    upo_ht_linprob_destroy(ht, 0);
+
+    /* NULL values */
+    ht = upo_ht_linprob_build(upo_ht_hash_int_div, int_compare, keys, NULL, n);
+    assert( upo_ht_linprob_size(ht) == n/2 );
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_ht_linprob_contains(ht, &ikeys[i]) );
+        assert( upo_ht_linprob_get(ht, &ikeys[i]) == NULL );
+    }
+    upo_ht_linprob_destroy(ht, 0);
+
+    /* No pairs */
+    ht = upo_ht_linprob_build(upo_ht_hash_int_div, int_compare, NULL, NULL, 0);
+    assert( upo_ht_linprob_is_empty(ht) );
+    upo_ht_linprob_put(ht, &ikeys[0], &ivalues[0]);
+    assert( upo_ht_linprob_get(ht, &ikeys[0]) == &ivalues[0] );
+    upo_ht_linprob_stats(ht, &stats);
+    assert( stats.num_resizes == 0 );
+    upo_ht_linprob_destroy(ht, 0);
+
+    free(values);
+    free(keys);
+    free(ivalues);
+    free(ikeys);
+}
+
 
 int main()
 {
@@ -385,6 +687,21 @@ int main()
     test_traverse();
     printf("OK\n");
 
+    printf("Test case 'iterator'... ");
+    fflush(stdout);
+    test_iterator();
+    printf("OK\n");
+
+    printf("Test case 'stats'... ");
+    fflush(stdout);
+    test_stats();
+    printf("OK\n");
+
+    printf("Test case 'build'... ");
+    fflush(stdout);
+    test_build();
+    printf("OK\n");
+
 
     return 0;
 }
@@ -41,6 +41,7 @@ static void test_clear();
 static void test_empty();
 static void test_size();
 static void test_hash_funcs();
+static void test_batch();
 static void test_null();
 
 
@@ -1230,6 +1231,33 @@ void test_hash_funcs()
 
     upo_ht_sepchain_destroy(ht, 0);
 
+    /* HT with integer keys and with a multiply-xorshift mixer as hash function */
+
+    ht = upo_ht_sepchain_create(UPO_HT_SEPCHAIN_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+
+    assert( ht != NULL );
+
+    n = sizeof int_keys/sizeof int_keys[0];
+
+    /* Insertion */
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_sepchain_put(ht, &int_keys[i], &values[i]);
+    }
+
+    /* Search */
+    for (i = 0; i < n; ++i)
+    {
+        int *value = NULL;
+
+        value = upo_ht_sepchain_get(ht, &int_keys[i]);
+
+        assert( value != NULL );
+        assert( *value == values[i] );
+    }
+
+    upo_ht_sepchain_destroy(ht, 0);
+
     /* HT with string keys */
 
     ht = upo_ht_sepchain_create(UPO_HT_SEPCHAIN_DEFAULT_CAPACITY, upo_ht_hash_str_kr2e, str_compare);
@@ -1256,6 +1284,124 @@ void test_hash_funcs()
     }
 
     upo_ht_sepchain_destroy(ht, 0);
+
+    /* HT with string keys and with a wyhash-like hash function */
+
+    ht = upo_ht_sepchain_create(UPO_HT_SEPCHAIN_DEFAULT_CAPACITY, upo_ht_hash_str_wyhash, str_compare);
+
+    assert( ht != NULL );
+
+    n = sizeof str_keys/sizeof str_keys[0];
+
+    /* Insertion */
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_sepchain_put(ht, &str_keys[i], &values[i]);
+    }
+
+    /* Search */
+    for (i = 0; i < n; ++i)
+    {
+        int *value = NULL;
+
+        value = upo_ht_sepchain_get(ht, &str_keys[i]);
+
+        assert( value != NULL );
+        assert( *value == values[i] );
+    }
+
+    upo_ht_sepchain_destroy(ht, 0);
+}
+
+void test_batch()
+{
+    int keys[100];
+    int values[100];
+    int values_upd[100];
+    void *key_ptrs[150];
+    void *value_ptrs[150];
+    void *found[150];
+    void *old[150];
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i = 0;
+    upo_ht_sepchain_t ht = NULL;
+
+    ht = upo_ht_sepchain_create(UPO_HT_SEPCHAIN_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+
+    assert( ht != NULL );
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+        values[i] = (int) i;
+        values_upd[i] = (int) (n - i);
+    }
+
+    /* Insertion: the second half repeats the keys of the first quarter, so
+     * that some pairs of the same batch update each other */
+    for (i = 0; i < n; ++i)
+    {
+        key_ptrs[i] = &keys[i];
+        value_ptrs[i] = &values[i];
+    }
+    for (i = 0; i < n/2; ++i)
+    {
+        key_ptrs[n+i] = &keys[i % (n/4)];
+        value_ptrs[n+i] = &values_upd[i % (n/4)];
+    }
+    upo_ht_sepchain_put_batch(ht, key_ptrs, value_ptrs, n + n/2, old);
+
+    assert( upo_ht_sepchain_size(ht) == n );
+
+    for (i = 0; i < n; ++i)
+    {
+        assert( old[i] == NULL );
+    }
+    for (i = n; i < n + n/4; ++i)
+    {
+        assert( old[i] == &values[i - n] );
+    }
+    for (i = n + n/4; i < n + n/2; ++i)
+    {
+        assert( old[i] == &values_upd[i - n - n/4] );
+    }
+
+    /* Search: the batch also contains missing keys, and its size is not a
+     * multiple of the group size */
+    for (i = 0; i < n; ++i)
+    {
+        key_ptrs[i] = &keys[n-1-i];
+    }
+    for (i = n; i < n + n/2; ++i)
+    {
+        key_ptrs[i] = &values_upd[0]; /* key n is not in the hash table */
+    }
+    upo_ht_sepchain_get_batch(ht, key_ptrs, n + n/2 - 1, found);
+
+    for (i = 0; i < n; ++i)
+    {
+        assert( found[i] == upo_ht_sepchain_get(ht, key_ptrs[i]) );
+        assert( found[i] != NULL );
+    }
+    for (i = n; i < n + n/2 - 1; ++i)
+    {
+        assert( found[i] == NULL );
+    }
+
+    /* Replaced values are optional */
+    upo_ht_sepchain_put_batch(ht, key_ptrs, value_ptrs, n, NULL);
+
+    assert( upo_ht_sepchain_size(ht) == n );
+
+    upo_ht_sepchain_destroy(ht, 0);
+
+    /* HT: NULL */
+    upo_ht_sepchain_get_batch(NULL, key_ptrs, n, found);
+
+    for (i = 0; i < n; ++i)
+    {
+        assert( found[i] == NULL );
+    }
 }
 
 void test_null()
@@ -1311,6 +1457,11 @@ int main()
     test_hash_funcs();
     printf("OK\n");
 
+    printf("Test case 'batch'... ");
+    fflush(stdout);
+    test_batch();
+    printf("OK\n");
+
     printf("Test case 'null'... ");
     fflush(stdout);
     test_null();
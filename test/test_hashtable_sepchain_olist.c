@@ -0,0 +1,367 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/hashtable.h>
+#include <upo/error.h>
+
+
+static int str_compare(const void *a, const void *b);
+static int int_compare(const void *a, const void *b);
+static uint64_t const_hash(const void *x);
+
+static void test_create_destroy();
+static void test_put_get_contains_delete();
+static void test_insert();
+static void test_clear();
+static void test_empty_size();
+static void test_str_keys();
+static void test_null();
+
+
+int str_compare(const void *a, const void *b)
+{
+    const char **aa = (const char**) a;
+    const char **bb = (const char**) b;
+
+    return strcmp(*aa, *bb);
+}
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+uint64_t const_hash(const void *x)
+{
+    assert( x != NULL );
+
+    return 42;
+}
+
+void test_create_destroy()
+{
+    upo_ht_sepchain_olist_t ht;
+
+    ht = upo_ht_sepchain_olist_create(UPO_HT_SEPCHAIN_OLIST_DEFAULT_CAPACITY, upo_ht_hash_str_kr2e, str_compare);
+
+    assert( ht != NULL );
+    assert( upo_ht_sepchain_olist_capacity(ht) == UPO_HT_SEPCHAIN_OLIST_DEFAULT_CAPACITY );
+
+    upo_ht_sepchain_olist_destroy(ht, 0);
+}
+
+void test_put_get_contains_delete()
+{
+    int keys[] = {5,3,8,0,9,1,7,2,6,4};
+    int values[] = {0,1,2,3,4,5,6,7,8,9};
+    int values_upd[] = {9,8,7,6,5,4,3,2,1,0};
+    int no_keys[] = {-1,10,11,100};
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t num_no_keys = sizeof no_keys/sizeof no_keys[0];
+    upo_ht_hasher_t hashers[] = {upo_ht_hash_int_div, upo_ht_hash_int_mix, const_hash};
+    size_t capacities[] = {3, 3, 1};
+    size_t h;
+
+    /* Hashers: few slots, random slots, and a single hash value (so that
+     * lists are sorted by key only) */
+    for (h = 0; h < sizeof hashers/sizeof hashers[0]; ++h)
+    {
+        upo_ht_sepchain_olist_t ht = upo_ht_sepchain_olist_create(capacities[h], hashers[h], int_compare);
+        size_t i;
+
+        assert( ht != NULL );
+
+        /* Insertion */
+        for (i = 0; i < n; ++i)
+        {
+            assert( upo_ht_sepchain_olist_put(ht, &keys[i], &values[i]) == NULL );
+            assert( upo_ht_sepchain_olist_size(ht) == i+1 );
+        }
+
+        /* Search */
+        for (i = 0; i < n; ++i)
+        {
+            int *value = upo_ht_sepchain_olist_get(ht, &keys[i]);
+
+            assert( value != NULL );
+            assert( *value == values[i] );
+            assert( upo_ht_sepchain_olist_contains(ht, &keys[i]) );
+        }
+        for (i = 0; i < num_no_keys; ++i)
+        {
+            assert( upo_ht_sepchain_olist_get(ht, &no_keys[i]) == NULL );
+            assert( !upo_ht_sepchain_olist_contains(ht, &no_keys[i]) );
+        }
+
+        /* Update */
+        for (i = 0; i < n; ++i)
+        {
+            int *old_value = upo_ht_sepchain_olist_put(ht, &keys[i], &values_upd[i]);
+            int *value = upo_ht_sepchain_olist_get(ht, &keys[i]);
+
+            assert( old_value != NULL );
+            assert( *old_value == values[i] );
+            assert( value != NULL );
+            assert( *value == values_upd[i] );
+        }
+
+        assert( upo_ht_sepchain_olist_size(ht) == n );
+
+        /* Removal: keys are removed from both ends and the middle of lists */
+        for (i = 0; i < num_no_keys; ++i)
+        {
+            upo_ht_sepchain_olist_delete(ht, &no_keys[i], 0);
+        }
+
+        assert( upo_ht_sepchain_olist_size(ht) == n );
+
+        for (i = 0; i < n; ++i)
+        {
+            size_t j;
+
+            upo_ht_sepchain_olist_delete(ht, &keys[i], 0);
+
+            assert( !upo_ht_sepchain_olist_contains(ht, &keys[i]) );
+            assert( upo_ht_sepchain_olist_size(ht) == n-i-1 );
+
+            for (j = i+1; j < n; ++j)
+            {
+                assert( upo_ht_sepchain_olist_contains(ht, &keys[j]) );
+            }
+        }
+
+        assert( upo_ht_sepchain_olist_is_empty(ht) );
+
+        upo_ht_sepchain_olist_destroy(ht, 0);
+    }
+}
+
+void test_insert()
+{
+    int keys[] = {4,0,2,3,1};
+    int values[] = {0,1,2,3,4};
+    int values_upd[] = {9,8,7,6,5};
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i;
+    upo_ht_sepchain_olist_t ht;
+
+    ht = upo_ht_sepchain_olist_create(1, const_hash, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_sepchain_olist_insert(ht, &keys[i], &values[i]);
+    }
+    /* Duplicates are ignored */
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_sepchain_olist_insert(ht, &keys[i], &values_upd[i]);
+    }
+
+    assert( upo_ht_sepchain_olist_size(ht) == n );
+
+    for (i = 0; i < n; ++i)
+    {
+        int *value = upo_ht_sepchain_olist_get(ht, &keys[i]);
+
+        assert( value != NULL );
+        assert( *value == values[i] );
+    }
+
+    upo_ht_sepchain_olist_destroy(ht, 0);
+}
+
+void test_clear()
+{
+    size_t n = 100;
+    size_t i;
+    upo_ht_sepchain_olist_t ht;
+
+    ht = upo_ht_sepchain_olist_create(7, upo_ht_hash_int_div, int_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        int *key = malloc(sizeof(int));
+        int *value = malloc(sizeof(int));
+
+        if (key == NULL || value == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for key-value pairs");
+        }
+        *key = *value = (int) i;
+        upo_ht_sepchain_olist_put(ht, key, value);
+    }
+
+    assert( upo_ht_sepchain_olist_size(ht) == n );
+
+    upo_ht_sepchain_olist_clear(ht, 1);
+
+    assert( upo_ht_sepchain_olist_is_empty(ht) );
+
+    /* The hash table is still usable after being cleared */
+    for (i = 0; i < n; ++i)
+    {
+        int *key = malloc(sizeof(int));
+        int *value = malloc(sizeof(int));
+
+        if (key == NULL || value == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for key-value pairs");
+        }
+        *key = *value = (int) i;
+        upo_ht_sepchain_olist_put(ht, key, value);
+    }
+
+    assert( upo_ht_sepchain_olist_size(ht) == n );
+
+    upo_ht_sepchain_olist_destroy(ht, 1);
+}
+
+void test_empty_size()
+{
+    int keys[] = {0,1,2,3,4,5,6,7,8,9};
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t i;
+    upo_ht_sepchain_olist_t ht;
+
+    ht = upo_ht_sepchain_olist_create(4, upo_ht_hash_int_div, int_compare);
+
+    assert( upo_ht_sepchain_olist_is_empty(ht) );
+    assert( upo_ht_sepchain_olist_size(ht) == 0 );
+    assert( upo_ht_sepchain_olist_load_factor(ht) == 0 );
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_sepchain_olist_put(ht, &keys[i], &keys[i]);
+    }
+
+    assert( !upo_ht_sepchain_olist_is_empty(ht) );
+    assert( upo_ht_sepchain_olist_size(ht) == n );
+    assert( upo_ht_sepchain_olist_load_factor(ht) == n/4.0 );
+
+    upo_ht_sepchain_olist_destroy(ht, 0);
+}
+
+void test_str_keys()
+{
+    char *keys[] = {"pear","apple","fig","banana","kiwi","cherry"};
+    int values[] = {0,1,2,3,4,5};
+    char *no_keys[] = {"","grape","zucchini"};
+    size_t n = sizeof keys/sizeof keys[0];
+    size_t num_no_keys = sizeof no_keys/sizeof no_keys[0];
+    size_t i;
+    upo_ht_sepchain_olist_t ht;
+
+    ht = upo_ht_sepchain_olist_create(2, upo_ht_hash_str_wyhash, str_compare);
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_sepchain_olist_put(ht, &keys[i], &values[i]);
+    }
+    for (i = 0; i < n; ++i)
+    {
+        int *value = upo_ht_sepchain_olist_get(ht, &keys[i]);
+
+        assert( value != NULL );
+        assert( *value == values[i] );
+    }
+    for (i = 0; i < num_no_keys; ++i)
+    {
+        assert( !upo_ht_sepchain_olist_contains(ht, &no_keys[i]) );
+    }
+
+    upo_ht_sepchain_olist_destroy(ht, 0);
+}
+
+void test_null()
+{
+    int key = 0;
+    upo_ht_sepchain_olist_t ht = NULL;
+
+    assert( upo_ht_sepchain_olist_put(ht, &key, &key) == NULL );
+
+    upo_ht_sepchain_olist_insert(ht, &key, &key);
+
+    assert( upo_ht_sepchain_olist_get(ht, &key) == NULL );
+
+    assert( !upo_ht_sepchain_olist_contains(ht, &key) );
+
+    upo_ht_sepchain_olist_delete(ht, &key, 0);
+
+    assert( upo_ht_sepchain_olist_size(ht) == 0 );
+
+    assert( upo_ht_sepchain_olist_is_empty(ht) );
+
+    assert( upo_ht_sepchain_olist_capacity(ht) == 0 );
+
+    upo_ht_sepchain_olist_clear(ht, 0);
+
+    upo_ht_sepchain_olist_destroy(ht, 0);
+}
+
+
+int main()
+{
+    printf("Test case 'create/destroy'... ");
+    fflush(stdout);
+    test_create_destroy();
+    printf("OK\n");
+
+    printf("Test case 'put/get/contains/delete'... ");
+    fflush(stdout);
+    test_put_get_contains_delete();
+    printf("OK\n");
+
+    printf("Test case 'insert'... ");
+    fflush(stdout);
+    test_insert();
+    printf("OK\n");
+
+    printf("Test case 'clear'... ");
+    fflush(stdout);
+    test_clear();
+    printf("OK\n");
+
+    printf("Test case 'empty/size'... ");
+    fflush(stdout);
+    test_empty_size();
+    printf("OK\n");
+
+    printf("Test case 'string keys'... ");
+    fflush(stdout);
+    test_str_keys();
+    printf("OK\n");
+
+    printf("Test case 'null'... ");
+    fflush(stdout);
+    test_null();
+    printf("OK\n");
+
+    return 0;
+}
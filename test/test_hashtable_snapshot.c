@@ -0,0 +1,295 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+#include <upo/hashtable_snapshot.h>
+
+
+#define SNAPSHOT_PATH "test_hashtable_snapshot.tmp"
+
+
+static int int_compare(const void *a, const void *b);
+static int str_compare(const void *a, const void *b);
+static void count_pair_visit(void *key, void *value, void *info);
+
+static void test_empty();
+static void test_int();
+static void test_str();
+static void test_null_values();
+static void test_invalid();
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+int str_compare(const void *a, const void *b)
+{
+    const char **aa = (const char**) a;
+    const char **bb = (const char**) b;
+
+    return strcmp(*aa, *bb);
+}
+
+void count_pair_visit(void *key, void *value, void *info)
+{
+    size_t *counter = info;
+
+    assert( key != NULL );
+    assert( value != NULL );
+    /* Values are stored as the key times two */
+    assert( *(int*) value == 2 * *(int*) key );
+
+    *counter += 1;
+}
+
+void test_empty()
+{
+    upo_ht_linprob_t ht = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+    upo_ht_linprob_snapshot_t snap = NULL;
+    int key = 1;
+
+    assert( upo_ht_linprob_snapshot_save(ht, SNAPSHOT_PATH, upo_ht_serialize_int, upo_ht_serialize_int) );
+
+    snap = upo_ht_linprob_snapshot_open(SNAPSHOT_PATH, upo_ht_hash_int_div, upo_ht_serialize_int);
+    assert( snap != NULL );
+    assert( upo_ht_linprob_snapshot_is_empty(snap) );
+    assert( upo_ht_linprob_snapshot_size(snap) == 0 );
+    assert( upo_ht_linprob_snapshot_capacity(snap) > 0 );
+    assert( upo_ht_linprob_snapshot_get(snap, &key) == NULL );
+    assert( !upo_ht_linprob_snapshot_contains(snap, &key) );
+
+    upo_ht_linprob_snapshot_close(snap);
+    upo_ht_linprob_destroy(ht, 0);
+
+    remove(SNAPSHOT_PATH);
+}
+
+void test_int()
+{
+    size_t n = 1000;
+    int *keys = NULL;
+    int *values = NULL;
+    upo_ht_linprob_t ht = NULL;
+    upo_ht_linprob_snapshot_t snap = NULL;
+    size_t counter = 0;
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    values = malloc(n*sizeof(int));
+    if (keys == NULL || values == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys and values");
+    }
+
+    ht = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+    for (i = 0; i < n; ++i)
+    {
+        /* Keys sharing the low bits collide in the snapshot */
+        keys[i] = (int) (i * 64);
+        values[i] = 2*keys[i];
+        upo_ht_linprob_put(ht, &keys[i], &values[i]);
+    }
+    /* Deleted slots must not break probe sequences of the snapshot */
+    for (i = 0; i < n; i += 3)
+    {
+        upo_ht_linprob_delete(ht, &keys[i], 0);
+    }
+
+    assert( upo_ht_linprob_snapshot_save(ht, SNAPSHOT_PATH, upo_ht_serialize_int, upo_ht_serialize_int) );
+    upo_ht_linprob_destroy(ht, 0);
+
+    snap = upo_ht_linprob_snapshot_open(SNAPSHOT_PATH, upo_ht_hash_int_div, upo_ht_serialize_int);
+    assert( snap != NULL );
+    assert( upo_ht_linprob_snapshot_size(snap) == n - (n + 2)/3 );
+    assert( upo_ht_linprob_snapshot_capacity(snap) >= 2*upo_ht_linprob_snapshot_size(snap) );
+
+    for (i = 0; i < n; ++i)
+    {
+        int key = keys[i];
+        const int *value = upo_ht_linprob_snapshot_get(snap, &key);
+
+        if (i % 3 == 0)
+        {
+            assert( value == NULL );
+            assert( !upo_ht_linprob_snapshot_contains(snap, &key) );
+        }
+        else
+        {
+            assert( value != NULL );
+            assert( (uintptr_t) value % alignof(max_align_t) == 0 );
+            assert( *value == 2*key );
+            assert( upo_ht_linprob_snapshot_contains(snap, &key) );
+        }
+    }
+
+    upo_ht_linprob_snapshot_traverse(snap, count_pair_visit, &counter);
+    assert( counter == upo_ht_linprob_snapshot_size(snap) );
+
+    upo_ht_linprob_snapshot_close(snap);
+    free(values);
+    free(keys);
+
+    remove(SNAPSHOT_PATH);
+}
+
+void test_str()
+{
+    char *keys[] = {"apple", "banana", "cherry", "", "a longer key spanning more than one alignment unit"};
+    char *values[] = {"red", "yellow", "dark red", "empty", ""};
+    size_t n = sizeof keys/sizeof keys[0];
+    upo_ht_linprob_t ht = NULL;
+    upo_ht_linprob_snapshot_t snap = NULL;
+    char buf[64];
+    char *copy = buf;
+    char *missing = "durian";
+    size_t i;
+
+    ht = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_str_djb2, str_compare);
+    for (i = 0; i < n; ++i)
+    {
+        upo_ht_linprob_put(ht, &keys[i], &values[i]);
+    }
+
+    assert( upo_ht_linprob_snapshot_save(ht, SNAPSHOT_PATH, upo_ht_serialize_str, upo_ht_serialize_str) );
+    upo_ht_linprob_destroy(ht, 0);
+
+    snap = upo_ht_linprob_snapshot_open(SNAPSHOT_PATH, upo_ht_hash_str_djb2, upo_ht_serialize_str);
+    assert( snap != NULL );
+    assert( upo_ht_linprob_snapshot_size(snap) == n );
+
+    for (i = 0; i < n; ++i)
+    {
+        const char *value = NULL;
+
+        /* Look up a copy, to be sure keys are compared by content */
+        strcpy(buf, keys[i]);
+        value = upo_ht_linprob_snapshot_get(snap, &copy);
+        assert( value != NULL );
+        assert( strcmp(value, values[i]) == 0 );
+    }
+    assert( upo_ht_linprob_snapshot_get(snap, &missing) == NULL );
+
+    upo_ht_linprob_snapshot_close(snap);
+
+    remove(SNAPSHOT_PATH);
+}
+
+void test_null_values()
+{
+    int keys[] = {1, 2, 3};
+    int value = 4;
+    upo_ht_linprob_t ht = upo_ht_linprob_create(UPO_HT_LINPROB_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+    upo_ht_linprob_snapshot_t snap = NULL;
+
+    upo_ht_linprob_put(ht, &keys[0], NULL);
+    upo_ht_linprob_put(ht, &keys[1], &value);
+
+    assert( upo_ht_linprob_snapshot_save(ht, SNAPSHOT_PATH, upo_ht_serialize_int, upo_ht_serialize_int) );
+    upo_ht_linprob_destroy(ht, 0);
+
+    snap = upo_ht_linprob_snapshot_open(SNAPSHOT_PATH, upo_ht_hash_int_div, upo_ht_serialize_int);
+    assert( snap != NULL );
+    assert( upo_ht_linprob_snapshot_get(snap, &keys[0]) == NULL );
+    assert( upo_ht_linprob_snapshot_contains(snap, &keys[0]) );
+    assert( *(const int*) upo_ht_linprob_snapshot_get(snap, &keys[1]) == value );
+    assert( !upo_ht_linprob_snapshot_contains(snap, &keys[2]) );
+
+    upo_ht_linprob_snapshot_close(snap);
+
+    remove(SNAPSHOT_PATH);
+}
+
+void test_invalid()
+{
+    FILE *fp = NULL;
+    char garbage[256];
+
+    /* Missing file */
+    remove(SNAPSHOT_PATH);
+    assert( upo_ht_linprob_snapshot_open(SNAPSHOT_PATH, upo_ht_hash_int_div, upo_ht_serialize_int) == NULL );
+
+    /* Truncated file */
+    fp = fopen(SNAPSHOT_PATH, "wb");
+    assert( fp != NULL );
+    fputs("UPO", fp);
+    fclose(fp);
+    assert( upo_ht_linprob_snapshot_open(SNAPSHOT_PATH, upo_ht_hash_int_div, upo_ht_serialize_int) == NULL );
+
+    /* Not a snapshot */
+    memset(garbage, 'x', sizeof garbage);
+    fp = fopen(SNAPSHOT_PATH, "wb");
+    assert( fp != NULL );
+    fwrite(garbage, 1, sizeof garbage, fp);
+    fclose(fp);
+    assert( upo_ht_linprob_snapshot_open(SNAPSHOT_PATH, upo_ht_hash_int_div, upo_ht_serialize_int) == NULL );
+
+    /* NULL snapshots */
+    assert( upo_ht_linprob_snapshot_size(NULL) == 0 );
+    assert( upo_ht_linprob_snapshot_is_empty(NULL) );
+    assert( upo_ht_linprob_snapshot_get(NULL, garbage) == NULL );
+    upo_ht_linprob_snapshot_close(NULL);
+
+    remove(SNAPSHOT_PATH);
+}
+
+
+int main()
+{
+    printf("Test case 'empty'... ");
+    fflush(stdout);
+    test_empty();
+    printf("OK\n");
+
+    printf("Test case 'int'... ");
+    fflush(stdout);
+    test_int();
+    printf("OK\n");
+
+    printf("Test case 'str'... ");
+    fflush(stdout);
+    test_str();
+    printf("OK\n");
+
+    printf("Test case 'null values'... ");
+    fflush(stdout);
+    test_null_values();
+    printf("OK\n");
+
+    printf("Test case 'invalid'... ");
+    fflush(stdout);
+    test_invalid();
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,465 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <upo/error.h>
+#include <upo/hashtable.h>
+#include <upo/hset.h>
+
+
+/** \brief The keys used by set algebra tests are in [0, MAX_KEY). */
+#define MAX_KEY 4000
+
+
+static int int_compare(const void *a, const void *b);
+static int str_compare(const void *a, const void *b);
+static void count_visit(void *key, void *info);
+static void count_mset_visit(void *key, size_t count, void *info);
+static upo_hset_t make_set(int *keys, size_t step, size_t offset);
+static void check_set(upo_hset_t set, int *keys, const char *expect);
+
+static void test_empty();
+static void test_add_remove();
+static void test_str();
+static void test_algebra();
+static void test_algebra_parallel();
+static void test_multiset();
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+int str_compare(const void *a, const void *b)
+{
+    const char **aa = (const char**) a;
+    const char **bb = (const char**) b;
+
+    return strcmp(*aa, *bb);
+}
+
+void count_visit(void *key, void *info)
+{
+    size_t *counter = info;
+
+    assert( key != NULL );
+
+    *counter += 1;
+}
+
+void count_mset_visit(void *key, size_t count, void *info)
+{
+    size_t *total = info;
+
+    assert( key != NULL );
+    /* Keys are added as many times as their value */
+    assert( count == (size_t) *(int*) key );
+
+    *total += count;
+}
+
+upo_hset_t make_set(int *keys, size_t step, size_t offset)
+{
+    upo_hset_t set = upo_hset_create(UPO_HSET_DEFAULT_CAPACITY, upo_ht_hash_int_mix, int_compare);
+    size_t i;
+
+    for (i = offset; i < MAX_KEY; i += step)
+    {
+        assert( upo_hset_add(set, &keys[i]) );
+    }
+
+    return set;
+}
+
+void check_set(upo_hset_t set, int *keys, const char *expect)
+{
+    size_t n = 0;
+    size_t counter = 0;
+    size_t i;
+
+    for (i = 0; i < MAX_KEY; ++i)
+    {
+        int key = keys[i];
+
+        assert( upo_hset_contains(set, &key) == (expect[i] != 0) );
+        n += (expect[i] != 0);
+    }
+    assert( upo_hset_size(set) == n );
+    assert( upo_hset_load_factor(set) <= UPO_HSET_MAX_LOAD_FACTOR );
+
+    upo_hset_traverse(set, count_visit, &counter);
+    assert( counter == n );
+}
+
+void test_empty()
+{
+    upo_hset_t set = upo_hset_create(UPO_HSET_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+    upo_hmset_t mset = upo_hmset_create(UPO_HSET_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+    int key = 1;
+
+    assert( upo_hset_is_empty(set) );
+    assert( upo_hset_size(set) == 0 );
+    assert( upo_hset_capacity(set) >= UPO_HSET_DEFAULT_CAPACITY );
+    assert( !upo_hset_contains(set, &key) );
+    assert( upo_hset_get(set, &key) == NULL );
+    upo_hset_remove(set, &key, 0);
+    assert( upo_hset_is_empty(set) );
+
+    assert( upo_hmset_is_empty(mset) );
+    assert( upo_hmset_count(mset, &key) == 0 );
+    assert( upo_hmset_remove(mset, &key, 0) == 0 );
+    assert( upo_hmset_total(mset) == 0 );
+
+    /* NULL sets */
+    assert( upo_hset_size(NULL) == 0 );
+    assert( upo_hset_is_empty(NULL) );
+    assert( upo_hset_copy(NULL) == NULL );
+    assert( upo_hmset_size(NULL) == 0 );
+
+    upo_hmset_destroy(mset, 0);
+    upo_hset_destroy(set, 0);
+}
+
+void test_add_remove()
+{
+    size_t n = 2000;
+    int *keys = NULL;
+    char *present = NULL;
+    upo_hset_t set = NULL;
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    present = calloc(n, 1);
+    if (keys == NULL || present == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+
+    /* The identity hash and strided keys build long clusters, which removals
+     * must shift back without breaking probe sequences */
+    set = upo_hset_create(UPO_HSET_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) ((i % 7 == 0) ? i * 1024 : i);
+        assert( upo_hset_add(set, &keys[i]) );
+        present[i] = 1;
+    }
+    for (i = 0; i < n; ++i)
+    {
+        int key = keys[i];
+
+        /* Duplicates are not added, and the stored key is kept */
+        assert( !upo_hset_add(set, &key) );
+        assert( upo_hset_get(set, &key) == &keys[i] );
+    }
+    assert( upo_hset_size(set) == n );
+
+    for (i = 0; i < n; i += 3)
+    {
+        upo_hset_remove(set, &keys[i], 0);
+        present[i] = 0;
+    }
+    for (i = 0; i < n; ++i)
+    {
+        assert( upo_hset_contains(set, &keys[i]) == present[i] );
+    }
+    assert( upo_hset_size(set) == n - (n + 2)/3 );
+
+    upo_hset_clear(set, 0);
+    assert( upo_hset_is_empty(set) );
+    for (i = 0; i < n; ++i)
+    {
+        assert( !upo_hset_contains(set, &keys[i]) );
+    }
+
+    upo_hset_destroy(set, 0);
+    free(present);
+    free(keys);
+}
+
+void test_str()
+{
+    char *words[] = {"apple", "banana", "cherry", "", "banana", "apple"};
+    size_t n = sizeof words/sizeof words[0];
+    upo_hset_t set = upo_hset_create(UPO_HSET_DEFAULT_CAPACITY, upo_ht_hash_str_djb2, str_compare);
+    char buf[16];
+    char *copy = buf;
+    size_t i;
+
+    for (i = 0; i < n; ++i)
+    {
+        char **key = malloc(sizeof(char*));
+
+        if (key == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for a key");
+        }
+        *key = words[i];
+        if (!upo_hset_add(set, key))
+        {
+            free(key);
+        }
+    }
+    assert( upo_hset_size(set) == 4 );
+
+    /* Look up a copy, to be sure keys are compared by content */
+    strcpy(buf, "cherry");
+    assert( upo_hset_contains(set, &copy) );
+    strcpy(buf, "durian");
+    assert( !upo_hset_contains(set, &copy) );
+    strcpy(buf, "banana");
+    upo_hset_remove(set, &copy, 1);
+    assert( !upo_hset_contains(set, &copy) );
+    assert( upo_hset_size(set) == 3 );
+
+    upo_hset_destroy(set, 1);
+}
+
+void test_algebra()
+{
+    int keys[MAX_KEY];
+    char expect[MAX_KEY];
+    upo_hset_t evens = NULL;
+    upo_hset_t thirds = NULL;
+    upo_hset_t empty = NULL;
+    upo_hset_t res = NULL;
+    size_t i;
+
+    for (i = 0; i < MAX_KEY; ++i)
+    {
+        keys[i] = (int) i;
+    }
+    evens = make_set(keys, 2, 0);
+    thirds = make_set(keys, 3, 1);
+    empty = make_set(keys, 1, MAX_KEY);
+
+    /* Both operand orders, since the smaller set is the one iterated over */
+    for (i = 0; i < MAX_KEY; ++i)
+    {
+        expect[i] = (i % 2 == 0) || (i % 3 == 1);
+    }
+    res = upo_hset_union(evens, thirds);
+    check_set(res, keys, expect);
+    upo_hset_destroy(res, 0);
+    res = upo_hset_union(thirds, evens);
+    check_set(res, keys, expect);
+    upo_hset_destroy(res, 0);
+
+    for (i = 0; i < MAX_KEY; ++i)
+    {
+        expect[i] = (i % 2 == 0) && (i % 3 == 1);
+    }
+    res = upo_hset_intersect(evens, thirds);
+    check_set(res, keys, expect);
+    upo_hset_destroy(res, 0);
+    res = upo_hset_intersect(thirds, evens);
+    check_set(res, keys, expect);
+    upo_hset_destroy(res, 0);
+
+    for (i = 0; i < MAX_KEY; ++i)
+    {
+        expect[i] = (i % 2 == 0) && (i % 3 != 1);
+    }
+    res = upo_hset_difference(evens, thirds);
+    check_set(res, keys, expect);
+    upo_hset_destroy(res, 0);
+    for (i = 0; i < MAX_KEY; ++i)
+    {
+        expect[i] = (i % 2 != 0) && (i % 3 == 1);
+    }
+    res = upo_hset_difference(thirds, evens);
+    check_set(res, keys, expect);
+    upo_hset_destroy(res, 0);
+
+    /* Empty operands */
+    for (i = 0; i < MAX_KEY; ++i)
+    {
+        expect[i] = (i % 2 == 0);
+    }
+    res = upo_hset_union(empty, evens);
+    check_set(res, keys, expect);
+    upo_hset_destroy(res, 0);
+    res = upo_hset_difference(evens, empty);
+    check_set(res, keys, expect);
+    upo_hset_destroy(res, 0);
+    res = upo_hset_intersect(evens, empty);
+    assert( upo_hset_is_empty(res) );
+    upo_hset_destroy(res, 0);
+
+    /* Operands are left untouched */
+    assert( upo_hset_size(evens) == MAX_KEY/2 );
+    assert( upo_hset_size(thirds) == (MAX_KEY + 1)/3 );
+
+    upo_hset_destroy(empty, 0);
+    upo_hset_destroy(thirds, 0);
+    upo_hset_destroy(evens, 0);
+}
+
+void test_algebra_parallel()
+{
+    int keys[MAX_KEY];
+    char expect[MAX_KEY];
+    upo_hset_t evens = NULL;
+    upo_hset_t fifths = NULL;
+    size_t threads[] = {0, 1, 3, 8};
+    size_t t;
+    size_t i;
+
+    for (i = 0; i < MAX_KEY; ++i)
+    {
+        keys[i] = (int) i;
+    }
+    evens = make_set(keys, 2, 0);
+    fifths = make_set(keys, 5, 0);
+
+    for (t = 0; t < sizeof threads/sizeof threads[0]; ++t)
+    {
+        upo_hset_t res = NULL;
+
+        for (i = 0; i < MAX_KEY; ++i)
+        {
+            expect[i] = (i % 2 == 0) || (i % 5 == 0);
+        }
+        res = upo_hset_union_parallel(fifths, evens, threads[t]);
+        check_set(res, keys, expect);
+        upo_hset_destroy(res, 0);
+
+        for (i = 0; i < MAX_KEY; ++i)
+        {
+            expect[i] = (i % 10 == 0);
+        }
+        res = upo_hset_intersect_parallel(evens, fifths, threads[t]);
+        check_set(res, keys, expect);
+        upo_hset_destroy(res, 0);
+
+        for (i = 0; i < MAX_KEY; ++i)
+        {
+            expect[i] = (i % 2 == 0) && (i % 5 != 0);
+        }
+        res = upo_hset_difference_parallel(evens, fifths, threads[t]);
+        check_set(res, keys, expect);
+        upo_hset_destroy(res, 0);
+        for (i = 0; i < MAX_KEY; ++i)
+        {
+            expect[i] = (i % 2 != 0) && (i % 5 == 0);
+        }
+        res = upo_hset_difference_parallel(fifths, evens, threads[t]);
+        check_set(res, keys, expect);
+        upo_hset_destroy(res, 0);
+    }
+
+    upo_hset_destroy(fifths, 0);
+    upo_hset_destroy(evens, 0);
+}
+
+void test_multiset()
+{
+    int keys[100];
+    upo_hmset_t mset = upo_hmset_create(UPO_HSET_DEFAULT_CAPACITY, upo_ht_hash_int_div, int_compare);
+    size_t total = 0;
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < 100; ++i)
+    {
+        keys[i] = (int) i;
+        for (j = 0; j < i; ++j)
+        {
+            assert( upo_hmset_add(mset, &keys[i]) == j + 1 );
+        }
+    }
+    assert( upo_hmset_size(mset) == 99 );
+    assert( upo_hmset_total(mset) == 99*100/2 );
+    assert( !upo_hmset_contains(mset, &keys[0]) );
+
+    upo_hmset_traverse(mset, count_mset_visit, &total);
+    assert( total == upo_hmset_total(mset) );
+
+    /* Removing the last occurrence removes the key */
+    assert( upo_hmset_remove(mset, &keys[1], 0) == 0 );
+    assert( !upo_hmset_contains(mset, &keys[1]) );
+    assert( upo_hmset_remove(mset, &keys[50], 0) == 49 );
+    assert( upo_hmset_count(mset, &keys[50]) == 49 );
+    assert( upo_hmset_size(mset) == 98 );
+    assert( upo_hmset_total(mset) == 99*100/2 - 2 );
+
+    /* Counters follow keys moved by removals */
+    for (i = 2; i < 100; i += 2)
+    {
+        while (upo_hmset_remove(mset, &keys[i], 0) > 0)
+        {
+        }
+    }
+    for (i = 3; i < 100; i += 2)
+    {
+        assert( upo_hmset_count(mset, &keys[i]) == i );
+    }
+
+    upo_hmset_clear(mset, 0);
+    assert( upo_hmset_is_empty(mset) );
+    assert( upo_hmset_total(mset) == 0 );
+
+    upo_hmset_destroy(mset, 0);
+}
+
+
+int main()
+{
+    printf("Test case 'empty'... ");
+    fflush(stdout);
+    test_empty();
+    printf("OK\n");
+
+    printf("Test case 'add and remove'... ");
+    fflush(stdout);
+    test_add_remove();
+    printf("OK\n");
+
+    printf("Test case 'str'... ");
+    fflush(stdout);
+    test_str();
+    printf("OK\n");
+
+    printf("Test case 'set algebra'... ");
+    fflush(stdout);
+    test_algebra();
+    printf("OK\n");
+
+    printf("Test case 'parallel set algebra'... ");
+    fflush(stdout);
+    test_algebra_parallel();
+    printf("OK\n");
+
+    printf("Test case 'multiset'... ");
+    fflush(stdout);
+    test_multiset();
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,216 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <upo/error.h>
+#include <upo/pool.h>
+
+
+static void test_create_destroy();
+static void test_alloc_free();
+static void test_reuse();
+static void test_alignment();
+static void test_clear();
+static void test_null();
+
+
+void test_create_destroy()
+{
+    upo_pool_t pool;
+
+    pool = upo_pool_create(sizeof(int), UPO_POOL_DEFAULT_CHUNK_CAPACITY);
+
+    assert( pool != NULL );
+    assert( upo_pool_size(pool) == 0 );
+    assert( upo_pool_num_chunks(pool) == 0 );
+
+    upo_pool_destroy(pool);
+
+    /* Blocks smaller than a pointer and default capacity */
+    pool = upo_pool_create(1, 0);
+
+    assert( pool != NULL );
+
+    upo_pool_destroy(pool);
+}
+
+void test_alloc_free()
+{
+    size_t n = 1000;
+    size_t i;
+    int *blocks[1000];
+    upo_pool_t pool;
+
+    pool = upo_pool_create(sizeof(int), 4);
+
+    for (i = 0; i < n; ++i)
+    {
+        blocks[i] = upo_pool_alloc(pool);
+
+        assert( blocks[i] != NULL );
+
+        *blocks[i] = (int) i;
+
+        assert( upo_pool_size(pool) == i+1 );
+    }
+    /* Chunk capacities double: 4+8+...+512 >= 1000 */
+    assert( upo_pool_num_chunks(pool) == 8 );
+    /* Blocks must not overlap */
+    for (i = 0; i < n; ++i)
+    {
+        assert( *blocks[i] == (int) i );
+    }
+    for (i = 0; i < n; ++i)
+    {
+        upo_pool_free(pool, blocks[i]);
+
+        assert( upo_pool_size(pool) == n-i-1 );
+    }
+
+    upo_pool_free(pool, NULL);
+
+    assert( upo_pool_size(pool) == 0 );
+
+    upo_pool_destroy(pool);
+}
+
+void test_reuse()
+{
+    void *block1 = NULL;
+    void *block2 = NULL;
+    upo_pool_t pool;
+
+    pool = upo_pool_create(sizeof(double), 2);
+
+    block1 = upo_pool_alloc(pool);
+    upo_pool_free(pool, block1);
+    block2 = upo_pool_alloc(pool);
+
+    /* Freed blocks are reused before carving new ones */
+    assert( block1 == block2 );
+    assert( upo_pool_num_chunks(pool) == 1 );
+
+    upo_pool_destroy(pool);
+}
+
+void test_alignment()
+{
+    size_t sizes[] = {1, 3, 7, 12, 24, 33};
+    size_t n = sizeof sizes/sizeof sizes[0];
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < n; ++i)
+    {
+        upo_pool_t pool = upo_pool_create(sizes[i], 3);
+
+        for (j = 0; j < 10; ++j)
+        {
+            char *block = upo_pool_alloc(pool);
+
+            assert( ((uintptr_t) block) % alignof(max_align_t) == 0 );
+
+            memset(block, 0xFF, sizes[i]);
+        }
+
+        upo_pool_destroy(pool);
+    }
+}
+
+void test_clear()
+{
+    size_t i;
+    upo_pool_t pool;
+
+    pool = upo_pool_create(sizeof(long), 8);
+
+    for (i = 0; i < 100; ++i)
+    {
+        upo_pool_alloc(pool);
+    }
+
+    assert( upo_pool_size(pool) == 100 );
+
+    upo_pool_clear(pool);
+
+    assert( upo_pool_size(pool) == 0 );
+    assert( upo_pool_num_chunks(pool) == 0 );
+
+    /* The pool is usable after being cleared */
+    assert( upo_pool_alloc(pool) != NULL );
+    assert( upo_pool_size(pool) == 1 );
+
+    upo_pool_destroy(pool);
+}
+
+void test_null()
+{
+    upo_pool_t pool = NULL;
+
+    assert( upo_pool_size(pool) == 0 );
+
+    assert( upo_pool_num_chunks(pool) == 0 );
+
+    upo_pool_clear(pool);
+
+    upo_pool_destroy(pool);
+}
+
+
+int main()
+{
+    printf("Test case 'create/destroy'... ");
+    fflush(stdout);
+    test_create_destroy();
+    printf("OK\n");
+
+    printf("Test case 'alloc/free'... ");
+    fflush(stdout);
+    test_alloc_free();
+    printf("OK\n");
+
+    printf("Test case 'reuse'... ");
+    fflush(stdout);
+    test_reuse();
+    printf("OK\n");
+
+    printf("Test case 'alignment'... ");
+    fflush(stdout);
+    test_alignment();
+    printf("OK\n");
+
+    printf("Test case 'clear'... ");
+    fflush(stdout);
+    test_clear();
+    printf("OK\n");
+
+    printf("Test case 'null'... ");
+    fflush(stdout);
+    test_null();
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,449 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <upo/error.h>
+#include <upo/random.h>
+#include <upo/rbt.h>
+
+
+static int int_compare(const void *a, const void *b);
+static void check_balanced(const upo_rbt_t tree);
+static void check_key_list(upo_bst_key_list_t list, int low, int high, int step);
+static void in_order_visit(void *key, void *value, void *info);
+
+static void test_empty();
+static void test_sorted();
+static void test_reverse();
+static void test_random();
+static void test_delete();
+static void test_ordered();
+static void test_destroy_data();
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+void check_balanced(const upo_rbt_t tree)
+{
+    size_t n = upo_rbt_size(tree);
+
+    assert( upo_rbt_is_rbt(tree) );
+    /* The height of a red-black tree with n keys is at most 2*log2(n+1) */
+    assert( upo_rbt_height(tree) <= 2*log(n + 1)/log(2.0) );
+}
+
+/* Checks that the list holds low, low+step, ..., high and frees it */
+void check_key_list(upo_bst_key_list_t list, int low, int high, int step)
+{
+    int expected = low;
+
+    while (list != NULL)
+    {
+        upo_bst_key_list_t next = list->next;
+
+        assert( expected <= high );
+        assert( *(int*) list->key == expected );
+        expected += step;
+        free(list);
+        list = next;
+    }
+    assert( expected > high );
+}
+
+void in_order_visit(void *key, void *value, void *info)
+{
+    int *last = info;
+
+    assert( *(int*) key > *last );
+    assert( *(int*) value == 2 * *(int*) key );
+
+    *last = *(int*) key;
+}
+
+void test_empty()
+{
+    upo_rbt_t tree = upo_rbt_create(int_compare);
+    int key = 1;
+
+    assert( upo_rbt_is_empty(tree) );
+    assert( upo_rbt_size(tree) == 0 );
+    assert( upo_rbt_height(tree) == 0 );
+    assert( upo_rbt_is_rbt(tree) );
+    assert( upo_rbt_get(tree, &key) == NULL );
+    assert( !upo_rbt_contains(tree, &key) );
+    assert( upo_rbt_min(tree) == NULL );
+    assert( upo_rbt_max(tree) == NULL );
+    assert( upo_rbt_floor(tree, &key) == NULL );
+    assert( upo_rbt_ceiling(tree, &key) == NULL );
+    assert( upo_rbt_rank(tree, &key) == 0 );
+    assert( upo_rbt_select(tree, 0) == NULL );
+    assert( upo_rbt_keys(tree) == NULL );
+    assert( upo_rbt_keys_range(tree, &key, &key) == NULL );
+    assert( upo_rbt_get_comparator(tree) == int_compare );
+
+    upo_rbt_delete(tree, &key, 0);
+    upo_rbt_delete_min(tree, 0);
+    upo_rbt_delete_max(tree, 0);
+    assert( upo_rbt_is_empty(tree) );
+
+    upo_rbt_destroy(tree, 0);
+
+    /* NULL trees */
+    assert( upo_rbt_size(NULL) == 0 );
+    assert( upo_rbt_is_empty(NULL) );
+    assert( upo_rbt_get(NULL, &key) == NULL );
+    upo_rbt_destroy(NULL, 0);
+}
+
+void test_sorted()
+{
+    size_t n = 10000;
+    int *keys = NULL;
+    int *values = NULL;
+    upo_rbt_t tree = upo_rbt_create(int_compare);
+    int last = -1;
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    values = malloc(n*sizeof(int));
+    if (keys == NULL || values == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys and values");
+    }
+
+    /* Sorted insertions degenerate a plain BST into a list */
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+        values[i] = 2*keys[i];
+        assert( upo_rbt_put(tree, &keys[i], &values[i]) == NULL );
+        if (i % 1000 == 0)
+        {
+            check_balanced(tree);
+        }
+    }
+    assert( upo_rbt_size(tree) == n );
+    check_balanced(tree);
+
+    for (i = 0; i < n; ++i)
+    {
+        assert( *(int*) upo_rbt_get(tree, &keys[i]) == values[i] );
+    }
+    upo_rbt_traverse_in_order(tree, in_order_visit, &last);
+    assert( last == (int) n - 1 );
+
+    upo_rbt_destroy(tree, 0);
+    free(values);
+    free(keys);
+}
+
+void test_reverse()
+{
+    size_t n = 10000;
+    int *keys = NULL;
+    upo_rbt_t tree = upo_rbt_create(int_compare);
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) (n - i);
+        upo_rbt_insert(tree, &keys[i], &keys[i]);
+    }
+    assert( upo_rbt_size(tree) == n );
+    check_balanced(tree);
+    assert( *(int*) upo_rbt_min(tree) == 1 );
+    assert( *(int*) upo_rbt_max(tree) == (int) n );
+
+    upo_rbt_destroy(tree, 0);
+    free(keys);
+}
+
+void test_random()
+{
+    size_t n = 10000;
+    int *keys = NULL;
+    int *values = NULL;
+    int other = -1;
+    upo_rbt_t tree = upo_rbt_create(int_compare);
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    values = malloc(n*sizeof(int));
+    if (keys == NULL || values == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys and values");
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+        values[i] = 2*keys[i];
+    }
+    upo_random_shuffle(keys, n, sizeof(int));
+    for (i = 0; i < n; ++i)
+    {
+        upo_rbt_put(tree, &keys[i], &values[keys[i]]);
+    }
+    check_balanced(tree);
+
+    /* Put replaces the value and returns the old one, insert does not */
+    assert( upo_rbt_put(tree, &keys[0], &other) == &values[keys[0]] );
+    assert( upo_rbt_get(tree, &keys[0]) == &other );
+    upo_rbt_insert(tree, &keys[0], &values[keys[0]]);
+    assert( upo_rbt_get(tree, &keys[0]) == &other );
+    assert( upo_rbt_size(tree) == n );
+    check_balanced(tree);
+
+    upo_rbt_clear(tree, 0);
+    assert( upo_rbt_is_empty(tree) );
+
+    upo_rbt_destroy(tree, 0);
+    free(values);
+    free(keys);
+}
+
+static void test_delete()
+{
+    size_t n = 5000;
+    int *keys = NULL;
+    int *removed = NULL;
+    int missing = -1;
+    upo_rbt_t tree = upo_rbt_create(int_compare);
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    removed = malloc(n*sizeof(int));
+    if (keys == NULL || removed == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+    upo_random_shuffle(keys, n, sizeof(int));
+    for (i = 0; i < n; ++i)
+    {
+        upo_rbt_put(tree, &keys[i], &keys[i]);
+    }
+
+    upo_rbt_delete(tree, &missing, 0);
+    assert( upo_rbt_size(tree) == n );
+
+    /* Delete half of the keys in another random order, through copies since
+     * the tree references the original keys */
+    for (i = 0; i < n; ++i)
+    {
+        removed[i] = (int) i;
+    }
+    upo_random_shuffle(removed, n, sizeof(int));
+    for (i = 0; i < n/2; ++i)
+    {
+        upo_rbt_delete(tree, &removed[i], 0);
+        assert( !upo_rbt_contains(tree, &removed[i]) );
+        if (i % 250 == 0)
+        {
+            check_balanced(tree);
+        }
+    }
+    assert( upo_rbt_size(tree) == n - n/2 );
+    check_balanced(tree);
+    for (i = n/2; i < n; ++i)
+    {
+        assert( *(int*) upo_rbt_get(tree, &removed[i]) == removed[i] );
+    }
+
+    /* Remove the remaining keys from both ends */
+    while (!upo_rbt_is_empty(tree))
+    {
+        int min = *(int*) upo_rbt_min(tree);
+        int max = *(int*) upo_rbt_max(tree);
+
+        upo_rbt_delete_min(tree, 0);
+        assert( upo_rbt_is_empty(tree) || *(int*) upo_rbt_min(tree) > min );
+        upo_rbt_delete_max(tree, 0);
+        assert( upo_rbt_is_empty(tree) || *(int*) upo_rbt_max(tree) < max );
+        assert( upo_rbt_is_rbt(tree) );
+    }
+    assert( upo_rbt_size(tree) == 0 );
+
+    upo_rbt_destroy(tree, 0);
+    free(removed);
+    free(keys);
+}
+
+void test_ordered()
+{
+    size_t n = 1000;
+    int *keys = NULL;
+    upo_rbt_t tree = upo_rbt_create(int_compare);
+    int key;
+    int low;
+    int high;
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+
+    /* Even keys 0, 2, ..., 2(n-1) */
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = 2*(int) i;
+    }
+    upo_random_shuffle(keys, n, sizeof(int));
+    for (i = 0; i < n; ++i)
+    {
+        upo_rbt_put(tree, &keys[i], &keys[i]);
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        key = 2*(int) i;
+        assert( upo_rbt_rank(tree, &key) == i );
+        assert( *(int*) upo_rbt_select(tree, i) == key );
+        assert( *(int*) upo_rbt_floor(tree, &key) == key );
+        assert( *(int*) upo_rbt_ceiling(tree, &key) == key );
+
+        key = 2*(int) i + 1;
+        assert( upo_rbt_rank(tree, &key) == i + 1 );
+        assert( *(int*) upo_rbt_floor(tree, &key) == key - 1 );
+        if (i + 1 < n)
+        {
+            assert( *(int*) upo_rbt_ceiling(tree, &key) == key + 1 );
+        }
+        else
+        {
+            assert( upo_rbt_ceiling(tree, &key) == NULL );
+        }
+    }
+    key = -1;
+    assert( upo_rbt_floor(tree, &key) == NULL );
+    assert( upo_rbt_rank(tree, &key) == 0 );
+    assert( upo_rbt_select(tree, n) == NULL );
+
+    check_key_list(upo_rbt_keys(tree), 0, 2*((int) n - 1), 2);
+
+    low = 101;
+    high = 200;
+    check_key_list(upo_rbt_keys_range(tree, &low, &high), 102, 200, 2);
+    low = -10;
+    high = 0;
+    check_key_list(upo_rbt_keys_range(tree, &low, &high), 0, 0, 2);
+    low = 5;
+    high = 5;
+    assert( upo_rbt_keys_range(tree, &low, &high) == NULL );
+
+    upo_rbt_destroy(tree, 0);
+    free(keys);
+}
+
+void test_destroy_data()
+{
+    size_t n = 100;
+    upo_rbt_t tree = upo_rbt_create(int_compare);
+    int key;
+    size_t i;
+
+    /* Leaks of keys and values are reported by memory checkers */
+    for (i = 0; i < n; ++i)
+    {
+        int *k = malloc(sizeof(int));
+        int *v = malloc(sizeof(int));
+
+        if (k == NULL || v == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for a key-value pair");
+        }
+        *k = (int) i;
+        *v = (int) i;
+        upo_rbt_put(tree, k, v);
+    }
+
+    key = 10;
+    upo_rbt_delete(tree, &key, 1);
+    upo_rbt_delete(tree, upo_rbt_min(tree), 1);
+    upo_rbt_delete_max(tree, 1);
+    assert( upo_rbt_size(tree) == n - 3 );
+    assert( upo_rbt_is_rbt(tree) );
+
+    upo_rbt_destroy(tree, 1);
+}
+
+
+int main()
+{
+    printf("Test case 'empty'... ");
+    fflush(stdout);
+    test_empty();
+    printf("OK\n");
+
+    printf("Test case 'sorted'... ");
+    fflush(stdout);
+    test_sorted();
+    printf("OK\n");
+
+    printf("Test case 'reverse'... ");
+    fflush(stdout);
+    test_reverse();
+    printf("OK\n");
+
+    printf("Test case 'random'... ");
+    fflush(stdout);
+    test_random();
+    printf("OK\n");
+
+    printf("Test case 'delete'... ");
+    fflush(stdout);
+    test_delete();
+    printf("OK\n");
+
+    printf("Test case 'ordered'... ");
+    fflush(stdout);
+    test_ordered();
+    printf("OK\n");
+
+    printf("Test case 'destroy data'... ");
+    fflush(stdout);
+    test_destroy_data();
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,423 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/*
+ * Copyright 2015 University of Piemonte Orientale, Computer Science Institute
+ *
+ * This file is part of UPOalglib.
+ *
+ * UPOalglib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * UPOalglib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with UPOalglib.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <upo/error.h>
+#include <upo/random.h>
+#include <upo/splay.h>
+
+
+static int int_compare(const void *a, const void *b);
+static void check_key_list(upo_bst_key_list_t list, int low, int high, int step);
+static void in_order_visit(void *key, void *value, void *info);
+
+static void test_empty();
+static void test_sorted();
+static void test_random();
+static void test_delete();
+static void test_ordered();
+static void test_destroy_data();
+
+
+int int_compare(const void *a, const void *b)
+{
+    const int *aa = a;
+    const int *bb = b;
+
+    return (*aa > *bb) - (*aa < *bb);
+}
+
+/* Checks that the list holds low, low+step, ..., high and frees it */
+void check_key_list(upo_bst_key_list_t list, int low, int high, int step)
+{
+    int expected = low;
+
+    while (list != NULL)
+    {
+        upo_bst_key_list_t next = list->next;
+
+        assert( expected <= high );
+        assert( *(int*) list->key == expected );
+        expected += step;
+        free(list);
+        list = next;
+    }
+    assert( expected > high );
+}
+
+void in_order_visit(void *key, void *value, void *info)
+{
+    int *last = info;
+
+    assert( *(int*) key > *last );
+    assert( *(int*) value == 2 * *(int*) key );
+
+    *last = *(int*) key;
+}
+
+void test_empty()
+{
+    upo_splay_t tree = upo_splay_create(int_compare);
+    int key = 1;
+
+    assert( upo_splay_is_empty(tree) );
+    assert( upo_splay_size(tree) == 0 );
+    assert( upo_splay_height(tree) == 0 );
+    assert( upo_splay_is_bst(tree) );
+    assert( upo_splay_get(tree, &key) == NULL );
+    assert( !upo_splay_contains(tree, &key) );
+    assert( upo_splay_min(tree) == NULL );
+    assert( upo_splay_max(tree) == NULL );
+    assert( upo_splay_floor(tree, &key) == NULL );
+    assert( upo_splay_ceiling(tree, &key) == NULL );
+    assert( upo_splay_keys(tree) == NULL );
+    assert( upo_splay_keys_range(tree, &key, &key) == NULL );
+    assert( upo_splay_get_comparator(tree) == int_compare );
+
+    upo_splay_delete(tree, &key, 0);
+    assert( upo_splay_is_empty(tree) );
+
+    upo_splay_destroy(tree, 0);
+
+    /* NULL trees */
+    assert( upo_splay_size(NULL) == 0 );
+    assert( upo_splay_is_empty(NULL) );
+    assert( upo_splay_get(NULL, &key) == NULL );
+    upo_splay_destroy(NULL, 0);
+}
+
+void test_sorted()
+{
+    size_t n = 100000;
+    int *keys = NULL;
+    int *values = NULL;
+    upo_splay_t tree = upo_splay_create(int_compare);
+    int last = -1;
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    values = malloc(n*sizeof(int));
+    if (keys == NULL || values == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys and values");
+    }
+
+    /* Each new key becomes the root, with the previous root as left child:
+     * the tree is a list, which must not overflow the stack of any walk */
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+        values[i] = 2*keys[i];
+        assert( upo_splay_put(tree, &keys[i], &values[i]) == NULL );
+    }
+    assert( upo_splay_size(tree) == n );
+    assert( upo_splay_height(tree) == n - 1 );
+    assert( upo_splay_is_bst(tree) );
+    upo_splay_traverse_in_order(tree, in_order_visit, &last);
+    assert( last == (int) n - 1 );
+
+    /* Splaying the deepest key roughly halves the depth of the path */
+    assert( *(int*) upo_splay_get(tree, &keys[0]) == values[0] );
+    assert( upo_splay_height(tree) <= n/2 + 1 );
+    assert( upo_splay_is_bst(tree) );
+
+    for (i = 0; i < n; ++i)
+    {
+        assert( *(int*) upo_splay_get(tree, &keys[i]) == values[i] );
+    }
+    assert( upo_splay_is_bst(tree) );
+
+    upo_splay_destroy(tree, 0);
+    free(values);
+    free(keys);
+}
+
+void test_random()
+{
+    size_t n = 10000;
+    int *keys = NULL;
+    int *values = NULL;
+    int other = -1;
+    int missing = (int) n;
+    upo_splay_t tree = upo_splay_create(int_compare);
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    values = malloc(n*sizeof(int));
+    if (keys == NULL || values == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys and values");
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+        values[i] = 2*keys[i];
+    }
+    upo_random_shuffle(keys, n, sizeof(int));
+    for (i = 0; i < n; ++i)
+    {
+        upo_splay_put(tree, &keys[i], &values[keys[i]]);
+    }
+    assert( upo_splay_size(tree) == n );
+    assert( upo_splay_is_bst(tree) );
+
+    /* Put replaces the value and returns the old one, insert does not */
+    assert( upo_splay_put(tree, &keys[0], &other) == &values[keys[0]] );
+    assert( upo_splay_get(tree, &keys[0]) == &other );
+    upo_splay_insert(tree, &keys[0], &values[keys[0]]);
+    assert( upo_splay_get(tree, &keys[0]) == &other );
+    assert( upo_splay_size(tree) == n );
+
+    /* Repeated lookups of a few hot keys, and of a missing one */
+    for (i = 0; i < 10*n; ++i)
+    {
+        int key = keys[i % 8];
+
+        assert( upo_splay_contains(tree, &key) );
+    }
+    assert( upo_splay_get(tree, &missing) == NULL );
+    assert( !upo_splay_contains(tree, &missing) );
+    assert( upo_splay_is_bst(tree) );
+
+    upo_splay_clear(tree, 0);
+    assert( upo_splay_is_empty(tree) );
+    assert( upo_splay_size(tree) == 0 );
+
+    upo_splay_destroy(tree, 0);
+    free(values);
+    free(keys);
+}
+
+void test_delete()
+{
+    size_t n = 5000;
+    int *keys = NULL;
+    int *removed = NULL;
+    int missing = -1;
+    upo_splay_t tree = upo_splay_create(int_compare);
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    removed = malloc(n*sizeof(int));
+    if (keys == NULL || removed == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = (int) i;
+    }
+    upo_random_shuffle(keys, n, sizeof(int));
+    for (i = 0; i < n; ++i)
+    {
+        upo_splay_put(tree, &keys[i], &keys[i]);
+    }
+
+    upo_splay_delete(tree, &missing, 0);
+    assert( upo_splay_size(tree) == n );
+    assert( upo_splay_is_bst(tree) );
+
+    /* Delete half of the keys in another random order, through copies since
+     * the tree references the original keys */
+    for (i = 0; i < n; ++i)
+    {
+        removed[i] = (int) i;
+    }
+    upo_random_shuffle(removed, n, sizeof(int));
+    for (i = 0; i < n/2; ++i)
+    {
+        upo_splay_delete(tree, &removed[i], 0);
+        assert( !upo_splay_contains(tree, &removed[i]) );
+        if (i % 250 == 0)
+        {
+            assert( upo_splay_is_bst(tree) );
+        }
+    }
+    assert( upo_splay_size(tree) == n - n/2 );
+    assert( upo_splay_is_bst(tree) );
+    for (i = n/2; i < n; ++i)
+    {
+        assert( *(int*) upo_splay_get(tree, &removed[i]) == removed[i] );
+    }
+
+    /* Remove the remaining keys from both ends */
+    while (!upo_splay_is_empty(tree))
+    {
+        int min = *(int*) upo_splay_min(tree);
+        int max = *(int*) upo_splay_max(tree);
+
+        upo_splay_delete(tree, &min, 0);
+        assert( upo_splay_is_empty(tree) || *(int*) upo_splay_min(tree) > min );
+        upo_splay_delete(tree, &max, 0);
+        assert( upo_splay_is_empty(tree) || *(int*) upo_splay_max(tree) < max );
+        assert( upo_splay_is_bst(tree) );
+    }
+    assert( upo_splay_size(tree) == 0 );
+
+    upo_splay_destroy(tree, 0);
+    free(removed);
+    free(keys);
+}
+
+void test_ordered()
+{
+    size_t n = 1000;
+    int *keys = NULL;
+    upo_splay_t tree = upo_splay_create(int_compare);
+    int key;
+    int low;
+    int high;
+    size_t i;
+
+    keys = malloc(n*sizeof(int));
+    if (keys == NULL)
+    {
+        upo_throw_sys_error("Unable to allocate memory for keys");
+    }
+
+    /* Even keys 0, 2, ..., 2(n-1) */
+    for (i = 0; i < n; ++i)
+    {
+        keys[i] = 2*(int) i;
+    }
+    upo_random_shuffle(keys, n, sizeof(int));
+    for (i = 0; i < n; ++i)
+    {
+        upo_splay_put(tree, &keys[i], &keys[i]);
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+        key = 2*(int) i;
+        assert( *(int*) upo_splay_floor(tree, &key) == key );
+        assert( *(int*) upo_splay_ceiling(tree, &key) == key );
+
+        key = 2*(int) i + 1;
+        assert( *(int*) upo_splay_floor(tree, &key) == key - 1 );
+        if (i + 1 < n)
+        {
+            assert( *(int*) upo_splay_ceiling(tree, &key) == key + 1 );
+        }
+        else
+        {
+            assert( upo_splay_ceiling(tree, &key) == NULL );
+        }
+    }
+    key = -1;
+    assert( upo_splay_floor(tree, &key) == NULL );
+    assert( *(int*) upo_splay_ceiling(tree, &key) == 0 );
+    assert( *(int*) upo_splay_min(tree) == 0 );
+    assert( *(int*) upo_splay_max(tree) == 2*((int) n - 1) );
+    assert( upo_splay_is_bst(tree) );
+
+    check_key_list(upo_splay_keys(tree), 0, 2*((int) n - 1), 2);
+
+    low = 101;
+    high = 200;
+    check_key_list(upo_splay_keys_range(tree, &low, &high), 102, 200, 2);
+    low = -10;
+    high = 0;
+    check_key_list(upo_splay_keys_range(tree, &low, &high), 0, 0, 2);
+    low = 5;
+    high = 5;
+    assert( upo_splay_keys_range(tree, &low, &high) == NULL );
+    low = 2*(int) n - 3;
+    high = 2*(int) n + 10;
+    check_key_list(upo_splay_keys_range(tree, &low, &high), 2*((int) n - 1), 2*((int) n - 1), 2);
+    assert( upo_splay_is_bst(tree) );
+
+    upo_splay_destroy(tree, 0);
+    free(keys);
+}
+
+void test_destroy_data()
+{
+    size_t n = 100;
+    upo_splay_t tree = upo_splay_create(int_compare);
+    int key;
+    size_t i;
+
+    /* Leaks of keys and values are reported by memory checkers */
+    for (i = 0; i < n; ++i)
+    {
+        int *k = malloc(sizeof(int));
+        int *v = malloc(sizeof(int));
+
+        if (k == NULL || v == NULL)
+        {
+            upo_throw_sys_error("Unable to allocate memory for a key-value pair");
+        }
+        *k = (int) i;
+        *v = (int) i;
+        upo_splay_put(tree, k, v);
+    }
+
+    key = 10;
+    upo_splay_delete(tree, &key, 1);
+    upo_splay_delete(tree, upo_splay_min(tree), 1);
+    key = (int) n - 1;
+    upo_splay_delete(tree, &key, 1);
+    assert( upo_splay_size(tree) == n - 3 );
+    assert( upo_splay_is_bst(tree) );
+
+    upo_splay_destroy(tree, 1);
+}
+
+
+int main()
+{
+    printf("Test case 'empty'... ");
+    fflush(stdout);
+    test_empty();
+    printf("OK\n");
+
+    printf("Test case 'sorted'... ");
+    fflush(stdout);
+    test_sorted();
+    printf("OK\n");
+
+    printf("Test case 'random'... ");
+    fflush(stdout);
+    test_random();
+    printf("OK\n");
+
+    printf("Test case 'delete'... ");
+    fflush(stdout);
+    test_delete();
+    printf("OK\n");
+
+    printf("Test case 'ordered'... ");
+    fflush(stdout);
+    test_ordered();
+    printf("OK\n");
+
+    printf("Test case 'destroy data'... ");
+    fflush(stdout);
+    test_destroy_data();
+    printf("OK\n");
+
+    return 0;
+}